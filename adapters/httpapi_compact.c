@@ -893,7 +893,8 @@ static HTTPAPI_RESULT conn_send_all(HTTP_HANDLE_DATA* http_instance, const unsig
                 /*Codes_SRS_HTTPAPI_COMPACT_21_028: [ If the HTTPAPI_ExecuteRequest cannot send the request header, it shall return HTTPAPI_HTTP_HEADERS_FAILED. ]*/
                 result = HTTPAPI_SEND_REQUEST_FAILED;
             }
-            else
+            /* a socket IO that completes its sends asynchronously, like the io_uring one, completes them in xio_dowork */
+            else if (http_instance->send_completed == 0)
             {
                 /*Codes_SRS_HTTPAPI_COMPACT_21_083: [ The HTTPAPI_ExecuteRequest shall wait, at least, 100 milliseconds between retries. ]*/
                 ThreadAPI_Sleep(SEND_RETRY_INTERVAL_IN_MILLISECONDS);
@@ -1571,6 +1572,24 @@ HTTPAPI_RESULT HTTPAPI_CloneOption(const char* optionName, const void* value, co
             result = HTTPAPI_OK;
         }
     }
+    else if (strcmp(OPTION_UNIX_SOCKET_PATH, optionName) == 0)
+    {
+        /*Codes_SRS_HTTPAPI_COMPACT_21_088: [ The HTTPAPI_CloneOption shall clone the unix_socket_path option, which HTTPAPI_SetOption passes to the xio, as a string. ]*/
+        certLen = strlen((const char*)value);
+        tempCert = (char*)malloc((certLen + 1) * sizeof(char));
+        if (tempCert == NULL)
+        {
+            /*Codes_SRS_HTTPAPI_COMPACT_21_070: [ If any memory allocation get fail, the HTTPAPI_CloneOption shall return HTTPAPI_ALLOC_FAILED. ]*/
+            result = HTTPAPI_ALLOC_FAILED;
+        }
+        else
+        {
+            /*Codes_SRS_HTTPAPI_COMPACT_21_072: [ If the HTTPAPI_CloneOption get success setting the option, it shall return HTTPAPI_OK. ]*/
+            (void)strcpy_s(tempCert, certLen + 1, (const char*)value);
+            *savedValue = tempCert;
+            result = HTTPAPI_OK;
+        }
+    }
     else
     {
         /*Codes_SRS_HTTPAPI_COMPACT_21_071: [ If the HTTP do not support the optionName, the HTTPAPI_CloneOption shall return HTTPAPI_INVALID_ARG. ]*/
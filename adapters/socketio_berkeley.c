@@ -18,12 +18,17 @@
 #include <signal.h>
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
 #include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/socketio_event_loop.h"
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
 #include <poll.h>
 #ifdef TIZENRT
 #include <net/lwip/tcp.h>
@@ -35,13 +40,19 @@
 #include <fcntl.h>
 #include <errno.h>
 #include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/slab.h"
 #include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/conststring.h"
+#include "azure_c_shared_utility/crt_abstractions.h"
+#include "azure_c_shared_utility/constbuffer.h"
 #include "azure_c_shared_utility/gbnetwork.h"
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/optionhandler.h"
 #include "azure_c_shared_utility/shared_util_options.h"
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/const_defines.h"
+#include "azure_c_shared_utility/dns_resolver.h"
+#include "linux_time.h"
 #include <sys/ioctl.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -54,7 +65,65 @@
 #define IFREQ_BUFFER_SIZE              1024
 #endif
 
-#define CONNECT_TIMEOUT_SECONDS 10
+/* the time a connect is waited for when the connect_timeout option is not set */
+#ifndef SOCKETIO_DEFAULT_CONNECT_TIMEOUT_MS
+#define SOCKETIO_DEFAULT_CONNECT_TIMEOUT_MS 10000
+#endif
+
+/* the code of the open result of a connect that timed out */
+#define CONNECT_TIMEOUT_ERROR_CODE 9999
+
+/* the most buffers given to one sendmsg, IOV_MAX is 1024 on Linux and macOS */
+#ifndef SOCKETIO_MAX_IOVECS
+#define SOCKETIO_MAX_IOVECS 64
+#endif
+
+/* the size a batched receive grows the receive buffer up to, the bytes are indicated when it is full */
+#ifndef SOCKETIO_MAX_RECEIVE_BATCH_SIZE
+#define SOCKETIO_MAX_RECEIVE_BATCH_SIZE (256 * 1024)
+#endif
+
+/* the time a connect attempt is given before the next address is tried alongside it, the Connection Attempt Delay of RFC 8305 */
+#ifndef SOCKETIO_CONNECTION_ATTEMPT_DELAY_MS
+#define SOCKETIO_CONNECTION_ATTEMPT_DELAY_MS 250
+#endif
+
+/* how often the connect timer of a socket IO on an event loop checks a lookup of the DNS resolver, which does not wake the loop when it resolves */
+#ifndef SOCKETIO_DNS_LOOKUP_POLL_INTERVAL_MS
+#define SOCKETIO_DNS_LOOKUP_POLL_INTERVAL_MS 10
+#endif
+
+/* the most connect attempts in progress at once for one socket IO */
+#ifndef SOCKETIO_MAX_CONNECT_ATTEMPTS
+#define SOCKETIO_MAX_CONNECT_ATTEMPTS 4
+#endif
+
+// Edison is missing this from netinet/tcp.h, but this code still works if we manually define it.
+#ifndef SOL_TCP
+#define SOL_TCP 6
+#endif
+
+/* the options the layers above set on the TCP socket, they are kept so that the sockets created by a later connect get them too */
+typedef struct TCP_OPTION_TAG
+{
+    const char* name;
+    int level;
+    int option_name;
+} TCP_OPTION;
+
+#define TCP_OPTION_COUNT 4
+
+static const TCP_OPTION tcp_options[TCP_OPTION_COUNT] =
+{
+    { "tcp_keepalive", SOL_SOCKET, SO_KEEPALIVE },
+#ifdef __APPLE__
+    { "tcp_keepalive_time", IPPROTO_TCP, TCP_KEEPALIVE },
+#else
+    { "tcp_keepalive_time", SOL_TCP, TCP_KEEPIDLE },
+#endif
+    { "tcp_keepalive_interval", SOL_TCP, TCP_KEEPINTVL },
+    { "tcp_nodelay", IPPROTO_TCP, TCP_NODELAY }
+};
 
 typedef enum IO_STATE_TAG
 {
@@ -67,13 +136,43 @@ typedef enum IO_STATE_TAG
 
 typedef struct PENDING_SOCKET_IO_TAG
 {
-    unsigned char* bytes;
+    /* the bytes left to send, either in a copy owned by the pending IO or in constbuffer, a partial send advances them */
+    const unsigned char* bytes;
     size_t size;
+    unsigned char* copied_bytes;
+    CONSTBUFFER_HANDLE constbuffer;
     ON_SEND_COMPLETE on_send_complete;
     void* callback_context;
     SINGLYLINKEDLIST_HANDLE pending_io_list;
 } PENDING_SOCKET_IO;
 
+#define PENDING_SOCKET_IOS_PER_CHUNK 8
+
+typedef struct CONNECT_ADDRESS_TAG
+{
+    struct sockaddr_storage address;
+    socklen_t address_length;
+} CONNECT_ADDRESS;
+
+typedef struct CONNECT_ATTEMPT_TAG
+{
+    int socket;
+    SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE event_loop_registration;
+} CONNECT_ATTEMPT;
+
+/* the addresses of the host name, in the order they are tried, and the connects in progress to them */
+typedef struct CONNECT_RACE_TAG
+{
+    CONNECT_ATTEMPT attempts[SOCKETIO_MAX_CONNECT_ATTEMPTS];
+    size_t attempt_count;
+    uint64_t last_attempt_start_ms;
+    /* the error of the last attempt that failed, the open fails with it once no address is left */
+    int last_error;
+    size_t next_address;
+    size_t address_count;
+    CONNECT_ADDRESS addresses[];
+} CONNECT_RACE;
+
 typedef struct SOCKET_IO_INSTANCE_TAG
 {
     int socket;
@@ -83,10 +182,42 @@ typedef struct SOCKET_IO_INSTANCE_TAG
     void* on_io_error_context;
     char* hostname;
     int port;
-    char* target_mac_address;
+    /*shared with the option handlers produced by socketio_retrieveoptions*/
+    CONSTSTRING_HANDLE target_mac_address;
+    /* set by the unix_socket_path option, the socket IO then connects to this Unix domain socket and hostname and port are only kept for the layers above */
+    char* unix_socket_path;
     IO_STATE io_state;
+    /* socketio_open starts the connect and returns, the socket IO stays IO_STATE_OPENING until socketio_dowork or the event loop
+       finds the socket writable or the connect timed out, and indicates the open then */
+    ON_IO_OPEN_COMPLETE on_io_open_complete;
+    void* on_io_open_complete_context;
+    unsigned int connect_timeout_ms;
+    uint64_t connect_start_ms;
+    /* set while the host name is resolved by the DNS resolver, the connect starts once socketio_dowork or the connect timer finds it resolved */
+    DNS_RESOLVER_LOOKUP_HANDLE dns_lookup;
+    /* set while connecting, socket is INVALID_SOCKET until one of the attempts connects */
+    CONNECT_RACE* connect_race;
+    /* the values of the TCP options that were set, by the index of the option in tcp_options */
+    int tcp_option_values[TCP_OPTION_COUNT];
+    bool tcp_option_is_set[TCP_OPTION_COUNT];
     SINGLYLINKEDLIST_HANDLE pending_io_list;
-    unsigned char recv_bytes[RECEIVE_BYTES_VALUE];
+    /* the pending IO records are recycled through the slab, the bytes they copy are sized per send and stay on the heap */
+    SLAB_HANDLE pending_io_slab;
+    ARENA_HANDLE arena;
+    /* set by the event_loop option, the socket is then registered with the loop, which runs the send and receive paths when the socket is ready, and socketio_dowork does nothing */
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop;
+    SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE event_loop_registration;
+    unsigned int watched_events;
+    /* started while connecting with an event loop, so that the loop checks the connect when it times out, the DNS lookup may be resolved or the
+       next attempt is due although no socket is ready */
+    SOCKETIO_EVENT_LOOP_TIMER_HANDLE connect_timer;
+    /* the bytes are received in receive_buffer, which is recv_bytes unless the receive_buffer_size option or a batched receive made it larger.
+       A socket IO with an event loop receives in the buffer of the loop, receive_buffer is NULL until it is given its own */
+    unsigned char* receive_buffer;
+    size_t receive_buffer_size;
+    size_t receive_size;
+    bool receive_batched;
+    unsigned char recv_bytes[];
 } SOCKET_IO_INSTANCE;
 
 typedef struct NETWORK_INTERFACE_DESCRIPTION_TAG
@@ -97,6 +228,8 @@ typedef struct NETWORK_INTERFACE_DESCRIPTION_TAG
     struct NETWORK_INTERFACE_DESCRIPTION_TAG* next;
 } NETWORK_INTERFACE_DESCRIPTION;
 
+static int socketio_set_retrieved_option(void* handle, const char* name, const void* value);
+
 /*this function will clone an option given by name and value*/
 static void* socketio_CloneOption(const char* name, const void* value)
 {
@@ -114,16 +247,59 @@ static void* socketio_CloneOption(const char* name, const void* value)
             }
             else
             {
-                if ((result = malloc(sizeof(char) * (strlen((char*)value) + 1))) == NULL)
-                {
-                    LogError("Failed cloning option %s (malloc failed)", name);
-                }
-                else if (strcpy((char*)result, (char*)value) == NULL)
-                {
-                    LogError("Failed cloning option %s (strcpy failed)", name);
-                    free(result);
-                    result = NULL;
-                }
+                /*the value is the conststring of the instance, a clone shares the characters*/
+                result = CONSTSTRING_Clone((CONSTSTRING_HANDLE)value);
+            }
+        }
+        else if (strcmp(name, OPTION_RECEIVE_BUFFER_SIZE) == 0)
+        {
+            size_t* value_clone = (size_t*)malloc(sizeof(size_t));
+            if (value_clone == NULL)
+            {
+                LogError("Failed cloning option %s", name);
+            }
+            else
+            {
+                *value_clone = *(const size_t*)value;
+                result = value_clone;
+            }
+        }
+        else if (strcmp(name, OPTION_CONNECT_TIMEOUT) == 0)
+        {
+            unsigned int* value_clone = (unsigned int*)malloc(sizeof(unsigned int));
+            if (value_clone == NULL)
+            {
+                LogError("Failed cloning option %s", name);
+            }
+            else
+            {
+                *value_clone = *(const unsigned int*)value;
+                result = value_clone;
+            }
+        }
+        else if (strcmp(name, OPTION_UNIX_SOCKET_PATH) == 0)
+        {
+            char* value_clone;
+            if (mallocAndStrcpy_s(&value_clone, (const char*)value) != 0)
+            {
+                LogError("Failed cloning option %s", name);
+            }
+            else
+            {
+                result = value_clone;
+            }
+        }
+        else if (strcmp(name, OPTION_RECEIVE_BATCHED) == 0)
+        {
+            bool* value_clone = (bool*)malloc(sizeof(bool));
+            if (value_clone == NULL)
+            {
+                LogError("Failed cloning option %s", name);
+            }
+            else
+            {
+                *value_clone = *(const bool*)value;
+                result = value_clone;
             }
         }
         else
@@ -144,6 +320,13 @@ static void socketio_DestroyOption(const char* name, const void* value)
     if (name != NULL)
     {
         if (strcmp(name, OPTION_NET_INT_MAC_ADDRESS) == 0 && value != NULL)
+        {
+            CONSTSTRING_Destroy((CONSTSTRING_HANDLE)value);
+        }
+        else if (strcmp(name, OPTION_RECEIVE_BUFFER_SIZE) == 0 ||
+            strcmp(name, OPTION_RECEIVE_BATCHED) == 0 ||
+            strcmp(name, OPTION_CONNECT_TIMEOUT) == 0 ||
+            strcmp(name, OPTION_UNIX_SOCKET_PATH) == 0)
         {
             free((void*)value);
         }
@@ -163,7 +346,7 @@ static OPTIONHANDLER_HANDLE socketio_retrieveoptions(CONCRETE_IO_HANDLE handle)
     {
         SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)handle;
 
-        result = OptionHandler_Create(socketio_CloneOption, socketio_DestroyOption, socketio_setoption);
+        result = OptionHandler_Create(socketio_CloneOption, socketio_DestroyOption, socketio_set_retrieved_option);
         if (result == NULL)
         {
             LogError("unable to OptionHandler_Create");
@@ -175,6 +358,34 @@ static OPTIONHANDLER_HANDLE socketio_retrieveoptions(CONCRETE_IO_HANDLE handle)
             OptionHandler_Destroy(result);
             result = NULL;
         }
+        else if ((socket_io_instance->receive_size != RECEIVE_BYTES_VALUE) &&
+            (OptionHandler_AddOption(result, OPTION_RECEIVE_BUFFER_SIZE, &socket_io_instance->receive_size) != OPTIONHANDLER_OK))
+        {
+            LogError("failed retrieving options (failed adding %s)", OPTION_RECEIVE_BUFFER_SIZE);
+            OptionHandler_Destroy(result);
+            result = NULL;
+        }
+        else if (socket_io_instance->receive_batched &&
+            (OptionHandler_AddOption(result, OPTION_RECEIVE_BATCHED, &socket_io_instance->receive_batched) != OPTIONHANDLER_OK))
+        {
+            LogError("failed retrieving options (failed adding %s)", OPTION_RECEIVE_BATCHED);
+            OptionHandler_Destroy(result);
+            result = NULL;
+        }
+        else if ((socket_io_instance->connect_timeout_ms != SOCKETIO_DEFAULT_CONNECT_TIMEOUT_MS) &&
+            (OptionHandler_AddOption(result, OPTION_CONNECT_TIMEOUT, &socket_io_instance->connect_timeout_ms) != OPTIONHANDLER_OK))
+        {
+            LogError("failed retrieving options (failed adding %s)", OPTION_CONNECT_TIMEOUT);
+            OptionHandler_Destroy(result);
+            result = NULL;
+        }
+        else if ((socket_io_instance->unix_socket_path != NULL) &&
+            (OptionHandler_AddOption(result, OPTION_UNIX_SOCKET_PATH, socket_io_instance->unix_socket_path) != OPTIONHANDLER_OK))
+        {
+            LogError("failed retrieving options (failed adding %s)", OPTION_UNIX_SOCKET_PATH);
+            OptionHandler_Destroy(result);
+            result = NULL;
+        }
     }
 
     return result;
@@ -189,7 +400,9 @@ static const IO_INTERFACE_DESCRIPTION socket_io_interface_description =
     socketio_close,
     socketio_send,
     socketio_dowork,
-    socketio_setoption
+    socketio_setoption,
+    socketio_create_with_arena,
+    socketio_sendv
 };
 
 static void indicate_error(SOCKET_IO_INSTANCE* socket_io_instance)
@@ -200,21 +413,57 @@ static void indicate_error(SOCKET_IO_INSTANCE* socket_io_instance)
     }
 }
 
-static int add_pending_io(SOCKET_IO_INSTANCE* socket_io_instance, const unsigned char* buffer, size_t size, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+static void free_pending_io(SOCKET_IO_INSTANCE* socket_io_instance, PENDING_SOCKET_IO* pending_socket_io)
+{
+    if (pending_socket_io->constbuffer != NULL)
+    {
+        CONSTBUFFER_Destroy(pending_socket_io->constbuffer);
+    }
+    else
+    {
+        free(pending_socket_io->copied_bytes);
+    }
+    slab_free(socket_io_instance->pending_io_slab, pending_socket_io);
+}
+
+/* queues the bytes of buffers past the first sent_size ones as one pending IO.
+   When constbuffer is not NULL, buffers is its content and a reference to it is kept instead of copying the bytes */
+static int add_pending_io(SOCKET_IO_INSTANCE* socket_io_instance, const CONSTBUFFER* buffers, size_t buffer_count, size_t sent_size, CONSTBUFFER_HANDLE constbuffer, ON_SEND_COMPLETE on_send_complete, void* callback_context)
 {
     int result;
-    PENDING_SOCKET_IO* pending_socket_io = (PENDING_SOCKET_IO*)malloc(sizeof(PENDING_SOCKET_IO));
+    PENDING_SOCKET_IO* pending_socket_io = (PENDING_SOCKET_IO*)slab_malloc(socket_io_instance->pending_io_slab);
     if (pending_socket_io == NULL)
     {
         result = __FAILURE__;
     }
     else
     {
-        pending_socket_io->bytes = (unsigned char*)malloc(size);
-        if (pending_socket_io->bytes == NULL)
+        size_t size = 0;
+        size_t i;
+        for (i = 0; i < buffer_count; i++)
+        {
+            size += buffers[i].size;
+        }
+        size -= sent_size;
+
+        if (constbuffer != NULL)
+        {
+            pending_socket_io->copied_bytes = NULL;
+            pending_socket_io->constbuffer = CONSTBUFFER_Clone(constbuffer);
+            pending_socket_io->bytes = buffers[0].buffer + sent_size;
+        }
+        else
+        {
+            pending_socket_io->constbuffer = NULL;
+            pending_socket_io->copied_bytes = (unsigned char*)malloc(size);
+            pending_socket_io->bytes = pending_socket_io->copied_bytes;
+        }
+
+        if ((pending_socket_io->constbuffer == NULL) &&
+            (pending_socket_io->copied_bytes == NULL))
         {
             LogError("Allocation Failure: Unable to allocate pending list.");
-            free(pending_socket_io);
+            slab_free(socket_io_instance->pending_io_slab, pending_socket_io);
             result = __FAILURE__;
         }
         else
@@ -223,13 +472,28 @@ static int add_pending_io(SOCKET_IO_INSTANCE* socket_io_instance, const unsigned
             pending_socket_io->on_send_complete = on_send_complete;
             pending_socket_io->callback_context = callback_context;
             pending_socket_io->pending_io_list = socket_io_instance->pending_io_list;
-            (void)memcpy(pending_socket_io->bytes, buffer, size);
+            if (pending_socket_io->copied_bytes != NULL)
+            {
+                size = 0;
+                for (i = 0; i < buffer_count; i++)
+                {
+                    if (sent_size >= buffers[i].size)
+                    {
+                        sent_size -= buffers[i].size;
+                    }
+                    else
+                    {
+                        (void)memcpy(pending_socket_io->copied_bytes + size, buffers[i].buffer + sent_size, buffers[i].size - sent_size);
+                        size += buffers[i].size - sent_size;
+                        sent_size = 0;
+                    }
+                }
+            }
 
             if (singlylinkedlist_add(socket_io_instance->pending_io_list, pending_socket_io) == NULL)
             {
                 LogError("Failure: Unable to add socket to pending list.");
-                free(pending_socket_io->bytes);
-                free(pending_socket_io);
+                free_pending_io(socket_io_instance, pending_socket_io);
                 result = __FAILURE__;
             }
             else
@@ -241,135 +505,1202 @@ static int add_pending_io(SOCKET_IO_INSTANCE* socket_io_instance, const unsigned
     return result;
 }
 
-static STATIC_VAR_UNUSED void signal_callback(int signum)
-{
-    AZURE_UNREFERENCED_PARAMETER(signum);
-    LogError("Socket received signal %d.", signum);
-}
-
-#ifndef __APPLE__
-static void destroy_network_interface_descriptions(NETWORK_INTERFACE_DESCRIPTION* nid)
+/* the pending IOs are sent in order, as many as SOCKETIO_MAX_IOVECS of them per sendmsg, and completed in order as they are fully sent */
+static int send_pending_ios(SOCKET_IO_INSTANCE* socket_io_instance)
 {
-    if (nid != NULL)
+    int result = 0;
+    LIST_ITEM_HANDLE first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
+    while (first_pending_io != NULL)
     {
-        if (nid->next != NULL)
+        struct iovec iovecs[SOCKETIO_MAX_IOVECS];
+        struct msghdr message;
+        int iovec_count = 0;
+        size_t gathered_size = 0;
+        LIST_ITEM_HANDLE pending_io = first_pending_io;
+
+        while ((pending_io != NULL) && (iovec_count < SOCKETIO_MAX_IOVECS))
         {
-            destroy_network_interface_descriptions(nid->next);
+            PENDING_SOCKET_IO* pending_socket_io = (PENDING_SOCKET_IO*)singlylinkedlist_item_get_value(pending_io);
+            if (pending_socket_io == NULL)
+            {
+                break;
+            }
+
+            iovecs[iovec_count].iov_base = (void*)pending_socket_io->bytes;
+            iovecs[iovec_count].iov_len = pending_socket_io->size;
+            gathered_size += pending_socket_io->size;
+            iovec_count++;
+            pending_io = singlylinkedlist_get_next_item(pending_io);
         }
 
-        if (nid->name != NULL)
+        if (iovec_count == 0)
         {
-            free(nid->name);
+            socket_io_instance->io_state = IO_STATE_ERROR;
+            indicate_error(socket_io_instance);
+            LogError("Failure: retrieving socket from list");
+            result = __FAILURE__;
+            break;
         }
 
-        if (nid->mac_address != NULL)
+        signal(SIGPIPE, SIG_IGN);
+
+        (void)memset(&message, 0, sizeof(message));
+        message.msg_iov = iovecs;
+        message.msg_iovlen = iovec_count;
+        ssize_t send_result = sendmsg(socket_io_instance->socket, &message, 0);
+        if (send_result == INVALID_SOCKET)
         {
-            free(nid->mac_address);
-        }
+            if (errno == EAGAIN) /*send says "come back later" with EAGAIN - likely the socket buffer cannot accept more data*/
+            {
+                /*do nothing until next dowork */
+            }
+            else
+            {
+                free_pending_io(socket_io_instance, (PENDING_SOCKET_IO*)singlylinkedlist_item_get_value(first_pending_io));
+                (void)singlylinkedlist_remove(socket_io_instance->pending_io_list, first_pending_io);
 
-        if (nid->ip_address != NULL)
+                LogError("Failure: sending Socket information. errno=%d (%s).", errno, strerror(errno));
+                socket_io_instance->io_state = IO_STATE_ERROR;
+                indicate_error(socket_io_instance);
+                result = __FAILURE__;
+            }
+            break;
+        }
+        else
         {
-            free(nid->ip_address);
+            size_t sent_size = (size_t)send_result;
+
+            while (sent_size > 0)
+            {
+                PENDING_SOCKET_IO* pending_socket_io = (PENDING_SOCKET_IO*)singlylinkedlist_item_get_value(first_pending_io);
+                if (sent_size < pending_socket_io->size)
+                {
+                    /* simply wait until next dowork */
+                    pending_socket_io->bytes += sent_size;
+                    pending_socket_io->size -= sent_size;
+                    sent_size = 0;
+                }
+                else
+                {
+                    sent_size -= pending_socket_io->size;
+                    if (pending_socket_io->on_send_complete != NULL)
+                    {
+                        pending_socket_io->on_send_complete(pending_socket_io->callback_context, IO_SEND_OK);
+                    }
+
+                    free_pending_io(socket_io_instance, pending_socket_io);
+                    if (singlylinkedlist_remove(socket_io_instance->pending_io_list, first_pending_io) != 0)
+                    {
+                        socket_io_instance->io_state = IO_STATE_ERROR;
+                        indicate_error(socket_io_instance);
+                        LogError("Failure: unable to remove socket from list");
+                        result = __FAILURE__;
+                        break;
+                    }
+                    first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
+                }
+            }
+
+            if ((result != 0) || ((size_t)send_result < gathered_size))
+            {
+                /* the socket took less than was gathered, it is full */
+                break;
+            }
         }
 
-        free(nid);
+        first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
     }
+
+    return result;
 }
 
-static NETWORK_INTERFACE_DESCRIPTION* create_network_interface_description(struct ifreq *ifr, NETWORK_INTERFACE_DESCRIPTION* previous_nid)
+static void free_receive_buffer(SOCKET_IO_INSTANCE* socket_io_instance)
 {
-    NETWORK_INTERFACE_DESCRIPTION* result;
-
-    if ((result = (NETWORK_INTERFACE_DESCRIPTION*)malloc(sizeof(NETWORK_INTERFACE_DESCRIPTION))) == NULL)
-    {
-        LogError("Failed allocating NETWORK_INTERFACE_DESCRIPTION");
-    }
-    else if ((result->name = (char*)malloc(sizeof(char) * (strlen(ifr->ifr_name) + 1))) == NULL)
+    if (socket_io_instance->receive_buffer != socket_io_instance->recv_bytes)
     {
-        LogError("failed setting interface description name (malloc failed)");
-        destroy_network_interface_descriptions(result);
-        result = NULL;
+        free(socket_io_instance->receive_buffer);
     }
-    else if (strcpy(result->name, ifr->ifr_name) == NULL)
+}
+
+/* gives the socket IO its own receive buffer of size bytes, the bytes it holds are lost */
+static int set_receive_buffer_size(SOCKET_IO_INSTANCE* socket_io_instance, size_t size)
+{
+    int result;
+
+    if (size <= RECEIVE_BYTES_VALUE)
     {
-        LogError("failed setting interface description name (strcpy failed)");
-        destroy_network_interface_descriptions(result);
-        result = NULL;
+        free_receive_buffer(socket_io_instance);
+        socket_io_instance->receive_buffer = socket_io_instance->recv_bytes;
+        socket_io_instance->receive_buffer_size = size;
+        result = 0;
     }
     else
     {
-        char* ip_address;
-        unsigned char* mac = (unsigned char*)ifr->ifr_hwaddr.sa_data;
-
-        if ((result->mac_address = (char*)malloc(sizeof(char) * MAC_ADDRESS_STRING_LENGTH)) == NULL)
-        {
-            LogError("failed formatting mac address (malloc failed)");
-            destroy_network_interface_descriptions(result);
-            result = NULL;
-        }
-        else if (sprintf(result->mac_address, "%02X:%02X:%02X:%02X:%02X:%02X", mac[0],mac[1],mac[2],mac[3],mac[4],mac[5]) <= 0)
-        {
-            LogError("failed formatting mac address (sprintf failed)");
-            destroy_network_interface_descriptions(result);
-            result = NULL;
-        }
-        else if ((ip_address = inet_ntoa(((struct sockaddr_in*)&ifr->ifr_addr)->sin_addr)) == NULL)
-        {
-            LogError("failed setting the ip address (inet_ntoa failed)");
-            destroy_network_interface_descriptions(result);
-            result = NULL;
-        }
-        else if ((result->ip_address = (char*)malloc(sizeof(char) * (strlen(ip_address) + 1))) == NULL)
-        {
-            LogError("failed setting the ip address (malloc failed)");
-            destroy_network_interface_descriptions(result);
-            result = NULL;
-        }
-        else if (strcpy(result->ip_address, ip_address) == NULL)
+        unsigned char* receive_buffer = (unsigned char*)malloc(size);
+        if (receive_buffer == NULL)
         {
-            LogError("failed setting the ip address (strcpy failed)");
-            destroy_network_interface_descriptions(result);
-            result = NULL;
+            LogError("Failure: unable to allocate a receive buffer of %lu bytes.", (unsigned long)size);
+            result = __FAILURE__;
         }
         else
         {
-            result->next = NULL;
-
-            if (previous_nid != NULL)
-            {
-                previous_nid->next = result;
-            }
+            free_receive_buffer(socket_io_instance);
+            socket_io_instance->receive_buffer = receive_buffer;
+            socket_io_instance->receive_buffer_size = size;
+            result = 0;
         }
     }
 
     return result;
 }
 
-static int get_network_interface_descriptions(int socket, NETWORK_INTERFACE_DESCRIPTION** nid)
+/* the receive buffer of the socket IO, or the one of its event loop when it has none */
+static unsigned char* get_receive_buffer(SOCKET_IO_INSTANCE* socket_io_instance, size_t* size)
 {
-    int result;
-
-    struct ifreq ifr;
-    struct ifconf ifc;
-    char buf[IFREQ_BUFFER_SIZE];
+    unsigned char* result;
 
-    ifc.ifc_len = sizeof(buf);
-    ifc.ifc_buf = buf;
-
-    if (ioctl(socket, SIOCGIFCONF, &ifc) == -1)
+    if (socket_io_instance->receive_buffer != NULL)
     {
-        LogError("ioctl failed querying socket (SIOCGIFCONF, errno=%s)", errno);
-        result = __FAILURE__;
+        result = socket_io_instance->receive_buffer;
+        *size = socket_io_instance->receive_buffer_size;
     }
-    else
+    else if ((result = socketio_event_loop_get_receive_buffer(socket_io_instance->event_loop, size)) == NULL)
     {
-        NETWORK_INTERFACE_DESCRIPTION* root_nid = NULL;
-        NETWORK_INTERFACE_DESCRIPTION* new_nid = NULL;
-
-        struct ifreq* it = ifc.ifc_req;
-        const struct ifreq* const end = it + (ifc.ifc_len / sizeof(struct ifreq));
+        LogError("Failure: unable to get the receive buffer of the event loop.");
+    }
 
-        result = 0;
+    return result;
+}
+
+/* one on_bytes_received per recv */
+static int receive_bytes_unbatched(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    int result = 0;
+    ssize_t received = 0;
+    do
+    {
+        size_t buffer_size;
+        unsigned char* buffer = get_receive_buffer(socket_io_instance, &buffer_size);
+        if (buffer == NULL)
+        {
+            indicate_error(socket_io_instance);
+            result = __FAILURE__;
+            break;
+        }
+
+        received = recv(socket_io_instance->socket, buffer, buffer_size, 0);
+        if (received > 0)
+        {
+            if (socket_io_instance->on_bytes_received != NULL)
+            {
+                /* Explicitly ignoring here the result of the callback */
+                (void)socket_io_instance->on_bytes_received(socket_io_instance->on_bytes_received_context, buffer, received);
+            }
+        }
+        else if (received == 0)
+        {
+            // Do not log error here due to this is probably the socket being closed on the other end
+            indicate_error(socket_io_instance);
+            result = __FAILURE__;
+        }
+        else if (received < 0 && errno != EAGAIN)
+        {
+            LogError("Socketio_Failure: Receiving data from endpoint: errno=%d.", errno);
+            indicate_error(socket_io_instance);
+            result = __FAILURE__;
+        }
+
+    } while (received > 0 && socket_io_instance->io_state == IO_STATE_OPEN);
+
+    return result;
+}
+
+/* reads what the socket has into the receive buffer and indicates it with one on_bytes_received. The own buffer of the socket IO grows
+   up to SOCKETIO_MAX_RECEIVE_BATCH_SIZE and keeps its size for the next receives, the buffer of the event loop does not grow */
+static int receive_bytes_batched(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    int result = 0;
+    size_t received_size = 0;
+    ssize_t received = 0;
+    int receive_error = 0;
+    size_t buffer_size;
+    unsigned char* buffer = get_receive_buffer(socket_io_instance, &buffer_size);
+
+    while (buffer != NULL)
+    {
+        if (received_size == buffer_size)
+        {
+            size_t new_size = (buffer_size < SOCKETIO_MAX_RECEIVE_BATCH_SIZE / 2) ? buffer_size * 2 : SOCKETIO_MAX_RECEIVE_BATCH_SIZE;
+            unsigned char* new_buffer = NULL;
+            if ((new_size <= buffer_size) ||
+                (socket_io_instance->receive_buffer == NULL))
+            {
+                /* the buffer is as large as a batch gets, or it is the one of the event loop */
+            }
+            else if (socket_io_instance->receive_buffer != socket_io_instance->recv_bytes)
+            {
+                new_buffer = (unsigned char*)realloc(socket_io_instance->receive_buffer, new_size);
+            }
+            else if ((new_buffer = (unsigned char*)malloc(new_size)) != NULL)
+            {
+                (void)memcpy(new_buffer, socket_io_instance->recv_bytes, received_size);
+            }
+
+            if (new_buffer != NULL)
+            {
+                socket_io_instance->receive_buffer = new_buffer;
+                socket_io_instance->receive_buffer_size = new_size;
+            }
+            else
+            {
+                /* the buffer cannot grow, what it holds is indicated and it is reused */
+                if (socket_io_instance->on_bytes_received != NULL)
+                {
+                    (void)socket_io_instance->on_bytes_received(socket_io_instance->on_bytes_received_context, buffer, received_size);
+                }
+                received_size = 0;
+                if (socket_io_instance->io_state != IO_STATE_OPEN)
+                {
+                    break;
+                }
+            }
+
+            /* the callback may also have changed the buffer with the receive_buffer_size option */
+            if ((buffer = get_receive_buffer(socket_io_instance, &buffer_size)) == NULL)
+            {
+                break;
+            }
+        }
+
+        received = recv(socket_io_instance->socket, buffer + received_size, buffer_size - received_size, 0);
+        if (received > 0)
+        {
+            /* a read that does not fill the buffer emptied the socket, asking again would only get EAGAIN */
+            bool is_drained = ((size_t)received < buffer_size - received_size);
+            received_size += (size_t)received;
+            if (is_drained)
+            {
+                break;
+            }
+        }
+        else
+        {
+            if (received < 0)
+            {
+                receive_error = errno;
+            }
+            break;
+        }
+    }
+
+    /* the bytes received before the socket failed or was closed by the peer are indicated first */
+    if ((received_size > 0) &&
+        (buffer != NULL) &&
+        (socket_io_instance->io_state == IO_STATE_OPEN) &&
+        (socket_io_instance->on_bytes_received != NULL))
+    {
+        (void)socket_io_instance->on_bytes_received(socket_io_instance->on_bytes_received_context, buffer, received_size);
+    }
+
+    if (buffer == NULL)
+    {
+        indicate_error(socket_io_instance);
+        result = __FAILURE__;
+    }
+    else if (received == 0)
+    {
+        // Do not log error here due to this is probably the socket being closed on the other end
+        indicate_error(socket_io_instance);
+        result = __FAILURE__;
+    }
+    else if (received < 0 && receive_error != EAGAIN)
+    {
+        LogError("Socketio_Failure: Receiving data from endpoint: errno=%d.", receive_error);
+        indicate_error(socket_io_instance);
+        result = __FAILURE__;
+    }
+
+    return result;
+}
+
+static int receive_bytes(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    return socket_io_instance->receive_batched ? receive_bytes_batched(socket_io_instance) : receive_bytes_unbatched(socket_io_instance);
+}
+
+static void on_socket_event(void* context, unsigned int events);
+
+/* the socket is always watched for reads, and for writes only while sends are pending, so that an idle socket never wakes the loop */
+static unsigned int get_events_to_watch(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    unsigned int result;
+
+    if (singlylinkedlist_get_head_item(socket_io_instance->pending_io_list) == NULL)
+    {
+        result = SOCKETIO_EVENT_READABLE;
+    }
+    else
+    {
+        result = SOCKETIO_EVENT_READABLE | SOCKETIO_EVENT_WRITABLE;
+    }
+
+    return result;
+}
+
+static int watch_socket(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    int result;
+
+    if (socket_io_instance->event_loop == NULL)
+    {
+        result = 0;
+    }
+    else
+    {
+        socket_io_instance->watched_events = get_events_to_watch(socket_io_instance);
+        socket_io_instance->event_loop_registration = socketio_event_loop_register(socket_io_instance->event_loop, socket_io_instance->socket, socket_io_instance->watched_events, on_socket_event, socket_io_instance);
+        if (socket_io_instance->event_loop_registration == NULL)
+        {
+            LogError("Failure: socketio_event_loop_register failed.");
+            result = __FAILURE__;
+        }
+        else
+        {
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+static void unwatch_socket(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    if (socket_io_instance->event_loop_registration != NULL)
+    {
+        socketio_event_loop_unregister(socket_io_instance->event_loop_registration);
+        socket_io_instance->event_loop_registration = NULL;
+    }
+}
+
+static void update_watched_events(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    if (socket_io_instance->event_loop_registration != NULL)
+    {
+        unsigned int events = get_events_to_watch(socket_io_instance);
+        if (events != socket_io_instance->watched_events)
+        {
+            if (socketio_event_loop_modify(socket_io_instance->event_loop_registration, events) != 0)
+            {
+                /* pending sends would never be flushed */
+                LogError("Failure: socketio_event_loop_modify failed.");
+                unwatch_socket(socket_io_instance);
+                socket_io_instance->io_state = IO_STATE_ERROR;
+                indicate_error(socket_io_instance);
+            }
+            else
+            {
+                socket_io_instance->watched_events = events;
+            }
+        }
+    }
+}
+
+#ifndef __APPLE__
+static int set_target_network_interface(int socket, const char* mac_address);
+#endif //__APPLE__
+
+static int get_time_ms(uint64_t* time_ms)
+{
+    int result;
+    struct timespec ts;
+
+    if (get_time_ns(&ts) != 0)
+    {
+        LogError("Failure: cannot get the current time.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        *time_ms = (uint64_t)ts.tv_sec * MILLISECONDS_IN_1_SECOND + (uint64_t)ts.tv_nsec / NANOSECONDS_IN_1_MILLISECOND;
+        result = 0;
+    }
+
+    return result;
+}
+
+static void release_dns_lookup(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    if (socket_io_instance->dns_lookup != NULL)
+    {
+        dns_resolver_release(socket_io_instance->dns_lookup);
+        socket_io_instance->dns_lookup = NULL;
+    }
+}
+
+static void indicate_open_complete(SOCKET_IO_INSTANCE* socket_io_instance, IO_OPEN_RESULT open_result, int code)
+{
+    if (socket_io_instance->on_io_open_complete != NULL)
+    {
+        IO_OPEN_RESULT_DETAILED open_result_detailed;
+        open_result_detailed.result = open_result;
+        open_result_detailed.code = code;
+        socket_io_instance->on_io_open_complete(socket_io_instance->on_io_open_complete_context, open_result_detailed);
+    }
+}
+
+static bool is_supported_address(const struct addrinfo* address)
+{
+    return (address->ai_addrlen <= sizeof(struct sockaddr_storage)) &&
+        (((address->ai_family == AF_INET) && (address->ai_addrlen >= sizeof(struct sockaddr_in))) ||
+         ((address->ai_family == AF_INET6) && (address->ai_addrlen >= sizeof(struct sockaddr_in6))));
+}
+
+/* the first address at or after address whose family is family, or is not family when is_family is false */
+static const struct addrinfo* find_address(const struct addrinfo* address, int family, bool is_family)
+{
+    while ((address != NULL) && (!is_supported_address(address) || ((address->ai_family == family) != is_family)))
+    {
+        address = address->ai_next;
+    }
+
+    return address;
+}
+
+/* the addresses are tried alternating the address families, starting with the family of the first address, which getaddrinfo sorted
+   first (RFC 8305 section 4), so that a family that does not work only delays the connect by one attempt */
+static CONNECT_RACE* create_connect_race(const struct addrinfo* addresses, int port)
+{
+    CONNECT_RACE* result;
+    const struct addrinfo* first_address = find_address(addresses, AF_UNSPEC, false);
+    const struct addrinfo* address;
+    size_t address_count = 0;
+
+    for (address = first_address; address != NULL; address = find_address(address->ai_next, AF_UNSPEC, false))
+    {
+        address_count++;
+    }
+
+    if (address_count == 0)
+    {
+        LogError("Failure: no IPv4 or IPv6 address to connect to.");
+        result = NULL;
+    }
+    else if ((result = (CONNECT_RACE*)malloc(sizeof(CONNECT_RACE) + (address_count * sizeof(CONNECT_ADDRESS)))) == NULL)
+    {
+        LogError("Failure: cannot allocate the connect race.");
+    }
+    else
+    {
+        const struct addrinfo* next_addresses[2];
+        size_t family_index = 0;
+
+        next_addresses[0] = first_address;
+        next_addresses[1] = find_address(first_address, first_address->ai_family, false);
+
+        result->attempt_count = 0;
+        result->last_attempt_start_ms = 0;
+        result->last_error = 0;
+        result->next_address = 0;
+        result->address_count = 0;
+
+        while (result->address_count < address_count)
+        {
+            if ((address = next_addresses[family_index]) != NULL)
+            {
+                CONNECT_ADDRESS* connect_address = &result->addresses[result->address_count++];
+                (void)memcpy(&connect_address->address, address->ai_addr, address->ai_addrlen);
+                connect_address->address_length = (socklen_t)address->ai_addrlen;
+                /* the resolver looks the host name up without a service, the port is set here */
+                if (address->ai_family == AF_INET)
+                {
+                    ((struct sockaddr_in*)&connect_address->address)->sin_port = htons((uint16_t)port);
+                }
+                else
+                {
+                    ((struct sockaddr_in6*)&connect_address->address)->sin6_port = htons((uint16_t)port);
+                }
+
+                next_addresses[family_index] = find_address(address->ai_next, first_address->ai_family, (family_index == 0));
+            }
+
+            family_index = 1 - family_index;
+        }
+    }
+
+    return result;
+}
+
+/* the race of a Unix domain socket has its one address, a path starting with '@' names a socket in the abstract namespace of Linux, which has
+   no file and goes away with its listener */
+static CONNECT_RACE* create_unix_connect_race(const char* path)
+{
+    CONNECT_RACE* result;
+    size_t path_length = strlen(path);
+
+    if (path_length >= sizeof(((struct sockaddr_un*)NULL)->sun_path))
+    {
+        LogError("Failure: the Unix domain socket path %s is longer than %lu characters.", path, (unsigned long)(sizeof(((struct sockaddr_un*)NULL)->sun_path) - 1));
+        result = NULL;
+    }
+    else if ((result = (CONNECT_RACE*)malloc(sizeof(CONNECT_RACE) + sizeof(CONNECT_ADDRESS))) == NULL)
+    {
+        LogError("Failure: cannot allocate the connect race.");
+    }
+    else
+    {
+        struct sockaddr_un* address = (struct sockaddr_un*)&result->addresses[0].address;
+
+        result->attempt_count = 0;
+        result->last_attempt_start_ms = 0;
+        result->last_error = 0;
+        result->next_address = 0;
+        result->address_count = 1;
+
+        (void)memset(address, 0, sizeof(struct sockaddr_un));
+        address->sun_family = AF_UNIX;
+        (void)memcpy(address->sun_path, path, path_length);
+#ifdef __linux__
+        if (path[0] == '@')
+        {
+            /* the name of an abstract socket is the bytes after the leading NUL, the length of the address says where it ends */
+            address->sun_path[0] = '\0';
+            result->addresses[0].address_length = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + path_length);
+        }
+        else
+#endif
+        {
+            result->addresses[0].address_length = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + path_length + 1);
+        }
+    }
+
+    return result;
+}
+
+static void close_connect_attempt(CONNECT_ATTEMPT* connect_attempt)
+{
+    if (connect_attempt->event_loop_registration != NULL)
+    {
+        socketio_event_loop_unregister(connect_attempt->event_loop_registration);
+    }
+    close(connect_attempt->socket);
+}
+
+static void destroy_connect_race(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    if (socket_io_instance->connect_race != NULL)
+    {
+        size_t i;
+        for (i = 0; i < socket_io_instance->connect_race->attempt_count; i++)
+        {
+            close_connect_attempt(&socket_io_instance->connect_race->attempts[i]);
+        }
+
+        free(socket_io_instance->connect_race);
+        socket_io_instance->connect_race = NULL;
+    }
+}
+
+/* the time the connect has to be checked although none of its sockets is ready: the connect timeout, the next check of the DNS lookup or the
+   start of the next attempt, false when there is none */
+static bool get_connect_due_ms(SOCKET_IO_INSTANCE* socket_io_instance, uint64_t now_ms, uint64_t* due_ms)
+{
+    bool result = false;
+    CONNECT_RACE* connect_race = socket_io_instance->connect_race;
+
+    if (socket_io_instance->connect_timeout_ms != 0)
+    {
+        *due_ms = socket_io_instance->connect_start_ms + socket_io_instance->connect_timeout_ms;
+        result = true;
+    }
+
+    if (socket_io_instance->dns_lookup != NULL)
+    {
+        /* a lookup found in the cache is resolved already, the connect starts on the next run of the loop */
+        uint64_t lookup_due_ms = now_ms + ((dns_resolver_get_result(socket_io_instance->dns_lookup, NULL, NULL) == DNS_RESOLVER_PENDING) ? SOCKETIO_DNS_LOOKUP_POLL_INTERVAL_MS : 0);
+        if (!result || (lookup_due_ms < *due_ms))
+        {
+            *due_ms = lookup_due_ms;
+            result = true;
+        }
+    }
+
+    if ((connect_race != NULL) &&
+        (connect_race->attempt_count < SOCKETIO_MAX_CONNECT_ATTEMPTS) &&
+        (connect_race->next_address < connect_race->address_count))
+    {
+        uint64_t attempt_due_ms = connect_race->last_attempt_start_ms + SOCKETIO_CONNECTION_ATTEMPT_DELAY_MS;
+        if (!result || (attempt_due_ms < *due_ms))
+        {
+            *due_ms = attempt_due_ms;
+            result = true;
+        }
+    }
+
+    return result;
+}
+
+/* the loop has no other way to know when the connect is due, it is called each time the connect is checked, and stops the timer once the socket IO
+   is not connecting anymore */
+static void update_connect_timer(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    if (socket_io_instance->connect_timer != NULL)
+    {
+        uint64_t due_ms;
+        uint64_t now_ms;
+
+        if (socket_io_instance->io_state != IO_STATE_OPENING)
+        {
+            socketio_event_loop_stop_timer(socket_io_instance->connect_timer);
+        }
+        else if (get_time_ms(&now_ms) != 0)
+        {
+            LogError("Failure: cannot start the connect timer.");
+        }
+        else if (!get_connect_due_ms(socket_io_instance, now_ms, &due_ms))
+        {
+            socketio_event_loop_stop_timer(socket_io_instance->connect_timer);
+        }
+        else if (socketio_event_loop_start_timer(socket_io_instance->connect_timer, (due_ms > now_ms) ? (unsigned int)(due_ms - now_ms) : 0) != 0)
+        {
+            LogError("Failure: socketio_event_loop_start_timer failed.");
+        }
+    }
+}
+
+/* the socket IO goes back to closed, so that it can be opened again, the callback may destroy it */
+static void indicate_connect_failed(SOCKET_IO_INSTANCE* socket_io_instance, int code)
+{
+    release_dns_lookup(socket_io_instance);
+    destroy_connect_race(socket_io_instance);
+    socket_io_instance->io_state = IO_STATE_CLOSED;
+    update_connect_timer(socket_io_instance);
+    indicate_open_complete(socket_io_instance, IO_OPEN_ERROR, code);
+}
+
+/* the first socket that connects becomes the socket of the socket IO, the attempts still in progress are abandoned */
+static int win_connect_race(SOCKET_IO_INSTANCE* socket_io_instance, int connected_socket)
+{
+    int result;
+
+    socket_io_instance->socket = connected_socket;
+    socket_io_instance->io_state = IO_STATE_OPEN;
+
+    if (watch_socket(socket_io_instance) != 0)
+    {
+        socket_io_instance->connect_race->last_error = __FAILURE__;
+        close(connected_socket);
+        socket_io_instance->socket = INVALID_SOCKET;
+        socket_io_instance->io_state = IO_STATE_OPENING;
+        result = __FAILURE__;
+    }
+    else
+    {
+        destroy_connect_race(socket_io_instance);
+        result = 0;
+    }
+
+    return result;
+}
+
+static void on_connect_attempt_event(void* context, unsigned int events);
+
+/* the connect runs without waiting, the loop reports the socket writable once it is finished, successfully or not */
+static int add_connect_attempt(SOCKET_IO_INSTANCE* socket_io_instance, int attempt_socket)
+{
+    int result;
+    CONNECT_RACE* connect_race = socket_io_instance->connect_race;
+    CONNECT_ATTEMPT* connect_attempt = &connect_race->attempts[connect_race->attempt_count];
+
+    connect_attempt->socket = attempt_socket;
+    connect_attempt->event_loop_registration = NULL;
+
+    if ((socket_io_instance->event_loop != NULL) &&
+        ((connect_attempt->event_loop_registration = socketio_event_loop_register(socket_io_instance->event_loop, attempt_socket, SOCKETIO_EVENT_WRITABLE, on_connect_attempt_event, socket_io_instance)) == NULL))
+    {
+        LogError("Failure: socketio_event_loop_register failed.");
+        connect_race->last_error = __FAILURE__;
+        close(attempt_socket);
+        result = __FAILURE__;
+    }
+    else
+    {
+        connect_race->attempt_count++;
+        (void)get_time_ms(&connect_race->last_attempt_start_ms);
+        result = 0;
+    }
+
+    return result;
+}
+
+static int set_tcp_option(SOCKET_IO_INSTANCE* socket_io_instance, int tcp_socket, size_t index)
+{
+    int result;
+
+    if (setsockopt(tcp_socket, tcp_options[index].level, tcp_options[index].option_name, &socket_io_instance->tcp_option_values[index], sizeof(int)) != 0)
+    {
+        LogError("Failure: setting option %s failed, errno %d.", tcp_options[index].name, errno);
+        result = errno;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+/* sets the TCP options that were set before the socket existed, the options are not set on a Unix domain socket */
+static int set_tcp_options(SOCKET_IO_INSTANCE* socket_io_instance, int tcp_socket)
+{
+    int result = 0;
+    size_t i;
+
+    for (i = 0; (result == 0) && (i < TCP_OPTION_COUNT); i++)
+    {
+        if (socket_io_instance->tcp_option_is_set[i])
+        {
+            result = set_tcp_option(socket_io_instance, tcp_socket, i);
+        }
+    }
+
+    return result;
+}
+
+/* starts connecting the next addresses until a connect is in progress or one connected, fails when no address is left to try */
+static int connect_next_address(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    int result = __FAILURE__;
+    CONNECT_RACE* connect_race = socket_io_instance->connect_race;
+
+    while ((result != 0) && (connect_race->next_address < connect_race->address_count))
+    {
+        const CONNECT_ADDRESS* connect_address = &connect_race->addresses[connect_race->next_address++];
+        int attempt_socket = socket(connect_address->address.ss_family, SOCK_STREAM, 0);
+        int flags;
+        int option_error;
+        int connect_result = 0;
+
+        if (attempt_socket < SOCKET_SUCCESS)
+        {
+            LogError("Failure: socket create failure %d.", errno);
+            connect_race->last_error = errno;
+        }
+#ifndef __APPLE__
+        else if (socket_io_instance->target_mac_address != NULL &&
+                 connect_address->address.ss_family != AF_UNIX &&
+                 set_target_network_interface(attempt_socket, CONSTSTRING_c_str(socket_io_instance->target_mac_address)) != 0)
+        {
+            LogError("Failure: failed selecting target network interface (MACADDR=%s).", CONSTSTRING_c_str(socket_io_instance->target_mac_address));
+            connect_race->last_error = __FAILURE__;
+            close(attempt_socket);
+        }
+#endif //__APPLE__
+        else if ((connect_address->address.ss_family != AF_UNIX) &&
+                 ((option_error = set_tcp_options(socket_io_instance, attempt_socket)) != 0))
+        {
+            connect_race->last_error = option_error;
+            close(attempt_socket);
+        }
+        else if ((-1 == (flags = fcntl(attempt_socket, F_GETFL, 0))) ||
+                 (fcntl(attempt_socket, F_SETFL, flags | O_NONBLOCK) == -1))
+        {
+            LogError("Failure: fcntl failure %d.", errno);
+            connect_race->last_error = errno;
+            close(attempt_socket);
+        }
+        else if (((connect_result = connect(attempt_socket, (const struct sockaddr*)&connect_address->address, connect_address->address_length)) != 0) && (errno != EINPROGRESS))
+        {
+            LogError("Failure: connect failure %d.", errno);
+            connect_race->last_error = errno;
+            close(attempt_socket);
+        }
+        else if (connect_result == 0)
+        {
+            result = win_connect_race(socket_io_instance, attempt_socket);
+        }
+        else
+        {
+            result = add_connect_attempt(socket_io_instance, attempt_socket);
+        }
+    }
+
+    return result;
+}
+
+/* returns 0 once a connect is in progress or the socket connected, the socket IO is IO_STATE_OPENING until then. connect_race is NULL when it
+   could not be created */
+static int start_connect_race(SOCKET_IO_INSTANCE* socket_io_instance, CONNECT_RACE* connect_race, int* error_code)
+{
+    int result;
+
+    if ((socket_io_instance->connect_race = connect_race) == NULL)
+    {
+        *error_code = __FAILURE__;
+        result = __FAILURE__;
+    }
+    else if (connect_next_address(socket_io_instance) != 0)
+    {
+        *error_code = socket_io_instance->connect_race->last_error;
+        destroy_connect_race(socket_io_instance);
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+/* removes the attempt from the race, the last attempt takes its place, its socket is not closed */
+static int remove_connect_attempt(CONNECT_RACE* connect_race, size_t index)
+{
+    int result = connect_race->attempts[index].socket;
+
+    if (connect_race->attempts[index].event_loop_registration != NULL)
+    {
+        socketio_event_loop_unregister(connect_race->attempts[index].event_loop_registration);
+    }
+
+    connect_race->attempt_count--;
+    connect_race->attempts[index] = connect_race->attempts[connect_race->attempt_count];
+
+    return result;
+}
+
+/* called once the socket of the attempt is writable, SO_ERROR tells whether its connect succeeded */
+static void finish_connect_attempt(SOCKET_IO_INSTANCE* socket_io_instance, size_t index)
+{
+    CONNECT_RACE* connect_race = socket_io_instance->connect_race;
+    int attempt_socket = remove_connect_attempt(connect_race, index);
+    int so_error = 0;
+    socklen_t len = sizeof(so_error);
+
+    if (getsockopt(attempt_socket, SOL_SOCKET, SO_ERROR, &so_error, &len) != 0)
+    {
+        LogError("Failure: getsockopt failure %d.", errno);
+        connect_race->last_error = errno;
+        close(attempt_socket);
+    }
+    else if (so_error != 0)
+    {
+        LogError("Failure: connect failure %d.", so_error);
+        connect_race->last_error = so_error;
+        close(attempt_socket);
+    }
+    else
+    {
+        (void)win_connect_race(socket_io_instance, attempt_socket);
+    }
+}
+
+static bool is_connect_timed_out(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    uint64_t now_ms;
+
+    return (socket_io_instance->connect_timeout_ms != 0) &&
+        (get_time_ms(&now_ms) == 0) &&
+        (now_ms - socket_io_instance->connect_start_ms >= socket_io_instance->connect_timeout_ms);
+}
+
+static bool is_next_attempt_due(CONNECT_RACE* connect_race)
+{
+    uint64_t now_ms;
+
+    return (connect_race->attempt_count < SOCKETIO_MAX_CONNECT_ATTEMPTS) &&
+        (get_time_ms(&now_ms) == 0) &&
+        (now_ms - connect_race->last_attempt_start_ms >= SOCKETIO_CONNECTION_ATTEMPT_DELAY_MS);
+}
+
+/* the attempts are polled without waiting, from socketio_dowork, or when the event loop reports one of them or the connect timer is due, a thread
+   driving many socket IOs is not held by a slow endpoint. The next address is tried once the attempts in progress failed, or alongside them once
+   the connection attempt delay elapsed, so an address that does not answer only delays the connect by the delay */
+static void check_connect_race(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    CONNECT_RACE* connect_race = socket_io_instance->connect_race;
+    struct pollfd fds[SOCKETIO_MAX_CONNECT_ATTEMPTS];
+    size_t attempt_count = connect_race->attempt_count;
+    size_t i;
+
+    for (i = 0; i < attempt_count; i++)
+    {
+        fds[i].fd = connect_race->attempts[i].socket;
+        fds[i].events = POLLOUT;
+        fds[i].revents = 0;
+    }
+
+    if ((poll(fds, attempt_count, 0) < 0) && (errno != EINTR))
+    {
+        LogError("Failure: poll failure, errno %d.", errno);
+        indicate_connect_failed(socket_io_instance, errno);
+    }
+    else
+    {
+        /* from the last attempt, removing an attempt moves the last one in its place */
+        for (i = attempt_count; (i > 0) && (socket_io_instance->io_state == IO_STATE_OPENING); i--)
+        {
+            if (fds[i - 1].revents != 0)
+            {
+                finish_connect_attempt(socket_io_instance, i - 1);
+            }
+        }
+
+        if ((socket_io_instance->io_state == IO_STATE_OPENING) &&
+            ((connect_race->attempt_count == 0) || is_next_attempt_due(connect_race)))
+        {
+            (void)connect_next_address(socket_io_instance);
+        }
+
+        if (socket_io_instance->io_state == IO_STATE_OPEN)
+        {
+            update_connect_timer(socket_io_instance);
+            indicate_open_complete(socket_io_instance, IO_OPEN_OK, 0);
+        }
+        else if (connect_race->attempt_count == 0)
+        {
+            LogError("Failure: cannot connect to any address of %s.", socket_io_instance->hostname);
+            indicate_connect_failed(socket_io_instance, connect_race->last_error);
+        }
+        else if (is_connect_timed_out(socket_io_instance))
+        {
+            LogError("Failure: connect timed out after %u ms.", socket_io_instance->connect_timeout_ms);
+            indicate_connect_failed(socket_io_instance, CONNECT_TIMEOUT_ERROR_CODE);
+        }
+        else
+        {
+            update_connect_timer(socket_io_instance);
+        }
+    }
+}
+
+static void on_connect_attempt_event(void* context, unsigned int events)
+{
+    SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)context;
+    (void)events;
+    /* the open callback may close or destroy the socket IO, it receives on the next run of the loop */
+    if (socket_io_instance->connect_race != NULL)
+    {
+        check_connect_race(socket_io_instance);
+    }
+}
+
+/* the socket is not registered with the event loop while the host name is resolved, socketio_dowork or the connect timer connects it once the
+   resolver has the addresses */
+static void check_dns_lookup(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    const struct addrinfo* addresses = NULL;
+    int error = 0;
+    DNS_RESOLVER_RESULT dns_result = dns_resolver_get_result(socket_io_instance->dns_lookup, &addresses, &error);
+
+    if (dns_result == DNS_RESOLVER_PENDING)
+    {
+        if (is_connect_timed_out(socket_io_instance))
+        {
+            LogError("Failure: resolving %s timed out after %u ms.", socket_io_instance->hostname, socket_io_instance->connect_timeout_ms);
+            indicate_connect_failed(socket_io_instance, CONNECT_TIMEOUT_ERROR_CODE);
+        }
+        else
+        {
+            update_connect_timer(socket_io_instance);
+        }
+    }
+    else if (dns_result != DNS_RESOLVER_OK)
+    {
+        LogError("Failure: getaddrinfo failure %d.", error);
+        indicate_connect_failed(socket_io_instance, error);
+    }
+    else
+    {
+        int start_result = start_connect_race(socket_io_instance, create_connect_race(addresses, socket_io_instance->port), &error);
+        /* the addresses are copied in the race, the cache keeps them for the next lookups of the host name */
+        release_dns_lookup(socket_io_instance);
+
+        if (start_result != 0)
+        {
+            indicate_connect_failed(socket_io_instance, error);
+        }
+        else
+        {
+            update_connect_timer(socket_io_instance);
+            if (socket_io_instance->io_state == IO_STATE_OPEN)
+            {
+                indicate_open_complete(socket_io_instance, IO_OPEN_OK, 0);
+            }
+        }
+    }
+}
+
+static void on_connect_timer(void* context)
+{
+    SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)context;
+
+    if (socket_io_instance->dns_lookup != NULL)
+    {
+        check_dns_lookup(socket_io_instance);
+    }
+    else if (socket_io_instance->connect_race != NULL)
+    {
+        check_connect_race(socket_io_instance);
+    }
+}
+
+static void on_socket_event(void* context, unsigned int events)
+{
+    SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)context;
+    int result = 0;
+
+    if ((events & (SOCKETIO_EVENT_WRITABLE | SOCKETIO_EVENT_ERROR)) != 0)
+    {
+        result = send_pending_ios(socket_io_instance);
+    }
+
+    if ((result == 0) &&
+        (socket_io_instance->io_state == IO_STATE_OPEN) &&
+        ((events & (SOCKETIO_EVENT_READABLE | SOCKETIO_EVENT_ERROR)) != 0))
+    {
+        result = receive_bytes(socket_io_instance);
+    }
+
+    if ((result != 0) || (socket_io_instance->io_state != IO_STATE_OPEN))
+    {
+        /* a closed or failed socket stays readable, watching it would wake the loop on every run until the socket IO is closed */
+        unwatch_socket(socket_io_instance);
+    }
+    else
+    {
+        update_watched_events(socket_io_instance);
+    }
+}
+
+static STATIC_VAR_UNUSED void signal_callback(int signum)
+{
+    AZURE_UNREFERENCED_PARAMETER(signum);
+    LogError("Socket received signal %d.", signum);
+}
+
+#ifndef __APPLE__
+static void destroy_network_interface_descriptions(NETWORK_INTERFACE_DESCRIPTION* nid)
+{
+    if (nid != NULL)
+    {
+        if (nid->next != NULL)
+        {
+            destroy_network_interface_descriptions(nid->next);
+        }
+
+        if (nid->name != NULL)
+        {
+            free(nid->name);
+        }
+
+        if (nid->mac_address != NULL)
+        {
+            free(nid->mac_address);
+        }
+
+        if (nid->ip_address != NULL)
+        {
+            free(nid->ip_address);
+        }
+
+        free(nid);
+    }
+}
+
+static NETWORK_INTERFACE_DESCRIPTION* create_network_interface_description(struct ifreq *ifr, NETWORK_INTERFACE_DESCRIPTION* previous_nid)
+{
+    NETWORK_INTERFACE_DESCRIPTION* result;
+
+    if ((result = (NETWORK_INTERFACE_DESCRIPTION*)malloc(sizeof(NETWORK_INTERFACE_DESCRIPTION))) == NULL)
+    {
+        LogError("Failed allocating NETWORK_INTERFACE_DESCRIPTION");
+    }
+    else if ((result->name = (char*)malloc(sizeof(char) * (strlen(ifr->ifr_name) + 1))) == NULL)
+    {
+        LogError("failed setting interface description name (malloc failed)");
+        destroy_network_interface_descriptions(result);
+        result = NULL;
+    }
+    else if (strcpy(result->name, ifr->ifr_name) == NULL)
+    {
+        LogError("failed setting interface description name (strcpy failed)");
+        destroy_network_interface_descriptions(result);
+        result = NULL;
+    }
+    else
+    {
+        char* ip_address;
+        unsigned char* mac = (unsigned char*)ifr->ifr_hwaddr.sa_data;
+
+        if ((result->mac_address = (char*)malloc(sizeof(char) * MAC_ADDRESS_STRING_LENGTH)) == NULL)
+        {
+            LogError("failed formatting mac address (malloc failed)");
+            destroy_network_interface_descriptions(result);
+            result = NULL;
+        }
+        else if (sprintf(result->mac_address, "%02X:%02X:%02X:%02X:%02X:%02X", mac[0],mac[1],mac[2],mac[3],mac[4],mac[5]) <= 0)
+        {
+            LogError("failed formatting mac address (sprintf failed)");
+            destroy_network_interface_descriptions(result);
+            result = NULL;
+        }
+        else if ((ip_address = inet_ntoa(((struct sockaddr_in*)&ifr->ifr_addr)->sin_addr)) == NULL)
+        {
+            LogError("failed setting the ip address (inet_ntoa failed)");
+            destroy_network_interface_descriptions(result);
+            result = NULL;
+        }
+        else if ((result->ip_address = (char*)malloc(sizeof(char) * (strlen(ip_address) + 1))) == NULL)
+        {
+            LogError("failed setting the ip address (malloc failed)");
+            destroy_network_interface_descriptions(result);
+            result = NULL;
+        }
+        else if (strcpy(result->ip_address, ip_address) == NULL)
+        {
+            LogError("failed setting the ip address (strcpy failed)");
+            destroy_network_interface_descriptions(result);
+            result = NULL;
+        }
+        else
+        {
+            result->next = NULL;
+
+            if (previous_nid != NULL)
+            {
+                previous_nid->next = result;
+            }
+        }
+    }
+
+    return result;
+}
+
+static int get_network_interface_descriptions(int socket, NETWORK_INTERFACE_DESCRIPTION** nid)
+{
+    int result;
+
+    struct ifreq ifr;
+    struct ifconf ifc;
+    char buf[IFREQ_BUFFER_SIZE];
+
+    ifc.ifc_len = sizeof(buf);
+    ifc.ifc_buf = buf;
+
+    if (ioctl(socket, SIOCGIFCONF, &ifc) == -1)
+    {
+        LogError("ioctl failed querying socket (SIOCGIFCONF, errno=%s)", errno);
+        result = __FAILURE__;
+    }
+    else
+    {
+        NETWORK_INTERFACE_DESCRIPTION* root_nid = NULL;
+        NETWORK_INTERFACE_DESCRIPTION* new_nid = NULL;
+
+        struct ifreq* it = ifc.ifc_req;
+        const struct ifreq* const end = it + (ifc.ifc_len / sizeof(struct ifreq));
+
+        result = 0;
 
         for (; it != end; ++it)
         {
@@ -418,7 +1749,19 @@ static int get_network_interface_descriptions(int socket, NETWORK_INTERFACE_DESC
     return result;
 }
 
-static int set_target_network_interface(int socket, char* mac_address)
+/*the option value may be given in lower case, the descriptions are in upper case*/
+static int mac_address_equals(const char* mac_address, const char* description_mac_address)
+{
+    while ((*mac_address != '\0') && (toupper((int)*mac_address) == (int)*description_mac_address))
+    {
+        mac_address++;
+        description_mac_address++;
+    }
+
+    return (*mac_address == '\0') && (*description_mac_address == '\0');
+}
+
+static int set_target_network_interface(int socket, const char* mac_address)
 {
     int result;
     NETWORK_INTERFACE_DESCRIPTION* nid;
@@ -434,7 +1777,7 @@ static int set_target_network_interface(int socket, char* mac_address)
 
         while(current_nid != NULL)
         {
-            if (strcmp(mac_address, current_nid->mac_address) == 0)
+            if (mac_address_equals(mac_address, current_nid->mac_address))
             {
                 break;
             }
@@ -465,6 +1808,11 @@ static int set_target_network_interface(int socket, char* mac_address)
 #endif //__APPLE__
 
 CONCRETE_IO_HANDLE socketio_create(void* io_create_parameters)
+{
+    return socketio_create_with_arena(io_create_parameters, NULL);
+}
+
+CONCRETE_IO_HANDLE socketio_create_with_arena(void* io_create_parameters, ARENA_HANDLE arena)
 {
     SOCKETIO_CONFIG* socket_io_config = io_create_parameters;
     SOCKET_IO_INSTANCE* result;
@@ -476,21 +1824,30 @@ CONCRETE_IO_HANDLE socketio_create(void* io_create_parameters)
     }
     else
     {
-        result = malloc(sizeof(SOCKET_IO_INSTANCE));
+        /* the instance and the hostname are the only allocations that live as long as the socket IO, so they are the ones taken from the arena */
+        result = arena_malloc_or_heap(arena, sizeof(SOCKET_IO_INSTANCE) + RECEIVE_BYTES_VALUE);
         if (result != NULL)
         {
+            result->arena = arena;
             result->pending_io_list = singlylinkedlist_create();
             if (result->pending_io_list == NULL)
             {
                 LogError("Failure: singlylinkedlist_create unable to create pending list.");
-                free(result);
+                arena_free_or_heap(result->arena, result);
+                result = NULL;
+            }
+            else if ((result->pending_io_slab = slab_create(sizeof(PENDING_SOCKET_IO), PENDING_SOCKET_IOS_PER_CHUNK)) == NULL)
+            {
+                LogError("Failure: slab_create unable to create pending IO slab.");
+                singlylinkedlist_destroy(result->pending_io_list);
+                arena_free_or_heap(result->arena, result);
                 result = NULL;
             }
             else
             {
                 if (socket_io_config->hostname != NULL)
                 {
-                    result->hostname = (char*)malloc(strlen(socket_io_config->hostname) + 1);
+                    result->hostname = (char*)arena_malloc_or_heap(result->arena, strlen(socket_io_config->hostname) + 1);
                     if (result->hostname != NULL)
                     {
                         (void)strcpy(result->hostname, socket_io_config->hostname);
@@ -504,22 +1861,42 @@ CONCRETE_IO_HANDLE socketio_create(void* io_create_parameters)
                     result->socket = *((int*)socket_io_config->accepted_socket);
                 }
 
+                result->connect_timer = NULL;
+
                 if ((result->hostname == NULL) && (result->socket == INVALID_SOCKET))
                 {
                     LogError("Failure: hostname == NULL and socket is invalid.");
                     singlylinkedlist_destroy(result->pending_io_list);
-                    free(result);
+                    slab_destroy(result->pending_io_slab);
+                    arena_free_or_heap(result->arena, result);
                     result = NULL;
                 }
                 else
                 {
                     result->port = socket_io_config->port;
                     result->target_mac_address = NULL;
+                    result->unix_socket_path = NULL;
                     result->on_bytes_received = NULL;
                     result->on_io_error = NULL;
                     result->on_bytes_received_context = NULL;
                     result->on_io_error_context = NULL;
                     result->io_state = IO_STATE_CLOSED;
+                    result->on_io_open_complete = NULL;
+                    result->on_io_open_complete_context = NULL;
+                    result->connect_timeout_ms = SOCKETIO_DEFAULT_CONNECT_TIMEOUT_MS;
+                    result->connect_start_ms = 0;
+                    result->dns_lookup = NULL;
+                    result->connect_race = NULL;
+                    (void)memset(result->tcp_option_is_set, 0, sizeof(result->tcp_option_is_set));
+                    /* the connect timeout is measured on the monotonic clock */
+                    set_time_basis();
+                    result->event_loop = NULL;
+                    result->event_loop_registration = NULL;
+                    result->watched_events = 0;
+                    result->receive_buffer = result->recv_bytes;
+                    result->receive_buffer_size = RECEIVE_BYTES_VALUE;
+                    result->receive_size = RECEIVE_BYTES_VALUE;
+                    result->receive_batched = false;
                 }
             }
         }
@@ -537,9 +1914,13 @@ void socketio_destroy(CONCRETE_IO_HANDLE socket_io)
     if (socket_io != NULL)
     {
         SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)socket_io;
+        release_dns_lookup(socket_io_instance);
+        destroy_connect_race(socket_io_instance);
+        socketio_event_loop_destroy_timer(socket_io_instance->connect_timer);
         /* we cannot do much if the close fails, so just ignore the result */
         if (socket_io_instance->socket != INVALID_SOCKET)
         {
+            unwatch_socket(socket_io_instance);
             close(socket_io_instance->socket);
         }
 
@@ -550,8 +1931,7 @@ void socketio_destroy(CONCRETE_IO_HANDLE socket_io)
             PENDING_SOCKET_IO* pending_socket_io = (PENDING_SOCKET_IO*)singlylinkedlist_item_get_value(first_pending_io);
             if (pending_socket_io != NULL)
             {
-                free(pending_socket_io->bytes);
-                free(pending_socket_io);
+                free_pending_io(socket_io_instance, pending_socket_io);
             }
 
             (void)singlylinkedlist_remove(socket_io_instance->pending_io_list, first_pending_io);
@@ -559,17 +1939,22 @@ void socketio_destroy(CONCRETE_IO_HANDLE socket_io)
         }
 
         singlylinkedlist_destroy(socket_io_instance->pending_io_list);
-        free(socket_io_instance->hostname);
-        free(socket_io_instance->target_mac_address);
-        free(socket_io);
+        slab_destroy(socket_io_instance->pending_io_slab);
+        free_receive_buffer(socket_io_instance);
+        arena_free_or_heap(socket_io_instance->arena, socket_io_instance->hostname);
+        if (socket_io_instance->target_mac_address != NULL)
+        {
+            CONSTSTRING_Destroy(socket_io_instance->target_mac_address);
+        }
+        free(socket_io_instance->unix_socket_path);
+        arena_free_or_heap(socket_io_instance->arena, socket_io);
     }
 }
 
 int socketio_open(CONCRETE_IO_HANDLE socket_io, ON_IO_OPEN_COMPLETE on_io_open_complete, void* on_io_open_complete_context, ON_BYTES_RECEIVED on_bytes_received, void* on_bytes_received_context, ON_IO_ERROR on_io_error, void* on_io_error_context)
 {
     int result;
-    int retval = -1;
-    int poll_errno = 0;
+    bool is_connecting = false;
 
     IO_OPEN_RESULT_DETAILED open_result_detailed = { IO_OPEN_OK, 0 };
 
@@ -594,274 +1979,315 @@ int socketio_open(CONCRETE_IO_HANDLE socket_io, ON_IO_OPEN_COMPLETE on_io_open_c
             socket_io_instance->on_io_error = on_io_error;
             socket_io_instance->on_io_error_context = on_io_error_context;
 
-            socket_io_instance->io_state = IO_STATE_OPEN;
+            if (watch_socket(socket_io_instance) != 0)
+            {
+                result = open_result_detailed.code = __FAILURE__;
+            }
+            else
+            {
+                socket_io_instance->io_state = IO_STATE_OPEN;
 
-            result = 0;
+                result = 0;
+            }
         }
         else
         {
             struct addrinfo* addrInfo;
             char portString[16];
 
-            socket_io_instance->socket = socket(AF_INET, SOCK_STREAM, 0);
-            if (socket_io_instance->socket < SOCKET_SUCCESS)
+            socket_io_instance->on_bytes_received = on_bytes_received;
+            socket_io_instance->on_bytes_received_context = on_bytes_received_context;
+
+            socket_io_instance->on_io_error = on_io_error;
+            socket_io_instance->on_io_error_context = on_io_error_context;
+
+            socket_io_instance->on_io_open_complete = on_io_open_complete;
+            socket_io_instance->on_io_open_complete_context = on_io_open_complete_context;
+
+            /* the connect timeout covers resolving the host name and connecting */
+            if (get_time_ms(&socket_io_instance->connect_start_ms) != 0)
             {
-                LogError("Failure: socket create failure %d.", socket_io_instance->socket);
-                open_result_detailed.code = socket_io_instance->socket;
-                result = __FAILURE__;
+                result = open_result_detailed.code = __FAILURE__;
             }
-#ifndef __APPLE__
-            else if (socket_io_instance->target_mac_address != NULL &&
-                     set_target_network_interface(socket_io_instance->socket, socket_io_instance->target_mac_address) != 0)
+            else if (socket_io_instance->unix_socket_path != NULL)
             {
-                LogError("Failure: failed selecting target network interface (MACADDR=%s).", socket_io_instance->target_mac_address);
-                close(socket_io_instance->socket);
-                socket_io_instance->socket = INVALID_SOCKET;
-                result = open_result_detailed.code = __FAILURE__;
+                /* a local socket has nothing to resolve, its connect is finished or refused at once unless the listener's backlog is full */
+                socket_io_instance->io_state = IO_STATE_OPENING;
+                if (start_connect_race(socket_io_instance, create_unix_connect_race(socket_io_instance->unix_socket_path), &open_result_detailed.code) != 0)
+                {
+                    socket_io_instance->io_state = IO_STATE_CLOSED;
+                    result = __FAILURE__;
+                }
+                else
+                {
+                    is_connecting = (socket_io_instance->io_state == IO_STATE_OPENING);
+                    result = 0;
+                }
+            }
+            else if ((socket_io_instance->dns_lookup = dns_resolver_lookup(socket_io_instance->hostname)) != NULL)
+            {
+                /* the resolver has a thread resolve the host name, or has it cached, socketio_dowork or the connect timer connects once it has the addresses */
+                socket_io_instance->io_state = IO_STATE_OPENING;
+                is_connecting = true;
+                result = 0;
             }
-#endif //__APPLE__
             else
             {
+                /* the application does not use the resolver, the host name is resolved here */
                 struct addrinfo addrHint = { 0 };
-                addrHint.ai_family = AF_INET;
+                addrHint.ai_family = AF_UNSPEC;
                 addrHint.ai_socktype = SOCK_STREAM;
                 addrHint.ai_protocol = 0;
 
-                sprintf(portString, "%u", socket_io_instance->port);
-                int err = getaddrinfo(socket_io_instance->hostname, portString, &addrHint, &addrInfo);
-                if (err != 0)
+                sprintf(portString, "%u", socket_io_instance->port);
+                int err = getaddrinfo(socket_io_instance->hostname, portString, &addrHint, &addrInfo);
+                if (err != 0)
+                {
+                    LogError("Failure: getaddrinfo failure %d.", err);
+                    open_result_detailed.code = err;
+                    result = __FAILURE__;
+                }
+                else
+                {
+                    socket_io_instance->io_state = IO_STATE_OPENING;
+                    if (start_connect_race(socket_io_instance, create_connect_race(addrInfo, socket_io_instance->port), &open_result_detailed.code) != 0)
+                    {
+                        socket_io_instance->io_state = IO_STATE_CLOSED;
+                        result = __FAILURE__;
+                    }
+                    else
+                    {
+                        is_connecting = (socket_io_instance->io_state == IO_STATE_OPENING);
+                        result = 0;
+                    }
+                    freeaddrinfo(addrInfo);
+                }
+            }
+        }
+    }
+
+    if (is_connecting)
+    {
+        update_connect_timer(socket_io_instance);
+    }
+    else if (on_io_open_complete != NULL)
+    {
+        open_result_detailed.result = result == 0 ? IO_OPEN_OK : IO_OPEN_ERROR;
+        on_io_open_complete(on_io_open_complete_context, open_result_detailed);
+    }
+
+    return result;
+}
+
+int socketio_close(CONCRETE_IO_HANDLE socket_io, ON_IO_CLOSE_COMPLETE on_io_close_complete, void* callback_context)
+{
+    int result = 0;
+
+    if (socket_io == NULL)
+    {
+        result = __FAILURE__;
+    }
+    else
+    {
+        SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)socket_io;
+        if ((socket_io_instance->io_state != IO_STATE_CLOSED) && (socket_io_instance->io_state != IO_STATE_CLOSING))
+        {
+            // Only close if the socket isn't already in the closed or closing state
+            bool is_connecting = (socket_io_instance->io_state == IO_STATE_OPENING);
+
+            release_dns_lookup(socket_io_instance);
+            destroy_connect_race(socket_io_instance);
+            if (socket_io_instance->socket != INVALID_SOCKET)
+            {
+                unwatch_socket(socket_io_instance);
+                (void)shutdown(socket_io_instance->socket, SHUT_RDWR);
+                close(socket_io_instance->socket);
+                socket_io_instance->socket = INVALID_SOCKET;
+            }
+            socket_io_instance->io_state = IO_STATE_CLOSED;
+            update_connect_timer(socket_io_instance);
+
+            if (is_connecting)
+            {
+                indicate_open_complete(socket_io_instance, IO_OPEN_CANCELLED, 0);
+            }
+        }
+
+        if (on_io_close_complete != NULL)
+        {
+            on_io_close_complete(callback_context);
+        }
+
+        result = 0;
+    }
+
+    return result;
+}
+
+static int send_buffers(SOCKET_IO_INSTANCE* socket_io_instance, const CONSTBUFFER* buffers, size_t buffer_count, size_t size, CONSTBUFFER_HANDLE constbuffer, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    int result;
+
+    if (socket_io_instance->io_state != IO_STATE_OPEN)
+    {
+        LogError("Failure: socket state is not opened.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        LIST_ITEM_HANDLE first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
+        if (first_pending_io != NULL)
+        {
+            if (add_pending_io(socket_io_instance, buffers, buffer_count, 0, constbuffer, on_send_complete, callback_context) != 0)
+            {
+                LogError("Failure: add_pending_io failed.");
+                result = __FAILURE__;
+            }
+            else
+            {
+                result = 0;
+            }
+        }
+        else
+        {
+            struct iovec iovecs[SOCKETIO_MAX_IOVECS];
+            struct msghdr message;
+            size_t i;
+
+            /* the buffers past the first SOCKETIO_MAX_IOVECS ones are queued as if the socket had not taken them */
+            for (i = 0; (i < buffer_count) && (i < SOCKETIO_MAX_IOVECS); i++)
+            {
+                iovecs[i].iov_base = (void*)buffers[i].buffer;
+                iovecs[i].iov_len = buffers[i].size;
+            }
+
+            signal(SIGPIPE, SIG_IGN);
+
+            (void)memset(&message, 0, sizeof(message));
+            message.msg_iov = iovecs;
+            message.msg_iovlen = i;
+            ssize_t send_result = sendmsg(socket_io_instance->socket, &message, 0);
+            if (send_result != size)
+            {
+                if (send_result == INVALID_SOCKET && errno != EAGAIN)
                 {
-                    LogError("Failure: getaddrinfo failure %d.", err);
-                    open_result_detailed.code = err;
-                    close(socket_io_instance->socket);
-                    socket_io_instance->socket = INVALID_SOCKET;
+                    LogError("Failure: sending socket failed. errno=%d (%s).", errno, strerror(errno));
                     result = __FAILURE__;
                 }
                 else
                 {
-                    int flags;
-                    if ((-1 == (flags = fcntl(socket_io_instance->socket, F_GETFL, 0))) ||
-                        (fcntl(socket_io_instance->socket, F_SETFL, flags | O_NONBLOCK) == -1))
+                    if (send_result == INVALID_SOCKET && errno == EAGAIN) /*send says "come back later" with EAGAIN - likely the socket buffer cannot accept more data*/
+                    {
+                        // put the full message in the queue
+                        send_result = 0;
+                    }
+
+                    /* queue remaining data */
+                    if (add_pending_io(socket_io_instance, buffers, buffer_count, send_result, constbuffer, on_send_complete, callback_context) != 0)
                     {
-                        LogError("Failure: fcntl failure %d.", errno);
-                        open_result_detailed.code = errno;
-                        close(socket_io_instance->socket);
-                        socket_io_instance->socket = INVALID_SOCKET;
+                        LogError("Failure: add_pending_io failed.");
                         result = __FAILURE__;
                     }
                     else
                     {
-                        err = connect(socket_io_instance->socket, addrInfo->ai_addr, sizeof(*addrInfo->ai_addr));
-                        if ((err != 0) && (errno != EINPROGRESS))
-                        {
-                            LogError("Failure: connect failure %d.", errno);
-                            open_result_detailed.code = errno;
-                            close(socket_io_instance->socket);
-                            socket_io_instance->socket = INVALID_SOCKET;
-                            result = __FAILURE__;
-                        }
-                        else
-                        {
-                            if (err != 0)
-                            {
-                                struct pollfd fd = { 0 };
-                                fd.fd = socket_io_instance->socket;
-                                // Wait until writing is possible.
-                                fd.events = POLLOUT;
-
-                                do
-                                {
-                                    retval = poll(&fd, 1, CONNECT_TIMEOUT_SECONDS * 1000);
-                                    if (retval < 0)
-                                    {
-                                        poll_errno = errno;
-                                    }
-                                } while (retval < 0 && poll_errno == EINTR);
-
-                                if (retval != 1)
-                                {
-                                    LogError("Failure: poll failure, retval %d, errno %d.", retval, poll_errno);
-                                    if (retval == 0) {
-                                        // timeout
-                                        open_result_detailed.code = 9999;
-                                    } else {
-                                        open_result_detailed.code = poll_errno;
-                                    }
-                                    close(socket_io_instance->socket);
-                                    socket_io_instance->socket = INVALID_SOCKET;
-                                    result = __FAILURE__;
-                                }
-                                else
-                                {
-                                    int so_error = 0;
-                                    socklen_t len = sizeof(so_error);
-                                    err = getsockopt(socket_io_instance->socket, SOL_SOCKET, SO_ERROR, &so_error, &len);
-                                    if (err != 0)
-                                    {
-                                        LogError("Failure: getsockopt failure %d.", errno);
-                                        open_result_detailed.code = errno;
-                                        close(socket_io_instance->socket);
-                                        socket_io_instance->socket = INVALID_SOCKET;
-                                        result = __FAILURE__;
-                                    }
-                                    else if (so_error != 0)
-                                    {
-                                        err = so_error;
-                                        LogError("Failure: connect failure %d.", so_error);
-                                        open_result_detailed.code = so_error;
-                                        close(socket_io_instance->socket);
-                                        socket_io_instance->socket = INVALID_SOCKET;
-                                        result = __FAILURE__;
-                                    }
-                                    else
-                                    {
-                                        result = 0;
-                                    }
-                                }
-                            }
-                            else
-                            {
-                                result = 0;
-                            }
-
-                            if (err == 0)
-                            {
-                                socket_io_instance->on_bytes_received = on_bytes_received;
-                                socket_io_instance->on_bytes_received_context = on_bytes_received_context;
-
-                                socket_io_instance->on_io_error = on_io_error;
-                                socket_io_instance->on_io_error_context = on_io_error_context;
-
-                                socket_io_instance->io_state = IO_STATE_OPEN;
-
-                                result = 0;
-                            }
-                        }
+                        /* the first pending send has the event loop watch for the socket to become writable */
+                        update_watched_events(socket_io_instance);
+                        result = 0;
                     }
-                    freeaddrinfo(addrInfo);
                 }
             }
-        }
-    }
+            else
+            {
+                if (on_send_complete != NULL)
+                {
+                    on_send_complete(callback_context, IO_SEND_OK);
+                }
 
-    if (on_io_open_complete != NULL)
-    {
-        open_result_detailed.result = result == 0 ? IO_OPEN_OK : IO_OPEN_ERROR;
-        on_io_open_complete(on_io_open_complete_context, open_result_detailed);
+                result = 0;
+            }
+        }
     }
 
     return result;
 }
 
-int socketio_close(CONCRETE_IO_HANDLE socket_io, ON_IO_CLOSE_COMPLETE on_io_close_complete, void* callback_context)
+int socketio_send(CONCRETE_IO_HANDLE socket_io, const void* buffer, size_t size, ON_SEND_COMPLETE on_send_complete, void* callback_context)
 {
-    int result = 0;
+    int result;
 
-    if (socket_io == NULL)
+    if ((socket_io == NULL) ||
+        (buffer == NULL) ||
+        (size == 0))
     {
+        /* Invalid arguments */
+        LogError("Invalid argument: send given invalid parameter");
         result = __FAILURE__;
     }
     else
     {
-        SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)socket_io;
-        if ((socket_io_instance->io_state != IO_STATE_CLOSED) && (socket_io_instance->io_state != IO_STATE_CLOSING))
-        {
-            // Only close if the socket isn't already in the closed or closing state
-            (void)shutdown(socket_io_instance->socket, SHUT_RDWR);
-            close(socket_io_instance->socket);
-            socket_io_instance->socket = INVALID_SOCKET;
-            socket_io_instance->io_state = IO_STATE_CLOSED;
-        }
+        CONSTBUFFER send_buffer;
+        send_buffer.buffer = (const unsigned char*)buffer;
+        send_buffer.size = size;
+        result = send_buffers((SOCKET_IO_INSTANCE*)socket_io, &send_buffer, 1, size, NULL, on_send_complete, callback_context);
+    }
 
-        if (on_io_close_complete != NULL)
+    return result;
+}
+
+int socketio_sendv(CONCRETE_IO_HANDLE socket_io, const CONSTBUFFER* buffers, size_t buffer_count, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    int result;
+    size_t size = 0;
+    size_t i = 0;
+
+    if ((socket_io != NULL) &&
+        (buffers != NULL))
+    {
+        for (i = 0; i < buffer_count; i++)
         {
-            on_io_close_complete(callback_context);
+            if ((buffers[i].size > 0) &&
+                ((buffers[i].buffer == NULL) || (buffers[i].size > SIZE_MAX - size)))
+            {
+                break;
+            }
+            size += buffers[i].size;
         }
+    }
 
-        result = 0;
+    if ((socket_io == NULL) ||
+        (buffers == NULL) ||
+        (i < buffer_count) ||
+        (size == 0))
+    {
+        /* Invalid arguments */
+        LogError("Invalid argument: sendv given invalid parameter");
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = send_buffers((SOCKET_IO_INSTANCE*)socket_io, buffers, buffer_count, size, NULL, on_send_complete, callback_context);
     }
 
     return result;
 }
 
-int socketio_send(CONCRETE_IO_HANDLE socket_io, const void* buffer, size_t size, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+int socketio_send_constbuffer(CONCRETE_IO_HANDLE socket_io, CONSTBUFFER_HANDLE constbuffer, ON_SEND_COMPLETE on_send_complete, void* callback_context)
 {
     int result;
+    const CONSTBUFFER* content;
 
     if ((socket_io == NULL) ||
-        (buffer == NULL) ||
-        (size == 0))
+        (constbuffer == NULL) ||
+        ((content = CONSTBUFFER_GetContent(constbuffer)) == NULL) ||
+        (content->size == 0))
     {
         /* Invalid arguments */
-        LogError("Invalid argument: send given invalid parameter");
+        LogError("Invalid argument: send_constbuffer given invalid parameter");
         result = __FAILURE__;
     }
     else
     {
-        SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)socket_io;
-        if (socket_io_instance->io_state != IO_STATE_OPEN)
-        {
-            LogError("Failure: socket state is not opened.");
-            result = __FAILURE__;
-        }
-        else
-        {
-            LIST_ITEM_HANDLE first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
-            if (first_pending_io != NULL)
-            {
-                if (add_pending_io(socket_io_instance, buffer, size, on_send_complete, callback_context) != 0)
-                {
-                    LogError("Failure: add_pending_io failed.");
-                    result = __FAILURE__;
-                }
-                else
-                {
-                    result = 0;
-                }
-            }
-            else
-            {
-                signal(SIGPIPE, SIG_IGN);
-
-                ssize_t send_result = send(socket_io_instance->socket, buffer, size, 0);
-                if (send_result != size)
-                {
-                    if (send_result == INVALID_SOCKET && errno != EAGAIN)
-                    {
-                        LogError("Failure: sending socket failed. errno=%d (%s).", errno, strerror(errno));
-                        result = __FAILURE__;
-                    }
-                    else
-                    {
-                        if (send_result == INVALID_SOCKET && errno == EAGAIN) /*send says "come back later" with EAGAIN - likely the socket buffer cannot accept more data*/
-                        {
-                            // put the full message in the queue
-                            send_result = 0;
-                        }
-
-                        /* queue remaining data */
-                        if (add_pending_io(socket_io_instance, buffer + send_result, size - send_result, on_send_complete, callback_context) != 0)
-                        {
-                            LogError("Failure: add_pending_io failed.");
-                            result = __FAILURE__;
-                        }
-                        else
-                        {
-                            result = 0;
-                        }
-                    }
-                }
-                else
-                {
-                    if (on_send_complete != NULL)
-                    {
-                        on_send_complete(callback_context, IO_SEND_OK);
-                    }
-
-                    result = 0;
-                }
-            }
-        }
+        result = send_buffers((SOCKET_IO_INSTANCE*)socket_io, content, 1, content->size, constbuffer, on_send_complete, callback_context);
     }
 
     return result;
@@ -872,120 +2298,106 @@ void socketio_dowork(CONCRETE_IO_HANDLE socket_io)
     if (socket_io != NULL)
     {
         SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)socket_io;
-        LIST_ITEM_HANDLE first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
-        while (first_pending_io != NULL)
+        if (socket_io_instance->dns_lookup != NULL)
         {
-            PENDING_SOCKET_IO* pending_socket_io = (PENDING_SOCKET_IO*)singlylinkedlist_item_get_value(first_pending_io);
-            if (pending_socket_io == NULL)
+            check_dns_lookup(socket_io_instance);
+        }
+        else if (socket_io_instance->io_state == IO_STATE_OPENING)
+        {
+            check_connect_race(socket_io_instance);
+        }
+        /* a socket watched by an event loop is sent to and received from when the loop reports it ready, polling it here would only cost a syscall */
+        else if (socket_io_instance->event_loop_registration == NULL)
+        {
+            (void)send_pending_ios(socket_io_instance);
+
+            if (socket_io_instance->io_state == IO_STATE_OPEN)
             {
-                socket_io_instance->io_state = IO_STATE_ERROR;
-                indicate_error(socket_io_instance);
-                LogError("Failure: retrieving socket from list");
-                break;
+                (void)receive_bytes(socket_io_instance);
             }
+        }
+    }
+}
 
-            signal(SIGPIPE, SIG_IGN);
+static void set_target_mac_address(SOCKET_IO_INSTANCE* socket_io_instance, CONSTSTRING_HANDLE mac_address)
+{
+    if (socket_io_instance->target_mac_address != NULL)
+    {
+        CONSTSTRING_Destroy(socket_io_instance->target_mac_address);
+    }
+    socket_io_instance->target_mac_address = CONSTSTRING_Clone(mac_address);
+}
 
-            ssize_t send_result = send(socket_io_instance->socket, pending_socket_io->bytes, pending_socket_io->size, 0);
-            if (send_result != pending_socket_io->size)
-            {
-                if (send_result == INVALID_SOCKET)
-                {
-                    if (errno == EAGAIN) /*send says "come back later" with EAGAIN - likely the socket buffer cannot accept more data*/
-                    {
-                        /*do nothing until next dowork */
-                        break;
-                    }
-                    else
-                    {
-                        free(pending_socket_io->bytes);
-                        free(pending_socket_io);
-                        (void)singlylinkedlist_remove(socket_io_instance->pending_io_list, first_pending_io);
+/* an empty path goes back to connecting to hostname and port */
+static int set_unix_socket_path(SOCKET_IO_INSTANCE* socket_io_instance, const char* path)
+{
+    int result;
+    char* new_path = NULL;
 
-                        LogError("Failure: sending Socket information. errno=%d (%s).", errno, strerror(errno));
-                        socket_io_instance->io_state = IO_STATE_ERROR;
-                        indicate_error(socket_io_instance);
-                    }
-                }
-                else
-                {
-                    /* simply wait until next dowork */
-                    (void)memmove(pending_socket_io->bytes, pending_socket_io->bytes + send_result, pending_socket_io->size - send_result);
-                    pending_socket_io->size -= send_result;
-                    break;
-                }
-            }
-            else
-            {
-                if (pending_socket_io->on_send_complete != NULL)
-                {
-                    pending_socket_io->on_send_complete(pending_socket_io->callback_context, IO_SEND_OK);
-                }
+    if ((path[0] != '\0') && (mallocAndStrcpy_s(&new_path, path) != 0))
+    {
+        LogError("failed setting option %s", OPTION_UNIX_SOCKET_PATH);
+        result = __FAILURE__;
+    }
+    else
+    {
+        free(socket_io_instance->unix_socket_path);
+        socket_io_instance->unix_socket_path = new_path;
+        result = 0;
+    }
 
-                free(pending_socket_io->bytes);
-                free(pending_socket_io);
-                if (singlylinkedlist_remove(socket_io_instance->pending_io_list, first_pending_io) != 0)
-                {
-                    socket_io_instance->io_state = IO_STATE_ERROR;
-                    indicate_error(socket_io_instance);
-                    LogError("Failure: unable to remove socket from list");
-                }
-            }
+    return result;
+}
 
-            first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
-        }
+/* the timer of the loop is created here, an accepted socket is never connected and has no use for it. The receive buffer of the loop replaces
+   recv_bytes, unless the receive_buffer_size option changed the size of the receives */
+static int set_event_loop(SOCKET_IO_INSTANCE* socket_io_instance, SOCKETIO_EVENT_LOOP_HANDLE event_loop)
+{
+    int result;
+    SOCKETIO_EVENT_LOOP_TIMER_HANDLE connect_timer = NULL;
 
-        if (socket_io_instance->io_state == IO_STATE_OPEN)
+    if (socket_io_instance->io_state != IO_STATE_CLOSED)
+    {
+        LogError("option %s can only be set while the socket IO is closed", OPTION_EVENT_LOOP);
+        result = __FAILURE__;
+    }
+    else if ((socket_io_instance->hostname != NULL) &&
+             ((connect_timer = socketio_event_loop_create_timer(event_loop, on_connect_timer, socket_io_instance)) == NULL))
+    {
+        LogError("Failure: socketio_event_loop_create_timer failed.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        socketio_event_loop_destroy_timer(socket_io_instance->connect_timer);
+        socket_io_instance->connect_timer = connect_timer;
+        socket_io_instance->event_loop = event_loop;
+        if ((socket_io_instance->receive_buffer == socket_io_instance->recv_bytes) &&
+            (socket_io_instance->receive_size == RECEIVE_BYTES_VALUE))
         {
-            ssize_t received = 0;
-            do
-            {
-                received = recv(socket_io_instance->socket, socket_io_instance->recv_bytes, RECEIVE_BYTES_VALUE, 0);
-                if (received > 0)
-                {
-                    if (socket_io_instance->on_bytes_received != NULL)
-                    {
-                        /* Explicitly ignoring here the result of the callback */
-                        (void)socket_io_instance->on_bytes_received(socket_io_instance->on_bytes_received_context, socket_io_instance->recv_bytes, received);
-                    }
-                }
-                else if (received == 0)
-                {
-                    // Do not log error here due to this is probably the socket being closed on the other end
-                    indicate_error(socket_io_instance);
-                }
-                else if (received < 0 && errno != EAGAIN)
-                {
-                    LogError("Socketio_Failure: Receiving data from endpoint: errno=%d.", errno);
-                    indicate_error(socket_io_instance);
-                }
-
-            } while (received > 0 && socket_io_instance->io_state == IO_STATE_OPEN);
+            socket_io_instance->receive_buffer = NULL;
         }
+        result = 0;
     }
-}
 
-// Edison is missing this from netinet/tcp.h, but this code still works if we manually define it.
-#ifndef SOL_TCP
-#define SOL_TCP 6
-#endif
+    return result;
+}
 
-#ifndef __APPLE__
-static void strtoup(char* str)
+/* returns TCP_OPTION_COUNT when the option is not one of tcp_options */
+static size_t get_tcp_option_index(const char* optionName)
 {
-    if (str != NULL)
+    size_t result;
+
+    for (result = 0; result < TCP_OPTION_COUNT; result++)
     {
-        while (*str != '\0')
+        if (strcmp(optionName, tcp_options[result].name) == 0)
         {
-            if (isalpha((int)*str) && islower((int)*str))
-            {
-                *str = (char)toupper((int)*str);
-            }
-            str++;
+            break;
         }
     }
+
+    return result;
 }
-#endif // __APPLE__
 
 int socketio_setoption(CONCRETE_IO_HANDLE socket_io, const char* optionName, const void* value)
 {
@@ -1000,25 +2412,32 @@ int socketio_setoption(CONCRETE_IO_HANDLE socket_io, const char* optionName, con
     else
     {
         SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)socket_io;
+        size_t tcp_option_index = get_tcp_option_index(optionName);
 
-        if (strcmp(optionName, "tcp_keepalive") == 0)
-        {
-            result = setsockopt(socket_io_instance->socket, SOL_SOCKET, SO_KEEPALIVE, value, sizeof(int));
-            if (result == -1) result = errno;
-        }
-        else if (strcmp(optionName, "tcp_keepalive_time") == 0)
+        if ((socket_io_instance->unix_socket_path != NULL) && (tcp_option_index < TCP_OPTION_COUNT))
         {
-#ifdef __APPLE__
-            result = setsockopt(socket_io_instance->socket, IPPROTO_TCP, TCP_KEEPALIVE, value, sizeof(int));
-#else
-            result = setsockopt(socket_io_instance->socket, SOL_TCP, TCP_KEEPIDLE, value, sizeof(int));
-#endif
-            if (result == -1) result = errno;
+            /* the layers above set the TCP options without knowing the transport, a Unix domain socket has nothing to set */
+            result = 0;
         }
-        else if (strcmp(optionName, "tcp_keepalive_interval") == 0)
+        else if (tcp_option_index < TCP_OPTION_COUNT)
         {
-            result = setsockopt(socket_io_instance->socket, SOL_TCP, TCP_KEEPINTVL, value, sizeof(int));
-            if (result == -1) result = errno;
+            /* while connecting there is no socket yet, the option is set on the sockets of the connect attempts in progress and kept for the next ones */
+            socket_io_instance->tcp_option_values[tcp_option_index] = *(const int*)value;
+            socket_io_instance->tcp_option_is_set[tcp_option_index] = true;
+
+            if (socket_io_instance->socket != INVALID_SOCKET)
+            {
+                result = set_tcp_option(socket_io_instance, socket_io_instance->socket, tcp_option_index);
+            }
+            else
+            {
+                size_t i;
+                result = 0;
+                for (i = 0; (socket_io_instance->connect_race != NULL) && (result == 0) && (i < socket_io_instance->connect_race->attempt_count); i++)
+                {
+                    result = set_tcp_option(socket_io_instance, socket_io_instance->connect_race->attempts[i].socket, tcp_option_index);
+                }
+            }
         }
         else if (strcmp(optionName, OPTION_NET_INT_MAC_ADDRESS) == 0)
         {
@@ -1031,29 +2450,75 @@ int socketio_setoption(CONCRETE_IO_HANDLE socket_io, const char* optionName, con
                 LogError("option value must be a valid mac address");
                 result = __FAILURE__;
             }
-            else if ((socket_io_instance->target_mac_address = (char*)malloc(sizeof(char) * (strlen(value) + 1))) == NULL)
+            else
+            {
+                CONSTSTRING_HANDLE mac_address = CONSTSTRING_Create((const char*)value);
+                if (mac_address == NULL)
+                {
+                    LogError("failed setting net_interface_mac_address option (CONSTSTRING_Create failed)");
+                    result = __FAILURE__;
+                }
+                else
+                {
+                    set_target_mac_address(socket_io_instance, mac_address);
+                    CONSTSTRING_Destroy(mac_address);
+                    result = 0;
+                }
+            }
+#endif
+        }
+        else if (strcmp(optionName, OPTION_RECEIVE_BUFFER_SIZE) == 0)
+        {
+            size_t receive_size = *(const size_t*)value;
+            if (receive_size == 0)
             {
-                LogError("failed setting net_interface_mac_address option (malloc failed)");
+                LogError("option %s must be greater than 0", optionName);
                 result = __FAILURE__;
             }
-            else if (strcpy(socket_io_instance->target_mac_address, value) == NULL)
+            else if (set_receive_buffer_size(socket_io_instance, receive_size) != 0)
             {
-                LogError("failed setting net_interface_mac_address option (strcpy failed)");
-                free(socket_io_instance->target_mac_address);
-                socket_io_instance->target_mac_address = NULL;
+                LogError("failed setting option %s", optionName);
                 result = __FAILURE__;
             }
             else
             {
-                strtoup(socket_io_instance->target_mac_address);
+                socket_io_instance->receive_size = receive_size;
                 result = 0;
             }
-#endif
         }
-        else if (strcmp(optionName, "tcp_nodelay") == 0)
+        else if (strcmp(optionName, OPTION_UNIX_SOCKET_PATH) == 0)
+        {
+            /* it applies to the next socketio_open */
+            result = set_unix_socket_path(socket_io_instance, (const char*)value);
+        }
+        else if (strcmp(optionName, OPTION_CONNECT_TIMEOUT) == 0)
+        {
+            /* it also applies to a connect in progress */
+            socket_io_instance->connect_timeout_ms = *(const unsigned int*)value;
+            update_connect_timer(socket_io_instance);
+            result = 0;
+        }
+        else if (strcmp(optionName, OPTION_EVENT_LOOP) == 0)
+        {
+            result = set_event_loop(socket_io_instance, (SOCKETIO_EVENT_LOOP_HANDLE)value);
+        }
+        else if (strcmp(optionName, OPTION_RECEIVE_BATCHED) == 0)
         {
-            result = setsockopt(socket_io_instance->socket, IPPROTO_TCP, TCP_NODELAY, value, sizeof(int));
-            if (result == -1) result = errno;
+            bool receive_batched = *(const bool*)value;
+            /* unbatched receives go back to reads of the size that was set, a batched receive may have grown the buffer */
+            if (!receive_batched &&
+                (socket_io_instance->receive_buffer != NULL) &&
+                (socket_io_instance->receive_buffer_size != socket_io_instance->receive_size) &&
+                (set_receive_buffer_size(socket_io_instance, socket_io_instance->receive_size) != 0))
+            {
+                LogError("failed setting option %s", optionName);
+                result = __FAILURE__;
+            }
+            else
+            {
+                socket_io_instance->receive_batched = receive_batched;
+                result = 0;
+            }
         }
         else
         {
@@ -1064,6 +2529,28 @@ int socketio_setoption(CONCRETE_IO_HANDLE socket_io, const char* optionName, con
     return result;
 }
 
+/*feeds the options produced by socketio_retrieveoptions, whose MAC address is a conststring and not a plain string*/
+static int socketio_set_retrieved_option(void* handle, const char* name, const void* value)
+{
+    int result;
+
+    if (handle == NULL || name == NULL || value == NULL)
+    {
+        result = __FAILURE__;
+    }
+    else if (strcmp(name, OPTION_NET_INT_MAC_ADDRESS) == 0)
+    {
+        set_target_mac_address((SOCKET_IO_INSTANCE*)handle, (CONSTSTRING_HANDLE)value);
+        result = 0;
+    }
+    else
+    {
+        result = socketio_setoption(handle, name, value);
+    }
+
+    return result;
+}
+
 const IO_INTERFACE_DESCRIPTION* socketio_get_interface_description(void)
 {
     return &socket_io_interface_description;
@@ -0,0 +1,708 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/socketio_event_loop.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#ifdef __linux__
+
+/* the most ready sockets handled by one run, the others are reported by the next run */
+#define SOCKETIO_EVENT_LOOP_MAX_EVENTS 256
+
+/* the size of the receive buffer shared by the socket IOs of a loop */
+#ifndef SOCKETIO_EVENT_LOOP_RECEIVE_BUFFER_SIZE
+#define SOCKETIO_EVENT_LOOP_RECEIVE_BUFFER_SIZE (64 * 1024)
+#endif
+
+typedef struct SOCKETIO_EVENT_LOOP_REGISTRATION_TAG
+{
+    struct SOCKETIO_EVENT_LOOP_TAG* event_loop;
+    int socket;
+    /* NULL once unregistered by a callback of the running loop, the registration is freed when the run ends */
+    ON_SOCKETIO_EVENT on_event;
+    void* on_event_context;
+    struct SOCKETIO_EVENT_LOOP_REGISTRATION_TAG* next_removed;
+} SOCKETIO_EVENT_LOOP_REGISTRATION;
+
+typedef struct SOCKETIO_EVENT_LOOP_TIMER_TAG
+{
+    struct SOCKETIO_EVENT_LOOP_TAG* event_loop;
+    /* NULL once destroyed by a callback of the running loop, the timer is freed when the run ends */
+    ON_SOCKETIO_EVENT_LOOP_TIMER on_timer;
+    void* on_timer_context;
+    uint64_t due_ms;
+    /* the list the timer is in, the started timers of the loop or the due timers of the run, NULL while it is stopped */
+    struct SOCKETIO_EVENT_LOOP_TIMER_TAG** list;
+    struct SOCKETIO_EVENT_LOOP_TIMER_TAG* previous;
+    struct SOCKETIO_EVENT_LOOP_TIMER_TAG* next;
+} SOCKETIO_EVENT_LOOP_TIMER;
+
+typedef struct SOCKETIO_EVENT_LOOP_TAG
+{
+    int epoll_fd;
+    size_t registration_count;
+    bool is_running;
+    SOCKETIO_EVENT_LOOP_REGISTRATION* removed;
+    /* only the started timers are in a list, the wait looks for the earliest of them */
+    size_t timer_count;
+    SOCKETIO_EVENT_LOOP_TIMER* timers;
+    SOCKETIO_EVENT_LOOP_TIMER* due_timers;
+    SOCKETIO_EVENT_LOOP_TIMER* removed_timers;
+    void* context;
+    ON_SOCKETIO_EVENT_LOOP_DESTROY on_destroy;
+    struct epoll_event events[SOCKETIO_EVENT_LOOP_MAX_EVENTS];
+    unsigned char receive_buffer[SOCKETIO_EVENT_LOOP_RECEIVE_BUFFER_SIZE];
+} SOCKETIO_EVENT_LOOP;
+
+static uint32_t to_epoll_events(unsigned int events)
+{
+    uint32_t result = 0;
+    if ((events & SOCKETIO_EVENT_READABLE) != 0)
+    {
+        result |= EPOLLIN;
+    }
+    if ((events & SOCKETIO_EVENT_WRITABLE) != 0)
+    {
+        result |= EPOLLOUT;
+    }
+    return result;
+}
+
+static unsigned int from_epoll_events(uint32_t epoll_events)
+{
+    unsigned int result = 0;
+    if ((epoll_events & EPOLLIN) != 0)
+    {
+        result |= SOCKETIO_EVENT_READABLE;
+    }
+    if ((epoll_events & EPOLLOUT) != 0)
+    {
+        result |= SOCKETIO_EVENT_WRITABLE;
+    }
+    if ((epoll_events & (EPOLLERR | EPOLLHUP)) != 0)
+    {
+        result |= SOCKETIO_EVENT_ERROR;
+    }
+    return result;
+}
+
+static void free_removed_registrations(SOCKETIO_EVENT_LOOP* event_loop)
+{
+    while (event_loop->removed != NULL)
+    {
+        SOCKETIO_EVENT_LOOP_REGISTRATION* registration = event_loop->removed;
+        event_loop->removed = registration->next_removed;
+        free(registration);
+    }
+
+    while (event_loop->removed_timers != NULL)
+    {
+        SOCKETIO_EVENT_LOOP_TIMER* timer = event_loop->removed_timers;
+        event_loop->removed_timers = timer->next;
+        free(timer);
+    }
+}
+
+/* the timers are measured on the monotonic clock, a change of the wall clock does not fire them */
+static int get_time_ms(uint64_t* time_ms)
+{
+    int result;
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+    {
+        LogError("Failure: clock_gettime failed. errno=%d (%s).", errno, strerror(errno));
+        result = __FAILURE__;
+    }
+    else
+    {
+        *time_ms = (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+        result = 0;
+    }
+
+    return result;
+}
+
+static void link_timer(SOCKETIO_EVENT_LOOP_TIMER** list, SOCKETIO_EVENT_LOOP_TIMER* timer)
+{
+    timer->list = list;
+    timer->previous = NULL;
+    timer->next = *list;
+    if (*list != NULL)
+    {
+        (*list)->previous = timer;
+    }
+    *list = timer;
+}
+
+static void unlink_timer(SOCKETIO_EVENT_LOOP_TIMER* timer)
+{
+    if (timer->list != NULL)
+    {
+        if (timer->previous != NULL)
+        {
+            timer->previous->next = timer->next;
+        }
+        else
+        {
+            *timer->list = timer->next;
+        }
+
+        if (timer->next != NULL)
+        {
+            timer->next->previous = timer->previous;
+        }
+
+        timer->list = NULL;
+        timer->previous = NULL;
+        timer->next = NULL;
+    }
+}
+
+/* timeout_ms, shortened to the time left until the earliest started timer is due */
+static int get_wait_timeout(SOCKETIO_EVENT_LOOP* event_loop, int timeout_ms)
+{
+    int result = timeout_ms;
+    uint64_t now_ms;
+
+    if ((event_loop->timers != NULL) && (get_time_ms(&now_ms) == 0))
+    {
+        SOCKETIO_EVENT_LOOP_TIMER* timer;
+        uint64_t due_ms = event_loop->timers->due_ms;
+        uint64_t wait_ms;
+
+        for (timer = event_loop->timers->next; timer != NULL; timer = timer->next)
+        {
+            if (timer->due_ms < due_ms)
+            {
+                due_ms = timer->due_ms;
+            }
+        }
+
+        wait_ms = (due_ms > now_ms) ? (due_ms - now_ms) : 0;
+        if ((result < 0) || (wait_ms < (uint64_t)result))
+        {
+            result = (wait_ms > INT32_MAX) ? INT32_MAX : (int)wait_ms;
+        }
+    }
+
+    return result;
+}
+
+/* the due timers are moved out of the started ones before any of them is called, a timer its callback starts again is called on a later run */
+static void run_due_timers(SOCKETIO_EVENT_LOOP* event_loop)
+{
+    uint64_t now_ms;
+
+    if ((event_loop->timers != NULL) && (get_time_ms(&now_ms) == 0))
+    {
+        SOCKETIO_EVENT_LOOP_TIMER* timer = event_loop->timers;
+        while (timer != NULL)
+        {
+            SOCKETIO_EVENT_LOOP_TIMER* next_timer = timer->next;
+            if (timer->due_ms <= now_ms)
+            {
+                unlink_timer(timer);
+                link_timer(&event_loop->due_timers, timer);
+            }
+            timer = next_timer;
+        }
+
+        /* a callback may stop or destroy the other due timers, which takes them out of the list */
+        while ((timer = event_loop->due_timers) != NULL)
+        {
+            unlink_timer(timer);
+            timer->on_timer(timer->on_timer_context);
+        }
+    }
+}
+
+SOCKETIO_EVENT_LOOP_HANDLE socketio_event_loop_create(void)
+{
+    /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_001: [ socketio_event_loop_create shall create an epoll instance and return a non-NULL handle. ]*/
+    SOCKETIO_EVENT_LOOP* result = (SOCKETIO_EVENT_LOOP*)malloc(sizeof(SOCKETIO_EVENT_LOOP));
+    if (result == NULL)
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_002: [ If any error occurs, socketio_event_loop_create shall fail and return NULL. ]*/
+        LogError("Allocation Failure: SOCKETIO_EVENT_LOOP");
+    }
+    else if ((result->epoll_fd = epoll_create1(EPOLL_CLOEXEC)) == -1)
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_002: [ If any error occurs, socketio_event_loop_create shall fail and return NULL. ]*/
+        LogError("Failure: epoll_create1 failed. errno=%d (%s).", errno, strerror(errno));
+        free(result);
+        result = NULL;
+    }
+    else
+    {
+        result->registration_count = 0;
+        result->is_running = false;
+        result->removed = NULL;
+        result->timer_count = 0;
+        result->timers = NULL;
+        result->due_timers = NULL;
+        result->removed_timers = NULL;
+        result->context = NULL;
+        result->on_destroy = NULL;
+    }
+
+    return result;
+}
+
+void socketio_event_loop_destroy(SOCKETIO_EVENT_LOOP_HANDLE event_loop)
+{
+    /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_003: [ If event_loop is NULL, socketio_event_loop_destroy shall return. ]*/
+    if (event_loop != NULL)
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_028: [ If a context was set, socketio_event_loop_destroy shall first call its on_destroy with it, while the registrations it made can still be removed. ]*/
+        if (event_loop->on_destroy != NULL)
+        {
+            event_loop->on_destroy(event_loop->context);
+        }
+
+        if (event_loop->registration_count != 0)
+        {
+            LogError("Destroying an event loop that still has %lu registered sockets.", (unsigned long)event_loop->registration_count);
+        }
+
+        if (event_loop->timer_count != 0)
+        {
+            LogError("Destroying an event loop that still has %lu timers.", (unsigned long)event_loop->timer_count);
+        }
+
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_004: [ socketio_event_loop_destroy shall close the epoll instance and free the event loop. ]*/
+        free_removed_registrations(event_loop);
+        (void)close(event_loop->epoll_fd);
+        free(event_loop);
+    }
+}
+
+SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE socketio_event_loop_register(SOCKETIO_EVENT_LOOP_HANDLE event_loop, int socket, unsigned int events, ON_SOCKETIO_EVENT on_event, void* on_event_context)
+{
+    SOCKETIO_EVENT_LOOP_REGISTRATION* result;
+
+    if ((event_loop == NULL) ||
+        (socket < 0) ||
+        (on_event == NULL))
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_005: [ If event_loop or on_event is NULL or socket is negative, socketio_event_loop_register shall fail and return NULL. ]*/
+        LogError("Invalid argument: SOCKETIO_EVENT_LOOP_HANDLE event_loop=%p, int socket=%d, ON_SOCKETIO_EVENT on_event=%p", event_loop, socket, on_event);
+        result = NULL;
+    }
+    else if ((result = (SOCKETIO_EVENT_LOOP_REGISTRATION*)malloc(sizeof(SOCKETIO_EVENT_LOOP_REGISTRATION))) == NULL)
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_007: [ If any error occurs, socketio_event_loop_register shall fail and return NULL. ]*/
+        LogError("Allocation Failure: SOCKETIO_EVENT_LOOP_REGISTRATION");
+    }
+    else
+    {
+        struct epoll_event epoll_event;
+        (void)memset(&epoll_event, 0, sizeof(epoll_event));
+        epoll_event.events = to_epoll_events(events);
+        epoll_event.data.ptr = result;
+
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_006: [ socketio_event_loop_register shall add socket to the epoll instance, watched for events, and return a registration through which on_event is called with on_event_context and the events the socket is ready for. ]*/
+        if (epoll_ctl(event_loop->epoll_fd, EPOLL_CTL_ADD, socket, &epoll_event) != 0)
+        {
+            /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_007: [ If any error occurs, socketio_event_loop_register shall fail and return NULL. ]*/
+            LogError("Failure: epoll_ctl failed adding socket %d. errno=%d (%s).", socket, errno, strerror(errno));
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            result->event_loop = event_loop;
+            result->socket = socket;
+            result->on_event = on_event;
+            result->on_event_context = on_event_context;
+            result->next_removed = NULL;
+            event_loop->registration_count++;
+        }
+    }
+
+    return result;
+}
+
+int socketio_event_loop_modify(SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE registration, unsigned int events)
+{
+    int result;
+
+    if (registration == NULL)
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_008: [ If registration is NULL, socketio_event_loop_modify shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE registration=NULL");
+        result = __FAILURE__;
+    }
+    else
+    {
+        struct epoll_event epoll_event;
+        (void)memset(&epoll_event, 0, sizeof(epoll_event));
+        epoll_event.events = to_epoll_events(events);
+        epoll_event.data.ptr = registration;
+
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_009: [ socketio_event_loop_modify shall change the events the socket of registration is watched for to events and return 0. ]*/
+        if (epoll_ctl(registration->event_loop->epoll_fd, EPOLL_CTL_MOD, registration->socket, &epoll_event) != 0)
+        {
+            /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_010: [ If any error occurs, socketio_event_loop_modify shall fail and return a non-zero value. ]*/
+            LogError("Failure: epoll_ctl failed modifying socket %d. errno=%d (%s).", registration->socket, errno, strerror(errno));
+            result = __FAILURE__;
+        }
+        else
+        {
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+void socketio_event_loop_unregister(SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE registration)
+{
+    /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_011: [ If registration is NULL, socketio_event_loop_unregister shall return. ]*/
+    if (registration != NULL)
+    {
+        SOCKETIO_EVENT_LOOP* event_loop = registration->event_loop;
+
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_012: [ socketio_event_loop_unregister shall remove the socket of registration from the epoll instance, it has to be called before the socket is closed. ]*/
+        if (epoll_ctl(event_loop->epoll_fd, EPOLL_CTL_DEL, registration->socket, NULL) != 0)
+        {
+            LogError("Failure: epoll_ctl failed removing socket %d. errno=%d (%s).", registration->socket, errno, strerror(errno));
+        }
+        event_loop->registration_count--;
+
+        if (event_loop->is_running)
+        {
+            /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_013: [ When called from a callback of the running loop, socketio_event_loop_unregister shall stop the callbacks of registration and free it when the run ends, since events for it may still be waiting to be dispatched. ]*/
+            registration->on_event = NULL;
+            registration->next_removed = event_loop->removed;
+            event_loop->removed = registration;
+        }
+        else
+        {
+            /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_014: [ Otherwise socketio_event_loop_unregister shall free registration. ]*/
+            free(registration);
+        }
+    }
+}
+
+unsigned char* socketio_event_loop_get_receive_buffer(SOCKETIO_EVENT_LOOP_HANDLE event_loop, size_t* size)
+{
+    unsigned char* result;
+
+    if ((event_loop == NULL) ||
+        (size == NULL))
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_021: [ If event_loop or size is NULL, socketio_event_loop_get_receive_buffer shall fail and return NULL. ]*/
+        LogError("Invalid arguments: event_loop=%p, size=%p", event_loop, size);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_022: [ socketio_event_loop_get_receive_buffer shall return the receive buffer of the loop and set size to its size. ]*/
+        result = event_loop->receive_buffer;
+        *size = sizeof(event_loop->receive_buffer);
+    }
+
+    return result;
+}
+
+int socketio_event_loop_set_context(SOCKETIO_EVENT_LOOP_HANDLE event_loop, void* context, ON_SOCKETIO_EVENT_LOOP_DESTROY on_destroy)
+{
+    int result;
+
+    if ((event_loop == NULL) ||
+        (context == NULL))
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_023: [ If event_loop or context is NULL, socketio_event_loop_set_context shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: event_loop=%p, context=%p", event_loop, context);
+        result = __FAILURE__;
+    }
+    else if (event_loop->context != NULL)
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_024: [ If the loop already has a context, socketio_event_loop_set_context shall fail and return a non-zero value. ]*/
+        LogError("Failure: the event loop already has a context.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_025: [ socketio_event_loop_set_context shall keep context and on_destroy in the loop and return 0. ]*/
+        event_loop->context = context;
+        event_loop->on_destroy = on_destroy;
+        result = 0;
+    }
+
+    return result;
+}
+
+void* socketio_event_loop_get_context(SOCKETIO_EVENT_LOOP_HANDLE event_loop)
+{
+    void* result;
+
+    if (event_loop == NULL)
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_026: [ If event_loop is NULL, socketio_event_loop_get_context shall return NULL. ]*/
+        LogError("Invalid argument: SOCKETIO_EVENT_LOOP_HANDLE event_loop=NULL");
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_027: [ socketio_event_loop_get_context shall return the context of the loop, or NULL if none was set. ]*/
+        result = event_loop->context;
+    }
+
+    return result;
+}
+
+SOCKETIO_EVENT_LOOP_TIMER_HANDLE socketio_event_loop_create_timer(SOCKETIO_EVENT_LOOP_HANDLE event_loop, ON_SOCKETIO_EVENT_LOOP_TIMER on_timer, void* on_timer_context)
+{
+    SOCKETIO_EVENT_LOOP_TIMER* result;
+
+    if ((event_loop == NULL) ||
+        (on_timer == NULL))
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_029: [ If event_loop or on_timer is NULL, socketio_event_loop_create_timer shall fail and return NULL. ]*/
+        LogError("Invalid arguments: event_loop=%p, on_timer=%p", event_loop, on_timer);
+        result = NULL;
+    }
+    else if ((result = (SOCKETIO_EVENT_LOOP_TIMER*)malloc(sizeof(SOCKETIO_EVENT_LOOP_TIMER))) == NULL)
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_031: [ If any error occurs, socketio_event_loop_create_timer shall fail and return NULL. ]*/
+        LogError("Allocation Failure: SOCKETIO_EVENT_LOOP_TIMER");
+    }
+    else
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_030: [ socketio_event_loop_create_timer shall return a stopped timer through which on_timer is called with on_timer_context. ]*/
+        result->event_loop = event_loop;
+        result->on_timer = on_timer;
+        result->on_timer_context = on_timer_context;
+        result->due_ms = 0;
+        result->list = NULL;
+        result->previous = NULL;
+        result->next = NULL;
+        event_loop->timer_count++;
+    }
+
+    return result;
+}
+
+void socketio_event_loop_destroy_timer(SOCKETIO_EVENT_LOOP_TIMER_HANDLE timer)
+{
+    /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_032: [ If timer is NULL, socketio_event_loop_destroy_timer shall return. ]*/
+    if (timer != NULL)
+    {
+        SOCKETIO_EVENT_LOOP* event_loop = timer->event_loop;
+
+        unlink_timer(timer);
+        event_loop->timer_count--;
+
+        if (event_loop->is_running)
+        {
+            /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_034: [ When called from a callback of the running loop, socketio_event_loop_destroy_timer shall stop timer and free it when the run ends. ]*/
+            timer->on_timer = NULL;
+            timer->next = event_loop->removed_timers;
+            event_loop->removed_timers = timer;
+        }
+        else
+        {
+            /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_033: [ Otherwise socketio_event_loop_destroy_timer shall stop timer and free it. ]*/
+            free(timer);
+        }
+    }
+}
+
+int socketio_event_loop_start_timer(SOCKETIO_EVENT_LOOP_TIMER_HANDLE timer, unsigned int delay_ms)
+{
+    int result;
+    uint64_t now_ms;
+
+    if (timer == NULL)
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_035: [ If timer is NULL, socketio_event_loop_start_timer shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: SOCKETIO_EVENT_LOOP_TIMER_HANDLE timer=NULL");
+        result = __FAILURE__;
+    }
+    else if (get_time_ms(&now_ms) != 0)
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_037: [ If any error occurs, socketio_event_loop_start_timer shall fail and return a non-zero value. ]*/
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_036: [ socketio_event_loop_start_timer shall make timer due delay_ms milliseconds from now, in place of the time it was due if it was started, and return 0. ]*/
+        unlink_timer(timer);
+        timer->due_ms = now_ms + delay_ms;
+        link_timer(&timer->event_loop->timers, timer);
+        result = 0;
+    }
+
+    return result;
+}
+
+void socketio_event_loop_stop_timer(SOCKETIO_EVENT_LOOP_TIMER_HANDLE timer)
+{
+    /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_038: [ If timer is NULL, socketio_event_loop_stop_timer shall return. ]*/
+    if (timer != NULL)
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_039: [ socketio_event_loop_stop_timer shall stop timer, its on_timer is not called until it is started again. ]*/
+        unlink_timer(timer);
+    }
+}
+
+int socketio_event_loop_run_once(SOCKETIO_EVENT_LOOP_HANDLE event_loop, int timeout_ms)
+{
+    int result;
+
+    if (event_loop == NULL)
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_015: [ If event_loop is NULL, socketio_event_loop_run_once shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: SOCKETIO_EVENT_LOOP_HANDLE event_loop=NULL");
+        result = __FAILURE__;
+    }
+    else if (event_loop->is_running)
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_016: [ If called from a callback of the loop, socketio_event_loop_run_once shall fail and return a non-zero value. ]*/
+        LogError("Failure: socketio_event_loop_run_once cannot be called from a callback of the loop.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_017: [ socketio_event_loop_run_once shall wait up to timeout_ms milliseconds, or indefinitely if timeout_ms is negative, until at least one registered socket is ready. ]*/
+        /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_040: [ socketio_event_loop_run_once shall not wait past the time the earliest started timer is due. ]*/
+        int event_count = epoll_wait(event_loop->epoll_fd, event_loop->events, SOCKETIO_EVENT_LOOP_MAX_EVENTS, get_wait_timeout(event_loop, timeout_ms));
+        if ((event_count < 0) && (errno != EINTR))
+        {
+            /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_020: [ If waiting fails, socketio_event_loop_run_once shall fail and return a non-zero value. ]*/
+            LogError("Failure: epoll_wait failed. errno=%d (%s).", errno, strerror(errno));
+            result = __FAILURE__;
+        }
+        else
+        {
+            /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_019: [ A wait interrupted by a signal, or that timed out, shall not be an error. ]*/
+            int i;
+
+            /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_018: [ socketio_event_loop_run_once shall call the on_event callback of each ready registration once with the events it is ready for, and return 0. ]*/
+            event_loop->is_running = true;
+            for (i = 0; i < event_count; i++)
+            {
+                SOCKETIO_EVENT_LOOP_REGISTRATION* registration = (SOCKETIO_EVENT_LOOP_REGISTRATION*)event_loop->events[i].data.ptr;
+                if (registration->on_event != NULL)
+                {
+                    registration->on_event(registration->on_event_context, from_epoll_events(event_loop->events[i].events));
+                }
+            }
+
+            /* Codes_SRS_SOCKETIO_EVENT_LOOP_03_041: [ socketio_event_loop_run_once shall then stop the started timers that are due and call the on_timer callback of each once, a timer started again by a callback of the run is not called before the next run. ]*/
+            run_due_timers(event_loop);
+            event_loop->is_running = false;
+            free_removed_registrations(event_loop);
+
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+#else
+
+/* the event loop is built on epoll, elsewhere the socket IOs are driven by their dowork */
+
+SOCKETIO_EVENT_LOOP_HANDLE socketio_event_loop_create(void)
+{
+    LogError("socketio_event_loop needs epoll, which this platform does not have.");
+    return NULL;
+}
+
+void socketio_event_loop_destroy(SOCKETIO_EVENT_LOOP_HANDLE event_loop)
+{
+    (void)event_loop;
+}
+
+SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE socketio_event_loop_register(SOCKETIO_EVENT_LOOP_HANDLE event_loop, int socket, unsigned int events, ON_SOCKETIO_EVENT on_event, void* on_event_context)
+{
+    (void)event_loop;
+    (void)socket;
+    (void)events;
+    (void)on_event;
+    (void)on_event_context;
+    return NULL;
+}
+
+int socketio_event_loop_modify(SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE registration, unsigned int events)
+{
+    (void)registration;
+    (void)events;
+    return __FAILURE__;
+}
+
+void socketio_event_loop_unregister(SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE registration)
+{
+    (void)registration;
+}
+
+unsigned char* socketio_event_loop_get_receive_buffer(SOCKETIO_EVENT_LOOP_HANDLE event_loop, size_t* size)
+{
+    (void)event_loop;
+    (void)size;
+    return NULL;
+}
+
+int socketio_event_loop_set_context(SOCKETIO_EVENT_LOOP_HANDLE event_loop, void* context, ON_SOCKETIO_EVENT_LOOP_DESTROY on_destroy)
+{
+    (void)event_loop;
+    (void)context;
+    (void)on_destroy;
+    return __FAILURE__;
+}
+
+void* socketio_event_loop_get_context(SOCKETIO_EVENT_LOOP_HANDLE event_loop)
+{
+    (void)event_loop;
+    return NULL;
+}
+
+SOCKETIO_EVENT_LOOP_TIMER_HANDLE socketio_event_loop_create_timer(SOCKETIO_EVENT_LOOP_HANDLE event_loop, ON_SOCKETIO_EVENT_LOOP_TIMER on_timer, void* on_timer_context)
+{
+    (void)event_loop;
+    (void)on_timer;
+    (void)on_timer_context;
+    return NULL;
+}
+
+void socketio_event_loop_destroy_timer(SOCKETIO_EVENT_LOOP_TIMER_HANDLE timer)
+{
+    (void)timer;
+}
+
+int socketio_event_loop_start_timer(SOCKETIO_EVENT_LOOP_TIMER_HANDLE timer, unsigned int delay_ms)
+{
+    (void)timer;
+    (void)delay_ms;
+    return __FAILURE__;
+}
+
+void socketio_event_loop_stop_timer(SOCKETIO_EVENT_LOOP_TIMER_HANDLE timer)
+{
+    (void)timer;
+}
+
+int socketio_event_loop_run_once(SOCKETIO_EVENT_LOOP_HANDLE event_loop, int timeout_ms)
+{
+    (void)event_loop;
+    (void)timeout_ms;
+    return __FAILURE__;
+}
+
+#endif
@@ -0,0 +1,2184 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/* the socket IO on io_uring, built instead of socketio_berkeley.c with the use_io_uring CMake option, it needs Linux 6.0 or later.
+   The socket is received from with a multishot receive into the buffers of a provided buffer ring, and sent to and connected with operations
+   submitted to the ring: an open socket IO costs no syscall until the kernel has bytes for it, and the sends queued while the completions of
+   the ring are dispatched are submitted together when the dispatch ends. */
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <linux/io_uring.h>
+#include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/socketio_event_loop.h"
+#include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/slab.h"
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/constbuffer.h"
+#include "azure_c_shared_utility/crt_abstractions.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/optionhandler.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+#include "azure_c_shared_utility/xlogging.h"
+#include "azure_c_shared_utility/dns_resolver.h"
+#include "linux_time.h"
+
+#define INVALID_SOCKET                 -1
+
+/* the time a connect is waited for when the connect_timeout option is not set */
+#ifndef SOCKETIO_DEFAULT_CONNECT_TIMEOUT_MS
+#define SOCKETIO_DEFAULT_CONNECT_TIMEOUT_MS 10000
+#endif
+
+/* the code of the open result of a connect that timed out */
+#define CONNECT_TIMEOUT_ERROR_CODE 9999
+
+/* how often the timer of a socket IO on an event loop checks a lookup of the DNS resolver, which does not wake the loop when it resolves */
+#ifndef SOCKETIO_DNS_LOOKUP_POLL_INTERVAL_MS
+#define SOCKETIO_DNS_LOOKUP_POLL_INTERVAL_MS 10
+#endif
+
+/* the most pending IOs given to one sendmsg, their iovecs stay in the connection while the sendmsg is in flight */
+#ifndef SOCKETIO_URING_MAX_IOVECS
+#define SOCKETIO_URING_MAX_IOVECS 16
+#endif
+
+/* the ring of an event loop is shared by the socket IOs of the loop, and so are its receive buffers, which are only held by a socket IO
+   from the completion of a receive until its on_bytes_received returns. The buffer counts are powers of 2 */
+#ifndef SOCKETIO_URING_LOOP_ENTRIES
+#define SOCKETIO_URING_LOOP_ENTRIES 256
+#endif
+
+#ifndef SOCKETIO_URING_LOOP_COMPLETIONS
+#define SOCKETIO_URING_LOOP_COMPLETIONS 4096
+#endif
+
+#ifndef SOCKETIO_URING_LOOP_BUFFER_COUNT
+#define SOCKETIO_URING_LOOP_BUFFER_COUNT 64
+#endif
+
+#ifndef SOCKETIO_URING_LOOP_BUFFER_SIZE
+#define SOCKETIO_URING_LOOP_BUFFER_SIZE (16 * 1024)
+#endif
+
+/* a socket IO without an event loop has a small ring of its own, dispatched by socketio_dowork */
+#ifndef SOCKETIO_URING_ENTRIES
+#define SOCKETIO_URING_ENTRIES 8
+#endif
+
+#ifndef SOCKETIO_URING_COMPLETIONS
+#define SOCKETIO_URING_COMPLETIONS 32
+#endif
+
+#ifndef SOCKETIO_URING_BUFFER_COUNT
+#define SOCKETIO_URING_BUFFER_COUNT 4
+#endif
+
+#ifndef SOCKETIO_URING_BUFFER_SIZE
+#define SOCKETIO_URING_BUFFER_SIZE 1024
+#endif
+
+#define SOCKETIO_URING_BUFFER_GROUP 0
+
+typedef enum IO_STATE_TAG
+{
+    IO_STATE_CLOSED,
+    IO_STATE_OPENING,
+    IO_STATE_OPEN,
+    IO_STATE_CLOSING,
+    IO_STATE_ERROR
+} IO_STATE;
+
+typedef struct PENDING_SOCKET_IO_TAG
+{
+    /* the bytes left to send, either in a copy owned by the pending IO or in constbuffer, a partial send advances them */
+    const unsigned char* bytes;
+    size_t size;
+    unsigned char* copied_bytes;
+    CONSTBUFFER_HANDLE constbuffer;
+    ON_SEND_COMPLETE on_send_complete;
+    void* callback_context;
+} PENDING_SOCKET_IO;
+
+#define PENDING_SOCKET_IOS_PER_CHUNK 8
+
+typedef struct CONNECT_ADDRESS_TAG
+{
+    struct sockaddr_storage address;
+    socklen_t address_length;
+} CONNECT_ADDRESS;
+
+typedef enum URING_OPERATION_KIND_TAG
+{
+    URING_OPERATION_CONNECT,
+    URING_OPERATION_CONNECT_TIMEOUT,
+    URING_OPERATION_RECEIVE,
+    URING_OPERATION_SEND,
+    URING_OPERATION_CANCEL
+} URING_OPERATION_KIND;
+
+/* the user_data of a submission is the operation it is for, a connection has one of each kind in flight at most */
+typedef struct URING_OPERATION_TAG
+{
+    struct URING_CONNECTION_TAG* connection;
+    URING_OPERATION_KIND kind;
+} URING_OPERATION;
+
+typedef struct SOCKETIO_URING_TAG
+{
+    int ring_fd;
+    void* sq_ring;
+    size_t sq_ring_size;
+    void* cq_ring;
+    size_t cq_ring_size;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+    unsigned int* sq_head;
+    unsigned int* sq_tail;
+    unsigned int* sq_flags;
+    unsigned int* sq_array;
+    unsigned int sq_mask;
+    unsigned int sq_entries;
+    unsigned int* cq_head;
+    unsigned int* cq_tail;
+    unsigned int cq_mask;
+    struct io_uring_cqe* cqes;
+    /* the kernel takes a buffer of buffer_ring for each receive, the buffer is given back once on_bytes_received returned */
+    struct io_uring_buf_ring* buffer_ring;
+    size_t buffer_ring_size;
+    unsigned char* buffers;
+    unsigned int buffer_count;
+    unsigned int buffer_size;
+    unsigned short buffer_tail;
+    /* the submissions queued while the completions are dispatched are submitted when the dispatch ends */
+    unsigned int unsubmitted;
+    size_t in_flight;
+    bool is_dispatching;
+    /* set when the ring is destroyed by a callback of its own dispatch, the dispatch destroys it when it ends */
+    bool is_orphaned;
+    /* the connections whose receive stopped for lack of buffers, they receive again once the dispatch gave the buffers back */
+    struct URING_CONNECTION_TAG* starved;
+    SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE event_loop_registration;
+} SOCKETIO_URING;
+
+/* the socket of an open, which outlives the close of the socket IO until the kernel completed every operation submitted for it */
+typedef struct URING_CONNECTION_TAG
+{
+    /* NULL once the socket IO closed the connection */
+    struct SOCKET_IO_INSTANCE_TAG* socket_io_instance;
+    SOCKETIO_URING* ring;
+    int socket;
+    /* the operations whose last completion is not dispatched yet, and the starved receive */
+    size_t in_flight;
+    bool is_connecting;
+    bool is_receiving;
+    bool is_sending;
+    bool is_starved;
+    struct URING_CONNECTION_TAG* next_starved;
+    URING_OPERATION connect_operation;
+    URING_OPERATION connect_timeout_operation;
+    URING_OPERATION receive_operation;
+    URING_OPERATION send_operation;
+    URING_OPERATION cancel_operation;
+    SINGLYLINKEDLIST_HANDLE pending_io_list;
+    SLAB_HANDLE pending_io_slab;
+    /* the sendmsg in flight gathers the first pending IOs, the kernel reads message and iovecs until it completes */
+    struct msghdr message;
+    struct iovec iovecs[SOCKETIO_URING_MAX_IOVECS];
+    /* the addresses of the host name, tried in turn until one connects */
+    CONNECT_ADDRESS* addresses;
+    size_t address_count;
+    size_t next_address;
+    /* the error of the last address that failed, the open fails with it once no address is left */
+    int last_error;
+    struct __kernel_timespec connect_timeout;
+} URING_CONNECTION;
+
+typedef struct SOCKET_IO_INSTANCE_TAG
+{
+    /* the socket given by SOCKETIO_CONFIG for an accepted connection, it becomes the socket of the connection on socketio_open */
+    int accepted_socket;
+    ON_BYTES_RECEIVED on_bytes_received;
+    ON_IO_ERROR on_io_error;
+    void* on_bytes_received_context;
+    void* on_io_error_context;
+    char* hostname;
+    int port;
+    /* set by the unix_socket_path option, the socket IO then connects to this Unix domain socket and hostname and port are only kept for the layers above */
+    char* unix_socket_path;
+    IO_STATE io_state;
+    ON_IO_OPEN_COMPLETE on_io_open_complete;
+    void* on_io_open_complete_context;
+    unsigned int connect_timeout_ms;
+    uint64_t connect_start_ms;
+    /* set while the host name is resolved by the DNS resolver, the connect starts once socketio_dowork or dns_lookup_timer finds it resolved */
+    DNS_RESOLVER_LOOKUP_HANDLE dns_lookup;
+    /* started while the host name is resolved with an event loop, the ring has nothing in flight for the socket IO until the connect is submitted */
+    SOCKETIO_EVENT_LOOP_TIMER_HANDLE dns_lookup_timer;
+    URING_CONNECTION* connection;
+    /* the ring of the event loop, or the own ring of the socket IO, created by the first socketio_open */
+    SOCKETIO_URING* ring;
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop;
+    ARENA_HANDLE arena;
+} SOCKET_IO_INSTANCE;
+
+/*this function will clone an option given by name and value*/
+static void* socketio_CloneOption(const char* name, const void* value)
+{
+    void* result;
+
+    if (name != NULL)
+    {
+        result = NULL;
+
+        if (strcmp(name, OPTION_CONNECT_TIMEOUT) == 0)
+        {
+            unsigned int* value_clone = (unsigned int*)malloc(sizeof(unsigned int));
+            if (value_clone == NULL)
+            {
+                LogError("Failed cloning option %s", name);
+            }
+            else
+            {
+                *value_clone = *(const unsigned int*)value;
+                result = value_clone;
+            }
+        }
+        else if (strcmp(name, OPTION_UNIX_SOCKET_PATH) == 0)
+        {
+            char* value_clone;
+            if (mallocAndStrcpy_s(&value_clone, (const char*)value) != 0)
+            {
+                LogError("Failed cloning option %s", name);
+            }
+            else
+            {
+                result = value_clone;
+            }
+        }
+        else
+        {
+            LogError("Cannot clone option %s (not suppported)", name);
+        }
+    }
+    else
+    {
+        result = NULL;
+    }
+    return result;
+}
+
+/*this function destroys an option previously created*/
+static void socketio_DestroyOption(const char* name, const void* value)
+{
+    if ((name != NULL) &&
+        ((strcmp(name, OPTION_CONNECT_TIMEOUT) == 0) || (strcmp(name, OPTION_UNIX_SOCKET_PATH) == 0)))
+    {
+        free((void*)value);
+    }
+}
+
+static OPTIONHANDLER_HANDLE socketio_retrieveoptions(CONCRETE_IO_HANDLE handle)
+{
+    OPTIONHANDLER_HANDLE result;
+
+    if (handle == NULL)
+    {
+        LogError("failed retrieving options (handle is NULL)");
+        result = NULL;
+    }
+    else
+    {
+        SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)handle;
+
+        result = OptionHandler_Create(socketio_CloneOption, socketio_DestroyOption, socketio_setoption);
+        if (result == NULL)
+        {
+            LogError("unable to OptionHandler_Create");
+        }
+        else if ((socket_io_instance->connect_timeout_ms != SOCKETIO_DEFAULT_CONNECT_TIMEOUT_MS) &&
+            (OptionHandler_AddOption(result, OPTION_CONNECT_TIMEOUT, &socket_io_instance->connect_timeout_ms) != OPTIONHANDLER_OK))
+        {
+            LogError("failed retrieving options (failed adding %s)", OPTION_CONNECT_TIMEOUT);
+            OptionHandler_Destroy(result);
+            result = NULL;
+        }
+        else if ((socket_io_instance->unix_socket_path != NULL) &&
+            (OptionHandler_AddOption(result, OPTION_UNIX_SOCKET_PATH, socket_io_instance->unix_socket_path) != OPTIONHANDLER_OK))
+        {
+            LogError("failed retrieving options (failed adding %s)", OPTION_UNIX_SOCKET_PATH);
+            OptionHandler_Destroy(result);
+            result = NULL;
+        }
+    }
+
+    return result;
+}
+
+static const IO_INTERFACE_DESCRIPTION socket_io_interface_description =
+{
+    socketio_retrieveoptions,
+    socketio_create,
+    socketio_destroy,
+    socketio_open,
+    socketio_close,
+    socketio_send,
+    socketio_dowork,
+    socketio_setoption,
+    socketio_create_with_arena,
+    socketio_sendv
+};
+
+static void indicate_error(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    if (socket_io_instance->on_io_error != NULL)
+    {
+        socket_io_instance->on_io_error(socket_io_instance->on_io_error_context);
+    }
+}
+
+static void indicate_open_complete(SOCKET_IO_INSTANCE* socket_io_instance, IO_OPEN_RESULT open_result, int code)
+{
+    if (socket_io_instance->on_io_open_complete != NULL)
+    {
+        IO_OPEN_RESULT_DETAILED open_result_detailed;
+        open_result_detailed.result = open_result;
+        open_result_detailed.code = code;
+        socket_io_instance->on_io_open_complete(socket_io_instance->on_io_open_complete_context, open_result_detailed);
+    }
+}
+
+static int get_time_ms(uint64_t* time_ms)
+{
+    int result;
+    struct timespec ts;
+
+    if (get_time_ns(&ts) != 0)
+    {
+        LogError("Failure: cannot get the current time.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        *time_ms = (uint64_t)ts.tv_sec * MILLISECONDS_IN_1_SECOND + (uint64_t)ts.tv_nsec / NANOSECONDS_IN_1_MILLISECOND;
+        result = 0;
+    }
+
+    return result;
+}
+
+static void release_dns_lookup(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    if (socket_io_instance->dns_lookup != NULL)
+    {
+        dns_resolver_release(socket_io_instance->dns_lookup);
+        socket_io_instance->dns_lookup = NULL;
+        socketio_event_loop_stop_timer(socket_io_instance->dns_lookup_timer);
+    }
+}
+
+/* the timer is due at the next check of the lookup, or when the connect times out if that is sooner, right away when the lookup is resolved */
+static void start_dns_lookup_timer(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    uint64_t now_ms;
+
+    if (socket_io_instance->dns_lookup_timer == NULL)
+    {
+        /* no event loop, socketio_dowork checks the lookup */
+    }
+    else if (get_time_ms(&now_ms) != 0)
+    {
+        LogError("Failure: cannot start the DNS lookup timer.");
+    }
+    else
+    {
+        uint64_t due_ms = now_ms + ((dns_resolver_get_result(socket_io_instance->dns_lookup, NULL, NULL) == DNS_RESOLVER_PENDING) ? SOCKETIO_DNS_LOOKUP_POLL_INTERVAL_MS : 0);
+        uint64_t timeout_ms = socket_io_instance->connect_start_ms + socket_io_instance->connect_timeout_ms;
+
+        if ((socket_io_instance->connect_timeout_ms != 0) && (timeout_ms < due_ms))
+        {
+            due_ms = (timeout_ms > now_ms) ? timeout_ms : now_ms;
+        }
+
+        if (socketio_event_loop_start_timer(socket_io_instance->dns_lookup_timer, (unsigned int)(due_ms - now_ms)) != 0)
+        {
+            LogError("Failure: socketio_event_loop_start_timer failed.");
+        }
+    }
+}
+
+static void free_uring(SOCKETIO_URING* ring)
+{
+    /* closing the ring unregisters the buffer ring, the kernel does not use the memory of the ring past it */
+    if (ring->ring_fd != -1)
+    {
+        (void)close(ring->ring_fd);
+    }
+    if (ring->sqes != MAP_FAILED)
+    {
+        (void)munmap(ring->sqes, ring->sqes_size);
+    }
+    if ((ring->cq_ring != MAP_FAILED) && (ring->cq_ring != ring->sq_ring))
+    {
+        (void)munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    if (ring->sq_ring != MAP_FAILED)
+    {
+        (void)munmap(ring->sq_ring, ring->sq_ring_size);
+    }
+    if (ring->buffer_ring != MAP_FAILED)
+    {
+        (void)munmap(ring->buffer_ring, ring->buffer_ring_size);
+    }
+    free(ring->buffers);
+    free(ring);
+}
+
+static int map_uring(SOCKETIO_URING* ring, const struct io_uring_params* params)
+{
+    int result;
+
+    ring->sq_ring_size = params->sq_off.array + (params->sq_entries * sizeof(unsigned int));
+    ring->cq_ring_size = params->cq_off.cqes + (params->cq_entries * sizeof(struct io_uring_cqe));
+    ring->sqes_size = params->sq_entries * sizeof(struct io_uring_sqe);
+
+    /* the submission and completion rings share one mapping on the kernels that allow it */
+    if ((params->features & IORING_FEAT_SINGLE_MMAP) != 0)
+    {
+        if (ring->cq_ring_size > ring->sq_ring_size)
+        {
+            ring->sq_ring_size = ring->cq_ring_size;
+        }
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+
+    if ((ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQ_RING)) == MAP_FAILED)
+    {
+        LogError("Failure: cannot map the submission ring. errno=%d (%s).", errno, strerror(errno));
+        result = __FAILURE__;
+    }
+    else if ((ring->cq_ring = ((params->features & IORING_FEAT_SINGLE_MMAP) != 0) ? ring->sq_ring :
+        mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_CQ_RING)) == MAP_FAILED)
+    {
+        LogError("Failure: cannot map the completion ring. errno=%d (%s).", errno, strerror(errno));
+        result = __FAILURE__;
+    }
+    else if ((ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQES)) == MAP_FAILED)
+    {
+        LogError("Failure: cannot map the submission entries. errno=%d (%s).", errno, strerror(errno));
+        result = __FAILURE__;
+    }
+    else
+    {
+        unsigned char* sq_ring = (unsigned char*)ring->sq_ring;
+        unsigned char* cq_ring = (unsigned char*)ring->cq_ring;
+
+        ring->sq_head = (unsigned int*)(sq_ring + params->sq_off.head);
+        ring->sq_tail = (unsigned int*)(sq_ring + params->sq_off.tail);
+        ring->sq_flags = (unsigned int*)(sq_ring + params->sq_off.flags);
+        ring->sq_array = (unsigned int*)(sq_ring + params->sq_off.array);
+        ring->sq_mask = *(unsigned int*)(sq_ring + params->sq_off.ring_mask);
+        ring->sq_entries = params->sq_entries;
+        ring->cq_head = (unsigned int*)(cq_ring + params->cq_off.head);
+        ring->cq_tail = (unsigned int*)(cq_ring + params->cq_off.tail);
+        ring->cq_mask = *(unsigned int*)(cq_ring + params->cq_off.ring_mask);
+        ring->cqes = (struct io_uring_cqe*)(cq_ring + params->cq_off.cqes);
+        result = 0;
+    }
+
+    return result;
+}
+
+static void give_back_buffer(SOCKETIO_URING* ring, unsigned short buffer_id)
+{
+    struct io_uring_buf* buffer = &ring->buffer_ring->bufs[ring->buffer_tail & (ring->buffer_count - 1)];
+    buffer->addr = (uint64_t)(uintptr_t)(ring->buffers + ((size_t)buffer_id * ring->buffer_size));
+    buffer->len = ring->buffer_size;
+    buffer->bid = buffer_id;
+    ring->buffer_tail++;
+    __atomic_store_n(&ring->buffer_ring->tail, ring->buffer_tail, __ATOMIC_RELEASE);
+}
+
+static int register_buffers(SOCKETIO_URING* ring, unsigned int buffer_count, unsigned int buffer_size)
+{
+    int result;
+
+    ring->buffer_count = buffer_count;
+    ring->buffer_size = buffer_size;
+    ring->buffer_tail = 0;
+    /* the buffer ring is shared with the kernel and has to be page aligned */
+    ring->buffer_ring_size = buffer_count * sizeof(struct io_uring_buf);
+
+    if ((ring->buffer_ring = (struct io_uring_buf_ring*)mmap(NULL, ring->buffer_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED)
+    {
+        LogError("Failure: cannot map the buffer ring. errno=%d (%s).", errno, strerror(errno));
+        result = __FAILURE__;
+    }
+    else if ((ring->buffers = (unsigned char*)malloc((size_t)buffer_count * buffer_size)) == NULL)
+    {
+        LogError("Failure: cannot allocate the receive buffers.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        struct io_uring_buf_reg buffer_registration;
+        (void)memset(&buffer_registration, 0, sizeof(buffer_registration));
+        buffer_registration.ring_addr = (uint64_t)(uintptr_t)ring->buffer_ring;
+        buffer_registration.ring_entries = buffer_count;
+        buffer_registration.bgid = SOCKETIO_URING_BUFFER_GROUP;
+
+        if (syscall(__NR_io_uring_register, ring->ring_fd, IORING_REGISTER_PBUF_RING, &buffer_registration, 1) != 0)
+        {
+            LogError("Failure: cannot register the buffer ring, it needs Linux 5.19 or later. errno=%d (%s).", errno, strerror(errno));
+            result = __FAILURE__;
+        }
+        else
+        {
+            unsigned int i;
+            for (i = 0; i < buffer_count; i++)
+            {
+                give_back_buffer(ring, (unsigned short)i);
+            }
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+static SOCKETIO_URING* create_uring(unsigned int entries, unsigned int completions, unsigned int buffer_count, unsigned int buffer_size)
+{
+    SOCKETIO_URING* result = (SOCKETIO_URING*)malloc(sizeof(SOCKETIO_URING));
+    if (result == NULL)
+    {
+        LogError("Failure: cannot allocate the ring.");
+    }
+    else
+    {
+        struct io_uring_params params;
+        (void)memset(&params, 0, sizeof(params));
+        params.flags = IORING_SETUP_CQSIZE;
+        params.cq_entries = completions;
+
+        result->sq_ring = MAP_FAILED;
+        result->cq_ring = MAP_FAILED;
+        result->sqes = MAP_FAILED;
+        result->buffer_ring = MAP_FAILED;
+        result->buffers = NULL;
+
+        if ((result->ring_fd = (int)syscall(__NR_io_uring_setup, entries, &params)) < 0)
+        {
+            LogError("Failure: io_uring_setup failed. errno=%d (%s).", errno, strerror(errno));
+            result->ring_fd = -1;
+            free_uring(result);
+            result = NULL;
+        }
+        else if ((params.features & IORING_FEAT_NODROP) == 0)
+        {
+            LogError("Failure: the ring may drop completions, it needs Linux 5.5 or later.");
+            free_uring(result);
+            result = NULL;
+        }
+        else if ((map_uring(result, &params) != 0) ||
+            (register_buffers(result, buffer_count, buffer_size) != 0))
+        {
+            free_uring(result);
+            result = NULL;
+        }
+        else
+        {
+            result->unsubmitted = 0;
+            result->in_flight = 0;
+            result->is_dispatching = false;
+            result->is_orphaned = false;
+            result->starved = NULL;
+            result->event_loop_registration = NULL;
+        }
+    }
+
+    return result;
+}
+
+/* submits the queued submissions, and waits for min_complete completions when it is not 0 */
+static int enter_uring(SOCKETIO_URING* ring, unsigned int min_complete, unsigned int flags)
+{
+    int result;
+    int entered;
+
+    do
+    {
+        entered = (int)syscall(__NR_io_uring_enter, ring->ring_fd, ring->unsubmitted, min_complete, flags, NULL, 0);
+    } while ((entered < 0) && (errno == EINTR));
+
+    if (entered < 0)
+    {
+        LogError("Failure: io_uring_enter failed. errno=%d (%s).", errno, strerror(errno));
+        result = __FAILURE__;
+    }
+    else
+    {
+        ring->unsubmitted -= ((unsigned int)entered < ring->unsubmitted) ? (unsigned int)entered : ring->unsubmitted;
+        result = 0;
+    }
+
+    return result;
+}
+
+static int submit_uring(SOCKETIO_URING* ring)
+{
+    int result;
+
+    if (ring->is_dispatching || (ring->unsubmitted == 0))
+    {
+        result = 0;
+    }
+    else
+    {
+        result = enter_uring(ring, 0, 0);
+    }
+
+    return result;
+}
+
+/* makes room for count submissions, submitting the queued ones if the submission ring is too full */
+static int reserve_sqes(SOCKETIO_URING* ring, unsigned int count)
+{
+    int result;
+
+    if ((ring->sq_entries - (*ring->sq_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE)) >= count) ||
+        ((enter_uring(ring, 0, 0) == 0) && (ring->sq_entries - (*ring->sq_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE)) >= count)))
+    {
+        result = 0;
+    }
+    else
+    {
+        LogError("Failure: the submission ring is full.");
+        result = __FAILURE__;
+    }
+
+    return result;
+}
+
+/* the entry is queued as it is returned, the kernel only reads it on the next io_uring_enter */
+static struct io_uring_sqe* get_sqe(SOCKETIO_URING* ring, uint64_t user_data)
+{
+    struct io_uring_sqe* result;
+
+    if (reserve_sqes(ring, 1) != 0)
+    {
+        result = NULL;
+    }
+    else
+    {
+        unsigned int tail = *ring->sq_tail;
+        unsigned int index = tail & ring->sq_mask;
+
+        result = &ring->sqes[index];
+        (void)memset(result, 0, sizeof(struct io_uring_sqe));
+        result->user_data = user_data;
+        ring->sq_array[index] = index;
+        __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+        ring->unsubmitted++;
+        ring->in_flight++;
+    }
+
+    return result;
+}
+
+static struct io_uring_sqe* get_operation_sqe(URING_CONNECTION* connection, URING_OPERATION* operation)
+{
+    struct io_uring_sqe* result = get_sqe(connection->ring, (uint64_t)(uintptr_t)operation);
+    if (result != NULL)
+    {
+        connection->in_flight++;
+    }
+
+    return result;
+}
+
+static void free_pending_io(URING_CONNECTION* connection, PENDING_SOCKET_IO* pending_socket_io)
+{
+    if (pending_socket_io->constbuffer != NULL)
+    {
+        CONSTBUFFER_Destroy(pending_socket_io->constbuffer);
+    }
+    else
+    {
+        free(pending_socket_io->copied_bytes);
+    }
+    slab_free(connection->pending_io_slab, pending_socket_io);
+}
+
+static void free_connection(URING_CONNECTION* connection)
+{
+    LIST_ITEM_HANDLE first_pending_io;
+
+    /* the pending sends of a closed socket IO are dropped without their callbacks */
+    while ((first_pending_io = singlylinkedlist_get_head_item(connection->pending_io_list)) != NULL)
+    {
+        free_pending_io(connection, (PENDING_SOCKET_IO*)singlylinkedlist_item_get_value(first_pending_io));
+        (void)singlylinkedlist_remove(connection->pending_io_list, first_pending_io);
+    }
+
+    singlylinkedlist_destroy(connection->pending_io_list);
+    slab_destroy(connection->pending_io_slab);
+    free(connection->addresses);
+    free(connection);
+}
+
+static void release_connection(URING_CONNECTION* connection)
+{
+    connection->in_flight--;
+    if ((connection->in_flight == 0) && (connection->socket_io_instance == NULL))
+    {
+        free_connection(connection);
+    }
+}
+
+static void init_operation(URING_OPERATION* operation, URING_CONNECTION* connection, URING_OPERATION_KIND kind)
+{
+    operation->connection = connection;
+    operation->kind = kind;
+}
+
+static URING_CONNECTION* create_connection(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    URING_CONNECTION* result = (URING_CONNECTION*)malloc(sizeof(URING_CONNECTION));
+    if (result == NULL)
+    {
+        LogError("Failure: cannot allocate the connection.");
+    }
+    else if ((result->pending_io_list = singlylinkedlist_create()) == NULL)
+    {
+        LogError("Failure: singlylinkedlist_create unable to create pending list.");
+        free(result);
+        result = NULL;
+    }
+    else if ((result->pending_io_slab = slab_create(sizeof(PENDING_SOCKET_IO), PENDING_SOCKET_IOS_PER_CHUNK)) == NULL)
+    {
+        LogError("Failure: slab_create unable to create pending IO slab.");
+        singlylinkedlist_destroy(result->pending_io_list);
+        free(result);
+        result = NULL;
+    }
+    else
+    {
+        result->socket_io_instance = socket_io_instance;
+        result->ring = socket_io_instance->ring;
+        result->socket = INVALID_SOCKET;
+        result->in_flight = 0;
+        result->is_connecting = false;
+        result->is_receiving = false;
+        result->is_sending = false;
+        result->is_starved = false;
+        result->next_starved = NULL;
+        init_operation(&result->connect_operation, result, URING_OPERATION_CONNECT);
+        init_operation(&result->connect_timeout_operation, result, URING_OPERATION_CONNECT_TIMEOUT);
+        init_operation(&result->receive_operation, result, URING_OPERATION_RECEIVE);
+        init_operation(&result->send_operation, result, URING_OPERATION_SEND);
+        init_operation(&result->cancel_operation, result, URING_OPERATION_CANCEL);
+        result->addresses = NULL;
+        result->address_count = 0;
+        result->next_address = 0;
+        result->last_error = 0;
+        socket_io_instance->connection = result;
+    }
+
+    return result;
+}
+
+static void cancel_operation(URING_CONNECTION* connection, URING_OPERATION* operation)
+{
+    struct io_uring_sqe* sqe = get_operation_sqe(connection, &connection->cancel_operation);
+    if (sqe == NULL)
+    {
+        LogError("Failure: cannot cancel an operation of the socket.");
+    }
+    else
+    {
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = (uint64_t)(uintptr_t)operation;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_ALL;
+    }
+}
+
+/* detaches the connection from its socket IO, the operations in flight are cancelled and the connection is freed by the last completion */
+static void close_connection(URING_CONNECTION* connection)
+{
+    connection->socket_io_instance->connection = NULL;
+    connection->socket_io_instance = NULL;
+
+    if (connection->socket != INVALID_SOCKET)
+    {
+        (void)shutdown(connection->socket, SHUT_RDWR);
+        if (connection->is_connecting)
+        {
+            /* the link timeout of the connect is cancelled with it */
+            cancel_operation(connection, &connection->connect_operation);
+        }
+        if (connection->is_receiving)
+        {
+            cancel_operation(connection, &connection->receive_operation);
+        }
+        if (connection->is_sending)
+        {
+            cancel_operation(connection, &connection->send_operation);
+        }
+
+        /* the operations in flight hold the file, the socket is released when they completed */
+        (void)close(connection->socket);
+        connection->socket = INVALID_SOCKET;
+        (void)submit_uring(connection->ring);
+    }
+
+    if (connection->in_flight == 0)
+    {
+        free_connection(connection);
+    }
+}
+
+/* the socket IO goes back to closed, so that it can be opened again, the callback may destroy it */
+static void indicate_connect_failed(SOCKET_IO_INSTANCE* socket_io_instance, int code)
+{
+    release_dns_lookup(socket_io_instance);
+    if (socket_io_instance->connection != NULL)
+    {
+        close_connection(socket_io_instance->connection);
+    }
+    socket_io_instance->io_state = IO_STATE_CLOSED;
+    indicate_open_complete(socket_io_instance, IO_OPEN_ERROR, code);
+}
+
+static int start_receive(URING_CONNECTION* connection)
+{
+    int result;
+    struct io_uring_sqe* sqe = get_operation_sqe(connection, &connection->receive_operation);
+    if (sqe == NULL)
+    {
+        LogError("Failure: cannot receive from the socket.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* the receive completes for each read until it fails, or the ring runs out of buffers or completion entries */
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = connection->socket;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = SOCKETIO_URING_BUFFER_GROUP;
+        connection->is_receiving = true;
+        result = 0;
+    }
+
+    return result;
+}
+
+/* the pending IOs are sent in order, as many as SOCKETIO_URING_MAX_IOVECS of them per sendmsg, with one sendmsg in flight at a time */
+static int send_pending_ios(URING_CONNECTION* connection)
+{
+    int result;
+    int iovec_count = 0;
+    LIST_ITEM_HANDLE pending_io = singlylinkedlist_get_head_item(connection->pending_io_list);
+    struct io_uring_sqe* sqe;
+
+    while ((pending_io != NULL) && (iovec_count < SOCKETIO_URING_MAX_IOVECS))
+    {
+        PENDING_SOCKET_IO* pending_socket_io = (PENDING_SOCKET_IO*)singlylinkedlist_item_get_value(pending_io);
+        connection->iovecs[iovec_count].iov_base = (void*)pending_socket_io->bytes;
+        connection->iovecs[iovec_count].iov_len = pending_socket_io->size;
+        iovec_count++;
+        pending_io = singlylinkedlist_get_next_item(pending_io);
+    }
+
+    if (iovec_count == 0)
+    {
+        result = 0;
+    }
+    else if ((sqe = get_operation_sqe(connection, &connection->send_operation)) == NULL)
+    {
+        LogError("Failure: cannot send to the socket.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        (void)memset(&connection->message, 0, sizeof(connection->message));
+        connection->message.msg_iov = connection->iovecs;
+        connection->message.msg_iovlen = iovec_count;
+
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->fd = connection->socket;
+        sqe->addr = (uint64_t)(uintptr_t)&connection->message;
+        sqe->len = 1;
+        sqe->msg_flags = MSG_NOSIGNAL;
+        connection->is_sending = true;
+        /* the sendmsg is queued, a submit that fails leaves it for the next one */
+        (void)submit_uring(connection->ring);
+        result = 0;
+    }
+
+    return result;
+}
+
+static int submit_connect(URING_CONNECTION* connection, const CONNECT_ADDRESS* connect_address, unsigned int timeout_ms)
+{
+    int result;
+
+    /* the connect and its timeout are linked, they have to be queued together */
+    if (reserve_sqes(connection->ring, 2) != 0)
+    {
+        result = __FAILURE__;
+    }
+    else
+    {
+        struct io_uring_sqe* sqe = get_operation_sqe(connection, &connection->connect_operation);
+        sqe->opcode = IORING_OP_CONNECT;
+        sqe->fd = connection->socket;
+        sqe->addr = (uint64_t)(uintptr_t)&connect_address->address;
+        sqe->off = connect_address->address_length;
+
+        if (timeout_ms != 0)
+        {
+            /* the timeout cancels the connect, which completes with ECANCELED */
+            sqe->flags = IOSQE_IO_LINK;
+            connection->connect_timeout.tv_sec = timeout_ms / MILLISECONDS_IN_1_SECOND;
+            connection->connect_timeout.tv_nsec = (long long)(timeout_ms % MILLISECONDS_IN_1_SECOND) * NANOSECONDS_IN_1_MILLISECOND;
+
+            sqe = get_operation_sqe(connection, &connection->connect_timeout_operation);
+            sqe->opcode = IORING_OP_LINK_TIMEOUT;
+            sqe->fd = -1;
+            sqe->addr = (uint64_t)(uintptr_t)&connection->connect_timeout;
+            sqe->len = 1;
+        }
+
+        connection->is_connecting = true;
+        (void)submit_uring(connection->ring);
+        result = 0;
+    }
+
+    return result;
+}
+
+/* connects to the next address that gets as far as a submitted connect, the connect timeout covers every address */
+static int connect_next_address(URING_CONNECTION* connection)
+{
+    int result = __FAILURE__;
+    SOCKET_IO_INSTANCE* socket_io_instance = connection->socket_io_instance;
+
+    while ((result != 0) && (connection->next_address < connection->address_count))
+    {
+        const CONNECT_ADDRESS* connect_address = &connection->addresses[connection->next_address++];
+        unsigned int timeout_ms = 0;
+        uint64_t now_ms;
+
+        if (get_time_ms(&now_ms) != 0)
+        {
+            connection->last_error = __FAILURE__;
+            break;
+        }
+
+        if (socket_io_instance->connect_timeout_ms != 0)
+        {
+            uint64_t elapsed_ms = now_ms - socket_io_instance->connect_start_ms;
+            if (elapsed_ms >= socket_io_instance->connect_timeout_ms)
+            {
+                LogError("Failure: connecting to %s timed out after %u ms.", socket_io_instance->hostname, socket_io_instance->connect_timeout_ms);
+                connection->last_error = CONNECT_TIMEOUT_ERROR_CODE;
+                break;
+            }
+            timeout_ms = socket_io_instance->connect_timeout_ms - (unsigned int)elapsed_ms;
+        }
+
+        if ((connection->socket = socket(connect_address->address.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0)) == INVALID_SOCKET)
+        {
+            LogError("Failure: socket create failure %d.", errno);
+            connection->last_error = errno;
+        }
+        else if (submit_connect(connection, connect_address, timeout_ms) != 0)
+        {
+            connection->last_error = __FAILURE__;
+            (void)close(connection->socket);
+            connection->socket = INVALID_SOCKET;
+        }
+        else
+        {
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+static bool is_supported_address(const struct addrinfo* address)
+{
+    return (address->ai_addrlen <= sizeof(struct sockaddr_storage)) &&
+        (((address->ai_family == AF_INET) && (address->ai_addrlen >= sizeof(struct sockaddr_in))) ||
+         ((address->ai_family == AF_INET6) && (address->ai_addrlen >= sizeof(struct sockaddr_in6))));
+}
+
+/* the connection is closed when no address gets as far as a submitted connect */
+static int connect_first_address(URING_CONNECTION* connection, int* error_code)
+{
+    int result;
+
+    if (connect_next_address(connection) != 0)
+    {
+        *error_code = connection->last_error;
+        close_connection(connection);
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+/* the addresses are tried in the order getaddrinfo sorted them */
+static int start_connect(SOCKET_IO_INSTANCE* socket_io_instance, const struct addrinfo* addresses, int* error_code)
+{
+    int result;
+    const struct addrinfo* address;
+    size_t address_count = 0;
+    URING_CONNECTION* connection;
+
+    for (address = addresses; address != NULL; address = address->ai_next)
+    {
+        address_count += is_supported_address(address) ? 1 : 0;
+    }
+
+    if (address_count == 0)
+    {
+        LogError("Failure: no IPv4 or IPv6 address to connect to.");
+        *error_code = __FAILURE__;
+        result = __FAILURE__;
+    }
+    else if ((connection = create_connection(socket_io_instance)) == NULL)
+    {
+        *error_code = __FAILURE__;
+        result = __FAILURE__;
+    }
+    else if ((connection->addresses = (CONNECT_ADDRESS*)malloc(address_count * sizeof(CONNECT_ADDRESS))) == NULL)
+    {
+        LogError("Failure: cannot allocate the addresses.");
+        close_connection(connection);
+        *error_code = __FAILURE__;
+        result = __FAILURE__;
+    }
+    else
+    {
+        for (address = addresses; address != NULL; address = address->ai_next)
+        {
+            if (is_supported_address(address))
+            {
+                CONNECT_ADDRESS* connect_address = &connection->addresses[connection->address_count++];
+                (void)memcpy(&connect_address->address, address->ai_addr, address->ai_addrlen);
+                connect_address->address_length = (socklen_t)address->ai_addrlen;
+                /* the resolver looks the host name up without a service, the port is set here */
+                if (address->ai_family == AF_INET)
+                {
+                    ((struct sockaddr_in*)&connect_address->address)->sin_port = htons((uint16_t)socket_io_instance->port);
+                }
+                else
+                {
+                    ((struct sockaddr_in6*)&connect_address->address)->sin6_port = htons((uint16_t)socket_io_instance->port);
+                }
+            }
+        }
+
+        result = connect_first_address(connection, error_code);
+    }
+
+    return result;
+}
+
+/* a path starting with '@' names a socket in the abstract namespace, which has no file and goes away with its listener */
+static int start_unix_connect(SOCKET_IO_INSTANCE* socket_io_instance, int* error_code)
+{
+    int result;
+    const char* path = socket_io_instance->unix_socket_path;
+    size_t path_length = strlen(path);
+    URING_CONNECTION* connection;
+
+    if (path_length >= sizeof(((struct sockaddr_un*)NULL)->sun_path))
+    {
+        LogError("Failure: the Unix domain socket path %s is longer than %lu characters.", path, (unsigned long)(sizeof(((struct sockaddr_un*)NULL)->sun_path) - 1));
+        *error_code = __FAILURE__;
+        result = __FAILURE__;
+    }
+    else if ((connection = create_connection(socket_io_instance)) == NULL)
+    {
+        *error_code = __FAILURE__;
+        result = __FAILURE__;
+    }
+    else if ((connection->addresses = (CONNECT_ADDRESS*)malloc(sizeof(CONNECT_ADDRESS))) == NULL)
+    {
+        LogError("Failure: cannot allocate the addresses.");
+        close_connection(connection);
+        *error_code = __FAILURE__;
+        result = __FAILURE__;
+    }
+    else
+    {
+        struct sockaddr_un* address = (struct sockaddr_un*)&connection->addresses[0].address;
+        (void)memset(address, 0, sizeof(struct sockaddr_un));
+        address->sun_family = AF_UNIX;
+        (void)memcpy(address->sun_path, path, path_length);
+        if (path[0] == '@')
+        {
+            /* the name of an abstract socket is the bytes after the leading NUL, the length of the address says where it ends */
+            address->sun_path[0] = '\0';
+            connection->addresses[0].address_length = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + path_length);
+        }
+        else
+        {
+            connection->addresses[0].address_length = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + path_length + 1);
+        }
+        connection->address_count = 1;
+
+        result = connect_first_address(connection, error_code);
+    }
+
+    return result;
+}
+
+static void on_connect_complete(URING_CONNECTION* connection, int connect_result)
+{
+    SOCKET_IO_INSTANCE* socket_io_instance = connection->socket_io_instance;
+    connection->is_connecting = false;
+
+    if (socket_io_instance == NULL)
+    {
+        /* closed while connecting */
+    }
+    else if (connect_result == 0)
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_011: [ When a connect succeeds, the socket IO shall start the multishot receive and call on_io_open_complete with IO_OPEN_OK. ]*/
+        free(connection->addresses);
+        connection->addresses = NULL;
+        connection->address_count = 0;
+
+        if (start_receive(connection) != 0)
+        {
+            indicate_connect_failed(socket_io_instance, __FAILURE__);
+        }
+        else
+        {
+            socket_io_instance->io_state = IO_STATE_OPEN;
+            (void)submit_uring(connection->ring);
+            indicate_open_complete(socket_io_instance, IO_OPEN_OK, 0);
+        }
+    }
+    else if (connect_result == -ECANCELED)
+    {
+        LogError("Failure: connecting to %s timed out after %u ms.", socket_io_instance->hostname, socket_io_instance->connect_timeout_ms);
+        indicate_connect_failed(socket_io_instance, CONNECT_TIMEOUT_ERROR_CODE);
+    }
+    else
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_012: [ When a connect fails, the next address shall be connected to. When none is left the socket IO shall go back to closed and call on_io_open_complete with IO_OPEN_ERROR and the error of the last connect, or CONNECT_TIMEOUT_ERROR_CODE (9999) if the connect timed out. ]*/
+        LogError("Failure: connect failure %d.", -connect_result);
+        connection->last_error = -connect_result;
+        (void)close(connection->socket);
+        connection->socket = INVALID_SOCKET;
+
+        if (connect_next_address(connection) != 0)
+        {
+            indicate_connect_failed(socket_io_instance, connection->last_error);
+        }
+    }
+}
+
+static void on_receive_complete(URING_CONNECTION* connection, int receive_result, unsigned int flags)
+{
+    SOCKET_IO_INSTANCE* socket_io_instance = connection->socket_io_instance;
+
+    if ((flags & IORING_CQE_F_MORE) == 0)
+    {
+        connection->is_receiving = false;
+    }
+
+    if (receive_result > 0)
+    {
+        unsigned short buffer_id = (unsigned short)(flags >> IORING_CQE_BUFFER_SHIFT);
+        SOCKETIO_URING* ring = connection->ring;
+
+        /* Codes_SRS_SOCKETIO_URING_03_022: [ For each completion of the receive, the socket IO shall call on_bytes_received with the bytes in the receive buffer, and give the buffer back to the ring when it returns. ]*/
+        if ((socket_io_instance != NULL) && (socket_io_instance->io_state == IO_STATE_OPEN) && (socket_io_instance->on_bytes_received != NULL))
+        {
+            /* Explicitly ignoring here the result of the callback */
+            (void)socket_io_instance->on_bytes_received(socket_io_instance->on_bytes_received_context, ring->buffers + ((size_t)buffer_id * ring->buffer_size), (size_t)receive_result);
+        }
+        give_back_buffer(ring, buffer_id);
+
+        /* the multishot receive ends when the completion ring overflows, the callback may also have closed the socket IO */
+        socket_io_instance = connection->socket_io_instance;
+        if (!connection->is_receiving && (socket_io_instance != NULL) && (socket_io_instance->io_state == IO_STATE_OPEN) && (start_receive(connection) != 0))
+        {
+            socket_io_instance->io_state = IO_STATE_ERROR;
+            indicate_error(socket_io_instance);
+        }
+    }
+    else if (receive_result == -ENOBUFS)
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_024: [ When the ring has no receive buffer left, the receive shall start again once the dispatch of the completions gave the buffers back. ]*/
+        /* every buffer is held by a completion not dispatched yet, the receive starts again when the dispatch gave them back */
+        if ((socket_io_instance != NULL) && (socket_io_instance->io_state == IO_STATE_OPEN) && !connection->is_starved)
+        {
+            connection->is_starved = true;
+            connection->next_starved = connection->ring->starved;
+            connection->ring->starved = connection;
+            connection->in_flight++;
+        }
+    }
+    else if ((socket_io_instance != NULL) && (socket_io_instance->io_state == IO_STATE_OPEN))
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_023: [ When the peer closed the socket or the receive fails, the socket IO shall call on_io_error. ]*/
+        if (receive_result < 0)
+        {
+            LogError("Socketio_Failure: Receiving data from endpoint: errno=%d.", -receive_result);
+        }
+        // Do not log error when 0 bytes are received, this is probably the socket being closed on the other end
+        socket_io_instance->io_state = IO_STATE_ERROR;
+        indicate_error(socket_io_instance);
+    }
+}
+
+static void on_send_complete(URING_CONNECTION* connection, int send_result)
+{
+    SOCKET_IO_INSTANCE* socket_io_instance = connection->socket_io_instance;
+    connection->is_sending = false;
+
+    if (socket_io_instance == NULL)
+    {
+        /* closed, the pending IOs are freed with the connection */
+    }
+    else if (send_result < 0)
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_021: [ When a sendmsg fails, the socket IO shall call on_io_error. ]*/
+        LogError("Failure: sending socket failed. errno=%d (%s).", -send_result, strerror(-send_result));
+        socket_io_instance->io_state = IO_STATE_ERROR;
+        indicate_error(socket_io_instance);
+    }
+    else
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_020: [ When a sendmsg completes, the pending IOs it sent shall be completed in order with IO_SEND_OK, and the next sendmsg shall send what is left. ]*/
+        size_t sent_size = (size_t)send_result;
+        LIST_ITEM_HANDLE first_pending_io;
+
+        while ((sent_size > 0) && ((first_pending_io = singlylinkedlist_get_head_item(connection->pending_io_list)) != NULL))
+        {
+            PENDING_SOCKET_IO* pending_socket_io = (PENDING_SOCKET_IO*)singlylinkedlist_item_get_value(first_pending_io);
+            if (sent_size < pending_socket_io->size)
+            {
+                pending_socket_io->bytes += sent_size;
+                pending_socket_io->size -= sent_size;
+                sent_size = 0;
+            }
+            else
+            {
+                ON_SEND_COMPLETE on_pending_send_complete = pending_socket_io->on_send_complete;
+                void* callback_context = pending_socket_io->callback_context;
+
+                sent_size -= pending_socket_io->size;
+                free_pending_io(connection, pending_socket_io);
+                (void)singlylinkedlist_remove(connection->pending_io_list, first_pending_io);
+
+                if (on_pending_send_complete != NULL)
+                {
+                    on_pending_send_complete(callback_context, IO_SEND_OK);
+                }
+
+                /* the callback may have closed the socket IO */
+                if (connection->socket_io_instance == NULL)
+                {
+                    break;
+                }
+            }
+        }
+
+        socket_io_instance = connection->socket_io_instance;
+        if ((socket_io_instance != NULL) && (socket_io_instance->io_state == IO_STATE_OPEN) && !connection->is_sending &&
+            (send_pending_ios(connection) != 0))
+        {
+            socket_io_instance->io_state = IO_STATE_ERROR;
+            indicate_error(socket_io_instance);
+        }
+    }
+}
+
+static void on_completion(SOCKETIO_URING* ring, const struct io_uring_cqe* cqe)
+{
+    URING_OPERATION* operation = (URING_OPERATION*)(uintptr_t)cqe->user_data;
+    bool is_last = ((cqe->flags & IORING_CQE_F_MORE) == 0);
+
+    /* an operation without user_data is the cancel of a ring being destroyed */
+    if (operation != NULL)
+    {
+        URING_CONNECTION* connection = operation->connection;
+
+        switch (operation->kind)
+        {
+        case URING_OPERATION_CONNECT:
+            on_connect_complete(connection, cqe->res);
+            break;
+        case URING_OPERATION_RECEIVE:
+            on_receive_complete(connection, cqe->res, cqe->flags);
+            break;
+        case URING_OPERATION_SEND:
+            on_send_complete(connection, cqe->res);
+            break;
+        default:
+            /* the completions of the connect timeouts and of the cancels */
+            break;
+        }
+
+        /* the operation kept the connection alive through its callbacks */
+        if (is_last)
+        {
+            release_connection(connection);
+        }
+    }
+
+    if (is_last)
+    {
+        ring->in_flight--;
+    }
+}
+
+static void reap_uring(SOCKETIO_URING* ring)
+{
+    unsigned int head = *ring->cq_head;
+    unsigned int tail;
+    bool is_overflowed;
+
+    do
+    {
+        /* the completions that did not fit in the completion ring are kept by the kernel until io_uring_enter flushes them */
+        if ((is_overflowed = ((__atomic_load_n(ring->sq_flags, __ATOMIC_ACQUIRE) & IORING_SQ_CQ_OVERFLOW) != 0)))
+        {
+            (void)enter_uring(ring, 0, IORING_ENTER_GETEVENTS);
+        }
+
+        while (head != (tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)))
+        {
+            while (head != tail)
+            {
+                struct io_uring_cqe cqe = ring->cqes[head & ring->cq_mask];
+                head++;
+                __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+                on_completion(ring, &cqe);
+            }
+        }
+    } while (is_overflowed);
+
+    while (ring->starved != NULL)
+    {
+        URING_CONNECTION* connection = ring->starved;
+        ring->starved = connection->next_starved;
+        connection->is_starved = false;
+
+        if ((connection->socket_io_instance != NULL) && (connection->socket_io_instance->io_state == IO_STATE_OPEN) && !connection->is_receiving &&
+            (start_receive(connection) != 0))
+        {
+            connection->socket_io_instance->io_state = IO_STATE_ERROR;
+            indicate_error(connection->socket_io_instance);
+        }
+        release_connection(connection);
+    }
+}
+
+static void destroy_uring(SOCKETIO_URING* ring)
+{
+    if (ring->is_dispatching)
+    {
+        ring->is_orphaned = true;
+    }
+    else
+    {
+        /* the kernel uses the memory of the operations in flight until they complete, they are cancelled and waited for */
+        if (ring->in_flight > 0)
+        {
+            struct io_uring_sqe* sqe = get_sqe(ring, 0);
+            if (sqe != NULL)
+            {
+                sqe->opcode = IORING_OP_ASYNC_CANCEL;
+                sqe->fd = -1;
+                sqe->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+            }
+        }
+
+        ring->is_dispatching = true;
+        while ((ring->in_flight > 0) && (enter_uring(ring, 1, IORING_ENTER_GETEVENTS) == 0))
+        {
+            reap_uring(ring);
+        }
+
+        free_uring(ring);
+    }
+}
+
+static void dispatch_uring(SOCKETIO_URING* ring)
+{
+    /* a callback calling socketio_dowork does not dispatch the completions again */
+    if (!ring->is_dispatching)
+    {
+        ring->is_dispatching = true;
+        reap_uring(ring);
+        ring->is_dispatching = false;
+
+        if (ring->is_orphaned)
+        {
+            ring->is_orphaned = false;
+            destroy_uring(ring);
+        }
+        else
+        {
+            (void)submit_uring(ring);
+        }
+    }
+}
+
+static void on_uring_event(void* context, unsigned int events)
+{
+    (void)events;
+    dispatch_uring((SOCKETIO_URING*)context);
+}
+
+static void destroy_event_loop_uring(void* context)
+{
+    SOCKETIO_URING* ring = (SOCKETIO_URING*)context;
+    socketio_event_loop_unregister(ring->event_loop_registration);
+    ring->event_loop_registration = NULL;
+    destroy_uring(ring);
+}
+
+/* the socket IOs of an event loop share one ring, the loop dispatches its completions when the ring is readable */
+static SOCKETIO_URING* get_event_loop_uring(SOCKETIO_EVENT_LOOP_HANDLE event_loop)
+{
+    SOCKETIO_URING* result = (SOCKETIO_URING*)socketio_event_loop_get_context(event_loop);
+    if ((result == NULL) &&
+        ((result = create_uring(SOCKETIO_URING_LOOP_ENTRIES, SOCKETIO_URING_LOOP_COMPLETIONS, SOCKETIO_URING_LOOP_BUFFER_COUNT, SOCKETIO_URING_LOOP_BUFFER_SIZE)) != NULL))
+    {
+        if ((result->event_loop_registration = socketio_event_loop_register(event_loop, result->ring_fd, SOCKETIO_EVENT_READABLE, on_uring_event, result)) == NULL)
+        {
+            LogError("Failure: cannot register the ring with the event loop.");
+            destroy_uring(result);
+            result = NULL;
+        }
+        else if (socketio_event_loop_set_context(event_loop, result, destroy_event_loop_uring) != 0)
+        {
+            LogError("Failure: cannot keep the ring in the event loop.");
+            destroy_event_loop_uring(result);
+            result = NULL;
+        }
+    }
+
+    return result;
+}
+
+static bool is_connect_timed_out(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    uint64_t now_ms;
+    return (socket_io_instance->connect_timeout_ms != 0) &&
+        (get_time_ms(&now_ms) == 0) &&
+        ((now_ms - socket_io_instance->connect_start_ms) >= socket_io_instance->connect_timeout_ms);
+}
+
+static void check_dns_lookup(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    const struct addrinfo* addresses = NULL;
+    int error = 0;
+    DNS_RESOLVER_RESULT dns_result = dns_resolver_get_result(socket_io_instance->dns_lookup, &addresses, &error);
+
+    if (dns_result == DNS_RESOLVER_PENDING)
+    {
+        if (is_connect_timed_out(socket_io_instance))
+        {
+            LogError("Failure: resolving %s timed out after %u ms.", socket_io_instance->hostname, socket_io_instance->connect_timeout_ms);
+            indicate_connect_failed(socket_io_instance, CONNECT_TIMEOUT_ERROR_CODE);
+        }
+        else
+        {
+            start_dns_lookup_timer(socket_io_instance);
+        }
+    }
+    else if (dns_result != DNS_RESOLVER_OK)
+    {
+        LogError("Failure: getaddrinfo failure %d.", error);
+        indicate_connect_failed(socket_io_instance, error);
+    }
+    else
+    {
+        int start_result = start_connect(socket_io_instance, addresses, &error);
+        /* the addresses are copied in the connection, the cache keeps them for the next lookups of the host name */
+        release_dns_lookup(socket_io_instance);
+
+        if (start_result != 0)
+        {
+            indicate_connect_failed(socket_io_instance, error);
+        }
+    }
+}
+
+static void on_dns_lookup_timer(void* context)
+{
+    SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)context;
+
+    if (socket_io_instance->dns_lookup != NULL)
+    {
+        check_dns_lookup(socket_io_instance);
+    }
+}
+
+CONCRETE_IO_HANDLE socketio_create(void* io_create_parameters)
+{
+    /* Codes_SRS_SOCKETIO_URING_03_003: [ socketio_create shall allocate the socket IO on the heap and return it. The ring is not created until the socket IO is opened. ]*/
+    return socketio_create_with_arena(io_create_parameters, NULL);
+}
+
+CONCRETE_IO_HANDLE socketio_create_with_arena(void* io_create_parameters, ARENA_HANDLE arena)
+{
+    SOCKETIO_CONFIG* socket_io_config = io_create_parameters;
+    SOCKET_IO_INSTANCE* result;
+
+    if (socket_io_config == NULL)
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_001: [ If io_create_parameters is NULL, socketio_create shall fail and return NULL. ]*/
+        LogError("Invalid argument: socket_io_config is NULL");
+        result = NULL;
+    }
+    else if ((result = arena_malloc_or_heap(arena, sizeof(SOCKET_IO_INSTANCE))) == NULL)
+    {
+        LogError("Allocation Failure: SOCKET_IO_INSTANCE");
+    }
+    else
+    {
+        result->arena = arena;
+        if (socket_io_config->hostname != NULL)
+        {
+            result->hostname = (char*)arena_malloc_or_heap(result->arena, strlen(socket_io_config->hostname) + 1);
+            if (result->hostname != NULL)
+            {
+                (void)strcpy(result->hostname, socket_io_config->hostname);
+            }
+
+            result->accepted_socket = INVALID_SOCKET;
+        }
+        else
+        {
+            result->hostname = NULL;
+            result->accepted_socket = (socket_io_config->accepted_socket == NULL) ? INVALID_SOCKET : *((int*)socket_io_config->accepted_socket);
+        }
+
+        result->dns_lookup_timer = NULL;
+
+        if ((result->hostname == NULL) && (result->accepted_socket == INVALID_SOCKET))
+        {
+            /* Codes_SRS_SOCKETIO_URING_03_002: [ If the hostname of the SOCKETIO_CONFIG is NULL and it has no accepted_socket, socketio_create shall fail and return NULL. ]*/
+            LogError("Failure: hostname == NULL and socket is invalid.");
+            arena_free_or_heap(result->arena, result);
+            result = NULL;
+        }
+        else
+        {
+            /* Codes_SRS_SOCKETIO_URING_03_037: [ socketio_create_with_arena shall allocate the socket IO and its host name in arena when arena is not NULL, on the heap otherwise, and return it. ]*/
+            result->port = socket_io_config->port;
+            result->unix_socket_path = NULL;
+            result->on_bytes_received = NULL;
+            result->on_io_error = NULL;
+            result->on_bytes_received_context = NULL;
+            result->on_io_error_context = NULL;
+            result->io_state = IO_STATE_CLOSED;
+            result->on_io_open_complete = NULL;
+            result->on_io_open_complete_context = NULL;
+            result->connect_timeout_ms = SOCKETIO_DEFAULT_CONNECT_TIMEOUT_MS;
+            result->connect_start_ms = 0;
+            result->dns_lookup = NULL;
+            result->connection = NULL;
+            result->ring = NULL;
+            /* the connect timeout is measured on the monotonic clock */
+            set_time_basis();
+            result->event_loop = NULL;
+        }
+    }
+
+    return result;
+}
+
+void socketio_destroy(CONCRETE_IO_HANDLE socket_io)
+{
+    /* Codes_SRS_SOCKETIO_URING_03_004: [ If socket_io is NULL, socketio_destroy shall return. ]*/
+    if (socket_io != NULL)
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_005: [ socketio_destroy shall close the socket like socketio_close, without indicating the open, destroy the ring of the socket IO when it has its own, and free the socket IO. ]*/
+        SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)socket_io;
+        release_dns_lookup(socket_io_instance);
+        socketio_event_loop_destroy_timer(socket_io_instance->dns_lookup_timer);
+        if (socket_io_instance->connection != NULL)
+        {
+            close_connection(socket_io_instance->connection);
+        }
+        /* the ring of an event loop is destroyed with the loop */
+        if ((socket_io_instance->ring != NULL) && (socket_io_instance->event_loop == NULL))
+        {
+            destroy_uring(socket_io_instance->ring);
+        }
+        if (socket_io_instance->accepted_socket != INVALID_SOCKET)
+        {
+            (void)close(socket_io_instance->accepted_socket);
+        }
+
+        free(socket_io_instance->unix_socket_path);
+        arena_free_or_heap(socket_io_instance->arena, socket_io_instance->hostname);
+        arena_free_or_heap(socket_io_instance->arena, socket_io);
+    }
+}
+
+int socketio_open(CONCRETE_IO_HANDLE socket_io, ON_IO_OPEN_COMPLETE on_io_open_complete, void* on_io_open_complete_context, ON_BYTES_RECEIVED on_bytes_received, void* on_bytes_received_context, ON_IO_ERROR on_io_error, void* on_io_error_context)
+{
+    int result;
+    bool is_connecting = false;
+
+    IO_OPEN_RESULT_DETAILED open_result_detailed = { IO_OPEN_OK, 0 };
+
+    SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)socket_io;
+    if (socket_io == NULL)
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_006: [ If socket_io is NULL or the socket IO is not closed, socketio_open shall fail, call on_io_open_complete with IO_OPEN_ERROR and return a non-zero value. ]*/
+        LogError("Invalid argument: SOCKET_IO_INSTANCE is NULL");
+        result = open_result_detailed.code = __FAILURE__;
+    }
+    else if (socket_io_instance->io_state != IO_STATE_CLOSED)
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_006: [ If socket_io is NULL or the socket IO is not closed, socketio_open shall fail, call on_io_open_complete with IO_OPEN_ERROR and return a non-zero value. ]*/
+        LogError("Failure: socket state is not closed.");
+        result = open_result_detailed.code = __FAILURE__;
+    }
+    else
+    {
+        socket_io_instance->on_bytes_received = on_bytes_received;
+        socket_io_instance->on_bytes_received_context = on_bytes_received_context;
+
+        socket_io_instance->on_io_error = on_io_error;
+        socket_io_instance->on_io_error_context = on_io_error_context;
+
+        socket_io_instance->on_io_open_complete = on_io_open_complete;
+        socket_io_instance->on_io_open_complete_context = on_io_open_complete_context;
+
+        /* Codes_SRS_SOCKETIO_URING_03_007: [ The first socketio_open shall create the ring of a socket IO without an event loop. With an event loop it shall use the ring of the loop, which the first socket IO of the loop to open creates, registers with the loop and keeps in the loop with socketio_event_loop_set_context. ]*/
+        if ((socket_io_instance->ring == NULL) &&
+            ((socket_io_instance->ring = (socket_io_instance->event_loop == NULL) ?
+                create_uring(SOCKETIO_URING_ENTRIES, SOCKETIO_URING_COMPLETIONS, SOCKETIO_URING_BUFFER_COUNT, SOCKETIO_URING_BUFFER_SIZE) :
+                get_event_loop_uring(socket_io_instance->event_loop)) == NULL))
+        {
+            result = open_result_detailed.code = __FAILURE__;
+        }
+        else if (socket_io_instance->accepted_socket != INVALID_SOCKET)
+        {
+            /* Codes_SRS_SOCKETIO_URING_03_008: [ For an accepted socket, socketio_open shall start the multishot receive, call on_io_open_complete with IO_OPEN_OK and return 0. ]*/
+            // Opening an accepted socket
+            URING_CONNECTION* connection = create_connection(socket_io_instance);
+            if (connection == NULL)
+            {
+                result = open_result_detailed.code = __FAILURE__;
+            }
+            else
+            {
+                connection->socket = socket_io_instance->accepted_socket;
+                socket_io_instance->accepted_socket = INVALID_SOCKET;
+
+                if (start_receive(connection) != 0)
+                {
+                    close_connection(connection);
+                    result = open_result_detailed.code = __FAILURE__;
+                }
+                else
+                {
+                    socket_io_instance->io_state = IO_STATE_OPEN;
+                    (void)submit_uring(socket_io_instance->ring);
+                    result = 0;
+                }
+            }
+        }
+        /* the connect timeout covers resolving the host name and connecting */
+        else if (get_time_ms(&socket_io_instance->connect_start_ms) != 0)
+        {
+            result = open_result_detailed.code = __FAILURE__;
+        }
+        else if (socket_io_instance->unix_socket_path != NULL)
+        {
+            /* Codes_SRS_SOCKETIO_URING_03_032: [ When the unix_socket_path option is set, socketio_open shall submit a connect to that Unix domain socket, linked to the connect timeout, instead of resolving the host name, and return 0. ]*/
+            socket_io_instance->io_state = IO_STATE_OPENING;
+            if (start_unix_connect(socket_io_instance, &open_result_detailed.code) != 0)
+            {
+                socket_io_instance->io_state = IO_STATE_CLOSED;
+                result = __FAILURE__;
+            }
+            else
+            {
+                is_connecting = true;
+                result = 0;
+            }
+        }
+        else if ((socket_io_instance->dns_lookup = dns_resolver_lookup(socket_io_instance->hostname)) != NULL)
+        {
+            /* Codes_SRS_SOCKETIO_URING_03_009: [ socketio_open shall resolve the host name with the DNS resolver when the application initialized it, socketio_dowork then connects once the resolver has the addresses, and with getaddrinfo otherwise. ]*/
+            /* Codes_SRS_SOCKETIO_URING_03_036: [ With an event loop, socketio_open shall start the timer of the socket IO to check the lookup every SOCKETIO_DNS_LOOKUP_POLL_INTERVAL_MS milliseconds until it is resolved or the connect times out, socketio_dowork does not have to be called. ]*/
+            /* the resolver has a thread resolve the host name, or has it cached, socketio_dowork or the timer connects once it has the addresses */
+            socket_io_instance->io_state = IO_STATE_OPENING;
+            start_dns_lookup_timer(socket_io_instance);
+            is_connecting = true;
+            result = 0;
+        }
+        else
+        {
+            /* the application does not use the resolver, the host name is resolved here */
+            struct addrinfo* addrInfo;
+            char portString[16];
+            struct addrinfo addrHint = { 0 };
+            addrHint.ai_family = AF_UNSPEC;
+            addrHint.ai_socktype = SOCK_STREAM;
+            addrHint.ai_protocol = 0;
+
+            sprintf(portString, "%u", socket_io_instance->port);
+            int err = getaddrinfo(socket_io_instance->hostname, portString, &addrHint, &addrInfo);
+            if (err != 0)
+            {
+                LogError("Failure: getaddrinfo failure %d.", err);
+                open_result_detailed.code = err;
+                result = __FAILURE__;
+            }
+            else
+            {
+                socket_io_instance->io_state = IO_STATE_OPENING;
+                /* Codes_SRS_SOCKETIO_URING_03_010: [ socketio_open shall submit a connect to the first address, linked to a timeout of what is left of the connect_timeout option, and return 0. The open is indicated when the connect completes. ]*/
+                if (start_connect(socket_io_instance, addrInfo, &open_result_detailed.code) != 0)
+                {
+                    socket_io_instance->io_state = IO_STATE_CLOSED;
+                    result = __FAILURE__;
+                }
+                else
+                {
+                    is_connecting = true;
+                    result = 0;
+                }
+                freeaddrinfo(addrInfo);
+            }
+        }
+    }
+
+    /* Codes_SRS_SOCKETIO_URING_03_013: [ If any other error occurs, socketio_open shall fail, call on_io_open_complete with IO_OPEN_ERROR and return a non-zero value. ]*/
+    if ((on_io_open_complete != NULL) && !is_connecting)
+    {
+        open_result_detailed.result = result == 0 ? IO_OPEN_OK : IO_OPEN_ERROR;
+        on_io_open_complete(on_io_open_complete_context, open_result_detailed);
+    }
+
+    return result;
+}
+
+int socketio_close(CONCRETE_IO_HANDLE socket_io, ON_IO_CLOSE_COMPLETE on_io_close_complete, void* callback_context)
+{
+    int result = 0;
+
+    if (socket_io == NULL)
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_014: [ If socket_io is NULL, socketio_close shall fail and return a non-zero value. ]*/
+        result = __FAILURE__;
+    }
+    else
+    {
+        SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)socket_io;
+        if ((socket_io_instance->io_state != IO_STATE_CLOSED) && (socket_io_instance->io_state != IO_STATE_CLOSING))
+        {
+            // Only close if the socket isn't already in the closed or closing state
+            bool is_connecting = (socket_io_instance->io_state == IO_STATE_OPENING);
+
+            /* Codes_SRS_SOCKETIO_URING_03_015: [ socketio_close shall cancel the operations of the socket in flight, close the socket, drop the pending sends without calling their callbacks, call on_io_close_complete and return 0. No callback of the socket IO is called for the operations that complete after. ]*/
+            release_dns_lookup(socket_io_instance);
+            if (socket_io_instance->connection != NULL)
+            {
+                close_connection(socket_io_instance->connection);
+            }
+            socket_io_instance->io_state = IO_STATE_CLOSED;
+
+            if (is_connecting)
+            {
+                /* Codes_SRS_SOCKETIO_URING_03_016: [ If the socket IO is opening, socketio_close shall call on_io_open_complete with IO_OPEN_CANCELLED. ]*/
+                indicate_open_complete(socket_io_instance, IO_OPEN_CANCELLED, 0);
+            }
+        }
+
+        if (on_io_close_complete != NULL)
+        {
+            on_io_close_complete(callback_context);
+        }
+
+        result = 0;
+    }
+
+    return result;
+}
+
+/* the bytes are copied in a pending IO, or a reference to constbuffer is kept, and sent once the sends queued before them are */
+static int send_buffers(SOCKET_IO_INSTANCE* socket_io_instance, const CONSTBUFFER* buffers, size_t buffer_count, size_t size, CONSTBUFFER_HANDLE constbuffer, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    int result;
+
+    if (socket_io_instance->io_state != IO_STATE_OPEN)
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_018: [ If the socket IO is not open, the send functions shall fail and return a non-zero value. ]*/
+        LogError("Failure: socket state is not opened.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_019: [ The send functions shall queue a pending IO with a copy of the bytes, or a reference to constbuffer, submit a sendmsg of the pending IOs when none is in flight, and return 0. ]*/
+        URING_CONNECTION* connection = socket_io_instance->connection;
+        PENDING_SOCKET_IO* pending_socket_io = (PENDING_SOCKET_IO*)slab_malloc(connection->pending_io_slab);
+        LIST_ITEM_HANDLE pending_io;
+
+        if (pending_socket_io == NULL)
+        {
+            LogError("Allocation Failure: Unable to allocate pending list.");
+            result = __FAILURE__;
+        }
+        else
+        {
+            if (constbuffer != NULL)
+            {
+                pending_socket_io->copied_bytes = NULL;
+                pending_socket_io->constbuffer = CONSTBUFFER_Clone(constbuffer);
+                pending_socket_io->bytes = buffers[0].buffer;
+            }
+            else
+            {
+                pending_socket_io->constbuffer = NULL;
+                pending_socket_io->copied_bytes = (unsigned char*)malloc(size);
+                pending_socket_io->bytes = pending_socket_io->copied_bytes;
+            }
+
+            if ((pending_socket_io->constbuffer == NULL) &&
+                (pending_socket_io->copied_bytes == NULL))
+            {
+                LogError("Allocation Failure: Unable to allocate pending list.");
+                slab_free(connection->pending_io_slab, pending_socket_io);
+                result = __FAILURE__;
+            }
+            else
+            {
+                size_t i;
+                size_t copied_size = 0;
+
+                pending_socket_io->size = size;
+                pending_socket_io->on_send_complete = on_send_complete;
+                pending_socket_io->callback_context = callback_context;
+                if (pending_socket_io->copied_bytes != NULL)
+                {
+                    for (i = 0; i < buffer_count; i++)
+                    {
+                        if (buffers[i].size > 0)
+                        {
+                            (void)memcpy(pending_socket_io->copied_bytes + copied_size, buffers[i].buffer, buffers[i].size);
+                            copied_size += buffers[i].size;
+                        }
+                    }
+                }
+
+                if ((pending_io = singlylinkedlist_add(connection->pending_io_list, pending_socket_io)) == NULL)
+                {
+                    LogError("Failure: Unable to add socket to pending list.");
+                    free_pending_io(connection, pending_socket_io);
+                    result = __FAILURE__;
+                }
+                /* the sends queued while a sendmsg is in flight are gathered by the next one */
+                else if (!connection->is_sending && (send_pending_ios(connection) != 0))
+                {
+                    free_pending_io(connection, pending_socket_io);
+                    (void)singlylinkedlist_remove(connection->pending_io_list, pending_io);
+                    result = __FAILURE__;
+                }
+                else
+                {
+                    result = 0;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+int socketio_send(CONCRETE_IO_HANDLE socket_io, const void* buffer, size_t size, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    int result;
+
+    if ((socket_io == NULL) ||
+        (buffer == NULL) ||
+        (size == 0))
+    {
+        /* Invalid arguments */
+        /* Codes_SRS_SOCKETIO_URING_03_017: [ If socket_io is NULL, or there are no bytes to send, the send functions shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: send given invalid parameter");
+        result = __FAILURE__;
+    }
+    else
+    {
+        CONSTBUFFER send_buffer;
+        send_buffer.buffer = (const unsigned char*)buffer;
+        send_buffer.size = size;
+        result = send_buffers((SOCKET_IO_INSTANCE*)socket_io, &send_buffer, 1, size, NULL, on_send_complete, callback_context);
+    }
+
+    return result;
+}
+
+int socketio_sendv(CONCRETE_IO_HANDLE socket_io, const CONSTBUFFER* buffers, size_t buffer_count, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    int result;
+    size_t size = 0;
+    size_t i = 0;
+
+    if ((socket_io != NULL) &&
+        (buffers != NULL))
+    {
+        for (i = 0; i < buffer_count; i++)
+        {
+            if ((buffers[i].size > 0) &&
+                ((buffers[i].buffer == NULL) || (buffers[i].size > SIZE_MAX - size)))
+            {
+                break;
+            }
+            size += buffers[i].size;
+        }
+    }
+
+    if ((socket_io == NULL) ||
+        (buffers == NULL) ||
+        (i < buffer_count) ||
+        (size == 0))
+    {
+        /* Invalid arguments */
+        /* Codes_SRS_SOCKETIO_URING_03_017: [ If socket_io is NULL, or there are no bytes to send, the send functions shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: sendv given invalid parameter");
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = send_buffers((SOCKET_IO_INSTANCE*)socket_io, buffers, buffer_count, size, NULL, on_send_complete, callback_context);
+    }
+
+    return result;
+}
+
+int socketio_send_constbuffer(CONCRETE_IO_HANDLE socket_io, CONSTBUFFER_HANDLE constbuffer, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    int result;
+    const CONSTBUFFER* content;
+
+    if ((socket_io == NULL) ||
+        (constbuffer == NULL) ||
+        ((content = CONSTBUFFER_GetContent(constbuffer)) == NULL) ||
+        (content->size == 0))
+    {
+        /* Invalid arguments */
+        /* Codes_SRS_SOCKETIO_URING_03_017: [ If socket_io is NULL, or there are no bytes to send, the send functions shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: send_constbuffer given invalid parameter");
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = send_buffers((SOCKET_IO_INSTANCE*)socket_io, content, 1, content->size, constbuffer, on_send_complete, callback_context);
+    }
+
+    return result;
+}
+
+void socketio_dowork(CONCRETE_IO_HANDLE socket_io)
+{
+    /* Codes_SRS_SOCKETIO_URING_03_025: [ If socket_io is NULL, socketio_dowork shall return. ]*/
+    if (socket_io != NULL)
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_026: [ While the host name is resolved socketio_dowork shall check the lookup, otherwise it shall dispatch the completions of the own ring of the socket IO. It does nothing for a socket IO of an event loop. ]*/
+        SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)socket_io;
+        if (socket_io_instance->dns_lookup != NULL)
+        {
+            check_dns_lookup(socket_io_instance);
+        }
+        /* the ring of an event loop is dispatched by the loop when it has completions */
+        else if ((socket_io_instance->ring != NULL) && (socket_io_instance->event_loop == NULL))
+        {
+            dispatch_uring(socket_io_instance->ring);
+        }
+    }
+}
+
+// Edison is missing this from netinet/tcp.h, but this code still works if we manually define it.
+#ifndef SOL_TCP
+#define SOL_TCP 6
+#endif
+
+/* an empty path goes back to connecting to hostname and port */
+static int set_unix_socket_path(SOCKET_IO_INSTANCE* socket_io_instance, const char* path)
+{
+    int result;
+    char* new_path = NULL;
+
+    if ((path[0] != '\0') && (mallocAndStrcpy_s(&new_path, path) != 0))
+    {
+        LogError("failed setting option %s", OPTION_UNIX_SOCKET_PATH);
+        result = __FAILURE__;
+    }
+    else
+    {
+        free(socket_io_instance->unix_socket_path);
+        socket_io_instance->unix_socket_path = new_path;
+        result = 0;
+    }
+
+    return result;
+}
+
+/* the first socketio_open picks the ring, the socket IO keeps the loop it was opened with */
+static int set_event_loop(SOCKET_IO_INSTANCE* socket_io_instance, SOCKETIO_EVENT_LOOP_HANDLE event_loop)
+{
+    int result;
+    SOCKETIO_EVENT_LOOP_TIMER_HANDLE dns_lookup_timer = NULL;
+
+    if ((socket_io_instance->io_state != IO_STATE_CLOSED) ||
+        (socket_io_instance->ring != NULL))
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_038: [ socketio_setoption shall fail and return a non-zero value for the event_loop option once the socket IO was opened, or when creating the timer fails. ]*/
+        LogError("option %s can only be set before the first open of the socket IO", OPTION_EVENT_LOOP);
+        result = __FAILURE__;
+    }
+    else if ((socket_io_instance->hostname != NULL) &&
+             ((dns_lookup_timer = socketio_event_loop_create_timer(event_loop, on_dns_lookup_timer, socket_io_instance)) == NULL))
+    {
+        LogError("Failure: socketio_event_loop_create_timer failed.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        socketio_event_loop_destroy_timer(socket_io_instance->dns_lookup_timer);
+        socket_io_instance->dns_lookup_timer = dns_lookup_timer;
+        socket_io_instance->event_loop = event_loop;
+        result = 0;
+    }
+
+    return result;
+}
+
+static bool is_tcp_option(const char* optionName)
+{
+    return (strcmp(optionName, "tcp_keepalive") == 0) ||
+        (strcmp(optionName, "tcp_keepalive_time") == 0) ||
+        (strcmp(optionName, "tcp_keepalive_interval") == 0) ||
+        (strcmp(optionName, "tcp_nodelay") == 0);
+}
+
+int socketio_setoption(CONCRETE_IO_HANDLE socket_io, const char* optionName, const void* value)
+{
+    int result;
+
+    if (socket_io == NULL ||
+        optionName == NULL ||
+        value == NULL)
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_027: [ If socket_io, optionName or value is NULL, socketio_setoption shall fail and return a non-zero value. ]*/
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_SOCKETIO_URING_03_028: [ socketio_setoption shall set the tcp_keepalive, tcp_keepalive_time, tcp_keepalive_interval and tcp_nodelay options on the socket, and return the errno of setsockopt when it fails. ]*/
+        SOCKET_IO_INSTANCE* socket_io_instance = (SOCKET_IO_INSTANCE*)socket_io;
+        int option_socket = (socket_io_instance->connection != NULL) ? socket_io_instance->connection->socket : socket_io_instance->accepted_socket;
+
+        if ((socket_io_instance->unix_socket_path != NULL) && is_tcp_option(optionName))
+        {
+            /* Codes_SRS_SOCKETIO_URING_03_034: [ While the unix_socket_path option is set, socketio_setoption shall ignore the tcp_keepalive, tcp_keepalive_time, tcp_keepalive_interval and tcp_nodelay options and return 0. ]*/
+            /* the layers above set the TCP options without knowing the transport, a Unix domain socket has nothing to set */
+            result = 0;
+        }
+        else if (strcmp(optionName, "tcp_keepalive") == 0)
+        {
+            result = setsockopt(option_socket, SOL_SOCKET, SO_KEEPALIVE, value, sizeof(int));
+            if (result == -1) result = errno;
+        }
+        else if (strcmp(optionName, "tcp_keepalive_time") == 0)
+        {
+            result = setsockopt(option_socket, SOL_TCP, TCP_KEEPIDLE, value, sizeof(int));
+            if (result == -1) result = errno;
+        }
+        else if (strcmp(optionName, "tcp_keepalive_interval") == 0)
+        {
+            result = setsockopt(option_socket, SOL_TCP, TCP_KEEPINTVL, value, sizeof(int));
+            if (result == -1) result = errno;
+        }
+        else if (strcmp(optionName, "tcp_nodelay") == 0)
+        {
+            result = setsockopt(option_socket, IPPROTO_TCP, TCP_NODELAY, value, sizeof(int));
+            if (result == -1) result = errno;
+        }
+        else if (strcmp(optionName, OPTION_CONNECT_TIMEOUT) == 0)
+        {
+            /* Codes_SRS_SOCKETIO_URING_03_029: [ socketio_setoption shall keep the connect_timeout option for the next connect and return 0. ]*/
+            /* it applies to the next connect, a connect in progress keeps the timeout it was submitted with */
+            socket_io_instance->connect_timeout_ms = *(const unsigned int*)value;
+            result = 0;
+        }
+        else if (strcmp(optionName, OPTION_UNIX_SOCKET_PATH) == 0)
+        {
+            /* Codes_SRS_SOCKETIO_URING_03_033: [ socketio_setoption shall keep the unix_socket_path option for the next socketio_open, an empty path clears it, and return 0. ]*/
+            result = set_unix_socket_path(socket_io_instance, (const char*)value);
+        }
+        else if (strcmp(optionName, OPTION_EVENT_LOOP) == 0)
+        {
+            /* Codes_SRS_SOCKETIO_URING_03_035: [ Before the first socketio_open, socketio_setoption shall keep the event_loop option, create a timer of the loop for a socket IO that has a host name, and return 0. ]*/
+            result = set_event_loop(socket_io_instance, (SOCKETIO_EVENT_LOOP_HANDLE)value);
+        }
+        else if ((strcmp(optionName, OPTION_NET_INT_MAC_ADDRESS) == 0) ||
+            (strcmp(optionName, OPTION_RECEIVE_BUFFER_SIZE) == 0) ||
+            (strcmp(optionName, OPTION_RECEIVE_BATCHED) == 0))
+        {
+            /* Codes_SRS_SOCKETIO_URING_03_030: [ socketio_setoption shall fail and return a non-zero value for the receive_buffer_size, receive_batched and net_interface_mac_address options and any unknown option. ]*/
+            /* the receive buffers belong to the ring, and the connect does not bind to a network interface */
+            LogError("option %s is not supported by the io_uring socket IO", optionName);
+            result = __FAILURE__;
+        }
+        else
+        {
+            /* Codes_SRS_SOCKETIO_URING_03_030: [ socketio_setoption shall fail and return a non-zero value for the receive_buffer_size, receive_batched and net_interface_mac_address options and any unknown option. ]*/
+            result = __FAILURE__;
+        }
+    }
+
+    return result;
+}
+
+const IO_INTERFACE_DESCRIPTION* socketio_get_interface_description(void)
+{
+    /* Codes_SRS_SOCKETIO_URING_03_031: [ socketio_get_interface_description shall return the IO_INTERFACE_DESCRIPTION of the socketio API, socketio_retrieveoptions, socketio_create, socketio_destroy, socketio_open, socketio_close, socketio_send, socketio_dowork, socketio_setoption, socketio_create_with_arena and socketio_sendv. ]*/
+    return &socket_io_interface_description;
+}
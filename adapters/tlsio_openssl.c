@@ -25,6 +25,7 @@
 #include "azure_c_shared_utility/x509_openssl.h"
 #include "azure_c_shared_utility/shared_util_options.h"
 #include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/conststring.h"
 #include "azure_c_shared_utility/const_defines.h"
 #include "azure_c_shared_utility/platform.h" // for http proxy settings
 
@@ -68,9 +69,10 @@ typedef struct TLS_IO_INSTANCE_TAG
     BIO* in_bio;
     BIO* out_bio;
     TLSIO_STATE tlsio_state;
-    char* certificate;
-    const char* x509_certificate;
-    const char* x509_private_key;
+    /*the certificate options are shared with the option handlers produced by tlsio_openssl_retrieveoptions*/
+    CONSTSTRING_HANDLE certificate;
+    CONSTSTRING_HANDLE x509_certificate;
+    CONSTSTRING_HANDLE x509_private_key;
     TLSIO_VERSION tls_version;
     bool disable_crl_check;
     bool continue_on_crl_download_failure;
@@ -79,6 +81,7 @@ typedef struct TLS_IO_INSTANCE_TAG
     void* tls_validation_callback_data;
     char* hostname;
     bool ignore_host_name_check;
+    ARENA_HANDLE arena;
 } TLS_IO_INSTANCE;
 
 struct CRYPTO_dynlock_value
@@ -90,6 +93,8 @@ static const char* const OPTION_UNDERLYING_IO_OPTIONS = "underlying_io_options";
 #define SSL_DO_HANDSHAKE_SUCCESS 1
 static int g_ssl_crl_max_size_in_kb = 10 * 1024;
 
+static int tlsio_openssl_set_retrieved_option(void* handle, const char* name, const void* value);
+
 /*this function will clone an option given by name and value*/
 static void* tlsio_openssl_CloneOption(const char* name, const void* value)
 {
@@ -107,65 +112,16 @@ static void* tlsio_openssl_CloneOption(const char* name, const void* value)
         {
             result = (void*)value;
         }
-        else if (strcmp(name, OPTION_TRUSTED_CERT) == 0)
-        {
-            if (mallocAndStrcpy_s((char**)&result, value) != 0)
-            {
-                LogError("unable to mallocAndStrcpy_s TrustedCerts value");
-                result = NULL;
-            }
-            else
-            {
-                /*return as is*/
-            }
-        }
-        else if (strcmp(name, SU_OPTION_X509_CERT) == 0)
-        {
-            if (mallocAndStrcpy_s((char**)&result, value) != 0)
-            {
-                LogError("unable to mallocAndStrcpy_s x509certificate value");
-                result = NULL;
-            }
-            else
-            {
-                /*return as is*/
-            }
-        }
-        else if (strcmp(name, SU_OPTION_X509_PRIVATE_KEY) == 0)
-        {
-            if (mallocAndStrcpy_s((char**)&result, value) != 0)
-            {
-                LogError("unable to mallocAndStrcpy_s x509privatekey value");
-                result = NULL;
-            }
-            else
-            {
-                /*return as is*/
-            }
-        }
-        else if (strcmp(name, OPTION_X509_ECC_CERT) == 0)
+        else if (
+            (strcmp(name, OPTION_TRUSTED_CERT) == 0) ||
+            (strcmp(name, SU_OPTION_X509_CERT) == 0) ||
+            (strcmp(name, SU_OPTION_X509_PRIVATE_KEY) == 0) ||
+            (strcmp(name, OPTION_X509_ECC_CERT) == 0) ||
+            (strcmp(name, OPTION_X509_ECC_KEY) == 0)
+            )
         {
-            if (mallocAndStrcpy_s((char**)&result, value) != 0)
-            {
-                LogError("unable to mallocAndStrcpy_s x509EccCertificate value");
-                result = NULL;
-            }
-            else
-            {
-                /*return as is*/
-            }
-        }
-        else if (strcmp(name, OPTION_X509_ECC_KEY) == 0)
-        {
-            if (mallocAndStrcpy_s((char**)&result, value) != 0)
-            {
-                LogError("unable to mallocAndStrcpy_s x509EccKey value");
-                result = NULL;
-            }
-            else
-            {
-                /*return as is*/
-            }
+            /*the certificates are conststrings, a clone shares the characters*/
+            result = CONSTSTRING_Clone((CONSTSTRING_HANDLE)value);
         }
         else if (strcmp(name, OPTION_TLS_VERSION) == 0)
         {
@@ -240,7 +196,6 @@ static void* tlsio_openssl_CloneOption(const char* name, const void* value)
 /*this function destroys an option previously created*/
 static void tlsio_openssl_DestroyOption(const char* name, const void* value)
 {
-    /*since all options for this layer are actually string copies., disposing of one is just calling free*/
     if (
         (name == NULL) || (value == NULL)
         )
@@ -254,9 +209,12 @@ static void tlsio_openssl_DestroyOption(const char* name, const void* value)
             (strcmp(name, SU_OPTION_X509_CERT) == 0) ||
             (strcmp(name, SU_OPTION_X509_PRIVATE_KEY) == 0) ||
             (strcmp(name, OPTION_X509_ECC_CERT) == 0) ||
-            (strcmp(name, OPTION_X509_ECC_KEY) == 0) ||
-            (strcmp(name, OPTION_TLS_VERSION) == 0)
+            (strcmp(name, OPTION_X509_ECC_KEY) == 0)
             )
+        {
+            CONSTSTRING_Destroy((CONSTSTRING_HANDLE)value);
+        }
+        else if (strcmp(name, OPTION_TLS_VERSION) == 0)
         {
             free((void*)value);
         }
@@ -288,7 +246,7 @@ static OPTIONHANDLER_HANDLE tlsio_openssl_retrieveoptions(CONCRETE_IO_HANDLE han
     }
     else
     {
-        result = OptionHandler_Create(tlsio_openssl_CloneOption, tlsio_openssl_DestroyOption, tlsio_openssl_setoption);
+        result = OptionHandler_Create(tlsio_openssl_CloneOption, tlsio_openssl_DestroyOption, tlsio_openssl_set_retrieved_option);
         if (result == NULL)
         {
             LogError("unable to OptionHandler_Create");
@@ -411,7 +369,8 @@ static const IO_INTERFACE_DESCRIPTION tlsio_openssl_interface_description =
     tlsio_openssl_close,
     tlsio_openssl_send,
     tlsio_openssl_dowork,
-    tlsio_openssl_setoption
+    tlsio_openssl_setoption,
+    tlsio_openssl_create_with_arena
 };
 
 static void log_ERR_get_error(const char* message)
@@ -2024,7 +1983,7 @@ static int create_openssl_instance(TLS_IO_INSTANCE* tlsInstance)
     }
     else if (
         (tlsInstance->certificate != NULL) &&
-        add_certificate_to_store(tlsInstance, tlsInstance->certificate) != 0)
+        add_certificate_to_store(tlsInstance, CONSTSTRING_c_str(tlsInstance->certificate)) != 0)
     {
         SSL_CTX_free(tlsInstance->ssl_context);
         tlsInstance->ssl_context = NULL;
@@ -2035,7 +1994,7 @@ static int create_openssl_instance(TLS_IO_INSTANCE* tlsInstance)
     else if (
         (tlsInstance->x509_certificate != NULL) &&
         (tlsInstance->x509_private_key != NULL) &&
-        (x509_openssl_add_credentials(tlsInstance->ssl_context, tlsInstance->x509_certificate, tlsInstance->x509_private_key) != 0)
+        (x509_openssl_add_credentials(tlsInstance->ssl_context, CONSTSTRING_c_str(tlsInstance->x509_certificate), CONSTSTRING_c_str(tlsInstance->x509_private_key)) != 0)
         )
     {
         SSL_CTX_free(tlsInstance->ssl_context);
@@ -2204,7 +2163,32 @@ void tlsio_openssl_deinit(void)
 #endif
 }
 
+static int tlsio_openssl_copy_string(ARENA_HANDLE arena, char** destination, const char* source)
+{
+    int result;
+
+    if (arena == NULL)
+    {
+        result = mallocAndStrcpy_s(destination, source);
+    }
+    else if ((*destination = arena_copy_string(arena, source)) == NULL)
+    {
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
 CONCRETE_IO_HANDLE tlsio_openssl_create(void* io_create_parameters)
+{
+    return tlsio_openssl_create_with_arena(io_create_parameters, NULL);
+}
+
+CONCRETE_IO_HANDLE tlsio_openssl_create_with_arena(void* io_create_parameters, ARENA_HANDLE arena)
 {
     TLSIO_CONFIG* tls_io_config = io_create_parameters;
     TLS_IO_INSTANCE* result;
@@ -2216,16 +2200,17 @@ CONCRETE_IO_HANDLE tlsio_openssl_create(void* io_create_parameters)
     }
     else
     {
-        result = malloc(sizeof(TLS_IO_INSTANCE));
+        result = arena_malloc_or_heap(arena, sizeof(TLS_IO_INSTANCE));
         if (result == NULL)
         {
             LogError("Failed allocating TLSIO instance.");
         }
         else
         {
-            if (mallocAndStrcpy_s((char **)&result->hostname, tls_io_config->hostname) != 0)
+            result->arena = arena;
+            if (tlsio_openssl_copy_string(result->arena, &result->hostname, tls_io_config->hostname) != 0)
             {
-                free(result);
+                arena_free_or_heap(result->arena, result);
                 result = NULL;
                 LogError("Failed to copy server name.");
             }
@@ -2252,7 +2237,8 @@ CONCRETE_IO_HANDLE tlsio_openssl_create(void* io_create_parameters)
 
                 if (underlying_io_interface == NULL)
                 {
-                    free(result);
+                    arena_free_or_heap(result->arena, result->hostname);
+                    arena_free_or_heap(result->arena, result);
                     result = NULL;
                     LogError("Failed getting socket IO interface description.");
                 }
@@ -2282,10 +2268,12 @@ CONCRETE_IO_HANDLE tlsio_openssl_create(void* io_create_parameters)
                     result->continue_on_crl_download_failure = false;
                     result->disable_default_verify_paths = false;
 
-                    result->underlying_io = xio_create(underlying_io_interface, io_interface_parameters);
+                    /* the underlying IO shares the arena of the TLS IO */
+                    result->underlying_io = (arena == NULL) ? xio_create(underlying_io_interface, io_interface_parameters) : xio_create_with_arena(underlying_io_interface, io_interface_parameters, arena);
                     if (result->underlying_io == NULL)
                     {
-                        free(result);
+                        arena_free_or_heap(result->arena, result->hostname);
+                        arena_free_or_heap(result->arena, result);
                         result = NULL;
                         LogError("Failed xio_create.");
                     }
@@ -2312,11 +2300,17 @@ void tlsio_openssl_destroy(CONCRETE_IO_HANDLE tls_io)
         TLS_IO_INSTANCE* tls_io_instance = (TLS_IO_INSTANCE*)tls_io;
         if (tls_io_instance->certificate != NULL)
         {
-            free(tls_io_instance->certificate);
+            CONSTSTRING_Destroy(tls_io_instance->certificate);
             tls_io_instance->certificate = NULL;
         }
-        free((void*)tls_io_instance->x509_certificate);
-        free((void*)tls_io_instance->x509_private_key);
+        if (tls_io_instance->x509_certificate != NULL)
+        {
+            CONSTSTRING_Destroy(tls_io_instance->x509_certificate);
+        }
+        if (tls_io_instance->x509_private_key != NULL)
+        {
+            CONSTSTRING_Destroy(tls_io_instance->x509_private_key);
+        }
         close_openssl_instance(tls_io_instance);
         if (tls_io_instance->underlying_io != NULL)
         {
@@ -2325,9 +2319,9 @@ void tlsio_openssl_destroy(CONCRETE_IO_HANDLE tls_io)
         }
         if (tls_io_instance->hostname != NULL)
         {
-            free((void *)tls_io_instance->hostname);
+            arena_free_or_heap(tls_io_instance->arena, tls_io_instance->hostname);
         }
-        free(tls_io);
+        arena_free_or_heap(tls_io_instance->arena, tls_io);
     }
 }
 
@@ -2554,6 +2548,59 @@ void tlsio_openssl_dowork(CONCRETE_IO_HANDLE tls_io)
     }
 }
 
+/*stores a new reference to a certificate option, value is shared with the option handlers*/
+static int set_certificate_option(TLS_IO_INSTANCE* tls_io_instance, const char* optionName, CONSTSTRING_HANDLE value)
+{
+    int result;
+
+    if (strcmp(OPTION_TRUSTED_CERT, optionName) == 0)
+    {
+        if (tls_io_instance->certificate != NULL)
+        {
+            // Release the previous certificate
+            CONSTSTRING_Destroy(tls_io_instance->certificate);
+        }
+
+        // Store the certificate
+        tls_io_instance->certificate = CONSTSTRING_Clone(value);
+        result = 0;
+
+        // If we're previously connected then add the cert to the context
+        if (tls_io_instance->ssl_context != NULL)
+        {
+            result = add_certificate_to_store(tls_io_instance, CONSTSTRING_c_str(value));
+        }
+    }
+    else if (strcmp(SU_OPTION_X509_CERT, optionName) == 0 || strcmp(OPTION_X509_ECC_CERT, optionName) == 0)
+    {
+        if (tls_io_instance->x509_certificate != NULL)
+        {
+            LogError("unable to set x509 options more than once");
+            result = __FAILURE__;
+        }
+        else
+        {
+            tls_io_instance->x509_certificate = CONSTSTRING_Clone(value);
+            result = 0;
+        }
+    }
+    else
+    {
+        if (tls_io_instance->x509_private_key != NULL)
+        {
+            LogError("unable to set more than once x509 options");
+            result = __FAILURE__;
+        }
+        else
+        {
+            tls_io_instance->x509_private_key = CONSTSTRING_Clone(value);
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
 int tlsio_openssl_setoption(CONCRETE_IO_HANDLE tls_io, const char* optionName, const void* value)
 {
     int result;
@@ -2566,76 +2613,25 @@ int tlsio_openssl_setoption(CONCRETE_IO_HANDLE tls_io, const char* optionName, c
     {
         TLS_IO_INSTANCE* tls_io_instance = (TLS_IO_INSTANCE*)tls_io;
 
-        if (strcmp(OPTION_TRUSTED_CERT, optionName) == 0)
-        {
-            const char* cert = (const char*)value;
-            size_t len;
-
-            if (tls_io_instance->certificate != NULL)
-            {
-                // Free the memory if it has been previously allocated
-                free(tls_io_instance->certificate);
-            }
-
-            // Store the certificate
-            len = strlen(cert);
-            tls_io_instance->certificate = malloc(len + 1);
-            if (tls_io_instance->certificate == NULL)
-            {
-                result = __FAILURE__;
-            }
-            else
-            {
-                strcpy(tls_io_instance->certificate, cert);
-                result = 0;
-            }
-
-            // If we're previously connected then add the cert to the context
-            if (tls_io_instance->ssl_context != NULL)
-            {
-                result = add_certificate_to_store(tls_io_instance, cert);
-            }
-        }
-        else if (strcmp(SU_OPTION_X509_CERT, optionName) == 0 || strcmp(OPTION_X509_ECC_CERT, optionName) == 0)
-        {
-            if (tls_io_instance->x509_certificate != NULL)
-            {
-                LogError("unable to set x509 options more than once");
-                result = __FAILURE__;
-            }
-            else
-            {
-                /*let's make a copy of this option*/
-                if (mallocAndStrcpy_s((char**)&tls_io_instance->x509_certificate, value) != 0)
-                {
-                    LogError("unable to mallocAndStrcpy_s");
-                    result = __FAILURE__;
-                }
-                else
-                {
-                    result = 0;
-                }
-            }
-        }
-        else if (strcmp(SU_OPTION_X509_PRIVATE_KEY, optionName) == 0 || strcmp(OPTION_X509_ECC_KEY, optionName) == 0)
+        if (
+            (strcmp(OPTION_TRUSTED_CERT, optionName) == 0) ||
+            (strcmp(SU_OPTION_X509_CERT, optionName) == 0) ||
+            (strcmp(OPTION_X509_ECC_CERT, optionName) == 0) ||
+            (strcmp(SU_OPTION_X509_PRIVATE_KEY, optionName) == 0) ||
+            (strcmp(OPTION_X509_ECC_KEY, optionName) == 0)
+            )
         {
-            if (tls_io_instance->x509_private_key != NULL)
+            /*this is the only copy of the certificate made, the option handlers share it from here on*/
+            CONSTSTRING_HANDLE certificate_option = CONSTSTRING_Create((const char*)value);
+            if (certificate_option == NULL)
             {
-                LogError("unable to set more than once x509 options");
+                LogError("unable to CONSTSTRING_Create");
                 result = __FAILURE__;
             }
             else
             {
-                /*let's make a copy of this option*/
-                if (mallocAndStrcpy_s((char**)&tls_io_instance->x509_private_key, value) != 0)
-                {
-                    LogError("unable to mallocAndStrcpy_s");
-                    result = __FAILURE__;
-                }
-                else
-                {
-                    result = 0;
-                }
+                result = set_certificate_option(tls_io_instance, optionName, certificate_option);
+                CONSTSTRING_Destroy(certificate_option);
             }
         }
         else if (strcmp("tls_validation_callback", optionName) == 0)
@@ -2777,6 +2773,34 @@ int tlsio_openssl_setoption(CONCRETE_IO_HANDLE tls_io, const char* optionName, c
     return result;
 }
 
+/*feeds the options produced by tlsio_openssl_retrieveoptions, whose certificates are conststrings and not plain strings*/
+static int tlsio_openssl_set_retrieved_option(void* handle, const char* name, const void* value)
+{
+    int result;
+
+    if (handle == NULL || name == NULL)
+    {
+        LogError("invalid parameter detected: void* handle=%p, const char* name=%p", handle, name);
+        result = __FAILURE__;
+    }
+    else if (
+        (strcmp(OPTION_TRUSTED_CERT, name) == 0) ||
+        (strcmp(SU_OPTION_X509_CERT, name) == 0) ||
+        (strcmp(OPTION_X509_ECC_CERT, name) == 0) ||
+        (strcmp(SU_OPTION_X509_PRIVATE_KEY, name) == 0) ||
+        (strcmp(OPTION_X509_ECC_KEY, name) == 0)
+        )
+    {
+        result = set_certificate_option((TLS_IO_INSTANCE*)handle, name, (CONSTSTRING_HANDLE)value);
+    }
+    else
+    {
+        result = tlsio_openssl_setoption(handle, name, value);
+    }
+
+    return result;
+}
+
 const IO_INTERFACE_DESCRIPTION* tlsio_openssl_get_interface_description(void)
 {
     return &tlsio_openssl_interface_description;
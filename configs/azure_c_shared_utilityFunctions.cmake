@@ -564,7 +564,8 @@ function(set_platform_files c_shared_dir)
         set(LOGGING_C_FILE ${c_shared_dir}/src/consolelogger.c PARENT_SCOPE)
         set(LOGGING_H_FILE ${c_shared_dir}/inc/azure_c_shared_utility/consolelogger.h PARENT_SCOPE)
         
-        if(${use_condition})
+        # the DNS resolver of socketio_berkeley waits on a condition
+        if(${use_condition} OR ${use_socketio})
             set(CONDITION_C_FILE ${c_shared_dir}/adapters/condition_pthreads.c PARENT_SCOPE)
         endif()
 
@@ -580,7 +581,11 @@ function(set_platform_files c_shared_dir)
             set(PLATFORM_C_FILE ${c_shared_dir}/adapters/platform_linux.c PARENT_SCOPE)
         endif()
         if (${use_socketio})
-            set(SOCKETIO_C_FILE ${c_shared_dir}/adapters/socketio_berkeley.c PARENT_SCOPE)
+            if (${use_io_uring})
+                set(SOCKETIO_C_FILE ${c_shared_dir}/adapters/socketio_uring.c ${c_shared_dir}/adapters/socketio_event_loop_epoll.c ${c_shared_dir}/src/dns_resolver.c PARENT_SCOPE)
+            else()
+                set(SOCKETIO_C_FILE ${c_shared_dir}/adapters/socketio_berkeley.c ${c_shared_dir}/adapters/socketio_event_loop_epoll.c ${c_shared_dir}/src/dns_resolver.c PARENT_SCOPE)
+            endif()
         endif()
         set(THREAD_C_FILE ${c_shared_dir}/adapters/threadapi_pthreads.c PARENT_SCOPE)
         set(TICKCOUTER_C_FILE ${c_shared_dir}/adapters/tickcounter_linux.c PARENT_SCOPE)
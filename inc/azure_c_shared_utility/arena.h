@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C"
+{
+#else
+#include <stddef.h>
+#endif
+
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+/* an arena hands out memory by bumping a pointer in large blocks and releases all of it at once in arena_destroy.
+   It is meant for objects that share a lifetime (for example everything a connection allocates at creation time),
+   memory obtained from an arena must never be passed to free. An arena is not thread-safe. */
+typedef struct ARENA_TAG* ARENA_HANDLE;
+
+/* block_size 0 selects ARENA_DEFAULT_BLOCK_SIZE */
+#define ARENA_DEFAULT_BLOCK_SIZE 1024
+
+MOCKABLE_FUNCTION(, ARENA_HANDLE, arena_create, size_t, block_size);
+MOCKABLE_FUNCTION(, void, arena_destroy, ARENA_HANDLE, arena);
+MOCKABLE_FUNCTION(, void*, arena_malloc, ARENA_HANDLE, arena, size_t, size);
+MOCKABLE_FUNCTION(, char*, arena_copy_string, ARENA_HANDLE, arena, const char*, source);
+MOCKABLE_FUNCTION(, size_t, arena_get_allocated_size, ARENA_HANDLE, arena);
+
+/* for objects that come from an arena when their owner was given one and from the heap otherwise.
+   These are macros so that malloc and free are the ones of the including file (gballoc when it redirects them). */
+#define arena_malloc_or_heap(arena, size) (((arena) == NULL) ? malloc(size) : arena_malloc((arena), (size)))
+/* arena memory is released all at once by arena_destroy */
+#define arena_free_or_heap(arena, ptr) (((arena) == NULL) ? free(ptr) : (void)0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARENA_H */
@@ -5,6 +5,7 @@
 #define CONSTBUFFER_H
 
 #include "azure_c_shared_utility/buffer_.h"
+#include "azure_c_shared_utility/constbuffer_types.h"
 
 #ifdef __cplusplus
 #include <cstddef>
@@ -16,15 +17,8 @@ extern "C"
 
 #include "azure_c_shared_utility/umock_c_prod.h"
 
-/*this is the handle*/
-typedef struct CONSTBUFFER_HANDLE_DATA_TAG* CONSTBUFFER_HANDLE;
-
-/*this is what is returned when the content of the buffer needs access*/
-typedef struct CONSTBUFFER_TAG
-{
-    const unsigned char* buffer;
-    size_t size;
-} CONSTBUFFER;
+/*called when the last reference to a constbuffer created by CONSTBUFFER_CreateWithCustomFree goes away*/
+typedef void(*CONSTBUFFER_CUSTOM_FREE_FUNC)(void* context);
 
 /*this creates a new constbuffer from a memory area*/
 MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_Create, const unsigned char*, source, size_t, size);
@@ -32,6 +26,18 @@ MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_Create, const unsigned char*
 /*this creates a new constbuffer from an existing BUFFER_HANDLE*/
 MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateFromBuffer, BUFFER_HANDLE, buffer);
 
+/*this creates a new constbuffer that takes ownership of source (allocated with malloc) without copying it*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateWithMoveMemory, unsigned char*, source, size_t, size);
+
+/*this creates a new constbuffer that refers to source without copying it, customFreeFunc releases source once the constbuffer is destroyed*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateWithCustomFree, const unsigned char*, source, size_t, size, CONSTBUFFER_CUSTOM_FREE_FUNC, customFreeFunc, void*, customFreeFuncContext);
+
+/*this creates a new constbuffer that takes ownership of an existing BUFFER_HANDLE without copying its content*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateFromBufferMove, BUFFER_HANDLE, buffer);
+
+/*this creates a new constbuffer that refers to size bytes of handle starting at offset, without copying them*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateFromOffsetAndSize, CONSTBUFFER_HANDLE, handle, size_t, offset, size_t, size);
+
 MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_Clone, CONSTBUFFER_HANDLE, constbufferHandle);
 
 MOCKABLE_FUNCTION(, const CONSTBUFFER*, CONSTBUFFER_GetContent, CONSTBUFFER_HANDLE, constbufferHandle);
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CONSTBUFFER_ARRAY_H
+#define CONSTBUFFER_ARRAY_H
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C"
+{
+#else
+#include <stddef.h>
+#endif
+
+#include "azure_c_shared_utility/constbuffer.h"
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+/* a constbuffer array is an ordered, ref counted and immutable list of const buffers, used to assemble a payload from
+   several pieces (a header, properties, a body) without copying them into one buffer. Adding a buffer produces a new
+   array that shares the const buffers of the original one, so arrays can be cloned and passed across threads freely. */
+typedef struct CONSTBUFFER_ARRAY_HANDLE_DATA_TAG* CONSTBUFFER_ARRAY_HANDLE;
+
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create, const CONSTBUFFER_HANDLE*, buffers, size_t, buffer_count);
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create_empty);
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_clone, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle);
+MOCKABLE_FUNCTION(, void, constbuffer_array_destroy, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle);
+
+/* these return a new array, constbuffer_array_handle is left unchanged */
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_add_front, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, CONSTBUFFER_HANDLE, constbuffer_handle);
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_add_back, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, CONSTBUFFER_HANDLE, constbuffer_handle);
+
+MOCKABLE_FUNCTION(, int, constbuffer_array_get_buffer_count, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, size_t*, buffer_count);
+MOCKABLE_FUNCTION(, int, constbuffer_array_get_all_buffers_size, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, size_t*, all_buffers_size);
+
+/* returns a new reference to the const buffer, to be released with CONSTBUFFER_Destroy */
+MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, constbuffer_array_get_buffer, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, size_t, buffer_index);
+
+/* produces the contents of all the buffers in order, stored contiguously so that they can be handed to a vectored send
+   as they are. The contents are valid for as long as the array is */
+MOCKABLE_FUNCTION(, int, constbuffer_array_get_contents, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, const CONSTBUFFER**, contents, size_t*, buffer_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONSTBUFFER_ARRAY_H */
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CONSTSTRING_H
+#define CONSTSTRING_H
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C"
+{
+#else
+#include <stddef.h>
+#endif
+
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+/*a conststring is a ref counted, immutable, null terminated string. Cloning it does not copy the characters*/
+typedef struct CONSTSTRING_HANDLE_DATA_TAG* CONSTSTRING_HANDLE;
+
+/*this creates a new conststring holding a copy of source*/
+MOCKABLE_FUNCTION(, CONSTSTRING_HANDLE, CONSTSTRING_Create, const char*, source);
+
+MOCKABLE_FUNCTION(, CONSTSTRING_HANDLE, CONSTSTRING_Clone, CONSTSTRING_HANDLE, handle);
+
+/*the returned string is valid for as long as handle is*/
+MOCKABLE_FUNCTION(, const char*, CONSTSTRING_c_str, CONSTSTRING_HANDLE, handle);
+
+MOCKABLE_FUNCTION(, size_t, CONSTSTRING_length, CONSTSTRING_HANDLE, handle);
+
+MOCKABLE_FUNCTION(, void, CONSTSTRING_Destroy, CONSTSTRING_HANDLE, handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* CONSTSTRING_H */
@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef DNS_RESOLVER_H
+#define DNS_RESOLVER_H
+
+#include "azure_c_shared_utility/macro_utils.h"
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+struct addrinfo;
+
+/* the resolver looks host names up with getaddrinfo on worker threads, so that the thread asking is not held, and keeps what it found in a
+   cache shared by the whole process: the lookups of a host name that is being resolved or was resolved less than a TTL ago share one result.
+   getaddrinfo does not tell the TTL of the DNS records, the TTL of the cache is set with dns_resolver_set_ttl. */
+typedef struct DNS_RESOLVER_LOOKUP_TAG* DNS_RESOLVER_LOOKUP_HANDLE;
+
+#define DNS_RESOLVER_RESULT_VALUES \
+    DNS_RESOLVER_PENDING, \
+    DNS_RESOLVER_OK, \
+    DNS_RESOLVER_ERROR
+
+DEFINE_ENUM(DNS_RESOLVER_RESULT, DNS_RESOLVER_RESULT_VALUES);
+
+/* dns_resolver_init and dns_resolver_deinit are not thread-safe, they are called once by the application, like platform_init.
+   When lookups are not released at the last dns_resolver_deinit, the resolver keeps resolving them and is released with the last of them */
+MOCKABLE_FUNCTION(, int, dns_resolver_init);
+MOCKABLE_FUNCTION(, void, dns_resolver_deinit);
+MOCKABLE_FUNCTION(, int, dns_resolver_set_ttl, unsigned int, ttl_ms, unsigned int, negative_ttl_ms);
+
+MOCKABLE_FUNCTION(, DNS_RESOLVER_LOOKUP_HANDLE, dns_resolver_lookup, const char*, hostname);
+/* the addresses are those of getaddrinfo, they are valid until the lookup is released */
+MOCKABLE_FUNCTION(, DNS_RESOLVER_RESULT, dns_resolver_get_result, DNS_RESOLVER_LOOKUP_HANDLE, lookup, const struct addrinfo**, addresses, int*, error);
+MOCKABLE_FUNCTION(, void, dns_resolver_release, DNS_RESOLVER_LOOKUP_HANDLE, lookup);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* DNS_RESOLVER_H */
@@ -16,6 +16,24 @@ extern "C"
 #include <stdlib.h>
 #endif
 
+/* callsites are only recorded for the translation units built with GB_PROFILE_ALLOC (and GB_DEBUG_ALLOC) */
+typedef enum GBALLOC_CALLSITE_SORT_TAG
+{
+    GBALLOC_CALLSITE_SORT_BY_LIVE_BYTES,
+    GBALLOC_CALLSITE_SORT_BY_PEAK_BYTES,
+    GBALLOC_CALLSITE_SORT_BY_ALLOCATION_COUNT
+} GBALLOC_CALLSITE_SORT;
+
+typedef struct GBALLOC_CALLSITE_STATS_TAG
+{
+    const char* file;
+    int line;
+    size_t liveBytes;
+    size_t peakBytes;
+    size_t liveAllocations;
+    size_t allocationCount;
+} GBALLOC_CALLSITE_STATS;
+
 // GB_USE_CUSTOM_HEAP disables the implementations in gballoc.c and
 // requires that an external library implement the gballoc_malloc family
 // declared here.
@@ -46,6 +64,16 @@ MOCKABLE_FUNCTION(, size_t, gballoc_getCurrentMemoryUsed);
 MOCKABLE_FUNCTION(, size_t, gballoc_getAllocationCount);
 MOCKABLE_FUNCTION(, void, gballoc_resetMetrics);
 
+/* same as the functions above, but the allocation is also accounted to the callsite file/line (file has to be a string with static storage, like __FILE__) */
+MOCKABLE_FUNCTION(, void*, gballoc_malloc_at, size_t, size, const char*, file, int, line);
+MOCKABLE_FUNCTION(, void*, gballoc_calloc_at, size_t, nmemb, size_t, size, const char*, file, int, line);
+MOCKABLE_FUNCTION(, void*, gballoc_realloc_at, void*, ptr, size_t, size, const char*, file, int, line);
+
+/* fills callsite_stats with (at most) the count callsites ranking highest by sort, returns how many were filled */
+MOCKABLE_FUNCTION(, size_t, gballoc_getTopCallsites, GBALLOC_CALLSITE_SORT, sort, GBALLOC_CALLSITE_STATS*, callsite_stats, size_t, count);
+/* logs (at most) the count callsites ranking highest by sort */
+MOCKABLE_FUNCTION(, void, gballoc_dumpTopCallsites, GBALLOC_CALLSITE_SORT, sort, size_t, count);
+
 /* if GB_MEASURE_MEMORY_FOR_THIS is defined then we want to redirect memory allocation functions to gballoc_xxx functions */
 #ifdef GB_MEASURE_MEMORY_FOR_THIS
 /* Unfortunately this is still needed here for things to still compile when using _CRTDBG_MAP_ALLOC.
@@ -59,6 +87,12 @@ That is because there is a rogue component (most likely CppUnitTest) including c
 #define _calloc_dbg(nmemb, size, ...) gballoc_calloc(nmemb, size)
 #define _realloc_dbg(ptr, size, ...) gballoc_realloc(ptr, size)
 #define _free_dbg(ptr, ...) gballoc_free(ptr)
+#elif defined(GB_PROFILE_ALLOC)
+/* free needs no callsite, the callsite is remembered with the allocation */
+#define malloc(size) gballoc_malloc_at(size, __FILE__, __LINE__)
+#define calloc(nmemb, size) gballoc_calloc_at(nmemb, size, __FILE__, __LINE__)
+#define realloc(ptr, size) gballoc_realloc_at(ptr, size, __FILE__, __LINE__)
+#define free gballoc_free
 #else
 #define malloc gballoc_malloc
 #define calloc gballoc_calloc
@@ -77,6 +111,9 @@ That is because there is a rogue component (most likely CppUnitTest) including c
 #define gballoc_getAllocationCount() SIZE_MAX
 #define gballoc_resetMetrics() ((void)0)
 
+#define gballoc_getTopCallsites(sort, callsites, count) 0
+#define gballoc_dumpTopCallsites(sort, count) ((void)0)
+
 #endif /* GB_DEBUG_ALLOC */
 
 #ifdef __cplusplus
@@ -55,6 +55,21 @@ typedef int (*MAP_FILTER_CALLBACK)(const char* mapProperty, const char* mapValue
  */
 MOCKABLE_FUNCTION(, MAP_HANDLE, Map_Create, MAP_FILTER_CALLBACK, mapFilterFunc);
 
+/**
+ * @brief   Creates a new, empty map whose keys are interned.
+ *
+ *          The keys are acquired from the string intern table instead of
+ *          being copied, so maps holding the same keys share their storage,
+ *          and a key given by its canonical copy is found by a pointer
+ *          compare. Suited to maps with a small, recurring set of keys such
+ *          as header names.
+ *
+ * @param   mapFilterFunc   Same as for ::Map_Create.
+ *
+ * @return  A valid @c MAP_HANDLE or @c NULL in case an error occurs.
+ */
+MOCKABLE_FUNCTION(, MAP_HANDLE, Map_CreateWithInternedKeys, MAP_FILTER_CALLBACK, mapFilterFunc);
+
 /**
  * @brief   Release all resources associated with the map.
  *
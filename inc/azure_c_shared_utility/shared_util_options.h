@@ -43,6 +43,19 @@ extern "C"
 
     static STATIC_VAR_UNUSED const char* const OPTION_NET_INT_MAC_ADDRESS = "net_interface_mac_address";
 
+    /* a SOCKETIO_EVENT_LOOP_HANDLE, the event loop that runs a socket IO from then on instead of socketio_dowork. It is set while the socket IO is closed,
+       before its first open, and the loop has to outlive the socket IO */
+    static STATIC_VAR_UNUSED const char* const OPTION_EVENT_LOOP = "event_loop";
+    /* the size of the reads of a socket IO, a size_t. With receive_batched it is the size the receive buffer starts at */
+    static STATIC_VAR_UNUSED const char* const OPTION_RECEIVE_BUFFER_SIZE = "receive_buffer_size";
+    /* a bool, when true a socket IO reads until the socket has no more bytes, growing its receive buffer, and indicates them with one on_bytes_received */
+    static STATIC_VAR_UNUSED const char* const OPTION_RECEIVE_BATCHED = "receive_batched";
+    /* an unsigned int, the milliseconds a socket IO waits for its connect to finish before the open fails, 0 waits until the connect itself fails */
+    static STATIC_VAR_UNUSED const char* const OPTION_CONNECT_TIMEOUT = "connect_timeout";
+    /* a const char*, the path of a Unix domain socket the next open of a socket IO connects to instead of its host name and port, which the layers
+       above keep using for TLS and HTTP. A path starting with '@' names a socket in the abstract namespace of Linux, an empty path clears the option */
+    static STATIC_VAR_UNUSED const char* const OPTION_UNIX_SOCKET_PATH = "unix_socket_path";
+
     static STATIC_VAR_UNUSED const char* const OPTION_TLS_VERSION = "tls_version";
 
     typedef enum TLSIO_VERSION_TAG
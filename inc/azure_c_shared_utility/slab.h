@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef SLAB_H
+#define SLAB_H
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C"
+{
+#else
+#include <stddef.h>
+#endif
+
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+/* a slab hands out objects of one fixed size carved from chunks of several objects. Freed objects are kept on a free list
+   and reused by the next slab_malloc, so a steady stream of allocations and frees does not reach the heap at all.
+   A chunk is released once none of its objects is in use, except for one empty chunk that the slab keeps. A slab is not thread-safe, it is meant to be owned by a single object
+   (a list, a connection) and used from whichever thread drives that object. */
+typedef struct SLAB_TAG* SLAB_HANDLE;
+
+/* objects_per_chunk 0 selects SLAB_DEFAULT_OBJECTS_PER_CHUNK */
+#define SLAB_DEFAULT_OBJECTS_PER_CHUNK 16
+
+MOCKABLE_FUNCTION(, SLAB_HANDLE, slab_create, size_t, object_size, size_t, objects_per_chunk);
+MOCKABLE_FUNCTION(, void, slab_destroy, SLAB_HANDLE, slab);
+MOCKABLE_FUNCTION(, void*, slab_malloc, SLAB_HANDLE, slab);
+MOCKABLE_FUNCTION(, void, slab_free, SLAB_HANDLE, slab, void*, ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SLAB_H */
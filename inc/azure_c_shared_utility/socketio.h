@@ -7,6 +7,8 @@
 #include "azure_c_shared_utility/xio.h"
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/umock_c_prod.h"
+#include "azure_c_shared_utility/arena.h"
+#include "azure_c_shared_utility/socketio_event_loop.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -22,13 +24,28 @@ typedef struct SOCKETIO_CONFIG_TAG
     void* accepted_socket;
 } SOCKETIO_CONFIG;
 
+/* with the event_loop option (OPTION_EVENT_LOOP) the socket is registered with the event loop while the socket IO is open, the loop then runs its
+   send and receive paths and socketio_dowork does nothing. While it connects, a timer of the loop checks the DNS lookup, fires the connect timeout
+   and starts the delayed connect attempts, socketio_dowork does not have to be called then either. The socket IO receives in the receive buffer of
+   the loop unless the receive_buffer_size option gives it its own. Only the Berkeley sockets and io_uring adapters support it, on Linux, the socket
+   IOs of the io_uring adapter share one ring per loop and have no receive_buffer_size option */
+
 #define RECEIVE_BYTES_VALUE     64
 
 MOCKABLE_FUNCTION(, CONCRETE_IO_HANDLE, socketio_create, void*, io_create_parameters);
+/* same as socketio_create, with the long lived allocations of the socket IO made in arena (which has to outlive the socket IO).
+   Only the Berkeley sockets and io_uring adapters implement it, xio_create_with_arena reaches it through the interface description */
+MOCKABLE_FUNCTION(, CONCRETE_IO_HANDLE, socketio_create_with_arena, void*, io_create_parameters, ARENA_HANDLE, arena);
 MOCKABLE_FUNCTION(, void, socketio_destroy, CONCRETE_IO_HANDLE, socket_io);
 MOCKABLE_FUNCTION(, int, socketio_open, CONCRETE_IO_HANDLE, socket_io, ON_IO_OPEN_COMPLETE, on_io_open_complete, void*, on_io_open_complete_context, ON_BYTES_RECEIVED, on_bytes_received, void*, on_bytes_received_context, ON_IO_ERROR, on_io_error, void*, on_io_error_context);
 MOCKABLE_FUNCTION(, int, socketio_close, CONCRETE_IO_HANDLE, socket_io, ON_IO_CLOSE_COMPLETE, on_io_close_complete, void*, callback_context);
 MOCKABLE_FUNCTION(, int, socketio_send, CONCRETE_IO_HANDLE, socket_io, const void*, buffer, size_t, size, ON_SEND_COMPLETE, on_send_complete, void*, callback_context);
+/* sends the buffers with one sendmsg, only the Berkeley sockets and io_uring adapters implement it */
+MOCKABLE_FUNCTION(, int, socketio_sendv, CONCRETE_IO_HANDLE, socket_io, const CONSTBUFFER*, buffers, size_t, buffer_count, ON_SEND_COMPLETE, on_send_complete, void*, callback_context);
+/* sends the content of constbuffer without copying it: what the socket cannot take at once is sent later from constbuffer, which the socket IO
+   keeps a reference to until then. A buffer owned by the caller is sent this way by wrapping it with CONSTBUFFER_CreateWithCustomFree.
+   Only the Berkeley sockets and io_uring adapters implement it */
+MOCKABLE_FUNCTION(, int, socketio_send_constbuffer, CONCRETE_IO_HANDLE, socket_io, CONSTBUFFER_HANDLE, constbuffer, ON_SEND_COMPLETE, on_send_complete, void*, callback_context);
 MOCKABLE_FUNCTION(, void, socketio_dowork, CONCRETE_IO_HANDLE, socket_io);
 MOCKABLE_FUNCTION(, int, socketio_setoption, CONCRETE_IO_HANDLE, socket_io, const char*, optionName, const void*, value);
 
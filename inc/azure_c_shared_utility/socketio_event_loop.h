@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef SOCKETIO_EVENT_LOOP_H
+#define SOCKETIO_EVENT_LOOP_H
+
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#include <cstddef>
+#else
+#include <stddef.h>
+#endif /* __cplusplus */
+
+/* an event loop waits on the sockets of many socket IOs at once and runs the receive and send paths of the ones that are ready,
+   so that one thread drives them without calling dowork on each of them. It is not thread-safe: it is run, and the socket IOs
+   registered with it are used, from one thread. */
+typedef struct SOCKETIO_EVENT_LOOP_TAG* SOCKETIO_EVENT_LOOP_HANDLE;
+typedef struct SOCKETIO_EVENT_LOOP_REGISTRATION_TAG* SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE;
+typedef struct SOCKETIO_EVENT_LOOP_TIMER_TAG* SOCKETIO_EVENT_LOOP_TIMER_HANDLE;
+
+#define SOCKETIO_EVENT_READABLE     0x01
+#define SOCKETIO_EVENT_WRITABLE     0x02
+/* reported whether it was asked for or not, when the socket has an error or was hung up */
+#define SOCKETIO_EVENT_ERROR        0x04
+
+typedef void(*ON_SOCKETIO_EVENT)(void* context, unsigned int events);
+typedef void(*ON_SOCKETIO_EVENT_LOOP_DESTROY)(void* context);
+typedef void(*ON_SOCKETIO_EVENT_LOOP_TIMER)(void* context);
+
+MOCKABLE_FUNCTION(, SOCKETIO_EVENT_LOOP_HANDLE, socketio_event_loop_create);
+MOCKABLE_FUNCTION(, void, socketio_event_loop_destroy, SOCKETIO_EVENT_LOOP_HANDLE, event_loop);
+MOCKABLE_FUNCTION(, int, socketio_event_loop_run_once, SOCKETIO_EVENT_LOOP_HANDLE, event_loop, int, timeout_ms);
+
+/* used by the socket IO adapters to have their sockets watched */
+MOCKABLE_FUNCTION(, SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE, socketio_event_loop_register, SOCKETIO_EVENT_LOOP_HANDLE, event_loop, int, socket, unsigned int, events, ON_SOCKETIO_EVENT, on_event, void*, on_event_context);
+MOCKABLE_FUNCTION(, int, socketio_event_loop_modify, SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE, registration, unsigned int, events);
+MOCKABLE_FUNCTION(, void, socketio_event_loop_unregister, SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE, registration);
+/* the receive buffer shared by the socket IOs of the loop, what a socket IO receives in it is only valid until the socket IO returns to the loop */
+MOCKABLE_FUNCTION(, unsigned char*, socketio_event_loop_get_receive_buffer, SOCKETIO_EVENT_LOOP_HANDLE, event_loop, size_t*, size);
+/* an object the socket IO adapter shares between the socket IOs of the loop, on_destroy is called with it when the loop is destroyed */
+MOCKABLE_FUNCTION(, int, socketio_event_loop_set_context, SOCKETIO_EVENT_LOOP_HANDLE, event_loop, void*, context, ON_SOCKETIO_EVENT_LOOP_DESTROY, on_destroy);
+MOCKABLE_FUNCTION(, void*, socketio_event_loop_get_context, SOCKETIO_EVENT_LOOP_HANDLE, event_loop);
+/* a timer calls on_timer once from the first run of the loop that finds it due after it was started, the loop does not wait past the earliest
+   started timer. The socket IOs use them for what has to happen while no socket is ready, like a connect timeout */
+MOCKABLE_FUNCTION(, SOCKETIO_EVENT_LOOP_TIMER_HANDLE, socketio_event_loop_create_timer, SOCKETIO_EVENT_LOOP_HANDLE, event_loop, ON_SOCKETIO_EVENT_LOOP_TIMER, on_timer, void*, on_timer_context);
+MOCKABLE_FUNCTION(, void, socketio_event_loop_destroy_timer, SOCKETIO_EVENT_LOOP_TIMER_HANDLE, timer);
+MOCKABLE_FUNCTION(, int, socketio_event_loop_start_timer, SOCKETIO_EVENT_LOOP_TIMER_HANDLE, timer, unsigned int, delay_ms);
+MOCKABLE_FUNCTION(, void, socketio_event_loop_stop_timer, SOCKETIO_EVENT_LOOP_TIMER_HANDLE, timer);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SOCKETIO_EVENT_LOOP_H */
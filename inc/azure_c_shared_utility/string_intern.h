@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef STRING_INTERN_H
+#define STRING_INTERN_H
+
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*the string intern table keeps one ref counted copy of each string acquired from it. Two interned strings are equal
+exactly when their pointers are equal. The table is process wide and thread safe*/
+
+/*returns the canonical copy of value, and a new reference to it. Every successful call has to be paired with a call to string_intern_release*/
+MOCKABLE_FUNCTION(, const char*, string_intern_acquire, const char*, value);
+
+/*returns the canonical copy of value if it is currently interned, NULL otherwise. No reference is taken, the pointer
+can only be compared with interned strings the caller holds*/
+MOCKABLE_FUNCTION(, const char*, string_intern_find, const char*, value);
+
+/*releases a reference obtained with string_intern_acquire*/
+MOCKABLE_FUNCTION(, void, string_intern_release, const char*, interned);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STRING_INTERN_H */
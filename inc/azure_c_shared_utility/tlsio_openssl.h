@@ -18,6 +18,8 @@ MOCKABLE_FUNCTION(, int, tlsio_openssl_init);
 MOCKABLE_FUNCTION(, void, tlsio_openssl_deinit);
 
 MOCKABLE_FUNCTION(, CONCRETE_IO_HANDLE, tlsio_openssl_create, void*, io_create_parameters);
+/* same as tlsio_openssl_create, with the long lived allocations of the TLS IO and of the socket IO under it made in arena (which has to outlive the TLS IO) */
+MOCKABLE_FUNCTION(, CONCRETE_IO_HANDLE, tlsio_openssl_create_with_arena, void*, io_create_parameters, ARENA_HANDLE, arena);
 MOCKABLE_FUNCTION(, void, tlsio_openssl_destroy, CONCRETE_IO_HANDLE, tls_io);
 MOCKABLE_FUNCTION(, int, tlsio_openssl_open, CONCRETE_IO_HANDLE, tls_io, ON_IO_OPEN_COMPLETE, on_io_open_complete, void*, on_io_open_complete_context, ON_BYTES_RECEIVED, on_bytes_received, void*, on_bytes_received_context, ON_IO_ERROR, on_io_error, void*, on_io_error_context);
 MOCKABLE_FUNCTION(, int, tlsio_openssl_close, CONCRETE_IO_HANDLE, tls_io, ON_IO_CLOSE_COMPLETE, on_io_close_complete, void*, callback_context);
@@ -27,6 +27,7 @@ MOCKABLE_FUNCTION(, int, VECTOR_push_back, VECTOR_HANDLE, handle, const void*, e
 
 /* removal */
 MOCKABLE_FUNCTION(, void, VECTOR_erase, VECTOR_HANDLE, handle, void*, elements, size_t, numElements);
+MOCKABLE_FUNCTION(, void, VECTOR_erase_unordered, VECTOR_HANDLE, handle, void*, element);
 MOCKABLE_FUNCTION(, void, VECTOR_clear, VECTOR_HANDLE, handle);
 
 /* access */
@@ -35,8 +36,15 @@ MOCKABLE_FUNCTION(, void*, VECTOR_front, VECTOR_HANDLE, handle);
 MOCKABLE_FUNCTION(, void*, VECTOR_back, VECTOR_HANDLE, handle);
 MOCKABLE_FUNCTION(, void*, VECTOR_find_if, VECTOR_HANDLE, handle, PREDICATE_FUNCTION, pred, const void*, value);
 
+/* ordering */
+MOCKABLE_FUNCTION(, void, VECTOR_sort, VECTOR_HANDLE, handle, COMPARE_FUNCTION, compare);
+MOCKABLE_FUNCTION(, void*, VECTOR_lower_bound, VECTOR_HANDLE, handle, COMPARE_FUNCTION, compare, const void*, value);
+
 /* capacity */
 MOCKABLE_FUNCTION(, size_t, VECTOR_size, VECTOR_HANDLE, handle);
+MOCKABLE_FUNCTION(, size_t, VECTOR_capacity, VECTOR_HANDLE, handle);
+MOCKABLE_FUNCTION(, int, VECTOR_reserve, VECTOR_HANDLE, handle, size_t, numElements);
+MOCKABLE_FUNCTION(, int, VECTOR_shrink_to_fit, VECTOR_HANDLE, handle);
 
 #ifdef __cplusplus
 }
@@ -14,6 +14,7 @@ extern "C"
 typedef struct VECTOR_TAG* VECTOR_HANDLE;
 
 typedef bool(*PREDICATE_FUNCTION)(const void* element, const void* value);
+typedef int(*COMPARE_FUNCTION)(const void* element1, const void* element2);
 
 #ifdef __cplusplus
 }
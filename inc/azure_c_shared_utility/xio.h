@@ -5,6 +5,8 @@
 #define XIO_H
 
 #include "azure_c_shared_utility/optionhandler.h"
+#include "azure_c_shared_utility/constbuffer_types.h"
+#include "azure_c_shared_utility/arena.h"
 
 #include "azure_c_shared_utility/umock_c_prod.h"
 #include "azure_c_shared_utility/macro_utils.h"
@@ -46,10 +48,12 @@ typedef void(*ON_IO_ERROR)(void* context);
 
 typedef OPTIONHANDLER_HANDLE (*IO_RETRIEVEOPTIONS)(CONCRETE_IO_HANDLE concrete_io);
 typedef CONCRETE_IO_HANDLE(*IO_CREATE)(void* io_create_parameters);
+typedef CONCRETE_IO_HANDLE(*IO_CREATE_WITH_ARENA)(void* io_create_parameters, ARENA_HANDLE arena);
 typedef void(*IO_DESTROY)(CONCRETE_IO_HANDLE concrete_io);
 typedef int(*IO_OPEN)(CONCRETE_IO_HANDLE concrete_io, ON_IO_OPEN_COMPLETE on_io_open_complete, void* on_io_open_complete_context, ON_BYTES_RECEIVED on_bytes_received, void* on_bytes_received_context, ON_IO_ERROR on_io_error, void* on_io_error_context);
 typedef int(*IO_CLOSE)(CONCRETE_IO_HANDLE concrete_io, ON_IO_CLOSE_COMPLETE on_io_close_complete, void* callback_context);
 typedef int(*IO_SEND)(CONCRETE_IO_HANDLE concrete_io, const void* buffer, size_t size, ON_SEND_COMPLETE on_send_complete, void* callback_context);
+typedef int(*IO_SENDV)(CONCRETE_IO_HANDLE concrete_io, const CONSTBUFFER* buffers, size_t buffer_count, ON_SEND_COMPLETE on_send_complete, void* callback_context);
 typedef void(*IO_DOWORK)(CONCRETE_IO_HANDLE concrete_io);
 typedef int(*IO_SETOPTION)(CONCRETE_IO_HANDLE concrete_io, const char* optionName, const void* value);
 
@@ -64,13 +68,20 @@ typedef struct IO_INTERFACE_DESCRIPTION_TAG
     IO_SEND concrete_io_send;
     IO_DOWORK concrete_io_dowork;
     IO_SETOPTION concrete_io_setoption;
+    /* optional, creates the concrete IO with its long lived allocations in an arena; when NULL, xio_create_with_arena calls concrete_io_create */
+    IO_CREATE_WITH_ARENA concrete_io_create_with_arena;
+    /* optional, sends several buffers as one send; when NULL, xio_sendv gathers the buffers and calls concrete_io_send */
+    IO_SENDV concrete_io_sendv;
 } IO_INTERFACE_DESCRIPTION;
 
 MOCKABLE_FUNCTION(, XIO_HANDLE, xio_create, const IO_INTERFACE_DESCRIPTION*, io_interface_description, const void*, io_create_parameters);
+/* same as xio_create, with the long lived allocations of the concrete IO made in arena (which has to outlive the IO) when the concrete IO supports it */
+MOCKABLE_FUNCTION(, XIO_HANDLE, xio_create_with_arena, const IO_INTERFACE_DESCRIPTION*, io_interface_description, const void*, io_create_parameters, ARENA_HANDLE, arena);
 MOCKABLE_FUNCTION(, void, xio_destroy, XIO_HANDLE, xio);
 MOCKABLE_FUNCTION(, int, xio_open, XIO_HANDLE, xio, ON_IO_OPEN_COMPLETE, on_io_open_complete, void*, on_io_open_complete_context, ON_BYTES_RECEIVED, on_bytes_received, void*, on_bytes_received_context, ON_IO_ERROR, on_io_error, void*, on_io_error_context);
 MOCKABLE_FUNCTION(, int, xio_close, XIO_HANDLE, xio, ON_IO_CLOSE_COMPLETE, on_io_close_complete, void*, callback_context);
 MOCKABLE_FUNCTION(, int, xio_send, XIO_HANDLE, xio, const void*, buffer, size_t, size, ON_SEND_COMPLETE, on_send_complete, void*, callback_context);
+MOCKABLE_FUNCTION(, int, xio_sendv, XIO_HANDLE, xio, const CONSTBUFFER*, buffers, size_t, buffer_count, ON_SEND_COMPLETE, on_send_complete, void*, callback_context);
 MOCKABLE_FUNCTION(, void, xio_dowork, XIO_HANDLE, xio);
 MOCKABLE_FUNCTION(, int, xio_setoption, XIO_HANDLE, xio, const char*, optionName, const void*, value);
 MOCKABLE_FUNCTION(, OPTIONHANDLER_HANDLE, xio_retrieveoptions, XIO_HANDLE, xio);
@@ -14,6 +14,9 @@
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/crt_abstractions.h"
 #include "azure_c_shared_utility/xlogging.h"
+#ifdef DNS_ASYNC_USE_DNS_RESOLVER
+#include "azure_c_shared_utility/dns_resolver.h"
+#endif
 
 // EXTRACT_IPV4 pulls the uint32_t IPv4 address out of an addrinfo struct
 // This will not be needed for the asynchronous design
@@ -30,8 +33,25 @@ typedef struct
     uint32_t ip_v4;
     bool is_complete;
     bool is_failed;
+#ifdef DNS_ASYNC_USE_DNS_RESOLVER
+    /* NULL when the application did not initialize the resolver, the lookup is then made by dns_async_is_lookup_complete */
+    DNS_RESOLVER_LOOKUP_HANDLE lookup;
+#endif
 } DNS_ASYNC_INSTANCE;
 
+#ifdef DNS_ASYNC_USE_DNS_RESOLVER
+// The resolver asks for the addresses of every family, the first IPv4 one is used
+static uint32_t get_first_ipv4(const struct addrinfo* addrInfo)
+{
+    while ((addrInfo != NULL) && (addrInfo->ai_family != AF_INET))
+    {
+        addrInfo = addrInfo->ai_next;
+    }
+
+    return (addrInfo == NULL) ? 0 : EXTRACT_IPV4(addrInfo);
+}
+#endif
+
 DNS_ASYNC_HANDLE dns_async_create(const char* hostname, DNS_ASYNC_OPTIONS* options)
 {
     /* Codes_SRS_DNS_ASYNC_30_012: [ The optional options parameter shall be ignored. ]*/
@@ -66,6 +86,13 @@ DNS_ASYNC_HANDLE dns_async_create(const char* hostname, DNS_ASYNC_OPTIONS* optio
                 free(result);
                 result = NULL;
             }
+#ifdef DNS_ASYNC_USE_DNS_RESOLVER
+            else
+            {
+                /* Codes_SRS_DNS_ASYNC_03_015: [ When built with DNS_ASYNC_USE_DNS_RESOLVER, dns_async_create shall start the lookup of hostname with dns_resolver_lookup. ]*/
+                result->lookup = dns_resolver_lookup(hostname);
+            }
+#endif
         }
     }
     return result;
@@ -90,6 +117,40 @@ bool dns_async_is_lookup_complete(DNS_ASYNC_HANDLE dns_in)
             /* Codes_SRS_DNS_ASYNC_30_024: [ If dns_async_is_create_complete has previously returned true, dns_async_is_create_complete shall do nothing and return true. ]*/
             result = true;
         }
+#ifdef DNS_ASYNC_USE_DNS_RESOLVER
+        else if (dns->lookup != NULL)
+        {
+            const struct addrinfo* addresses = NULL;
+            int error = 0;
+            DNS_RESOLVER_RESULT lookup_result = dns_resolver_get_result(dns->lookup, &addresses, &error);
+
+            if (lookup_result == DNS_RESOLVER_PENDING)
+            {
+                /* Codes_SRS_DNS_ASYNC_30_023: [ If the DNS lookup process is not yet complete, dns_async_is_create_complete shall return false. ]*/
+                result = false;
+            }
+            else
+            {
+                if (lookup_result == DNS_RESOLVER_OK)
+                {
+                    dns->ip_v4 = get_first_ipv4(addresses);
+                }
+                else
+                {
+                    LogInfo("Failed DNS lookup for %s: %d", dns->hostname, error);
+                }
+
+                /* Codes_SRS_DNS_ASYNC_30_033: [ If dns_async_is_create_complete has returned true and the lookup process has failed, dns_async_get_ipv4 shall return 0. ]*/
+                dns->is_failed = (dns->ip_v4 == 0);
+                dns->is_complete = true;
+                /* the address is copied, the resolver keeps the addresses cached for the next lookups */
+                dns_resolver_release(dns->lookup);
+                dns->lookup = NULL;
+                /* Codes_SRS_DNS_ASYNC_30_022: [ If the DNS lookup process has completed, dns_async_is_create_complete shall return true. ]*/
+                result = true;
+            }
+        }
+#endif
         else
         {
             struct addrinfo *addrInfo = NULL;
@@ -160,6 +221,12 @@ void dns_async_destroy(DNS_ASYNC_HANDLE dns_in)
     else
     {
         /* Codes_SRS_DNS_ASYNC_30_051: [ dns_async_destroy shall delete all acquired resources and delete the DNS_ASYNC_HANDLE. ]*/
+#ifdef DNS_ASYNC_USE_DNS_RESOLVER
+        if (dns->lookup != NULL)
+        {
+            dns_resolver_release(dns->lookup);
+        }
+#endif
         free(dns->hostname);
         free(dns);
     }
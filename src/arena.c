@@ -0,0 +1,242 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/arena.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+/* every pointer handed out is aligned for the most demanding of these types */
+typedef union ARENA_ALIGN_TAG
+{
+    void* pointer;
+    void (*function)(void);
+    long long integer;
+    long double floating;
+} ARENA_ALIGN;
+
+#define ARENA_ALIGNMENT sizeof(ARENA_ALIGN)
+#define ARENA_ROUND_UP(size) ((((size) + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT) * ARENA_ALIGNMENT)
+
+typedef struct ARENA_BLOCK_TAG
+{
+    struct ARENA_BLOCK_TAG* next;
+    size_t size;
+    size_t used;
+} ARENA_BLOCK;
+
+typedef struct ARENA_TAG
+{
+    /* the block allocations are served from is always the head, blocks made for a single large allocation are kept behind it */
+    ARENA_BLOCK* blocks;
+    size_t block_size;
+    size_t allocated_size;
+} ARENA;
+
+/* the arena and its first block are a single allocation */
+#define ARENA_HEADER_SIZE ARENA_ROUND_UP(sizeof(ARENA))
+#define ARENA_BLOCK_HEADER_SIZE ARENA_ROUND_UP(sizeof(ARENA_BLOCK))
+
+static unsigned char* get_block_data(ARENA_BLOCK* block)
+{
+    return (unsigned char*)block + ARENA_BLOCK_HEADER_SIZE;
+}
+
+static ARENA_BLOCK* get_first_block(ARENA* arena)
+{
+    return (ARENA_BLOCK*)((unsigned char*)arena + ARENA_HEADER_SIZE);
+}
+
+static ARENA_BLOCK* create_block(size_t size)
+{
+    ARENA_BLOCK* result;
+
+    if (size > SIZE_MAX - ARENA_BLOCK_HEADER_SIZE)
+    {
+        LogError("Block size %lu is too large", (unsigned long)size);
+        result = NULL;
+    }
+    else if ((result = (ARENA_BLOCK*)malloc(ARENA_BLOCK_HEADER_SIZE + size)) == NULL)
+    {
+        LogError("Cannot allocate arena block of %lu bytes", (unsigned long)size);
+    }
+    else
+    {
+        result->next = NULL;
+        result->size = size;
+        result->used = 0;
+    }
+
+    return result;
+}
+
+ARENA_HANDLE arena_create(size_t block_size)
+{
+    ARENA* result;
+
+    /* Codes_SRS_ARENA_03_001: [ If block_size is 0, arena_create shall use ARENA_DEFAULT_BLOCK_SIZE. ]*/
+    if (block_size == 0)
+    {
+        block_size = ARENA_DEFAULT_BLOCK_SIZE;
+    }
+
+    block_size = ARENA_ROUND_UP(block_size);
+
+    if ((block_size == 0) || (block_size > SIZE_MAX - ARENA_HEADER_SIZE - ARENA_BLOCK_HEADER_SIZE))
+    {
+        /* Codes_SRS_ARENA_03_003: [ If any error occurs, arena_create shall fail and return NULL. ]*/
+        LogError("Invalid block size");
+        result = NULL;
+    }
+    /* Codes_SRS_ARENA_03_002: [ arena_create shall allocate the arena together with its first block of block_size bytes in a single allocation and return a non-NULL handle. ]*/
+    else if ((result = (ARENA*)malloc(ARENA_HEADER_SIZE + ARENA_BLOCK_HEADER_SIZE + block_size)) == NULL)
+    {
+        /* Codes_SRS_ARENA_03_003: [ If any error occurs, arena_create shall fail and return NULL. ]*/
+        LogError("Cannot allocate arena");
+    }
+    else
+    {
+        result->blocks = get_first_block(result);
+        result->blocks->next = NULL;
+        result->blocks->size = block_size;
+        result->blocks->used = 0;
+        result->block_size = block_size;
+        result->allocated_size = 0;
+    }
+
+    return result;
+}
+
+void arena_destroy(ARENA_HANDLE arena)
+{
+    if (arena == NULL)
+    {
+        /* Codes_SRS_ARENA_03_004: [ If arena is NULL, arena_destroy shall return. ]*/
+        LogError("Invalid argument: ARENA_HANDLE arena=%p", arena);
+    }
+    else
+    {
+        ARENA_BLOCK* first_block = get_first_block(arena);
+        ARENA_BLOCK* block = arena->blocks;
+
+        /* Codes_SRS_ARENA_03_005: [ arena_destroy shall free all the blocks of the arena and the arena itself. ]*/
+        while (block != NULL)
+        {
+            ARENA_BLOCK* next = block->next;
+            if (block != first_block)
+            {
+                free(block);
+            }
+            block = next;
+        }
+
+        free(arena);
+    }
+}
+
+void* arena_malloc(ARENA_HANDLE arena, size_t size)
+{
+    void* result;
+
+    if ((arena == NULL) || (size == 0))
+    {
+        /* Codes_SRS_ARENA_03_006: [ If arena is NULL or size is 0, arena_malloc shall fail and return NULL. ]*/
+        LogError("Invalid arguments: ARENA_HANDLE arena=%p, size_t size=%lu", arena, (unsigned long)size);
+        result = NULL;
+    }
+    else if (size > SIZE_MAX - ARENA_ALIGNMENT)
+    {
+        LogError("Size %lu is too large", (unsigned long)size);
+        result = NULL;
+    }
+    else
+    {
+        size_t aligned_size = ARENA_ROUND_UP(size);
+        ARENA_BLOCK* block = arena->blocks;
+
+        if (block->size - block->used < aligned_size)
+        {
+            if (aligned_size > arena->block_size / 2)
+            {
+                /* Codes_SRS_ARENA_03_009: [ If size is larger than half of the block size, arena_malloc shall serve it from a block of its own, keeping the current block for the following allocations. ]*/
+                if ((block = create_block(aligned_size)) != NULL)
+                {
+                    block->next = arena->blocks->next;
+                    arena->blocks->next = block;
+                }
+            }
+            /* Codes_SRS_ARENA_03_008: [ If the current block does not have size bytes left, arena_malloc shall allocate a new block of the arena block size and continue from it. ]*/
+            else if ((block = create_block(arena->block_size)) != NULL)
+            {
+                block->next = arena->blocks;
+                arena->blocks = block;
+            }
+        }
+
+        if (block == NULL)
+        {
+            /* Codes_SRS_ARENA_03_010: [ If allocating a new block fails, arena_malloc shall fail and return NULL. ]*/
+            result = NULL;
+        }
+        else
+        {
+            /* Codes_SRS_ARENA_03_007: [ arena_malloc shall return the next size bytes of the current block, aligned for any type. ]*/
+            result = get_block_data(block) + block->used;
+            block->used += aligned_size;
+            arena->allocated_size += aligned_size;
+        }
+    }
+
+    return result;
+}
+
+char* arena_copy_string(ARENA_HANDLE arena, const char* source)
+{
+    char* result;
+
+    if ((arena == NULL) || (source == NULL))
+    {
+        /* Codes_SRS_ARENA_03_011: [ If arena or source is NULL, arena_copy_string shall fail and return NULL. ]*/
+        LogError("Invalid arguments: ARENA_HANDLE arena=%p, const char* source=%p", arena, source);
+        result = NULL;
+    }
+    else
+    {
+        size_t length = strlen(source);
+
+        /* Codes_SRS_ARENA_03_012: [ arena_copy_string shall copy source, including its terminating zero, to memory obtained with arena_malloc and return it. ]*/
+        if ((result = (char*)arena_malloc(arena, length + 1)) == NULL)
+        {
+            /* Codes_SRS_ARENA_03_013: [ If arena_malloc fails, arena_copy_string shall fail and return NULL. ]*/
+            LogError("Cannot copy string to arena");
+        }
+        else
+        {
+            (void)memcpy(result, source, length + 1);
+        }
+    }
+
+    return result;
+}
+
+size_t arena_get_allocated_size(ARENA_HANDLE arena)
+{
+    size_t result;
+
+    if (arena == NULL)
+    {
+        /* Codes_SRS_ARENA_03_014: [ If arena is NULL, arena_get_allocated_size shall return 0. ]*/
+        LogError("Invalid argument: ARENA_HANDLE arena=%p", arena);
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_ARENA_03_015: [ arena_get_allocated_size shall return the number of bytes handed out by arena_malloc, including the alignment padding. ]*/
+        result = arena->allocated_size;
+    }
+
+    return result;
+}
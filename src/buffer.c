@@ -5,6 +5,7 @@
 #include <stddef.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/buffer_.h"
 #include "azure_c_shared_utility/optimize_size.h"
@@ -14,6 +15,8 @@ typedef struct BUFFER_TAG
 {
     unsigned char* buffer;
     size_t size;
+    /* number of bytes allocated for buffer, appends grow it geometrically so that size can be smaller */
+    size_t capacity;
 } BUFFER;
 
 /* Codes_SRS_BUFFER_07_001: [BUFFER_new shall allocate a BUFFER_HANDLE that will contain a NULL unsigned char*.] */
@@ -25,6 +28,7 @@ BUFFER_HANDLE BUFFER_new(void)
     {
         temp->buffer = NULL;
         temp->size = 0;
+        temp->capacity = 0;
     }
     return (BUFFER_HANDLE)temp;
 }
@@ -48,11 +52,45 @@ static int BUFFER_safemalloc(BUFFER* handleptr, size_t size)
     {
         // we still consider the real buffer size is 0
         handleptr->size = size;
+        handleptr->capacity = sizetomalloc;
         result = 0;
     }
     return result;
 }
 
+/* makes room for at least needed bytes, growing the capacity geometrically so that a series of appends costs amortized O(1) reallocs */
+static int BUFFER_grow(BUFFER* handleptr, size_t needed)
+{
+    int result;
+    if (needed <= handleptr->capacity)
+    {
+        result = 0;
+    }
+    else
+    {
+        size_t new_capacity = (handleptr->capacity > SIZE_MAX / 2) ? needed : handleptr->capacity * 2;
+        unsigned char* temp;
+        if (new_capacity < needed)
+        {
+            new_capacity = needed;
+        }
+
+        temp = (unsigned char*)realloc(handleptr->buffer, new_capacity);
+        if (temp == NULL)
+        {
+            LogError("Failure reallocating buffer to %lu bytes", (unsigned long)new_capacity);
+            result = __FAILURE__;
+        }
+        else
+        {
+            handleptr->buffer = temp;
+            handleptr->capacity = new_capacity;
+            result = 0;
+        }
+    }
+    return result;
+}
+
 BUFFER_HANDLE BUFFER_create(const unsigned char* source, size_t size)
 {
     BUFFER* result;
@@ -126,6 +164,7 @@ int BUFFER_build(BUFFER_HANDLE handle, const unsigned char* source, size_t size)
         free(b->buffer);
         b->buffer = NULL;
         b->size = 0;
+        b->capacity = 0;
 
         result = 0;
     }
@@ -151,6 +190,7 @@ int BUFFER_build(BUFFER_HANDLE handle, const unsigned char* source, size_t size)
             {
                 b->buffer = newBuffer;
                 b->size = size;
+                b->capacity = size;
                 /* Codes_SRS_BUFFER_01_002: [The size argument can be zero, in which case nothing shall be copied from source.] */
                 (void)memcpy(b->buffer, source, size);
 
@@ -195,9 +235,16 @@ int BUFFER_append_build(BUFFER_HANDLE handle, const unsigned char* source, size_
         }
         else
         {
+            if (size > SIZE_MAX - handle->size)
+            {
+                /* Codes_SRS_BUFFER_07_035: [ If any error is encountered BUFFER_append_build shall return a non-null value. ] */
+                LogError("Buffer size overflows: size=%lu, appended size=%lu", (unsigned long)handle->size, (unsigned long)size);
+                result = __FAILURE__;
+            }
             /* Codes_SRS_BUFFER_07_032: [ if handle->buffer is not NULL BUFFER_append_build shall realloc the buffer to be the handle->size + size ] */
-            unsigned char* temp = (unsigned char*)realloc(handle->buffer, handle->size + size);
-            if (temp == NULL)
+            /* Codes_SRS_BUFFER_03_001: [ If the capacity of the buffer is smaller than the new size, the buffer shall be reallocated to the larger of the new size and twice the capacity. ] */
+            /* Codes_SRS_BUFFER_03_002: [ If the capacity of the buffer is enough for the new size, no memory shall be allocated. ] */
+            else if (BUFFER_grow(handle, handle->size + size) != 0)
             {
                 /* Codes_SRS_BUFFER_07_035: [ If any error is encountered BUFFER_append_build shall return a non-null value. ] */
                 LogError("Failure reallocating temporary buffer");
@@ -206,7 +253,6 @@ int BUFFER_append_build(BUFFER_HANDLE handle, const unsigned char* source, size_
             else
             {
                 /* Codes_SRS_BUFFER_07_033: [ ... and copy the contents of source to the end of the buffer. ] */
-                handle->buffer = temp;
                 // Append the BUFFER
                 (void)memcpy(&handle->buffer[handle->size], source, size);
                 handle->size += size;
@@ -254,6 +300,7 @@ int BUFFER_pre_build(BUFFER_HANDLE handle, size_t size)
             else
             {
                 b->size = size;
+                b->capacity = size;
                 result = 0;
             }
         }
@@ -298,6 +345,7 @@ extern int BUFFER_unbuild(BUFFER_HANDLE handle)
             free(b->buffer);
             b->buffer = NULL;
             b->size = 0;
+            b->capacity = 0;
             result = 0;
         }
         else
@@ -328,8 +376,15 @@ int BUFFER_enlarge(BUFFER_HANDLE handle, size_t enlargeSize)
     else
     {
         BUFFER* b = (BUFFER*)handle;
-        unsigned char* temp = (unsigned char*)realloc(b->buffer, b->size + enlargeSize);
-        if (temp == NULL)
+        if (enlargeSize > SIZE_MAX - b->size)
+        {
+            /* Codes_SRS_BUFFER_07_018: [BUFFER_enlarge shall return a nonzero result if any error is encountered.] */
+            LogError("Failure: enlargeSize overflows the buffer size.");
+            result = __FAILURE__;
+        }
+        /* Codes_SRS_BUFFER_03_001: [ If the capacity of the buffer is smaller than the new size, the buffer shall be reallocated to the larger of the new size and twice the capacity. ] */
+        /* Codes_SRS_BUFFER_03_002: [ If the capacity of the buffer is enough for the new size, no memory shall be allocated. ] */
+        else if (BUFFER_grow(b, b->size + enlargeSize) != 0)
         {
             /* Codes_SRS_BUFFER_07_018: [BUFFER_enlarge shall return a nonzero result if any error is encountered.] */
             LogError("Failure: allocating temp buffer.");
@@ -337,7 +392,6 @@ int BUFFER_enlarge(BUFFER_HANDLE handle, size_t enlargeSize)
         }
         else
         {
-            b->buffer = temp;
             b->size += enlargeSize;
             result = 0;
         }
@@ -376,6 +430,7 @@ int BUFFER_shrink(BUFFER_HANDLE handle, size_t decreaseSize, bool fromEnd)
             free(handle->buffer);
             handle->buffer = NULL;
             handle->size = 0;
+            handle->capacity = 0;
             result = 0;
         }
         else
@@ -396,6 +451,7 @@ int BUFFER_shrink(BUFFER_HANDLE handle, size_t decreaseSize, bool fromEnd)
                     free(handle->buffer);
                     handle->buffer = tmp;
                     handle->size = alloc_size;
+                    handle->capacity = alloc_size;
                     result = 0;
                 }
                 else
@@ -405,6 +461,7 @@ int BUFFER_shrink(BUFFER_HANDLE handle, size_t decreaseSize, bool fromEnd)
                     free(handle->buffer);
                     handle->buffer = tmp;
                     handle->size = alloc_size;
+                    handle->capacity = alloc_size;
                     result = 0;
                 }
             }
@@ -464,8 +521,15 @@ int BUFFER_append(BUFFER_HANDLE handle1, BUFFER_HANDLE handle2)
             else
             {
                 // b2->size != 0, whatever b1->size is
-                unsigned char* temp = (unsigned char*)realloc(b1->buffer, b1->size + b2->size);
-                if (temp == NULL)
+                if (b2->size > SIZE_MAX - b1->size)
+                {
+                    /* Codes_SRS_BUFFER_07_023: [BUFFER_append shall return a nonzero upon any error that is encountered.] */
+                    LogError("Failure: appended size overflows the buffer size.");
+                    result = __FAILURE__;
+                }
+                /* Codes_SRS_BUFFER_03_001: [ If the capacity of the buffer is smaller than the new size, the buffer shall be reallocated to the larger of the new size and twice the capacity. ] */
+                /* Codes_SRS_BUFFER_03_002: [ If the capacity of the buffer is enough for the new size, no memory shall be allocated. ] */
+                else if (BUFFER_grow(b1, b1->size + b2->size) != 0)
                 {
                     /* Codes_SRS_BUFFER_07_023: [BUFFER_append shall return a nonzero upon any error that is encountered.] */
                     LogError("Failure: allocating temp buffer.");
@@ -474,7 +538,6 @@ int BUFFER_append(BUFFER_HANDLE handle1, BUFFER_HANDLE handle2)
                 else
                 {
                     /* Codes_SRS_BUFFER_07_024: [BUFFER_append concatenates b2 onto b1 without modifying b2 and shall return zero on success.]*/
-                    b1->buffer = temp;
                     // Append the BUFFER
                     (void)memcpy(&b1->buffer[b1->size], b2->buffer, b2->size);
                     b1->size += b2->size;
@@ -543,6 +606,7 @@ int BUFFER_prepend(BUFFER_HANDLE handle1, BUFFER_HANDLE handle2)
                     free(b1->buffer);
                     b1->buffer = temp;
                     b1->size += b2->size;
+                    b1->capacity = b1->size + 1;
                     result = 0;
                 }
             }
@@ -642,3 +706,99 @@ BUFFER_HANDLE BUFFER_clone(BUFFER_HANDLE handle)
     }
     return result;
 }
+
+int BUFFER_reserve(BUFFER_HANDLE handle, size_t capacity)
+{
+    int result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_BUFFER_03_003: [ If handle is NULL, BUFFER_reserve shall fail and return a non-zero value. ] */
+        LogError("Invalid argument: BUFFER_HANDLE handle=%p", handle);
+        result = __FAILURE__;
+    }
+    else
+    {
+        BUFFER* b = (BUFFER*)handle;
+        if (capacity <= b->capacity)
+        {
+            /* Codes_SRS_BUFFER_03_004: [ If the capacity of the buffer is already at least capacity, BUFFER_reserve shall succeed without allocating memory. ] */
+            result = 0;
+        }
+        else
+        {
+            /* Codes_SRS_BUFFER_03_005: [ Otherwise BUFFER_reserve shall reallocate the buffer to exactly capacity bytes, keeping its content and its length. ] */
+            unsigned char* temp = (unsigned char*)realloc(b->buffer, capacity);
+            if (temp == NULL)
+            {
+                /* Codes_SRS_BUFFER_03_006: [ If reallocating fails, BUFFER_reserve shall fail, leave the buffer unchanged and return a non-zero value. ] */
+                LogError("Failure reallocating buffer to %lu bytes", (unsigned long)capacity);
+                result = __FAILURE__;
+            }
+            else
+            {
+                b->buffer = temp;
+                b->capacity = capacity;
+                /* Codes_SRS_BUFFER_03_007: [ On success BUFFER_reserve shall return 0. ] */
+                result = 0;
+            }
+        }
+    }
+    return result;
+}
+
+int BUFFER_shrink_to_fit(BUFFER_HANDLE handle)
+{
+    int result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_BUFFER_03_008: [ If handle is NULL, BUFFER_shrink_to_fit shall fail and return a non-zero value. ] */
+        LogError("Invalid argument: BUFFER_HANDLE handle=%p", handle);
+        result = __FAILURE__;
+    }
+    else
+    {
+        BUFFER* b = (BUFFER*)handle;
+        /* an allocated buffer keeps at least 1 byte, like BUFFER_create does for size 0 */
+        size_t target = (b->size == 0) ? 1 : b->size;
+        if ((b->buffer == NULL) || (b->capacity <= target))
+        {
+            /* Codes_SRS_BUFFER_03_009: [ If the buffer has no unused capacity, BUFFER_shrink_to_fit shall succeed without allocating memory. ] */
+            result = 0;
+        }
+        else
+        {
+            /* Codes_SRS_BUFFER_03_010: [ Otherwise BUFFER_shrink_to_fit shall reallocate the buffer to its length (1 byte if the length is 0), keeping its content. ] */
+            unsigned char* temp = (unsigned char*)realloc(b->buffer, target);
+            if (temp == NULL)
+            {
+                /* Codes_SRS_BUFFER_03_011: [ If reallocating fails, BUFFER_shrink_to_fit shall fail, leave the buffer unchanged and return a non-zero value. ] */
+                LogError("Failure reallocating buffer to %lu bytes", (unsigned long)target);
+                result = __FAILURE__;
+            }
+            else
+            {
+                b->buffer = temp;
+                b->capacity = target;
+                /* Codes_SRS_BUFFER_03_012: [ On success BUFFER_shrink_to_fit shall return 0. ] */
+                result = 0;
+            }
+        }
+    }
+    return result;
+}
+
+size_t BUFFER_capacity(BUFFER_HANDLE handle)
+{
+    size_t result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_BUFFER_03_013: [ If handle is NULL, BUFFER_capacity shall return 0. ] */
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_BUFFER_03_014: [ BUFFER_capacity shall return the number of bytes the buffer can hold without reallocating. ] */
+        result = ((BUFFER*)handle)->capacity;
+    }
+    return result;
+}
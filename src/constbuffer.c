@@ -6,14 +6,31 @@
 //
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdint.h>
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/constbuffer.h"
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/refcount.h"
 
+typedef enum CONSTBUFFER_TYPE_TAG
+{
+    /*the bytes are a copy stored right after the handle, in the same allocation*/
+    CONSTBUFFER_TYPE_COPIED,
+    /*the bytes were handed over by the caller and are released with free*/
+    CONSTBUFFER_TYPE_MEMORY_MOVED,
+    /*the bytes belong to someone else and are released by calling customFreeFunc*/
+    CONSTBUFFER_TYPE_WITH_CUSTOM_FREE,
+    /*the bytes are a window into the bytes of originalHandle, which is released when the handle is destroyed*/
+    CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE
+}CONSTBUFFER_TYPE;
+
 typedef struct CONSTBUFFER_HANDLE_DATA_TAG
 {
     CONSTBUFFER alias;
+    CONSTBUFFER_TYPE bufferType;
+    CONSTBUFFER_CUSTOM_FREE_FUNC customFreeFunc;
+    void* customFreeFuncContext;
+    CONSTBUFFER_HANDLE originalHandle;
 }CONSTBUFFER_HANDLE_DATA;
 
 DEFINE_REFCOUNT_TYPE(CONSTBUFFER_HANDLE_DATA);
@@ -21,18 +38,33 @@ DEFINE_REFCOUNT_TYPE(CONSTBUFFER_HANDLE_DATA);
 static CONSTBUFFER_HANDLE CONSTBUFFER_Create_Internal(const unsigned char* source, size_t size)
 {
     CONSTBUFFER_HANDLE_DATA* result;
-    /*Codes_SRS_CONSTBUFFER_02_005: [The non-NULL handle returned by CONSTBUFFER_Create shall have its ref count set to "1".]*/
-    /*Codes_SRS_CONSTBUFFER_02_010: [The non-NULL handle returned by CONSTBUFFER_CreateFromBuffer shall have its ref count set to "1".]*/
-    result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_HANDLE_DATA);
-    if (result == NULL)
+    REFCOUNT_TYPE(CONSTBUFFER_HANDLE_DATA)* refcounted;
+    /*Codes_SRS_CONSTBUFFER_03_001: [The copy of the bytes shall be stored in the same memory allocation as the handle.]*/
+    if (size > SIZE_MAX - sizeof(REFCOUNT_TYPE(CONSTBUFFER_HANDLE_DATA)))
+    {
+        /*Codes_SRS_CONSTBUFFER_02_003: [If creating the copy fails then CONSTBUFFER_Create shall return NULL.]*/
+        /*Codes_SRS_CONSTBUFFER_02_008: [If copying the content fails, then CONSTBUFFER_CreateFromBuffer shall fail and return NULL.] */
+        LogError("size too big: %lu", (unsigned long)size);
+        result = NULL;
+    }
+    else if ((refcounted = (REFCOUNT_TYPE(CONSTBUFFER_HANDLE_DATA)*)malloc(sizeof(REFCOUNT_TYPE(CONSTBUFFER_HANDLE_DATA)) + size)) == NULL)
     {
         /*Codes_SRS_CONSTBUFFER_02_003: [If creating the copy fails then CONSTBUFFER_Create shall return NULL.]*/
         /*Codes_SRS_CONSTBUFFER_02_008: [If copying the content fails, then CONSTBUFFER_CreateFromBuffer shall fail and return NULL.] */
         LogError("unable to malloc");
-        /*return as is*/
+        result = NULL;
     }
     else
     {
+        /*Codes_SRS_CONSTBUFFER_02_005: [The non-NULL handle returned by CONSTBUFFER_Create shall have its ref count set to "1".]*/
+        /*Codes_SRS_CONSTBUFFER_02_010: [The non-NULL handle returned by CONSTBUFFER_CreateFromBuffer shall have its ref count set to "1".]*/
+        refcounted->count = 1;
+        result = &refcounted->counted;
+        result->bufferType = CONSTBUFFER_TYPE_COPIED;
+        result->customFreeFunc = NULL;
+        result->customFreeFuncContext = NULL;
+        result->originalHandle = NULL;
+
         /*Codes_SRS_CONSTBUFFER_02_002: [Otherwise, CONSTBUFFER_Create shall create a copy of the memory area pointed to by source having size bytes.]*/
         result->alias.size = size;
         if (size == 0)
@@ -41,29 +73,38 @@ static CONSTBUFFER_HANDLE CONSTBUFFER_Create_Internal(const unsigned char* sourc
         }
         else
         {
-            unsigned char* temp = (unsigned char*)malloc(size);
-            if (temp == NULL)
-            {
-                /*Codes_SRS_CONSTBUFFER_02_003: [If creating the copy fails then CONSTBUFFER_Create shall return NULL.]*/
-                /*Codes_SRS_CONSTBUFFER_02_008: [If copying the content fails, then CONSTBUFFER_CreateFromBuffer shall fail and return NULL.] */
-                LogError("unable to malloc");
-                free(result);
-                result = NULL;
-            }
-            else
-            {
-                
-                /*Codes_SRS_CONSTBUFFER_02_004: [Otherwise CONSTBUFFER_Create shall return a non-NULL handle.]*/
-                /*Codes_SRS_CONSTBUFFER_02_007: [Otherwise, CONSTBUFFER_CreateFromBuffer shall copy the content of buffer.]*/
-                /*Codes_SRS_CONSTBUFFER_02_009: [Otherwise, CONSTBUFFER_CreateFromBuffer shall return a non-NULL handle.]*/
-                (void)memcpy(temp, source, size);
-                result->alias.buffer = temp;
-            }
+            /*Codes_SRS_CONSTBUFFER_02_004: [Otherwise CONSTBUFFER_Create shall return a non-NULL handle.]*/
+            /*Codes_SRS_CONSTBUFFER_02_007: [Otherwise, CONSTBUFFER_CreateFromBuffer shall copy the content of buffer.]*/
+            /*Codes_SRS_CONSTBUFFER_02_009: [Otherwise, CONSTBUFFER_CreateFromBuffer shall return a non-NULL handle.]*/
+            unsigned char* payload = (unsigned char*)(refcounted + 1);
+            (void)memcpy(payload, source, size);
+            result->alias.buffer = payload;
         }
     }
     return (CONSTBUFFER_HANDLE)result;
 }
 
+/*creates a handle that refers to bytes it does not copy, the bytes are released according to bufferType when the handle is destroyed*/
+static CONSTBUFFER_HANDLE CONSTBUFFER_CreateReferring_Internal(const unsigned char* source, size_t size, CONSTBUFFER_TYPE bufferType, CONSTBUFFER_CUSTOM_FREE_FUNC customFreeFunc, void* customFreeFuncContext)
+{
+    CONSTBUFFER_HANDLE_DATA* result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_HANDLE_DATA);
+    if (result == NULL)
+    {
+        LogError("unable to malloc");
+        /*return as is*/
+    }
+    else
+    {
+        result->alias.buffer = source;
+        result->alias.size = size;
+        result->bufferType = bufferType;
+        result->customFreeFunc = customFreeFunc;
+        result->customFreeFuncContext = customFreeFuncContext;
+        result->originalHandle = NULL;
+    }
+    return (CONSTBUFFER_HANDLE)result;
+}
+
 CONSTBUFFER_HANDLE CONSTBUFFER_Create(const unsigned char* source, size_t size)
 {
     CONSTBUFFER_HANDLE_DATA* result;
@@ -102,6 +143,125 @@ CONSTBUFFER_HANDLE CONSTBUFFER_CreateFromBuffer(BUFFER_HANDLE buffer)
     return (CONSTBUFFER_HANDLE)result;
 }
 
+CONSTBUFFER_HANDLE CONSTBUFFER_CreateWithMoveMemory(unsigned char* source, size_t size)
+{
+    CONSTBUFFER_HANDLE_DATA* result;
+    /*Codes_SRS_CONSTBUFFER_03_002: [If source is NULL and size is different than 0 then CONSTBUFFER_CreateWithMoveMemory shall fail and return NULL.]*/
+    if (
+        (source == NULL) &&
+        (size != 0)
+        )
+    {
+        LogError("invalid arguments: unsigned char* source=%p, size_t size=%lu", source, (unsigned long)size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_03_003: [CONSTBUFFER_CreateWithMoveMemory shall take ownership of source without copying it, source shall be released with free when the refcount reaches zero.]*/
+        /*Codes_SRS_CONSTBUFFER_03_004: [If any error occurs, CONSTBUFFER_CreateWithMoveMemory shall fail, return NULL and leave the ownership of source to the caller.]*/
+        /*Codes_SRS_CONSTBUFFER_03_005: [The non-NULL handle returned by CONSTBUFFER_CreateWithMoveMemory shall have its ref count set to "1".]*/
+        result = (CONSTBUFFER_HANDLE_DATA*)CONSTBUFFER_CreateReferring_Internal(source, size, CONSTBUFFER_TYPE_MEMORY_MOVED, NULL, NULL);
+    }
+    return (CONSTBUFFER_HANDLE)result;
+}
+
+CONSTBUFFER_HANDLE CONSTBUFFER_CreateWithCustomFree(const unsigned char* source, size_t size, CONSTBUFFER_CUSTOM_FREE_FUNC customFreeFunc, void* customFreeFuncContext)
+{
+    CONSTBUFFER_HANDLE_DATA* result;
+    /*Codes_SRS_CONSTBUFFER_03_006: [If source is NULL and size is different than 0 then CONSTBUFFER_CreateWithCustomFree shall fail and return NULL.]*/
+    /*Codes_SRS_CONSTBUFFER_03_007: [If customFreeFunc is NULL then CONSTBUFFER_CreateWithCustomFree shall fail and return NULL.]*/
+    if (
+        ((source == NULL) && (size != 0)) ||
+        (customFreeFunc == NULL)
+        )
+    {
+        LogError("invalid arguments: const unsigned char* source=%p, size_t size=%lu, CONSTBUFFER_CUSTOM_FREE_FUNC customFreeFunc=%s",
+            source, (unsigned long)size, (customFreeFunc == NULL) ? "NULL" : "non-NULL");
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_03_008: [CONSTBUFFER_CreateWithCustomFree shall refer to source without copying it, and shall call customFreeFunc with customFreeFuncContext when the refcount reaches zero.]*/
+        /*Codes_SRS_CONSTBUFFER_03_009: [If any error occurs, CONSTBUFFER_CreateWithCustomFree shall fail and return NULL, customFreeFunc shall not be called.]*/
+        /*Codes_SRS_CONSTBUFFER_03_010: [The non-NULL handle returned by CONSTBUFFER_CreateWithCustomFree shall have its ref count set to "1".]*/
+        result = (CONSTBUFFER_HANDLE_DATA*)CONSTBUFFER_CreateReferring_Internal(source, size, CONSTBUFFER_TYPE_WITH_CUSTOM_FREE, customFreeFunc, customFreeFuncContext);
+    }
+    return (CONSTBUFFER_HANDLE)result;
+}
+
+static void CONSTBUFFER_DeleteBuffer(void* context)
+{
+    BUFFER_delete((BUFFER_HANDLE)context);
+}
+
+CONSTBUFFER_HANDLE CONSTBUFFER_CreateFromBufferMove(BUFFER_HANDLE buffer)
+{
+    CONSTBUFFER_HANDLE_DATA* result;
+    /*Codes_SRS_CONSTBUFFER_03_011: [If buffer is NULL then CONSTBUFFER_CreateFromBufferMove shall fail and return NULL.]*/
+    if (buffer == NULL)
+    {
+        LogError("invalid arg passed to CONSTBUFFER_CreateFromBufferMove");
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_03_012: [CONSTBUFFER_CreateFromBufferMove shall take ownership of buffer and refer to its content without copying it, buffer shall be deleted with BUFFER_delete when the refcount reaches zero.]*/
+        /*Codes_SRS_CONSTBUFFER_03_013: [If any error occurs, CONSTBUFFER_CreateFromBufferMove shall fail, return NULL and leave the ownership of buffer to the caller.]*/
+        /*Codes_SRS_CONSTBUFFER_03_014: [The non-NULL handle returned by CONSTBUFFER_CreateFromBufferMove shall have its ref count set to "1".]*/
+        size_t length = BUFFER_length(buffer);
+        unsigned char* rawBuffer = BUFFER_u_char(buffer);
+        result = (CONSTBUFFER_HANDLE_DATA*)CONSTBUFFER_CreateReferring_Internal(rawBuffer, length, CONSTBUFFER_TYPE_WITH_CUSTOM_FREE, CONSTBUFFER_DeleteBuffer, buffer);
+    }
+    return (CONSTBUFFER_HANDLE)result;
+}
+
+CONSTBUFFER_HANDLE CONSTBUFFER_CreateFromOffsetAndSize(CONSTBUFFER_HANDLE handle, size_t offset, size_t size)
+{
+    CONSTBUFFER_HANDLE result;
+
+    if (handle == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_03_015: [If handle is NULL then CONSTBUFFER_CreateFromOffsetAndSize shall fail and return NULL.]*/
+        LogError("invalid arguments: CONSTBUFFER_HANDLE handle=%p, size_t offset=%lu, size_t size=%lu", handle, (unsigned long)offset, (unsigned long)size);
+        result = NULL;
+    }
+    else if (
+        (offset > handle->alias.size) ||
+        (size > handle->alias.size - offset)
+        )
+    {
+        /*Codes_SRS_CONSTBUFFER_03_016: [If offset is greater than the size of handle or offset + size is greater than the size of handle then CONSTBUFFER_CreateFromOffsetAndSize shall fail and return NULL.]*/
+        LogError("window out of range: size_t offset=%lu, size_t size=%lu, buffer size=%lu", (unsigned long)offset, (unsigned long)size, (unsigned long)handle->alias.size);
+        result = NULL;
+    }
+    else if (
+        (offset == 0) &&
+        (size == handle->alias.size)
+        )
+    {
+        /*Codes_SRS_CONSTBUFFER_03_017: [If the window covers the whole of handle then CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle and return handle.]*/
+        INC_REF(CONSTBUFFER_HANDLE_DATA, handle);
+        result = handle;
+    }
+    else
+    {
+        /*a window into a window refers to the bytes of the outermost handle, so that windows do not chain*/
+        CONSTBUFFER_HANDLE originalHandle = (handle->bufferType == CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE) ? handle->originalHandle : handle;
+
+        /*Codes_SRS_CONSTBUFFER_03_018: [CONSTBUFFER_CreateFromOffsetAndSize shall create a handle that refers to size bytes of handle starting at offset without copying them and that holds a reference to the handle owning the bytes.]*/
+        /*Codes_SRS_CONSTBUFFER_03_019: [If any error occurs, CONSTBUFFER_CreateFromOffsetAndSize shall fail and return NULL.]*/
+        /*Codes_SRS_CONSTBUFFER_03_020: [The non-NULL handle returned by CONSTBUFFER_CreateFromOffsetAndSize shall have its ref count set to "1".]*/
+        result = CONSTBUFFER_CreateReferring_Internal((size == 0) ? NULL : handle->alias.buffer + offset, size, CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE, NULL, NULL);
+        if (result != NULL)
+        {
+            INC_REF(CONSTBUFFER_HANDLE_DATA, originalHandle);
+            result->originalHandle = originalHandle;
+        }
+    }
+
+    return result;
+}
+
 CONSTBUFFER_HANDLE CONSTBUFFER_Clone(CONSTBUFFER_HANDLE constbufferHandle)
 {
     if (constbufferHandle == NULL)
@@ -144,7 +304,21 @@ void CONSTBUFFER_Destroy(CONSTBUFFER_HANDLE constbufferHandle)
         {
             /*Codes_SRS_CONSTBUFFER_02_017: [If the refcount reaches zero, then CONSTBUFFER_Destroy shall deallocate all resources used by the CONSTBUFFER_HANDLE.]*/
             CONSTBUFFER_HANDLE_DATA* constbufferHandleData = (CONSTBUFFER_HANDLE_DATA*)constbufferHandle;
-            free((void*)constbufferHandleData->alias.buffer);
+            switch (constbufferHandleData->bufferType)
+            {
+                case CONSTBUFFER_TYPE_MEMORY_MOVED:
+                    free((void*)constbufferHandleData->alias.buffer);
+                    break;
+                case CONSTBUFFER_TYPE_WITH_CUSTOM_FREE:
+                    constbufferHandleData->customFreeFunc(constbufferHandleData->customFreeFuncContext);
+                    break;
+                case CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE:
+                    CONSTBUFFER_Destroy(constbufferHandleData->originalHandle);
+                    break;
+                default:
+                    /*the copy lives in the same allocation as the handle*/
+                    break;
+            }
             free(constbufferHandleData);
         }
     }
@@ -0,0 +1,365 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/constbuffer_array.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/xlogging.h"
+#include "azure_c_shared_utility/refcount.h"
+
+typedef struct CONSTBUFFER_ARRAY_HANDLE_DATA_TAG
+{
+    size_t buffer_count;
+    size_t all_buffers_size;
+    /* both live in the same allocation as the array, contents[i] is the content of buffers[i] */
+    CONSTBUFFER* contents;
+    CONSTBUFFER_HANDLE* buffers;
+} CONSTBUFFER_ARRAY_HANDLE_DATA;
+
+DEFINE_REFCOUNT_TYPE(CONSTBUFFER_ARRAY_HANDLE_DATA);
+
+static CONSTBUFFER_ARRAY_HANDLE_DATA* constbuffer_array_allocate(size_t buffer_count)
+{
+    CONSTBUFFER_ARRAY_HANDLE_DATA* result;
+
+    if (buffer_count == 0)
+    {
+        result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA);
+        if (result == NULL)
+        {
+            LogError("Cannot allocate constbuffer array");
+        }
+        else
+        {
+            result->contents = NULL;
+            result->buffers = NULL;
+        }
+    }
+    else if (buffer_count > (SIZE_MAX - sizeof(REFCOUNT_TYPE(CONSTBUFFER_ARRAY_HANDLE_DATA))) / (sizeof(CONSTBUFFER) + sizeof(CONSTBUFFER_HANDLE)))
+    {
+        LogError("Too many buffers: %lu", (unsigned long)buffer_count);
+        result = NULL;
+    }
+    else
+    {
+        REFCOUNT_TYPE(CONSTBUFFER_ARRAY_HANDLE_DATA)* refcounted = (REFCOUNT_TYPE(CONSTBUFFER_ARRAY_HANDLE_DATA)*)malloc(
+            sizeof(REFCOUNT_TYPE(CONSTBUFFER_ARRAY_HANDLE_DATA)) + (buffer_count * (sizeof(CONSTBUFFER) + sizeof(CONSTBUFFER_HANDLE))));
+        if (refcounted == NULL)
+        {
+            LogError("Cannot allocate constbuffer array of %lu buffers", (unsigned long)buffer_count);
+            result = NULL;
+        }
+        else
+        {
+            refcounted->count = 1;
+            result = &refcounted->counted;
+            result->contents = (CONSTBUFFER*)(refcounted + 1);
+            result->buffers = (CONSTBUFFER_HANDLE*)(result->contents + buffer_count);
+        }
+    }
+
+    if (result != NULL)
+    {
+        result->buffer_count = buffer_count;
+        result->all_buffers_size = 0;
+    }
+
+    return result;
+}
+
+static void constbuffer_array_release_buffers(CONSTBUFFER_ARRAY_HANDLE_DATA* constbuffer_array, size_t buffer_count)
+{
+    size_t i;
+    for (i = 0; i < buffer_count; i++)
+    {
+        CONSTBUFFER_Destroy(constbuffer_array->buffers[i]);
+    }
+}
+
+/* stores a new reference to buffer at index, fails if the total size of the array would overflow */
+static int constbuffer_array_set_buffer(CONSTBUFFER_ARRAY_HANDLE_DATA* constbuffer_array, size_t index, CONSTBUFFER_HANDLE buffer)
+{
+    int result;
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(buffer);
+
+    if (content == NULL)
+    {
+        LogError("CONSTBUFFER_GetContent failed for buffer %lu", (unsigned long)index);
+        result = __FAILURE__;
+    }
+    else if (content->size > SIZE_MAX - constbuffer_array->all_buffers_size)
+    {
+        LogError("The size of all the buffers overflows at buffer %lu", (unsigned long)index);
+        result = __FAILURE__;
+    }
+    else
+    {
+        constbuffer_array->contents[index] = *content;
+        constbuffer_array->buffers[index] = CONSTBUFFER_Clone(buffer);
+        constbuffer_array->all_buffers_size += content->size;
+        result = 0;
+    }
+
+    return result;
+}
+
+/* builds a new array out of front (if not NULL), buffers and back (if not NULL), in this order */
+static CONSTBUFFER_ARRAY_HANDLE_DATA* constbuffer_array_build(CONSTBUFFER_HANDLE front, const CONSTBUFFER_HANDLE* buffers, size_t buffer_count, CONSTBUFFER_HANDLE back)
+{
+    CONSTBUFFER_ARRAY_HANDLE_DATA* result;
+    size_t extra_count = ((front == NULL) ? 0 : 1) + ((back == NULL) ? 0 : 1);
+
+    if (buffer_count > SIZE_MAX - extra_count)
+    {
+        LogError("Too many buffers: %lu", (unsigned long)buffer_count);
+        result = NULL;
+    }
+    else if ((result = constbuffer_array_allocate(buffer_count + extra_count)) == NULL)
+    {
+        /* already logged */
+    }
+    else
+    {
+        size_t set_count = 0;
+        size_t i;
+
+        if ((front != NULL) && (constbuffer_array_set_buffer(result, set_count, front) == 0))
+        {
+            set_count++;
+        }
+
+        if (set_count == ((front == NULL) ? 0 : 1))
+        {
+            for (i = 0; i < buffer_count; i++)
+            {
+                if (constbuffer_array_set_buffer(result, set_count, buffers[i]) != 0)
+                {
+                    break;
+                }
+                set_count++;
+            }
+
+            if ((i == buffer_count) && (back != NULL) && (constbuffer_array_set_buffer(result, set_count, back) == 0))
+            {
+                set_count++;
+            }
+        }
+
+        if (set_count != result->buffer_count)
+        {
+            constbuffer_array_release_buffers(result, set_count);
+            free(result);
+            result = NULL;
+        }
+    }
+
+    return result;
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create(const CONSTBUFFER_HANDLE* buffers, size_t buffer_count)
+{
+    CONSTBUFFER_ARRAY_HANDLE_DATA* result;
+
+    if ((buffers == NULL) && (buffer_count != 0))
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_001: [ If buffers is NULL and buffer_count is not 0, constbuffer_array_create shall fail and return NULL. ]*/
+        LogError("Invalid arguments: const CONSTBUFFER_HANDLE* buffers=%p, size_t buffer_count=%lu", buffers, (unsigned long)buffer_count);
+        result = NULL;
+    }
+    else
+    {
+        size_t i;
+
+        for (i = 0; i < buffer_count; i++)
+        {
+            if (buffers[i] == NULL)
+            {
+                break;
+            }
+        }
+
+        if (i < buffer_count)
+        {
+            /* Codes_SRS_CONSTBUFFER_ARRAY_03_002: [ If any of the buffers is NULL, constbuffer_array_create shall fail and return NULL. ]*/
+            LogError("Invalid argument: buffer %lu is NULL", (unsigned long)i);
+            result = NULL;
+        }
+        else
+        {
+            /* Codes_SRS_CONSTBUFFER_ARRAY_03_003: [ constbuffer_array_create shall allocate the array and its contents in a single allocation, take a new reference to each of the buffers and return a handle with its ref count set to 1. ]*/
+            /* Codes_SRS_CONSTBUFFER_ARRAY_03_004: [ If any error occurs, constbuffer_array_create shall fail and return NULL. ]*/
+            result = constbuffer_array_build(NULL, buffers, buffer_count, NULL);
+        }
+    }
+
+    return result;
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create_empty(void)
+{
+    /* Codes_SRS_CONSTBUFFER_ARRAY_03_005: [ constbuffer_array_create_empty shall create an array with no buffers and its ref count set to 1. ]*/
+    /* Codes_SRS_CONSTBUFFER_ARRAY_03_006: [ If any error occurs, constbuffer_array_create_empty shall fail and return NULL. ]*/
+    return constbuffer_array_allocate(0);
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_clone(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle)
+{
+    if (constbuffer_array_handle == NULL)
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_007: [ If constbuffer_array_handle is NULL, constbuffer_array_clone shall fail and return NULL. ]*/
+        LogError("Invalid argument: CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p", constbuffer_array_handle);
+    }
+    else
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_008: [ Otherwise constbuffer_array_clone shall increment the ref count and return constbuffer_array_handle. ]*/
+        INC_REF(CONSTBUFFER_ARRAY_HANDLE_DATA, constbuffer_array_handle);
+    }
+
+    return constbuffer_array_handle;
+}
+
+void constbuffer_array_destroy(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle)
+{
+    if (constbuffer_array_handle == NULL)
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_009: [ If constbuffer_array_handle is NULL, constbuffer_array_destroy shall return. ]*/
+        LogError("Invalid argument: CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p", constbuffer_array_handle);
+    }
+    /* Codes_SRS_CONSTBUFFER_ARRAY_03_010: [ Otherwise constbuffer_array_destroy shall decrement the ref count. ]*/
+    else if (DEC_REF(CONSTBUFFER_ARRAY_HANDLE_DATA, constbuffer_array_handle) == DEC_RETURN_ZERO)
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_011: [ If the ref count reaches 0, constbuffer_array_destroy shall release its reference to each of the buffers and free the array. ]*/
+        constbuffer_array_release_buffers(constbuffer_array_handle, constbuffer_array_handle->buffer_count);
+        free(constbuffer_array_handle);
+    }
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_add_front(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE constbuffer_handle)
+{
+    CONSTBUFFER_ARRAY_HANDLE_DATA* result;
+
+    if ((constbuffer_array_handle == NULL) || (constbuffer_handle == NULL))
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_012: [ If constbuffer_array_handle or constbuffer_handle is NULL, constbuffer_array_add_front shall fail and return NULL. ]*/
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, CONSTBUFFER_HANDLE constbuffer_handle=%p", constbuffer_array_handle, constbuffer_handle);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_013: [ constbuffer_array_add_front shall create a new array holding constbuffer_handle followed by the buffers of constbuffer_array_handle, and leave constbuffer_array_handle unchanged. ]*/
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_014: [ If any error occurs, constbuffer_array_add_front shall fail and return NULL. ]*/
+        result = constbuffer_array_build(constbuffer_handle, constbuffer_array_handle->buffers, constbuffer_array_handle->buffer_count, NULL);
+    }
+
+    return result;
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_add_back(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE constbuffer_handle)
+{
+    CONSTBUFFER_ARRAY_HANDLE_DATA* result;
+
+    if ((constbuffer_array_handle == NULL) || (constbuffer_handle == NULL))
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_015: [ If constbuffer_array_handle or constbuffer_handle is NULL, constbuffer_array_add_back shall fail and return NULL. ]*/
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, CONSTBUFFER_HANDLE constbuffer_handle=%p", constbuffer_array_handle, constbuffer_handle);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_016: [ constbuffer_array_add_back shall create a new array holding the buffers of constbuffer_array_handle followed by constbuffer_handle, and leave constbuffer_array_handle unchanged. ]*/
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_017: [ If any error occurs, constbuffer_array_add_back shall fail and return NULL. ]*/
+        result = constbuffer_array_build(NULL, constbuffer_array_handle->buffers, constbuffer_array_handle->buffer_count, constbuffer_handle);
+    }
+
+    return result;
+}
+
+int constbuffer_array_get_buffer_count(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, size_t* buffer_count)
+{
+    int result;
+
+    if ((constbuffer_array_handle == NULL) || (buffer_count == NULL))
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_018: [ If constbuffer_array_handle or buffer_count is NULL, constbuffer_array_get_buffer_count shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, size_t* buffer_count=%p", constbuffer_array_handle, buffer_count);
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_019: [ Otherwise constbuffer_array_get_buffer_count shall write the number of buffers in buffer_count and return 0. ]*/
+        *buffer_count = constbuffer_array_handle->buffer_count;
+        result = 0;
+    }
+
+    return result;
+}
+
+int constbuffer_array_get_all_buffers_size(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, size_t* all_buffers_size)
+{
+    int result;
+
+    if ((constbuffer_array_handle == NULL) || (all_buffers_size == NULL))
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_020: [ If constbuffer_array_handle or all_buffers_size is NULL, constbuffer_array_get_all_buffers_size shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, size_t* all_buffers_size=%p", constbuffer_array_handle, all_buffers_size);
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_021: [ Otherwise constbuffer_array_get_all_buffers_size shall write the sum of the sizes of all the buffers in all_buffers_size and return 0. ]*/
+        *all_buffers_size = constbuffer_array_handle->all_buffers_size;
+        result = 0;
+    }
+
+    return result;
+}
+
+CONSTBUFFER_HANDLE constbuffer_array_get_buffer(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, size_t buffer_index)
+{
+    CONSTBUFFER_HANDLE result;
+
+    if (constbuffer_array_handle == NULL)
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_022: [ If constbuffer_array_handle is NULL, constbuffer_array_get_buffer shall fail and return NULL. ]*/
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p", constbuffer_array_handle);
+        result = NULL;
+    }
+    else if (buffer_index >= constbuffer_array_handle->buffer_count)
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_023: [ If buffer_index is not smaller than the number of buffers, constbuffer_array_get_buffer shall fail and return NULL. ]*/
+        LogError("Invalid arguments: size_t buffer_index=%lu, buffer_count=%lu", (unsigned long)buffer_index, (unsigned long)constbuffer_array_handle->buffer_count);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_024: [ Otherwise constbuffer_array_get_buffer shall return a new reference to the buffer at buffer_index. ]*/
+        result = CONSTBUFFER_Clone(constbuffer_array_handle->buffers[buffer_index]);
+    }
+
+    return result;
+}
+
+int constbuffer_array_get_contents(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, const CONSTBUFFER** contents, size_t* buffer_count)
+{
+    int result;
+
+    if ((constbuffer_array_handle == NULL) || (contents == NULL) || (buffer_count == NULL))
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_025: [ If constbuffer_array_handle, contents or buffer_count is NULL, constbuffer_array_get_contents shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, const CONSTBUFFER** contents=%p, size_t* buffer_count=%p",
+            constbuffer_array_handle, contents, buffer_count);
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_CONSTBUFFER_ARRAY_03_026: [ Otherwise constbuffer_array_get_contents shall write in contents the contents of all the buffers, in order and stored contiguously, write the number of buffers in buffer_count and return 0. ]*/
+        *contents = constbuffer_array_handle->contents;
+        *buffer_count = constbuffer_array_handle->buffer_count;
+        result = 0;
+    }
+
+    return result;
+}
@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/conststring.h"
+#include "azure_c_shared_utility/xlogging.h"
+#include "azure_c_shared_utility/refcount.h"
+
+typedef struct CONSTSTRING_HANDLE_DATA_TAG
+{
+    size_t length;
+    /*points to the characters stored right after the handle, in the same allocation*/
+    const char* value;
+} CONSTSTRING_HANDLE_DATA;
+
+DEFINE_REFCOUNT_TYPE(CONSTSTRING_HANDLE_DATA);
+
+CONSTSTRING_HANDLE CONSTSTRING_Create(const char* source)
+{
+    CONSTSTRING_HANDLE_DATA* result;
+
+    if (source == NULL)
+    {
+        /*Codes_SRS_CONSTSTRING_03_001: [If source is NULL then CONSTSTRING_Create shall fail and return NULL.]*/
+        LogError("invalid argument: const char* source=%p", source);
+        result = NULL;
+    }
+    else
+    {
+        size_t length = strlen(source);
+
+        if (length == 0)
+        {
+            /*Codes_SRS_CONSTSTRING_03_003: [The non-NULL handle returned by CONSTSTRING_Create shall have its ref count set to "1".]*/
+            /*the empty string needs no storage of its own*/
+            result = REFCOUNT_TYPE_CREATE(CONSTSTRING_HANDLE_DATA);
+            if (result == NULL)
+            {
+                /*Codes_SRS_CONSTSTRING_03_004: [If any error occurs, CONSTSTRING_Create shall fail and return NULL.]*/
+                LogError("unable to malloc");
+            }
+            else
+            {
+                result->length = 0;
+                result->value = "";
+            }
+        }
+        else if (length > SIZE_MAX - sizeof(REFCOUNT_TYPE(CONSTSTRING_HANDLE_DATA)) - 1)
+        {
+            /*Codes_SRS_CONSTSTRING_03_004: [If any error occurs, CONSTSTRING_Create shall fail and return NULL.]*/
+            LogError("string too long: %lu", (unsigned long)length);
+            result = NULL;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTSTRING_03_002: [CONSTSTRING_Create shall copy source, including its null terminator, in the same memory allocation as the handle.]*/
+            REFCOUNT_TYPE(CONSTSTRING_HANDLE_DATA)* refcounted = (REFCOUNT_TYPE(CONSTSTRING_HANDLE_DATA)*)malloc(sizeof(REFCOUNT_TYPE(CONSTSTRING_HANDLE_DATA)) + length + 1);
+            if (refcounted == NULL)
+            {
+                /*Codes_SRS_CONSTSTRING_03_004: [If any error occurs, CONSTSTRING_Create shall fail and return NULL.]*/
+                LogError("unable to malloc");
+                result = NULL;
+            }
+            else
+            {
+                /*Codes_SRS_CONSTSTRING_03_003: [The non-NULL handle returned by CONSTSTRING_Create shall have its ref count set to "1".]*/
+                char* value = (char*)(refcounted + 1);
+                (void)memcpy(value, source, length + 1);
+                refcounted->count = 1;
+                result = &refcounted->counted;
+                result->length = length;
+                result->value = value;
+            }
+        }
+    }
+
+    return result;
+}
+
+CONSTSTRING_HANDLE CONSTSTRING_Clone(CONSTSTRING_HANDLE handle)
+{
+    if (handle == NULL)
+    {
+        /*Codes_SRS_CONSTSTRING_03_005: [If handle is NULL then CONSTSTRING_Clone shall fail and return NULL.]*/
+        LogError("invalid argument: CONSTSTRING_HANDLE handle=%p", handle);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTSTRING_03_006: [Otherwise, CONSTSTRING_Clone shall increment the reference count and return handle.]*/
+        INC_REF(CONSTSTRING_HANDLE_DATA, handle);
+    }
+    return handle;
+}
+
+const char* CONSTSTRING_c_str(CONSTSTRING_HANDLE handle)
+{
+    const char* result;
+    if (handle == NULL)
+    {
+        /*Codes_SRS_CONSTSTRING_03_007: [If handle is NULL then CONSTSTRING_c_str shall return NULL.]*/
+        LogError("invalid argument: CONSTSTRING_HANDLE handle=%p", handle);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTSTRING_03_008: [Otherwise, CONSTSTRING_c_str shall return the null terminated characters of handle.]*/
+        result = handle->value;
+    }
+    return result;
+}
+
+size_t CONSTSTRING_length(CONSTSTRING_HANDLE handle)
+{
+    size_t result;
+    if (handle == NULL)
+    {
+        /*Codes_SRS_CONSTSTRING_03_009: [If handle is NULL then CONSTSTRING_length shall return 0.]*/
+        LogError("invalid argument: CONSTSTRING_HANDLE handle=%p", handle);
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTSTRING_03_010: [Otherwise, CONSTSTRING_length shall return the number of characters of handle, without the null terminator.]*/
+        result = handle->length;
+    }
+    return result;
+}
+
+void CONSTSTRING_Destroy(CONSTSTRING_HANDLE handle)
+{
+    /*Codes_SRS_CONSTSTRING_03_011: [If handle is NULL then CONSTSTRING_Destroy shall do nothing.]*/
+    if (handle != NULL)
+    {
+        /*Codes_SRS_CONSTSTRING_03_012: [Otherwise, CONSTSTRING_Destroy shall decrement the reference count of handle.]*/
+        if (DEC_REF(CONSTSTRING_HANDLE_DATA, handle) == DEC_RETURN_ZERO)
+        {
+            /*Codes_SRS_CONSTSTRING_03_013: [If the reference count reaches zero, CONSTSTRING_Destroy shall free the memory used by handle.]*/
+            free(handle);
+        }
+    }
+}
@@ -0,0 +1,538 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/dns_resolver.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/condition.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/tickcounter.h"
+#include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/crt_abstractions.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+/* the most lookups that run at once, a thread is started when a lookup is queued and no thread is idle */
+#ifndef DNS_RESOLVER_THREAD_COUNT
+#define DNS_RESOLVER_THREAD_COUNT 4
+#endif
+
+#ifndef DNS_RESOLVER_DEFAULT_TTL_MS
+#define DNS_RESOLVER_DEFAULT_TTL_MS (60 * 1000)
+#endif
+
+#ifndef DNS_RESOLVER_DEFAULT_NEGATIVE_TTL_MS
+#define DNS_RESOLVER_DEFAULT_NEGATIVE_TTL_MS (5 * 1000)
+#endif
+
+typedef struct DNS_RESOLVER_LOOKUP_TAG
+{
+    char* hostname;
+    DNS_RESOLVER_RESULT result;
+    struct addrinfo* addresses;
+    int error;
+    tickcounter_ms_t resolved_ms;
+    /* the cache holds a reference while the entry is in it, every lookup returned by dns_resolver_lookup holds one, they are all counted under the lock */
+    size_t ref_count;
+} DNS_RESOLVER_LOOKUP;
+
+typedef struct DNS_RESOLVER_TAG
+{
+    size_t init_count;
+    LOCK_HANDLE lock;
+    COND_HANDLE queue_condition;
+    TICK_COUNTER_HANDLE tick_counter;
+    /* one entry per host name */
+    SINGLYLINKEDLIST_HANDLE cache;
+    /* the entries waiting for a worker thread */
+    SINGLYLINKEDLIST_HANDLE queue;
+    THREAD_HANDLE threads[DNS_RESOLVER_THREAD_COUNT];
+    size_t thread_count;
+    size_t idle_thread_count;
+    bool is_stopping;
+    /* the references returned by dns_resolver_lookup and not released yet, the last dns_resolver_deinit is finished by the release of the last
+       of them when it is called before */
+    size_t lookup_count;
+    bool is_deinit_deferred;
+    unsigned int ttl_ms;
+    unsigned int negative_ttl_ms;
+} DNS_RESOLVER;
+
+static DNS_RESOLVER dns_resolver;
+
+static void release_lookup(DNS_RESOLVER_LOOKUP* lookup)
+{
+    lookup->ref_count--;
+    if (lookup->ref_count == 0)
+    {
+        if (lookup->addresses != NULL)
+        {
+            freeaddrinfo(lookup->addresses);
+        }
+        free(lookup->hostname);
+        free(lookup);
+    }
+}
+
+static int resolve_queued_lookups(void* arg)
+{
+    (void)arg;
+
+    if (Lock(dns_resolver.lock) != LOCK_OK)
+    {
+        LogError("Failure: Lock failed.");
+    }
+    else
+    {
+        while (!dns_resolver.is_stopping)
+        {
+            LIST_ITEM_HANDLE queued_item = singlylinkedlist_get_head_item(dns_resolver.queue);
+            if (queued_item == NULL)
+            {
+                dns_resolver.idle_thread_count++;
+                (void)Condition_Wait(dns_resolver.queue_condition, dns_resolver.lock, 0);
+                dns_resolver.idle_thread_count--;
+            }
+            else
+            {
+                DNS_RESOLVER_LOOKUP* lookup = (DNS_RESOLVER_LOOKUP*)singlylinkedlist_item_get_value(queued_item);
+                struct addrinfo hints;
+                struct addrinfo* addresses = NULL;
+                int error;
+                tickcounter_ms_t now_ms = 0;
+
+                (void)singlylinkedlist_remove(dns_resolver.queue, queued_item);
+                (void)Unlock(dns_resolver.lock);
+
+                /* Codes_SRS_DNS_RESOLVER_03_015: [ A worker thread shall resolve the queued entries with getaddrinfo, asking for the stream addresses of any family, without holding the lock of the resolver. ]*/
+                (void)memset(&hints, 0, sizeof(hints));
+                hints.ai_family = AF_UNSPEC;
+                hints.ai_socktype = SOCK_STREAM;
+                error = getaddrinfo(lookup->hostname, NULL, &hints, &addresses);
+                if (error != 0)
+                {
+                    LogInfo("Failed DNS lookup for %s: %d", lookup->hostname, error);
+                }
+
+                (void)Lock(dns_resolver.lock);
+                /* the tick counter keeps the last time it read, it is only used under the lock */
+                (void)tickcounter_get_current_ms(dns_resolver.tick_counter, &now_ms);
+                lookup->addresses = (error == 0) ? addresses : NULL;
+                lookup->error = error;
+                lookup->resolved_ms = now_ms;
+                lookup->result = (error == 0) ? DNS_RESOLVER_OK : DNS_RESOLVER_ERROR;
+            }
+        }
+
+        (void)Unlock(dns_resolver.lock);
+    }
+
+    return 0;
+}
+
+static bool is_expired(const DNS_RESOLVER_LOOKUP* lookup, tickcounter_ms_t now_ms)
+{
+    /* a pending entry is never expired, the lookups of its host name wait for it */
+    return (lookup->result != DNS_RESOLVER_PENDING) &&
+        (now_ms - lookup->resolved_ms >= ((lookup->result == DNS_RESOLVER_OK) ? dns_resolver.ttl_ms : dns_resolver.negative_ttl_ms));
+}
+
+static DNS_RESOLVER_LOOKUP* find_in_cache(const char* hostname, tickcounter_ms_t now_ms)
+{
+    DNS_RESOLVER_LOOKUP* result = NULL;
+    LIST_ITEM_HANDLE item = singlylinkedlist_get_head_item(dns_resolver.cache);
+
+    while (item != NULL)
+    {
+        DNS_RESOLVER_LOOKUP* lookup = (DNS_RESOLVER_LOOKUP*)singlylinkedlist_item_get_value(item);
+        LIST_ITEM_HANDLE next_item = singlylinkedlist_get_next_item(item);
+
+        if (is_expired(lookup, now_ms))
+        {
+            /* Codes_SRS_DNS_RESOLVER_03_011: [ dns_resolver_lookup shall remove the entries of the cache whose TTL has elapsed, the lookups that hold them keep their result. ]*/
+            (void)singlylinkedlist_remove(dns_resolver.cache, item);
+            release_lookup(lookup);
+        }
+        else if (strcmp(lookup->hostname, hostname) == 0)
+        {
+            result = lookup;
+        }
+
+        item = next_item;
+    }
+
+    return result;
+}
+
+/* the thread is started when no thread is idle to take the entry, a lookup still completes when starting it fails as long as one thread runs */
+static int start_thread_if_needed(void)
+{
+    int result;
+
+    if ((dns_resolver.idle_thread_count > 0) || (dns_resolver.thread_count == DNS_RESOLVER_THREAD_COUNT))
+    {
+        result = 0;
+    }
+    else if (ThreadAPI_Create(&dns_resolver.threads[dns_resolver.thread_count], resolve_queued_lookups, NULL) != THREADAPI_OK)
+    {
+        LogError("Failure: ThreadAPI_Create failed.");
+        result = (dns_resolver.thread_count == 0) ? __FAILURE__ : 0;
+    }
+    else
+    {
+        dns_resolver.thread_count++;
+        result = 0;
+    }
+
+    return result;
+}
+
+static DNS_RESOLVER_LOOKUP* add_to_cache(const char* hostname)
+{
+    DNS_RESOLVER_LOOKUP* result = (DNS_RESOLVER_LOOKUP*)malloc(sizeof(DNS_RESOLVER_LOOKUP));
+
+    if (result == NULL)
+    {
+        LogError("Failure: cannot allocate the lookup.");
+    }
+    else if (mallocAndStrcpy_s(&result->hostname, hostname) != 0)
+    {
+        LogError("Failure: cannot copy the host name.");
+        free(result);
+        result = NULL;
+    }
+    else
+    {
+        LIST_ITEM_HANDLE cache_item;
+        LIST_ITEM_HANDLE queued_item;
+
+        result->result = DNS_RESOLVER_PENDING;
+        result->addresses = NULL;
+        result->error = 0;
+        result->resolved_ms = 0;
+        /* the cache and the caller */
+        result->ref_count = 2;
+
+        if ((cache_item = singlylinkedlist_add(dns_resolver.cache, result)) == NULL)
+        {
+            LogError("Failure: cannot add the lookup to the cache.");
+            free(result->hostname);
+            free(result);
+            result = NULL;
+        }
+        else if ((queued_item = singlylinkedlist_add(dns_resolver.queue, result)) == NULL)
+        {
+            LogError("Failure: cannot queue the lookup.");
+            (void)singlylinkedlist_remove(dns_resolver.cache, cache_item);
+            free(result->hostname);
+            free(result);
+            result = NULL;
+        }
+        else if (start_thread_if_needed() != 0)
+        {
+            /* nothing would ever resolve the entry */
+            (void)singlylinkedlist_remove(dns_resolver.queue, queued_item);
+            (void)singlylinkedlist_remove(dns_resolver.cache, cache_item);
+            free(result->hostname);
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            (void)Condition_Post(dns_resolver.queue_condition);
+        }
+    }
+
+    return result;
+}
+
+int dns_resolver_init(void)
+{
+    int result;
+
+    if (dns_resolver.init_count > 0)
+    {
+        /* Codes_SRS_DNS_RESOLVER_03_002: [ If the resolver is already initialized, dns_resolver_init shall count the call and return 0. ]*/
+        dns_resolver.init_count++;
+        result = 0;
+    }
+    else if (dns_resolver.is_deinit_deferred)
+    {
+        /* Codes_SRS_DNS_RESOLVER_03_024: [ If the last dns_resolver_deinit waits for lookups to be released, dns_resolver_init shall keep the resolver, count the call and return 0. ]*/
+        (void)Lock(dns_resolver.lock);
+        dns_resolver.is_deinit_deferred = false;
+        dns_resolver.init_count = 1;
+        (void)Unlock(dns_resolver.lock);
+        result = 0;
+    }
+    /* Codes_SRS_DNS_RESOLVER_03_001: [ dns_resolver_init shall create the lock, the condition, the tick counter, the cache and the queue of the resolver and return 0. ]*/
+    else if ((dns_resolver.lock = Lock_Init()) == NULL)
+    {
+        /* Codes_SRS_DNS_RESOLVER_03_003: [ If any error occurs, dns_resolver_init shall fail and return a non-zero value. ]*/
+        LogError("Failure: Lock_Init failed.");
+        result = __FAILURE__;
+    }
+    else if ((dns_resolver.queue_condition = Condition_Init()) == NULL)
+    {
+        LogError("Failure: Condition_Init failed.");
+        (void)Lock_Deinit(dns_resolver.lock);
+        result = __FAILURE__;
+    }
+    else if ((dns_resolver.tick_counter = tickcounter_create()) == NULL)
+    {
+        LogError("Failure: tickcounter_create failed.");
+        Condition_Deinit(dns_resolver.queue_condition);
+        (void)Lock_Deinit(dns_resolver.lock);
+        result = __FAILURE__;
+    }
+    else if ((dns_resolver.cache = singlylinkedlist_create()) == NULL)
+    {
+        LogError("Failure: singlylinkedlist_create failed.");
+        tickcounter_destroy(dns_resolver.tick_counter);
+        Condition_Deinit(dns_resolver.queue_condition);
+        (void)Lock_Deinit(dns_resolver.lock);
+        result = __FAILURE__;
+    }
+    else if ((dns_resolver.queue = singlylinkedlist_create()) == NULL)
+    {
+        LogError("Failure: singlylinkedlist_create failed.");
+        singlylinkedlist_destroy(dns_resolver.cache);
+        tickcounter_destroy(dns_resolver.tick_counter);
+        Condition_Deinit(dns_resolver.queue_condition);
+        (void)Lock_Deinit(dns_resolver.lock);
+        result = __FAILURE__;
+    }
+    else
+    {
+        dns_resolver.thread_count = 0;
+        dns_resolver.idle_thread_count = 0;
+        dns_resolver.is_stopping = false;
+        dns_resolver.lookup_count = 0;
+        dns_resolver.is_deinit_deferred = false;
+        dns_resolver.ttl_ms = DNS_RESOLVER_DEFAULT_TTL_MS;
+        dns_resolver.negative_ttl_ms = DNS_RESOLVER_DEFAULT_NEGATIVE_TTL_MS;
+        dns_resolver.init_count = 1;
+        result = 0;
+    }
+
+    return result;
+}
+
+/* the worker threads finish the lookups they are running, the ones still queued are released with the cache */
+static void destroy_resolver(void)
+{
+    /* Codes_SRS_DNS_RESOLVER_03_006: [ dns_resolver_deinit shall stop the worker threads, wait for the lookups they are running, and free the entries of the cache. ]*/
+    LIST_ITEM_HANDLE item;
+    size_t i;
+
+    (void)Lock(dns_resolver.lock);
+    dns_resolver.is_stopping = true;
+    for (i = 0; i < dns_resolver.thread_count; i++)
+    {
+        (void)Condition_Post(dns_resolver.queue_condition);
+    }
+    (void)Unlock(dns_resolver.lock);
+
+    for (i = 0; i < dns_resolver.thread_count; i++)
+    {
+        int thread_result;
+        (void)ThreadAPI_Join(dns_resolver.threads[i], &thread_result);
+    }
+
+    while ((item = singlylinkedlist_get_head_item(dns_resolver.cache)) != NULL)
+    {
+        DNS_RESOLVER_LOOKUP* lookup = (DNS_RESOLVER_LOOKUP*)singlylinkedlist_item_get_value(item);
+        (void)singlylinkedlist_remove(dns_resolver.cache, item);
+        release_lookup(lookup);
+    }
+
+    singlylinkedlist_destroy(dns_resolver.queue);
+    singlylinkedlist_destroy(dns_resolver.cache);
+    tickcounter_destroy(dns_resolver.tick_counter);
+    Condition_Deinit(dns_resolver.queue_condition);
+    (void)Lock_Deinit(dns_resolver.lock);
+}
+
+void dns_resolver_deinit(void)
+{
+    if (dns_resolver.init_count == 0)
+    {
+        /* Codes_SRS_DNS_RESOLVER_03_004: [ If the resolver is not initialized, dns_resolver_deinit shall return. ]*/
+        LogError("dns_resolver_deinit called without dns_resolver_init");
+    }
+    else if (--dns_resolver.init_count == 0)
+    {
+        /* Codes_SRS_DNS_RESOLVER_03_005: [ dns_resolver_deinit shall release the resolver on the call that matches the first dns_resolver_init. ]*/
+        bool is_deferred;
+
+        (void)Lock(dns_resolver.lock);
+        is_deferred = (dns_resolver.lookup_count != 0);
+        if (is_deferred)
+        {
+            /* Codes_SRS_DNS_RESOLVER_03_022: [ If lookups are not released, dns_resolver_deinit shall leave the resolver running until the last of them is released, no new lookup is accepted meanwhile. ]*/
+            LogError("dns_resolver_deinit called with %lu lookups not released, the resolver is released with the last of them.", (unsigned long)dns_resolver.lookup_count);
+            dns_resolver.is_deinit_deferred = true;
+        }
+        (void)Unlock(dns_resolver.lock);
+
+        if (!is_deferred)
+        {
+            destroy_resolver();
+        }
+    }
+}
+
+int dns_resolver_set_ttl(unsigned int ttl_ms, unsigned int negative_ttl_ms)
+{
+    int result;
+
+    if (dns_resolver.init_count == 0)
+    {
+        /* Codes_SRS_DNS_RESOLVER_03_007: [ If the resolver is not initialized, dns_resolver_set_ttl shall fail and return a non-zero value. ]*/
+        LogError("Failure: the resolver is not initialized.");
+        result = __FAILURE__;
+    }
+    else if (Lock(dns_resolver.lock) != LOCK_OK)
+    {
+        LogError("Failure: Lock failed.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_DNS_RESOLVER_03_008: [ dns_resolver_set_ttl shall keep the resolved entries of the cache for ttl_ms milliseconds and the failed ones for negative_ttl_ms milliseconds, and return 0. ]*/
+        dns_resolver.ttl_ms = ttl_ms;
+        dns_resolver.negative_ttl_ms = negative_ttl_ms;
+        (void)Unlock(dns_resolver.lock);
+        result = 0;
+    }
+
+    return result;
+}
+
+DNS_RESOLVER_LOOKUP_HANDLE dns_resolver_lookup(const char* hostname)
+{
+    DNS_RESOLVER_LOOKUP* result;
+
+    if (hostname == NULL)
+    {
+        /* Codes_SRS_DNS_RESOLVER_03_009: [ If hostname is NULL, dns_resolver_lookup shall fail and return NULL. ]*/
+        LogError("Invalid argument: hostname is NULL");
+        result = NULL;
+    }
+    else if (dns_resolver.init_count == 0)
+    {
+        /* Codes_SRS_DNS_RESOLVER_03_010: [ If the resolver is not initialized, dns_resolver_lookup shall fail and return NULL. ]*/
+        /* not an error: the socket IOs resolve host names themselves when the application does not use the resolver */
+        result = NULL;
+    }
+    else if (Lock(dns_resolver.lock) != LOCK_OK)
+    {
+        /* Codes_SRS_DNS_RESOLVER_03_014: [ If any error occurs, dns_resolver_lookup shall fail and return NULL. ]*/
+        LogError("Failure: Lock failed.");
+        result = NULL;
+    }
+    else
+    {
+        tickcounter_ms_t now_ms;
+
+        if (tickcounter_get_current_ms(dns_resolver.tick_counter, &now_ms) != 0)
+        {
+            LogError("Failure: tickcounter_get_current_ms failed.");
+            result = NULL;
+        }
+        else if ((result = find_in_cache(hostname, now_ms)) != NULL)
+        {
+            /* Codes_SRS_DNS_RESOLVER_03_012: [ If the cache has an entry for hostname, resolved or pending, dns_resolver_lookup shall return a new reference to it. ]*/
+            result->ref_count++;
+        }
+        else
+        {
+            /* Codes_SRS_DNS_RESOLVER_03_013: [ Otherwise dns_resolver_lookup shall add a pending entry for hostname to the cache, queue it for a worker thread, starting one if none is idle and fewer than DNS_RESOLVER_THREAD_COUNT run, and return a reference to it. ]*/
+            result = add_to_cache(hostname);
+        }
+
+        if (result != NULL)
+        {
+            dns_resolver.lookup_count++;
+        }
+
+        (void)Unlock(dns_resolver.lock);
+    }
+
+    return result;
+}
+
+DNS_RESOLVER_RESULT dns_resolver_get_result(DNS_RESOLVER_LOOKUP_HANDLE lookup, const struct addrinfo** addresses, int* error)
+{
+    DNS_RESOLVER_RESULT result;
+
+    if (lookup == NULL)
+    {
+        /* Codes_SRS_DNS_RESOLVER_03_016: [ If lookup is NULL, dns_resolver_get_result shall fail and return DNS_RESOLVER_ERROR. ]*/
+        LogError("Invalid argument: lookup is NULL");
+        result = DNS_RESOLVER_ERROR;
+    }
+    else if (Lock(dns_resolver.lock) != LOCK_OK)
+    {
+        LogError("Failure: Lock failed.");
+        result = DNS_RESOLVER_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_DNS_RESOLVER_03_017: [ While the host name is resolved, dns_resolver_get_result shall return DNS_RESOLVER_PENDING. ]*/
+        result = lookup->result;
+        if ((result == DNS_RESOLVER_OK) && (addresses != NULL))
+        {
+            /* Codes_SRS_DNS_RESOLVER_03_018: [ Once the host name is resolved, dns_resolver_get_result shall set addresses to the addresses getaddrinfo returned and return DNS_RESOLVER_OK. ]*/
+            *addresses = lookup->addresses;
+        }
+        else if ((result == DNS_RESOLVER_ERROR) && (error != NULL))
+        {
+            /* Codes_SRS_DNS_RESOLVER_03_019: [ If resolving the host name failed, dns_resolver_get_result shall set error to the error getaddrinfo returned and return DNS_RESOLVER_ERROR. ]*/
+            *error = lookup->error;
+        }
+        (void)Unlock(dns_resolver.lock);
+    }
+
+    return result;
+}
+
+void dns_resolver_release(DNS_RESOLVER_LOOKUP_HANDLE lookup)
+{
+    if (lookup == NULL)
+    {
+        /* Codes_SRS_DNS_RESOLVER_03_020: [ If lookup is NULL, dns_resolver_release shall return. ]*/
+        LogError("Invalid argument: lookup is NULL");
+    }
+    else if (Lock(dns_resolver.lock) != LOCK_OK)
+    {
+        LogError("Failure: Lock failed.");
+    }
+    else
+    {
+        /* Codes_SRS_DNS_RESOLVER_03_021: [ dns_resolver_release shall release the reference of lookup, and free the entry with its addresses when it was the last one. ]*/
+        bool is_deinit_finished;
+
+        release_lookup(lookup);
+        dns_resolver.lookup_count--;
+        is_deinit_finished = dns_resolver.is_deinit_deferred && (dns_resolver.lookup_count == 0);
+        if (is_deinit_finished)
+        {
+            dns_resolver.is_deinit_deferred = false;
+        }
+        (void)Unlock(dns_resolver.lock);
+
+        if (is_deinit_finished)
+        {
+            /* Codes_SRS_DNS_RESOLVER_03_023: [ When the last dns_resolver_deinit waits for lookups to be released, dns_resolver_release of the last of them shall release the resolver. ]*/
+            destroy_resolver();
+        }
+    }
+}
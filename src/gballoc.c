@@ -11,30 +11,370 @@
 
 #ifndef GB_USE_CUSTOM_HEAP
 
+/* this file implements what gballoc.h redirects to, so it needs the declarations without the redirection */
+#ifdef GB_MEASURE_MEMORY_FOR_THIS
+#undef GB_MEASURE_MEMORY_FOR_THIS
+#endif
+#ifndef GB_DEBUG_ALLOC
+#define GB_DEBUG_ALLOC
+#endif
+#include "azure_c_shared_utility/gballoc.h"
+
 #ifndef SIZE_MAX
 #define SIZE_MAX ((size_t)~(size_t)0)
 #endif
 
+/* the aggregate counters are updated with atomic operations so that no lock is shared by all the allocating threads */
+/* GBALLOC_ATOMIC_ADD and GBALLOC_ATOMIC_CAS both return the value the counter had before the operation */
+#if defined(_MSC_VER)
+#include <intrin.h>
+#if defined(_WIN64)
+#define GBALLOC_ATOMIC_ADD(var, value) ((size_t)_InterlockedExchangeAdd64((volatile __int64*)(var), (__int64)(value)))
+#define GBALLOC_ATOMIC_CAS(var, expected, desired) ((size_t)_InterlockedCompareExchange64((volatile __int64*)(var), (__int64)(desired), (__int64)(expected)))
+#else
+#define GBALLOC_ATOMIC_ADD(var, value) ((size_t)_InterlockedExchangeAdd((volatile long*)(var), (long)(value)))
+#define GBALLOC_ATOMIC_CAS(var, expected, desired) ((size_t)_InterlockedCompareExchange((volatile long*)(var), (long)(desired), (long)(expected)))
+#endif
+#elif defined(__GNUC__)
+#define GBALLOC_ATOMIC_ADD(var, value) __sync_fetch_and_add((var), (value))
+#define GBALLOC_ATOMIC_CAS(var, expected, desired) __sync_val_compare_and_swap((var), (expected), (desired))
+#else
+/* no atomic operations known for this compiler, the counters are only exact when allocations are not concurrent */
+static size_t gballoc_plain_add(volatile size_t* var, size_t value)
+{
+    size_t previous = *var;
+    *var = previous + value;
+    return previous;
+}
+static size_t gballoc_plain_cas(volatile size_t* var, size_t expected, size_t desired)
+{
+    size_t previous = *var;
+    if (previous == expected)
+    {
+        *var = desired;
+    }
+    return previous;
+}
+#define GBALLOC_ATOMIC_ADD(var, value) gballoc_plain_add((var), (value))
+#define GBALLOC_ATOMIC_CAS(var, expected, desired) gballoc_plain_cas((var), (expected), (desired))
+#endif
+
+#define GBALLOC_ATOMIC_LOAD(var) GBALLOC_ATOMIC_ADD((var), 0)
+
+/* callsites are kept in a fixed open addressed table so that profiling never allocates, GBALLOC_MAX_CALLSITES has to be a power of 2 */
+#ifndef GBALLOC_MAX_CALLSITES
+#define GBALLOC_MAX_CALLSITES 1024
+#endif
+
+#define CALLSITE_EMPTY 0
+#define CALLSITE_CLAIMED 1
+#define CALLSITE_READY 2
+
+typedef struct GBALLOC_CALLSITE_TAG
+{
+    /* file and line can only be read once state is CALLSITE_READY */
+    volatile size_t state;
+    const char* file;
+    int line;
+    volatile size_t liveBytes;
+    volatile size_t peakBytes;
+    volatile size_t liveAllocations;
+    volatile size_t allocationCount;
+} GBALLOC_CALLSITE;
+
 typedef struct ALLOCATION_TAG
 {
     size_t size;
     void* ptr;
-    void* next;
+    GBALLOC_CALLSITE* callsite;
+    /* value of metricsEpoch when the block was counted in the total */
+    size_t epoch;
+    struct ALLOCATION_TAG* next;
 } ALLOCATION;
 
+/* allocations are indexed by pointer in chained hash tables so that free/realloc do not need to walk all the live allocations.
+   The index is split in shards, each with its own lock, so that threads allocating concurrently rarely wait for each other. */
+#define GBALLOC_SHARD_COUNT 16
+#define GBALLOC_INITIAL_BUCKET_COUNT 64
+/* a shard's table is doubled when it has more live allocations than GBALLOC_MAX_LOAD_FACTOR * bucket count */
+#define GBALLOC_MAX_LOAD_FACTOR 2
+
+typedef struct GBALLOC_SHARD_TAG
+{
+    LOCK_HANDLE lock;
+    ALLOCATION** buckets;
+    size_t bucketCount;
+    size_t liveAllocations;
+    /* the counter is kept per shard and only written with the shard lock held, the getter adds them up */
+    volatile size_t allocationCount;
+    /* blocks that could not be indexed because the shard lock could not be taken, pushed without the lock and indexed by the next
+       holder of the lock (the list is only ever taken as a whole, so pushing with a compare and swap is safe) */
+    volatile size_t deferredAllocations;
+    ALLOCATION* initialBuckets[GBALLOC_INITIAL_BUCKET_COUNT];
+} GBALLOC_SHARD;
+
 typedef enum GBALLOC_STATE_TAG
 {
     GBALLOC_STATE_INIT,
     GBALLOC_STATE_NOT_INIT
 } GBALLOC_STATE;
 
-static ALLOCATION* head = NULL;
-static size_t totalSize = 0;
-static size_t maxSize = 0;
-static size_t g_allocations = 0;
+static GBALLOC_SHARD shards[GBALLOC_SHARD_COUNT];
+/* the total is a single atomic counter, so that the maximum is updated from the exact total without looking at the other shards */
+static volatile size_t totalSize = 0;
+static volatile size_t maxSize = 0;
+/* bumped by gballoc_init and gballoc_resetMetrics with all the shard locks held, blocks counted before that are not deducted when freed */
+static size_t metricsEpoch = 0;
 static GBALLOC_STATE gballocState = GBALLOC_STATE_NOT_INIT;
+static GBALLOC_CALLSITE callsites[GBALLOC_MAX_CALLSITES];
+
+static size_t get_pointer_hash(const void* ptr)
+{
+    /* low bits of heap pointers are mostly zero due to alignment, so mix them before using them */
+    uintptr_t hash = (uintptr_t)ptr;
+    hash ^= hash >> 4;
+    hash *= (uintptr_t)0x9E3779B1u;
+    hash ^= hash >> 16;
+    return (size_t)hash;
+}
+
+static GBALLOC_SHARD* get_shard(const void* ptr)
+{
+    return &shards[get_pointer_hash(ptr) % GBALLOC_SHARD_COUNT];
+}
+
+static size_t get_bucket_index(const void* ptr, size_t count)
+{
+    /* the low hash bits pick the shard, the bucket is picked with the rest (count is always a power of 2) */
+    return (get_pointer_hash(ptr) / GBALLOC_SHARD_COUNT) & (count - 1);
+}
+
+static void grow_buckets(GBALLOC_SHARD* shard)
+{
+    size_t newBucketCount = shard->bucketCount * 2;
+    ALLOCATION** newBuckets;
+
+    if ((newBucketCount <= shard->bucketCount) ||
+        (newBucketCount > SIZE_MAX / sizeof(ALLOCATION*)) ||
+        ((newBuckets = (ALLOCATION**)calloc(newBucketCount, sizeof(ALLOCATION*))) == NULL))
+    {
+        /* not growing only makes the chains longer, tracking keeps working */
+        LogError("Failed to grow the allocation index.");
+    }
+    else
+    {
+        size_t i;
+        for (i = 0; i < shard->bucketCount; i++)
+        {
+            ALLOCATION* curr = shard->buckets[i];
+            while (curr != NULL)
+            {
+                ALLOCATION* next = curr->next;
+                size_t index = get_bucket_index(curr->ptr, newBucketCount);
+                curr->next = newBuckets[index];
+                newBuckets[index] = curr;
+                curr = next;
+            }
+        }
+
+        if (shard->buckets != shard->initialBuckets)
+        {
+            free(shard->buckets);
+        }
+
+        shard->buckets = newBuckets;
+        shard->bucketCount = newBucketCount;
+    }
+}
+
+static void add_allocation(GBALLOC_SHARD* shard, ALLOCATION* allocation)
+{
+    size_t index = get_bucket_index(allocation->ptr, shard->bucketCount);
+    allocation->next = shard->buckets[index];
+    shard->buckets[index] = allocation;
+    shard->liveAllocations++;
+
+    if (shard->liveAllocations > shard->bucketCount * GBALLOC_MAX_LOAD_FACTOR)
+    {
+        grow_buckets(shard);
+    }
+}
+
+static ALLOCATION* find_allocation(GBALLOC_SHARD* shard, const void* ptr, ALLOCATION*** link)
+{
+    ALLOCATION** prev = &shard->buckets[get_bucket_index(ptr, shard->bucketCount)];
+    ALLOCATION* curr = *prev;
+
+    while ((curr != NULL) && (curr->ptr != ptr))
+    {
+        prev = &curr->next;
+        curr = *prev;
+    }
+
+    if (link != NULL)
+    {
+        *link = prev;
+    }
+
+    return curr;
+}
+
+static void remove_allocation(GBALLOC_SHARD* shard, ALLOCATION** link)
+{
+    ALLOCATION* allocation = *link;
+    *link = allocation->next;
+    shard->liveAllocations--;
+}
+
+static void update_max(volatile size_t* max, size_t value)
+{
+    size_t currentMax = GBALLOC_ATOMIC_LOAD(max);
+
+    while (currentMax < value)
+    {
+        size_t previousMax = GBALLOC_ATOMIC_CAS(max, currentMax, value);
+        if (previousMax == currentMax)
+        {
+            break;
+        }
+
+        currentMax = previousMax;
+    }
+}
+
+/* both are called with the shard lock held, so that they cannot race with gballoc_resetMetrics */
+static void count_allocation(ALLOCATION* allocation)
+{
+    allocation->epoch = metricsEpoch;
+    /* Codes_SRS_GBALLOC_01_011: [The maximum total memory used shall be the maximum of the total memory used at any point.] */
+    update_max(&maxSize, GBALLOC_ATOMIC_ADD(&totalSize, allocation->size) + allocation->size);
+}
+
+static void uncount_allocation(const ALLOCATION* allocation)
+{
+    /* Codes_SRS_GBALLOC_07_010: [ Blocks allocated before gballoc_resetMetrics shall not be deducted from the total memory used when they are freed or reallocated. ]*/
+    if (allocation->epoch == metricsEpoch)
+    {
+        (void)GBALLOC_ATOMIC_ADD(&totalSize, (size_t)0 - allocation->size);
+    }
+}
+
+/* called without the shard lock, when the lock could not be taken for a block the caller owns */
+static void defer_allocation(GBALLOC_SHARD* shard, ALLOCATION* allocation)
+{
+    size_t head = GBALLOC_ATOMIC_LOAD(&shard->deferredAllocations);
+    size_t previousHead;
+
+    allocation->next = (ALLOCATION*)head;
+    while ((previousHead = GBALLOC_ATOMIC_CAS(&shard->deferredAllocations, head, (size_t)allocation)) != head)
+    {
+        head = previousHead;
+        allocation->next = (ALLOCATION*)head;
+    }
+}
+
+/* called right after taking the shard lock, indexes the blocks deferred while the lock could not be taken */
+static void index_deferred_allocations(GBALLOC_SHARD* shard)
+{
+    if (shard->deferredAllocations != 0)
+    {
+        size_t head = GBALLOC_ATOMIC_LOAD(&shard->deferredAllocations);
+        size_t previousHead;
+        ALLOCATION* allocation;
 
-static LOCK_HANDLE gballocThreadSafeLock = NULL;
+        while ((previousHead = GBALLOC_ATOMIC_CAS(&shard->deferredAllocations, head, 0)) != head)
+        {
+            head = previousHead;
+        }
+
+        allocation = (ALLOCATION*)head;
+        while (allocation != NULL)
+        {
+            ALLOCATION* next = allocation->next;
+            add_allocation(shard, allocation);
+            /* a reset that happened meanwhile already dropped the block from the counters */
+            if (allocation->epoch == metricsEpoch)
+            {
+                count_allocation(allocation);
+            }
+            allocation = next;
+        }
+    }
+}
+
+static GBALLOC_CALLSITE* get_callsite(const char* file, int line)
+{
+    GBALLOC_CALLSITE* result = NULL;
+
+    if (file != NULL)
+    {
+        /* __FILE__ is the same string for all the callsites of a translation unit, so the pointer identifies the file */
+        size_t index = get_pointer_hash(file) ^ ((size_t)line * (size_t)0x9E3779B1u);
+        size_t i;
+
+        for (i = 0; i < GBALLOC_MAX_CALLSITES; i++)
+        {
+            GBALLOC_CALLSITE* callsite = &callsites[(index + i) & (GBALLOC_MAX_CALLSITES - 1)];
+            size_t state = GBALLOC_ATOMIC_LOAD(&callsite->state);
+
+            if ((state == CALLSITE_EMPTY) &&
+                ((state = GBALLOC_ATOMIC_CAS(&callsite->state, CALLSITE_EMPTY, CALLSITE_CLAIMED)) == CALLSITE_EMPTY))
+            {
+                callsite->file = file;
+                callsite->line = line;
+                (void)GBALLOC_ATOMIC_CAS(&callsite->state, CALLSITE_CLAIMED, CALLSITE_READY);
+                result = callsite;
+                break;
+            }
+
+            /* another thread is filling in this slot, it only takes a couple of stores */
+            while (state == CALLSITE_CLAIMED)
+            {
+                state = GBALLOC_ATOMIC_LOAD(&callsite->state);
+            }
+
+            if ((callsite->file == file) && (callsite->line == line))
+            {
+                result = callsite;
+                break;
+            }
+        }
+
+        /* when the table is full the allocation is still tracked, it is just not accounted to a callsite */
+    }
+
+    return result;
+}
+
+static void add_callsite_allocation(GBALLOC_CALLSITE* callsite, size_t size)
+{
+    if (callsite != NULL)
+    {
+        update_max(&callsite->peakBytes, GBALLOC_ATOMIC_ADD(&callsite->liveBytes, size) + size);
+        (void)GBALLOC_ATOMIC_ADD(&callsite->liveAllocations, 1);
+        (void)GBALLOC_ATOMIC_ADD(&callsite->allocationCount, 1);
+    }
+}
+
+static void remove_callsite_allocation(GBALLOC_CALLSITE* callsite, size_t size)
+{
+    if (callsite != NULL)
+    {
+        (void)GBALLOC_ATOMIC_ADD(&callsite->liveBytes, (size_t)0 - size);
+        (void)GBALLOC_ATOMIC_ADD(&callsite->liveAllocations, (size_t)0 - 1);
+    }
+}
+
+static void set_counter(volatile size_t* counter, size_t value)
+{
+    size_t current = GBALLOC_ATOMIC_LOAD(counter);
+    size_t previous;
+
+    while ((previous = GBALLOC_ATOMIC_CAS(counter, current, value)) != current)
+    {
+        current = previous;
+    }
+}
 
 int gballoc_init(void)
 {
@@ -45,23 +385,58 @@ int gballoc_init(void)
         /* Codes_SRS_GBALLOC_01_025: [Init after Init shall fail and return a non-zero value.] */
         result = __FAILURE__;
     }
-    /* Codes_SRS_GBALLOC_01_026: [gballoc_Init shall create a lock handle that will be used to make the other gballoc APIs thread-safe.] */
-    else if ((gballocThreadSafeLock = Lock_Init()) == NULL)
-    {
-        /* Codes_SRS_GBALLOC_01_027: [If the Lock creation fails, gballoc_init shall return a non-zero value.]*/
-        result = __FAILURE__;
-    }
     else
     {
-        gballocState = GBALLOC_STATE_INIT;
+        size_t i;
 
-        /* Codes_ SRS_GBALLOC_01_002: [Upon initialization the total memory used and maximum total memory used tracked by the module shall be set to 0.] */
-        totalSize = 0;
-        maxSize = 0;
-        g_allocations = 0;
+        /* Codes_SRS_GBALLOC_01_026: [gballoc_Init shall create a lock handle that will be used to make the other gballoc APIs thread-safe.] */
+        /* Codes_SRS_GBALLOC_03_001: [ gballoc_init shall create one lock for each of the GBALLOC_SHARD_COUNT shards of the allocation index. ]*/
+        for (i = 0; i < GBALLOC_SHARD_COUNT; i++)
+        {
+            if ((shards[i].lock = Lock_Init()) == NULL)
+            {
+                break;
+            }
+        }
 
-        /* Codes_SRS_GBALLOC_01_024: [gballoc_init shall initialize the gballoc module and return 0 upon success.] */
-        result = 0;
+        if (i < GBALLOC_SHARD_COUNT)
+        {
+            /* Codes_SRS_GBALLOC_01_027: [If the Lock creation fails, gballoc_init shall return a non-zero value.]*/
+            /* Codes_SRS_GBALLOC_03_002: [ If creating any of the shard locks fails, gballoc_init shall destroy the locks already created. ]*/
+            LogError("Failed to create the lock for shard %lu.", (unsigned long)i);
+            while (i > 0)
+            {
+                i--;
+                (void)Lock_Deinit(shards[i].lock);
+                shards[i].lock = NULL;
+            }
+
+            result = __FAILURE__;
+        }
+        else
+        {
+            for (i = 0; i < GBALLOC_SHARD_COUNT; i++)
+            {
+                /* tracked allocations survive a deinit/init cycle, so the index is only set up the first time */
+                if (shards[i].buckets == NULL)
+                {
+                    shards[i].buckets = shards[i].initialBuckets;
+                    shards[i].bucketCount = GBALLOC_INITIAL_BUCKET_COUNT;
+                }
+
+                shards[i].allocationCount = 0;
+            }
+
+            gballocState = GBALLOC_STATE_INIT;
+
+            /* Codes_ SRS_GBALLOC_01_002: [Upon initialization the total memory used and maximum total memory used tracked by the module shall be set to 0.] */
+            totalSize = 0;
+            maxSize = 0;
+            metricsEpoch++;
+
+            /* Codes_SRS_GBALLOC_01_024: [gballoc_init shall initialize the gballoc module and return 0 upon success.] */
+            result = 0;
+        }
     }
 
     return result;
@@ -71,120 +446,122 @@ void gballoc_deinit(void)
 {
     if (gballocState == GBALLOC_STATE_INIT)
     {
+        size_t i;
+
         /* Codes_SRS_GBALLOC_01_028: [gballoc_deinit shall free all resources allocated by gballoc_init.] */
-        (void)Lock_Deinit(gballocThreadSafeLock);
+        for (i = 0; i < GBALLOC_SHARD_COUNT; i++)
+        {
+            (void)Lock_Deinit(shards[i].lock);
+            shards[i].lock = NULL;
+        }
     }
 
     gballocState = GBALLOC_STATE_NOT_INIT;
 }
 
+/* tracks a block freshly returned by the underlying allocator, returns the block or NULL if it could not be tracked (in which case the block is freed) */
+static void* track_new_allocation(ALLOCATION* allocation, void* ptr, size_t size, GBALLOC_CALLSITE* callsite)
+{
+    void* result;
+    GBALLOC_SHARD* shard = get_shard(ptr);
+
+    /* Codes_SRS_GBALLOC_03_003: [ The lock taken shall be the lock of the shard owning the allocated pointer, the underlying allocation function shall be called without holding any lock. ]*/
+    if (LOCK_OK != Lock(shard->lock))
+    {
+        LogError("Failed to get the Lock.");
+        free(ptr);
+        free(allocation);
+        result = NULL;
+    }
+    else
+    {
+        index_deferred_allocations(shard);
+        allocation->ptr = ptr;
+        allocation->size = size;
+        allocation->callsite = callsite;
+        add_allocation(shard, allocation);
+        count_allocation(allocation);
+        shard->allocationCount++;
+        (void)Unlock(shard->lock);
+
+        /* Codes_SRS_GBALLOC_03_006: [ gballoc_malloc_at, gballoc_calloc_at and gballoc_realloc_at shall account the allocation to the callsite identified by file and line. ]*/
+        add_callsite_allocation(callsite, size);
+
+        result = ptr;
+    }
+
+    return result;
+}
+
 void* gballoc_malloc(size_t size)
+{
+    return gballoc_malloc_at(size, NULL, 0);
+}
+
+void* gballoc_malloc_at(size_t size, const char* file, int line)
 {
     void* result;
+    ALLOCATION* allocation;
 
     if (gballocState != GBALLOC_STATE_INIT)
     {
         /* Codes_SRS_GBALLOC_01_039: [If gballoc was not initialized gballoc_malloc shall simply call malloc without any memory tracking being performed.] */
         result = malloc(size);
     }
-    /* Codes_SRS_GBALLOC_01_030: [gballoc_malloc shall ensure thread safety by using the lock created by gballoc_Init.] */
-    else if (LOCK_OK != Lock(gballocThreadSafeLock))
+    else if ((allocation = (ALLOCATION*)malloc(sizeof(ALLOCATION))) == NULL)
     {
-        /* Codes_SRS_GBALLOC_01_048: [If acquiring the lock fails, gballoc_malloc shall return NULL.] */
-        LogError("Failed to get the Lock.");
+        /* Codes_SRS_GBALLOC_01_013: [When gballoc_malloc fails allocating memory for its internal use, gballoc_malloc shall return NULL.] */
         result = NULL;
     }
+    /* Codes_SRS_GBALLOC_01_003: [gb_malloc shall call the C99 malloc function and return its result.] */
+    else if ((result = malloc(size)) == NULL)
+    {
+        /* Codes_SRS_GBALLOC_01_012: [When the underlying malloc call fails, gballoc_malloc shall return NULL and size should not be counted towards total memory used.] */
+        free(allocation);
+    }
     else
     {
-        ALLOCATION* allocation = (ALLOCATION*)malloc(sizeof(ALLOCATION));
-        if (allocation == NULL)
-        {
-            result = NULL;
-        }
-        else
-        {
-            /* Codes_SRS_GBALLOC_01_003: [gb_malloc shall call the C99 malloc function and return its result.] */
-            result = malloc(size);
-            if (result == NULL)
-            {
-                /* Codes_SRS_GBALLOC_01_012: [When the underlying malloc call fails, gballoc_malloc shall return NULL and size should not be counted towards total memory used.] */
-                free(allocation);
-            }
-            else
-            {
-                /* Codes_SRS_GBALLOC_01_004: [If the underlying malloc call is successful, gb_malloc shall increment the total memory used with the amount indicated by size.] */
-                allocation->ptr = result;
-                allocation->size = size;
-                allocation->next = head;
-                head = allocation;
-
-                g_allocations++;
-                totalSize += size;
-                /* Codes_SRS_GBALLOC_01_011: [The maximum total memory used shall be the maximum of the total memory used at any point.] */
-                if (maxSize < totalSize)
-                {
-                    maxSize = totalSize;
-                }
-            }
-        }
-
-        (void)Unlock(gballocThreadSafeLock);
+        /* Codes_SRS_GBALLOC_01_030: [gballoc_malloc shall ensure thread safety by using the lock created by gballoc_Init.] */
+        /* Codes_SRS_GBALLOC_01_048: [If acquiring the lock fails, gballoc_malloc shall return NULL.] */
+        /* Codes_SRS_GBALLOC_01_004: [If the underlying malloc call is successful, gb_malloc shall increment the total memory used with the amount indicated by size.] */
+        /* Codes_SRS_GBALLOC_03_005: [ gballoc_malloc_at, gballoc_calloc_at and gballoc_realloc_at shall behave like gballoc_malloc, gballoc_calloc and gballoc_realloc. ]*/
+        result = track_new_allocation(allocation, result, size, get_callsite(file, line));
     }
 
     return result;
 }
 
 void* gballoc_calloc(size_t nmemb, size_t size)
+{
+    return gballoc_calloc_at(nmemb, size, NULL, 0);
+}
+
+void* gballoc_calloc_at(size_t nmemb, size_t size, const char* file, int line)
 {
     void* result;
+    ALLOCATION* allocation;
 
     if (gballocState != GBALLOC_STATE_INIT)
     {
         /* Codes_SRS_GBALLOC_01_040: [If gballoc was not initialized gballoc_calloc shall simply call calloc without any memory tracking being performed.] */
         result = calloc(nmemb, size);
     }
-    /* Codes_SRS_GBALLOC_01_031: [gballoc_calloc shall ensure thread safety by using the lock created by gballoc_Init]  */
-    else if (LOCK_OK != Lock(gballocThreadSafeLock))
+    else if ((allocation = (ALLOCATION*)malloc(sizeof(ALLOCATION))) == NULL)
     {
-        /* Codes_SRS_GBALLOC_01_046: [If acquiring the lock fails, gballoc_calloc shall return NULL.] */
-        LogError("Failed to get the Lock.");
         result = NULL;
     }
+    /* Codes_SRS_GBALLOC_01_020: [gballoc_calloc shall call the C99 calloc function and return its result.] */
+    else if ((result = calloc(nmemb, size)) == NULL)
+    {
+        /* Codes_SRS_GBALLOC_01_022: [When the underlying calloc call fails, gballoc_calloc shall return NULL and size should not be counted towards total memory used.] */
+        free(allocation);
+    }
     else
     {
-        ALLOCATION* allocation = (ALLOCATION*)malloc(sizeof(ALLOCATION));
-        if (allocation == NULL)
-        {
-            result = NULL;
-        }
-        else
-        {
-            /* Codes_SRS_GBALLOC_01_020: [gballoc_calloc shall call the C99 calloc function and return its result.] */
-            result = calloc(nmemb, size);
-            if (result == NULL)
-            {
-                /* Codes_SRS_GBALLOC_01_022: [When the underlying calloc call fails, gballoc_calloc shall return NULL and size should not be counted towards total memory used.] */
-                free(allocation);
-            }
-            else
-            {
-                /* Codes_SRS_GBALLOC_01_021: [If the underlying calloc call is successful, gballoc_calloc shall increment the total memory used with nmemb*size.] */
-                allocation->ptr = result;
-                allocation->size = nmemb * size;
-                allocation->next = head;
-                head = allocation;
-                g_allocations++;
-
-                totalSize += allocation->size;
-                /* Codes_SRS_GBALLOC_01_011: [The maximum total memory used shall be the maximum of the total memory used at any point.] */
-                if (maxSize < totalSize)
-                {
-                    maxSize = totalSize;
-                }
-            }
-        }
-
-        (void)Unlock(gballocThreadSafeLock);
+        /* Codes_SRS_GBALLOC_01_031: [gballoc_calloc shall ensure thread safety by using the lock created by gballoc_Init]  */
+        /* Codes_SRS_GBALLOC_01_046: [If acquiring the lock fails, gballoc_calloc shall return NULL.] */
+        /* Codes_SRS_GBALLOC_01_021: [If the underlying calloc call is successful, gballoc_calloc shall increment the total memory used with nmemb*size.] */
+        result = track_new_allocation(allocation, result, nmemb * size, get_callsite(file, line));
     }
 
     return result;
@@ -192,94 +569,124 @@ void* gballoc_calloc(size_t nmemb, size_t size)
 
 void* gballoc_realloc(void* ptr, size_t size)
 {
-    ALLOCATION* curr;
+    return gballoc_realloc_at(ptr, size, NULL, 0);
+}
+
+void* gballoc_realloc_at(void* ptr, size_t size, const char* file, int line)
+{
     void* result;
-    ALLOCATION* allocation = NULL;
+    ALLOCATION* allocation;
 
     if (gballocState != GBALLOC_STATE_INIT)
     {
         /* Codes_SRS_GBALLOC_01_041: [If gballoc was not initialized gballoc_realloc shall shall simply call realloc without any memory tracking being performed.] */
         result = realloc(ptr, size);
     }
-    /* Codes_SRS_GBALLOC_01_032: [gballoc_realloc shall ensure thread safety by using the lock created by gballoc_Init.] */
-    else if (LOCK_OK != Lock(gballocThreadSafeLock))
+    else if (ptr == NULL)
     {
-        /* Codes_SRS_GBALLOC_01_047: [If acquiring the lock fails, gballoc_realloc shall return NULL.] */
-        LogError("Failed to get the Lock.");
-        result = NULL;
-    }
-    else
-    {
-        if (ptr == NULL)
+        /* Codes_SRS_GBALLOC_01_017: [When ptr is NULL, gballoc_realloc shall call the underlying realloc with ptr being NULL and the realloc result shall be tracked by gballoc.] */
+        if ((allocation = (ALLOCATION*)malloc(sizeof(ALLOCATION))) == NULL)
+        {
+            /* Codes_SRS_GBALLOC_01_015: [When allocating memory used for tracking by gballoc_realloc fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
+            result = NULL;
+        }
+        else if ((result = realloc(NULL, size)) == NULL)
         {
-            /* Codes_SRS_GBALLOC_01_017: [When ptr is NULL, gballoc_realloc shall call the underlying realloc with ptr being NULL and the realloc result shall be tracked by gballoc.] */
-            allocation = (ALLOCATION*)malloc(sizeof(ALLOCATION));
+            /* Codes_SRS_GBALLOC_01_014: [When the underlying realloc call fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
+            free(allocation);
         }
         else
         {
-            curr = head;
-            while (curr != NULL)
-            {
-                if (curr->ptr == ptr)
-                {
-                    allocation = curr;
-                    break;
-                }
-                else
-                {
-                    curr = (ALLOCATION*)curr->next;
-                }
-            }
+            /* Codes_SRS_GBALLOC_01_032: [gballoc_realloc shall ensure thread safety by using the lock created by gballoc_Init.] */
+            /* Codes_SRS_GBALLOC_01_047: [If acquiring the lock fails, gballoc_realloc shall return NULL.] */
+            result = track_new_allocation(allocation, result, size, get_callsite(file, line));
         }
+    }
+    else
+    {
+        GBALLOC_SHARD* shard = get_shard(ptr);
 
-        if (allocation == NULL)
+        /* Codes_SRS_GBALLOC_01_032: [gballoc_realloc shall ensure thread safety by using the lock created by gballoc_Init.] */
+        if (LOCK_OK != Lock(shard->lock))
         {
-            /* Codes_SRS_GBALLOC_01_015: [When allocating memory used for tracking by gballoc_realloc fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
-            /* Codes_SRS_GBALLOC_01_016: [When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_realloc shall return NULL and the underlying realloc shall not be called.] */
+            /* Codes_SRS_GBALLOC_01_047: [If acquiring the lock fails, gballoc_realloc shall return NULL.] */
+            LogError("Failed to get the Lock.");
             result = NULL;
         }
         else
         {
-            result = realloc(ptr, size);
-            if (result == NULL)
+            ALLOCATION** link;
+
+            index_deferred_allocations(shard);
+            if ((allocation = find_allocation(shard, ptr, &link)) == NULL)
             {
-                /* Codes_SRS_GBALLOC_01_014: [When the underlying realloc call fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
-                if (ptr == NULL)
-                {
-                    free(allocation);
-                }
+                /* Codes_SRS_GBALLOC_01_016: [When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_realloc shall return NULL and the underlying realloc shall not be called.] */
+                result = NULL;
+                (void)Unlock(shard->lock);
             }
             else
             {
-                if (ptr != NULL)
+                size_t previousSize = allocation->size;
+
+                /* Codes_SRS_GBALLOC_03_017: [ gballoc_realloc shall take the block out of the allocation index and call the underlying realloc without holding any lock. ]*/
+                remove_allocation(shard, link);
+                uncount_allocation(allocation);
+                (void)Unlock(shard->lock);
+
+                /* Codes_SRS_GBALLOC_01_005: [gballoc_realloc shall call the C99 realloc function and return its result.] */
+                if ((result = realloc(ptr, size)) == NULL)
                 {
-                    /* Codes_SRS_GBALLOC_01_006: [If the underlying realloc call is successful, gballoc_realloc shall look up the size associated with the pointer ptr and decrease the total memory used with that size.] */
-                    allocation->ptr = result;
-                    totalSize -= allocation->size;
-                    allocation->size = size;
+                    /* Codes_SRS_GBALLOC_01_014: [When the underlying realloc call fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
+                    /* Codes_SRS_GBALLOC_03_018: [ If the underlying realloc fails, gballoc_realloc shall put the block back in the allocation index. ]*/
+                    /* Codes_SRS_GBALLOC_03_019: [ If acquiring the lock fails after the underlying realloc was called, gballoc_realloc shall keep the block in a list of its shard that is indexed the next time the lock of the shard is taken. ]*/
+                    defer_allocation(shard, allocation);
+                    if (LOCK_OK != Lock(shard->lock))
+                    {
+                        /* the block still belongs to the caller, it is indexed by the next holder of the lock */
+                        LogError("Failed to get the Lock, indexing allocation %p is deferred.", ptr);
+                    }
+                    else
+                    {
+                        index_deferred_allocations(shard);
+                        (void)Unlock(shard->lock);
+                    }
                 }
                 else
                 {
-                    /* add block */
+                    GBALLOC_SHARD* newShard = get_shard(result);
+                    GBALLOC_CALLSITE* previousCallsite = allocation->callsite;
+                    /* Codes_SRS_GBALLOC_03_007: [ When ptr is not NULL, gballoc_realloc_at shall move the accounting of the block from its previous callsite to the callsite identified by file and line. ]*/
+                    /* Codes_SRS_GBALLOC_03_008: [ gballoc_realloc shall keep the block accounted to its previous callsite. ]*/
+                    GBALLOC_CALLSITE* newCallsite = (file == NULL) ? previousCallsite : get_callsite(file, line);
+
+                    /* the block is indexed under its new address, which may belong to another shard */
                     allocation->ptr = result;
                     allocation->size = size;
-                    allocation->next = head;
-                    head = allocation;
-                }
+                    allocation->callsite = newCallsite;
 
-                /* Codes_SRS_GBALLOC_01_007: [If realloc is successful, gballoc_realloc shall also increment the total memory used value tracked by this module.] */
-                totalSize += size;
-                g_allocations++;
-
-                /* Codes_SRS_GBALLOC_01_011: [The maximum total memory used shall be the maximum of the total memory used at any point.] */
-                if (maxSize < totalSize)
-                {
-                    maxSize = totalSize;
+                    /* Codes_SRS_GBALLOC_01_006: [If the underlying realloc call is successful, gballoc_realloc shall look up the size associated with the pointer ptr and decrease the total memory used with that size.] */
+                    /* Codes_SRS_GBALLOC_01_007: [If realloc is successful, gballoc_realloc shall also increment the total memory used value tracked by this module.] */
+                    if (LOCK_OK != Lock(newShard->lock))
+                    {
+                        /* Codes_SRS_GBALLOC_03_019: [ If acquiring the lock fails after the underlying realloc was called, gballoc_realloc shall keep the block in a list of its shard that is indexed the next time the lock of the shard is taken. ]*/
+                        LogError("Failed to get the Lock, indexing allocation %p is deferred.", result);
+                        allocation->epoch = metricsEpoch;
+                        defer_allocation(newShard, allocation);
+                    }
+                    else
+                    {
+                        index_deferred_allocations(newShard);
+                        add_allocation(newShard, allocation);
+                        count_allocation(allocation);
+                        newShard->allocationCount++;
+                        (void)Unlock(newShard->lock);
+                    }
+
+                    remove_callsite_allocation(previousCallsite, previousSize);
+                    add_callsite_allocation(newCallsite, size);
                 }
             }
         }
-
-        (void)Unlock(gballocThreadSafeLock);
     }
 
     return result;
@@ -287,8 +694,7 @@ void* gballoc_realloc(void* ptr, size_t size)
 
 void gballoc_free(void* ptr)
 {
-    ALLOCATION* curr = head;
-    ALLOCATION* prev = NULL;
+    GBALLOC_SHARD* shard;
 
     if (gballocState != GBALLOC_STATE_INIT)
     {
@@ -296,53 +702,41 @@ void gballoc_free(void* ptr)
         free(ptr);
     }
     /* Codes_SRS_GBALLOC_01_033: [gballoc_free shall ensure thread safety by using the lock created by gballoc_Init.] */
-    else if (LOCK_OK != Lock(gballocThreadSafeLock))
+    else if (LOCK_OK != Lock((shard = get_shard(ptr))->lock))
     {
         /* Codes_SRS_GBALLOC_01_049: [If acquiring the lock fails, gballoc_free shall do nothing.] */
         LogError("Failed to get the Lock.");
     }
     else
     {
+        ALLOCATION** link;
+        ALLOCATION* curr;
+
         /* Codes_SRS_GBALLOC_01_009: [gballoc_free shall also look up the size associated with the ptr pointer and decrease the total memory used with the associated size amount.] */
-        while (curr != NULL)
+        index_deferred_allocations(shard);
+        curr = find_allocation(shard, ptr, &link);
+        if (curr != NULL)
         {
-            if (curr->ptr == ptr)
-            {
-                /* Codes_SRS_GBALLOC_01_008: [gballoc_free shall call the C99 free function.] */
-                free(ptr);
-                totalSize -= curr->size;
-                if (prev != NULL)
-                {
-                    prev->next = curr->next;
-                }
-                else
-                {
-                    head = (ALLOCATION*)curr->next;
-                }
-
-                free(curr);
-                break;
-            }
-
-            prev = curr;
-            curr = (ALLOCATION*)curr->next;
+            remove_allocation(shard, link);
+            uncount_allocation(curr);
         }
+        (void)Unlock(shard->lock);
 
-#ifdef _MSC_VER
-// Disable: Using uninitialized memory 'curr'
-#pragma warning(disable:6001)
-#endif
-        if ((curr == NULL) && (ptr != NULL))
+        if (curr != NULL)
+        {
+            /* Codes_SRS_GBALLOC_01_008: [gballoc_free shall call the C99 free function.] */
+            /* Codes_SRS_GBALLOC_03_004: [ gballoc_free shall call the underlying free after releasing the shard lock. ]*/
+            remove_callsite_allocation(curr->callsite, curr->size);
+            free(ptr);
+            free(curr);
+        }
+        else if (ptr != NULL)
         {
             /* Codes_SRS_GBALLOC_01_019: [When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_free shall not free any memory.] */
 
             /* could not find the allocation */
             LogError("Could not free allocation for address %p (not found)", ptr);
         }
-#ifdef _MSC_VER
-#pragma warning(default:6001)
-#endif
-        (void)Unlock(gballocThreadSafeLock);
     }
 }
 
@@ -356,18 +750,11 @@ size_t gballoc_getMaximumMemoryUsed(void)
         LogError("gballoc is not initialized.");
         result = SIZE_MAX;
     }
-    /* Codes_SRS_GBALLOC_01_034: [gballoc_getMaximumMemoryUsed shall ensure thread safety by using the lock created by gballoc_Init.]  */
-    else if (LOCK_OK != Lock(gballocThreadSafeLock))
-    {
-        /* Codes_SRS_GBALLOC_01_050: [If the lock cannot be acquired, gballoc_getMaximumMemoryUsed shall return SIZE_MAX.]  */
-        LogError("Failed to get the Lock.");
-        result = SIZE_MAX;
-    }
     else
     {
+        /* Codes_SRS_GBALLOC_01_034: [gballoc_getMaximumMemoryUsed shall ensure thread safety by reading the counter atomically, without taking any lock.]  */
         /* Codes_SRS_GBALLOC_01_010: [gballoc_getMaximumMemoryUsed shall return the maximum amount of total memory used recorded since the module initialization.] */
-        result = maxSize;
-        (void)Unlock(gballocThreadSafeLock);
+        result = GBALLOC_ATOMIC_LOAD(&maxSize);
     }
 
     return result;
@@ -383,18 +770,11 @@ size_t gballoc_getCurrentMemoryUsed(void)
         LogError("gballoc is not initialized.");
         result = SIZE_MAX;
     }
-    /* Codes_SRS_GBALLOC_01_036: [gballoc_getCurrentMemoryUsed shall ensure thread safety by using the lock created by gballoc_Init.]*/
-    else if (LOCK_OK != Lock(gballocThreadSafeLock))
-    {
-        /* Codes_SRS_GBALLOC_01_051: [If the lock cannot be acquired, gballoc_getCurrentMemoryUsed shall return SIZE_MAX.] */
-        LogError("Failed to get the Lock.");
-        result = SIZE_MAX;
-    }
     else
     {
+        /* Codes_SRS_GBALLOC_01_036: [gballoc_getCurrentMemoryUsed shall ensure thread safety by reading the counter atomically, without taking any lock.]*/
         /*Codes_SRS_GBALLOC_02_001: [gballoc_getCurrentMemoryUsed shall return the currently used memory size.] */
-        result = totalSize;
-        (void)Unlock(gballocThreadSafeLock);
+        result = GBALLOC_ATOMIC_LOAD(&totalSize);
     }
 
     return result;
@@ -410,18 +790,17 @@ size_t gballoc_getAllocationCount(void)
         LogError("gballoc is not initialized.");
         result = 0;
     }
-    /* Codes_SRS_GBALLOC_07_002: [ gballoc_getAllocationCount shall ensure thread safety by using the lock created by gballoc_Init ] */
-    else if (LOCK_OK != Lock(gballocThreadSafeLock))
-    {
-        /* Codes_SRS_GBALLOC_07_003: [ If the lock cannot be acquired, gballoc_getAllocationCount shall return 0. ] */
-        LogError("Failed to get the Lock.");
-        result = 0;
-    }
     else
     {
+        size_t i;
+
+        /* Codes_SRS_GBALLOC_07_002: [ gballoc_getAllocationCount shall ensure thread safety by adding up the per shard counters without taking any lock. ] */
         /* Codes_SRS_GBALLOC_07_004: [ gballoc_getAllocationCount shall return the currently number of allocations. ] */
-        result = g_allocations;
-        (void)Unlock(gballocThreadSafeLock);
+        result = 0;
+        for (i = 0; i < GBALLOC_SHARD_COUNT; i++)
+        {
+            result += shards[i].allocationCount;
+        }
     }
 
     return result;
@@ -434,19 +813,175 @@ void gballoc_resetMetrics(void)
     {
         LogError("gballoc is not initialized.");
     }
-    /* Codes_SRS_GBALLOC_07_006: [ gballoc_resetMetrics shall ensure thread safety by using the lock created by gballoc_Init ]*/
-    else if (LOCK_OK != Lock(gballocThreadSafeLock))
+    else
     {
-        /* Codes_SRS_GBALLOC_07_007: [ If the lock cannot be acquired, gballoc_reset Metrics shall do nothing.] */
-        LogError("Failed to get the Lock.");
+        size_t locked;
+
+        /* Codes_SRS_GBALLOC_07_006: [ gballoc_resetMetrics shall take the locks of all the shards, so that no allocation is counted partly before and partly after the reset. ]*/
+        for (locked = 0; locked < GBALLOC_SHARD_COUNT; locked++)
+        {
+            if (LOCK_OK != Lock(shards[locked].lock))
+            {
+                break;
+            }
+        }
+
+        if (locked < GBALLOC_SHARD_COUNT)
+        {
+            /* Codes_SRS_GBALLOC_07_009: [ If acquiring any of the shard locks fails, gballoc_resetMetrics shall release the locks it acquired and do nothing. ]*/
+            LogError("Failed to get the Lock.");
+        }
+        else
+        {
+            size_t i;
+
+            /* Codes_SRS_GBALLOC_07_008: [ gballoc_resetMetrics shall reset the total allocation size, max allocation size and number of allocation to zero. ] */
+            for (i = 0; i < GBALLOC_SHARD_COUNT; i++)
+            {
+                shards[i].allocationCount = 0;
+            }
+            set_counter(&totalSize, 0);
+            set_counter(&maxSize, 0);
+            metricsEpoch++;
+
+            /* Codes_SRS_GBALLOC_03_016: [ gballoc_resetMetrics shall set the peak bytes of every callsite to its live bytes and its allocation count to zero. ]*/
+            for (i = 0; i < GBALLOC_MAX_CALLSITES; i++)
+            {
+                if (GBALLOC_ATOMIC_LOAD(&callsites[i].state) == CALLSITE_READY)
+                {
+                    /* live bytes are left alone, the blocks they account for are still going to be freed */
+                    set_counter(&callsites[i].peakBytes, GBALLOC_ATOMIC_LOAD(&callsites[i].liveBytes));
+                    set_counter(&callsites[i].allocationCount, 0);
+                }
+            }
+        }
+
+        while (locked > 0)
+        {
+            locked--;
+            (void)Unlock(shards[locked].lock);
+        }
+    }
+}
+
+static size_t get_callsite_rank(const GBALLOC_CALLSITE_STATS* stats, GBALLOC_CALLSITE_SORT sort)
+{
+    size_t result;
+
+    switch (sort)
+    {
+    default:
+    case GBALLOC_CALLSITE_SORT_BY_LIVE_BYTES:
+        result = stats->liveBytes;
+        break;
+    case GBALLOC_CALLSITE_SORT_BY_PEAK_BYTES:
+        result = stats->peakBytes;
+        break;
+    case GBALLOC_CALLSITE_SORT_BY_ALLOCATION_COUNT:
+        result = stats->allocationCount;
+        break;
+    }
+
+    return result;
+}
+
+size_t gballoc_getTopCallsites(GBALLOC_CALLSITE_SORT sort, GBALLOC_CALLSITE_STATS* callsite_stats, size_t count)
+{
+    size_t result;
+
+    if ((callsite_stats == NULL) && (count > 0))
+    {
+        /* Codes_SRS_GBALLOC_03_009: [ If callsite_stats is NULL and count is not 0, gballoc_getTopCallsites shall return 0. ]*/
+        LogError("Invalid arguments: GBALLOC_CALLSITE_STATS* callsite_stats=%p, size_t count=%lu", callsite_stats, (unsigned long)count);
+        result = 0;
+    }
+    else if ((sort != GBALLOC_CALLSITE_SORT_BY_LIVE_BYTES) &&
+        (sort != GBALLOC_CALLSITE_SORT_BY_PEAK_BYTES) &&
+        (sort != GBALLOC_CALLSITE_SORT_BY_ALLOCATION_COUNT))
+    {
+        /* Codes_SRS_GBALLOC_03_010: [ If sort is not a GBALLOC_CALLSITE_SORT value, gballoc_getTopCallsites shall return 0. ]*/
+        LogError("Invalid sort %d", (int)sort);
+        result = 0;
+    }
+    else
+    {
+        size_t i;
+
+        result = 0;
+
+        /* Codes_SRS_GBALLOC_03_011: [ gballoc_getTopCallsites shall fill callsite_stats with the (at most) count callsites ranking highest by sort, in decreasing order, and return how many were filled. ]*/
+        /* Codes_SRS_GBALLOC_03_012: [ gballoc_getTopCallsites shall not take any lock. ]*/
+        for (i = 0; i < GBALLOC_MAX_CALLSITES; i++)
+        {
+            GBALLOC_CALLSITE* callsite = &callsites[i];
+
+            if (GBALLOC_ATOMIC_LOAD(&callsite->state) == CALLSITE_READY)
+            {
+                GBALLOC_CALLSITE_STATS stats;
+                size_t position;
+
+                stats.file = callsite->file;
+                stats.line = callsite->line;
+                stats.liveBytes = GBALLOC_ATOMIC_LOAD(&callsite->liveBytes);
+                stats.peakBytes = GBALLOC_ATOMIC_LOAD(&callsite->peakBytes);
+                stats.liveAllocations = GBALLOC_ATOMIC_LOAD(&callsite->liveAllocations);
+                stats.allocationCount = GBALLOC_ATOMIC_LOAD(&callsite->allocationCount);
+
+                /* count is expected to be small, so an insertion into the sorted output is enough */
+                position = result;
+                while ((position > 0) && (get_callsite_rank(&callsite_stats[position - 1], sort) < get_callsite_rank(&stats, sort)))
+                {
+                    if (position < count)
+                    {
+                        callsite_stats[position] = callsite_stats[position - 1];
+                    }
+                    position--;
+                }
+
+                if (position < count)
+                {
+                    callsite_stats[position] = stats;
+                    if (result < count)
+                    {
+                        result++;
+                    }
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+void gballoc_dumpTopCallsites(GBALLOC_CALLSITE_SORT sort, size_t count)
+{
+    GBALLOC_CALLSITE_STATS* callsite_stats;
+
+    if (count == 0)
+    {
+        /* Codes_SRS_GBALLOC_03_013: [ If count is 0, gballoc_dumpTopCallsites shall do nothing. ]*/
+    }
+    else if ((count > SIZE_MAX / sizeof(GBALLOC_CALLSITE_STATS)) ||
+        ((callsite_stats = (GBALLOC_CALLSITE_STATS*)malloc(count * sizeof(GBALLOC_CALLSITE_STATS))) == NULL))
+    {
+        /* Codes_SRS_GBALLOC_03_014: [ If allocating memory for the dump fails, gballoc_dumpTopCallsites shall do nothing. ]*/
+        LogError("Cannot allocate memory for %lu callsites", (unsigned long)count);
     }
     else
     {
-        /* Codes_SRS_GBALLOC_07_008: [ gballoc_resetMetrics shall reset the total allocation size, max allocation size and number of allocation to zero. ] */
-        totalSize = 0;
-        maxSize = 0;
-        g_allocations = 0;
-        (void)Unlock(gballocThreadSafeLock);
+        size_t filled = gballoc_getTopCallsites(sort, callsite_stats, count);
+        size_t i;
+
+        /* Codes_SRS_GBALLOC_03_015: [ gballoc_dumpTopCallsites shall log one line per callsite returned by gballoc_getTopCallsites for sort and count. ]*/
+        for (i = 0; i < filled; i++)
+        {
+            LogInfo("%s:%d live %lu bytes in %lu allocations, peak %lu bytes, %lu allocations",
+                callsite_stats[i].file, callsite_stats[i].line,
+                (unsigned long)callsite_stats[i].liveBytes, (unsigned long)callsite_stats[i].liveAllocations,
+                (unsigned long)callsite_stats[i].peakBytes, (unsigned long)callsite_stats[i].allocationCount);
+        }
+
+        free(callsite_stats);
     }
 }
 
@@ -29,10 +29,10 @@ HTTP_HEADERS_HANDLE HTTPHeaders_Alloc(void)
     else
     {
         /*Codes_SRS_HTTP_HEADERS_99_004:[ After a successful init, HTTPHeaders_GetHeaderCount shall report 0 existing headers.]*/
-        result->headers = Map_Create(NULL);
+        result->headers = Map_CreateWithInternedKeys(NULL);
         if (result->headers == NULL)
         {
-            LogError("Map_Create failed");
+            LogError("Map_CreateWithInternedKeys failed");
             free(result);
             result = NULL;
         }
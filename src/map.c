@@ -2,38 +2,232 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <stdlib.h>
+#include <stdint.h>
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/map.h"
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/strings.h"
+#include "azure_c_shared_utility/refcount.h"
+#include "azure_c_shared_utility/string_intern.h"
 
 DEFINE_ENUM_STRINGS(MAP_RESULT, MAP_RESULT_VALUES);
 
+/*a map of fewer keys than this is searched linearly, which is as fast as hashing for so few keys and costs no memory*/
+#define MAP_INDEX_MIN_COUNT 16
+
+/*one slot of the key index, position is the index of the key in keys + 1, 0 marks an empty slot*/
+typedef struct MAP_INDEX_SLOT_TAG
+{
+    uint32_t hash;
+    size_t position;
+}MAP_INDEX_SLOT;
+
 typedef struct MAP_HANDLE_DATA_TAG
 {
     char** keys;
     char** values;
     size_t count;
+    /*number of slots allocated in both keys and values, adds grow it geometrically so that it can be larger than count*/
+    size_t capacity;
     MAP_FILTER_CALLBACK mapFilterCallback;
+    /*open addressing hash table over keys, kept at most half full. keys and values stay in insertion order*/
+    MAP_INDEX_SLOT* index;
+    size_t indexSize;
+    /*non-NULL while keys, values and index are shared with clones of the map, they are then read-only and copied by the first write*/
+    struct MAP_SHARED_CONTENT_TAG* sharedContent;
+    /*the keys are canonical copies acquired from the string intern table instead of copies of their own*/
+    bool internedKeys;
 }MAP_HANDLE_DATA;
 
+/*the content a map shares with its clones, it is released by the last of them*/
+typedef struct MAP_SHARED_CONTENT_TAG
+{
+    char** keys;
+    char** values;
+    size_t count;
+    MAP_INDEX_SLOT* index;
+    bool internedKeys;
+}MAP_SHARED_CONTENT;
+
+DEFINE_REFCOUNT_TYPE(MAP_SHARED_CONTENT);
+
 #define LOG_MAP_ERROR LogError("result = %s", ENUM_TO_STRING(MAP_RESULT, result));
 
-MAP_HANDLE Map_Create(MAP_FILTER_CALLBACK mapFilterFunc)
+static MAP_HANDLE_DATA* Map_CreateInternal(MAP_FILTER_CALLBACK mapFilterFunc, bool internedKeys)
 {
-    /*Codes_SRS_MAP_02_001: [Map_Create shall create a new, empty map.]*/
     MAP_HANDLE_DATA* result = (MAP_HANDLE_DATA*)malloc(sizeof(MAP_HANDLE_DATA));
-    /*Codes_SRS_MAP_02_002: [If during creation there are any error, then Map_Create shall return NULL.]*/
     if (result != NULL)
     {
-        /*Codes_SRS_MAP_02_003: [Otherwise, it shall return a non-NULL handle that can be used in subsequent calls.] */
         result->keys = NULL;
         result->values = NULL;
         result->count = 0;
+        result->capacity = 0;
         result->mapFilterCallback = mapFilterFunc;
+        result->index = NULL;
+        result->indexSize = 0;
+        result->sharedContent = NULL;
+        result->internedKeys = internedKeys;
+    }
+    return result;
+}
+
+MAP_HANDLE Map_Create(MAP_FILTER_CALLBACK mapFilterFunc)
+{
+    /*Codes_SRS_MAP_02_001: [Map_Create shall create a new, empty map.]*/
+    /*Codes_SRS_MAP_02_002: [If during creation there are any error, then Map_Create shall return NULL.]*/
+    /*Codes_SRS_MAP_02_003: [Otherwise, it shall return a non-NULL handle that can be used in subsequent calls.] */
+    return (MAP_HANDLE)Map_CreateInternal(mapFilterFunc, false);
+}
+
+MAP_HANDLE Map_CreateWithInternedKeys(MAP_FILTER_CALLBACK mapFilterFunc)
+{
+    /*Codes_SRS_MAP_03_009: [ Map_CreateWithInternedKeys shall create a new, empty map whose keys are acquired from the string intern table instead of being copied. ]*/
+    /*Codes_SRS_MAP_03_010: [ If during creation there are any error, then Map_CreateWithInternedKeys shall return NULL. ]*/
+    return (MAP_HANDLE)Map_CreateInternal(mapFilterFunc, true);
+}
+
+/*FNV-1a*/
+static uint32_t Map_HashKey(const char* key)
+{
+    uint32_t result = 2166136261u;
+    while (*key != '\0')
+    {
+        result ^= (unsigned char)*key;
+        result *= 16777619u;
+        key++;
+    }
+    return result;
+}
+
+static void Map_IndexInsert(MAP_INDEX_SLOT* index, size_t indexSize, uint32_t hash, size_t position)
+{
+    size_t i = hash & (indexSize - 1);
+    while (index[i].position != 0)
+    {
+        i = (i + 1) & (indexSize - 1);
+    }
+    index[i].hash = hash;
+    index[i].position = position + 1;
+}
+
+/*replaces the key index with a new one of indexSize slots. On failure the map is left unchanged*/
+static int Map_BuildIndex(MAP_HANDLE_DATA* handleData, size_t indexSize)
+{
+    int result;
+    MAP_INDEX_SLOT* newIndex;
+    if ((indexSize > SIZE_MAX / sizeof(MAP_INDEX_SLOT)) ||
+        ((newIndex = (MAP_INDEX_SLOT*)malloc(indexSize * sizeof(MAP_INDEX_SLOT))) == NULL))
+    {
+        LogError("unable to allocate a key index of %lu slots", (unsigned long)indexSize);
+        result = __FAILURE__;
+    }
+    else
+    {
+        size_t i;
+        (void)memset(newIndex, 0, indexSize * sizeof(MAP_INDEX_SLOT));
+        for (i = 0; i < handleData->count; i++)
+        {
+            Map_IndexInsert(newIndex, indexSize, Map_HashKey(handleData->keys[i]), i);
+        }
+        if (handleData->index != NULL)
+        {
+            free(handleData->index);
+        }
+        handleData->index = newIndex;
+        handleData->indexSize = indexSize;
+        result = 0;
+    }
+    return result;
+}
+
+static void Map_DropIndex(MAP_HANDLE_DATA* handleData)
+{
+    if (handleData->index != NULL)
+    {
+        free(handleData->index);
+        handleData->index = NULL;
+        handleData->indexSize = 0;
+    }
+}
+
+/*keeps the key index in sync after the key at count - 1 has been added*/
+static void Map_IndexAdd(MAP_HANDLE_DATA* handleData)
+{
+    if (handleData->count < MAP_INDEX_MIN_COUNT)
+    {
+        /*small map, searched linearly*/
+    }
+    else if ((handleData->index == NULL) || (handleData->count > handleData->indexSize / 2))
+    {
+        size_t indexSize = (handleData->index == NULL) ? 2 * MAP_INDEX_MIN_COUNT : handleData->indexSize;
+        while ((indexSize / 2 < handleData->count) && (indexSize <= SIZE_MAX / 2))
+        {
+            indexSize *= 2;
+        }
+
+        if (Map_BuildIndex(handleData, indexSize) != 0)
+        {
+            /*the map stays usable, it is searched linearly until the index can be built*/
+            LogError("unable to grow the key index, falling back to a linear search");
+            Map_DropIndex(handleData);
+        }
+    }
+    else
+    {
+        Map_IndexInsert(handleData->index, handleData->indexSize, Map_HashKey(handleData->keys[handleData->count - 1]), handleData->count - 1);
+    }
+}
+
+/*keeps the key index in sync after a key has been removed and the following keys have moved down*/
+static void Map_IndexRemove(MAP_HANDLE_DATA* handleData)
+{
+    if (handleData->index != NULL)
+    {
+        if (handleData->count < MAP_INDEX_MIN_COUNT)
+        {
+            Map_DropIndex(handleData);
+        }
+        else
+        {
+            /*the positions of all the following keys changed, the index is rebuilt in place, which costs no more than the memmove of the keys*/
+            size_t i;
+            (void)memset(handleData->index, 0, handleData->indexSize * sizeof(MAP_INDEX_SLOT));
+            for (i = 0; i < handleData->count; i++)
+            {
+                Map_IndexInsert(handleData->index, handleData->indexSize, Map_HashKey(handleData->keys[i]), i);
+            }
+        }
+    }
+}
+
+static void Map_FreeKey(bool internedKeys, char* key)
+{
+    if (internedKeys)
+    {
+        string_intern_release(key);
+    }
+    else
+    {
+        free(key);
+    }
+}
+
+static void Map_FreeContent(char** keys, char** values, size_t count, MAP_INDEX_SLOT* index, bool internedKeys)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        Map_FreeKey(internedKeys, keys[i]);
+        free(values[i]);
+    }
+    free(keys);
+    free(values);
+    /*a small map has no index, this keeps the frees of a small map as they were*/
+    if (index != NULL)
+    {
+        free(index);
     }
-    return (MAP_HANDLE)result;
 }
 
 void Map_Destroy(MAP_HANDLE handle)
@@ -43,22 +237,30 @@ void Map_Destroy(MAP_HANDLE handle)
     {
         /*Codes_SRS_MAP_02_004: [Map_Destroy shall release all resources associated with the map.] */
         MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)handle;
-        size_t i;
 
-        for (i = 0; i < handleData->count; i++)
+        if (handleData->sharedContent == NULL)
         {
-            free(handleData->keys[i]);
-            free(handleData->values[i]);
+            Map_FreeContent(handleData->keys, handleData->values, handleData->count, handleData->index, handleData->internedKeys);
+        }
+        /*Codes_SRS_MAP_03_005: [If the content of the map is shared with clones, Map_Destroy shall release it only when the last map sharing it is destroyed.]*/
+        else if (DEC_REF(MAP_SHARED_CONTENT, handleData->sharedContent) == DEC_RETURN_ZERO)
+        {
+            MAP_SHARED_CONTENT* sharedContent = handleData->sharedContent;
+            Map_FreeContent(sharedContent->keys, sharedContent->values, sharedContent->count, sharedContent->index, sharedContent->internedKeys);
+            free(sharedContent);
+        }
+        else
+        {
+            /*other maps still use the content*/
         }
-        free(handleData->keys);
-        free(handleData->values);
         free(handleData);
     }
 }
 
 /*makes a copy of a vector of const char*, having size "size". source cannot be NULL*/
+/*interned strings are not copied, a new reference to them is acquired instead*/
 /*returns NULL if it fails*/
-static char** Map_CloneVector(const char*const * source, size_t count)
+static char** Map_CloneVector(const char*const * source, size_t count, bool interned)
 {
     char** result;
     result = (char**)malloc(count *sizeof(char*));
@@ -71,7 +273,15 @@ static char** Map_CloneVector(const char*const * source, size_t count)
         size_t i;
         for (i = 0; i < count; i++)
         {
-            if (mallocAndStrcpy_s(result + i, source[i]) != 0)
+            if (interned)
+            {
+                /*Codes_SRS_MAP_03_013: [ A map with interned keys that copies its shared content shall acquire a new reference to each of its keys instead of copying them. ]*/
+                if ((result[i] = (char*)string_intern_acquire(source[i])) == NULL)
+                {
+                    break;
+                }
+            }
+            else if (mallocAndStrcpy_s(result + i, source[i]) != 0)
             {
                 break;
             }
@@ -86,7 +296,7 @@ static char** Map_CloneVector(const char*const * source, size_t count)
             size_t j;
             for (j = 0; j < i; j++)
             {
-                free(result[j]);
+                Map_FreeKey(interned, result[j]);
             }
             free(result);
             result = NULL;
@@ -95,6 +305,81 @@ static char** Map_CloneVector(const char*const * source, size_t count)
     return result;
 }
 
+/*gives the map its own copy of a content shared with clones, called before every write. On failure the map is left unchanged*/
+static int Map_Unshare(MAP_HANDLE_DATA* handleData)
+{
+    int result;
+    if (handleData->sharedContent == NULL)
+    {
+        result = 0;
+    }
+    else if (((REFCOUNT_TYPE(MAP_SHARED_CONTENT)*)handleData->sharedContent)->count == 1)
+    {
+        /*Codes_SRS_MAP_03_007: [If the map is the last one using a shared content, the write shall take ownership of the content without copying it.]*/
+        free(handleData->sharedContent);
+        handleData->sharedContent = NULL;
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_MAP_03_006: [Before Map_Add, Map_AddOrUpdate or Map_Delete changes a map that shares its content with clones, it shall make a copy of the keys and values of the map.]*/
+        char** keys;
+        char** values;
+        if ((keys = Map_CloneVector((const char* const*)handleData->keys, handleData->count, handleData->internedKeys)) == NULL)
+        {
+            /*Codes_SRS_MAP_03_008: [If copying the content fails, the write shall fail and leave the map unchanged.]*/
+            LogError("unable to copy the keys of a shared map");
+            result = __FAILURE__;
+        }
+        else if ((values = Map_CloneVector((const char* const*)handleData->values, handleData->count, false)) == NULL)
+        {
+            size_t i;
+            /*Codes_SRS_MAP_03_008: [If copying the content fails, the write shall fail and leave the map unchanged.]*/
+            LogError("unable to copy the values of a shared map");
+            for (i = 0; i < handleData->count; i++)
+            {
+                Map_FreeKey(handleData->internedKeys, keys[i]);
+            }
+            free(keys);
+            result = __FAILURE__;
+        }
+        else
+        {
+            MAP_SHARED_CONTENT* sharedContent = handleData->sharedContent;
+            MAP_INDEX_SLOT* index = NULL;
+            if (handleData->index == NULL)
+            {
+                /*small map, searched linearly*/
+            }
+            else if ((index = (MAP_INDEX_SLOT*)malloc(handleData->indexSize * sizeof(MAP_INDEX_SLOT))) == NULL)
+            {
+                /*the map stays usable, it is searched linearly until the index can be built*/
+                LogError("unable to copy the key index of a shared map, falling back to a linear search");
+            }
+            else
+            {
+                (void)memcpy(index, handleData->index, handleData->indexSize * sizeof(MAP_INDEX_SLOT));
+            }
+
+            handleData->keys = keys;
+            handleData->values = values;
+            handleData->capacity = handleData->count;
+            handleData->index = index;
+            handleData->indexSize = (index == NULL) ? 0 : handleData->indexSize;
+            handleData->sharedContent = NULL;
+
+            /*the other maps might have been destroyed meanwhile*/
+            if (DEC_REF(MAP_SHARED_CONTENT, sharedContent) == DEC_RETURN_ZERO)
+            {
+                Map_FreeContent(sharedContent->keys, sharedContent->values, sharedContent->count, sharedContent->index, sharedContent->internedKeys);
+                free(sharedContent);
+            }
+            result = 0;
+        }
+    }
+    return result;
+}
+
 /*Codes_SRS_MAP_02_039: [Map_Clone shall make a copy of the map indicated by parameter handle and return a non-NULL handle to it.]*/
 MAP_HANDLE Map_Clone(MAP_HANDLE handle)
 {
@@ -117,40 +402,58 @@ MAP_HANDLE Map_Clone(MAP_HANDLE handle)
         }
         else
         {
+            result->index = NULL;
+            result->indexSize = 0;
+            result->sharedContent = NULL;
+            /*Codes_SRS_MAP_03_014: [ The clone of a map with interned keys shall have interned keys. ]*/
+            result->internedKeys = handleData->internedKeys;
             if (handleData->count == 0)
             {
                 result->count = 0;
+                result->capacity = 0;
                 result->keys = NULL;
                 result->values = NULL;
                 result->mapFilterCallback = NULL;
             }
             else
             {
-                result->mapFilterCallback = handleData->mapFilterCallback;
-                result->count = handleData->count;
-                if( (result->keys = Map_CloneVector((const char* const*)handleData->keys, handleData->count))==NULL)
+                /*Codes_SRS_MAP_03_004: [Map_Clone shall share the keys and values of the map with the clone instead of copying them, the first clone of a map shall allocate their reference count.]*/
+                if (handleData->sharedContent == NULL)
                 {
-                    /*Codes_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-                    LogError("unable to clone keys");
-                    free(result);
-                    result = NULL;
+                    /*the reference count starts at 1, which is the reference of the source*/
+                    MAP_SHARED_CONTENT* sharedContent = REFCOUNT_TYPE_CREATE(MAP_SHARED_CONTENT);
+                    if (sharedContent == NULL)
+                    {
+                        LogError("unable to allocate the shared content");
+                    }
+                    else
+                    {
+                        sharedContent->keys = handleData->keys;
+                        sharedContent->values = handleData->values;
+                        sharedContent->count = handleData->count;
+                        sharedContent->index = handleData->index;
+                        sharedContent->internedKeys = handleData->internedKeys;
+                        handleData->sharedContent = sharedContent;
+                    }
                 }
-                else if ((result->values = Map_CloneVector((const char* const*)handleData->values, handleData->count)) == NULL)
+
+                if (handleData->sharedContent == NULL)
                 {
-                    size_t i;
                     /*Codes_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-                    LogError("unable to clone values");
-                    for (i = 0; i < result->count; i++)
-                    {
-                        free(result->keys[i]);
-                    }
-                    free(result->keys);
                     free(result);
                     result = NULL;
                 }
                 else
                 {
-                    /*all fine, return it*/
+                    INC_REF(MAP_SHARED_CONTENT, handleData->sharedContent);
+                    result->mapFilterCallback = handleData->mapFilterCallback;
+                    result->count = handleData->count;
+                    result->capacity = handleData->capacity;
+                    result->keys = handleData->keys;
+                    result->values = handleData->values;
+                    result->index = handleData->index;
+                    result->indexSize = handleData->indexSize;
+                    result->sharedContent = handleData->sharedContent;
                 }
             }
         }
@@ -158,54 +461,68 @@ MAP_HANDLE Map_Clone(MAP_HANDLE handle)
     return (MAP_HANDLE)result;
 }
 
+/*makes room for one more key and value, growing the capacity geometrically so that a series of adds costs amortized O(1) reallocs*/
 static int Map_IncreaseStorageKeysValues(MAP_HANDLE_DATA* handleData)
 {
     int result;
-    char** newKeys = (char**)realloc(handleData->keys, (handleData->count + 1) * sizeof(char*));
-    if (newKeys == NULL)
+    if (handleData->count < handleData->capacity)
     {
-        LogError("realloc error");
-        result = __FAILURE__;
+        /*Codes_SRS_MAP_03_016: [ If the capacity of the map is enough for one more key, adding a key shall not allocate memory for the keys and values arrays. ]*/
+        handleData->keys[handleData->count] = NULL;
+        handleData->values[handleData->count] = NULL;
+        handleData->count++;
+        result = 0;
     }
     else
     {
-        char** newValues;
-        handleData->keys = newKeys;
-        handleData->keys[handleData->count] = NULL;
-        newValues = (char**)realloc(handleData->values, (handleData->count + 1) * sizeof(char*));
-        if (newValues == NULL)
+        /*Codes_SRS_MAP_03_015: [ If the capacity of the map is not enough for one more key, the keys and values arrays shall be reallocated to the larger of count + 1 and twice the capacity. ]*/
+        size_t newCapacity = (handleData->capacity > SIZE_MAX / (2 * sizeof(char*))) ? handleData->count + 1 : handleData->capacity * 2;
+        char** newKeys;
+        if (newCapacity < handleData->count + 1)
+        {
+            newCapacity = handleData->count + 1;
+        }
+
+        if ((newCapacity > SIZE_MAX / sizeof(char*)) ||
+            ((newKeys = (char**)realloc(handleData->keys, newCapacity * sizeof(char*))) == NULL))
         {
             LogError("realloc error");
-            if (handleData->count == 0) /*avoiding an implementation defined behavior */
-            {
-                free(handleData->keys);
-                handleData->keys = NULL;
-            }
-            else
+            result = __FAILURE__;
+        }
+        else
+        {
+            char** newValues;
+            handleData->keys = newKeys;
+            newValues = (char**)realloc(handleData->values, newCapacity * sizeof(char*));
+            if (newValues == NULL)
             {
-                char** undoneKeys = (char**)realloc(handleData->keys, (handleData->count) * sizeof(char*));
-                if (undoneKeys == NULL)
+                LogError("realloc error");
+                if (handleData->count == 0) /*avoiding an implementation defined behavior */
                 {
-                    LogError("CATASTROPHIC error, unable to undo through realloc to a smaller size");
+                    free(handleData->keys);
+                    handleData->keys = NULL;
                 }
                 else
                 {
-                    handleData->keys = undoneKeys;
+                    /*the keys array stays at its larger size, capacity is the number of slots both arrays have*/
                 }
+                result = __FAILURE__;
+            }
+            else
+            {
+                handleData->values = newValues;
+                handleData->capacity = newCapacity;
+                handleData->keys[handleData->count] = NULL;
+                handleData->values[handleData->count] = NULL;
+                handleData->count++;
+                result = 0;
             }
-            result = __FAILURE__;
-        }
-        else
-        {
-            handleData->values = newValues;
-            handleData->values[handleData->count] = NULL;
-            handleData->count++;
-            result = 0;
         }
     }
     return result;
 }
 
+/*forgets the key and value at count - 1, the capacity is kept for the next adds until the map becomes empty*/
 static void Map_DecreaseStorageKeysValues(MAP_HANDLE_DATA* handleData)
 {
     if (handleData->count == 1)
@@ -215,36 +532,22 @@ static void Map_DecreaseStorageKeysValues(MAP_HANDLE_DATA* handleData)
         free(handleData->values);
         handleData->values = NULL;
         handleData->count = 0;
+        handleData->capacity = 0;
         handleData->mapFilterCallback = NULL;
     }
     else
     {
         /*certainly > 1...*/
-        char** undoneValues;
-        char** undoneKeys = (char**)realloc(handleData->keys, sizeof(char*)* (handleData->count - 1));
-        if (undoneKeys == NULL)
-        {
-            LogError("CATASTROPHIC error, unable to undo through realloc to a smaller size");
-        }
-        else
-        {
-            handleData->keys = undoneKeys;
-        }
-
-        undoneValues = (char**)realloc(handleData->values, sizeof(char*)* (handleData->count - 1));
-        if (undoneValues == NULL)
-        {
-            LogError("CATASTROPHIC error, unable to undo through realloc to a smaller size");
-        }
-        else
-        {
-            handleData->values = undoneValues;
-        }
-
         handleData->count--;
     }
 }
 
+/*the keys of a map with interned keys are canonical pointers, a caller holding the canonical copy of key is answered without comparing characters*/
+static bool Map_KeyEquals(const char* storedKey, const char* key)
+{
+    return (storedKey == key) || (strcmp(storedKey, key) == 0);
+}
+
 static char** findKey(MAP_HANDLE_DATA* handleData, const char* key)
 {
     char** result;
@@ -252,13 +555,31 @@ static char** findKey(MAP_HANDLE_DATA* handleData, const char* key)
     {
         result = NULL;
     }
+    else if (handleData->index != NULL)
+    {
+        uint32_t hash = Map_HashKey(key);
+        size_t i = hash & (handleData->indexSize - 1);
+        result = NULL;
+        while (handleData->index[i].position != 0)
+        {
+            char** candidate = handleData->keys + (handleData->index[i].position - 1);
+            /*Codes_SRS_MAP_03_012: [ A map shall compare a key with its keys by pointer first, and compare the characters only if the pointers differ. ]*/
+            if ((handleData->index[i].hash == hash) && Map_KeyEquals(*candidate, key))
+            {
+                result = candidate;
+                break;
+            }
+            i = (i + 1) & (handleData->indexSize - 1);
+        }
+    }
     else
     {
         size_t i;
         result = NULL;
         for (i = 0; i < handleData->count; i++)
         {
-            if (strcmp(handleData->keys[i], key) == 0)
+            /*Codes_SRS_MAP_03_012: [ A map shall compare a key with its keys by pointer first, and compare the characters only if the pointers differ. ]*/
+            if (Map_KeyEquals(handleData->keys[i], key))
             {
                 result = handleData->keys + i;
                 break;
@@ -294,29 +615,44 @@ static char** findValue(MAP_HANDLE_DATA* handleData, const char* value)
 static int insertNewKeyValue(MAP_HANDLE_DATA* handleData, const char* key, const char* value)
 {
     int result;
-    if (Map_IncreaseStorageKeysValues(handleData) != 0) /*this increases handleData->count*/
+    if (Map_Unshare(handleData) != 0)
+    {
+        result = __FAILURE__;
+    }
+    else if (Map_IncreaseStorageKeysValues(handleData) != 0) /*this increases handleData->count*/
     {
         result = __FAILURE__;
     }
     else
     {
-        if (mallocAndStrcpy_s(&(handleData->keys[handleData->count - 1]), key) != 0)
+        if (handleData->internedKeys)
+        {
+            /*Codes_SRS_MAP_03_011: [ A map with interned keys shall store the canonical copy of each key acquired from the string intern table. ]*/
+            handleData->keys[handleData->count - 1] = (char*)string_intern_acquire(key);
+        }
+        else if (mallocAndStrcpy_s(&(handleData->keys[handleData->count - 1]), key) != 0)
+        {
+            handleData->keys[handleData->count - 1] = NULL;
+        }
+
+        if (handleData->keys[handleData->count - 1] == NULL)
         {
             Map_DecreaseStorageKeysValues(handleData);
-            LogError("unable to mallocAndStrcpy_s");
+            LogError("unable to store the key");
             result = __FAILURE__;
         }
         else
         {
             if (mallocAndStrcpy_s(&(handleData->values[handleData->count - 1]), value) != 0)
             {
-                free(handleData->keys[handleData->count - 1]);
+                Map_FreeKey(handleData->internedKeys, handleData->keys[handleData->count - 1]);
                 Map_DecreaseStorageKeysValues(handleData);
                 LogError("unable to mallocAndStrcpy_s");
                 result = __FAILURE__;
             }
             else
             {
+                Map_IndexAdd(handleData);
                 result = 0;
             }
         }
@@ -419,9 +755,14 @@ MAP_RESULT Map_AddOrUpdate(MAP_HANDLE handle, const char* key, const char* value
                 /*Codes_SRS_MAP_02_016: [If the key already exists, then Map_AddOrUpdate shall overwrite the value of the existing key with parameter value.]*/
                 size_t index = whereIsIt - handleData->keys;
                 size_t valueLength = strlen(value);
+                char* newValue;
+                if (Map_Unshare(handleData) != 0)
+                {
+                    result = MAP_ERROR;
+                    LOG_MAP_ERROR;
+                }
                 /*try to realloc value of this key*/
-                char* newValue = (char*)realloc(handleData->values[index],valueLength  + 1);
-                if (newValue == NULL)
+                else if ((newValue = (char*)realloc(handleData->values[index], valueLength + 1)) == NULL)
                 {
                     result = MAP_ERROR;
                     LOG_MAP_ERROR;
@@ -463,14 +804,24 @@ MAP_RESULT Map_Delete(MAP_HANDLE handle, const char* key)
         }
         else
         {
-            /*Codes_SRS_MAP_02_023: [Otherwise, Map_Delete shall remove the key and its associated value from the map and return MAP_OK.]*/
             size_t index = whereIsIt - handleData->keys;
-            free(handleData->keys[index]);
-            free(handleData->values[index]);
-            memmove(handleData->keys + index, handleData->keys + index + 1, (handleData->count - index - 1)*sizeof(char*)); /*if order doesn't matter... then this can be optimized*/
-            memmove(handleData->values + index, handleData->values + index + 1, (handleData->count - index - 1)*sizeof(char*));
-            Map_DecreaseStorageKeysValues(handleData);
-            result = MAP_OK;
+            if (Map_Unshare(handleData) != 0)
+            {
+                /*Codes_SRS_MAP_03_008: [If copying the content fails, the write shall fail and leave the map unchanged.]*/
+                result = MAP_ERROR;
+                LOG_MAP_ERROR;
+            }
+            else
+            {
+                /*Codes_SRS_MAP_02_023: [Otherwise, Map_Delete shall remove the key and its associated value from the map and return MAP_OK.]*/
+                Map_FreeKey(handleData->internedKeys, handleData->keys[index]);
+                free(handleData->values[index]);
+                memmove(handleData->keys + index, handleData->keys + index + 1, (handleData->count - index - 1)*sizeof(char*)); /*if order doesn't matter... then this can be optimized*/
+                memmove(handleData->values + index, handleData->values + index + 1, (handleData->count - index - 1)*sizeof(char*));
+                Map_DecreaseStorageKeysValues(handleData);
+                Map_IndexRemove(handleData);
+                result = MAP_OK;
+            }
         }
 
     }
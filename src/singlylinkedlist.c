@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/slab.h"
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xlogging.h"
 
@@ -13,10 +14,14 @@ typedef struct LIST_ITEM_INSTANCE_TAG
     void* next;
 } LIST_ITEM_INSTANCE;
 
+/* nodes are recycled through a slab owned by the list, so adding and removing items does not go to the heap in steady state */
+#define LIST_NODES_PER_CHUNK 8
+
 typedef struct SINGLYLINKEDLIST_INSTANCE_TAG
 {
     LIST_ITEM_INSTANCE* head;
     LIST_ITEM_INSTANCE* tail;
+    SLAB_HANDLE node_slab;
 } LIST_INSTANCE;
 
 SINGLYLINKEDLIST_HANDLE singlylinkedlist_create(void)
@@ -27,9 +32,10 @@ SINGLYLINKEDLIST_HANDLE singlylinkedlist_create(void)
     result = (LIST_INSTANCE*)malloc(sizeof(LIST_INSTANCE));
     if (result != NULL)
     {
-        /* Codes_SRS_LIST_01_002: [If any error occurs during the list creation, singlylinkedlist_create shall return NULL.] */
         result->head = NULL;
         result->tail = NULL;
+        /* Codes_SRS_LIST_03_001: [singlylinkedlist_create shall not create the slab for the list nodes, so that a list that never has an item added does not hold a slab.] */
+        result->node_slab = NULL;
     }
 
     return result;
@@ -42,17 +48,12 @@ void singlylinkedlist_destroy(SINGLYLINKEDLIST_HANDLE list)
     {
         LIST_INSTANCE* list_instance = (LIST_INSTANCE*)list;
 
-        while (list_instance->head != NULL)
+        /* Codes_SRS_LIST_01_003: [singlylinkedlist_destroy shall free all resources associated with the list identified by the handle argument.] */
+        /* Codes_SRS_LIST_03_002: [If the slab for the list nodes was created, singlylinkedlist_destroy shall free all the nodes at once by calling slab_destroy.] */
+        if (list_instance->node_slab != NULL)
         {
-#pragma warning(push)
-#pragma warning(disable:6001)
-            LIST_ITEM_INSTANCE* current_item = list_instance->head;
-            list_instance->head = (LIST_ITEM_INSTANCE*)current_item->next;
-            free(current_item);
-#pragma warning(pop) // C6001
+            slab_destroy(list_instance->node_slab);
         }
-
-        /* Codes_SRS_LIST_01_003: [singlylinkedlist_destroy shall free all resources associated with the list identified by the handle argument.] */
         free(list_instance);
     }
 }
@@ -71,9 +72,17 @@ LIST_ITEM_HANDLE singlylinkedlist_add(SINGLYLINKEDLIST_HANDLE list, const void*
     else
     {
         LIST_INSTANCE* list_instance = (LIST_INSTANCE*)list;
-        result = (LIST_ITEM_INSTANCE*)malloc(sizeof(LIST_ITEM_INSTANCE));
 
-        if (result == NULL)
+        /* Codes_SRS_LIST_03_005: [If the slab for the list nodes was not created yet, singlylinkedlist_add shall create it by calling slab_create.] */
+        if ((list_instance->node_slab == NULL) &&
+            ((list_instance->node_slab = slab_create(sizeof(LIST_ITEM_INSTANCE), LIST_NODES_PER_CHUNK)) == NULL))
+        {
+            /* Codes_SRS_LIST_03_006: [If creating the slab fails, singlylinkedlist_add shall return NULL.] */
+            LogError("Cannot create the slab for the list nodes");
+            result = NULL;
+        }
+        /* Codes_SRS_LIST_03_003: [singlylinkedlist_add shall allocate the new list node by calling slab_malloc.] */
+        else if ((result = (LIST_ITEM_INSTANCE*)slab_malloc(list_instance->node_slab)) == NULL)
         {
             /* Codes_SRS_LIST_01_007: [If allocating the new list node fails, singlylinkedlist_add shall return NULL.] */
             result = NULL;
@@ -135,7 +144,8 @@ int singlylinkedlist_remove(SINGLYLINKEDLIST_HANDLE list, LIST_ITEM_HANDLE item)
                     list_instance->tail = previous_item;
                 }
 
-                free(current_item);
+                /* Codes_SRS_LIST_03_004: [Removed nodes shall be returned to the slab by calling slab_free.] */
+                slab_free(list_instance->node_slab, current_item);
 
                 break;
             }
@@ -313,7 +323,8 @@ int singlylinkedlist_remove_if(SINGLYLINKEDLIST_HANDLE list, LIST_CONDITION_FUNC
                     list_instance->tail = previous_item;
                 }
 
-                free(current_item);
+                /* Codes_SRS_LIST_03_004: [Removed nodes shall be returned to the slab by calling slab_free.] */
+                slab_free(list_instance->node_slab, current_item);
             }
             /* Codes_SRS_LIST_09_005: [ If the condition function returns false, singlylinkedlist_find shall consider that item as not to be removed. ] */
             else
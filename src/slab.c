@@ -0,0 +1,283 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/slab.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+/* every object handed out is aligned for the most demanding of these types */
+typedef union SLAB_ALIGN_TAG
+{
+    void* pointer;
+    void (*function)(void);
+    long long integer;
+    long double floating;
+} SLAB_ALIGN;
+
+#define SLAB_ALIGNMENT sizeof(SLAB_ALIGN)
+#define SLAB_ROUND_UP(size) ((((size) + SLAB_ALIGNMENT - 1) / SLAB_ALIGNMENT) * SLAB_ALIGNMENT)
+
+/* a free object stores the link to the next free object of its chunk in its own first bytes */
+typedef struct SLAB_FREE_OBJECT_TAG
+{
+    struct SLAB_FREE_OBJECT_TAG* next;
+} SLAB_FREE_OBJECT;
+
+/* a chunk is in the available list of the slab while it has objects to hand out and in the full list otherwise, so that it can be released
+   as soon as none of its objects is in use */
+typedef struct SLAB_CHUNK_TAG
+{
+    struct SLAB_CHUNK_TAG* previous;
+    struct SLAB_CHUNK_TAG* next;
+    SLAB_FREE_OBJECT* free_objects;
+    /* the objects that were never handed out, carved one at a time so that a chunk costs nothing until used */
+    unsigned char* next_unused;
+    size_t unused_count;
+    size_t used_count;
+} SLAB_CHUNK;
+
+/* every object is preceded by the chunk it belongs to, so that slab_free finds the chunk without searching */
+typedef struct SLAB_OBJECT_HEADER_TAG
+{
+    SLAB_CHUNK* chunk;
+} SLAB_OBJECT_HEADER;
+
+#define SLAB_CHUNK_HEADER_SIZE SLAB_ROUND_UP(sizeof(SLAB_CHUNK))
+#define SLAB_OBJECT_HEADER_SIZE SLAB_ROUND_UP(sizeof(SLAB_OBJECT_HEADER))
+
+typedef struct SLAB_TAG
+{
+    SLAB_CHUNK* available_chunks;
+    SLAB_CHUNK* full_chunks;
+    /* one chunk none of whose objects is in use is kept, so that a slab going back and forth around a chunk boundary does not reach the heap */
+    SLAB_CHUNK* empty_chunk;
+    /* the size of an object with its header */
+    size_t slot_size;
+    size_t objects_per_chunk;
+} SLAB;
+
+static void link_chunk(SLAB_CHUNK** list, SLAB_CHUNK* chunk)
+{
+    chunk->previous = NULL;
+    chunk->next = *list;
+    if (*list != NULL)
+    {
+        (*list)->previous = chunk;
+    }
+    *list = chunk;
+}
+
+static void unlink_chunk(SLAB_CHUNK** list, SLAB_CHUNK* chunk)
+{
+    if (chunk->previous != NULL)
+    {
+        chunk->previous->next = chunk->next;
+    }
+    else
+    {
+        *list = chunk->next;
+    }
+
+    if (chunk->next != NULL)
+    {
+        chunk->next->previous = chunk->previous;
+    }
+}
+
+static void free_chunks(SLAB_CHUNK* chunk)
+{
+    while (chunk != NULL)
+    {
+        SLAB_CHUNK* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+}
+
+SLAB_HANDLE slab_create(size_t object_size, size_t objects_per_chunk)
+{
+    SLAB* result;
+
+    if (object_size == 0)
+    {
+        /* Codes_SRS_SLAB_03_001: [ If object_size is 0, slab_create shall fail and return NULL. ]*/
+        LogError("Invalid argument: size_t object_size=0");
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_SLAB_03_002: [ If objects_per_chunk is 0, slab_create shall use SLAB_DEFAULT_OBJECTS_PER_CHUNK. ]*/
+        if (objects_per_chunk == 0)
+        {
+            objects_per_chunk = SLAB_DEFAULT_OBJECTS_PER_CHUNK;
+        }
+
+        /* a free object has to hold the free list link */
+        if (object_size < sizeof(SLAB_FREE_OBJECT))
+        {
+            object_size = sizeof(SLAB_FREE_OBJECT);
+        }
+
+        if ((object_size > SIZE_MAX - SLAB_ALIGNMENT - SLAB_OBJECT_HEADER_SIZE) ||
+            (SLAB_OBJECT_HEADER_SIZE + SLAB_ROUND_UP(object_size) > (SIZE_MAX - SLAB_CHUNK_HEADER_SIZE) / objects_per_chunk))
+        {
+            /* Codes_SRS_SLAB_03_004: [ If any error occurs, slab_create shall fail and return NULL. ]*/
+            LogError("Chunk size overflows: object_size=%lu, objects_per_chunk=%lu", (unsigned long)object_size, (unsigned long)objects_per_chunk);
+            result = NULL;
+        }
+        /* Codes_SRS_SLAB_03_003: [ slab_create shall allocate the slab and return a non-NULL handle, no chunk shall be allocated until the first slab_malloc. ]*/
+        else if ((result = (SLAB*)malloc(sizeof(SLAB))) == NULL)
+        {
+            /* Codes_SRS_SLAB_03_004: [ If any error occurs, slab_create shall fail and return NULL. ]*/
+            LogError("Cannot allocate slab");
+        }
+        else
+        {
+            result->available_chunks = NULL;
+            result->full_chunks = NULL;
+            result->empty_chunk = NULL;
+            result->slot_size = SLAB_OBJECT_HEADER_SIZE + SLAB_ROUND_UP(object_size);
+            result->objects_per_chunk = objects_per_chunk;
+        }
+    }
+
+    return result;
+}
+
+void slab_destroy(SLAB_HANDLE slab)
+{
+    if (slab == NULL)
+    {
+        /* Codes_SRS_SLAB_03_005: [ If slab is NULL, slab_destroy shall return. ]*/
+        LogError("Invalid argument: SLAB_HANDLE slab=%p", slab);
+    }
+    else
+    {
+        /* Codes_SRS_SLAB_03_006: [ slab_destroy shall free all the chunks of the slab, whether their objects were freed or not, and the slab itself. ]*/
+        free_chunks(slab->available_chunks);
+        free_chunks(slab->full_chunks);
+        free(slab->empty_chunk);
+        free(slab);
+    }
+}
+
+void* slab_malloc(SLAB_HANDLE slab)
+{
+    void* result;
+
+    if (slab == NULL)
+    {
+        /* Codes_SRS_SLAB_03_007: [ If slab is NULL, slab_malloc shall fail and return NULL. ]*/
+        LogError("Invalid argument: SLAB_HANDLE slab=%p", slab);
+        result = NULL;
+    }
+    else
+    {
+        SLAB_CHUNK* chunk = slab->available_chunks;
+
+        if (chunk == NULL)
+        {
+            if (slab->empty_chunk != NULL)
+            {
+                chunk = slab->empty_chunk;
+                slab->empty_chunk = NULL;
+            }
+            /* Codes_SRS_SLAB_03_010: [ If all objects of the slab are in use, slab_malloc shall allocate a new chunk of objects_per_chunk objects. ]*/
+            else if ((chunk = (SLAB_CHUNK*)malloc(SLAB_CHUNK_HEADER_SIZE + (slab->slot_size * slab->objects_per_chunk))) == NULL)
+            {
+                /* Codes_SRS_SLAB_03_011: [ If allocating the chunk fails, slab_malloc shall fail and return NULL. ]*/
+                LogError("Cannot allocate slab chunk");
+            }
+            else
+            {
+                chunk->free_objects = NULL;
+                chunk->next_unused = (unsigned char*)chunk + SLAB_CHUNK_HEADER_SIZE;
+                chunk->unused_count = slab->objects_per_chunk;
+                chunk->used_count = 0;
+            }
+
+            if (chunk != NULL)
+            {
+                link_chunk(&slab->available_chunks, chunk);
+            }
+        }
+
+        if (chunk == NULL)
+        {
+            result = NULL;
+        }
+        else
+        {
+            SLAB_OBJECT_HEADER* header;
+
+            if (chunk->free_objects != NULL)
+            {
+                /* Codes_SRS_SLAB_03_008: [ slab_malloc shall return the most recently freed object of a chunk that has objects to hand out if there is one. ]*/
+                header = (SLAB_OBJECT_HEADER*)((unsigned char*)chunk->free_objects - SLAB_OBJECT_HEADER_SIZE);
+                chunk->free_objects = chunk->free_objects->next;
+            }
+            else
+            {
+                /* Codes_SRS_SLAB_03_009: [ Otherwise slab_malloc shall return the next never used object of that chunk, aligned for any type. ]*/
+                header = (SLAB_OBJECT_HEADER*)chunk->next_unused;
+                header->chunk = chunk;
+                chunk->next_unused += slab->slot_size;
+                chunk->unused_count--;
+            }
+
+            chunk->used_count++;
+            if (chunk->used_count == slab->objects_per_chunk)
+            {
+                unlink_chunk(&slab->available_chunks, chunk);
+                link_chunk(&slab->full_chunks, chunk);
+            }
+
+            result = (unsigned char*)header + SLAB_OBJECT_HEADER_SIZE;
+        }
+    }
+
+    return result;
+}
+
+void slab_free(SLAB_HANDLE slab, void* ptr)
+{
+    if (slab == NULL)
+    {
+        /* Codes_SRS_SLAB_03_012: [ If slab is NULL, slab_free shall return. ]*/
+        LogError("Invalid argument: SLAB_HANDLE slab=%p", slab);
+    }
+    /* Codes_SRS_SLAB_03_013: [ If ptr is NULL, slab_free shall return. ]*/
+    else if (ptr != NULL)
+    {
+        SLAB_FREE_OBJECT* free_object = (SLAB_FREE_OBJECT*)ptr;
+        SLAB_CHUNK* chunk = ((SLAB_OBJECT_HEADER*)((unsigned char*)ptr - SLAB_OBJECT_HEADER_SIZE))->chunk;
+
+        /* Codes_SRS_SLAB_03_014: [ slab_free shall put the object on the free list of its chunk for reuse by slab_malloc. ]*/
+        free_object->next = chunk->free_objects;
+        chunk->free_objects = free_object;
+
+        if (chunk->used_count == slab->objects_per_chunk)
+        {
+            unlink_chunk(&slab->full_chunks, chunk);
+            link_chunk(&slab->available_chunks, chunk);
+        }
+
+        chunk->used_count--;
+        if (chunk->used_count == 0)
+        {
+            unlink_chunk(&slab->available_chunks, chunk);
+            if (slab->empty_chunk == NULL)
+            {
+                /* Codes_SRS_SLAB_03_015: [ When none of the objects of its chunk is in use anymore, slab_free shall keep the chunk if the slab has no other such chunk and free it otherwise. ]*/
+                slab->empty_chunk = chunk;
+            }
+            else
+            {
+                free(chunk);
+            }
+        }
+    }
+}
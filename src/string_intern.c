@@ -0,0 +1,325 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/string_intern.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+/*the lock of the table is created by the first string_intern_acquire, STRING_INTERN_LOCK_CAS makes sure only one is kept*/
+/*STRING_INTERN_LOCK_CAS returns the value the lock had before the operation*/
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define STRING_INTERN_LOCK_CAS(var, expected, desired) ((LOCK_HANDLE)_InterlockedCompareExchangePointer((void* volatile*)(var), (desired), (expected)))
+#elif defined(__GNUC__)
+#define STRING_INTERN_LOCK_CAS(var, expected, desired) __sync_val_compare_and_swap((var), (expected), (desired))
+#else
+/*no atomic operations known for this compiler, the first string_intern_acquire shall not race with another one*/
+static LOCK_HANDLE string_intern_plain_cas(LOCK_HANDLE volatile* var, LOCK_HANDLE expected, LOCK_HANDLE desired)
+{
+    LOCK_HANDLE previous = *var;
+    if (previous == expected)
+    {
+        *var = desired;
+    }
+    return previous;
+}
+#define STRING_INTERN_LOCK_CAS(var, expected, desired) string_intern_plain_cas((var), (expected), (desired))
+#endif
+
+#define STRING_INTERN_MIN_BUCKET_COUNT 32
+
+typedef struct STRING_INTERN_ENTRY_TAG
+{
+    struct STRING_INTERN_ENTRY_TAG* next;
+    uint32_t hash;
+    /*only changed while holding the lock of the table*/
+    size_t ref_count;
+    /*the characters follow the entry, in the same allocation*/
+} STRING_INTERN_ENTRY;
+
+static LOCK_HANDLE volatile string_intern_lock = NULL;
+
+/*the table, only accessed while holding string_intern_lock. The buckets are freed when the table becomes empty*/
+static STRING_INTERN_ENTRY** string_intern_buckets = NULL;
+static size_t string_intern_bucket_count = 0;
+static size_t string_intern_entry_count = 0;
+
+/*FNV-1a*/
+static uint32_t string_intern_hash(const char* value)
+{
+    uint32_t result = 2166136261u;
+    while (*value != '\0')
+    {
+        result ^= (unsigned char)*value;
+        result *= 16777619u;
+        value++;
+    }
+    return result;
+}
+
+static const char* string_intern_entry_value(STRING_INTERN_ENTRY* entry)
+{
+    return (const char*)(entry + 1);
+}
+
+static STRING_INTERN_ENTRY* string_intern_lookup(const char* value, uint32_t hash)
+{
+    STRING_INTERN_ENTRY* result = NULL;
+    if (string_intern_buckets != NULL)
+    {
+        result = string_intern_buckets[hash & (string_intern_bucket_count - 1)];
+        while ((result != NULL) &&
+            ((result->hash != hash) || (strcmp(string_intern_entry_value(result), value) != 0)))
+        {
+            result = result->next;
+        }
+    }
+    return result;
+}
+
+/*makes room for one more entry, the chains only get longer if the buckets cannot be grown*/
+static int string_intern_reserve(void)
+{
+    int result;
+    if (string_intern_buckets == NULL)
+    {
+        string_intern_buckets = (STRING_INTERN_ENTRY**)malloc(STRING_INTERN_MIN_BUCKET_COUNT * sizeof(STRING_INTERN_ENTRY*));
+        if (string_intern_buckets == NULL)
+        {
+            LogError("unable to allocate the buckets of the intern table");
+            result = __FAILURE__;
+        }
+        else
+        {
+            (void)memset(string_intern_buckets, 0, STRING_INTERN_MIN_BUCKET_COUNT * sizeof(STRING_INTERN_ENTRY*));
+            string_intern_bucket_count = STRING_INTERN_MIN_BUCKET_COUNT;
+            result = 0;
+        }
+    }
+    else if ((string_intern_entry_count < string_intern_bucket_count) ||
+        (string_intern_bucket_count > SIZE_MAX / (2 * sizeof(STRING_INTERN_ENTRY*))))
+    {
+        result = 0;
+    }
+    else
+    {
+        size_t new_bucket_count = string_intern_bucket_count * 2;
+        STRING_INTERN_ENTRY** new_buckets = (STRING_INTERN_ENTRY**)malloc(new_bucket_count * sizeof(STRING_INTERN_ENTRY*));
+        if (new_buckets == NULL)
+        {
+            LogError("unable to grow the intern table, keeping %lu buckets", (unsigned long)string_intern_bucket_count);
+        }
+        else
+        {
+            size_t i;
+            (void)memset(new_buckets, 0, new_bucket_count * sizeof(STRING_INTERN_ENTRY*));
+            for (i = 0; i < string_intern_bucket_count; i++)
+            {
+                STRING_INTERN_ENTRY* entry = string_intern_buckets[i];
+                while (entry != NULL)
+                {
+                    STRING_INTERN_ENTRY* next = entry->next;
+                    size_t bucket = entry->hash & (new_bucket_count - 1);
+                    entry->next = new_buckets[bucket];
+                    new_buckets[bucket] = entry;
+                    entry = next;
+                }
+            }
+            free(string_intern_buckets);
+            string_intern_buckets = new_buckets;
+            string_intern_bucket_count = new_bucket_count;
+        }
+        result = 0;
+    }
+    return result;
+}
+
+static LOCK_HANDLE string_intern_get_lock(void)
+{
+    LOCK_HANDLE result = string_intern_lock;
+    if (result == NULL)
+    {
+        LOCK_HANDLE new_lock = Lock_Init();
+        if (new_lock == NULL)
+        {
+            LogError("unable to create the lock of the intern table");
+        }
+        else
+        {
+            result = STRING_INTERN_LOCK_CAS(&string_intern_lock, NULL, new_lock);
+            if (result == NULL)
+            {
+                result = new_lock;
+            }
+            else
+            {
+                /*another thread created the lock first*/
+                (void)Lock_Deinit(new_lock);
+            }
+        }
+    }
+    return result;
+}
+
+const char* string_intern_acquire(const char* value)
+{
+    const char* result;
+    LOCK_HANDLE lock;
+    if (value == NULL)
+    {
+        /*Codes_SRS_STRING_INTERN_03_001: [ If value is NULL, string_intern_acquire shall fail and return NULL. ]*/
+        LogError("invalid argument: const char* value=%p", value);
+        result = NULL;
+    }
+    /*Codes_SRS_STRING_INTERN_03_002: [ The first call to string_intern_acquire shall create the lock of the table. ]*/
+    else if ((lock = string_intern_get_lock()) == NULL)
+    {
+        /*Codes_SRS_STRING_INTERN_03_005: [ If any error occurs, string_intern_acquire shall fail and return NULL. ]*/
+        result = NULL;
+    }
+    /*Codes_SRS_STRING_INTERN_03_012: [ string_intern_acquire, string_intern_find and string_intern_release shall hold the lock of the table while they access it. ]*/
+    else if (Lock(lock) != LOCK_OK)
+    {
+        /*Codes_SRS_STRING_INTERN_03_005: [ If any error occurs, string_intern_acquire shall fail and return NULL. ]*/
+        LogError("unable to lock the intern table");
+        result = NULL;
+    }
+    else
+    {
+        uint32_t hash = string_intern_hash(value);
+        STRING_INTERN_ENTRY* entry = string_intern_lookup(value, hash);
+        if (entry != NULL)
+        {
+            /*Codes_SRS_STRING_INTERN_03_003: [ If value is already interned, string_intern_acquire shall increment the reference count of the canonical copy and return it. ]*/
+            entry->ref_count++;
+            result = string_intern_entry_value(entry);
+        }
+        else
+        {
+            size_t length = strlen(value);
+            if (length > SIZE_MAX - sizeof(STRING_INTERN_ENTRY) - 1)
+            {
+                /*Codes_SRS_STRING_INTERN_03_005: [ If any error occurs, string_intern_acquire shall fail and return NULL. ]*/
+                LogError("string too long: %lu", (unsigned long)length);
+                result = NULL;
+            }
+            else if (string_intern_reserve() != 0)
+            {
+                /*Codes_SRS_STRING_INTERN_03_005: [ If any error occurs, string_intern_acquire shall fail and return NULL. ]*/
+                result = NULL;
+            }
+            /*Codes_SRS_STRING_INTERN_03_004: [ Otherwise string_intern_acquire shall copy value in a new entry of the table having its reference count set to 1 and return the copy. ]*/
+            else if ((entry = (STRING_INTERN_ENTRY*)malloc(sizeof(STRING_INTERN_ENTRY) + length + 1)) == NULL)
+            {
+                /*Codes_SRS_STRING_INTERN_03_005: [ If any error occurs, string_intern_acquire shall fail and return NULL. ]*/
+                LogError("unable to malloc");
+                result = NULL;
+            }
+            else
+            {
+                size_t bucket = hash & (string_intern_bucket_count - 1);
+                (void)memcpy(entry + 1, value, length + 1);
+                entry->hash = hash;
+                entry->ref_count = 1;
+                entry->next = string_intern_buckets[bucket];
+                string_intern_buckets[bucket] = entry;
+                string_intern_entry_count++;
+                result = string_intern_entry_value(entry);
+            }
+
+            if ((result == NULL) && (string_intern_entry_count == 0) && (string_intern_buckets != NULL))
+            {
+                free(string_intern_buckets);
+                string_intern_buckets = NULL;
+                string_intern_bucket_count = 0;
+            }
+        }
+        (void)Unlock(lock);
+    }
+    return result;
+}
+
+const char* string_intern_find(const char* value)
+{
+    const char* result;
+    LOCK_HANDLE lock = string_intern_lock;
+    if (value == NULL)
+    {
+        /*Codes_SRS_STRING_INTERN_03_006: [ If value is NULL, string_intern_find shall return NULL. ]*/
+        LogError("invalid argument: const char* value=%p", value);
+        result = NULL;
+    }
+    else if (lock == NULL)
+    {
+        /*Codes_SRS_STRING_INTERN_03_008: [ Otherwise string_intern_find shall return NULL. ]*/
+        /*nothing was ever interned*/
+        result = NULL;
+    }
+    /*Codes_SRS_STRING_INTERN_03_012: [ string_intern_acquire, string_intern_find and string_intern_release shall hold the lock of the table while they access it. ]*/
+    else if (Lock(lock) != LOCK_OK)
+    {
+        LogError("unable to lock the intern table");
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_STRING_INTERN_03_007: [ If value is interned, string_intern_find shall return its canonical copy without changing its reference count. ]*/
+        /*Codes_SRS_STRING_INTERN_03_008: [ Otherwise string_intern_find shall return NULL. ]*/
+        STRING_INTERN_ENTRY* entry = string_intern_lookup(value, string_intern_hash(value));
+        result = (entry == NULL) ? NULL : string_intern_entry_value(entry);
+        (void)Unlock(lock);
+    }
+    return result;
+}
+
+void string_intern_release(const char* interned)
+{
+    LOCK_HANDLE lock = string_intern_lock;
+    if (interned == NULL)
+    {
+        /*Codes_SRS_STRING_INTERN_03_009: [ If interned is NULL, string_intern_release shall return. ]*/
+        LogError("invalid argument: const char* interned=%p", interned);
+    }
+    else if (lock == NULL)
+    {
+        LogError("string %p was not acquired from the intern table", interned);
+    }
+    /*Codes_SRS_STRING_INTERN_03_012: [ string_intern_acquire, string_intern_find and string_intern_release shall hold the lock of the table while they access it. ]*/
+    else if (Lock(lock) != LOCK_OK)
+    {
+        LogError("unable to lock the intern table");
+    }
+    else
+    {
+        STRING_INTERN_ENTRY* entry = (STRING_INTERN_ENTRY*)interned - 1;
+
+        /*Codes_SRS_STRING_INTERN_03_010: [ Otherwise string_intern_release shall decrement the reference count of interned. ]*/
+        entry->ref_count--;
+        if (entry->ref_count == 0)
+        {
+            /*Codes_SRS_STRING_INTERN_03_011: [ If the reference count reaches 0, string_intern_release shall remove interned from the table and free it, the table frees its buckets when its last entry is removed. ]*/
+            STRING_INTERN_ENTRY** link = &string_intern_buckets[entry->hash & (string_intern_bucket_count - 1)];
+            while (*link != entry)
+            {
+                link = &(*link)->next;
+            }
+            *link = entry->next;
+            free(entry);
+
+            string_intern_entry_count--;
+            if (string_intern_entry_count == 0)
+            {
+                free(string_intern_buckets);
+                string_intern_buckets = NULL;
+                string_intern_bucket_count = 0;
+            }
+        }
+        (void)Unlock(lock);
+    }
+}
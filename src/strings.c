@@ -7,6 +7,7 @@
 #include <stdlib.h>
 #include "azure_c_shared_utility/gballoc.h"
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdarg.h>
 #include <stdio.h>
@@ -21,30 +22,119 @@
 
 static const char hexToASCII[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
 
+/* strings that fit here ('\0' included) are stored in the STRING itself, which makes header names, SAS fragments
+   and small JSON pieces a single allocation. 40 makes sizeof(STRING) 64 on 64 bit platforms */
+#define STRING_INLINE_SIZE 40
+
 typedef struct STRING_TAG
 {
+    /* points at inline_s while the string fits there, at a heap block otherwise */
     char* s;
+    size_t length;
+    /* bytes available at s, the terminating '\0' included */
+    size_t capacity;
+    char inline_s[STRING_INLINE_SIZE];
 } STRING;
 
-/*this function will allocate a new string with just '\0' in it*/
-/*return NULL if it fails*/
-/* Codes_SRS_STRING_07_001: [STRING_new shall allocate a new STRING_HANDLE pointing to an empty string.] */
-STRING_HANDLE STRING_new(void)
+/* allocates an empty string with room for size bytes, '\0' included */
+static STRING* STRING_allocate(size_t size)
 {
-    STRING* result;
-    if ((result = (STRING*)malloc(sizeof(STRING))) != NULL)
+    STRING* result = (STRING*)malloc(sizeof(STRING));
+    if (result == NULL)
     {
-        if ((result->s = (char*)malloc(1)) != NULL)
+        LogError("Failure allocating STRING.");
+    }
+    else
+    {
+        if (size <= STRING_INLINE_SIZE)
         {
-            result->s[0] = '\0';
+            /* Codes_SRS_STRING_03_001: [ A string of less than STRING_INLINE_SIZE characters shall be stored in the STRING structure, without allocating memory for its characters. ]*/
+            result->s = result->inline_s;
+            result->capacity = STRING_INLINE_SIZE;
         }
-        else
+        else if ((result->s = (char*)malloc(size)) == NULL)
         {
-            /* Codes_SRS_STRING_07_002: [STRING_new shall return an NULL STRING_HANDLE on any error that is encountered.] */
-            LogError("Failure allocating in STRING_new.");
+            LogError("Failure allocating %lu bytes for the string value.", (unsigned long)size);
             free(result);
             result = NULL;
         }
+        else
+        {
+            result->capacity = size;
+        }
+
+        if (result != NULL)
+        {
+            result->s[0] = '\0';
+            result->length = 0;
+        }
+    }
+    return result;
+}
+
+/* moves the string to a heap block of capacity bytes, capacity has to be bigger than the current capacity */
+static int STRING_set_capacity(STRING* str, size_t capacity)
+{
+    int result;
+    char* temp;
+    if (str->s == str->inline_s)
+    {
+        if ((temp = (char*)malloc(capacity)) != NULL)
+        {
+            (void)memcpy(temp, str->s, str->length + 1);
+        }
+    }
+    else
+    {
+        temp = (char*)realloc(str->s, capacity);
+    }
+
+    if (temp == NULL)
+    {
+        LogError("Failure reallocating value to %lu bytes.", (unsigned long)capacity);
+        result = __FAILURE__;
+    }
+    else
+    {
+        str->s = temp;
+        str->capacity = capacity;
+        result = 0;
+    }
+    return result;
+}
+
+/* makes room for size bytes ('\0' included), growing the capacity geometrically so that a chain of concatenations costs amortized O(1) reallocs */
+static int STRING_grow(STRING* str, size_t size)
+{
+    int result;
+    if (size <= str->capacity)
+    {
+        /* Codes_SRS_STRING_03_003: [ If the capacity of the string is enough for the new value, no memory shall be allocated. ]*/
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_STRING_03_002: [ If the capacity of the string is not enough for the new value, the capacity shall grow to the larger of the needed size and twice the capacity. ]*/
+        size_t new_capacity = (str->capacity > SIZE_MAX / 2) ? size : str->capacity * 2;
+        if (new_capacity < size)
+        {
+            new_capacity = size;
+        }
+        result = STRING_set_capacity(str, new_capacity);
+    }
+    return result;
+}
+
+/*this function will allocate a new string with just '\0' in it*/
+/*return NULL if it fails*/
+/* Codes_SRS_STRING_07_001: [STRING_new shall allocate a new STRING_HANDLE pointing to an empty string.] */
+STRING_HANDLE STRING_new(void)
+{
+    STRING* result;
+    if ((result = STRING_allocate(1)) == NULL)
+    {
+        /* Codes_SRS_STRING_07_002: [STRING_new shall return an NULL STRING_HANDLE on any error that is encountered.] */
+        LogError("Failure allocating in STRING_new.");
     }
     return (STRING_HANDLE)result;
 }
@@ -60,26 +150,16 @@ STRING_HANDLE STRING_clone(STRING_HANDLE handle)
     }
     else
     {
+        STRING* source = (STRING*)handle;
         /*Codes_SRS_STRING_02_003: [If STRING_clone fails for any reason, it shall return NULL.] */
-        if ((result = (STRING*)malloc(sizeof(STRING))) != NULL)
+        if ((result = STRING_allocate(source->length + 1)) == NULL)
         {
-            STRING* source = (STRING*)handle;
-            /*Codes_SRS_STRING_02_003: [If STRING_clone fails for any reason, it shall return NULL.] */
-            size_t sourceLen = strlen(source->s);
-            if ((result->s = (char*)malloc(sourceLen + 1)) == NULL)
-            {
-                LogError("Failure allocating clone value.");
-                free(result);
-                result = NULL;
-            }
-            else
-            {
-                (void)memcpy(result->s, source->s, sourceLen + 1);
-            }
+            LogError("Failure allocating clone value.");
         }
         else
         {
-            /*not much to do, result is NULL from malloc*/
+            (void)memcpy(result->s, source->s, source->length + 1);
+            result->length = source->length;
         }
     }
     return (STRING_HANDLE)result;
@@ -97,26 +177,17 @@ STRING_HANDLE STRING_construct(const char* psz)
     else
     {
         STRING* str;
-        if ((str = (STRING*)malloc(sizeof(STRING))) != NULL)
+        size_t nLen = strlen(psz);
+        if ((str = STRING_allocate(nLen + 1)) != NULL)
         {
-            size_t nLen = strlen(psz) + 1;
-            if ((str->s = (char*)malloc(nLen)) != NULL)
-            {
-                (void)memcpy(str->s, psz, nLen);
-                result = (STRING_HANDLE)str;
-            }
-            /* Codes_SRS_STRING_07_032: [STRING_construct encounters any error it shall return a NULL value.] */
-            else
-            {
-                LogError("Failure allocating constructed value.");
-                free(str);
-                result = NULL;
-            }
+            (void)memcpy(str->s, psz, nLen + 1);
+            str->length = nLen;
+            result = (STRING_HANDLE)str;
         }
         else
         {
             /* Codes_SRS_STRING_07_032: [STRING_construct encounters any error it shall return a NULL value.] */
-            LogError("Failure allocating value.");
+            LogError("Failure allocating constructed value.");
             result = NULL;
         }
     }
@@ -149,37 +220,30 @@ STRING_HANDLE STRING_construct_sprintf(const char* format, ...)
         va_end(arg_list);
         if (length > 0)
         {
-            result = (STRING*)malloc(sizeof(STRING));
-            if (result != NULL)
-            {
 #pragma warning(push)
 #pragma warning(disable:26451)
-                result->s = (char*)malloc(length+1);
-                if (result->s != NULL)
-                {
-                    va_start(arg_list, format);
-                    if (vsnprintf(result->s, length+1, format, arg_list) < 0)
+            result = STRING_allocate((size_t)length + 1);
+            if (result != NULL)
+            {
+                va_start(arg_list, format);
+                if (vsnprintf(result->s, (size_t)length + 1, format, arg_list) < 0)
 #pragma warning(pop) // C26451
-                    {
-                        /* Codes_SRS_STRING_07_040: [If any error is encountered STRING_construct_sprintf shall return NULL.] */
-                        free(result->s);
-                        free(result);
-                        result = NULL;
-                        LogError("Failure: vsnprintf formatting failed.");
-                    }
-                    va_end(arg_list);
-                }
-                else
                 {
                     /* Codes_SRS_STRING_07_040: [If any error is encountered STRING_construct_sprintf shall return NULL.] */
-                    free(result);
+                    STRING_delete((STRING_HANDLE)result);
                     result = NULL;
-                    LogError("Failure: allocation sprintf value failed.");
+                    LogError("Failure: vsnprintf formatting failed.");
+                }
+                else
+                {
+                    result->length = (size_t)length;
                 }
+                va_end(arg_list);
             }
             else
             {
-                LogError("Failure: allocation failed.");
+                /* Codes_SRS_STRING_07_040: [If any error is encountered STRING_construct_sprintf shall return NULL.] */
+                LogError("Failure: allocation sprintf value failed.");
             }
         }
         else if (length == 0)
@@ -219,6 +283,8 @@ STRING_HANDLE STRING_new_with_memory(const char* memory)
         if ((result = (STRING*)malloc(sizeof(STRING))) != NULL)
         {
             result->s = (char*)memory;
+            result->length = strlen(memory);
+            result->capacity = result->length + 1;
         }
         else
         {
@@ -237,22 +303,21 @@ STRING_HANDLE STRING_new_quoted(const char* source)
         /* Codes_SRS_STRING_07_009: [STRING_new_quoted shall return a NULL STRING_HANDLE if the supplied const char* is NULL.] */
         result = NULL;
     }
-    else if ((result = (STRING*)malloc(sizeof(STRING))) != NULL)
+    else
     {
         size_t sourceLength = strlen(source);
-        if ((result->s = (char*)malloc(sourceLength + 3)) != NULL)
+        if ((result = STRING_allocate(sourceLength + 3)) != NULL)
         {
             result->s[0] = '"';
             (void)memcpy(result->s + 1, source, sourceLength);
             result->s[sourceLength + 1] = '"';
             result->s[sourceLength + 2] = '\0';
+            result->length = sourceLength + 2;
         }
         else
         {
             /* Codes_SRS_STRING_07_031: [STRING_new_quoted shall return a NULL STRING_HANDLE if any error is encountered.] */
             LogError("Failure allocating quoted string value.");
-            free(result);
-            result = NULL;
         }
     }
     return (STRING_HANDLE)result;
@@ -309,18 +374,11 @@ STRING_HANDLE STRING_new_JSON(const char* source)
         else
         {
             size_t nAllocation = vlen + 5 * nControlCharacters + nEscapeCharacters + 3;
-            if ((result = (STRING*)malloc(sizeof(STRING))) == NULL)
+            if ((result = STRING_allocate(nAllocation)) == NULL)
             {
                 /*Codes_SRS_STRING_02_021: [If the complete JSON representation cannot be produced, then STRING_new_JSON shall fail and return NULL.] */
                 LogError("malloc json failure");
             }
-            else if ((result->s = (char*)malloc(nAllocation)) == NULL)
-            {
-                /*Codes_SRS_STRING_02_021: [If the complete JSON representation cannot be produced, then STRING_new_JSON shall fail and return NULL.] */
-                free(result);
-                result = NULL;
-                LogError("malloc failed");
-            }
             else
             {
                 size_t pos = 0;
@@ -385,6 +443,7 @@ STRING_HANDLE STRING_new_JSON(const char* source)
                 result->s[pos++] = '"';
                 /*zero terminating it*/
                 result->s[pos] = '\0';
+                result->length = pos;
             }
         }
 
@@ -407,10 +466,14 @@ int STRING_concat(STRING_HANDLE handle, const char* s2)
     else
     {
         STRING* s1 = (STRING*)handle;
-        size_t s1Length = strlen(s1->s);
         size_t s2Length = strlen(s2);
-        char* temp = (char*)realloc(s1->s, s1Length + s2Length + 1);
-        if (temp == NULL)
+        if (s2Length > SIZE_MAX - s1->length - 1)
+        {
+            /* Codes_SRS_STRING_07_013: [STRING_concat shall return a nonzero number if an error is encountered.] */
+            LogError("Concatenated length overflows.");
+            result = __FAILURE__;
+        }
+        else if (STRING_grow(s1, s1->length + s2Length + 1) != 0)
         {
             /* Codes_SRS_STRING_07_013: [STRING_concat shall return a nonzero number if an error is encountered.] */
             LogError("Failure reallocating value.");
@@ -418,8 +481,8 @@ int STRING_concat(STRING_HANDLE handle, const char* s2)
         }
         else
         {
-            s1->s = temp;
-            (void)memcpy(s1->s + s1Length, s2, s2Length + 1);
+            (void)memcpy(s1->s + s1->length, s2, s2Length + 1);
+            s1->length += s2Length;
             result = 0;
         }
     }
@@ -444,10 +507,16 @@ int STRING_concat_with_STRING(STRING_HANDLE s1, STRING_HANDLE s2)
         STRING* dest = (STRING*)s1;
         STRING* src = (STRING*)s2;
 
-        size_t s1Length = strlen(dest->s);
-        size_t s2Length = strlen(src->s);
-        char* temp = (char*)realloc(dest->s, s1Length + s2Length + 1);
-        if (temp == NULL)
+        /* s1 and s2 can be the same string, so the lengths are taken before growing */
+        size_t s1Length = dest->length;
+        size_t s2Length = src->length;
+        if (s2Length > SIZE_MAX - s1Length - 1)
+        {
+            /* Codes_SRS_STRING_07_035: [String_Concat_with_STRING shall return a nonzero number if an error is encountered.] */
+            LogError("Concatenated length overflows.");
+            result = __FAILURE__;
+        }
+        else if (STRING_grow(dest, s1Length + s2Length + 1) != 0)
         {
             /* Codes_SRS_STRING_07_035: [String_Concat_with_STRING shall return a nonzero number if an error is encountered.] */
             LogError("Failure reallocating value");
@@ -455,9 +524,10 @@ int STRING_concat_with_STRING(STRING_HANDLE s1, STRING_HANDLE s2)
         }
         else
         {
-            dest->s = temp;
             /* Codes_SRS_STRING_07_034: [String_Concat_with_STRING shall concatenate a given STRING_HANDLE variable with a source STRING_HANDLE.] */
-            (void)memcpy(dest->s + s1Length, src->s, s2Length + 1);
+            (void)memcpy(dest->s + s1Length, src->s, s2Length);
+            dest->s[s1Length + s2Length] = '\0';
+            dest->length = s1Length + s2Length;
             result = 0;
         }
     }
@@ -483,8 +553,7 @@ int STRING_copy(STRING_HANDLE handle, const char* s2)
         if (s1->s != s2)
         {
             size_t s2Length = strlen(s2);
-            char* temp = (char*)realloc(s1->s, s2Length + 1);
-            if (temp == NULL)
+            if (STRING_grow(s1, s2Length + 1) != 0)
             {
                 LogError("Failure reallocating value.");
                 /* Codes_SRS_STRING_07_027: [STRING_copy shall return a nonzero value if any error is encountered.] */
@@ -492,8 +561,8 @@ int STRING_copy(STRING_HANDLE handle, const char* s2)
             }
             else
             {
-                s1->s = temp;
                 memmove(s1->s, s2, s2Length + 1);
+                s1->length = s2Length;
                 result = 0;
             }
         }
@@ -522,14 +591,12 @@ int STRING_copy_n(STRING_HANDLE handle, const char* s2, size_t n)
     {
         STRING* s1 = (STRING*)handle;
         size_t s2Length = strlen(s2);
-        char* temp;
         if (s2Length > n)
         {
             s2Length = n;
         }
 
-        temp = (char*)realloc(s1->s, s2Length + 1);
-        if (temp == NULL)
+        if (STRING_grow(s1, s2Length + 1) != 0)
         {
             LogError("Failure reallocating value.");
             /* Codes_SRS_STRING_07_028: [STRING_copy_n shall return a nonzero value if any error is encountered.] */
@@ -537,9 +604,9 @@ int STRING_copy_n(STRING_HANDLE handle, const char* s2, size_t n)
         }
         else
         {
-            s1->s = temp;
-            (void)memcpy(s1->s, s2, s2Length);
+            memmove(s1->s, s2, s2Length);
             s1->s[s2Length] = 0;
+            s1->length = s2Length;
             result = 0;
         }
 
@@ -590,14 +657,11 @@ int STRING_sprintf(STRING_HANDLE handle, const char* format, ...)
         else
         {
             STRING* s1 = (STRING*)handle;
-            char* temp;
-            size_t s1Length = strlen(s1->s);
-            temp = (char*)realloc(s1->s, s1Length + s2Length + 1);
-            if (temp != NULL)
+            size_t s1Length = s1->length;
+            if (STRING_grow(s1, s1Length + (size_t)s2Length + 1) == 0)
             {
-                s1->s = temp;
                 va_start(arg_list, format);
-                if (vsnprintf(s1->s + s1Length, s1Length + s2Length + 1, format, arg_list) < 0)
+                if (vsnprintf(s1->s + s1Length, (size_t)s2Length + 1, format, arg_list) < 0)
                 {
                     /* Codes_SRS_STRING_07_043: [If any error is encountered STRING_sprintf shall return a non zero value.] */
                     LogError("Failure vsnprintf formatting error");
@@ -607,6 +671,7 @@ int STRING_sprintf(STRING_HANDLE handle, const char* format, ...)
                 else
                 {
                     /* Codes_SRS_STRING_07_044: [On success STRING_sprintf shall return 0.]*/
+                    s1->length = s1Length + (size_t)s2Length;
                     result = 0;
                 }
                 va_end(arg_list);
@@ -637,9 +702,8 @@ int STRING_quote(STRING_HANDLE handle)
     else
     {
         STRING* s1 = (STRING*)handle;
-        size_t s1Length = strlen(s1->s);
-        char* temp = (char*)realloc(s1->s, s1Length + 2 + 1);/*2 because 2 quotes, 1 because '\0'*/
-        if (temp == NULL)
+        size_t s1Length = s1->length;
+        if (STRING_grow(s1, s1Length + 2 + 1) != 0)/*2 because 2 quotes, 1 because '\0'*/
         {
             LogError("Failure reallocating value.");
             /* Codes_SRS_STRING_07_029: [STRING_quote shall return a nonzero value if any error is encountered.] */
@@ -647,11 +711,11 @@ int STRING_quote(STRING_HANDLE handle)
         }
         else
         {
-            s1->s = temp;
             memmove(s1->s + 1, s1->s, s1Length);
             s1->s[0] = '"';
             s1->s[s1Length + 1] = '"';
             s1->s[s1Length + 2] = '\0';
+            s1->length = s1Length + 2;
             result = 0;
         }
     }
@@ -670,20 +734,11 @@ int STRING_empty(STRING_HANDLE handle)
     }
     else
     {
+        /* Codes_SRS_STRING_03_004: [ STRING_empty shall keep the capacity of the string for reuse. ]*/
         STRING* s1 = (STRING*)handle;
-        char* temp = (char*)realloc(s1->s, 1);
-        if (temp == NULL)
-        {
-            LogError("Failure reallocating value.");
-            /* Codes_SRS_STRING_07_030: [STRING_empty shall return a nonzero value if the STRING_HANDLE is NULL.] */
-            result = __FAILURE__;
-        }
-        else
-        {
-            s1->s = temp;
-            s1->s[0] = '\0';
-            result = 0;
-        }
+        s1->s[0] = '\0';
+        s1->length = 0;
+        result = 0;
     }
     return result;
 }
@@ -696,7 +751,10 @@ void STRING_delete(STRING_HANDLE handle)
     if (handle != NULL)
     {
         STRING* value = (STRING*)handle;
-        free(value->s);
+        if (value->s != value->inline_s)
+        {
+            free(value->s);
+        }
         value->s = NULL;
         free(value);
     }
@@ -726,7 +784,7 @@ size_t STRING_length(STRING_HANDLE handle)
     if (handle != NULL)
     {
         STRING* value = (STRING*)handle;
-        result = strlen(value->s);
+        result = value->length;
     }
     return result;
 }
@@ -753,25 +811,17 @@ STRING_HANDLE STRING_construct_n(const char* psz, size_t n)
         else
         {
             STRING* str;
-            if ((str = (STRING*)malloc(sizeof(STRING))) != NULL)
+            if ((str = STRING_allocate(n + 1)) != NULL)
             {
-                if ((str->s = (char*)malloc(len + 1)) != NULL)
-                {
-                    (void)memcpy(str->s, psz, n);
-                    str->s[n] = '\0';
-                    result = (STRING_HANDLE)str;
-                }
-                /* Codes_SRS_STRING_02_010: [In all other error cases, STRING_construct_n shall return NULL.]  */
-                else
-                {
-                    LogError("Failure allocating value.");
-                    free(str);
-                    result = NULL;
-                }
+                (void)memcpy(str->s, psz, n);
+                str->s[n] = '\0';
+                str->length = n;
+                result = (STRING_HANDLE)str;
             }
             else
             {
                 /* Codes_SRS_STRING_02_010: [In all other error cases, STRING_construct_n shall return NULL.]  */
+                LogError("Failure allocating value.");
                 result = NULL;
             }
         }
@@ -820,7 +870,7 @@ STRING_HANDLE STRING_from_byte_array(const unsigned char* source, size_t size)
     else
     {
         /*Codes_SRS_STRING_02_023: [ Otherwise, STRING_from_BUFFER shall build a string that has the same content (byte-by-byte) as source and return a non-NULL handle. ]*/
-        result = (STRING*)malloc(sizeof(STRING));
+        result = STRING_allocate(size + 1);
         if (result == NULL)
         {
             /*Codes_SRS_STRING_02_024: [ If building the string fails, then STRING_from_BUFFER shall fail and return NULL. ]*/
@@ -829,20 +879,13 @@ STRING_HANDLE STRING_from_byte_array(const unsigned char* source, size_t size)
         }
         else
         {
-            /*Codes_SRS_STRING_02_023: [ Otherwise, STRING_from_BUFFER shall build a string that has the same content (byte-by-byte) as source and return a non-NULL handle. ]*/
-            result->s = (char*)malloc(size + 1);
-            if (result->s == NULL)
-            {
-                /*Codes_SRS_STRING_02_024: [ If building the string fails, then STRING_from_BUFFER shall fail and return NULL. ]*/
-                LogError("oom - unable to malloc");
-                free(result);
-                result = NULL;
-            }
-            else
+            if (size > 0)
             {
                 (void)memcpy(result->s, source, size);
-                result->s[size] = '\0'; /*all is fine*/
             }
+            result->s[size] = '\0'; /*all is fine*/
+            /* source can contain '\0', the string ends at the first one */
+            result->length = strlen(result->s);
         }
     }
     return (STRING_HANDLE)result;
@@ -867,7 +910,7 @@ int STRING_replace(STRING_HANDLE handle, char target, char replace)
         size_t index;
         /* Codes_SRS_STRING_07_047: [ STRING_replace shall replace all instances of target with replace. ] */
         STRING* str_value = (STRING*)handle;
-        length = strlen(str_value->s);
+        length = str_value->length;
         for (index = 0; index < length; index++)
         {
             if (str_value->s[index] == target)
@@ -875,8 +918,52 @@ int STRING_replace(STRING_HANDLE handle, char target, char replace)
                 str_value->s[index] = replace;
             }
         }
+        if (replace == '\0')
+        {
+            /* the string now ends at the first replaced character */
+            str_value->length = strlen(str_value->s);
+        }
         /* Codes_SRS_STRING_07_049: [ On success STRING_replace shall return zero. ] */
         result = 0;
     }
     return result;
 }
+
+int STRING_reserve(STRING_HANDLE handle, size_t capacity)
+{
+    int result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_STRING_03_005: [ If handle is NULL, STRING_reserve shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: STRING_HANDLE handle=%p", handle);
+        result = __FAILURE__;
+    }
+    else if (capacity == SIZE_MAX)
+    {
+        /* Codes_SRS_STRING_03_009: [ If any error occurs, STRING_reserve shall fail, leave the string unchanged and return a non-zero value. ]*/
+        LogError("Invalid argument: size_t capacity=%lu", (unsigned long)capacity);
+        result = __FAILURE__;
+    }
+    else
+    {
+        STRING* str = (STRING*)handle;
+        if (capacity + 1 <= str->capacity)
+        {
+            /* Codes_SRS_STRING_03_006: [ If the string can already hold capacity characters, STRING_reserve shall succeed without allocating memory. ]*/
+            result = 0;
+        }
+        /* Codes_SRS_STRING_03_007: [ Otherwise STRING_reserve shall reallocate the string to hold exactly capacity characters and the terminating '\0', keeping its value. ]*/
+        else if (STRING_set_capacity(str, capacity + 1) != 0)
+        {
+            /* Codes_SRS_STRING_03_009: [ If any error occurs, STRING_reserve shall fail, leave the string unchanged and return a non-zero value. ]*/
+            LogError("Failure reserving %lu characters.", (unsigned long)capacity);
+            result = __FAILURE__;
+        }
+        else
+        {
+            /* Codes_SRS_STRING_03_008: [ On success STRING_reserve shall return 0. ]*/
+            result = 0;
+        }
+    }
+    return result;
+}
@@ -12,6 +12,7 @@
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/xio.h"
 #include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/slab.h"
 #include "azure_c_shared_utility/socketio.h"
 #include "azure_c_shared_utility/platform.h"
 #include "azure_c_shared_utility/tlsio.h"
@@ -24,6 +25,7 @@
 #include "azure_c_shared_utility/base64.h"
 #include "azure_c_shared_utility/optionhandler.h"
 #include "azure_c_shared_utility/map.h"
+#include "azure_c_shared_utility/arena.h"
 
 static const char* UWS_CLIENT_OPTIONS = "uWSClientOptions";
 
@@ -73,10 +75,13 @@ typedef struct WS_PENDING_SEND_TAG
     UWS_CLIENT_HANDLE uws_client;
 } WS_PENDING_SEND;
 
+#define PENDING_SENDS_PER_CHUNK 8
+
 
 typedef struct UWS_CLIENT_INSTANCE_TAG
 {
     SINGLYLINKEDLIST_HANDLE pending_sends;
+    SLAB_HANDLE pending_send_slab;
     XIO_HANDLE underlying_io;
     char* hostname;
     char* resource_name;
@@ -100,14 +105,42 @@ typedef struct UWS_CLIENT_INSTANCE_TAG
     unsigned char* fragment_buffer;
     size_t fragment_buffer_count;
     unsigned char fragmented_frame_type;
+    ARENA_HANDLE arena;
 } UWS_CLIENT_INSTANCE;
 
+/* the hostname and resource name come from the arena when one is given, like the instance and its protocols */
+static int uws_client_copy_string(ARENA_HANDLE arena, char** destination, const char* source)
+{
+    int result;
+
+    if (arena == NULL)
+    {
+        result = mallocAndStrcpy_s(destination, source);
+    }
+    else if ((*destination = arena_copy_string(arena, source)) == NULL)
+    {
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
 void clear_pending_sends(UWS_CLIENT_INSTANCE* uws_client);
 
 /* Codes_SRS_UWS_CLIENT_01_360: [ Connection confidentiality and integrity is provided by running the WebSocket Protocol over TLS (wss URIs). ]*/
 /* Codes_SRS_UWS_CLIENT_01_361: [ WebSocket implementations MUST support TLS and SHOULD employ it when communicating with their peers. ]*/
 /* Codes_SRS_UWS_CLIENT_01_063: [ A client will need to supply a /host/, /port/, /resource name/, and a /secure/ flag, which are the components of a WebSocket URI as discussed in Section 3, along with a list of /protocols/ and /extensions/ to be used. ]*/
 UWS_CLIENT_HANDLE uws_client_create(const char* hostname, unsigned int port, const char* resource_name, bool use_ssl, const WS_PROTOCOL* protocols, size_t protocol_count)
+{
+    return uws_client_create_with_arena(NULL, hostname, port, resource_name, use_ssl, protocols, protocol_count);
+}
+
+/* Codes_SRS_UWS_CLIENT_03_001: [ `uws_client_create_with_arena` shall behave like `uws_client_create`. ]*/
+UWS_CLIENT_HANDLE uws_client_create_with_arena(ARENA_HANDLE arena, const char* hostname, unsigned int port, const char* resource_name, bool use_ssl, const WS_PROTOCOL* protocols, size_t protocol_count)
 {
     UWS_CLIENT_HANDLE result;
 
@@ -140,7 +173,7 @@ UWS_CLIENT_HANDLE uws_client_create(const char* hostname, unsigned int port, con
         else
         {
             /* Codes_SRS_UWS_CLIENT_01_001: [`uws_client_create` shall create an instance of uws and return a non-NULL handle to it.]*/
-            result = (UWS_CLIENT_HANDLE)malloc(sizeof(UWS_CLIENT_INSTANCE));
+            result = (UWS_CLIENT_HANDLE)arena_malloc_or_heap(arena, sizeof(UWS_CLIENT_INSTANCE));
             if (result == NULL)
             {
                 /* Codes_SRS_UWS_CLIENT_01_003: [ If allocating memory for the new uws instance fails then `uws_client_create` shall return NULL. ]*/
@@ -149,32 +182,33 @@ UWS_CLIENT_HANDLE uws_client_create(const char* hostname, unsigned int port, con
             else
             {
                 (void)memset(result, 0, sizeof(UWS_CLIENT_INSTANCE));
+                result->arena = arena;
 
                 /* Codes_SRS_UWS_CLIENT_01_004: [ The argument `hostname` shall be copied for later use. ]*/
-                if (mallocAndStrcpy_s(&result->hostname, hostname) != 0)
+                if (uws_client_copy_string(arena, &result->hostname, hostname) != 0)
                 {
                     /* Codes_SRS_UWS_CLIENT_01_392: [ If allocating memory for the copy of the `hostname` argument fails, then `uws_client_create` shall return NULL. ]*/
                     LogError("Could not copy hostname.");
-                    free(result);
+                    arena_free_or_heap(arena, result);
                     result = NULL;
                 }
                 else
                 {
                     /* Codes_SRS_UWS_CLIENT_01_404: [ The argument `resource_name` shall be copied for later use. ]*/
-                    if (mallocAndStrcpy_s(&result->resource_name, resource_name) != 0)
+                    if (uws_client_copy_string(arena, &result->resource_name, resource_name) != 0)
                     {
                         /* Codes_SRS_UWS_CLIENT_01_405: [ If allocating memory for the copy of the `resource` argument fails, then `uws_client_create` shall return NULL. ]*/
                         LogError("Could not copy resource.");
-                        free(result->hostname);
-                        free(result);
+                        arena_free_or_heap(arena, result->hostname);
+                        arena_free_or_heap(arena, result);
                         result = NULL;
                     }
-                    else if ((result->request_headers = Map_Create(NULL)) == NULL)
+                    else if ((result->request_headers = Map_CreateWithInternedKeys(NULL)) == NULL)
                     {
                         LogError("Failed allocating MAP for request headers");
-                        free(result->resource_name);
-                        free(result->hostname);
-                        free(result);
+                        arena_free_or_heap(arena, result->resource_name);
+                        arena_free_or_heap(arena, result->hostname);
+                        arena_free_or_heap(arena, result);
                         result = NULL;
                     }
                     else
@@ -186,9 +220,21 @@ UWS_CLIENT_HANDLE uws_client_create(const char* hostname, unsigned int port, con
                             /* Codes_SRS_UWS_CLIENT_01_018: [ If `singlylinkedlist_create` fails then `uws_client_create` shall fail and return NULL. ]*/
                             LogError("Could not allocate pending send frames list");
                             Map_Destroy(result->request_headers);
-                            free(result->resource_name);
-                            free(result->hostname);
-                            free(result);
+                            arena_free_or_heap(arena, result->resource_name);
+                            arena_free_or_heap(arena, result->hostname);
+                            arena_free_or_heap(arena, result);
+                            result = NULL;
+                        }
+                        /* Codes_SRS_UWS_CLIENT_03_005: [ `uws_client_create` shall create a slab for the pending sends by calling `slab_create`. ]*/
+                        else if ((result->pending_send_slab = slab_create(sizeof(WS_PENDING_SEND), PENDING_SENDS_PER_CHUNK)) == NULL)
+                        {
+                            /* Codes_SRS_UWS_CLIENT_03_006: [ If `slab_create` fails then `uws_client_create` shall fail and return NULL. ]*/
+                            LogError("Could not create pending send frames slab");
+                            singlylinkedlist_destroy(result->pending_sends);
+                            Map_Destroy(result->request_headers);
+                            arena_free_or_heap(arena, result->resource_name);
+                            arena_free_or_heap(arena, result->hostname);
+                            arena_free_or_heap(arena, result);
                             result = NULL;
                         }
                         else
@@ -222,7 +268,8 @@ UWS_CLIENT_HANDLE uws_client_create(const char* hostname, unsigned int port, con
                                     tlsio_config.underlying_io_interface = socketio_get_interface_description();
                                     tlsio_config.underlying_io_parameters = &socketio_config;
 
-                                    result->underlying_io = xio_create(tlsio_interface, &tlsio_config);
+                                    /* Codes_SRS_UWS_CLIENT_03_004: [ If `arena` is not NULL, `uws_client_create_with_arena` shall create the underlying IO by calling `xio_create_with_arena` with `arena` instead of `xio_create`. ]*/
+                                    result->underlying_io = (arena == NULL) ? xio_create(tlsio_interface, &tlsio_config) : xio_create_with_arena(tlsio_interface, &tlsio_config, arena);
                                     if (result->underlying_io == NULL)
                                     {
                                         LogError("Cannot create underlying TLS IO.");
@@ -251,7 +298,8 @@ UWS_CLIENT_HANDLE uws_client_create(const char* hostname, unsigned int port, con
 
                                     /* Codes_SRS_UWS_CLIENT_01_008: [ The obtained interface shall be used to create the IO used as underlying IO by the newly created uws instance. ]*/
                                     /* Codes_SRS_UWS_CLIENT_01_009: [ The underlying IO shall be created by calling `xio_create`. ]*/
-                                    result->underlying_io = xio_create(socketio_interface, &socketio_config);
+                                    /* Codes_SRS_UWS_CLIENT_03_004: [ If `arena` is not NULL, `uws_client_create_with_arena` shall create the underlying IO by calling `xio_create_with_arena` with `arena` instead of `xio_create`. ]*/
+                                    result->underlying_io = (arena == NULL) ? xio_create(socketio_interface, &socketio_config) : xio_create_with_arena(socketio_interface, &socketio_config, arena);
                                     if (result->underlying_io == NULL)
                                     {
                                         LogError("Cannot create underlying socket IO.");
@@ -263,10 +311,11 @@ UWS_CLIENT_HANDLE uws_client_create(const char* hostname, unsigned int port, con
                             {
                                 /* Codes_SRS_UWS_CLIENT_01_016: [ If `xio_create` fails, then `uws_client_create` shall fail and return NULL. ]*/
                                 singlylinkedlist_destroy(result->pending_sends);
+                                slab_destroy(result->pending_send_slab);
                                 Map_Destroy(result->request_headers);
-                                free(result->resource_name);
-                                free(result->hostname);
-                                free(result);
+                                arena_free_or_heap(arena, result->resource_name);
+                                arena_free_or_heap(arena, result->hostname);
+                                arena_free_or_heap(arena, result);
                                 result = NULL;
                             }
                             else
@@ -286,17 +335,18 @@ UWS_CLIENT_HANDLE uws_client_create(const char* hostname, unsigned int port, con
                                 }
                                 else
                                 {
-                                    result->protocols = (WS_INSTANCE_PROTOCOL*)malloc(sizeof(WS_INSTANCE_PROTOCOL) * protocol_count);
+                                    result->protocols = (WS_INSTANCE_PROTOCOL*)arena_malloc_or_heap(arena, sizeof(WS_INSTANCE_PROTOCOL) * protocol_count);
                                     if (result->protocols == NULL)
                                     {
                                         /* Codes_SRS_UWS_CLIENT_01_414: [ If allocating memory for the copied protocol information fails then `uws_client_create` shall fail and return NULL. ]*/
                                         LogError("Cannot allocate memory for the protocols array.");
                                         xio_destroy(result->underlying_io);
                                         singlylinkedlist_destroy(result->pending_sends);
+                                        slab_destroy(result->pending_send_slab);
                                         Map_Destroy(result->request_headers);
-                                        free(result->resource_name);
-                                        free(result->hostname);
-                                        free(result);
+                                        arena_free_or_heap(arena, result->resource_name);
+                                        arena_free_or_heap(arena, result->hostname);
+                                        arena_free_or_heap(arena, result);
                                         result = NULL;
                                     }
                                     else
@@ -304,7 +354,7 @@ UWS_CLIENT_HANDLE uws_client_create(const char* hostname, unsigned int port, con
                                         /* Codes_SRS_UWS_CLIENT_01_413: [ The protocol information indicated by `protocols` and `protocol_count` shall be copied for later use (for constructing the upgrade request). ]*/
                                         for (i = 0; i < protocol_count; i++)
                                         {
-                                            if (mallocAndStrcpy_s(&result->protocols[i].protocol, protocols[i].protocol) != 0)
+                                            if (uws_client_copy_string(arena, &result->protocols[i].protocol, protocols[i].protocol) != 0)
                                             {
                                                 /* Codes_SRS_UWS_CLIENT_01_414: [ If allocating memory for the copied protocol information fails then `uws_client_create` shall fail and return NULL. ]*/
                                                 LogError("Cannot allocate memory for the protocol index %u.", (unsigned int)i);
@@ -318,16 +368,17 @@ UWS_CLIENT_HANDLE uws_client_create(const char* hostname, unsigned int port, con
 
                                             for (j = 0; j < i; j++)
                                             {
-                                                free(result->protocols[j].protocol);
+                                                arena_free_or_heap(arena, result->protocols[j].protocol);
                                             }
 
-                                            free(result->protocols);
+                                            arena_free_or_heap(arena, result->protocols);
                                             xio_destroy(result->underlying_io);
                                             singlylinkedlist_destroy(result->pending_sends);
+                                            slab_destroy(result->pending_send_slab);
                                             Map_Destroy(result->request_headers);
-                                            free(result->resource_name);
-                                            free(result->hostname);
-                                            free(result);
+                                            arena_free_or_heap(arena, result->resource_name);
+                                            arena_free_or_heap(arena, result->hostname);
+                                            arena_free_or_heap(arena, result);
                                             result = NULL;
                                         }
                                         else
@@ -348,6 +399,12 @@ UWS_CLIENT_HANDLE uws_client_create(const char* hostname, unsigned int port, con
 }
 
 UWS_CLIENT_HANDLE uws_client_create_with_io(const IO_INTERFACE_DESCRIPTION* io_interface, void* io_create_parameters, const char* hostname, unsigned int port, const char* resource_name, const WS_PROTOCOL* protocols, size_t protocol_count)
+{
+    return uws_client_create_with_io_and_arena(NULL, io_interface, io_create_parameters, hostname, port, resource_name, protocols, protocol_count);
+}
+
+/* Codes_SRS_UWS_CLIENT_03_002: [ `uws_client_create_with_io_and_arena` shall behave like `uws_client_create_with_io`. ]*/
+UWS_CLIENT_HANDLE uws_client_create_with_io_and_arena(ARENA_HANDLE arena, const IO_INTERFACE_DESCRIPTION* io_interface, void* io_create_parameters, const char* hostname, unsigned int port, const char* resource_name, const WS_PROTOCOL* protocols, size_t protocol_count)
 {
     UWS_CLIENT_HANDLE result;
 
@@ -381,7 +438,7 @@ UWS_CLIENT_HANDLE uws_client_create_with_io(const IO_INTERFACE_DESCRIPTION* io_i
         else
         {
             /* Codes_SRS_UWS_CLIENT_01_515: [ `uws_client_create_with_io` shall create an instance of uws and return a non-NULL handle to it. ]*/
-            result = (UWS_CLIENT_HANDLE)malloc(sizeof(UWS_CLIENT_INSTANCE));
+            result = (UWS_CLIENT_HANDLE)arena_malloc_or_heap(arena, sizeof(UWS_CLIENT_INSTANCE));
             if (result == NULL)
             {
                 /* Codes_SRS_UWS_CLIENT_01_517: [ If allocating memory for the new uws instance fails then `uws_client_create_with_io` shall return NULL. ]*/
@@ -390,32 +447,33 @@ UWS_CLIENT_HANDLE uws_client_create_with_io(const IO_INTERFACE_DESCRIPTION* io_i
             else
             {
                 memset(result, 0, sizeof(UWS_CLIENT_INSTANCE));
+                result->arena = arena;
 
                 /* Codes_SRS_UWS_CLIENT_01_518: [ The argument `hostname` shall be copied for later use. ]*/
-                if (mallocAndStrcpy_s(&result->hostname, hostname) != 0)
+                if (uws_client_copy_string(arena, &result->hostname, hostname) != 0)
                 {
                     /* Codes_SRS_UWS_CLIENT_01_519: [ If allocating memory for the copy of the `hostname` argument fails, then `uws_client_create` shall return NULL. ]*/
                     LogError("Could not copy hostname.");
-                    free(result);
+                    arena_free_or_heap(arena, result);
                     result = NULL;
                 }
                 else
                 {
                     /* Codes_SRS_UWS_CLIENT_01_523: [ The argument `resource_name` shall be copied for later use. ]*/
-                    if (mallocAndStrcpy_s(&result->resource_name, resource_name) != 0)
+                    if (uws_client_copy_string(arena, &result->resource_name, resource_name) != 0)
                     {
                         /* Codes_SRS_UWS_CLIENT_01_529: [ If allocating memory for the copy of the `resource_name` argument fails, then `uws_client_create_with_io` shall return NULL. ]*/
                         LogError("Could not copy resource.");
-                        free(result->hostname);
-                        free(result);
+                        arena_free_or_heap(arena, result->hostname);
+                        arena_free_or_heap(arena, result);
                         result = NULL;
                     }
-                    else if ((result->request_headers = Map_Create(NULL)) == NULL)
+                    else if ((result->request_headers = Map_CreateWithInternedKeys(NULL)) == NULL)
                     {
                         LogError("Failed allocating MAP for request headers");
-                        free(result->resource_name);
-                        free(result->hostname);
-                        free(result);
+                        arena_free_or_heap(arena, result->resource_name);
+                        arena_free_or_heap(arena, result->hostname);
+                        arena_free_or_heap(arena, result);
                         result = NULL;
                     }
                     else
@@ -427,9 +485,21 @@ UWS_CLIENT_HANDLE uws_client_create_with_io(const IO_INTERFACE_DESCRIPTION* io_i
                             /* Codes_SRS_UWS_CLIENT_01_531: [ If `singlylinkedlist_create` fails then `uws_client_create_with_io` shall fail and return NULL. ]*/
                             LogError("Could not allocate pending send frames list");
                             Map_Destroy(result->request_headers);
-                            free(result->resource_name);
-                            free(result->hostname);
-                            free(result);
+                            arena_free_or_heap(arena, result->resource_name);
+                            arena_free_or_heap(arena, result->hostname);
+                            arena_free_or_heap(arena, result);
+                            result = NULL;
+                        }
+                        /* Codes_SRS_UWS_CLIENT_03_007: [ `uws_client_create_with_io` shall create a slab for the pending sends by calling `slab_create`. ]*/
+                        else if ((result->pending_send_slab = slab_create(sizeof(WS_PENDING_SEND), PENDING_SENDS_PER_CHUNK)) == NULL)
+                        {
+                            /* Codes_SRS_UWS_CLIENT_03_008: [ If `slab_create` fails then `uws_client_create_with_io` shall fail and return NULL. ]*/
+                            LogError("Could not create pending send frames slab");
+                            singlylinkedlist_destroy(result->pending_sends);
+                            Map_Destroy(result->request_headers);
+                            arena_free_or_heap(arena, result->resource_name);
+                            arena_free_or_heap(arena, result->hostname);
+                            arena_free_or_heap(arena, result);
                             result = NULL;
                         }
                         else
@@ -441,10 +511,11 @@ UWS_CLIENT_HANDLE uws_client_create_with_io(const IO_INTERFACE_DESCRIPTION* io_i
                                 /* Codes_SRS_UWS_CLIENT_01_522: [ If `xio_create` fails, then `uws_client_create_with_io` shall fail and return NULL. ]*/
                                 LogError("Cannot create underlying IO.");
                                 singlylinkedlist_destroy(result->pending_sends);
+                                slab_destroy(result->pending_send_slab);
                                 Map_Destroy(result->request_headers);
-                                free(result->resource_name);
-                                free(result->hostname);
-                                free(result);
+                                arena_free_or_heap(arena, result->resource_name);
+                                arena_free_or_heap(arena, result->hostname);
+                                arena_free_or_heap(arena, result);
                                 result = NULL;
                             }
                             else
@@ -465,17 +536,18 @@ UWS_CLIENT_HANDLE uws_client_create_with_io(const IO_INTERFACE_DESCRIPTION* io_i
                                 }
                                 else
                                 {
-                                    result->protocols = (WS_INSTANCE_PROTOCOL*)malloc(sizeof(WS_INSTANCE_PROTOCOL) * protocol_count);
+                                    result->protocols = (WS_INSTANCE_PROTOCOL*)arena_malloc_or_heap(arena, sizeof(WS_INSTANCE_PROTOCOL) * protocol_count);
                                     if (result->protocols == NULL)
                                     {
                                         /* Codes_SRS_UWS_CLIENT_01_414: [ If allocating memory for the copied protocol information fails then `uws_client_create` shall fail and return NULL. ]*/
                                         LogError("Cannot allocate memory for the protocols array.");
                                         xio_destroy(result->underlying_io);
                                         singlylinkedlist_destroy(result->pending_sends);
+                                        slab_destroy(result->pending_send_slab);
                                         Map_Destroy(result->request_headers);
-                                        free(result->resource_name);
-                                        free(result->hostname);
-                                        free(result);
+                                        arena_free_or_heap(arena, result->resource_name);
+                                        arena_free_or_heap(arena, result->hostname);
+                                        arena_free_or_heap(arena, result);
                                         result = NULL;
                                     }
                                     else
@@ -483,7 +555,7 @@ UWS_CLIENT_HANDLE uws_client_create_with_io(const IO_INTERFACE_DESCRIPTION* io_i
                                         /* Codes_SRS_UWS_CLIENT_01_527: [ The protocol information indicated by `protocols` and `protocol_count` shall be copied for later use (for constructing the upgrade request). ]*/
                                         for (i = 0; i < protocol_count; i++)
                                         {
-                                            if (mallocAndStrcpy_s(&result->protocols[i].protocol, protocols[i].protocol) != 0)
+                                            if (uws_client_copy_string(arena, &result->protocols[i].protocol, protocols[i].protocol) != 0)
                                             {
                                                 /* Codes_SRS_UWS_CLIENT_01_528: [ If allocating memory for the copied protocol information fails then `uws_client_create_with_io` shall fail and return NULL. ]*/
                                                 LogError("Cannot allocate memory for the protocol index %u.", (unsigned int)i);
@@ -497,16 +569,17 @@ UWS_CLIENT_HANDLE uws_client_create_with_io(const IO_INTERFACE_DESCRIPTION* io_i
 
                                             for (j = 0; j < i; j++)
                                             {
-                                                free(result->protocols[j].protocol);
+                                                arena_free_or_heap(arena, result->protocols[j].protocol);
                                             }
 
-                                            free(result->protocols);
+                                            arena_free_or_heap(arena, result->protocols);
                                             xio_destroy(result->underlying_io);
                                             singlylinkedlist_destroy(result->pending_sends);
+                                            slab_destroy(result->pending_send_slab);
                                             Map_Destroy(result->request_headers);
-                                            free(result->resource_name);
-                                            free(result->hostname);
-                                            free(result);
+                                            arena_free_or_heap(arena, result->resource_name);
+                                            arena_free_or_heap(arena, result->hostname);
+                                            arena_free_or_heap(arena, result);
                                             result = NULL;
                                         }
                                         else
@@ -559,11 +632,11 @@ void uws_client_destroy(UWS_CLIENT_HANDLE uws_client)
             {
 #pragma warning(push)
 #pragma warning(disable:6001)
-                free(uws_client->protocols[i].protocol);
+                arena_free_or_heap(uws_client->arena, uws_client->protocols[i].protocol);
 #pragma warning(pop) // C6001
             }
 
-            free(uws_client->protocols);
+            arena_free_or_heap(uws_client->arena, uws_client->protocols);
         }
 
         /* Codes_SRS_UWS_CLIENT_01_019: [ `uws_client_destroy` shall free all resources associated with the uws instance. ]*/
@@ -578,10 +651,13 @@ void uws_client_destroy(UWS_CLIENT_HANDLE uws_client)
         clear_pending_sends(uws_client);
         /* Codes_SRS_UWS_CLIENT_01_024: [ `uws_client_destroy` shall free the list used to track the pending sends by calling `singlylinkedlist_destroy`. ]*/
         singlylinkedlist_destroy(uws_client->pending_sends);
-        free(uws_client->resource_name);
-        free(uws_client->hostname);
+        /* Codes_SRS_UWS_CLIENT_03_009: [ `uws_client_destroy` shall destroy the pending send slab by calling `slab_destroy`. ]*/
+        slab_destroy(uws_client->pending_send_slab);
+        /* Codes_SRS_UWS_CLIENT_03_003: [ Memory obtained from the arena shall not be freed by `uws_client_destroy`. ]*/
+        arena_free_or_heap(uws_client->arena, uws_client->resource_name);
+        arena_free_or_heap(uws_client->arena, uws_client->hostname);
         Map_Destroy(uws_client->request_headers);
-        free(uws_client);
+        arena_free_or_heap(uws_client->arena, uws_client);
     }
 }
 
@@ -1806,15 +1882,19 @@ static int complete_send_frame(WS_PENDING_SEND* ws_pending_send, LIST_ITEM_HANDL
     }
     else
     {
-        if (ws_pending_send->on_ws_send_frame_complete != NULL)
+        ON_WS_SEND_FRAME_COMPLETE on_ws_send_frame_complete = ws_pending_send->on_ws_send_frame_complete;
+        void* context = ws_pending_send->context;
+
+        /* Codes_SRS_UWS_CLIENT_01_434: [ The memory associated with the sent frame shall be freed. ]*/
+        /* Codes_SRS_UWS_CLIENT_03_010: [ The sent frame shall be returned to the pending send slab by calling `slab_free` before the `on_ws_send_frame_complete` callback is called, as the callback may destroy the uws instance. ]*/
+        slab_free(uws_client->pending_send_slab, ws_pending_send);
+
+        if (on_ws_send_frame_complete != NULL)
         {
             /* Codes_SRS_UWS_CLIENT_01_037: [ When indicating pending send frames as cancelled the callback context passed to the `on_ws_send_frame_complete` callback shall be the context given to `uws_client_send_frame_async`. ]*/
-            ws_pending_send->on_ws_send_frame_complete(ws_pending_send->context, ws_send_frame_result);
+            on_ws_send_frame_complete(context, ws_send_frame_result);
         }
 
-        /* Codes_SRS_UWS_CLIENT_01_434: [ The memory associated with the sent frame shall be freed. ]*/
-        free(ws_pending_send);
-
         result = 0;
     }
 
@@ -2009,7 +2089,8 @@ int uws_client_send_frame_async(UWS_CLIENT_HANDLE uws_client, unsigned char fram
     }
     else
     {
-        WS_PENDING_SEND* ws_pending_send = (WS_PENDING_SEND*)malloc(sizeof(WS_PENDING_SEND));
+        /* Codes_SRS_UWS_CLIENT_03_011: [ The memory for the queued item shall be obtained from the pending send slab by calling `slab_malloc`. ]*/
+        WS_PENDING_SEND* ws_pending_send = (WS_PENDING_SEND*)slab_malloc(uws_client->pending_send_slab);
         if (ws_pending_send == NULL)
         {
             /* Codes_SRS_UWS_CLIENT_01_047: [ If allocating memory for the newly queued item fails, `uws_client_send_frame_async` shall fail and return a non-zero value. ]*/
@@ -2029,7 +2110,7 @@ int uws_client_send_frame_async(UWS_CLIENT_HANDLE uws_client, unsigned char fram
             {
                 /* Codes_SRS_UWS_CLIENT_01_426: [ If `uws_frame_encoder_encode` fails, `uws_client_send_frame_async` shall fail and return a non-zero value. ]*/
                 LogError("Failed encoding WebSocket frame");
-                free(ws_pending_send);
+                slab_free(uws_client->pending_send_slab, ws_pending_send);
                 result = __FAILURE__;
             }
             else
@@ -2057,7 +2138,7 @@ int uws_client_send_frame_async(UWS_CLIENT_HANDLE uws_client, unsigned char fram
                 {
                     /* Codes_SRS_UWS_CLIENT_01_049: [ If `singlylinkedlist_add` fails, `uws_client_send_frame_async` shall fail and return a non-zero value. ]*/
                     LogError("Could not allocate memory for pending frames");
-                    free(ws_pending_send);
+                    slab_free(uws_client->pending_send_slab, ws_pending_send);
                     result = __FAILURE__;
                 }
                 else
@@ -2080,7 +2161,7 @@ int uws_client_send_frame_async(UWS_CLIENT_HANDLE uws_client, unsigned char fram
                             // Guards against double free in case the underlying I/O invoked 'on_underlying_io_send_complete' within xio_send,
                             // in which the message is already removed from the list and freed.
                             (void)singlylinkedlist_remove(uws_client->pending_sends, new_pending_send_list_item);
-                            free(ws_pending_send);
+                            slab_free(uws_client->pending_send_slab, ws_pending_send);
                         }
 
                         result = __FAILURE__;
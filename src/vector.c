@@ -2,6 +2,7 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <stdlib.h>
+#include <stdint.h>
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/vector.h"
 #include "azure_c_shared_utility/optimize_size.h"
@@ -9,6 +10,59 @@
 
 #include "azure_c_shared_utility/vector_types_internal.h"
 
+/* reallocates the storage to hold exactly capacity elements */
+static int VECTOR_set_capacity(VECTOR* handle, size_t capacity)
+{
+    int result;
+    void* temp;
+
+    if (capacity > SIZE_MAX / handle->elementSize)
+    {
+        LogError("capacity(%zd) elements of size %zd overflow size_t.", capacity, handle->elementSize);
+        result = __FAILURE__;
+    }
+    else if ((temp = realloc(handle->storage, handle->elementSize * capacity)) == NULL)
+    {
+        LogError("realloc failed.");
+        result = __FAILURE__;
+    }
+    else
+    {
+        handle->storage = temp;
+        handle->capacity = capacity;
+        result = 0;
+    }
+    return result;
+}
+
+/* makes room for numElements more elements, growing the capacity geometrically so that pushing one element at a time costs amortized O(1) reallocs */
+static int VECTOR_grow(VECTOR* handle, size_t numElements)
+{
+    int result;
+    if (numElements > SIZE_MAX - handle->count)
+    {
+        LogError("numElements(%zd) overflows the vector size.", numElements);
+        result = __FAILURE__;
+    }
+    else if (handle->count + numElements <= handle->capacity)
+    {
+        /* Codes_SRS_VECTOR_03_002: [VECTOR_push_back shall not allocate memory if the capacity of the vector is enough for the new elements.] */
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_VECTOR_03_001: [If the capacity of the vector is not enough for the new elements, VECTOR_push_back shall grow it to the larger of the needed number of elements and twice the capacity.] */
+        size_t needed = handle->count + numElements;
+        size_t new_capacity = (handle->capacity > SIZE_MAX / 2) ? needed : handle->capacity * 2;
+        if (new_capacity < needed)
+        {
+            new_capacity = needed;
+        }
+        result = VECTOR_set_capacity(handle, new_capacity);
+    }
+    return result;
+}
+
 VECTOR_HANDLE VECTOR_create(size_t elementSize)
 {
     VECTOR_HANDLE result;
@@ -32,6 +86,7 @@ VECTOR_HANDLE VECTOR_create(size_t elementSize)
             /* Codes_SRS_VECTOR_10_001: [VECTOR_create shall allocate a VECTOR_HANDLE that will contain an empty vector.The size of each element is given with the parameter elementSize.] */
             result->storage = NULL;
             result->count = 0;
+            result->capacity = 0;
             result->elementSize = elementSize;
         }
     }
@@ -74,11 +129,13 @@ VECTOR_HANDLE VECTOR_move(VECTOR_HANDLE handle)
         {
             /* Codes_SRS_VECTOR_10_004: [VECTOR_move shall allocate a VECTOR_HANDLE and move the data to it from the given handle.] */
             result->count = handle->count;
+            result->capacity = handle->capacity;
             result->elementSize = handle->elementSize;
             result->storage = handle->storage;
 
             handle->storage = NULL;
             handle->count = 0;
+            handle->capacity = 0;
         }
     }
     return result;
@@ -99,21 +156,16 @@ int VECTOR_push_back(VECTOR_HANDLE handle, const void* elements, size_t numEleme
     }
     else
     {
-        size_t curSize = handle->elementSize * handle->count;
-        size_t appendSize = handle->elementSize * numElements;
-
-        void* temp = realloc(handle->storage, curSize + appendSize);
-        if (temp == NULL)
+        if (VECTOR_grow(handle, numElements) != 0)
         {
            /* Codes_SRS_VECTOR_10_012: [VECTOR_push_back shall fail and return non-zero if memory allocation fails.] */
-            LogError("realloc failed.");
+            LogError("unable to grow the vector.");
             result = __FAILURE__;
         }
         else
         {
             /* Codes_SRS_VECTOR_10_013: [VECTOR_push_back shall append the given elements and return 0 indicating success.] */
-            (void)memcpy((unsigned char*)temp + curSize, elements, appendSize);
-            handle->storage = temp;
+            (void)memcpy((unsigned char*)handle->storage + (handle->elementSize * handle->count), elements, handle->elementSize * numElements);
             handle->count += numElements;
             result = 0;
         }
@@ -159,33 +211,46 @@ void VECTOR_erase(VECTOR_HANDLE handle, void* elements, size_t numElements)
                 }
                 else
                 {
-                    /* Codes_SRS_VECTOR_10_014: [VECTOR_erase shall remove the 'numElements' starting at 'elements' and reduce its internal storage.] */
+                    /* Codes_SRS_VECTOR_10_014: [VECTOR_erase shall remove the 'numElements' starting at 'elements'.] */
+                    /* Codes_SRS_VECTOR_03_003: [VECTOR_erase shall keep the capacity of the vector for reuse.] */
+                    (void)memmove(elements, src, srcEnd - src);
                     handle->count -= numElements;
-                    if (handle->count == 0)
-                    {
-                        free(handle->storage);
-                        handle->storage = NULL;
-                    }
-                    else
-                    {
-                        void* tmp;
-                        (void)memmove(elements, src, srcEnd - src);
-                        tmp = realloc(handle->storage, (handle->elementSize * handle->count));
-                        if (tmp == NULL)
-                        {
-                            LogInfo("realloc failed. Keeping original internal storage pointer.");
-                        }
-                        else
-                        {
-                            handle->storage = tmp;
-                        }
-                    }
                 }
             }
         }
     }
 }
 
+void VECTOR_erase_unordered(VECTOR_HANDLE handle, void* element)
+{
+    if (handle == NULL || element == NULL)
+    {
+        /* Codes_SRS_VECTOR_03_017: [VECTOR_erase_unordered shall return if `handle` or `element` is NULL.] */
+        LogError("invalid argument - handle(%p), element(%p).", handle, element);
+    }
+    else if ((element < handle->storage) ||
+        ((unsigned char*)element >= (unsigned char*)handle->storage + (handle->elementSize * handle->count)))
+    {
+        /* Codes_SRS_VECTOR_03_018: [VECTOR_erase_unordered shall return if `element` is out of bound.] */
+        LogError("invalid argument element(%p) is not a member of this object.", element);
+    }
+    else if (((size_t)((unsigned char*)element - (unsigned char*)handle->storage) % handle->elementSize) != 0)
+    {
+        /* Codes_SRS_VECTOR_03_019: [VECTOR_erase_unordered shall return if `element` is misaligned.] */
+        LogError("invalid argument - element(%p) is misaligned", element);
+    }
+    else
+    {
+        /* Codes_SRS_VECTOR_03_020: [VECTOR_erase_unordered shall remove `element` by moving the last element of the vector in its place, keeping the capacity of the vector.] */
+        unsigned char* last = (unsigned char*)handle->storage + (handle->elementSize * (handle->count - 1));
+        if ((unsigned char*)element != last)
+        {
+            (void)memcpy(element, last, handle->elementSize);
+        }
+        handle->count--;
+    }
+}
+
 void VECTOR_clear(VECTOR_HANDLE handle)
 {
     /* Codes_SRS_VECTOR_10_017: [VECTOR_clear shall if the object is NULL or empty.] */
@@ -199,6 +264,7 @@ void VECTOR_clear(VECTOR_HANDLE handle)
         free(handle->storage);
         handle->storage = NULL;
         handle->count = 0;
+        handle->capacity = 0;
     }
 }
 
@@ -318,6 +384,62 @@ void* VECTOR_find_if(VECTOR_HANDLE handle, PREDICATE_FUNCTION pred, const void*
     return result;
 }
 
+/* ordering */
+
+void VECTOR_sort(VECTOR_HANDLE handle, COMPARE_FUNCTION compare)
+{
+    if (handle == NULL || compare == NULL)
+    {
+        /* Codes_SRS_VECTOR_03_021: [VECTOR_sort shall return if `handle` or `compare` is NULL.] */
+        LogError("invalid argument - handle(%p), compare(%p)", handle, compare);
+    }
+    else if (handle->count > 1)
+    {
+        /* Codes_SRS_VECTOR_03_022: [VECTOR_sort shall sort the elements of the vector in ascending order according to `compare`.] */
+        qsort(handle->storage, handle->count, handle->elementSize, compare);
+    }
+}
+
+void* VECTOR_lower_bound(VECTOR_HANDLE handle, COMPARE_FUNCTION compare, const void* value)
+{
+    void* result;
+    if (handle == NULL || compare == NULL || value == NULL)
+    {
+        /* Codes_SRS_VECTOR_03_023: [VECTOR_lower_bound shall fail and return NULL if `handle`, `compare` or `value` is NULL.] */
+        LogError("invalid argument - handle(%p), compare(%p), value(%p)", handle, compare, value);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_VECTOR_03_024: [VECTOR_lower_bound shall return, with a binary search of the vector sorted by `compare`, the first element that does not compare less than `value`.] */
+        size_t low = 0;
+        size_t high = handle->count;
+        while (low < high)
+        {
+            size_t middle = low + ((high - low) / 2);
+            if (compare((unsigned char*)handle->storage + (handle->elementSize * middle), value) < 0)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+
+        if (low == handle->count)
+        {
+            /* Codes_SRS_VECTOR_03_025: [VECTOR_lower_bound shall return NULL if all the elements compare less than `value`.] */
+            result = NULL;
+        }
+        else
+        {
+            result = (unsigned char*)handle->storage + (handle->elementSize * low);
+        }
+    }
+    return result;
+}
+
 /* capacity */
 
 size_t VECTOR_size(VECTOR_HANDLE handle)
@@ -336,3 +458,86 @@ size_t VECTOR_size(VECTOR_HANDLE handle)
     }
     return result;
 }
+
+size_t VECTOR_capacity(VECTOR_HANDLE handle)
+{
+    size_t result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_VECTOR_03_015: [VECTOR_capacity shall return 0 if the given handle is NULL.] */
+        LogError("invalid argument handle(NULL).");
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_VECTOR_03_016: [VECTOR_capacity shall return the number of elements the vector can hold without allocating memory.] */
+        result = handle->capacity;
+    }
+    return result;
+}
+
+int VECTOR_reserve(VECTOR_HANDLE handle, size_t numElements)
+{
+    int result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_VECTOR_03_004: [VECTOR_reserve shall fail and return non-zero if `handle` is NULL.] */
+        LogError("invalid argument handle(NULL).");
+        result = __FAILURE__;
+    }
+    else if (numElements <= handle->capacity)
+    {
+        /* Codes_SRS_VECTOR_03_005: [If the capacity of the vector is at least `numElements`, VECTOR_reserve shall return 0 without allocating memory.] */
+        result = 0;
+    }
+    /* Codes_SRS_VECTOR_03_006: [Otherwise VECTOR_reserve shall reallocate the storage to hold exactly `numElements` elements, keeping the elements of the vector.] */
+    else if (VECTOR_set_capacity(handle, numElements) != 0)
+    {
+        /* Codes_SRS_VECTOR_03_007: [If any error occurs, VECTOR_reserve shall fail, leave the vector unchanged and return non-zero.] */
+        LogError("unable to reserve %zd elements.", numElements);
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_VECTOR_03_008: [On success VECTOR_reserve shall return 0.] */
+        result = 0;
+    }
+    return result;
+}
+
+int VECTOR_shrink_to_fit(VECTOR_HANDLE handle)
+{
+    int result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_VECTOR_03_009: [VECTOR_shrink_to_fit shall fail and return non-zero if `handle` is NULL.] */
+        LogError("invalid argument handle(NULL).");
+        result = __FAILURE__;
+    }
+    else if (handle->capacity == handle->count)
+    {
+        /* Codes_SRS_VECTOR_03_010: [If the vector has no unused capacity, VECTOR_shrink_to_fit shall return 0 without allocating memory.] */
+        result = 0;
+    }
+    else if (handle->count == 0)
+    {
+        /* Codes_SRS_VECTOR_03_011: [If the vector is empty, VECTOR_shrink_to_fit shall release its internal storage and return 0.] */
+        free(handle->storage);
+        handle->storage = NULL;
+        handle->capacity = 0;
+        result = 0;
+    }
+    /* Codes_SRS_VECTOR_03_012: [Otherwise VECTOR_shrink_to_fit shall reallocate the storage to hold exactly the elements of the vector.] */
+    else if (VECTOR_set_capacity(handle, handle->count) != 0)
+    {
+        /* Codes_SRS_VECTOR_03_013: [If reallocating fails, VECTOR_shrink_to_fit shall fail, leave the vector unchanged and return non-zero.] */
+        LogError("unable to shrink the vector to %zd elements.", handle->count);
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_VECTOR_03_014: [On success VECTOR_shrink_to_fit shall return 0.] */
+        result = 0;
+    }
+    return result;
+}
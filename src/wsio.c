@@ -10,6 +10,7 @@
 #include "azure_c_shared_utility/wsio.h"
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/slab.h"
 #include "azure_c_shared_utility/optionhandler.h"
 #include "azure_c_shared_utility/xio.h"
 #include "azure_c_shared_utility/shared_util_options.h"
@@ -35,6 +36,8 @@ typedef struct PENDING_IO_TAG
     void* wsio;
 } PENDING_IO;
 
+#define PENDING_IOS_PER_CHUNK 8
+
 typedef struct WSIO_INSTANCE_TAG
 {
     ON_BYTES_RECEIVED on_bytes_received;
@@ -47,6 +50,7 @@ typedef struct WSIO_INSTANCE_TAG
     void* on_io_close_complete_context;
     IO_STATE io_state;
     SINGLYLINKEDLIST_HANDLE pending_io_list;
+    SLAB_HANDLE pending_io_slab;
     UWS_CLIENT_HANDLE uws;
 } WSIO_INSTANCE;
 
@@ -65,6 +69,8 @@ static void complete_send_item(LIST_ITEM_HANDLE pending_io_list_item, IO_SEND_RE
 {
     PENDING_IO* pending_io = (PENDING_IO*)singlylinkedlist_item_get_value(pending_io_list_item);
     WSIO_INSTANCE* wsio_instance = (WSIO_INSTANCE*)pending_io->wsio;
+    ON_SEND_COMPLETE on_send_complete = pending_io->on_send_complete;
+    void* callback_context = pending_io->callback_context;
 
     /* Codes_SRS_WSIO_01_145: [ Removing it from the list shall be done by calling `singlylinkedlist_remove`. ]*/
     if (singlylinkedlist_remove(wsio_instance->pending_io_list, pending_io_list_item) != 0)
@@ -72,14 +78,15 @@ static void complete_send_item(LIST_ITEM_HANDLE pending_io_list_item, IO_SEND_RE
         LogError("Failed removing pending IO from linked list.");
     }
 
+    /* Codes_SRS_WSIO_01_144: [ Also the pending IO data shall be freed. ]*/
+    /* Codes_SRS_WSIO_03_004: [ The pending IO data shall be returned to the pending IO slab by calling `slab_free` before the `on_send_complete` callback is called, as the callback may destroy the wsio instance. ]*/
+    slab_free(wsio_instance->pending_io_slab, pending_io);
+
     /* Codes_SRS_WSIO_01_105: [ The argument `on_send_complete` shall be optional, if NULL is passed by the caller then no send complete callback shall be triggered. ]*/
-    if (pending_io->on_send_complete != NULL)
+    if (on_send_complete != NULL)
     {
-        pending_io->on_send_complete(pending_io->callback_context, io_send_result);
+        on_send_complete(callback_context, io_send_result);
     }
-
-    /* Codes_SRS_WSIO_01_144: [ Also the pending IO data shall be freed. ]*/
-    free(pending_io);
 }
 
 static void on_underlying_ws_send_frame_complete(void* context, WS_SEND_FRAME_RESULT ws_send_frame_result)
@@ -201,7 +208,8 @@ static int internal_close(WSIO_INSTANCE* wsio_instance, ON_IO_CLOSE_COMPLETE on_
     return result;
 }
 
-CONCRETE_IO_HANDLE wsio_create(void* io_create_parameters)
+/* Codes_SRS_WSIO_03_004: [ `wsio_create_with_arena` shall create the wsio instance like `wsio_create`. ]*/
+CONCRETE_IO_HANDLE wsio_create_with_arena(void* io_create_parameters, ARENA_HANDLE arena)
 {
     /* Codes_SRS_WSIO_01_066: [ `io_create_parameters` shall be used as a `WSIO_CONFIG*` . ]*/
     WSIO_CONFIG* ws_io_config = (WSIO_CONFIG*)io_create_parameters;
@@ -249,7 +257,15 @@ CONCRETE_IO_HANDLE wsio_create(void* io_create_parameters)
             /* Codes_SRS_WSIO_01_130: [ - `port` set to the `port` field in the `io_create_parameters` passed to `wsio_create`. ]*/
             /* Codes_SRS_WSIO_01_128: [ - `resource_name` set to the `resource_name` field in the `io_create_parameters` passed to `wsio_create`. ]*/
             /* Codes_SRS_WSIO_01_129: [ - `protocols` shall be filled with only one structure, that shall have the `protocol` set to the value of the `protocol` field in the `io_create_parameters` passed to `wsio_create`. ]*/
-            result->uws = uws_client_create_with_io(ws_io_config->underlying_io_interface, ws_io_config->underlying_io_parameters, ws_io_config->hostname, ws_io_config->port, ws_io_config->resource_name, &protocols, 1);
+            if (arena == NULL)
+            {
+                result->uws = uws_client_create_with_io(ws_io_config->underlying_io_interface, ws_io_config->underlying_io_parameters, ws_io_config->hostname, ws_io_config->port, ws_io_config->resource_name, &protocols, 1);
+            }
+            else
+            {
+                /* Codes_SRS_WSIO_03_001: [ If `arena` is not NULL, `wsio_create_with_arena` shall create the underlying uws instance by calling `uws_client_create_with_io_and_arena` with `arena` and the same arguments. ]*/
+                result->uws = uws_client_create_with_io_and_arena(arena, ws_io_config->underlying_io_interface, ws_io_config->underlying_io_parameters, ws_io_config->hostname, ws_io_config->port, ws_io_config->resource_name, &protocols, 1);
+            }
             if (result->uws == NULL)
             {
                 /* Codes_SRS_WSIO_01_075: [ If `uws_client_create_with_io` fails, then `wsio_create` shall fail and return NULL. ]*/
@@ -269,6 +285,16 @@ CONCRETE_IO_HANDLE wsio_create(void* io_create_parameters)
                     free(result);
                     result = NULL;
                 }
+                /* Codes_SRS_WSIO_03_002: [ `wsio_create` shall create a slab for the pending send IO entries by calling `slab_create`. ]*/
+                else if ((result->pending_io_slab = slab_create(sizeof(PENDING_IO), PENDING_IOS_PER_CHUNK)) == NULL)
+                {
+                    /* Codes_SRS_WSIO_03_003: [ If `slab_create` fails then `wsio_create` shall fail and return NULL. ]*/
+                    LogError("Cannot create pending IO slab.");
+                    singlylinkedlist_destroy(result->pending_io_list);
+                    uws_client_destroy(result->uws);
+                    free(result);
+                    result = NULL;
+                }
                 else
                 {
                     result->io_state = IO_STATE_NOT_OPEN;
@@ -301,6 +327,8 @@ void wsio_destroy(CONCRETE_IO_HANDLE ws_io)
         uws_client_destroy(wsio_instance->uws);
         /* Codes_SRS_WSIO_01_081: [ `wsio_destroy` shall free the list used to track the pending send IOs by calling `singlylinkedlist_destroy`. ]*/
         singlylinkedlist_destroy(wsio_instance->pending_io_list);
+        /* Codes_SRS_WSIO_03_005: [ `wsio_destroy` shall destroy the pending IO slab by calling `slab_destroy`. ]*/
+        slab_destroy(wsio_instance->pending_io_slab);
         free(ws_io);
     }
 }
@@ -596,7 +624,8 @@ int wsio_send(CONCRETE_IO_HANDLE ws_io, const void* buffer, size_t size, ON_SEND
         else
         {
             LIST_ITEM_HANDLE new_item;
-            PENDING_IO* pending_socket_io = (PENDING_IO*)malloc(sizeof(PENDING_IO));
+            /* Codes_SRS_WSIO_03_006: [ The memory for the pending IO data shall be obtained from the pending IO slab by calling `slab_malloc`. ]*/
+            PENDING_IO* pending_socket_io = (PENDING_IO*)slab_malloc(wsio_instance->pending_io_slab);
             if (pending_socket_io == NULL)
             {
                 /* Codes_SRS_WSIO_01_134: [ If allocating memory for the pending IO data fails, `wsio_send` shall fail and return a non-zero value. ]*/
@@ -613,7 +642,7 @@ int wsio_send(CONCRETE_IO_HANDLE ws_io, const void* buffer, size_t size, ON_SEND
                 if ((new_item = singlylinkedlist_add(wsio_instance->pending_io_list, pending_socket_io)) == NULL)
                 {
                     /* Codes_SRS_WSIO_01_104: [ If `singlylinkedlist_add` fails, `wsio_send` shall fail and return a non-zero value. ]*/
-                    free(pending_socket_io);
+                    slab_free(wsio_instance->pending_io_slab, pending_socket_io);
                     result = __FAILURE__;
                 }
                 else
@@ -628,7 +657,7 @@ int wsio_send(CONCRETE_IO_HANDLE ws_io, const void* buffer, size_t size, ON_SEND
                             LogError("Failed removing pending IO from linked list.");
                         }
 
-                        free(pending_socket_io);
+                        slab_free(wsio_instance->pending_io_slab, pending_socket_io);
                         result = __FAILURE__;
                     }
                     else
@@ -822,6 +851,11 @@ OPTIONHANDLER_HANDLE wsio_retrieveoptions(CONCRETE_IO_HANDLE handle)
     return result;
 }
 
+CONCRETE_IO_HANDLE wsio_create(void* io_create_parameters)
+{
+    return wsio_create_with_arena(io_create_parameters, NULL);
+}
+
 static const IO_INTERFACE_DESCRIPTION ws_io_interface_description =
 {
     wsio_retrieveoptions,
@@ -831,7 +865,8 @@ static const IO_INTERFACE_DESCRIPTION ws_io_interface_description =
     wsio_close,
     wsio_send,
     wsio_dowork,
-    wsio_setoption
+    wsio_setoption,
+    wsio_create_with_arena
 };
 
 const IO_INTERFACE_DESCRIPTION* wsio_get_interface_description(void)
@@ -3,6 +3,8 @@
 
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xio.h"
@@ -16,7 +18,7 @@ typedef struct XIO_INSTANCE_TAG
     CONCRETE_IO_HANDLE concrete_xio_handle;
 } XIO_INSTANCE;
 
-XIO_HANDLE xio_create(const IO_INTERFACE_DESCRIPTION* io_interface_description, const void* xio_create_parameters)
+static XIO_HANDLE xio_create_internal(const IO_INTERFACE_DESCRIPTION* io_interface_description, const void* xio_create_parameters, ARENA_HANDLE arena)
 {
     XIO_INSTANCE* xio_instance;
     /* Codes_SRS_XIO_01_003: [If the argument io_interface_description is NULL, xio_create shall return NULL.] */
@@ -43,8 +45,18 @@ XIO_HANDLE xio_create(const IO_INTERFACE_DESCRIPTION* io_interface_description,
             /* Codes_SRS_XIO_01_001: [xio_create shall return on success a non-NULL handle to a new IO interface.] */
             xio_instance->io_interface_description = io_interface_description;
 
-            /* Codes_SRS_XIO_01_002: [In order to instantiate the concrete IO implementation the function concrete_io_create from the io_interface_description shall be called, passing the xio_create_parameters argument.] */
-            xio_instance->concrete_xio_handle = xio_instance->io_interface_description->concrete_io_create((void*)xio_create_parameters);
+            if ((arena != NULL) &&
+                (xio_instance->io_interface_description->concrete_io_create_with_arena != NULL))
+            {
+                /* Codes_SRS_XIO_03_039: [ If arena is not NULL and the io_interface_description has a concrete_io_create_with_arena function, xio_create_with_arena shall call it passing the xio_create_parameters and arena arguments. ]*/
+                xio_instance->concrete_xio_handle = xio_instance->io_interface_description->concrete_io_create_with_arena((void*)xio_create_parameters, arena);
+            }
+            else
+            {
+                /* Codes_SRS_XIO_01_002: [In order to instantiate the concrete IO implementation the function concrete_io_create from the io_interface_description shall be called, passing the xio_create_parameters argument.] */
+                /* Codes_SRS_XIO_03_040: [ Otherwise xio_create_with_arena shall call concrete_io_create like xio_create, the IO is then allocated on the heap. ]*/
+                xio_instance->concrete_xio_handle = xio_instance->io_interface_description->concrete_io_create((void*)xio_create_parameters);
+            }
 
             /* Codes_SRS_XIO_01_016: [If the underlying concrete_io_create call fails, xio_create shall return NULL.] */
             if (xio_instance->concrete_xio_handle == NULL)
@@ -57,6 +69,17 @@ XIO_HANDLE xio_create(const IO_INTERFACE_DESCRIPTION* io_interface_description,
     return (XIO_HANDLE)xio_instance;
 }
 
+XIO_HANDLE xio_create(const IO_INTERFACE_DESCRIPTION* io_interface_description, const void* xio_create_parameters)
+{
+    return xio_create_internal(io_interface_description, xio_create_parameters, NULL);
+}
+
+/* Codes_SRS_XIO_03_038: [ xio_create_with_arena shall behave like xio_create. ]*/
+XIO_HANDLE xio_create_with_arena(const IO_INTERFACE_DESCRIPTION* io_interface_description, const void* xio_create_parameters, ARENA_HANDLE arena)
+{
+    return xio_create_internal(io_interface_description, xio_create_parameters, arena);
+}
+
 void xio_destroy(XIO_HANDLE xio)
 {
     /* Codes_SRS_XIO_01_007: [If the argument io is NULL, xio_destroy shall do nothing.] */
@@ -154,6 +177,86 @@ int xio_send(XIO_HANDLE xio, const void* buffer, size_t size, ON_SEND_COMPLETE o
     return result;
 }
 
+int xio_sendv(XIO_HANDLE xio, const CONSTBUFFER* buffers, size_t buffer_count, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    int result;
+
+    if ((xio == NULL) ||
+        (buffers == NULL) ||
+        (buffer_count == 0))
+    {
+        /* Codes_SRS_XIO_03_032: [ If xio or buffers is NULL or buffer_count is 0, xio_sendv shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: XIO_HANDLE xio=%p, const CONSTBUFFER* buffers=%p, size_t buffer_count=%lu", xio, buffers, (unsigned long)buffer_count);
+        result = __FAILURE__;
+    }
+    else
+    {
+        XIO_INSTANCE* xio_instance = (XIO_INSTANCE*)xio;
+
+        if (xio_instance->io_interface_description->concrete_io_sendv != NULL)
+        {
+            /* Codes_SRS_XIO_03_033: [ If the concrete IO implementation has a concrete_io_sendv function, xio_sendv shall call it passing down buffers, buffer_count, on_send_complete and callback_context. ]*/
+            /* Codes_SRS_XIO_03_037: [ If the underlying send fails, xio_sendv shall fail and return a non-zero value. ]*/
+            result = xio_instance->io_interface_description->concrete_io_sendv(xio_instance->concrete_xio_handle, buffers, buffer_count, on_send_complete, callback_context);
+        }
+        else if (buffer_count == 1)
+        {
+            /* Codes_SRS_XIO_03_034: [ Otherwise, if buffer_count is 1, xio_sendv shall call concrete_io_send with the buffer, on_send_complete and callback_context. ]*/
+            result = xio_instance->io_interface_description->concrete_io_send(xio_instance->concrete_xio_handle, buffers[0].buffer, buffers[0].size, on_send_complete, callback_context);
+        }
+        else
+        {
+            size_t total_size = 0;
+            size_t i;
+
+            for (i = 0; i < buffer_count; i++)
+            {
+                if (buffers[i].size > SIZE_MAX - total_size)
+                {
+                    break;
+                }
+                total_size += buffers[i].size;
+            }
+
+            if (i < buffer_count)
+            {
+                /* Codes_SRS_XIO_03_036: [ If any error occurs, xio_sendv shall fail and return a non-zero value. ]*/
+                LogError("The size of the buffers overflows.");
+                result = __FAILURE__;
+            }
+            else
+            {
+                /* Codes_SRS_XIO_03_035: [ Otherwise xio_sendv shall copy the buffers in order into one allocation, call concrete_io_send with it, on_send_complete and callback_context, and free it. ]*/
+                unsigned char* gathered = (unsigned char*)malloc(total_size == 0 ? 1 : total_size);
+                if (gathered == NULL)
+                {
+                    /* Codes_SRS_XIO_03_036: [ If any error occurs, xio_sendv shall fail and return a non-zero value. ]*/
+                    LogError("Failure allocating %lu bytes to gather the buffers.", (unsigned long)total_size);
+                    result = __FAILURE__;
+                }
+                else
+                {
+                    size_t offset = 0;
+                    for (i = 0; i < buffer_count; i++)
+                    {
+                        if (buffers[i].size > 0)
+                        {
+                            (void)memcpy(gathered + offset, buffers[i].buffer, buffers[i].size);
+                            offset += buffers[i].size;
+                        }
+                    }
+
+                    /* Codes_SRS_XIO_03_037: [ If the underlying send fails, xio_sendv shall fail and return a non-zero value. ]*/
+                    result = xio_instance->io_interface_description->concrete_io_send(xio_instance->concrete_xio_handle, gathered, total_size, on_send_complete, callback_context);
+                    free(gathered);
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
 void xio_dowork(XIO_HANDLE xio)
 {
     /* Codes_SRS_XIO_01_018: [When the handle argument is NULL, xio_dowork shall do nothing.] */
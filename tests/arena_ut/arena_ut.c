@@ -0,0 +1,484 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+void* my_gballoc_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void my_gballoc_free(void* ptr)
+{
+    free(ptr);
+}
+
+#include "umock_c.h"
+#include "azure_c_shared_utility/arena.h"
+
+#define ENABLE_MOCKS
+
+#include "azure_c_shared_utility/gballoc.h"
+
+#undef ENABLE_MOCKS
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+#define TEST_BLOCK_SIZE 256
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(arena_unittests)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+/* arena_create */
+
+/* Tests_SRS_ARENA_03_002: [ arena_create shall allocate the arena together with its first block of block_size bytes in a single allocation and return a non-NULL handle. ]*/
+TEST_FUNCTION(arena_create_succeeds)
+{
+    // arrange
+    ARENA_HANDLE result;
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+    // act
+    result = arena_create(TEST_BLOCK_SIZE);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 0, arena_get_allocated_size(result));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    arena_destroy(result);
+}
+
+/* Tests_SRS_ARENA_03_001: [ If block_size is 0, arena_create shall use ARENA_DEFAULT_BLOCK_SIZE. ]*/
+TEST_FUNCTION(arena_create_with_0_block_size_uses_the_default_block_size)
+{
+    // arrange
+    ARENA_HANDLE result;
+    result = arena_create(0);
+    umock_c_reset_all_calls();
+
+    // act
+    (void)arena_malloc(result, ARENA_DEFAULT_BLOCK_SIZE / 2);
+    (void)arena_malloc(result, ARENA_DEFAULT_BLOCK_SIZE / 2);
+
+    // assert
+    /* both fit in the first block */
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    arena_destroy(result);
+}
+
+/* Tests_SRS_ARENA_03_003: [ If any error occurs, arena_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_fails_arena_create_fails)
+{
+    // arrange
+    ARENA_HANDLE result;
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    // act
+    result = arena_create(TEST_BLOCK_SIZE);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_ARENA_03_003: [ If any error occurs, arena_create shall fail and return NULL. ]*/
+TEST_FUNCTION(arena_create_with_a_block_size_too_large_fails)
+{
+    // arrange
+    ARENA_HANDLE result;
+
+    // act
+    result = arena_create(SIZE_MAX);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* arena_destroy */
+
+/* Tests_SRS_ARENA_03_004: [ If arena is NULL, arena_destroy shall return. ]*/
+TEST_FUNCTION(arena_destroy_with_NULL_arena_returns)
+{
+    // arrange
+
+    // act
+    arena_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_ARENA_03_005: [ arena_destroy shall free all the blocks of the arena and the arena itself. ]*/
+TEST_FUNCTION(arena_destroy_frees_all_the_blocks)
+{
+    // arrange
+    ARENA_HANDLE arena = arena_create(TEST_BLOCK_SIZE);
+    /* one block of its own, the first block filled up and one more block */
+    (void)arena_malloc(arena, TEST_BLOCK_SIZE);
+    (void)arena_malloc(arena, TEST_BLOCK_SIZE / 2);
+    (void)arena_malloc(arena, TEST_BLOCK_SIZE / 2);
+    (void)arena_malloc(arena, TEST_BLOCK_SIZE / 4);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(arena));
+
+    // act
+    arena_destroy(arena);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* arena_malloc */
+
+/* Tests_SRS_ARENA_03_006: [ If arena is NULL or size is 0, arena_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(arena_malloc_with_NULL_arena_fails)
+{
+    // arrange
+    void* result;
+
+    // act
+    result = arena_malloc(NULL, 1);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_ARENA_03_006: [ If arena is NULL or size is 0, arena_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(arena_malloc_with_0_size_fails)
+{
+    // arrange
+    void* result;
+    ARENA_HANDLE arena = arena_create(TEST_BLOCK_SIZE);
+    umock_c_reset_all_calls();
+
+    // act
+    result = arena_malloc(arena, 0);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    arena_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_03_007: [ arena_malloc shall return the next size bytes of the current block, aligned for any type. ]*/
+TEST_FUNCTION(arena_malloc_returns_aligned_consecutive_memory_without_allocating)
+{
+    // arrange
+    unsigned char* result1;
+    unsigned char* result2;
+    ARENA_HANDLE arena = arena_create(TEST_BLOCK_SIZE);
+    umock_c_reset_all_calls();
+
+    // act
+    result1 = (unsigned char*)arena_malloc(arena, 1);
+    result2 = (unsigned char*)arena_malloc(arena, 3);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result1);
+    ASSERT_IS_NOT_NULL(result2);
+    ASSERT_IS_TRUE(result2 > result1);
+    ASSERT_ARE_EQUAL(size_t, 0, (size_t)((uintptr_t)result1 % sizeof(void*)));
+    ASSERT_ARE_EQUAL(size_t, 0, (size_t)((uintptr_t)result2 % sizeof(void*)));
+    ASSERT_ARE_EQUAL(size_t, (size_t)(result2 - result1) * 2, arena_get_allocated_size(arena));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    arena_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_03_008: [ If the current block does not have size bytes left, arena_malloc shall allocate a new block of the arena block size and continue from it. ]*/
+TEST_FUNCTION(when_the_block_is_full_arena_malloc_allocates_a_new_block)
+{
+    // arrange
+    void* result;
+    ARENA_HANDLE arena = arena_create(TEST_BLOCK_SIZE);
+    (void)arena_malloc(arena, TEST_BLOCK_SIZE / 2);
+    (void)arena_malloc(arena, TEST_BLOCK_SIZE / 2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+    // act
+    result = arena_malloc(arena, 1);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    arena_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_03_009: [ If size is larger than half of the block size, arena_malloc shall serve it from a block of its own, keeping the current block for the following allocations. ]*/
+TEST_FUNCTION(arena_malloc_serves_a_large_allocation_from_its_own_block)
+{
+    // arrange
+    void* large;
+    void* small;
+    ARENA_HANDLE arena = arena_create(TEST_BLOCK_SIZE);
+    (void)arena_malloc(arena, TEST_BLOCK_SIZE / 2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+    // act
+    large = arena_malloc(arena, TEST_BLOCK_SIZE * 4);
+    small = arena_malloc(arena, TEST_BLOCK_SIZE / 4);
+
+    // assert
+    ASSERT_IS_NOT_NULL(large);
+    ASSERT_IS_NOT_NULL(small);
+    (void)memset(large, 0, TEST_BLOCK_SIZE * 4);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    arena_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_03_010: [ If allocating a new block fails, arena_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(when_allocating_a_new_block_fails_arena_malloc_fails)
+{
+    // arrange
+    void* result;
+    ARENA_HANDLE arena = arena_create(TEST_BLOCK_SIZE);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    // act
+    result = arena_malloc(arena, TEST_BLOCK_SIZE * 4);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 0, arena_get_allocated_size(arena));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    arena_destroy(arena);
+}
+
+/* arena_copy_string */
+
+/* Tests_SRS_ARENA_03_011: [ If arena or source is NULL, arena_copy_string shall fail and return NULL. ]*/
+TEST_FUNCTION(arena_copy_string_with_NULL_arena_fails)
+{
+    // arrange
+    char* result;
+
+    // act
+    result = arena_copy_string(NULL, "test");
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_ARENA_03_011: [ If arena or source is NULL, arena_copy_string shall fail and return NULL. ]*/
+TEST_FUNCTION(arena_copy_string_with_NULL_source_fails)
+{
+    // arrange
+    char* result;
+    ARENA_HANDLE arena = arena_create(TEST_BLOCK_SIZE);
+    umock_c_reset_all_calls();
+
+    // act
+    result = arena_copy_string(arena, NULL);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    arena_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_03_012: [ arena_copy_string shall copy source, including its terminating zero, to memory obtained with arena_malloc and return it. ]*/
+TEST_FUNCTION(arena_copy_string_copies_the_string)
+{
+    // arrange
+    char* result;
+    ARENA_HANDLE arena = arena_create(TEST_BLOCK_SIZE);
+    umock_c_reset_all_calls();
+
+    // act
+    result = arena_copy_string(arena, "some.host.name");
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, "some.host.name", result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    arena_destroy(arena);
+}
+
+/* Tests_SRS_ARENA_03_013: [ If arena_malloc fails, arena_copy_string shall fail and return NULL. ]*/
+TEST_FUNCTION(when_arena_malloc_fails_arena_copy_string_fails)
+{
+    // arrange
+    char* result;
+    char source[TEST_BLOCK_SIZE * 2];
+    ARENA_HANDLE arena = arena_create(TEST_BLOCK_SIZE);
+    umock_c_reset_all_calls();
+
+    (void)memset(source, 'a', sizeof(source) - 1);
+    source[sizeof(source) - 1] = '\0';
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    // act
+    result = arena_copy_string(arena, source);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    arena_destroy(arena);
+}
+
+/* arena_get_allocated_size */
+
+/* Tests_SRS_ARENA_03_014: [ If arena is NULL, arena_get_allocated_size shall return 0. ]*/
+TEST_FUNCTION(arena_get_allocated_size_with_NULL_arena_returns_0)
+{
+    // arrange
+    size_t result;
+
+    // act
+    result = arena_get_allocated_size(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, result);
+}
+
+/* Tests_SRS_ARENA_03_015: [ arena_get_allocated_size shall return the number of bytes handed out by arena_malloc, including the alignment padding. ]*/
+TEST_FUNCTION(arena_get_allocated_size_counts_all_the_blocks)
+{
+    // arrange
+    size_t result;
+    ARENA_HANDLE arena = arena_create(TEST_BLOCK_SIZE);
+    (void)arena_malloc(arena, TEST_BLOCK_SIZE / 2);
+    (void)arena_malloc(arena, TEST_BLOCK_SIZE * 2);
+
+    // act
+    result = arena_get_allocated_size(arena);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, TEST_BLOCK_SIZE / 2 + TEST_BLOCK_SIZE * 2, result);
+
+    // cleanup
+    arena_destroy(arena);
+}
+
+/* arena_malloc_or_heap */
+
+/* Tests_SRS_ARENA_03_016: [ If arena is NULL, arena_malloc_or_heap shall return the result of malloc(size). ]*/
+/* Tests_SRS_ARENA_03_018: [ If arena is NULL, arena_free_or_heap shall call free(ptr). ]*/
+TEST_FUNCTION(arena_malloc_or_heap_with_NULL_arena_uses_the_heap)
+{
+    // arrange
+    ARENA_HANDLE arena = NULL;
+    void* result;
+
+    // act
+    result = arena_malloc_or_heap(arena, TEST_BLOCK_SIZE);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+
+    // cleanup
+    arena_free_or_heap(arena, result);
+}
+
+/* Tests_SRS_ARENA_03_017: [ Otherwise arena_malloc_or_heap shall return the result of arena_malloc(arena, size). ]*/
+/* Tests_SRS_ARENA_03_019: [ Otherwise arena_free_or_heap shall do nothing, the memory is released by arena_destroy. ]*/
+TEST_FUNCTION(arena_malloc_or_heap_with_an_arena_uses_the_arena)
+{
+    // arrange
+    void* result;
+    ARENA_HANDLE arena = arena_create(TEST_BLOCK_SIZE);
+    umock_c_reset_all_calls();
+
+    // act
+    result = arena_malloc_or_heap(arena, TEST_BLOCK_SIZE / 4);
+    arena_free_or_heap(arena, result);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, TEST_BLOCK_SIZE / 4, arena_get_allocated_size(arena));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    arena_destroy(arena);
+}
+
+END_TEST_SUITE(arena_unittests)
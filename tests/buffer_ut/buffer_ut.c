@@ -1635,4 +1635,330 @@ BEGIN_TEST_SUITE(Buffer_UnitTests)
         BUFFER_delete(buffer);
     }
 
+    /* Tests_SRS_BUFFER_03_001: [ If the capacity of the buffer is smaller than the new size, the buffer shall be reallocated to the larger of the new size and twice the capacity. ] */
+    TEST_FUNCTION(BUFFER_append_build_grows_capacity_geometrically)
+    {
+        //arrange
+        int nResult;
+        BUFFER_HANDLE hBuffer;
+        hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 * ALLOCATION_SIZE))
+            .IgnoreArgument(1);
+
+        //act
+        nResult = BUFFER_append_build(hBuffer, BUFFER_Test1, BUFFER_TEST1_SIZE);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE + BUFFER_TEST1_SIZE, BUFFER_length(hBuffer));
+        ASSERT_ARE_EQUAL(size_t, 2 * ALLOCATION_SIZE, BUFFER_capacity(hBuffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hBuffer) + ALLOCATION_SIZE, BUFFER_Test1, BUFFER_TEST1_SIZE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_03_001: [ If the capacity of the buffer is smaller than the new size, the buffer shall be reallocated to the larger of the new size and twice the capacity. ] */
+    TEST_FUNCTION(BUFFER_append_build_larger_than_twice_the_capacity_grows_to_the_new_size)
+    {
+        //arrange
+        int nResult;
+        BUFFER_HANDLE hBuffer;
+        hBuffer = BUFFER_create(BUFFER_Test1, BUFFER_TEST1_SIZE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, BUFFER_TEST1_SIZE + ALLOCATION_SIZE))
+            .IgnoreArgument(1);
+
+        //act
+        nResult = BUFFER_append_build(hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, BUFFER_TEST1_SIZE + ALLOCATION_SIZE, BUFFER_capacity(hBuffer));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_03_002: [ If the capacity of the buffer is enough for the new size, no memory shall be allocated. ] */
+    TEST_FUNCTION(BUFFER_append_build_within_capacity_does_not_allocate)
+    {
+        //arrange
+        int nResult;
+        BUFFER_HANDLE hBuffer;
+        hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        (void)BUFFER_append_build(hBuffer, BUFFER_Test1, BUFFER_TEST1_SIZE);
+        umock_c_reset_all_calls();
+
+        //act
+        nResult = BUFFER_append_build(hBuffer, BUFFER_Test2, BUFFER_TEST2_SIZE);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE + BUFFER_TEST1_SIZE + BUFFER_TEST2_SIZE, BUFFER_length(hBuffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hBuffer), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hBuffer) + ALLOCATION_SIZE, BUFFER_Test1, BUFFER_TEST1_SIZE));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hBuffer) + ALLOCATION_SIZE + BUFFER_TEST1_SIZE, BUFFER_Test2, BUFFER_TEST2_SIZE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_03_002: [ If the capacity of the buffer is enough for the new size, no memory shall be allocated. ] */
+    TEST_FUNCTION(BUFFER_enlarge_within_capacity_does_not_allocate)
+    {
+        //arrange
+        int nResult;
+        BUFFER_HANDLE hBuffer;
+        hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        (void)BUFFER_reserve(hBuffer, TOTAL_ALLOCATION_SIZE);
+        umock_c_reset_all_calls();
+
+        //act
+        nResult = BUFFER_enlarge(hBuffer, ALLOCATION_SIZE);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, TOTAL_ALLOCATION_SIZE, BUFFER_length(hBuffer));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_03_003: [ If handle is NULL, BUFFER_reserve shall fail and return a non-zero value. ] */
+    TEST_FUNCTION(BUFFER_reserve_with_NULL_handle_fails)
+    {
+        //arrange
+        int nResult;
+
+        //act
+        nResult = BUFFER_reserve(NULL, ALLOCATION_SIZE);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_BUFFER_03_005: [ Otherwise BUFFER_reserve shall reallocate the buffer to exactly capacity bytes, keeping its content and its length. ] */
+    /* Tests_SRS_BUFFER_03_007: [ On success BUFFER_reserve shall return 0. ] */
+    TEST_FUNCTION(BUFFER_reserve_reallocates_to_the_capacity)
+    {
+        //arrange
+        int nResult;
+        BUFFER_HANDLE hBuffer;
+        hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 3 * ALLOCATION_SIZE))
+            .IgnoreArgument(1);
+
+        //act
+        nResult = BUFFER_reserve(hBuffer, 3 * ALLOCATION_SIZE);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE, BUFFER_length(hBuffer));
+        ASSERT_ARE_EQUAL(size_t, 3 * ALLOCATION_SIZE, BUFFER_capacity(hBuffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hBuffer), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_03_005: [ Otherwise BUFFER_reserve shall reallocate the buffer to exactly capacity bytes, keeping its content and its length. ] */
+    TEST_FUNCTION(BUFFER_reserve_on_an_empty_buffer_keeps_the_length_0)
+    {
+        //arrange
+        int nResult;
+        BUFFER_HANDLE hBuffer;
+        hBuffer = BUFFER_new();
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(NULL, ALLOCATION_SIZE));
+
+        //act
+        nResult = BUFFER_reserve(hBuffer, ALLOCATION_SIZE);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, 0, BUFFER_length(hBuffer));
+        ASSERT_IS_NULL(BUFFER_u_char(hBuffer));
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE, BUFFER_capacity(hBuffer));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_03_004: [ If the capacity of the buffer is already at least capacity, BUFFER_reserve shall succeed without allocating memory. ] */
+    TEST_FUNCTION(BUFFER_reserve_below_the_capacity_does_not_allocate)
+    {
+        //arrange
+        int nResult;
+        BUFFER_HANDLE hBuffer;
+        hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        umock_c_reset_all_calls();
+
+        //act
+        nResult = BUFFER_reserve(hBuffer, BUFFER_TEST1_SIZE);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE, BUFFER_capacity(hBuffer));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_03_006: [ If reallocating fails, BUFFER_reserve shall fail, leave the buffer unchanged and return a non-zero value. ] */
+    TEST_FUNCTION(when_realloc_fails_BUFFER_reserve_fails)
+    {
+        //arrange
+        int nResult;
+        BUFFER_HANDLE hBuffer;
+        hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 3 * ALLOCATION_SIZE))
+            .IgnoreArgument(1)
+            .SetReturn(NULL);
+
+        //act
+        nResult = BUFFER_reserve(hBuffer, 3 * ALLOCATION_SIZE);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE, BUFFER_capacity(hBuffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hBuffer), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_03_008: [ If handle is NULL, BUFFER_shrink_to_fit shall fail and return a non-zero value. ] */
+    TEST_FUNCTION(BUFFER_shrink_to_fit_with_NULL_handle_fails)
+    {
+        //arrange
+        int nResult;
+
+        //act
+        nResult = BUFFER_shrink_to_fit(NULL);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_BUFFER_03_010: [ Otherwise BUFFER_shrink_to_fit shall reallocate the buffer to its length (1 byte if the length is 0), keeping its content. ] */
+    /* Tests_SRS_BUFFER_03_012: [ On success BUFFER_shrink_to_fit shall return 0. ] */
+    TEST_FUNCTION(BUFFER_shrink_to_fit_reallocates_to_the_length)
+    {
+        //arrange
+        int nResult;
+        BUFFER_HANDLE hBuffer;
+        hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        (void)BUFFER_append_build(hBuffer, BUFFER_Test1, BUFFER_TEST1_SIZE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, ALLOCATION_SIZE + BUFFER_TEST1_SIZE))
+            .IgnoreArgument(1);
+
+        //act
+        nResult = BUFFER_shrink_to_fit(hBuffer);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE + BUFFER_TEST1_SIZE, BUFFER_capacity(hBuffer));
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE + BUFFER_TEST1_SIZE, BUFFER_length(hBuffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hBuffer), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hBuffer) + ALLOCATION_SIZE, BUFFER_Test1, BUFFER_TEST1_SIZE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_03_009: [ If the buffer has no unused capacity, BUFFER_shrink_to_fit shall succeed without allocating memory. ] */
+    TEST_FUNCTION(BUFFER_shrink_to_fit_without_unused_capacity_does_not_allocate)
+    {
+        //arrange
+        int nResult;
+        BUFFER_HANDLE hBuffer;
+        hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        umock_c_reset_all_calls();
+
+        //act
+        nResult = BUFFER_shrink_to_fit(hBuffer);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE, BUFFER_capacity(hBuffer));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_03_011: [ If reallocating fails, BUFFER_shrink_to_fit shall fail, leave the buffer unchanged and return a non-zero value. ] */
+    TEST_FUNCTION(when_realloc_fails_BUFFER_shrink_to_fit_fails)
+    {
+        //arrange
+        int nResult;
+        BUFFER_HANDLE hBuffer;
+        hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        (void)BUFFER_append_build(hBuffer, BUFFER_Test1, BUFFER_TEST1_SIZE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, ALLOCATION_SIZE + BUFFER_TEST1_SIZE))
+            .IgnoreArgument(1)
+            .SetReturn(NULL);
+
+        //act
+        nResult = BUFFER_shrink_to_fit(hBuffer);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, 2 * ALLOCATION_SIZE, BUFFER_capacity(hBuffer));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        BUFFER_delete(hBuffer);
+    }
+
+    /* Tests_SRS_BUFFER_03_013: [ If handle is NULL, BUFFER_capacity shall return 0. ] */
+    TEST_FUNCTION(BUFFER_capacity_with_NULL_handle_returns_0)
+    {
+        //act
+        size_t capacity = BUFFER_capacity(NULL);
+
+        //assert
+        ASSERT_ARE_EQUAL(size_t, 0, capacity);
+    }
+
+    /* Tests_SRS_BUFFER_03_014: [ BUFFER_capacity shall return the number of bytes the buffer can hold without reallocating. ] */
+    TEST_FUNCTION(BUFFER_capacity_of_a_new_buffer_is_0)
+    {
+        //arrange
+        BUFFER_HANDLE hBuffer = BUFFER_new();
+
+        //act
+        size_t capacity = BUFFER_capacity(hBuffer);
+
+        //assert
+        ASSERT_ARE_EQUAL(size_t, 0, capacity);
+
+        //cleanup
+        BUFFER_delete(hBuffer);
+    }
+
 END_TEST_SUITE(Buffer_UnitTests)
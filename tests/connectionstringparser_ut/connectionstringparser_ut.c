@@ -38,6 +38,7 @@ void* my_gballoc_realloc(void* ptr, size_t size)
 #include "azure_c_shared_utility/strings.h"
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xlogging.h"
+#include "azure_c_shared_utility/string_intern.h"
 #undef ENABLE_MOCKS
 
 #include "azure_c_shared_utility/connection_string_parser.h"
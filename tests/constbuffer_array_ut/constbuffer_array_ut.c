@@ -0,0 +1,857 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+static size_t currentmalloc_call = 0;
+static size_t whenShallmalloc_fail = 0;
+
+void* my_gballoc_malloc(size_t size)
+{
+    void* result;
+    currentmalloc_call++;
+    if (whenShallmalloc_fail > 0)
+    {
+        if (currentmalloc_call == whenShallmalloc_fail)
+        {
+            result = NULL;
+        }
+        else
+        {
+            result = malloc(size);
+        }
+    }
+    else
+    {
+        result = malloc(size);
+    }
+    return result;
+}
+
+void my_gballoc_free(void* ptr)
+{
+    free(ptr);
+}
+
+#define ENABLE_MOCKS
+#include "umock_c.h"
+#include "azure_c_shared_utility/constbuffer.h"
+#include "azure_c_shared_utility/gballoc.h"
+#undef ENABLE_MOCKS
+
+#include "azure_c_shared_utility/constbuffer_array.h"
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+static const unsigned char buffer1[] = { '1' };
+static const unsigned char buffer2[] = { '2', '2' };
+static const unsigned char buffer3[] = { '3', '3', '3' };
+
+static const CONSTBUFFER content1 = { buffer1, sizeof(buffer1) };
+static const CONSTBUFFER content2 = { buffer2, sizeof(buffer2) };
+static const CONSTBUFFER content3 = { buffer3, sizeof(buffer3) };
+static const CONSTBUFFER huge_content = { buffer1, SIZE_MAX };
+
+#define TEST_CONSTBUFFER_HANDLE_1 (CONSTBUFFER_HANDLE)0x4241
+#define TEST_CONSTBUFFER_HANDLE_2 (CONSTBUFFER_HANDLE)0x4242
+#define TEST_CONSTBUFFER_HANDLE_3 (CONSTBUFFER_HANDLE)0x4243
+#define TEST_CONSTBUFFER_HANDLE_HUGE (CONSTBUFFER_HANDLE)0x4244
+
+static const CONSTBUFFER* my_CONSTBUFFER_GetContent(CONSTBUFFER_HANDLE constbufferHandle)
+{
+    const CONSTBUFFER* result;
+    if (constbufferHandle == TEST_CONSTBUFFER_HANDLE_1)
+    {
+        result = &content1;
+    }
+    else if (constbufferHandle == TEST_CONSTBUFFER_HANDLE_2)
+    {
+        result = &content2;
+    }
+    else if (constbufferHandle == TEST_CONSTBUFFER_HANDLE_3)
+    {
+        result = &content3;
+    }
+    else if (constbufferHandle == TEST_CONSTBUFFER_HANDLE_HUGE)
+    {
+        result = &huge_content;
+    }
+    else
+    {
+        result = NULL;
+        ASSERT_FAIL("who am I?");
+    }
+    return result;
+}
+
+static CONSTBUFFER_HANDLE my_CONSTBUFFER_Clone(CONSTBUFFER_HANDLE constbufferHandle)
+{
+    return constbufferHandle;
+}
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static void setup_build_expectations(const CONSTBUFFER_HANDLE* buffers, size_t buffer_count)
+{
+    size_t i;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    for (i = 0; i < buffer_count; i++)
+    {
+        STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(buffers[i]));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_Clone(buffers[i]));
+    }
+}
+
+static CONSTBUFFER_ARRAY_HANDLE create_test_array(void)
+{
+    CONSTBUFFER_HANDLE buffers[] = { TEST_CONSTBUFFER_HANDLE_1, TEST_CONSTBUFFER_HANDLE_2 };
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_create(buffers, sizeof(buffers) / sizeof(buffers[0]));
+    ASSERT_IS_NOT_NULL(result);
+    umock_c_reset_all_calls();
+    return result;
+}
+
+BEGIN_TEST_SUITE(constbuffer_array_unittests)
+
+    TEST_SUITE_INITIALIZE(suite_init)
+    {
+        TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+        g_testByTest = TEST_MUTEX_CREATE();
+        ASSERT_IS_NOT_NULL(g_testByTest);
+
+        umock_c_init(on_umock_c_error);
+
+        REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_HANDLE, void*);
+        REGISTER_UMOCK_ALIAS_TYPE(BUFFER_HANDLE, void*);
+        REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_CUSTOM_FREE_FUNC, void*);
+        REGISTER_UMOCK_ALIAS_TYPE(const CONSTBUFFER*, void*);
+
+        REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+        REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+        REGISTER_GLOBAL_MOCK_HOOK(CONSTBUFFER_GetContent, my_CONSTBUFFER_GetContent);
+        REGISTER_GLOBAL_MOCK_HOOK(CONSTBUFFER_Clone, my_CONSTBUFFER_Clone);
+    }
+
+    TEST_SUITE_CLEANUP(suite_cleanup)
+    {
+        umock_c_deinit();
+
+        TEST_MUTEX_DESTROY(g_testByTest);
+        TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    }
+
+    TEST_FUNCTION_INITIALIZE(method_init)
+    {
+        if (TEST_MUTEX_ACQUIRE(g_testByTest))
+        {
+            ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+        }
+
+        umock_c_reset_all_calls();
+
+        currentmalloc_call = 0;
+        whenShallmalloc_fail = 0;
+    }
+
+    TEST_FUNCTION_CLEANUP(method_cleanup)
+    {
+        TEST_MUTEX_RELEASE(g_testByTest);
+    }
+
+    /* constbuffer_array_create */
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_001: [ If buffers is NULL and buffer_count is not 0, constbuffer_array_create shall fail and return NULL. ]*/
+    TEST_FUNCTION(constbuffer_array_create_with_NULL_buffers_fails)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE result;
+
+        ///act
+        result = constbuffer_array_create(NULL, 1);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_002: [ If any of the buffers is NULL, constbuffer_array_create shall fail and return NULL. ]*/
+    TEST_FUNCTION(constbuffer_array_create_with_a_NULL_buffer_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE buffers[] = { TEST_CONSTBUFFER_HANDLE_1, NULL };
+        CONSTBUFFER_ARRAY_HANDLE result;
+
+        ///act
+        result = constbuffer_array_create(buffers, 2);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_003: [ constbuffer_array_create shall allocate the array and its contents in a single allocation, take a new reference to each of the buffers and return a handle with its ref count set to 1. ]*/
+    TEST_FUNCTION(constbuffer_array_create_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE buffers[] = { TEST_CONSTBUFFER_HANDLE_1, TEST_CONSTBUFFER_HANDLE_2, TEST_CONSTBUFFER_HANDLE_3 };
+        CONSTBUFFER_ARRAY_HANDLE result;
+        size_t buffer_count;
+        size_t all_buffers_size;
+
+        setup_build_expectations(buffers, 3);
+
+        ///act
+        result = constbuffer_array_create(buffers, 3);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+        ASSERT_ARE_EQUAL(size_t, 3, buffer_count);
+        ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size(result, &all_buffers_size));
+        ASSERT_ARE_EQUAL(size_t, 6, all_buffers_size);
+
+        ///cleanup
+        constbuffer_array_destroy(result);
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_003: [ constbuffer_array_create shall allocate the array and its contents in a single allocation, take a new reference to each of the buffers and return a handle with its ref count set to 1. ]*/
+    TEST_FUNCTION(constbuffer_array_create_with_0_buffers_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE result;
+        size_t buffer_count;
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+        ///act
+        result = constbuffer_array_create(NULL, 0);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+        ASSERT_ARE_EQUAL(size_t, 0, buffer_count);
+
+        ///cleanup
+        constbuffer_array_destroy(result);
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_004: [ If any error occurs, constbuffer_array_create shall fail and return NULL. ]*/
+    TEST_FUNCTION(constbuffer_array_create_fails_when_malloc_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE buffers[] = { TEST_CONSTBUFFER_HANDLE_1, TEST_CONSTBUFFER_HANDLE_2 };
+        CONSTBUFFER_ARRAY_HANDLE result;
+
+        whenShallmalloc_fail = 1;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+        ///act
+        result = constbuffer_array_create(buffers, 2);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_004: [ If any error occurs, constbuffer_array_create shall fail and return NULL. ]*/
+    TEST_FUNCTION(constbuffer_array_create_fails_when_the_total_size_overflows)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE buffers[] = { TEST_CONSTBUFFER_HANDLE_1, TEST_CONSTBUFFER_HANDLE_HUGE };
+        CONSTBUFFER_ARRAY_HANDLE result;
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_Clone(TEST_CONSTBUFFER_HANDLE_1));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_HUGE));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_Destroy(TEST_CONSTBUFFER_HANDLE_1));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+        ///act
+        result = constbuffer_array_create(buffers, 2);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_004: [ If any error occurs, constbuffer_array_create shall fail and return NULL. ]*/
+    TEST_FUNCTION(constbuffer_array_create_fails_when_CONSTBUFFER_GetContent_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE buffers[] = { TEST_CONSTBUFFER_HANDLE_1, TEST_CONSTBUFFER_HANDLE_2 };
+        CONSTBUFFER_ARRAY_HANDLE result;
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_Clone(TEST_CONSTBUFFER_HANDLE_1));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(CONSTBUFFER_Destroy(TEST_CONSTBUFFER_HANDLE_1));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+        ///act
+        result = constbuffer_array_create(buffers, 2);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* constbuffer_array_create_empty */
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_005: [ constbuffer_array_create_empty shall create an array with no buffers and its ref count set to 1. ]*/
+    TEST_FUNCTION(constbuffer_array_create_empty_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE result;
+        const CONSTBUFFER* contents;
+        size_t buffer_count;
+        size_t all_buffers_size;
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+        ///act
+        result = constbuffer_array_create_empty();
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size(result, &all_buffers_size));
+        ASSERT_ARE_EQUAL(size_t, 0, all_buffers_size);
+        ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_contents(result, &contents, &buffer_count));
+        ASSERT_IS_NULL(contents);
+        ASSERT_ARE_EQUAL(size_t, 0, buffer_count);
+
+        ///cleanup
+        constbuffer_array_destroy(result);
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_006: [ If any error occurs, constbuffer_array_create_empty shall fail and return NULL. ]*/
+    TEST_FUNCTION(constbuffer_array_create_empty_fails_when_malloc_fails)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE result;
+
+        whenShallmalloc_fail = 1;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+        ///act
+        result = constbuffer_array_create_empty();
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* constbuffer_array_clone */
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_007: [ If constbuffer_array_handle is NULL, constbuffer_array_clone shall fail and return NULL. ]*/
+    TEST_FUNCTION(constbuffer_array_clone_with_NULL_handle_fails)
+    {
+        ///act
+        CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_clone(NULL);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_008: [ Otherwise constbuffer_array_clone shall increment the ref count and return constbuffer_array_handle. ]*/
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_010: [ Otherwise constbuffer_array_destroy shall decrement the ref count. ]*/
+    TEST_FUNCTION(constbuffer_array_clone_increments_the_ref_count)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+        CONSTBUFFER_ARRAY_HANDLE result;
+
+        ///act
+        result = constbuffer_array_clone(array);
+        constbuffer_array_destroy(array);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, array, result);
+        /* the clone still holds the buffers and the memory */
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        constbuffer_array_destroy(result);
+    }
+
+    /* constbuffer_array_destroy */
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_009: [ If constbuffer_array_handle is NULL, constbuffer_array_destroy shall return. ]*/
+    TEST_FUNCTION(constbuffer_array_destroy_with_NULL_handle_returns)
+    {
+        ///act
+        constbuffer_array_destroy(NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_011: [ If the ref count reaches 0, constbuffer_array_destroy shall release its reference to each of the buffers and free the array. ]*/
+    TEST_FUNCTION(constbuffer_array_destroy_releases_the_buffers)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+
+        STRICT_EXPECTED_CALL(CONSTBUFFER_Destroy(TEST_CONSTBUFFER_HANDLE_1));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_Destroy(TEST_CONSTBUFFER_HANDLE_2));
+        STRICT_EXPECTED_CALL(gballoc_free(array));
+
+        ///act
+        constbuffer_array_destroy(array);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* constbuffer_array_add_front */
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_012: [ If constbuffer_array_handle or constbuffer_handle is NULL, constbuffer_array_add_front shall fail and return NULL. ]*/
+    TEST_FUNCTION(constbuffer_array_add_front_with_NULL_array_fails)
+    {
+        ///act
+        CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_add_front(NULL, TEST_CONSTBUFFER_HANDLE_3);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_012: [ If constbuffer_array_handle or constbuffer_handle is NULL, constbuffer_array_add_front shall fail and return NULL. ]*/
+    TEST_FUNCTION(constbuffer_array_add_front_with_NULL_buffer_fails)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+        CONSTBUFFER_ARRAY_HANDLE result;
+
+        ///act
+        result = constbuffer_array_add_front(array, NULL);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        constbuffer_array_destroy(array);
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_013: [ constbuffer_array_add_front shall create a new array holding constbuffer_handle followed by the buffers of constbuffer_array_handle, and leave constbuffer_array_handle unchanged. ]*/
+    TEST_FUNCTION(constbuffer_array_add_front_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+        CONSTBUFFER_HANDLE expected[] = { TEST_CONSTBUFFER_HANDLE_3, TEST_CONSTBUFFER_HANDLE_1, TEST_CONSTBUFFER_HANDLE_2 };
+        CONSTBUFFER_ARRAY_HANDLE result;
+        const CONSTBUFFER* contents;
+        size_t buffer_count;
+        size_t all_buffers_size;
+
+        setup_build_expectations(expected, 3);
+
+        ///act
+        result = constbuffer_array_add_front(array, TEST_CONSTBUFFER_HANDLE_3);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_NOT_EQUAL(void_ptr, array, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_contents(result, &contents, &buffer_count));
+        ASSERT_ARE_EQUAL(size_t, 3, buffer_count);
+        ASSERT_ARE_EQUAL(void_ptr, buffer3, contents[0].buffer);
+        ASSERT_ARE_EQUAL(void_ptr, buffer1, contents[1].buffer);
+        ASSERT_ARE_EQUAL(void_ptr, buffer2, contents[2].buffer);
+        ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size(result, &all_buffers_size));
+        ASSERT_ARE_EQUAL(size_t, 6, all_buffers_size);
+        ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(array, &buffer_count));
+        ASSERT_ARE_EQUAL(size_t, 2, buffer_count);
+
+        ///cleanup
+        constbuffer_array_destroy(result);
+        constbuffer_array_destroy(array);
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_014: [ If any error occurs, constbuffer_array_add_front shall fail and return NULL. ]*/
+    TEST_FUNCTION(constbuffer_array_add_front_fails_when_malloc_fails)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+        CONSTBUFFER_ARRAY_HANDLE result;
+
+        whenShallmalloc_fail = currentmalloc_call + 1;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+        ///act
+        result = constbuffer_array_add_front(array, TEST_CONSTBUFFER_HANDLE_3);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        constbuffer_array_destroy(array);
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_014: [ If any error occurs, constbuffer_array_add_front shall fail and return NULL. ]*/
+    TEST_FUNCTION(constbuffer_array_add_front_fails_when_CONSTBUFFER_GetContent_fails_for_the_new_buffer)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+        CONSTBUFFER_ARRAY_HANDLE result;
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3))
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+        ///act
+        result = constbuffer_array_add_front(array, TEST_CONSTBUFFER_HANDLE_3);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        constbuffer_array_destroy(array);
+    }
+
+    /* constbuffer_array_add_back */
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_015: [ If constbuffer_array_handle or constbuffer_handle is NULL, constbuffer_array_add_back shall fail and return NULL. ]*/
+    TEST_FUNCTION(constbuffer_array_add_back_with_NULL_array_fails)
+    {
+        ///act
+        CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_add_back(NULL, TEST_CONSTBUFFER_HANDLE_3);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_015: [ If constbuffer_array_handle or constbuffer_handle is NULL, constbuffer_array_add_back shall fail and return NULL. ]*/
+    TEST_FUNCTION(constbuffer_array_add_back_with_NULL_buffer_fails)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+        CONSTBUFFER_ARRAY_HANDLE result;
+
+        ///act
+        result = constbuffer_array_add_back(array, NULL);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        constbuffer_array_destroy(array);
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_016: [ constbuffer_array_add_back shall create a new array holding the buffers of constbuffer_array_handle followed by constbuffer_handle, and leave constbuffer_array_handle unchanged. ]*/
+    TEST_FUNCTION(constbuffer_array_add_back_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+        CONSTBUFFER_HANDLE expected[] = { TEST_CONSTBUFFER_HANDLE_1, TEST_CONSTBUFFER_HANDLE_2, TEST_CONSTBUFFER_HANDLE_3 };
+        CONSTBUFFER_ARRAY_HANDLE result;
+        const CONSTBUFFER* contents;
+        size_t buffer_count;
+
+        setup_build_expectations(expected, 3);
+
+        ///act
+        result = constbuffer_array_add_back(array, TEST_CONSTBUFFER_HANDLE_3);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_contents(result, &contents, &buffer_count));
+        ASSERT_ARE_EQUAL(size_t, 3, buffer_count);
+        ASSERT_ARE_EQUAL(void_ptr, buffer1, contents[0].buffer);
+        ASSERT_ARE_EQUAL(void_ptr, buffer2, contents[1].buffer);
+        ASSERT_ARE_EQUAL(void_ptr, buffer3, contents[2].buffer);
+        ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(array, &buffer_count));
+        ASSERT_ARE_EQUAL(size_t, 2, buffer_count);
+
+        ///cleanup
+        constbuffer_array_destroy(result);
+        constbuffer_array_destroy(array);
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_017: [ If any error occurs, constbuffer_array_add_back shall fail and return NULL. ]*/
+    TEST_FUNCTION(constbuffer_array_add_back_fails_when_the_total_size_overflows)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+        CONSTBUFFER_ARRAY_HANDLE result;
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_Clone(TEST_CONSTBUFFER_HANDLE_1));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_Clone(TEST_CONSTBUFFER_HANDLE_2));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_HUGE));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_Destroy(TEST_CONSTBUFFER_HANDLE_1));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_Destroy(TEST_CONSTBUFFER_HANDLE_2));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+        ///act
+        result = constbuffer_array_add_back(array, TEST_CONSTBUFFER_HANDLE_HUGE);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        constbuffer_array_destroy(array);
+    }
+
+    /* constbuffer_array_get_buffer_count */
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_018: [ If constbuffer_array_handle or buffer_count is NULL, constbuffer_array_get_buffer_count shall fail and return a non-zero value. ]*/
+    TEST_FUNCTION(constbuffer_array_get_buffer_count_with_NULL_array_fails)
+    {
+        ///arrange
+        size_t buffer_count;
+
+        ///act
+        int result = constbuffer_array_get_buffer_count(NULL, &buffer_count);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_018: [ If constbuffer_array_handle or buffer_count is NULL, constbuffer_array_get_buffer_count shall fail and return a non-zero value. ]*/
+    TEST_FUNCTION(constbuffer_array_get_buffer_count_with_NULL_buffer_count_fails)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+
+        ///act
+        int result = constbuffer_array_get_buffer_count(array, NULL);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+        ///cleanup
+        constbuffer_array_destroy(array);
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_019: [ Otherwise constbuffer_array_get_buffer_count shall write the number of buffers in buffer_count and return 0. ]*/
+    TEST_FUNCTION(constbuffer_array_get_buffer_count_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+        size_t buffer_count;
+
+        ///act
+        int result = constbuffer_array_get_buffer_count(array, &buffer_count);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 2, buffer_count);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        constbuffer_array_destroy(array);
+    }
+
+    /* constbuffer_array_get_all_buffers_size */
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_020: [ If constbuffer_array_handle or all_buffers_size is NULL, constbuffer_array_get_all_buffers_size shall fail and return a non-zero value. ]*/
+    TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_NULL_array_fails)
+    {
+        ///arrange
+        size_t all_buffers_size;
+
+        ///act
+        int result = constbuffer_array_get_all_buffers_size(NULL, &all_buffers_size);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_020: [ If constbuffer_array_handle or all_buffers_size is NULL, constbuffer_array_get_all_buffers_size shall fail and return a non-zero value. ]*/
+    TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_NULL_all_buffers_size_fails)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+
+        ///act
+        int result = constbuffer_array_get_all_buffers_size(array, NULL);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+        ///cleanup
+        constbuffer_array_destroy(array);
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_021: [ Otherwise constbuffer_array_get_all_buffers_size shall write the sum of the sizes of all the buffers in all_buffers_size and return 0. ]*/
+    TEST_FUNCTION(constbuffer_array_get_all_buffers_size_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+        size_t all_buffers_size;
+
+        ///act
+        int result = constbuffer_array_get_all_buffers_size(array, &all_buffers_size);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, sizeof(buffer1) + sizeof(buffer2), all_buffers_size);
+        /* the size is not computed again */
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        constbuffer_array_destroy(array);
+    }
+
+    /* constbuffer_array_get_buffer */
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_022: [ If constbuffer_array_handle is NULL, constbuffer_array_get_buffer shall fail and return NULL. ]*/
+    TEST_FUNCTION(constbuffer_array_get_buffer_with_NULL_array_fails)
+    {
+        ///act
+        CONSTBUFFER_HANDLE result = constbuffer_array_get_buffer(NULL, 0);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_023: [ If buffer_index is not smaller than the number of buffers, constbuffer_array_get_buffer shall fail and return NULL. ]*/
+    TEST_FUNCTION(constbuffer_array_get_buffer_with_index_out_of_range_fails)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+        CONSTBUFFER_HANDLE result;
+
+        ///act
+        result = constbuffer_array_get_buffer(array, 2);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        constbuffer_array_destroy(array);
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_024: [ Otherwise constbuffer_array_get_buffer shall return a new reference to the buffer at buffer_index. ]*/
+    TEST_FUNCTION(constbuffer_array_get_buffer_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+        CONSTBUFFER_HANDLE result;
+
+        STRICT_EXPECTED_CALL(CONSTBUFFER_Clone(TEST_CONSTBUFFER_HANDLE_2));
+
+        ///act
+        result = constbuffer_array_get_buffer(array, 1);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        constbuffer_array_destroy(array);
+    }
+
+    /* constbuffer_array_get_contents */
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_025: [ If constbuffer_array_handle, contents or buffer_count is NULL, constbuffer_array_get_contents shall fail and return a non-zero value. ]*/
+    TEST_FUNCTION(constbuffer_array_get_contents_with_NULL_array_fails)
+    {
+        ///arrange
+        const CONSTBUFFER* contents;
+        size_t buffer_count;
+
+        ///act
+        int result = constbuffer_array_get_contents(NULL, &contents, &buffer_count);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_025: [ If constbuffer_array_handle, contents or buffer_count is NULL, constbuffer_array_get_contents shall fail and return a non-zero value. ]*/
+    TEST_FUNCTION(constbuffer_array_get_contents_with_NULL_contents_fails)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+        size_t buffer_count;
+
+        ///act
+        int result = constbuffer_array_get_contents(array, NULL, &buffer_count);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+        ///cleanup
+        constbuffer_array_destroy(array);
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_025: [ If constbuffer_array_handle, contents or buffer_count is NULL, constbuffer_array_get_contents shall fail and return a non-zero value. ]*/
+    TEST_FUNCTION(constbuffer_array_get_contents_with_NULL_buffer_count_fails)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+        const CONSTBUFFER* contents;
+
+        ///act
+        int result = constbuffer_array_get_contents(array, &contents, NULL);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+        ///cleanup
+        constbuffer_array_destroy(array);
+    }
+
+    /* Tests_SRS_CONSTBUFFER_ARRAY_03_026: [ Otherwise constbuffer_array_get_contents shall write in contents the contents of all the buffers, in order and stored contiguously, write the number of buffers in buffer_count and return 0. ]*/
+    TEST_FUNCTION(constbuffer_array_get_contents_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+        const CONSTBUFFER* contents;
+        size_t buffer_count;
+
+        ///act
+        int result = constbuffer_array_get_contents(array, &contents, &buffer_count);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 2, buffer_count);
+        ASSERT_ARE_EQUAL(void_ptr, buffer1, contents[0].buffer);
+        ASSERT_ARE_EQUAL(size_t, sizeof(buffer1), contents[0].size);
+        ASSERT_ARE_EQUAL(void_ptr, buffer2, contents[1].buffer);
+        ASSERT_ARE_EQUAL(size_t, sizeof(buffer2), contents[1].size);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        constbuffer_array_destroy(array);
+    }
+
+END_TEST_SUITE(constbuffer_array_unittests)
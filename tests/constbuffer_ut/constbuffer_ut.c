@@ -4,9 +4,11 @@
 #ifdef __cplusplus
 #include <cstdlib>
 #include <cstddef>
+#include <cstdint>
 #else
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdint.h>
 #endif
 
 
@@ -47,6 +49,9 @@ void my_gballoc_free(void* ptr)
 #include "azure_c_shared_utility/buffer_.h"
 #include "azure_c_shared_utility/gballoc.h"
 
+MOCK_FUNCTION_WITH_CODE(, void, test_free_func, void*, context)
+MOCK_FUNCTION_END()
+
 #undef ENABLE_MOCKS
 #include "azure_c_shared_utility/constbuffer.h"
 
@@ -169,6 +174,7 @@ BEGIN_TEST_SUITE(constbuffer_unittests)
 
     /*Tests_SRS_CONSTBUFFER_02_002: [Otherwise, CONSTBUFFER_Create shall create a copy of the memory area pointed to by source having size bytes.]*/
     /*Tests_SRS_CONSTBUFFER_02_004: [Otherwise CONSTBUFFER_Create shall return a non-NULL handle.]*/
+    /*Tests_SRS_CONSTBUFFER_03_001: [The copy of the bytes shall be stored in the same memory allocation as the handle.]*/
     TEST_FUNCTION(CONSTBUFFER_Create_succeeds)
     {
         ///arrange
@@ -176,11 +182,9 @@ BEGIN_TEST_SUITE(constbuffer_unittests)
 		const CONSTBUFFER* content;
 
         ///act
-        /*this is the handle*/
+        /*this is the handle and the content*/
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        /*this is the content*/
-        STRICT_EXPECTED_CALL(gballoc_malloc(BUFFER1_length));
 
         handle = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
 
@@ -209,11 +213,9 @@ BEGIN_TEST_SUITE(constbuffer_unittests)
         ///act
         STRICT_EXPECTED_CALL(BUFFER_length(BUFFER1_HANDLE));
         STRICT_EXPECTED_CALL(BUFFER_u_char(BUFFER1_HANDLE));
-        /*this is the handle*/
+        /*this is the handle and the content*/
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        /*this is the content*/
-        STRICT_EXPECTED_CALL(gballoc_malloc(BUFFER1_length));
 
         handle = CONSTBUFFER_CreateFromBuffer(BUFFER1_HANDLE);
 
@@ -230,38 +232,6 @@ BEGIN_TEST_SUITE(constbuffer_unittests)
         ///cleanup
         CONSTBUFFER_Destroy(handle);
     }
-
-    /*Tests_SRS_CONSTBUFFER_02_008: [If copying the content fails, then CONSTBUFFER_CreateFromBuffer shall fail and return NULL.]*/
-    TEST_FUNCTION(CONSTBUFFER_CreateFromBuffer_fails_when_malloc_fails_1)
-    {
-        ///arrange
-		CONSTBUFFER_HANDLE handle;
-
-        ///act
-        STRICT_EXPECTED_CALL(BUFFER_length(BUFFER1_HANDLE));
-        STRICT_EXPECTED_CALL(BUFFER_u_char(BUFFER1_HANDLE));
-
-        /*this is the handle*/
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
-            .IgnoreArgument(1);
-
-        /*this is the content*/
-        whenShallmalloc_fail = 2;
-        STRICT_EXPECTED_CALL(gballoc_malloc(BUFFER1_length));
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
-
-        handle = CONSTBUFFER_CreateFromBuffer(BUFFER1_HANDLE);
-
-        ///assert
-        ASSERT_IS_NULL(handle);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        CONSTBUFFER_Destroy(handle);
-    }
-
     /*Tests_SRS_CONSTBUFFER_02_008: [If copying the content fails, then CONSTBUFFER_CreateFromBuffer shall fail and return NULL.]*/
     TEST_FUNCTION(CONSTBUFFER_CreateFromBuffer_fails_when_malloc_fails_2)
     {
@@ -313,10 +283,7 @@ BEGIN_TEST_SUITE(constbuffer_unittests)
         umock_c_reset_all_calls();
         ///act
 
-        /*this is the content*/
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        /*this is the handle*/
+        /*this is the handle and the content*/
         STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
@@ -327,32 +294,6 @@ BEGIN_TEST_SUITE(constbuffer_unittests)
 
         ///cleanup
     }
-
-    /*Tests_SRS_CONSTBUFFER_02_003: [If creating the copy fails then CONSTBUFFER_Create shall return NULL.]*/
-    TEST_FUNCTION(CONSTBUFFER_Create_fails_when_malloc_fails_1)
-    {
-        ///arrange
-		CONSTBUFFER_HANDLE handle;
-
-        ///act
-        /*this is the handle*/
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
-            .IgnoreArgument(1);
-        /*this is the content*/
-        whenShallmalloc_fail = 2;
-        STRICT_EXPECTED_CALL(gballoc_malloc(BUFFER1_length));
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
-        handle = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
-
-        ///assert
-        ASSERT_IS_NULL(handle);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-    }
-
     /*Tests_SRS_CONSTBUFFER_02_003: [If creating the copy fails then CONSTBUFFER_Create shall return NULL.]*/
     TEST_FUNCTION(CONSTBUFFER_Create_fails_when_malloc_fails_2)
     {
@@ -383,10 +324,7 @@ BEGIN_TEST_SUITE(constbuffer_unittests)
         umock_c_reset_all_calls();
         ///act
 
-        /*this is the content*/
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        /*this is the handle*/
+        /*this is the handle and the content*/
         STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
@@ -580,10 +518,7 @@ BEGIN_TEST_SUITE(constbuffer_unittests)
         umock_c_reset_all_calls();
 
         ///act
-        /*this is the content*/
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        /*this is the handle*/
+        /*this is the handle and the content*/
         STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
         CONSTBUFFER_Destroy(clone);
@@ -608,4 +543,537 @@ BEGIN_TEST_SUITE(constbuffer_unittests)
         ///cleanup
     }
 
+    /*Tests_SRS_CONSTBUFFER_03_002: [If source is NULL and size is different than 0 then CONSTBUFFER_CreateWithMoveMemory shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateWithMoveMemory_with_invalid_args_fails)
+    {
+        ///arrange
+
+        ///act
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateWithMoveMemory(NULL, 1);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_003: [CONSTBUFFER_CreateWithMoveMemory shall take ownership of source without copying it, source shall be released with free when the refcount reaches zero.]*/
+    /*Tests_SRS_CONSTBUFFER_03_005: [The non-NULL handle returned by CONSTBUFFER_CreateWithMoveMemory shall have its ref count set to "1".]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateWithMoveMemory_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+        const CONSTBUFFER* content;
+        unsigned char* source = (unsigned char*)malloc(BUFFER1_length);
+        ASSERT_IS_NOT_NULL(source);
+        (void)memcpy(source, BUFFER1_u_char, BUFFER1_length);
+
+        /*this is the handle*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        handle = CONSTBUFFER_CreateWithMoveMemory(source, BUFFER1_length);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(handle);
+        content = CONSTBUFFER_GetContent(handle);
+        ASSERT_ARE_EQUAL(size_t, BUFFER1_length, content->size);
+        /*testing that it is a pointer assignment and not a copy*/
+        ASSERT_ARE_EQUAL(void_ptr, source, content->buffer);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_003: [CONSTBUFFER_CreateWithMoveMemory shall take ownership of source without copying it, source shall be released with free when the refcount reaches zero.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateWithMoveMemory_frees_source_when_the_refcount_reaches_zero)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+        CONSTBUFFER_HANDLE clone;
+        unsigned char* source = (unsigned char*)malloc(BUFFER1_length);
+        ASSERT_IS_NOT_NULL(source);
+        handle = CONSTBUFFER_CreateWithMoveMemory(source, BUFFER1_length);
+        clone = CONSTBUFFER_Clone(handle);
+        CONSTBUFFER_Destroy(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_free(source));
+        /*this is the handle*/
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        CONSTBUFFER_Destroy(clone);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_004: [If any error occurs, CONSTBUFFER_CreateWithMoveMemory shall fail, return NULL and leave the ownership of source to the caller.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateWithMoveMemory_fails_when_malloc_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+        unsigned char* source = (unsigned char*)malloc(BUFFER1_length);
+        ASSERT_IS_NOT_NULL(source);
+
+        whenShallmalloc_fail = 1;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        handle = CONSTBUFFER_CreateWithMoveMemory(source, BUFFER1_length);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        free(source);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_006: [If source is NULL and size is different than 0 then CONSTBUFFER_CreateWithCustomFree shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateWithCustomFree_with_NULL_source_and_non_zero_size_fails)
+    {
+        ///arrange
+
+        ///act
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateWithCustomFree(NULL, 1, test_free_func, (void*)0x4242);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_007: [If customFreeFunc is NULL then CONSTBUFFER_CreateWithCustomFree shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateWithCustomFree_with_NULL_customFreeFunc_fails)
+    {
+        ///arrange
+
+        ///act
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateWithCustomFree(BUFFER1_u_char, BUFFER1_length, NULL, (void*)0x4242);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_008: [CONSTBUFFER_CreateWithCustomFree shall refer to source without copying it, and shall call customFreeFunc with customFreeFuncContext when the refcount reaches zero.]*/
+    /*Tests_SRS_CONSTBUFFER_03_010: [The non-NULL handle returned by CONSTBUFFER_CreateWithCustomFree shall have its ref count set to "1".]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateWithCustomFree_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+        const CONSTBUFFER* content;
+
+        /*this is the handle*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        handle = CONSTBUFFER_CreateWithCustomFree(BUFFER1_u_char, BUFFER1_length, test_free_func, (void*)0x4242);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(handle);
+        content = CONSTBUFFER_GetContent(handle);
+        ASSERT_ARE_EQUAL(size_t, BUFFER1_length, content->size);
+        /*testing that it is a pointer assignment and not a copy*/
+        ASSERT_ARE_EQUAL(void_ptr, BUFFER1_u_char, content->buffer);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_008: [CONSTBUFFER_CreateWithCustomFree shall refer to source without copying it, and shall call customFreeFunc with customFreeFuncContext when the refcount reaches zero.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateWithCustomFree_calls_customFreeFunc_when_the_refcount_reaches_zero)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateWithCustomFree(BUFFER1_u_char, BUFFER1_length, test_free_func, (void*)0x4242);
+        CONSTBUFFER_HANDLE clone = CONSTBUFFER_Clone(handle);
+        CONSTBUFFER_Destroy(handle); /*only a dec_Ref is expected here, so no effects*/
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(test_free_func((void*)0x4242));
+        /*this is the handle*/
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        CONSTBUFFER_Destroy(clone);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_009: [If any error occurs, CONSTBUFFER_CreateWithCustomFree shall fail and return NULL, customFreeFunc shall not be called.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateWithCustomFree_fails_when_malloc_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+
+        whenShallmalloc_fail = 1;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        handle = CONSTBUFFER_CreateWithCustomFree(BUFFER1_u_char, BUFFER1_length, test_free_func, (void*)0x4242);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_011: [If buffer is NULL then CONSTBUFFER_CreateFromBufferMove shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromBufferMove_with_NULL_fails)
+    {
+        ///arrange
+
+        ///act
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateFromBufferMove(NULL);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_012: [CONSTBUFFER_CreateFromBufferMove shall take ownership of buffer and refer to its content without copying it, buffer shall be deleted with BUFFER_delete when the refcount reaches zero.]*/
+    /*Tests_SRS_CONSTBUFFER_03_014: [The non-NULL handle returned by CONSTBUFFER_CreateFromBufferMove shall have its ref count set to "1".]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromBufferMove_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+        const CONSTBUFFER* content;
+
+        STRICT_EXPECTED_CALL(BUFFER_length(BUFFER1_HANDLE));
+        STRICT_EXPECTED_CALL(BUFFER_u_char(BUFFER1_HANDLE));
+        /*this is the handle*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        handle = CONSTBUFFER_CreateFromBufferMove(BUFFER1_HANDLE);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(handle);
+        content = CONSTBUFFER_GetContent(handle);
+        ASSERT_ARE_EQUAL(size_t, BUFFER1_length, content->size);
+        /*testing that it is a pointer assignment and not a copy*/
+        ASSERT_ARE_EQUAL(void_ptr, BUFFER1_u_char, content->buffer);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_012: [CONSTBUFFER_CreateFromBufferMove shall take ownership of buffer and refer to its content without copying it, buffer shall be deleted with BUFFER_delete when the refcount reaches zero.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromBufferMove_deletes_the_buffer_when_the_refcount_reaches_zero)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateFromBufferMove(BUFFER1_HANDLE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(BUFFER_delete(BUFFER1_HANDLE));
+        /*this is the handle*/
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        CONSTBUFFER_Destroy(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_013: [If any error occurs, CONSTBUFFER_CreateFromBufferMove shall fail, return NULL and leave the ownership of buffer to the caller.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromBufferMove_fails_when_malloc_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle;
+
+        STRICT_EXPECTED_CALL(BUFFER_length(BUFFER1_HANDLE));
+        STRICT_EXPECTED_CALL(BUFFER_u_char(BUFFER1_HANDLE));
+        whenShallmalloc_fail = 1;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        handle = CONSTBUFFER_CreateFromBufferMove(BUFFER1_HANDLE);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_015: [If handle is NULL then CONSTBUFFER_CreateFromOffsetAndSize shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_with_NULL_handle_fails)
+    {
+        ///arrange
+
+        ///act
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateFromOffsetAndSize(NULL, 0, 1);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_016: [If offset is greater than the size of handle or offset + size is greater than the size of handle then CONSTBUFFER_CreateFromOffsetAndSize shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_with_offset_out_of_range_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE original = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        CONSTBUFFER_HANDLE handle;
+        umock_c_reset_all_calls();
+
+        ///act
+        handle = CONSTBUFFER_CreateFromOffsetAndSize(original, BUFFER1_length + 1, 0);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(original);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_016: [If offset is greater than the size of handle or offset + size is greater than the size of handle then CONSTBUFFER_CreateFromOffsetAndSize shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_with_size_out_of_range_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE original = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        CONSTBUFFER_HANDLE handle;
+        umock_c_reset_all_calls();
+
+        ///act
+        handle = CONSTBUFFER_CreateFromOffsetAndSize(original, 1, BUFFER1_length);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(original);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_016: [If offset is greater than the size of handle or offset + size is greater than the size of handle then CONSTBUFFER_CreateFromOffsetAndSize shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_with_offset_plus_size_overflowing_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE original = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        CONSTBUFFER_HANDLE handle;
+        umock_c_reset_all_calls();
+
+        ///act
+        handle = CONSTBUFFER_CreateFromOffsetAndSize(original, 1, SIZE_MAX);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(original);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_017: [If the window covers the whole of handle then CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle and return handle.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_with_the_whole_buffer_returns_the_same_handle)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE original = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        CONSTBUFFER_HANDLE handle;
+        umock_c_reset_all_calls();
+
+        ///act
+        handle = CONSTBUFFER_CreateFromOffsetAndSize(original, 0, BUFFER1_length);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, original, handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(handle);
+        CONSTBUFFER_Destroy(original);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_018: [CONSTBUFFER_CreateFromOffsetAndSize shall create a handle that refers to size bytes of handle starting at offset without copying them and that holds a reference to the handle owning the bytes.]*/
+    /*Tests_SRS_CONSTBUFFER_03_020: [The non-NULL handle returned by CONSTBUFFER_CreateFromOffsetAndSize shall have its ref count set to "1".]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE original = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        const CONSTBUFFER* original_content = CONSTBUFFER_GetContent(original);
+        CONSTBUFFER_HANDLE handle;
+        const CONSTBUFFER* content;
+        umock_c_reset_all_calls();
+
+        /*this is the handle*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        handle = CONSTBUFFER_CreateFromOffsetAndSize(original, 3, 6);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(handle);
+        content = CONSTBUFFER_GetContent(handle);
+        ASSERT_ARE_EQUAL(size_t, 6, content->size);
+        /*testing that it is a pointer into the original and not a copy*/
+        ASSERT_ARE_EQUAL(void_ptr, original_content->buffer + 3, content->buffer);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(handle);
+        CONSTBUFFER_Destroy(original);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_018: [CONSTBUFFER_CreateFromOffsetAndSize shall create a handle that refers to size bytes of handle starting at offset without copying them and that holds a reference to the handle owning the bytes.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_keeps_the_original_alive)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE original = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateFromOffsetAndSize(original, 3, 6);
+        const CONSTBUFFER* content;
+        umock_c_reset_all_calls();
+
+        ///act
+        CONSTBUFFER_Destroy(original);
+
+        ///assert
+        content = CONSTBUFFER_GetContent(handle);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER1_u_char + 3, content->buffer, 6));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_018: [CONSTBUFFER_CreateFromOffsetAndSize shall create a handle that refers to size bytes of handle starting at offset without copying them and that holds a reference to the handle owning the bytes.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_releases_the_original_when_the_refcount_reaches_zero)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE original = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateFromOffsetAndSize(original, 3, 6);
+        CONSTBUFFER_Destroy(original);
+        umock_c_reset_all_calls();
+
+        /*this is the original*/
+        STRICT_EXPECTED_CALL(gballoc_free(original));
+        /*this is the handle*/
+        STRICT_EXPECTED_CALL(gballoc_free(handle));
+
+        ///act
+        CONSTBUFFER_Destroy(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_018: [CONSTBUFFER_CreateFromOffsetAndSize shall create a handle that refers to size bytes of handle starting at offset without copying them and that holds a reference to the handle owning the bytes.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_of_a_window_refers_to_the_original)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE original = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        CONSTBUFFER_HANDLE window = CONSTBUFFER_CreateFromOffsetAndSize(original, 3, 6);
+        CONSTBUFFER_HANDLE handle;
+        const CONSTBUFFER* content;
+        CONSTBUFFER_Destroy(original);
+
+        ///act
+        handle = CONSTBUFFER_CreateFromOffsetAndSize(window, 1, 2);
+        CONSTBUFFER_Destroy(window);
+
+        ///assert
+        content = CONSTBUFFER_GetContent(handle);
+        ASSERT_ARE_EQUAL(size_t, 2, content->size);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER1_u_char + 4, content->buffer, 2));
+
+        /*the first window is gone, only the original and the handle are left*/
+        umock_c_reset_all_calls();
+        STRICT_EXPECTED_CALL(gballoc_free(original));
+        STRICT_EXPECTED_CALL(gballoc_free(handle));
+        CONSTBUFFER_Destroy(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_018: [CONSTBUFFER_CreateFromOffsetAndSize shall create a handle that refers to size bytes of handle starting at offset without copying them and that holds a reference to the handle owning the bytes.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_with_size_0_succeeds)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE original = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        CONSTBUFFER_HANDLE handle;
+        const CONSTBUFFER* content;
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        handle = CONSTBUFFER_CreateFromOffsetAndSize(original, BUFFER1_length, 0);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(handle);
+        content = CONSTBUFFER_GetContent(handle);
+        ASSERT_ARE_EQUAL(size_t, 0, content->size);
+        ASSERT_IS_NULL(content->buffer);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_Destroy(handle);
+        CONSTBUFFER_Destroy(original);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_03_019: [If any error occurs, CONSTBUFFER_CreateFromOffsetAndSize shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_fails_when_malloc_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE original = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        CONSTBUFFER_HANDLE handle;
+        umock_c_reset_all_calls();
+
+        whenShallmalloc_fail = currentmalloc_call + 1;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        handle = CONSTBUFFER_CreateFromOffsetAndSize(original, 3, 6);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        /*the original was not given an extra reference*/
+        umock_c_reset_all_calls();
+        STRICT_EXPECTED_CALL(gballoc_free(original));
+        CONSTBUFFER_Destroy(original);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+    }
+
 END_TEST_SUITE(constbuffer_unittests)
@@ -0,0 +1,299 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+static size_t currentmalloc_call = 0;
+static size_t whenShallmalloc_fail = 0;
+
+void* my_gballoc_malloc(size_t size)
+{
+    void* result;
+    currentmalloc_call++;
+    if (whenShallmalloc_fail > 0)
+    {
+        if (currentmalloc_call == whenShallmalloc_fail)
+        {
+            result = NULL;
+        }
+        else
+        {
+            result = malloc(size);
+        }
+    }
+    else
+    {
+        result = malloc(size);
+    }
+    return result;
+}
+
+void my_gballoc_free(void* ptr)
+{
+    free(ptr);
+}
+
+#define ENABLE_MOCKS
+#include "umock_c.h"
+#include "azure_c_shared_utility/gballoc.h"
+#undef ENABLE_MOCKS
+
+#include "azure_c_shared_utility/conststring.h"
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+static const char* TEST_STRING = "-----BEGIN CERTIFICATE-----";
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(conststring_unittests)
+
+    TEST_SUITE_INITIALIZE(suite_init)
+    {
+        TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+        g_testByTest = TEST_MUTEX_CREATE();
+        ASSERT_IS_NOT_NULL(g_testByTest);
+
+        umock_c_init(on_umock_c_error);
+
+        REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+        REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+    }
+
+    TEST_SUITE_CLEANUP(suite_cleanup)
+    {
+        umock_c_deinit();
+
+        TEST_MUTEX_DESTROY(g_testByTest);
+        TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    }
+
+    TEST_FUNCTION_INITIALIZE(method_init)
+    {
+        if (TEST_MUTEX_ACQUIRE(g_testByTest))
+        {
+            ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+        }
+
+        umock_c_reset_all_calls();
+
+        currentmalloc_call = 0;
+        whenShallmalloc_fail = 0;
+    }
+
+    TEST_FUNCTION_CLEANUP(method_cleanup)
+    {
+        TEST_MUTEX_RELEASE(g_testByTest);
+    }
+
+    /*Tests_SRS_CONSTSTRING_03_001: [If source is NULL then CONSTSTRING_Create shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTSTRING_Create_with_NULL_source_fails)
+    {
+        ///act
+        CONSTSTRING_HANDLE handle = CONSTSTRING_Create(NULL);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTSTRING_03_002: [CONSTSTRING_Create shall copy source, including its null terminator, in the same memory allocation as the handle.]*/
+    /*Tests_SRS_CONSTSTRING_03_003: [The non-NULL handle returned by CONSTSTRING_Create shall have its ref count set to "1".]*/
+    TEST_FUNCTION(CONSTSTRING_Create_succeeds)
+    {
+        ///arrange
+        CONSTSTRING_HANDLE handle;
+
+        /*this is the handle and the characters*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+        ///act
+        handle = CONSTSTRING_Create(TEST_STRING);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_STRING, CONSTSTRING_c_str(handle));
+        /*testing that it is a copy and not a pointer assignment*/
+        ASSERT_ARE_NOT_EQUAL(void_ptr, TEST_STRING, CONSTSTRING_c_str(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTSTRING_Destroy(handle);
+    }
+
+    /*Tests_SRS_CONSTSTRING_03_002: [CONSTSTRING_Create shall copy source, including its null terminator, in the same memory allocation as the handle.]*/
+    TEST_FUNCTION(CONSTSTRING_Create_with_an_empty_string_succeeds)
+    {
+        ///arrange
+        CONSTSTRING_HANDLE handle;
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+        ///act
+        handle = CONSTSTRING_Create("");
+
+        ///assert
+        ASSERT_IS_NOT_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, "", CONSTSTRING_c_str(handle));
+        ASSERT_ARE_EQUAL(size_t, 0, CONSTSTRING_length(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTSTRING_Destroy(handle);
+    }
+
+    /*Tests_SRS_CONSTSTRING_03_004: [If any error occurs, CONSTSTRING_Create shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTSTRING_Create_fails_when_malloc_fails)
+    {
+        ///arrange
+        CONSTSTRING_HANDLE handle;
+
+        whenShallmalloc_fail = 1;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+        ///act
+        handle = CONSTSTRING_Create(TEST_STRING);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTSTRING_03_005: [If handle is NULL then CONSTSTRING_Clone shall fail and return NULL.]*/
+    TEST_FUNCTION(CONSTSTRING_Clone_with_NULL_handle_fails)
+    {
+        ///act
+        CONSTSTRING_HANDLE clone = CONSTSTRING_Clone(NULL);
+
+        ///assert
+        ASSERT_IS_NULL(clone);
+    }
+
+    /*Tests_SRS_CONSTSTRING_03_006: [Otherwise, CONSTSTRING_Clone shall increment the reference count and return handle.]*/
+    TEST_FUNCTION(CONSTSTRING_Clone_increments_the_ref_count)
+    {
+        ///arrange
+        CONSTSTRING_HANDLE handle = CONSTSTRING_Create(TEST_STRING);
+        CONSTSTRING_HANDLE clone;
+        umock_c_reset_all_calls();
+
+        ///act
+        clone = CONSTSTRING_Clone(handle);
+        CONSTSTRING_Destroy(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, handle, clone);
+        /*nothing was copied and nothing was freed*/
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_STRING, CONSTSTRING_c_str(clone));
+
+        ///cleanup
+        CONSTSTRING_Destroy(clone);
+    }
+
+    /*Tests_SRS_CONSTSTRING_03_007: [If handle is NULL then CONSTSTRING_c_str shall return NULL.]*/
+    TEST_FUNCTION(CONSTSTRING_c_str_with_NULL_handle_returns_NULL)
+    {
+        ///act
+        const char* result = CONSTSTRING_c_str(NULL);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+    }
+
+    /*Tests_SRS_CONSTSTRING_03_008: [Otherwise, CONSTSTRING_c_str shall return the null terminated characters of handle.]*/
+    TEST_FUNCTION(CONSTSTRING_c_str_succeeds)
+    {
+        ///arrange
+        CONSTSTRING_HANDLE handle = CONSTSTRING_Create(TEST_STRING);
+        const char* result;
+        umock_c_reset_all_calls();
+
+        ///act
+        result = CONSTSTRING_c_str(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, TEST_STRING, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTSTRING_Destroy(handle);
+    }
+
+    /*Tests_SRS_CONSTSTRING_03_009: [If handle is NULL then CONSTSTRING_length shall return 0.]*/
+    TEST_FUNCTION(CONSTSTRING_length_with_NULL_handle_returns_0)
+    {
+        ///act
+        size_t result = CONSTSTRING_length(NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 0, result);
+    }
+
+    /*Tests_SRS_CONSTSTRING_03_010: [Otherwise, CONSTSTRING_length shall return the number of characters of handle, without the null terminator.]*/
+    TEST_FUNCTION(CONSTSTRING_length_succeeds)
+    {
+        ///arrange
+        CONSTSTRING_HANDLE handle = CONSTSTRING_Create(TEST_STRING);
+        size_t result;
+        umock_c_reset_all_calls();
+
+        ///act
+        result = CONSTSTRING_length(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, strlen(TEST_STRING), result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTSTRING_Destroy(handle);
+    }
+
+    /*Tests_SRS_CONSTSTRING_03_011: [If handle is NULL then CONSTSTRING_Destroy shall do nothing.]*/
+    TEST_FUNCTION(CONSTSTRING_Destroy_with_NULL_handle_does_nothing)
+    {
+        ///act
+        CONSTSTRING_Destroy(NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTSTRING_03_012: [Otherwise, CONSTSTRING_Destroy shall decrement the reference count of handle.]*/
+    /*Tests_SRS_CONSTSTRING_03_013: [If the reference count reaches zero, CONSTSTRING_Destroy shall free the memory used by handle.]*/
+    TEST_FUNCTION(CONSTSTRING_Destroy_frees_when_the_last_reference_goes_away)
+    {
+        ///arrange
+        CONSTSTRING_HANDLE handle = CONSTSTRING_Create(TEST_STRING);
+        CONSTSTRING_HANDLE clone = CONSTSTRING_Clone(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_free(handle));
+
+        ///act
+        CONSTSTRING_Destroy(clone);
+        CONSTSTRING_Destroy(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+END_TEST_SUITE(conststring_unittests)
@@ -0,0 +1,605 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#endif
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+
+#include "testrunnerswitcher.h"
+#include "azure_c_shared_utility/dns_resolver.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/threadapi.h"
+
+/* the resolver runs on real threads, getaddrinfo is replaced by a stub resolver that knows every host name but TEST_UNKNOWN_HOSTNAME,
+   counts its calls and can be held to keep lookups pending */
+#define TEST_HOSTNAME           "test.host"
+#define TEST_OTHER_HOSTNAME     "other.test.host"
+#define TEST_UNKNOWN_HOSTNAME   "unknown.test.host"
+#define TEST_ADDRESS            "10.0.0.1"
+#define TEST_WAIT_MS            5000
+
+TEST_DEFINE_ENUM_TYPE(DNS_RESOLVER_RESULT, DNS_RESOLVER_RESULT_VALUES);
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+static LOCK_HANDLE stub_lock;
+static size_t getaddrinfo_call_count;
+static bool is_getaddrinfo_held;
+
+typedef struct TEST_ADDRINFO_TAG
+{
+    struct addrinfo addrinfo;
+    struct sockaddr_in address;
+} TEST_ADDRINFO;
+
+static bool get_is_getaddrinfo_held(void)
+{
+    bool result;
+    (void)Lock(stub_lock);
+    result = is_getaddrinfo_held;
+    (void)Unlock(stub_lock);
+    return result;
+}
+
+static void set_is_getaddrinfo_held(bool is_held)
+{
+    (void)Lock(stub_lock);
+    is_getaddrinfo_held = is_held;
+    (void)Unlock(stub_lock);
+}
+
+static size_t get_getaddrinfo_call_count(void)
+{
+    size_t result;
+    (void)Lock(stub_lock);
+    result = getaddrinfo_call_count;
+    (void)Unlock(stub_lock);
+    return result;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int getaddrinfo(const char* node, const char* service, const struct addrinfo* hints, struct addrinfo** res)
+{
+    int result;
+    (void)service;
+    (void)hints;
+
+    (void)Lock(stub_lock);
+    getaddrinfo_call_count++;
+    (void)Unlock(stub_lock);
+
+    while (get_is_getaddrinfo_held())
+    {
+        ThreadAPI_Sleep(1);
+    }
+
+    if (strcmp(node, TEST_UNKNOWN_HOSTNAME) == 0)
+    {
+        result = EAI_NONAME;
+    }
+    else
+    {
+        TEST_ADDRINFO* test_addrinfo = (TEST_ADDRINFO*)calloc(1, sizeof(TEST_ADDRINFO));
+        if (test_addrinfo == NULL)
+        {
+            result = EAI_MEMORY;
+        }
+        else
+        {
+            test_addrinfo->address.sin_family = AF_INET;
+            test_addrinfo->address.sin_addr.s_addr = inet_addr(TEST_ADDRESS);
+            test_addrinfo->addrinfo.ai_family = AF_INET;
+            test_addrinfo->addrinfo.ai_socktype = SOCK_STREAM;
+            test_addrinfo->addrinfo.ai_addrlen = sizeof(test_addrinfo->address);
+            test_addrinfo->addrinfo.ai_addr = (struct sockaddr*)&test_addrinfo->address;
+            *res = &test_addrinfo->addrinfo;
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+void freeaddrinfo(struct addrinfo* res)
+{
+    free(res);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+static DNS_RESOLVER_RESULT wait_for_result(DNS_RESOLVER_LOOKUP_HANDLE lookup, const struct addrinfo** addresses, int* error)
+{
+    DNS_RESOLVER_RESULT result;
+    size_t waited_ms = 0;
+
+    while (((result = dns_resolver_get_result(lookup, addresses, error)) == DNS_RESOLVER_PENDING) && (waited_ms < TEST_WAIT_MS))
+    {
+        ThreadAPI_Sleep(1);
+        waited_ms++;
+    }
+
+    return result;
+}
+
+static void resolve_and_release(const char* hostname)
+{
+    DNS_RESOLVER_LOOKUP_HANDLE lookup = dns_resolver_lookup(hostname);
+    ASSERT_IS_NOT_NULL(lookup);
+    (void)wait_for_result(lookup, NULL, NULL);
+    dns_resolver_release(lookup);
+}
+
+BEGIN_TEST_SUITE(dns_resolver_unittests)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    stub_lock = Lock_Init();
+    ASSERT_IS_NOT_NULL(stub_lock);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    (void)Lock_Deinit(stub_lock);
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    getaddrinfo_call_count = 0;
+    is_getaddrinfo_held = false;
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* dns_resolver_init */
+
+/* Tests_SRS_DNS_RESOLVER_03_001: [ dns_resolver_init shall create the lock, the condition, the tick counter, the cache and the queue of the resolver and return 0. ]*/
+TEST_FUNCTION(dns_resolver_init_succeeds)
+{
+    // arrange
+    int result;
+
+    // act
+    result = dns_resolver_init();
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    dns_resolver_deinit();
+}
+
+/* Tests_SRS_DNS_RESOLVER_03_002: [ If the resolver is already initialized, dns_resolver_init shall count the call and return 0. ]*/
+/* Tests_SRS_DNS_RESOLVER_03_005: [ dns_resolver_deinit shall release the resolver on the call that matches the first dns_resolver_init. ]*/
+TEST_FUNCTION(dns_resolver_deinit_releases_the_resolver_on_the_last_call)
+{
+    // arrange
+    DNS_RESOLVER_LOOKUP_HANDLE lookup;
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+
+    // act
+    dns_resolver_deinit();
+    lookup = dns_resolver_lookup(TEST_HOSTNAME);
+
+    // assert
+    ASSERT_IS_NOT_NULL(lookup);
+    dns_resolver_release(lookup);
+    dns_resolver_deinit();
+    ASSERT_IS_NULL(dns_resolver_lookup(TEST_HOSTNAME));
+}
+
+/* dns_resolver_deinit */
+
+/* Tests_SRS_DNS_RESOLVER_03_004: [ If the resolver is not initialized, dns_resolver_deinit shall return. ]*/
+TEST_FUNCTION(dns_resolver_deinit_without_init_returns)
+{
+    // arrange
+
+    // act
+    dns_resolver_deinit();
+
+    // assert
+    ASSERT_IS_NULL(dns_resolver_lookup(TEST_HOSTNAME));
+}
+
+/* Tests_SRS_DNS_RESOLVER_03_006: [ dns_resolver_deinit shall stop the worker threads, wait for the lookups they are running, and free the entries of the cache. ]*/
+TEST_FUNCTION(dns_resolver_deinit_frees_the_cache)
+{
+    // arrange
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+    resolve_and_release(TEST_HOSTNAME);
+
+    // act
+    dns_resolver_deinit();
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+    resolve_and_release(TEST_HOSTNAME);
+    ASSERT_ARE_EQUAL(size_t, 2, get_getaddrinfo_call_count());
+
+    // cleanup
+    dns_resolver_deinit();
+}
+
+/* Tests_SRS_DNS_RESOLVER_03_022: [ If lookups are not released, dns_resolver_deinit shall leave the resolver running until the last of them is released, no new lookup is accepted meanwhile. ]*/
+/* Tests_SRS_DNS_RESOLVER_03_023: [ When the last dns_resolver_deinit waits for lookups to be released, dns_resolver_release of the last of them shall release the resolver. ]*/
+TEST_FUNCTION(dns_resolver_deinit_with_a_pending_lookup_resolves_it_and_releases_the_resolver_with_it)
+{
+    // arrange
+    DNS_RESOLVER_LOOKUP_HANDLE lookup;
+    const struct addrinfo* addresses = NULL;
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+    set_is_getaddrinfo_held(true);
+    lookup = dns_resolver_lookup(TEST_HOSTNAME);
+    ASSERT_IS_NOT_NULL(lookup);
+
+    // act
+    dns_resolver_deinit();
+
+    // assert
+    ASSERT_IS_NULL(dns_resolver_lookup(TEST_OTHER_HOSTNAME));
+    ASSERT_ARE_EQUAL(DNS_RESOLVER_RESULT, DNS_RESOLVER_PENDING, dns_resolver_get_result(lookup, NULL, NULL));
+    set_is_getaddrinfo_held(false);
+    ASSERT_ARE_EQUAL(DNS_RESOLVER_RESULT, DNS_RESOLVER_OK, wait_for_result(lookup, &addresses, NULL));
+    ASSERT_IS_NOT_NULL(addresses);
+    dns_resolver_release(lookup);
+    ASSERT_IS_NULL(dns_resolver_lookup(TEST_HOSTNAME));
+
+    /* the resolver was released, the next init starts with an empty cache */
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+    resolve_and_release(TEST_HOSTNAME);
+    ASSERT_ARE_EQUAL(size_t, 2, get_getaddrinfo_call_count());
+
+    // cleanup
+    dns_resolver_deinit();
+}
+
+/* Tests_SRS_DNS_RESOLVER_03_024: [ If the last dns_resolver_deinit waits for lookups to be released, dns_resolver_init shall keep the resolver, count the call and return 0. ]*/
+TEST_FUNCTION(dns_resolver_init_after_a_deferred_deinit_keeps_the_resolver)
+{
+    // arrange
+    DNS_RESOLVER_LOOKUP_HANDLE lookup;
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+    lookup = dns_resolver_lookup(TEST_HOSTNAME);
+    ASSERT_IS_NOT_NULL(lookup);
+    ASSERT_ARE_EQUAL(DNS_RESOLVER_RESULT, DNS_RESOLVER_OK, wait_for_result(lookup, NULL, NULL));
+    dns_resolver_deinit();
+
+    // act
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+
+    // assert
+    dns_resolver_release(lookup);
+    resolve_and_release(TEST_HOSTNAME);
+    ASSERT_ARE_EQUAL(size_t, 1, get_getaddrinfo_call_count());
+
+    // cleanup
+    dns_resolver_deinit();
+    ASSERT_IS_NULL(dns_resolver_lookup(TEST_HOSTNAME));
+}
+
+/* dns_resolver_set_ttl */
+
+/* Tests_SRS_DNS_RESOLVER_03_007: [ If the resolver is not initialized, dns_resolver_set_ttl shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(dns_resolver_set_ttl_without_init_fails)
+{
+    // arrange
+    int result;
+
+    // act
+    result = dns_resolver_set_ttl(0, 0);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_DNS_RESOLVER_03_008: [ dns_resolver_set_ttl shall keep the resolved entries of the cache for ttl_ms milliseconds and the failed ones for negative_ttl_ms milliseconds, and return 0. ]*/
+/* Tests_SRS_DNS_RESOLVER_03_011: [ dns_resolver_lookup shall remove the entries of the cache whose TTL has elapsed, the lookups that hold them keep their result. ]*/
+TEST_FUNCTION(dns_resolver_lookup_after_the_ttl_resolves_again)
+{
+    // arrange
+    int result;
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+
+    // act
+    result = dns_resolver_set_ttl(0, 0);
+    resolve_and_release(TEST_HOSTNAME);
+    resolve_and_release(TEST_HOSTNAME);
+    resolve_and_release(TEST_UNKNOWN_HOSTNAME);
+    resolve_and_release(TEST_UNKNOWN_HOSTNAME);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 4, get_getaddrinfo_call_count());
+
+    // cleanup
+    dns_resolver_deinit();
+}
+
+/* Tests_SRS_DNS_RESOLVER_03_011: [ dns_resolver_lookup shall remove the entries of the cache whose TTL has elapsed, the lookups that hold them keep their result. ]*/
+TEST_FUNCTION(dns_resolver_lookup_held_past_the_ttl_keeps_its_result)
+{
+    // arrange
+    const struct addrinfo* addresses = NULL;
+    DNS_RESOLVER_LOOKUP_HANDLE lookup;
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_set_ttl(0, 0));
+    lookup = dns_resolver_lookup(TEST_HOSTNAME);
+    ASSERT_IS_NOT_NULL(lookup);
+    (void)wait_for_result(lookup, NULL, NULL);
+
+    // act
+    resolve_and_release(TEST_HOSTNAME);
+
+    // assert
+    ASSERT_ARE_EQUAL(DNS_RESOLVER_RESULT, DNS_RESOLVER_OK, dns_resolver_get_result(lookup, &addresses, NULL));
+    ASSERT_IS_NOT_NULL(addresses);
+    ASSERT_ARE_EQUAL(int, AF_INET, addresses->ai_family);
+
+    // cleanup
+    dns_resolver_release(lookup);
+    dns_resolver_deinit();
+}
+
+/* dns_resolver_lookup */
+
+/* Tests_SRS_DNS_RESOLVER_03_009: [ If hostname is NULL, dns_resolver_lookup shall fail and return NULL. ]*/
+TEST_FUNCTION(dns_resolver_lookup_with_NULL_hostname_fails)
+{
+    // arrange
+    DNS_RESOLVER_LOOKUP_HANDLE result;
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+
+    // act
+    result = dns_resolver_lookup(NULL);
+
+    // assert
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    dns_resolver_deinit();
+}
+
+/* Tests_SRS_DNS_RESOLVER_03_010: [ If the resolver is not initialized, dns_resolver_lookup shall fail and return NULL. ]*/
+TEST_FUNCTION(dns_resolver_lookup_without_init_fails)
+{
+    // arrange
+    DNS_RESOLVER_LOOKUP_HANDLE result;
+
+    // act
+    result = dns_resolver_lookup(TEST_HOSTNAME);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 0, get_getaddrinfo_call_count());
+}
+
+/* Tests_SRS_DNS_RESOLVER_03_013: [ Otherwise dns_resolver_lookup shall add a pending entry for hostname to the cache, queue it for a worker thread, starting one if none is idle and fewer than DNS_RESOLVER_THREAD_COUNT run, and return a reference to it. ]*/
+/* Tests_SRS_DNS_RESOLVER_03_015: [ A worker thread shall resolve the queued entries with getaddrinfo, asking for the stream addresses of any family, without holding the lock of the resolver. ]*/
+/* Tests_SRS_DNS_RESOLVER_03_018: [ Once the host name is resolved, dns_resolver_get_result shall set addresses to the addresses getaddrinfo returned and return DNS_RESOLVER_OK. ]*/
+TEST_FUNCTION(dns_resolver_lookup_resolves_the_hostname)
+{
+    // arrange
+    const struct addrinfo* addresses = NULL;
+    DNS_RESOLVER_LOOKUP_HANDLE lookup;
+    DNS_RESOLVER_RESULT result;
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+
+    // act
+    lookup = dns_resolver_lookup(TEST_HOSTNAME);
+    result = wait_for_result(lookup, &addresses, NULL);
+
+    // assert
+    ASSERT_IS_NOT_NULL(lookup);
+    ASSERT_ARE_EQUAL(DNS_RESOLVER_RESULT, DNS_RESOLVER_OK, result);
+    ASSERT_IS_NOT_NULL(addresses);
+    ASSERT_ARE_EQUAL(int, AF_INET, addresses->ai_family);
+    ASSERT_ARE_EQUAL(int, (int)inet_addr(TEST_ADDRESS), (int)((const struct sockaddr_in*)addresses->ai_addr)->sin_addr.s_addr);
+    ASSERT_ARE_EQUAL(size_t, 1, get_getaddrinfo_call_count());
+
+    // cleanup
+    dns_resolver_release(lookup);
+    dns_resolver_deinit();
+}
+
+/* Tests_SRS_DNS_RESOLVER_03_012: [ If the cache has an entry for hostname, resolved or pending, dns_resolver_lookup shall return a new reference to it. ]*/
+TEST_FUNCTION(dns_resolver_lookup_of_a_resolved_hostname_uses_the_cache)
+{
+    // arrange
+    const struct addrinfo* addresses = NULL;
+    DNS_RESOLVER_LOOKUP_HANDLE lookup;
+    DNS_RESOLVER_RESULT result;
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+    resolve_and_release(TEST_HOSTNAME);
+
+    // act
+    lookup = dns_resolver_lookup(TEST_HOSTNAME);
+    result = dns_resolver_get_result(lookup, &addresses, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(DNS_RESOLVER_RESULT, DNS_RESOLVER_OK, result);
+    ASSERT_IS_NOT_NULL(addresses);
+    ASSERT_ARE_EQUAL(size_t, 1, get_getaddrinfo_call_count());
+
+    // cleanup
+    dns_resolver_release(lookup);
+    dns_resolver_deinit();
+}
+
+/* Tests_SRS_DNS_RESOLVER_03_012: [ If the cache has an entry for hostname, resolved or pending, dns_resolver_lookup shall return a new reference to it. ]*/
+/* Tests_SRS_DNS_RESOLVER_03_017: [ While the host name is resolved, dns_resolver_get_result shall return DNS_RESOLVER_PENDING. ]*/
+TEST_FUNCTION(dns_resolver_lookups_of_a_pending_hostname_share_one_getaddrinfo)
+{
+    // arrange
+    DNS_RESOLVER_LOOKUP_HANDLE lookup_1;
+    DNS_RESOLVER_LOOKUP_HANDLE lookup_2;
+    DNS_RESOLVER_RESULT pending_result;
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+    set_is_getaddrinfo_held(true);
+
+    // act
+    lookup_1 = dns_resolver_lookup(TEST_HOSTNAME);
+    lookup_2 = dns_resolver_lookup(TEST_HOSTNAME);
+    pending_result = dns_resolver_get_result(lookup_2, NULL, NULL);
+    set_is_getaddrinfo_held(false);
+
+    // assert
+    ASSERT_IS_NOT_NULL(lookup_1);
+    ASSERT_IS_NOT_NULL(lookup_2);
+    ASSERT_ARE_EQUAL(DNS_RESOLVER_RESULT, DNS_RESOLVER_PENDING, pending_result);
+    ASSERT_ARE_EQUAL(DNS_RESOLVER_RESULT, DNS_RESOLVER_OK, wait_for_result(lookup_1, NULL, NULL));
+    ASSERT_ARE_EQUAL(DNS_RESOLVER_RESULT, DNS_RESOLVER_OK, wait_for_result(lookup_2, NULL, NULL));
+    ASSERT_ARE_EQUAL(size_t, 1, get_getaddrinfo_call_count());
+
+    // cleanup
+    dns_resolver_release(lookup_1);
+    dns_resolver_release(lookup_2);
+    dns_resolver_deinit();
+}
+
+/* Tests_SRS_DNS_RESOLVER_03_013: [ Otherwise dns_resolver_lookup shall add a pending entry for hostname to the cache, queue it for a worker thread, starting one if none is idle and fewer than DNS_RESOLVER_THREAD_COUNT run, and return a reference to it. ]*/
+TEST_FUNCTION(dns_resolver_lookup_is_not_held_by_a_pending_lookup_of_another_hostname)
+{
+    // arrange
+    DNS_RESOLVER_LOOKUP_HANDLE held_lookup;
+    DNS_RESOLVER_LOOKUP_HANDLE lookup;
+    size_t waited_ms = 0;
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+    set_is_getaddrinfo_held(true);
+    held_lookup = dns_resolver_lookup(TEST_HOSTNAME);
+    while ((get_getaddrinfo_call_count() == 0) && (waited_ms < TEST_WAIT_MS))
+    {
+        ThreadAPI_Sleep(1);
+        waited_ms++;
+    }
+
+    // act
+    lookup = dns_resolver_lookup(TEST_OTHER_HOSTNAME);
+
+    // assert
+    ASSERT_IS_NOT_NULL(held_lookup);
+    ASSERT_IS_NOT_NULL(lookup);
+    while ((get_getaddrinfo_call_count() < 2) && (waited_ms < TEST_WAIT_MS))
+    {
+        ThreadAPI_Sleep(1);
+        waited_ms++;
+    }
+    /* both host names are being resolved, each by its own thread */
+    ASSERT_ARE_EQUAL(size_t, 2, get_getaddrinfo_call_count());
+    set_is_getaddrinfo_held(false);
+    ASSERT_ARE_EQUAL(DNS_RESOLVER_RESULT, DNS_RESOLVER_OK, wait_for_result(held_lookup, NULL, NULL));
+    ASSERT_ARE_EQUAL(DNS_RESOLVER_RESULT, DNS_RESOLVER_OK, wait_for_result(lookup, NULL, NULL));
+
+    // cleanup
+    dns_resolver_release(held_lookup);
+    dns_resolver_release(lookup);
+    dns_resolver_deinit();
+}
+
+/* dns_resolver_get_result */
+
+/* Tests_SRS_DNS_RESOLVER_03_016: [ If lookup is NULL, dns_resolver_get_result shall fail and return DNS_RESOLVER_ERROR. ]*/
+TEST_FUNCTION(dns_resolver_get_result_with_NULL_lookup_fails)
+{
+    // arrange
+    DNS_RESOLVER_RESULT result;
+
+    // act
+    result = dns_resolver_get_result(NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(DNS_RESOLVER_RESULT, DNS_RESOLVER_ERROR, result);
+}
+
+/* Tests_SRS_DNS_RESOLVER_03_019: [ If resolving the host name failed, dns_resolver_get_result shall set error to the error getaddrinfo returned and return DNS_RESOLVER_ERROR. ]*/
+TEST_FUNCTION(dns_resolver_get_result_of_an_unknown_hostname_fails)
+{
+    // arrange
+    int error = 0;
+    DNS_RESOLVER_LOOKUP_HANDLE lookup;
+    DNS_RESOLVER_RESULT result;
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+    lookup = dns_resolver_lookup(TEST_UNKNOWN_HOSTNAME);
+
+    // act
+    result = wait_for_result(lookup, NULL, &error);
+
+    // assert
+    ASSERT_ARE_EQUAL(DNS_RESOLVER_RESULT, DNS_RESOLVER_ERROR, result);
+    ASSERT_ARE_EQUAL(int, EAI_NONAME, error);
+
+    // cleanup
+    dns_resolver_release(lookup);
+    dns_resolver_deinit();
+}
+
+/* Tests_SRS_DNS_RESOLVER_03_012: [ If the cache has an entry for hostname, resolved or pending, dns_resolver_lookup shall return a new reference to it. ]*/
+TEST_FUNCTION(dns_resolver_lookup_of_an_unknown_hostname_uses_the_negative_cache)
+{
+    // arrange
+    int error = 0;
+    DNS_RESOLVER_LOOKUP_HANDLE lookup;
+    DNS_RESOLVER_RESULT result;
+    ASSERT_ARE_EQUAL(int, 0, dns_resolver_init());
+    resolve_and_release(TEST_UNKNOWN_HOSTNAME);
+
+    // act
+    lookup = dns_resolver_lookup(TEST_UNKNOWN_HOSTNAME);
+    result = dns_resolver_get_result(lookup, NULL, &error);
+
+    // assert
+    ASSERT_ARE_EQUAL(DNS_RESOLVER_RESULT, DNS_RESOLVER_ERROR, result);
+    ASSERT_ARE_EQUAL(int, EAI_NONAME, error);
+    ASSERT_ARE_EQUAL(size_t, 1, get_getaddrinfo_call_count());
+
+    // cleanup
+    dns_resolver_release(lookup);
+    dns_resolver_deinit();
+}
+
+/* dns_resolver_release */
+
+/* Tests_SRS_DNS_RESOLVER_03_020: [ If lookup is NULL, dns_resolver_release shall return. ]*/
+TEST_FUNCTION(dns_resolver_release_with_NULL_lookup_returns)
+{
+    // arrange
+
+    // act
+    dns_resolver_release(NULL);
+
+    // assert
+}
+
+END_TEST_SUITE(dns_resolver_unittests)
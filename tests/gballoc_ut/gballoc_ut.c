@@ -30,6 +30,37 @@ static void* TEST_REALLOC_PTR = (void*)0x4245;
 #define OVERHEAD_SIZE	4096
 static const LOCK_HANDLE TEST_LOCK_HANDLE = (LOCK_HANDLE)0x4244;
 
+/* this has to match GBALLOC_SHARD_COUNT in gballoc.c */
+#define TEST_SHARD_COUNT 16
+
+/* callsites are identified by the file pointer, so every test uses its own file string */
+static const char TEST_FILE_1[] = "test_file_1.c";
+static const char TEST_FILE_2[] = "test_file_2.c";
+static const char TEST_FILE_3[] = "test_file_3.c";
+static const char TEST_FILE_4[] = "test_file_4.c";
+static const char TEST_FILE_5[] = "test_file_5.c";
+static const char TEST_FILE_6[] = "test_file_6.c";
+
+static int get_callsite_stats(const char* file, int line, GBALLOC_CALLSITE_STATS* stats)
+{
+    int result = 0;
+    GBALLOC_CALLSITE_STATS all_stats[32];
+    size_t count = gballoc_getTopCallsites(GBALLOC_CALLSITE_SORT_BY_ALLOCATION_COUNT, all_stats, sizeof(all_stats) / sizeof(all_stats[0]));
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        if ((all_stats[i].file == file) && (all_stats[i].line == line))
+        {
+            *stats = all_stats[i];
+            result = 1;
+            break;
+        }
+    }
+
+    return result;
+}
+
 #define ENABLE_MOCKS
 
 #include "umock_c.h"
@@ -144,11 +175,16 @@ TEST_FUNCTION(gballoc_init_resets_memory_used)
 
 /* Tests_SRS_GBALLOC_01_024: [gballoc_init shall initialize the gballoc module and return 0 upon success.] */
 /* Tests_SRS_GBALLOC_01_026: [gballoc_Init shall create a lock handle that will be used to make the other gballoc APIs thread-safe.] */
+/* Tests_SRS_GBALLOC_03_001: [ gballoc_init shall create one lock for each of the GBALLOC_SHARD_COUNT shards of the allocation index. ]*/
 TEST_FUNCTION(when_gballoc_init_calls_lock_init_and_it_succeeds_then_gballoc_init_succeeds)
 {
     // arrange
     int result;
-    STRICT_EXPECTED_CALL(Lock_Init());
+    size_t i;
+    for (i = 0; i < TEST_SHARD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(Lock_Init());
+    }
 
     // act
     result = gballoc_init();
@@ -174,12 +210,42 @@ TEST_FUNCTION(when_lock_init_fails_gballoc_init_fails)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+/* Tests_SRS_GBALLOC_01_027: [If the Lock creation fails, gballoc_init shall return a non-zero value.] */
+/* Tests_SRS_GBALLOC_03_002: [ If creating any of the shard locks fails, gballoc_init shall destroy the locks already created. ]*/
+TEST_FUNCTION(when_lock_init_fails_for_the_last_shard_gballoc_init_destroys_the_other_locks_and_fails)
+{
+    // arrange
+    int result;
+    size_t i;
+    for (i = 0; i < TEST_SHARD_COUNT - 1; i++)
+    {
+        STRICT_EXPECTED_CALL(Lock_Init());
+    }
+    STRICT_EXPECTED_CALL(Lock_Init())
+        .SetReturn((LOCK_HANDLE)NULL);
+    for (i = 0; i < TEST_SHARD_COUNT - 1; i++)
+    {
+        STRICT_EXPECTED_CALL(Lock_Deinit(TEST_LOCK_HANDLE));
+    }
+
+    // act
+    result = gballoc_init();
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 /* Tests_SRS_GBALLOC_01_025: [Init after Init shall fail and return a non-zero value.] */
 TEST_FUNCTION(gballoc_init_after_gballoc_init_fails)
 {
     // arrange
     int result;
-    STRICT_EXPECTED_CALL(Lock_Init());
+    size_t i;
+    for (i = 0; i < TEST_SHARD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(Lock_Init());
+    }
     gballoc_init();
 
     //act
@@ -196,10 +262,14 @@ TEST_FUNCTION(gballoc_init_after_gballoc_init_fails)
 TEST_FUNCTION(gballoc_deinit_frees_the_lock_when_the_module_was_initialized)
 {
     // arrange
+    size_t i;
     gballoc_init();
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(Lock_Deinit(TEST_LOCK_HANDLE));
+    for (i = 0; i < TEST_SHARD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(Lock_Deinit(TEST_LOCK_HANDLE));
+    }
 
     // act
     gballoc_deinit();
@@ -223,6 +293,7 @@ TEST_FUNCTION(gballoc_deinit_after_gballoc_deinit_doesnot_free_lock)
 /* gballoc_malloc */
 
 /* Tests_SRS_GBALLOC_01_048: [If acquiring the lock fails, gballoc_malloc shall return NULL.] */
+/* Tests_SRS_GBALLOC_03_003: [ The lock taken shall be the lock of the shard owning the allocated pointer, the underlying allocation function shall be called without holding any lock. ]*/
 TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_malloc_fails)
 {
     // arrange
@@ -230,8 +301,13 @@ TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_malloc_fails)
     gballoc_init();
     umock_c_reset_all_calls();
 
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(TEST_ALLOC_PTR2);
+    STRICT_EXPECTED_CALL(mock_malloc(1));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
         .SetReturn(LOCK_ERROR);
+    STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR1));
+    STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR2));
 
     // act
     result = gballoc_malloc(1);
@@ -253,12 +329,12 @@ TEST_FUNCTION(gballoc_malloc_with_0_Size_Calls_Underlying_malloc)
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
     STRICT_EXPECTED_CALL(mock_malloc(0));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -286,12 +362,12 @@ TEST_FUNCTION(gballoc_malloc_with_1_Size_Calls_Underlying_malloc_And_Increases_M
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
     STRICT_EXPECTED_CALL(mock_malloc(1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -317,7 +393,6 @@ TEST_FUNCTION(When_malloc_Fails_Then_gballoc_malloc_fails_too)
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
@@ -325,7 +400,6 @@ TEST_FUNCTION(When_malloc_Fails_Then_gballoc_malloc_fails_too)
     STRICT_EXPECTED_CALL(mock_malloc(1))
         .SetReturn((void*)NULL);
     STRICT_EXPECTED_CALL(mock_free(allocation));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_malloc(1);
@@ -347,11 +421,9 @@ TEST_FUNCTION(When_allocating_memory_for_tracking_information_fails_Then_gballoc
     gballoc_init();
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn((void*)NULL);
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_malloc(1);
@@ -387,8 +459,13 @@ TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_calloc_fails)
     gballoc_init();
     umock_c_reset_all_calls();
 
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(TEST_ALLOC_PTR2);
+    STRICT_EXPECTED_CALL(mock_calloc(1, 1));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
-    .SetReturn(LOCK_ERROR);
+        .SetReturn(LOCK_ERROR);
+    STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR1));
+    STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR2));
 
     // act
     result = gballoc_calloc(1,1);
@@ -410,12 +487,12 @@ TEST_FUNCTION(gballoc_calloc_with_0_Size_And_ItemCount_Calls_Underlying_calloc)
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
     STRICT_EXPECTED_CALL(mock_calloc(0, 0));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -442,12 +519,12 @@ TEST_FUNCTION(gballoc_calloc_with_1_Item_Of_1_Size_Calls_Underlying_malloc_And_I
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
     STRICT_EXPECTED_CALL(mock_calloc(1, 1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -474,12 +551,12 @@ TEST_FUNCTION(gballoc_calloc_with_1_Item_Of_0_Size_Calls_Underlying_malloc_And_D
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
     STRICT_EXPECTED_CALL(mock_calloc(1, 0));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -506,12 +583,12 @@ TEST_FUNCTION(gballoc_calloc_with_0_Items_Of_1_Size_Calls_Underlying_malloc_And_
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
     STRICT_EXPECTED_CALL(mock_calloc(0, 1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -538,12 +615,12 @@ TEST_FUNCTION(gballoc_calloc_with_42_Items_Of_2_Size_Calls_Underlying_malloc_And
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
     STRICT_EXPECTED_CALL(mock_calloc(42, 2));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -569,7 +646,6 @@ TEST_FUNCTION(When_calloc_Fails_Then_gballoc_calloc_fails_too)
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
@@ -577,7 +653,6 @@ TEST_FUNCTION(When_calloc_Fails_Then_gballoc_calloc_fails_too)
     STRICT_EXPECTED_CALL(mock_calloc(1, 1))
         .SetReturn((void*)NULL);
     STRICT_EXPECTED_CALL(mock_free(allocation));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_calloc(1, 1);
@@ -599,11 +674,9 @@ TEST_FUNCTION(When_allocating_memory_for_tracking_information_fails_Then_gballoc
     gballoc_init();
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn((void*)NULL);
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_calloc(1, 1);
@@ -640,8 +713,13 @@ TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_realloc_fails)
     gballoc_init();
     umock_c_reset_all_calls();
 
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(TEST_ALLOC_PTR2);
+    STRICT_EXPECTED_CALL(mock_realloc(NULL, 1));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
         .SetReturn(LOCK_ERROR);
+    STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR1));
+    STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR2));
 
     // act
     result = gballoc_realloc(NULL, 1);
@@ -678,12 +756,12 @@ TEST_FUNCTION(gballoc_realloc_with_NULL_Arg_And_0_Size_Calls_Underlying_realloc)
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
     STRICT_EXPECTED_CALL(mock_realloc(NULL, 0));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -710,12 +788,12 @@ TEST_FUNCTION(gballoc_realloc_with_NULL_Arg_And_1_Size_Calls_Underlying_realloc)
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
     STRICT_EXPECTED_CALL(mock_realloc(NULL, 1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
@@ -733,6 +811,7 @@ TEST_FUNCTION(gballoc_realloc_with_NULL_Arg_And_1_Size_Calls_Underlying_realloc)
 
 /* Tests_SRS_GBALLOC_01_005: [gballoc_realloc shall call the C99 realloc function and return its result.] */
 /* Tests_SRS_GBALLOC_01_006: [If the underlying realloc call is successful, gballoc_realloc shall look up the size associated with the pointer ptr and decrease the total memory used with that size.] */
+/* Tests_SRS_GBALLOC_03_017: [ gballoc_realloc shall take the block out of the allocation index and call the underlying realloc without holding any lock. ]*/
 TEST_FUNCTION(gballoc_realloc_with_Previous_1_Byte_Block_Ptr_And_2_Size_Calls_Underlying_realloc_And_Increases_Max_Used_Memory)
 {
     // arrange
@@ -742,16 +821,19 @@ TEST_FUNCTION(gballoc_realloc_with_Previous_1_Byte_Block_Ptr_And_2_Size_Calls_Un
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
     STRICT_EXPECTED_CALL(mock_realloc(NULL, 1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(mock_realloc(TEST_ALLOC_PTR1, 2))
         .SetReturn(TEST_ALLOC_PTR2);
+    /* TEST_ALLOC_PTR2 belongs to another shard than TEST_ALLOC_PTR1, so it is indexed under that shard's lock */
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     result = gballoc_realloc(NULL, 1);
@@ -770,6 +852,7 @@ TEST_FUNCTION(gballoc_realloc_with_Previous_1_Byte_Block_Ptr_And_2_Size_Calls_Un
 }
 
 /* Tests_SRS_GBALLOC_01_014: [When the underlying realloc call fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
+/* Tests_SRS_GBALLOC_03_018: [ If the underlying realloc fails, gballoc_realloc shall put the block back in the allocation index. ]*/
 TEST_FUNCTION(When_realloc_fails_then_gballoc_realloc_Fails_Too_And_No_Change_Is_Made_To_Memory_Counters)
 {
     // arrange
@@ -779,16 +862,19 @@ TEST_FUNCTION(When_realloc_fails_then_gballoc_realloc_Fails_Too_And_No_Change_Is
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
     STRICT_EXPECTED_CALL(mock_realloc(NULL, 1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(mock_realloc(TEST_ALLOC_PTR1, 2))
         .SetReturn((void*)NULL);
+    /* the block is put back in the allocation index */
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     result = gballoc_realloc(NULL, 1);
@@ -806,6 +892,90 @@ TEST_FUNCTION(When_realloc_fails_then_gballoc_realloc_Fails_Too_And_No_Change_Is
     free(allocation);
 }
 
+/* Tests_SRS_GBALLOC_03_019: [ If acquiring the lock fails after the underlying realloc was called, gballoc_realloc shall keep the block in a list of its shard that is indexed the next time the lock of the shard is taken. ]*/
+TEST_FUNCTION(when_acquiring_the_lock_fails_after_realloc_the_block_can_still_be_freed)
+{
+    // arrange
+    void* result;
+    void* allocation;
+    gballoc_init();
+    umock_c_reset_all_calls();
+    allocation = malloc(OVERHEAD_SIZE);
+
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation);
+    STRICT_EXPECTED_CALL(mock_realloc(NULL, 1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(mock_realloc(TEST_ALLOC_PTR1, 2))
+        .SetReturn(TEST_ALLOC_PTR2);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
+        .SetReturn(LOCK_ERROR);
+    /* the block is indexed by gballoc_free, which frees it */
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR2));
+    STRICT_EXPECTED_CALL(mock_free(allocation));
+
+    result = gballoc_realloc(NULL, 1);
+
+    // act
+    result = gballoc_realloc(result, 2);
+    gballoc_free(result);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_ALLOC_PTR2, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    free(allocation);
+}
+
+/* Tests_SRS_GBALLOC_03_019: [ If acquiring the lock fails after the underlying realloc was called, gballoc_realloc shall keep the block in a list of its shard that is indexed the next time the lock of the shard is taken. ]*/
+TEST_FUNCTION(when_realloc_fails_and_acquiring_the_lock_fails_the_block_can_still_be_freed)
+{
+    // arrange
+    void* result;
+    void* allocation;
+    gballoc_init();
+    umock_c_reset_all_calls();
+    allocation = malloc(OVERHEAD_SIZE);
+
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation);
+    STRICT_EXPECTED_CALL(mock_realloc(NULL, 1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(mock_realloc(TEST_ALLOC_PTR1, 2))
+        .SetReturn((void*)NULL);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
+        .SetReturn(LOCK_ERROR);
+    /* the block is indexed by gballoc_free, which frees it */
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR1));
+    STRICT_EXPECTED_CALL(mock_free(allocation));
+
+    result = gballoc_realloc(NULL, 1);
+
+    // act
+    result = gballoc_realloc(result, 2);
+    gballoc_free(TEST_ALLOC_PTR1);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    free(allocation);
+}
+
 /* Tests_SRS_GBALLOC_01_015: [When allocating memory used for tracking by gballoc_realloc fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
 TEST_FUNCTION(When_Allocating_Memory_For_tracking_fails_gballoc_realloc_fails)
 {
@@ -814,11 +984,9 @@ TEST_FUNCTION(When_Allocating_Memory_For_tracking_fails_gballoc_realloc_fails)
     gballoc_init();
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn((void*)NULL);
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_realloc(NULL, 1);
@@ -840,12 +1008,12 @@ TEST_FUNCTION(When_The_Pointer_Is_Not_Tracked_gballoc_realloc_Returns_NULL)
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     /* This is the call to the underlying malloc with the size we want to allocate */
     STRICT_EXPECTED_CALL(mock_realloc(NULL, 1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
@@ -875,7 +1043,6 @@ TEST_FUNCTION(When_ptr_is_null_and_the_underlying_realloc_fails_then_the_memory_
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
@@ -883,7 +1050,6 @@ TEST_FUNCTION(When_ptr_is_null_and_the_underlying_realloc_fails_then_the_memory_
     STRICT_EXPECTED_CALL(mock_realloc(NULL, 1))
         .SetReturn((void*)NULL);
     STRICT_EXPECTED_CALL(mock_free(allocation));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_realloc(NULL, 1);
@@ -949,6 +1115,7 @@ TEST_FUNCTION(when_acquiring_the_lock_fails_then_gballoc_free_does_nothing)
 /* Tests_SRS_GBALLOC_01_010: [gballoc_getMaximumMemoryUsed shall return the maximum amount of total memory used recorded since the module initialization.] */
 /* Tests_SRS_GBALLOC_01_011: [The maximum total memory used shall be the maximum of the total memory used at any point.] */
 /* Tests_SRS_GBALLOC_01_033: [gballoc_free shall ensure thread safety by using the lock created by gballoc_Init.] */
+/* Tests_SRS_GBALLOC_03_004: [ gballoc_free shall call the underlying free after releasing the shard lock. ]*/
 TEST_FUNCTION(gballoc_free_calls_the_underlying_free)
 {
     // arrange
@@ -967,9 +1134,9 @@ TEST_FUNCTION(gballoc_free_calls_the_underlying_free)
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR1));
     STRICT_EXPECTED_CALL(mock_free(allocation));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     gballoc_free(block);
@@ -1004,16 +1171,16 @@ TEST_FUNCTION(gballoc_malloc_free_2_times_with_1_byte_yields_1_byte_as_max)
     gballoc_free(block);
 
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     block = gballoc_realloc(NULL, 1);
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(mock_free(TEST_ALLOC_PTR1));
     STRICT_EXPECTED_CALL(mock_free(allocation));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     gballoc_free(block);
@@ -1036,9 +1203,9 @@ TEST_FUNCTION(gballoc_free_with_an_untracked_pointer_does_not_alter_total_memory
     allocation = malloc(OVERHEAD_SIZE);
 
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
 
     gballoc_realloc(NULL, 1);
     umock_c_reset_all_calls();
@@ -1062,15 +1229,13 @@ TEST_FUNCTION(gballoc_free_with_an_untracked_pointer_does_not_alter_total_memory
 /* gballoc_getMaximumMemoryUsed */
 
 
-/* Tests_SRS_GBALLOC_01_034: [gballoc_getMaximumMemoryUsed shall ensure thread safety by using the lock created by gballoc_Init.] */
-TEST_FUNCTION(when_gballoc_getMaximumMemoryUsed_called_It_Shall_Lock_And_Unlock)
+/* Tests_SRS_GBALLOC_01_034: [gballoc_getMaximumMemoryUsed shall ensure thread safety by reading the counter atomically, without taking any lock.] */
+TEST_FUNCTION(gballoc_getMaximumMemoryUsed_does_not_lock)
 {
     // arrange
     gballoc_init();
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     // act
     (void)gballoc_getMaximumMemoryUsed();
 
@@ -1078,25 +1243,6 @@ TEST_FUNCTION(when_gballoc_getMaximumMemoryUsed_called_It_Shall_Lock_And_Unlock)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/* Tests_SRS_GBALLOC_01_050: [If the lock cannot be acquired, gballoc_getMaximumMemoryUsed shall return SIZE_MAX.] */
-TEST_FUNCTION(when_acquiring_the_lock_fails_then_gballoc_getMaximumMemoryUsed_fails)
-{
-    // arrange
-    size_t result;
-    gballoc_init();
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
-        .SetReturn(LOCK_ERROR);
-
-    // act
-    result = gballoc_getMaximumMemoryUsed();
-
-    // assert
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(size_t, SIZE_MAX, result);
-}
-
 /* Tests_SRS_GBALLOC_01_038: [If gballoc was not initialized gballoc_getMaximumMemoryUsed shall return MAX_INT_SIZE.]  */
 TEST_FUNCTION(gballoc_getMaximumMemoryUsed_after_deinit_fails)
 {
@@ -1124,14 +1270,12 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_returns_1)
 
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     STRICT_EXPECTED_CALL(mock_malloc(1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     toBeFreed = gballoc_malloc(1);
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_getCurrentMemoryUsed();
@@ -1157,13 +1301,11 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_2x3_byte_calloc_returns_6)
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     toBeFreed = gballoc_calloc(2, 3);
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_getCurrentMemoryUsed();
@@ -1189,17 +1331,15 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_3_bytes_reall
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     STRICT_EXPECTED_CALL(mock_malloc(1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     toBeFreed = gballoc_malloc(1);
     toBeFreed = gballoc_realloc(toBeFreed, 3);
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_getCurrentMemoryUsed();
@@ -1225,17 +1365,15 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_free_returns_
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     STRICT_EXPECTED_CALL(mock_malloc(1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     toBeFreed = gballoc_malloc(1);
     gballoc_free(toBeFreed);
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_getCurrentMemoryUsed();
@@ -1260,16 +1398,14 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_2x3_byte_calloc_and_free_return
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     toBeFreed = gballoc_calloc(2, 3);
     gballoc_free(toBeFreed);
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_getCurrentMemoryUsed();
@@ -1294,18 +1430,16 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_realloc_and_free_returns_0)
     umock_c_reset_all_calls();
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     STRICT_EXPECTED_CALL(mock_malloc(1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     toBeFreed = gballoc_malloc(1);
     toBeFreed = gballoc_realloc(toBeFreed, 3);
     gballoc_free(toBeFreed);
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_getCurrentMemoryUsed();
@@ -1334,22 +1468,20 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_1_byte_malloc
     allocation1 = malloc(OVERHEAD_SIZE);
     allocation2 = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation1);
     STRICT_EXPECTED_CALL(mock_malloc(1));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation2);
     STRICT_EXPECTED_CALL(mock_malloc(1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     toBeFreed1 = gballoc_malloc(1);
     toBeFreed2 = gballoc_malloc(1);
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_getCurrentMemoryUsed();
@@ -1381,23 +1513,21 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_1_byte_malloc
     allocation1 = malloc(OVERHEAD_SIZE);
     allocation2 = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation1);
     STRICT_EXPECTED_CALL(mock_malloc(1));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation2);
     STRICT_EXPECTED_CALL(mock_malloc(1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     toBeFreed1 = gballoc_malloc(1);
     toBeFreed2 = gballoc_malloc(1);
     toBeFreed2 = gballoc_realloc(toBeFreed2, 3);
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_getCurrentMemoryUsed();
@@ -1429,22 +1559,20 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_6_byte_calloc
     allocation1 = malloc(OVERHEAD_SIZE);
     allocation2 = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation1);
     STRICT_EXPECTED_CALL(mock_malloc(1));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation2);
     STRICT_EXPECTED_CALL(mock_calloc(2, 3));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     toBeFreed1 = gballoc_malloc(1);
     toBeFreed2 = gballoc_calloc(2, 3);
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_getCurrentMemoryUsed();
@@ -1475,25 +1603,23 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_6_byte_calloc
     allocation1 = malloc(OVERHEAD_SIZE);
     allocation2 = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation1);
     STRICT_EXPECTED_CALL(mock_malloc(1))
         .SetReturn((char*)allocation1 + OVERHEAD_SIZE / 2); /*somewhere in the middle of allocation*/
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation2);
     STRICT_EXPECTED_CALL(mock_calloc(2, 3))
         .SetReturn((char*)allocation2 + OVERHEAD_SIZE / 2);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     toBeFreed1 = gballoc_malloc(1);
     toBeFreed2 = gballoc_calloc(2, 3);
     gballoc_free(toBeFreed1);
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_getCurrentMemoryUsed();
@@ -1523,18 +1649,20 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_1_byte_malloc
     allocation1 = malloc(OVERHEAD_SIZE);
     allocation2 = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation1);
     STRICT_EXPECTED_CALL(mock_malloc(1))
         .SetReturn((char*)allocation1 + OVERHEAD_SIZE / 2); /*somewhere in the middle of allocation*/
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation2);
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(mock_realloc(IGNORED_PTR_ARG, 3))
         .IgnoreArgument(1)
         .SetReturn((char*)allocation2 + OVERHEAD_SIZE / 2); /*somewhere in the middle of allocation*/
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     toBeFreed1 = gballoc_malloc(1);
@@ -1542,8 +1670,6 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_1_byte_malloc
     toBeFreed2 = gballoc_realloc(toBeFreed2, 3);
     gballoc_free(toBeFreed1);
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
     result = gballoc_getCurrentMemoryUsed();
@@ -1559,17 +1685,14 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_1_byte_malloc
     umock_c_reset_all_calls(); //this is just for mathematics, not for functionality
 }
 
-/* Tests_SRS_GBALLOC_01_036: [gballoc_getCurrentMemoryUsed shall ensure thread safety by using the lock created by gballoc_Init.] */
-TEST_FUNCTION(gballoc_getCurrentMemoryUsed_locks_and_unlocks)
+/* Tests_SRS_GBALLOC_01_036: [gballoc_getCurrentMemoryUsed shall ensure thread safety by adding up the per shard counters without taking any lock.] */
+TEST_FUNCTION(gballoc_getCurrentMemoryUsed_does_not_lock)
 {
     // assert
     size_t result;
     gballoc_init();
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
-
     // act
     result = gballoc_getCurrentMemoryUsed();
 
@@ -1591,85 +1714,107 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_deinit_fails)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/* Tests_SRS_GBALLOC_01_051: [If the lock cannot be acquired, gballoc_getCurrentMemoryUsed shall return SIZE_MAX.] */
-TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_getCurrentMemoryUsed_fails)
+/* Tests_SRS_GBALLOC_07_001: [ If gballoc was not initialized gballoc_getAllocationCount shall return SIZE_MAX. ] */
+TEST_FUNCTION(gballoc_getAllocationCount_without_init_fail)
 {
     // arrange
     size_t result;
-    gballoc_init();
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
-        .SetReturn(LOCK_ERROR);
 
     // act
-    result = gballoc_getCurrentMemoryUsed();
+    result = gballoc_getAllocationCount();
 
     // assert
-    ASSERT_ARE_EQUAL(size_t, SIZE_MAX, result);
+    ASSERT_ARE_EQUAL(size_t, 0, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/* Tests_SRS_GBALLOC_07_001: [ If gballoc was not initialized gballoc_getAllocationCount shall return SIZE_MAX. ] */
-TEST_FUNCTION(gballoc_getAllocationCount_without_init_fail)
+/* Tests_SRS_GBALLOC_07_004: [ gballoc_getAllocationCount shall return the currently number of allocations. ] */
+/* Tests_SRS_GBALLOC_07_002: [ gballoc_getAllocationCount shall ensure thread safety by adding up the per shard counters without taking any lock. ] */
+TEST_FUNCTION(gballoc_getAllocationCount_success)
 {
     // arrange
+    void* allocation;
+    void* toBeFreed;
     size_t result;
+    gballoc_init();
+    umock_c_reset_all_calls();
+
+    allocation = malloc(OVERHEAD_SIZE);
+
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation);
+    STRICT_EXPECTED_CALL(mock_malloc(1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    toBeFreed = gballoc_malloc(1);
+    umock_c_reset_all_calls();
 
     // act
     result = gballoc_getAllocationCount();
 
     // assert
-    ASSERT_ARE_EQUAL(size_t, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // Cleanup
+    gballoc_free(toBeFreed);
+    free(allocation);
 }
 
-/* Tests_SRS_GBALLOC_07_003: [ If the lock cannot be acquired, gballoc_getAllocationCount shall return SIZE_MAX. ] */
-TEST_FUNCTION(gballoc_getAllocationCount_lock_fail)
+TEST_FUNCTION(gballoc_resetMetrics_without_init_fail)
 {
     // arrange
-    size_t result;
-    gballoc_init();
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
-        .SetReturn(LOCK_ERROR);
 
     // act
-    result = gballoc_getAllocationCount();
+    gballoc_resetMetrics();
 
     // assert
-    ASSERT_ARE_EQUAL(size_t, 0, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/* Tests_SRS_GBALLOC_07_004: [ gballoc_getAllocationCount shall return the currently number of allocations. ] */
-/* Tests_SRS_GBALLOC_07_002: [ gballoc_getAllocationCount shall ensure thread safety by using the lock created by gballoc_Init ] */
-TEST_FUNCTION(gballoc_getAllocationCount_success)
+/* Tests_SRS_GBALLOC_07_006: [ gballoc_resetMetrics shall take the locks of all the shards, so that no allocation is counted partly before and partly after the reset. ]*/
+/* Tests_SRS_GBALLOC_07_008: [ gballoc_resetMetrics shall reset the total allocation size, max allocation size and number of allocation to zero. ] */
+TEST_FUNCTION(gballoc_resetMetrics_success)
 {
     // arrange
     void* allocation;
     void* toBeFreed;
-    size_t result;
+    size_t mem_used;
+    size_t alloc_count;
+    size_t i;
     gballoc_init();
     umock_c_reset_all_calls();
 
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
     STRICT_EXPECTED_CALL(mock_malloc(1));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     toBeFreed = gballoc_malloc(1);
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    alloc_count = gballoc_getAllocationCount();
+    ASSERT_ARE_EQUAL(size_t, 1, alloc_count);
+    umock_c_reset_all_calls();
+
+    for (i = 0; i < TEST_SHARD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    }
+    for (i = 0; i < TEST_SHARD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    }
 
     // act
-    result = gballoc_getAllocationCount();
+    gballoc_resetMetrics();
+    mem_used = gballoc_getCurrentMemoryUsed();
+    alloc_count = gballoc_getAllocationCount();
 
     // assert
-    ASSERT_ARE_EQUAL(size_t, 1, result);
+    ASSERT_ARE_EQUAL(size_t, 0, mem_used);
+    ASSERT_ARE_EQUAL(size_t, 0, alloc_count);
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getMaximumMemoryUsed());
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // Cleanup
@@ -1677,81 +1822,436 @@ TEST_FUNCTION(gballoc_getAllocationCount_success)
     free(allocation);
 }
 
-TEST_FUNCTION(gballoc_resetMetrics_without_init_fail)
+/* Tests_SRS_GBALLOC_07_009: [ If acquiring any of the shard locks fails, gballoc_resetMetrics shall release the locks it acquired and do nothing. ]*/
+TEST_FUNCTION(when_acquiring_the_last_shard_lock_fails_gballoc_resetMetrics_does_nothing)
 {
     // arrange
+    void* allocation;
+    void* toBeFreed;
+    size_t i;
+    gballoc_init();
+    umock_c_reset_all_calls();
+
+    allocation = malloc(OVERHEAD_SIZE);
+
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation);
+    toBeFreed = gballoc_malloc(1);
+    umock_c_reset_all_calls();
+
+    for (i = 0; i < TEST_SHARD_COUNT - 1; i++)
+    {
+        STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    }
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
+        .SetReturn(LOCK_ERROR);
+    for (i = 0; i < TEST_SHARD_COUNT - 1; i++)
+    {
+        STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    }
 
     // act
     gballoc_resetMetrics();
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getMaximumMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getAllocationCount());
+
+    // Cleanup
+    gballoc_free(toBeFreed);
+    free(allocation);
 }
 
-/* Tests_SRS_GBALLOC_07_003: [ If the lock cannot be acquired, gballoc_getAllocationCount shall return SIZE_MAX. ] */
-TEST_FUNCTION(gballoc_resetMetrics_lock_fail)
+/* Tests_SRS_GBALLOC_07_010: [ Blocks allocated before gballoc_resetMetrics shall not be deducted from the total memory used when they are freed or reallocated. ]*/
+TEST_FUNCTION(gballoc_free_of_a_block_allocated_before_gballoc_resetMetrics_does_not_wrap_the_counters)
 {
     // arrange
+    void* allocation1;
+    void* allocation2;
+    void* beforeReset;
+    void* afterReset;
     gballoc_init();
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
-        .SetReturn(LOCK_ERROR);
+    allocation1 = malloc(OVERHEAD_SIZE);
+    allocation2 = malloc(OVERHEAD_SIZE);
 
-    // act
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation1);
+    beforeReset = gballoc_malloc(100);
     gballoc_resetMetrics();
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation2);
+    STRICT_EXPECTED_CALL(mock_malloc(10))
+        .SetReturn(TEST_ALLOC_PTR2);
+    afterReset = gballoc_malloc(10);
+    umock_c_reset_all_calls();
+
+    // act
+    gballoc_free(beforeReset);
 
     // assert
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 10, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 10, gballoc_getMaximumMemoryUsed());
+
+    // cleanup
+    gballoc_free(afterReset);
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 10, gballoc_getMaximumMemoryUsed());
+    free(allocation1);
+    free(allocation2);
 }
 
-/* Tests_SRS_GBALLOC_07_004: [ gballoc_getAllocationCount shall return the currently number of allocations. ] */
-/* Tests_SRS_GBALLOC_07_002: [ gballoc_getAllocationCount shall ensure thread safety by using the lock created by gballoc_Init ] */
-TEST_FUNCTION(gballoc_resetMetrics_success)
+/* Tests_SRS_GBALLOC_07_010: [ Blocks allocated before gballoc_resetMetrics shall not be deducted from the total memory used when they are freed or reallocated. ]*/
+TEST_FUNCTION(gballoc_realloc_of_a_block_allocated_before_gballoc_resetMetrics_counts_only_the_new_size)
 {
     // arrange
     void* allocation;
-    void* toBeFreed;
-    size_t mem_used;
-    size_t alloc_count;
+    void* block;
     gballoc_init();
     umock_c_reset_all_calls();
 
     allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     EXPECTED_CALL(mock_malloc(0))
         .SetReturn(allocation);
-    STRICT_EXPECTED_CALL(mock_malloc(1));
-    toBeFreed = gballoc_malloc(1);
+    block = gballoc_malloc(100);
+    gballoc_resetMetrics();
     umock_c_reset_all_calls();
+
+    // act
+    block = gballoc_realloc(block, 10);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 10, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 10, gballoc_getMaximumMemoryUsed());
+
+    // cleanup
+    gballoc_free(block);
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+    free(allocation);
+}
+
+/* gballoc_malloc_at */
+
+/* Tests_SRS_GBALLOC_03_005: [ gballoc_malloc_at, gballoc_calloc_at and gballoc_realloc_at shall behave like gballoc_malloc, gballoc_calloc and gballoc_realloc. ]*/
+/* Tests_SRS_GBALLOC_03_006: [ gballoc_malloc_at, gballoc_calloc_at and gballoc_realloc_at shall account the allocation to the callsite identified by file and line. ]*/
+TEST_FUNCTION(gballoc_malloc_at_accounts_the_allocation_to_its_callsite)
+{
+    // arrange
+    void* allocation;
+    void* result;
+    GBALLOC_CALLSITE_STATS stats;
+    gballoc_init();
+    umock_c_reset_all_calls();
+
+    allocation = malloc(OVERHEAD_SIZE);
+
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation);
+    STRICT_EXPECTED_CALL(mock_malloc(10));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
-    alloc_count = gballoc_getAllocationCount();
-    ASSERT_ARE_EQUAL(size_t, 1, alloc_count);
+    // act
+    result = gballoc_malloc_at(10, TEST_FILE_1, 42);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_ALLOC_PTR1, result);
+    ASSERT_ARE_EQUAL(size_t, 10, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(int, 1, get_callsite_stats(TEST_FILE_1, 42, &stats));
+    ASSERT_ARE_EQUAL(size_t, 10, stats.liveBytes);
+    ASSERT_ARE_EQUAL(size_t, 10, stats.peakBytes);
+    ASSERT_ARE_EQUAL(size_t, 1, stats.liveAllocations);
+    ASSERT_ARE_EQUAL(size_t, 1, stats.allocationCount);
+
+    // cleanup
+    gballoc_free(result);
+    free(allocation);
+}
+
+/* Tests_SRS_GBALLOC_03_006: [ gballoc_malloc_at, gballoc_calloc_at and gballoc_realloc_at shall account the allocation to the callsite identified by file and line. ]*/
+TEST_FUNCTION(gballoc_calloc_at_accounts_the_allocation_to_its_callsite)
+{
+    // arrange
+    void* allocation;
+    void* result;
+    GBALLOC_CALLSITE_STATS stats;
+    gballoc_init();
     umock_c_reset_all_calls();
 
+    allocation = malloc(OVERHEAD_SIZE);
+
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation);
+    STRICT_EXPECTED_CALL(mock_calloc(2, 3));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = gballoc_calloc_at(2, 3, TEST_FILE_2, 7);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_ALLOC_PTR1, result);
+    ASSERT_ARE_EQUAL(int, 1, get_callsite_stats(TEST_FILE_2, 7, &stats));
+    ASSERT_ARE_EQUAL(size_t, 6, stats.liveBytes);
+    ASSERT_ARE_EQUAL(size_t, 1, stats.allocationCount);
+
+    // cleanup
+    gballoc_free(result);
+    free(allocation);
+}
+
+/* Tests_SRS_GBALLOC_01_009: [gballoc_free shall also look up the size associated with the ptr pointer and decrease the total memory used with the associated size amount.] */
+TEST_FUNCTION(gballoc_free_removes_the_block_from_the_live_bytes_of_its_callsite)
+{
+    // arrange
+    void* allocation;
+    void* block;
+    GBALLOC_CALLSITE_STATS stats;
+    gballoc_init();
+    allocation = malloc(OVERHEAD_SIZE);
+
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation);
+    block = gballoc_malloc_at(5, TEST_FILE_3, 1);
+    umock_c_reset_all_calls();
+
+    // act
+    gballoc_free(block);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 1, get_callsite_stats(TEST_FILE_3, 1, &stats));
+    ASSERT_ARE_EQUAL(size_t, 0, stats.liveBytes);
+    ASSERT_ARE_EQUAL(size_t, 0, stats.liveAllocations);
+    ASSERT_ARE_EQUAL(size_t, 5, stats.peakBytes);
+    ASSERT_ARE_EQUAL(size_t, 1, stats.allocationCount);
+
+    // cleanup
+    free(allocation);
+}
+
+/* gballoc_realloc_at */
+
+/* Tests_SRS_GBALLOC_03_007: [ When ptr is not NULL, gballoc_realloc_at shall move the accounting of the block from its previous callsite to the callsite identified by file and line. ]*/
+TEST_FUNCTION(gballoc_realloc_at_moves_the_block_to_the_new_callsite)
+{
+    // arrange
+    void* allocation;
+    void* block;
+    GBALLOC_CALLSITE_STATS stats;
+    gballoc_init();
+    allocation = malloc(OVERHEAD_SIZE);
+
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation);
+    block = gballoc_malloc_at(5, TEST_FILE_4, 1);
+    umock_c_reset_all_calls();
+
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(mock_realloc(TEST_ALLOC_PTR1, 8));
     STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
 
     // act
-    gballoc_resetMetrics();
-    mem_used = gballoc_getCurrentMemoryUsed();
-    alloc_count = gballoc_getAllocationCount();
+    block = gballoc_realloc_at(block, 8, TEST_FILE_4, 2);
 
     // assert
-    ASSERT_ARE_EQUAL(size_t, 0, mem_used);
-    ASSERT_ARE_EQUAL(size_t, 0, alloc_count);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 1, get_callsite_stats(TEST_FILE_4, 1, &stats));
+    ASSERT_ARE_EQUAL(size_t, 0, stats.liveBytes);
+    ASSERT_ARE_EQUAL(size_t, 0, stats.liveAllocations);
+    ASSERT_ARE_EQUAL(int, 1, get_callsite_stats(TEST_FILE_4, 2, &stats));
+    ASSERT_ARE_EQUAL(size_t, 8, stats.liveBytes);
+    ASSERT_ARE_EQUAL(size_t, 1, stats.liveAllocations);
+    ASSERT_ARE_EQUAL(size_t, 1, stats.allocationCount);
 
-    // Cleanup
-    gballoc_free(toBeFreed);
+    // cleanup
+    gballoc_free(block);
+    free(allocation);
+}
+
+/* Tests_SRS_GBALLOC_03_008: [ gballoc_realloc shall keep the block accounted to its previous callsite. ]*/
+TEST_FUNCTION(gballoc_realloc_keeps_the_block_on_its_callsite)
+{
+    // arrange
+    void* allocation;
+    void* block;
+    GBALLOC_CALLSITE_STATS stats;
+    gballoc_init();
+    allocation = malloc(OVERHEAD_SIZE);
+
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation);
+    block = gballoc_malloc_at(5, TEST_FILE_5, 1);
+    umock_c_reset_all_calls();
+
+    // act
+    block = gballoc_realloc(block, 8);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 1, get_callsite_stats(TEST_FILE_5, 1, &stats));
+    ASSERT_ARE_EQUAL(size_t, 8, stats.liveBytes);
+    ASSERT_ARE_EQUAL(size_t, 8, stats.peakBytes);
+    ASSERT_ARE_EQUAL(size_t, 1, stats.liveAllocations);
+    ASSERT_ARE_EQUAL(size_t, 2, stats.allocationCount);
+
+    // cleanup
+    gballoc_free(block);
     free(allocation);
 }
 
+/* gballoc_getTopCallsites */
+
+/* Tests_SRS_GBALLOC_03_009: [ If callsite_stats is NULL and count is not 0, gballoc_getTopCallsites shall return 0. ]*/
+TEST_FUNCTION(gballoc_getTopCallsites_with_NULL_callsite_stats_fails)
+{
+    // arrange
+    size_t result;
+    gballoc_init();
+    umock_c_reset_all_calls();
+
+    // act
+    result = gballoc_getTopCallsites(GBALLOC_CALLSITE_SORT_BY_LIVE_BYTES, NULL, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_03_010: [ If sort is not a GBALLOC_CALLSITE_SORT value, gballoc_getTopCallsites shall return 0. ]*/
+TEST_FUNCTION(gballoc_getTopCallsites_with_invalid_sort_fails)
+{
+    // arrange
+    size_t result;
+    GBALLOC_CALLSITE_STATS stats[1];
+    gballoc_init();
+    umock_c_reset_all_calls();
+
+    // act
+    result = gballoc_getTopCallsites((GBALLOC_CALLSITE_SORT)42, stats, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_03_011: [ gballoc_getTopCallsites shall fill callsite_stats with the (at most) count callsites ranking highest by sort, in decreasing order, and return how many were filled. ]*/
+/* Tests_SRS_GBALLOC_03_012: [ gballoc_getTopCallsites shall not take any lock. ]*/
+TEST_FUNCTION(gballoc_getTopCallsites_returns_the_callsites_with_the_most_live_bytes_first)
+{
+    // arrange
+    void* allocation1;
+    void* allocation2;
+    void* block1;
+    void* block2;
+    size_t result;
+    GBALLOC_CALLSITE_STATS stats[2];
+    gballoc_init();
+    allocation1 = malloc(OVERHEAD_SIZE);
+    allocation2 = malloc(OVERHEAD_SIZE);
+
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation1);
+    block1 = gballoc_malloc_at(100000, TEST_FILE_6, 1);
+    EXPECTED_CALL(mock_malloc(0))
+        .SetReturn(allocation2);
+    STRICT_EXPECTED_CALL(mock_malloc(200000))
+        .SetReturn(TEST_ALLOC_PTR2);
+    block2 = gballoc_malloc_at(200000, TEST_FILE_6, 2);
+    umock_c_reset_all_calls();
+
+    // act
+    result = gballoc_getTopCallsites(GBALLOC_CALLSITE_SORT_BY_LIVE_BYTES, stats, 2);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 2, result);
+    ASSERT_IS_TRUE(stats[0].file == TEST_FILE_6);
+    ASSERT_ARE_EQUAL(int, 2, stats[0].line);
+    ASSERT_ARE_EQUAL(size_t, 200000, stats[0].liveBytes);
+    ASSERT_IS_TRUE(stats[1].file == TEST_FILE_6);
+    ASSERT_ARE_EQUAL(int, 1, stats[1].line);
+    ASSERT_ARE_EQUAL(size_t, 100000, stats[1].liveBytes);
+
+    // cleanup
+    gballoc_free(block1);
+    gballoc_free(block2);
+    free(allocation1);
+    free(allocation2);
+}
+
+/* Tests_SRS_GBALLOC_03_011: [ gballoc_getTopCallsites shall fill callsite_stats with the (at most) count callsites ranking highest by sort, in decreasing order, and return how many were filled. ]*/
+TEST_FUNCTION(gballoc_getTopCallsites_with_0_count_returns_0)
+{
+    // arrange
+    size_t result;
+    gballoc_init();
+    umock_c_reset_all_calls();
+
+    // act
+    result = gballoc_getTopCallsites(GBALLOC_CALLSITE_SORT_BY_PEAK_BYTES, NULL, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* gballoc_dumpTopCallsites */
+
+/* Tests_SRS_GBALLOC_03_013: [ If count is 0, gballoc_dumpTopCallsites shall do nothing. ]*/
+TEST_FUNCTION(gballoc_dumpTopCallsites_with_0_count_does_nothing)
+{
+    // arrange
+    gballoc_init();
+    umock_c_reset_all_calls();
+
+    // act
+    gballoc_dumpTopCallsites(GBALLOC_CALLSITE_SORT_BY_LIVE_BYTES, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_03_014: [ If allocating memory for the dump fails, gballoc_dumpTopCallsites shall do nothing. ]*/
+TEST_FUNCTION(when_allocating_memory_fails_gballoc_dumpTopCallsites_does_nothing)
+{
+    // arrange
+    gballoc_init();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_malloc(10 * sizeof(GBALLOC_CALLSITE_STATS)))
+        .SetReturn(NULL);
+
+    // act
+    gballoc_dumpTopCallsites(GBALLOC_CALLSITE_SORT_BY_LIVE_BYTES, 10);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_03_015: [ gballoc_dumpTopCallsites shall log one line per callsite returned by gballoc_getTopCallsites for sort and count. ]*/
+TEST_FUNCTION(gballoc_dumpTopCallsites_frees_the_memory_it_allocated)
+{
+    // arrange
+    GBALLOC_CALLSITE_STATS stats[10];
+    gballoc_init();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_malloc(10 * sizeof(GBALLOC_CALLSITE_STATS)))
+        .SetReturn(stats);
+    STRICT_EXPECTED_CALL(mock_free(stats));
+
+    // act
+    gballoc_dumpTopCallsites(GBALLOC_CALLSITE_SORT_BY_ALLOCATION_COUNT, 10);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(GBAlloc_UnitTests)
@@ -1884,6 +1884,29 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__clone_certificate_succeed)
     free((void*)cloneCertificate);
 }
 
+/*Tests_SRS_HTTPAPI_COMPACT_21_088: [ The HTTPAPI_CloneOption shall clone the unix_socket_path option, which HTTPAPI_SetOption passes to the xio, as a string. ]*/
+TEST_FUNCTION(HTTPAPI_ExecuteRequest__clone_unix_socket_path_succeed)
+{
+    /// arrange
+    HTTPAPI_RESULT result;
+    char* clonePath;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+
+    /// act
+    result = HTTPAPI_CloneOption(OPTION_UNIX_SOCKET_PATH, "/run/test.sock", (const void**)&clonePath);
+
+    /// assert
+    ASSERT_ARE_EQUAL(int, HTTPAPI_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, "/run/test.sock", clonePath);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 1, currentmalloc_call);
+
+    /// cleanup
+    free(clonePath);
+}
+
 /*Tests_SRS_HTTPAPI_COMPACT_21_067: [ If the optionName is NULL, the HTTPAPI_CloneOption shall return HTTPAPI_INVALID_ARG. ]*/
 TEST_FUNCTION(HTTPAPI_ExecuteRequest__clone_certificate_NULL_optionName_failed)
 {
@@ -3181,12 +3204,15 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_retry_send_succeed)
     STRICT_EXPECTED_CALL(xio_send(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
         .IgnoreAllArguments();
     SkipDoworkJobsSendResult = 199;
-    for (i = 0; i < SkipDoworkJobsSendResult+1; i++)
+    for (i = 0; i < SkipDoworkJobsSendResult; i++)
     {
         STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
     }
+    /* the dowork that completes the send does not wait */
+    STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
     STRICT_EXPECTED_CALL(HTTPHeaders_GetHeader(requestHttpHeaders, IGNORED_NUM_ARG, IGNORED_PTR_ARG))
         .IgnoreArgument(2).IgnoreArgument(3);
     STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)).IgnoreArgument(1);
@@ -3194,12 +3220,10 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_retry_send_succeed)
         .IgnoreAllArguments();
     STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
         .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
     STRICT_EXPECTED_CALL(xio_send(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
         .IgnoreAllArguments();
     STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
         .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
     STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
         .IgnoreArgument(1);
     STRICT_EXPECTED_CALL(HTTPHeaders_GetHeader(requestHttpHeaders, IGNORED_NUM_ARG, IGNORED_PTR_ARG))
@@ -3209,25 +3233,21 @@ TEST_FUNCTION(HTTPAPI_ExecuteRequest__Execute_request_retry_send_succeed)
         .IgnoreAllArguments();
     STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
         .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
     STRICT_EXPECTED_CALL(xio_send(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
         .IgnoreAllArguments();
     STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
         .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
     STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
         .IgnoreArgument(1);
     STRICT_EXPECTED_CALL(xio_send(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
         .IgnoreAllArguments();
     STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
         .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
 
     STRICT_EXPECTED_CALL(xio_send(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
         .IgnoreAllArguments();
     STRICT_EXPECTED_CALL(xio_dowork(IGNORED_NUM_ARG))
         .IgnoreArgument(1);
-    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(100));
 
     setupAllCallBeforeReceiveHTTPsequenceWithSuccess();
 
@@ -73,7 +73,7 @@ void my_gballoc_free(void* ptr)
 
 #include "azure_c_shared_utility/map.h"
 
-MAP_HANDLE my_Map_Create(MAP_FILTER_CALLBACK mapFilterFunc)
+MAP_HANDLE my_Map_CreateWithInternedKeys(MAP_FILTER_CALLBACK mapFilterFunc)
 {
     (void)mapFilterFunc;
     return (MAP_HANDLE)malloc(1);
@@ -155,7 +155,7 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
             REGISTER_UMOCK_ALIAS_TYPE(MAP_FILTER_CALLBACK, void*);
             REGISTER_UMOCK_ALIAS_TYPE(MAP_HANDLE, void*);
 
-            REGISTER_GLOBAL_MOCK_HOOK(Map_Create, my_Map_Create);
+            REGISTER_GLOBAL_MOCK_HOOK(Map_CreateWithInternedKeys, my_Map_CreateWithInternedKeys);
             REGISTER_GLOBAL_MOCK_HOOK(Map_Clone, my_Map_Clone);
             REGISTER_GLOBAL_MOCK_HOOK(Map_Destroy, my_Map_Destroy);
             REGISTER_GLOBAL_MOCK_RETURN(Map_AddOrUpdate, MAP_OK);
@@ -205,7 +205,7 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
             STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
                 .IgnoreArgument(1);
 
-            STRICT_EXPECTED_CALL(Map_Create(IGNORED_PTR_ARG));
+            STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(IGNORED_PTR_ARG));
 
             ///act
             handle = HTTPHeaders_Alloc();
@@ -270,13 +270,13 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
 
 
         /*Tests_SRS_HTTP_HEADERS_99_003:[ The function shall return NULL when the function cannot execute properly]*/
-        TEST_FUNCTION(HTTPHeaders_Alloc_fails_when_Map_Create_fails)
+        TEST_FUNCTION(HTTPHeaders_Alloc_fails_when_Map_CreateWithInternedKeys_fails)
         {
             ///arrange
 			HTTP_HEADERS_HANDLE httpHandle;
             STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
                 .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(Map_Create(IGNORED_PTR_ARG))
+            STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(IGNORED_PTR_ARG))
                 .SetReturn(NULL);
 
             STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
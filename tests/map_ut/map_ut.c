@@ -3,8 +3,12 @@
 
 #ifdef __cplusplus
 #include <cstdlib>
+#include <cstdio>
+#include <cstring>
 #else
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 #endif
 
 #include "azure_c_shared_utility/optimize_size.h"
@@ -94,6 +98,57 @@ STRING_HANDLE my_STRING_new_JSON(const char* source)
 }
 
 #include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/string_intern.h"
+
+/*a minimal intern table, the canonical copies are the rows of test_interned*/
+#define TEST_INTERNED_MAX 4
+static char test_interned[TEST_INTERNED_MAX][32];
+static size_t test_interned_ref_count[TEST_INTERNED_MAX];
+
+const char* my_string_intern_find(const char* value)
+{
+    const char* result = NULL;
+    size_t i;
+    for (i = 0; i < TEST_INTERNED_MAX; i++)
+    {
+        if ((test_interned_ref_count[i] > 0) && (strcmp(test_interned[i], value) == 0))
+        {
+            result = test_interned[i];
+            break;
+        }
+    }
+    return result;
+}
+
+const char* my_string_intern_acquire(const char* value)
+{
+    size_t i;
+    for (i = 0; i < TEST_INTERNED_MAX; i++)
+    {
+        if ((test_interned_ref_count[i] > 0) && (strcmp(test_interned[i], value) == 0))
+        {
+            break;
+        }
+    }
+    if (i == TEST_INTERNED_MAX)
+    {
+        for (i = 0; i < TEST_INTERNED_MAX; i++)
+        {
+            if (test_interned_ref_count[i] == 0)
+            {
+                (void)strcpy(test_interned[i], value);
+                break;
+            }
+        }
+    }
+    test_interned_ref_count[i]++;
+    return test_interned[i];
+}
+
+void my_string_intern_release(const char* interned)
+{
+    test_interned_ref_count[(interned - test_interned[0]) / sizeof(test_interned[0])]--;
+}
 
 #undef ENABLE_MOCKS
 
@@ -135,6 +190,45 @@ static int DontAllowCapitalsFilters(const char* mapProperty, const char* mapValu
 
 /* capacity */
 
+/* enough keys for the map to build its hash index */
+#define TEST_MANY_KEYS_COUNT 100
+
+static void test_make_key(char* buffer, size_t i)
+{
+    (void)sprintf(buffer, "x-ms-key-%lu", (unsigned long)i);
+}
+
+static void test_make_value(char* buffer, size_t i)
+{
+    (void)sprintf(buffer, "value-%lu", (unsigned long)i);
+}
+
+static void test_add_keys(MAP_HANDLE handle, size_t first, size_t count)
+{
+    size_t i;
+    for (i = first; i < first + count; i++)
+    {
+        char key[32];
+        char value[32];
+        test_make_key(key, i);
+        test_make_value(value, i);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(handle, key, value));
+    }
+}
+
+static void test_assert_finds_keys(MAP_HANDLE handle, size_t first, size_t count)
+{
+    size_t i;
+    for (i = first; i < first + count; i++)
+    {
+        char key[32];
+        char value[32];
+        test_make_key(key, i);
+        test_make_value(value, i);
+        ASSERT_ARE_EQUAL(char_ptr, value, Map_GetValueFromKey(handle, key));
+    }
+}
+
 static const char* TEST_REDKEY = "testRedKey";
 static const char* TEST_REDVALUE = "testRedValue";
 
@@ -180,6 +274,10 @@ BEGIN_TEST_SUITE(map_unittests)
         REGISTER_GLOBAL_MOCK_HOOK(STRING_construct, my_STRING_construct);
         REGISTER_GLOBAL_MOCK_HOOK(STRING_delete, my_STRING_delete);
         REGISTER_GLOBAL_MOCK_HOOK(STRING_new_JSON, my_STRING_new_JSON);
+        REGISTER_GLOBAL_MOCK_HOOK(string_intern_acquire, my_string_intern_acquire);
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(string_intern_acquire, NULL);
+        REGISTER_GLOBAL_MOCK_HOOK(string_intern_find, my_string_intern_find);
+        REGISTER_GLOBAL_MOCK_HOOK(string_intern_release, my_string_intern_release);
     }
 
     TEST_SUITE_CLEANUP(TestClassCleanup)
@@ -549,10 +647,6 @@ BEGIN_TEST_SUITE(map_unittests)
         /*below are undo actions*/
         STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*undo copy of blue key*/
             .ValidateArgumentBuffer(1, TEST_BLUEKEY, strlen(TEST_BLUEKEY) + 1);
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing values*/
-            .IgnoreArgument(1);
 
 
         ///act
@@ -604,12 +698,7 @@ BEGIN_TEST_SUITE(map_unittests)
         whenShallmalloc_fail = currentmalloc_call + 3;
         STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of blue key*/
 
-        /*below are undo actions*/
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing values*/
-            .IgnoreArgument(1);
-
+        /*below are undo actions*/ /*none, the arrays keep their capacity for the next add*/
 
         ///act
         result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -658,9 +747,7 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing values*/
             .IgnoreArgument(1);
 
-        /*below are undo actions*/
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
+        /*below are undo actions*/ /*none, the keys array keeps its larger size*/
 
         ///act
         result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1109,10 +1196,6 @@ BEGIN_TEST_SUITE(map_unittests)
         /*below are undo actions*/
         STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*undo blue key value*/
             .ValidateArgumentBuffer(1, TEST_BLUEKEY, strlen(TEST_BLUEKEY) + 1);
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing values*/
-            .IgnoreArgument(1);
 
         ///act
         result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1157,11 +1240,7 @@ BEGIN_TEST_SUITE(map_unittests)
         whenShallmalloc_fail = currentmalloc_call + 3;
         STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of red key*/
 
-        /*below are undo actions*/
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing values*/
-            .IgnoreArgument(1);
+        /*below are undo actions*/ /*none, the arrays keep their capacity for the next add*/
 
         ///act
         result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1205,9 +1284,7 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing values*/
             .IgnoreArgument(1);
 
-        /*below are undo actions*/
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
+        /*below are undo actions*/ /*none, the keys array keeps its larger size*/
 
         ///act
         result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1692,11 +1769,7 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*freeing yellow value*/
             .ValidateArgumentBuffer(1, TEST_YELLOWVALUE, strlen(TEST_YELLOWVALUE) + 1);
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1* sizeof(const char*))) /*ungrowing values*/
-            .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*ungrowing keys*/
-            .IgnoreArgument(1);
 
         ///act
         result1 = Map_Delete(handle, TEST_YELLOWKEY);
@@ -1735,11 +1808,7 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*freeing yellow value*/
             .ValidateArgumentBuffer(1, TEST_REDVALUE, strlen(TEST_REDVALUE) + 1);
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*ungrowing values*/
-            .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*ungrowing keys*/
-            .IgnoreArgument(1);
 
         ///act
         result1 = Map_Delete(handle, TEST_REDKEY);
@@ -2152,13 +2221,17 @@ BEGIN_TEST_SUITE(map_unittests)
     }
 
     /*Tests_SRS_MAP_02_039: [Map_Clone shall make a copy of the map indicated by parameter handle and return a non-NULL handle to it.]*/
+    /*Tests_SRS_MAP_03_004: [Map_Clone shall share the keys and values of the map with the clone instead of copying them, the first clone of a map shall allocate their reference count.]*/
     TEST_FUNCTION(Map_Clone_with_map_with_1_element_succeeds)
     {
         ///arrange
-		MAP_HANDLE result;
+        MAP_HANDLE result;
         const char*const* keys;
         const char*const* values;
         size_t count;
+        const char*const* sourceKeys;
+        const char*const* sourceValues;
+        size_t sourceCount;
         MAP_HANDLE handle = Map_Create(NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         umock_c_reset_all_calls();
@@ -2166,13 +2239,8 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a clone of the storage for keys*/
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a clone of the storage for values*/
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a clone of RED value*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the reference count of the shared content*/
+            .IgnoreArgument(1);
 
         ///act
         result = Map_Clone(handle);
@@ -2180,11 +2248,12 @@ BEGIN_TEST_SUITE(map_unittests)
         ///assert
         ASSERT_IS_NOT_NULL(result);
         (void)Map_GetInternals(result, &keys, &values, &count);
-        ASSERT_IS_NOT_NULL(keys);
-        ASSERT_IS_NOT_NULL(values);
+        (void)Map_GetInternals(handle, &sourceKeys, &sourceValues, &sourceCount);
         ASSERT_ARE_EQUAL(size_t, 1, count);
         ASSERT_ARE_EQUAL(char_ptr, TEST_REDKEY, keys[0]);
         ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, values[0]);
+        ASSERT_ARE_EQUAL(void_ptr, (void*)sourceKeys, (void*)keys);
+        ASSERT_ARE_EQUAL(void_ptr, (void*)sourceValues, (void*)values);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
@@ -2196,32 +2265,15 @@ BEGIN_TEST_SUITE(map_unittests)
     TEST_FUNCTION(Map_Clone_with_map_with_1_element_fails_when_gbaloc_fails_1)
     {
         ///arrange
-		MAP_HANDLE result;
+        MAP_HANDLE result;
         MAP_HANDLE handle = Map_Create(NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         umock_c_reset_all_calls();
 
+        whenShallmalloc_fail = currentmalloc_call + 1;
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a clone of the storage for keys*/
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a clone of the storage for values*/
-
-        whenShallmalloc_fail = currentmalloc_call + 5;
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a clone of RED value*/
-
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
         ///act
         result = Map_Clone(handle);
 
@@ -2231,33 +2283,25 @@ BEGIN_TEST_SUITE(map_unittests)
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
     }
 
     /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
     TEST_FUNCTION(Map_Clone_with_map_with_1_element_fails_when_gbaloc_fails_2)
     {
         ///arrange
-		MAP_HANDLE result;
+        MAP_HANDLE result;
         MAP_HANDLE handle = Map_Create(NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         umock_c_reset_all_calls();
 
+        whenShallmalloc_fail = currentmalloc_call + 2;
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a clone of the storage for keys*/
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
-
-        whenShallmalloc_fail = currentmalloc_call + 4;
-        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a clone of the storage for values*/
-
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the reference count of the shared content*/
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*this is freeing the HANDLE structure*/
             .IgnoreArgument(1);
 
         ///act
@@ -2266,39 +2310,42 @@ BEGIN_TEST_SUITE(map_unittests)
         ///assert
         ASSERT_IS_NULL(result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(handle, TEST_REDKEY));
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_1_element_fails_when_gbaloc_fails_3)
+    /*Tests_SRS_MAP_02_039: [Map_Clone shall make a copy of the map indicated by parameter handle and return a non-NULL handle to it.]*/
+    TEST_FUNCTION(Map_Clone_with_map_with_2_element_succeeds)
     {
         ///arrange
-		MAP_HANDLE result;
+        MAP_HANDLE result;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
         MAP_HANDLE handle = Map_Create(NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
         umock_c_reset_all_calls();
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a clone of the storage for keys*/
-
-        whenShallmalloc_fail = currentmalloc_call + 3;
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
-
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the reference count of the shared content*/
             .IgnoreArgument(1);
 
         ///act
         result = Map_Clone(handle);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_IS_NOT_NULL(result);
+        (void)Map_GetInternals(result, &keys, &values, &count);
+        ASSERT_ARE_EQUAL(size_t, 2, count);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDKEY, keys[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, values[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEKEY, keys[1]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEVALUE, values[1]);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
@@ -2306,374 +2353,343 @@ BEGIN_TEST_SUITE(map_unittests)
         Map_Destroy(result);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_1_element_fails_when_gbaloc_fails_4)
+    /*Tests_SRS_MAP_03_004: [Map_Clone shall share the keys and values of the map with the clone instead of copying them, the first clone of a map shall allocate their reference count.]*/
+    TEST_FUNCTION(Map_Clone_of_a_shared_map_only_allocates_the_handle)
     {
         ///arrange
-		MAP_HANDLE result;
+        MAP_HANDLE result1;
+        MAP_HANDLE result2;
         MAP_HANDLE handle = Map_Create(NULL);
+        MAP_HANDLE clone;
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure of the clone of the source*/
             .IgnoreArgument(1);
-        whenShallmalloc_fail = currentmalloc_call + 2;
-        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a clone of the storage for keys*/
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure of the clone of the clone*/
             .IgnoreArgument(1);
 
         ///act
-        result = Map_Clone(handle);
+        result1 = Map_Clone(handle);
+        result2 = Map_Clone(clone);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_IS_NOT_NULL(result1);
+        ASSERT_IS_NOT_NULL(result2);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(result1, TEST_REDKEY));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(result2, TEST_REDKEY));
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
+        Map_Destroy(result1);
+        Map_Destroy(result2);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_1_element_fails_when_gbaloc_fails_5)
+    /*Tests_SRS_MAP_03_005: [If the content of the map is shared with clones, Map_Destroy shall release it only when the last map sharing it is destroyed.]*/
+    TEST_FUNCTION(Map_Destroy_of_a_shared_map_only_frees_the_handle)
     {
         ///arrange
-		MAP_HANDLE result;
         MAP_HANDLE handle = Map_Create(NULL);
+        MAP_HANDLE clone;
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        whenShallmalloc_fail = currentmalloc_call + 1;
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*free handle*/
             .IgnoreArgument(1);
 
         ///act
-        result = Map_Clone(handle);
+        Map_Destroy(handle);
 
         ///assert
-        ASSERT_IS_NULL(result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(clone, TEST_REDKEY));
 
         ///cleanup
-        Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
-    /*Tests_SRS_MAP_02_039: [Map_Clone shall make a copy of the map indicated by parameter handle and return a non-NULL handle to it.]*/
-    TEST_FUNCTION(Map_Clone_with_map_with_2_element_succeeds)
+    /*Tests_SRS_MAP_03_005: [If the content of the map is shared with clones, Map_Destroy shall release it only when the last map sharing it is destroyed.]*/
+    TEST_FUNCTION(Map_Destroy_of_the_last_shared_map_frees_the_content)
     {
         ///arrange
-		MAP_HANDLE result;
-        const char*const* keys;
-        const char*const* values;
-        size_t count;
         MAP_HANDLE handle = Map_Create(NULL);
+        MAP_HANDLE clone;
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
-        (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        clone = Map_Clone(handle);
+        Map_Destroy(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*free the red key*/
+            .ValidateArgumentBuffer(1, TEST_REDKEY, strlen(TEST_REDKEY) + 1);
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(2*sizeof(char*))); /*this is creating a clone of the storage for keys*/
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))/*free the red value*/
+            .ValidateArgumentBuffer(1, TEST_REDVALUE, strlen(TEST_REDVALUE) + 1);
+
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*free keys array*/
+            .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*this is creating a clone of BLUE key*/
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*free values array*/
+            .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(2*sizeof(char*))); /*this is creating a clone of the storage for values*/
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*free the reference count of the shared content*/
+            .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a clone of RED value*/
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEVALUE) + 1)); /*this is creating a clone of RED value*/
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*free handle*/
+            .IgnoreArgument(1);
 
         ///act
-        result = Map_Clone(handle);
+        Map_Destroy(clone);
 
         ///assert
-        ASSERT_IS_NOT_NULL(result);
-        (void)Map_GetInternals(result, &keys, &values, &count);
-        ASSERT_IS_NOT_NULL(keys);
-        ASSERT_IS_NOT_NULL(values);
-        ASSERT_ARE_EQUAL(size_t, 2, count);
-        ASSERT_ARE_EQUAL(char_ptr, TEST_REDKEY, keys[0]);
-        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, values[0]);
-        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEKEY, keys[1]);
-        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEVALUE, values[1]);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
-        Map_Destroy(handle);
-        Map_Destroy(result);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_2_element_fails_when_gballoc_fails_1)
+    /*Tests_SRS_MAP_03_006: [Before Map_Add, Map_AddOrUpdate or Map_Delete changes a map that shares its content with clones, it shall make a copy of the keys and values of the map.]*/
+    TEST_FUNCTION(Map_Add_to_a_clone_copies_the_content)
     {
         ///arrange
-		MAP_HANDLE result;
+        MAP_RESULT result;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
         MAP_HANDLE handle = Map_Create(NULL);
+        MAP_HANDLE clone;
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
-        (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(2 * sizeof(char*))); /*this is creating a clone of the storage for keys*/
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*this is creating a clone of BLUE key*/
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(2 * sizeof(char*))); /*this is creating a clone of the storage for values*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a copy of the storage for keys*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a copy of RED key*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a copy of the storage for values*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a copy of RED value*/
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a clone of RED value*/
-
-        whenShallmalloc_fail = currentmalloc_call + 7;
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEVALUE) + 1)); /*this is creating a clone of BLUE value*/
-
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing keys*/
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing values*/
             .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEKEY) + 1));
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEVALUE) + 1));
 
         ///act
-        result = Map_Clone(handle);
+        result = Map_Add(clone, TEST_BLUEKEY, TEST_BLUEVALUE);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        (void)Map_GetInternals(clone, &keys, &values, &count);
+        ASSERT_ARE_EQUAL(size_t, 2, count);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDKEY, keys[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEKEY, keys[1]);
+        (void)Map_GetInternals(handle, &keys, &values, &count);
+        ASSERT_ARE_EQUAL(size_t, 1, count);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDKEY, keys[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, values[0]);
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_2_element_fails_when_gballoc_fails_2)
+    /*Tests_SRS_MAP_03_006: [Before Map_Add, Map_AddOrUpdate or Map_Delete changes a map that shares its content with clones, it shall make a copy of the keys and values of the map.]*/
+    TEST_FUNCTION(Map_AddOrUpdate_of_an_existing_key_of_a_clone_copies_the_content)
     {
         ///arrange
-		MAP_HANDLE result;
+        MAP_RESULT result;
         MAP_HANDLE handle = Map_Create(NULL);
+        MAP_HANDLE clone;
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
-        (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(2 * sizeof(char*))); /*this is creating a clone of the storage for keys*/
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*this is creating a clone of BLUE key*/
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(2 * sizeof(char*))); /*this is creating a clone of the storage for values*/
-
-        whenShallmalloc_fail = currentmalloc_call + 6;
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a clone of RED value*/
-
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a copy of the storage for keys*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a copy of RED key*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a copy of the storage for values*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a copy of RED value*/
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, strlen(TEST_BLUEVALUE) + 1))
             .IgnoreArgument(1);
 
         ///act
-        result = Map_Clone(handle);
+        result = Map_AddOrUpdate(clone, TEST_REDKEY, TEST_BLUEVALUE);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEVALUE, Map_GetValueFromKey(clone, TEST_REDKEY));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(handle, TEST_REDKEY));
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_2_element_fails_when_gballoc_fails_3)
+    /*Tests_SRS_MAP_03_006: [Before Map_Add, Map_AddOrUpdate or Map_Delete changes a map that shares its content with clones, it shall make a copy of the keys and values of the map.]*/
+    TEST_FUNCTION(Map_Delete_from_a_source_copies_the_content)
     {
         ///arrange
-		MAP_HANDLE result;
+        MAP_RESULT result;
         MAP_HANDLE handle = Map_Create(NULL);
+        MAP_HANDLE clone;
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(2 * sizeof(char*))); /*this is creating a clone of the storage for keys*/
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*this is creating a clone of BLUE key*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(2 * sizeof(char*))); /*this is creating a copy of the storage for keys*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a copy of RED key*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*this is creating a copy of BLUE key*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(2 * sizeof(char*))); /*this is creating a copy of the storage for values*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a copy of RED value*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEVALUE) + 1)); /*this is creating a copy of BLUE value*/
 
-        whenShallmalloc_fail = currentmalloc_call + 5;
-        STRICT_EXPECTED_CALL(gballoc_malloc(2 * sizeof(char*))); /*this is creating a clone of the storage for values*/
-
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*free the copy of the red key*/
+            .ValidateArgumentBuffer(1, TEST_REDKEY, strlen(TEST_REDKEY) + 1);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*free the copy of the red value*/
+            .ValidateArgumentBuffer(1, TEST_REDVALUE, strlen(TEST_REDVALUE) + 1);
 
         ///act
-        result = Map_Clone(handle);
+        result = Map_Delete(handle, TEST_REDKEY);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_NULL(Map_GetValueFromKey(handle, TEST_REDKEY));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEVALUE, Map_GetValueFromKey(handle, TEST_BLUEKEY));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(clone, TEST_REDKEY));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEVALUE, Map_GetValueFromKey(clone, TEST_BLUEKEY));
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_2_element_fails_when_gballoc_fails_4)
+    /*Tests_SRS_MAP_03_007: [If the map is the last one using a shared content, the write shall take ownership of the content without copying it.]*/
+    TEST_FUNCTION(Map_Add_to_the_last_shared_map_does_not_copy_the_content)
     {
         ///arrange
-		MAP_HANDLE result;
+        MAP_RESULT result;
         MAP_HANDLE handle = Map_Create(NULL);
+        MAP_HANDLE clone;
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
-        (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        clone = Map_Clone(handle);
+        Map_Destroy(clone);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(2 * sizeof(char*))); /*this is creating a clone of the storage for keys*/
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
-
-        whenShallmalloc_fail = currentmalloc_call + 4;
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*this is creating a clone of BLUE key*/
-
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*free the reference count of the shared content*/
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing keys*/
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing values*/
             .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEKEY) + 1));
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEVALUE) + 1));
 
         ///act
-        result = Map_Clone(handle);
+        result = Map_Add(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(handle, TEST_REDKEY));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEVALUE, Map_GetValueFromKey(handle, TEST_BLUEKEY));
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_2_element_fails_when_gballoc_fails_5)
+    /*Tests_SRS_MAP_03_006: [Before Map_Add, Map_AddOrUpdate or Map_Delete changes a map that shares its content with clones, it shall make a copy of the keys and values of the map.]*/
+    TEST_FUNCTION(Map_Add_of_an_existing_key_to_a_clone_does_not_copy_the_content)
     {
         ///arrange
-		MAP_HANDLE result;
+        MAP_RESULT result;
         MAP_HANDLE handle = Map_Create(NULL);
+        MAP_HANDLE clone;
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
-        (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(2 * sizeof(char*))); /*this is creating a clone of the storage for keys*/
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDKEY) + 1))
-            .SetReturn(NULL); /*this is creating a clone of RED key*/
-
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
         ///act
-        result = Map_Clone(handle);
+        result = Map_Add(clone, TEST_REDKEY, TEST_BLUEVALUE);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_KEYEXISTS, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_2_element_fails_when_gballoc_fails_6)
+    /*Tests_SRS_MAP_03_008: [If copying the content fails, the write shall fail and leave the map unchanged.]*/
+    TEST_FUNCTION(Map_Add_to_a_clone_fails_when_copying_the_content_fails)
     {
         ///arrange
-		MAP_HANDLE result;
+        MAP_RESULT result;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
         MAP_HANDLE handle = Map_Create(NULL);
+        MAP_HANDLE clone;
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
-        (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
-            .IgnoreArgument(1);
-
-        whenShallmalloc_fail = currentmalloc_call + 2;
-        STRICT_EXPECTED_CALL(gballoc_malloc(2 * sizeof(char*))); /*this is creating a clone of the storage for keys*/
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+        whenShallmalloc_fail = currentmalloc_call + 3;
+        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a copy of the storage for keys*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a copy of RED key*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a copy of the storage for values, fails*/
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*free the copy of the red key*/
+            .ValidateArgumentBuffer(1, TEST_REDKEY, strlen(TEST_REDKEY) + 1);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*free the copy of the storage for keys*/
             .IgnoreArgument(1);
 
         ///act
-        result = Map_Clone(handle);
+        result = Map_Add(clone, TEST_BLUEKEY, TEST_BLUEVALUE);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        (void)Map_GetInternals(clone, &keys, &values, &count);
+        ASSERT_ARE_EQUAL(size_t, 1, count);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDKEY, keys[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, values[0]);
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_2_element_fails_when_gballoc_fails_7)
+    /*Tests_SRS_MAP_03_008: [If copying the content fails, the write shall fail and leave the map unchanged.]*/
+    TEST_FUNCTION(Map_Delete_from_a_clone_fails_when_copying_the_content_fails)
     {
         ///arrange
-		MAP_HANDLE result;
+        MAP_RESULT result;
         MAP_HANDLE handle = Map_Create(NULL);
+        MAP_HANDLE clone;
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
-        (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
+        clone = Map_Clone(handle);
         umock_c_reset_all_calls();
 
         whenShallmalloc_fail = currentmalloc_call + 1;
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a copy of the storage for keys, fails*/
 
         ///act
-        result = Map_Clone(handle);
+        result = Map_Delete(clone, TEST_REDKEY);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(clone, TEST_REDKEY));
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        Map_Destroy(clone);
     }
 
     /* Tests_SRS_MAP_07_009: [If the mapFilterCallback function is not NULL, then the return value will be check and if it is not zero then Map_Add shall return MAP_FILTER_REJECT.] */
@@ -3853,5 +3869,502 @@ BEGIN_TEST_SUITE(map_unittests)
         Map_Destroy(handle);
     }
 
-    
+    /*Tests_SRS_MAP_03_001: [ A map of at least 16 keys shall find its keys with a hash index instead of comparing all the keys. ]*/
+    TEST_FUNCTION(Map_with_many_keys_finds_every_key)
+    {
+        ///arrange
+        bool keyExists;
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_Create(NULL);
+        test_add_keys(handle, 0, TEST_MANY_KEYS_COUNT);
+
+        ///act
+        result = Map_ContainsKey(handle, "x-ms-key-not-there", &keyExists);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_IS_FALSE(keyExists);
+        ASSERT_IS_NULL(Map_GetValueFromKey(handle, "x-ms-key-not-there"));
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_KEYEXISTS, Map_Add(handle, "x-ms-key-42", "other"));
+        ASSERT_ARE_EQUAL(char_ptr, "value-42", Map_GetValueFromKey(handle, "x-ms-key-42"));
+        test_assert_finds_keys(handle, 0, TEST_MANY_KEYS_COUNT);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_03_001: [ A map of at least 16 keys shall find its keys with a hash index instead of comparing all the keys. ]*/
+    TEST_FUNCTION(Map_AddOrUpdate_with_many_keys_updates_the_value)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_Create(NULL);
+        test_add_keys(handle, 0, TEST_MANY_KEYS_COUNT);
+
+        ///act
+        result = Map_AddOrUpdate(handle, "x-ms-key-42", "other");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, "other", Map_GetValueFromKey(handle, "x-ms-key-42"));
+        test_assert_finds_keys(handle, 0, 42);
+        test_assert_finds_keys(handle, 43, TEST_MANY_KEYS_COUNT - 43);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_03_002: [ The keys and values of the map shall stay in insertion order, whether the map has an index or not. ]*/
+    TEST_FUNCTION(Map_Delete_with_many_keys_keeps_the_insertion_order)
+    {
+        ///arrange
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        size_t i;
+        MAP_HANDLE handle = Map_Create(NULL);
+        test_add_keys(handle, 0, TEST_MANY_KEYS_COUNT);
+
+        ///act
+        for (i = 0; i < TEST_MANY_KEYS_COUNT; i += 2)
+        {
+            char key[32];
+            test_make_key(key, i);
+            ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Delete(handle, key));
+        }
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(handle, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, TEST_MANY_KEYS_COUNT / 2, count);
+        for (i = 0; i < count; i++)
+        {
+            char key[32];
+            char value[32];
+            test_make_key(key, 2 * i + 1);
+            test_make_value(value, 2 * i + 1);
+            ASSERT_ARE_EQUAL(char_ptr, key, keys[i]);
+            ASSERT_ARE_EQUAL(char_ptr, value, values[i]);
+            ASSERT_ARE_EQUAL(char_ptr, value, Map_GetValueFromKey(handle, key));
+        }
+        ASSERT_IS_NULL(Map_GetValueFromKey(handle, "x-ms-key-0"));
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_KEYNOTFOUND, Map_Delete(handle, "x-ms-key-0"));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_03_001: [ A map of at least 16 keys shall find its keys with a hash index instead of comparing all the keys. ]*/
+    TEST_FUNCTION(Map_Add_of_the_16th_key_builds_the_index)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_Create(NULL);
+        test_add_keys(handle, 0, 15);
+        umock_c_reset_all_calls();
+
+        /*the keys and values arrays already have room for 16 keys*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen("x-ms-key-15") + 1));
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen("value-15") + 1));
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*the index*/
+            .IgnoreArgument(1);
+
+        ///act
+        result = Map_Add(handle, "x-ms-key-15", "value-15");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        test_assert_finds_keys(handle, 0, 16);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_03_015: [ If the capacity of the map is not enough for one more key, the keys and values arrays shall be reallocated to the larger of count + 1 and twice the capacity. ]*/
+    TEST_FUNCTION(Map_Add_when_the_map_is_full_doubles_its_capacity)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_Create(NULL);
+        test_add_keys(handle, 0, 4);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 8 * sizeof(char*))) /*growing keys*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 8 * sizeof(char*))) /*growing values*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen("x-ms-key-4") + 1));
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen("value-4") + 1));
+
+        ///act
+        result = Map_Add(handle, "x-ms-key-4", "value-4");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        test_assert_finds_keys(handle, 0, 5);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_03_016: [ If the capacity of the map is enough for one more key, adding a key shall not allocate memory for the keys and values arrays. ]*/
+    TEST_FUNCTION(Map_Add_when_the_map_has_capacity_left_does_not_grow_the_arrays)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_Create(NULL);
+        test_add_keys(handle, 0, 5);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen("x-ms-key-5") + 1));
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen("value-5") + 1));
+
+        ///act
+        result = Map_Add(handle, "x-ms-key-5", "value-5");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        test_assert_finds_keys(handle, 0, 6);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_03_016: [ If the capacity of the map is enough for one more key, adding a key shall not allocate memory for the keys and values arrays. ]*/
+    TEST_FUNCTION(Map_Add_after_Map_Delete_reuses_the_capacity)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_Create(NULL);
+        test_add_keys(handle, 0, 4);
+        (void)Map_Delete(handle, "x-ms-key-1");
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen("x-ms-key-1") + 1));
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen("value-1") + 1));
+
+        ///act
+        result = Map_Add(handle, "x-ms-key-1", "value-1");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        test_assert_finds_keys(handle, 0, 4);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_03_003: [ If the memory of the index cannot be allocated, the map shall keep working and find its keys by comparing all the keys. ]*/
+    TEST_FUNCTION(Map_Add_succeeds_when_allocating_the_index_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_Create(NULL);
+        test_add_keys(handle, 0, 15);
+        whenShallmalloc_fail = currentmalloc_call + 3; /*the key, the value, then the index*/
+
+        ///act
+        result = Map_Add(handle, "x-ms-key-15", "value-15");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(size_t, whenShallmalloc_fail, currentmalloc_call);
+        test_assert_finds_keys(handle, 0, 16);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_KEYEXISTS, Map_Add(handle, "x-ms-key-3", "other"));
+
+        /*the next Map_Add builds the index*/
+        test_add_keys(handle, 16, TEST_MANY_KEYS_COUNT - 16);
+        test_assert_finds_keys(handle, 0, TEST_MANY_KEYS_COUNT);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_02_039: [Map_Clone shall make a copy of the map indicated by parameter handle and return a non-NULL handle to it.]*/
+    /*Tests_SRS_MAP_03_002: [ The keys and values of the map shall stay in insertion order, whether the map has an index or not. ]*/
+    TEST_FUNCTION(Map_Clone_with_many_keys_succeeds)
+    {
+        ///arrange
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        MAP_HANDLE clone;
+        MAP_HANDLE handle = Map_Create(NULL);
+        test_add_keys(handle, 0, TEST_MANY_KEYS_COUNT);
+
+        ///act
+        clone = Map_Clone(handle);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(clone);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_GetInternals(clone, &keys, &values, &count));
+        ASSERT_ARE_EQUAL(size_t, TEST_MANY_KEYS_COUNT, count);
+        ASSERT_ARE_EQUAL(char_ptr, "x-ms-key-0", keys[0]);
+        ASSERT_ARE_EQUAL(char_ptr, "value-99", values[TEST_MANY_KEYS_COUNT - 1]);
+        test_assert_finds_keys(clone, 0, TEST_MANY_KEYS_COUNT);
+
+        ///cleanup
+        Map_Destroy(clone);
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_03_009: [ Map_CreateWithInternedKeys shall create a new, empty map whose keys are acquired from the string intern table instead of being copied. ]*/
+    /*Tests_SRS_MAP_03_011: [ A map with interned keys shall store the canonical copy of each key acquired from the string intern table. ]*/
+    TEST_FUNCTION(Map_Add_to_a_map_with_interned_keys_acquires_the_key)
+    {
+        ///arrange
+        MAP_RESULT result;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        MAP_HANDLE handle = Map_CreateWithInternedKeys(NULL);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, sizeof(const char*))) /*growing keys*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, sizeof(const char*))) /*growing values*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(string_intern_acquire(TEST_REDKEY));
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDVALUE) + 1));
+
+        ///act
+        result = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        (void)Map_GetInternals(handle, &keys, &values, &count);
+        ASSERT_ARE_EQUAL(size_t, 1, count);
+        ASSERT_ARE_EQUAL(void_ptr, my_string_intern_find(TEST_REDKEY), keys[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, values[0]);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_03_011: [ A map with interned keys shall store the canonical copy of each key acquired from the string intern table. ]*/
+    TEST_FUNCTION(Map_Add_to_a_map_with_interned_keys_fails_when_acquiring_the_key_fails)
+    {
+        ///arrange
+        MAP_RESULT result;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        MAP_HANDLE handle = Map_CreateWithInternedKeys(NULL);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, sizeof(const char*))) /*growing keys*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, sizeof(const char*))) /*growing values*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(string_intern_acquire(TEST_REDKEY))
+            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*keys*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*values*/
+            .IgnoreArgument(1);
+
+        ///act
+        result = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        (void)Map_GetInternals(handle, &keys, &values, &count);
+        ASSERT_ARE_EQUAL(size_t, 0, count);
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_03_011: [ A map with interned keys shall store the canonical copy of each key acquired from the string intern table. ]*/
+    TEST_FUNCTION(maps_with_interned_keys_share_their_keys)
+    {
+        ///arrange
+        const char*const* keys1;
+        const char*const* keys2;
+        const char*const* values;
+        size_t count;
+        MAP_HANDLE handle1 = Map_CreateWithInternedKeys(NULL);
+        MAP_HANDLE handle2 = Map_CreateWithInternedKeys(NULL);
+
+        ///act
+        (void)Map_Add(handle1, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_Add(handle2, TEST_REDKEY, TEST_BLUEVALUE);
+
+        ///assert
+        (void)Map_GetInternals(handle1, &keys1, &values, &count);
+        (void)Map_GetInternals(handle2, &keys2, &values, &count);
+        ASSERT_ARE_EQUAL(void_ptr, keys1[0], keys2[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEVALUE, Map_GetValueFromKey(handle2, TEST_REDKEY));
+
+        ///cleanup
+        Map_Destroy(handle1);
+        Map_Destroy(handle2);
+    }
+
+    /*Tests_SRS_MAP_03_012: [ A map shall compare a key with its keys by pointer first, and compare the characters only if the pointers differ. ]*/
+    TEST_FUNCTION(Map_GetValueFromKey_of_a_map_with_interned_keys_does_not_use_the_intern_table)
+    {
+        ///arrange
+        const char* result;
+        MAP_HANDLE handle = Map_CreateWithInternedKeys(NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_Add(handle, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_GetValueFromKey(handle, TEST_YELLOWKEY);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, TEST_YELLOWVALUE, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_03_012: [ A map shall compare a key with its keys by pointer first, and compare the characters only if the pointers differ. ]*/
+    TEST_FUNCTION(Map_GetValueFromKey_of_a_map_with_interned_keys_finds_a_key_given_by_its_canonical_copy)
+    {
+        ///arrange
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        const char* result;
+        MAP_HANDLE handle = Map_CreateWithInternedKeys(NULL);
+        MAP_HANDLE other = Map_CreateWithInternedKeys(NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_Add(other, TEST_REDKEY, TEST_BLUEVALUE);
+        (void)Map_GetInternals(other, &keys, &values, &count);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_GetValueFromKey(handle, keys[0]);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(other);
+    }
+
+    /*Tests_SRS_MAP_03_012: [ A map shall compare a key with its keys by pointer first, and compare the characters only if the pointers differ. ]*/
+    TEST_FUNCTION(Map_GetValueFromKey_of_a_map_with_interned_keys_returns_NULL_for_a_key_that_is_not_interned)
+    {
+        ///arrange
+        const char* result;
+        MAP_HANDLE handle = Map_CreateWithInternedKeys(NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_GetValueFromKey(handle, TEST_BLUEKEY);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_03_012: [ A map shall compare a key with its keys by pointer first, and compare the characters only if the pointers differ. ]*/
+    TEST_FUNCTION(Map_GetValueFromKey_of_a_map_with_interned_keys_returns_NULL_for_a_key_interned_by_another_map)
+    {
+        ///arrange
+        const char* result;
+        MAP_HANDLE handle = Map_CreateWithInternedKeys(NULL);
+        MAP_HANDLE other = Map_CreateWithInternedKeys(NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_Add(other, TEST_BLUEKEY, TEST_BLUEVALUE);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = Map_GetValueFromKey(handle, TEST_BLUEKEY);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(other);
+    }
+
+    /*Tests_SRS_MAP_03_011: [ A map with interned keys shall store the canonical copy of each key acquired from the string intern table. ]*/
+    TEST_FUNCTION(Map_Delete_of_a_map_with_interned_keys_releases_the_key)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithInternedKeys(NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(string_intern_release(IGNORED_PTR_ARG)) /*the red key*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*the red value*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*keys*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)) /*values*/
+            .IgnoreArgument(1);
+
+        ///act
+        result = Map_Delete(handle, TEST_REDKEY);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_NULL(my_string_intern_find(TEST_REDKEY));
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    /*Tests_SRS_MAP_03_013: [ A map with interned keys that copies its shared content shall acquire a new reference to each of its keys instead of copying them. ]*/
+    /*Tests_SRS_MAP_03_014: [ The clone of a map with interned keys shall have interned keys. ]*/
+    TEST_FUNCTION(Map_Add_to_a_clone_of_a_map_with_interned_keys_acquires_the_keys)
+    {
+        ///arrange
+        MAP_RESULT result;
+        MAP_HANDLE handle = Map_CreateWithInternedKeys(NULL);
+        MAP_HANDLE clone;
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        clone = Map_Clone(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a copy of the storage for keys*/
+        STRICT_EXPECTED_CALL(string_intern_acquire(IGNORED_PTR_ARG)) /*the RED key is not copied*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(char*))); /*this is creating a copy of the storage for values*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a copy of RED value*/
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing keys*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing values*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(string_intern_acquire(TEST_BLUEKEY));
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_BLUEVALUE) + 1));
+
+        ///act
+        result = Map_Add(clone, TEST_BLUEKEY, TEST_BLUEVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, TEST_BLUEVALUE, Map_GetValueFromKey(clone, TEST_BLUEKEY));
+        ASSERT_IS_NULL(Map_GetValueFromKey(handle, TEST_BLUEKEY));
+
+        ///cleanup
+        Map_Destroy(clone);
+        Map_Destroy(handle);
+        ASSERT_IS_NULL(my_string_intern_find(TEST_REDKEY));
+        ASSERT_IS_NULL(my_string_intern_find(TEST_BLUEKEY));
+    }
+
 END_TEST_SUITE(map_unittests)
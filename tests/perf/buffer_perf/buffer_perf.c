@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/buffer_.h"
+#include "perf_timer.h"
+
+/* measures building a payload by appending chunks of a fixed size.
+   "exact" is the previous scheme: every append reallocs the buffer to exactly the new size.
+   "BUFFER" is BUFFER_append_build, which grows the capacity geometrically. */
+
+#define PAYLOAD_SIZE (1024 * 1024)
+
+static const size_t chunk_sizes[] = { 1, 16, 256, 4096 };
+
+static unsigned char chunk[4096];
+
+static void print_result(const char* scheme, size_t chunk_size, uint64_t elapsed_ns, size_t allocation_count)
+{
+    size_t append_count = PAYLOAD_SIZE / chunk_size;
+    (void)printf("%-6s chunk: %4lu bytes, %7lu appends: %8.2f ms, %8.1f ns/append, %7lu reallocs\r\n",
+        scheme, (unsigned long)chunk_size, (unsigned long)append_count, (double)elapsed_ns / 1000000.0,
+        (double)elapsed_ns / (double)append_count, (unsigned long)allocation_count);
+}
+
+static int measure_exact(size_t chunk_size)
+{
+    int result = 0;
+    unsigned char* payload = NULL;
+    size_t payload_size = 0;
+    uint64_t start_ns;
+    uint64_t end_ns;
+
+    gballoc_resetMetrics();
+
+    start_ns = perf_timer_get_ns();
+    while (payload_size < PAYLOAD_SIZE)
+    {
+        unsigned char* temp = (unsigned char*)gballoc_realloc(payload, payload_size + chunk_size);
+        if (temp == NULL)
+        {
+            (void)printf("gballoc_realloc failed\r\n");
+            result = __LINE__;
+            break;
+        }
+
+        payload = temp;
+        (void)memcpy(payload + payload_size, chunk, chunk_size);
+        payload_size += chunk_size;
+    }
+    end_ns = perf_timer_get_ns();
+
+    if (result == 0)
+    {
+        print_result("exact", chunk_size, end_ns - start_ns, gballoc_getAllocationCount());
+    }
+
+    gballoc_free(payload);
+
+    return result;
+}
+
+static int measure_buffer(size_t chunk_size)
+{
+    int result = 0;
+    BUFFER_HANDLE payload;
+
+    if ((payload = BUFFER_new()) == NULL)
+    {
+        (void)printf("BUFFER_new failed\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        uint64_t start_ns;
+        uint64_t end_ns;
+
+        gballoc_resetMetrics();
+
+        start_ns = perf_timer_get_ns();
+        while (BUFFER_length(payload) < PAYLOAD_SIZE)
+        {
+            if (BUFFER_append_build(payload, chunk, chunk_size) != 0)
+            {
+                (void)printf("BUFFER_append_build failed\r\n");
+                result = __LINE__;
+                break;
+            }
+        }
+        end_ns = perf_timer_get_ns();
+
+        if (result == 0)
+        {
+            print_result("BUFFER", chunk_size, end_ns - start_ns, gballoc_getAllocationCount());
+        }
+
+        BUFFER_delete(payload);
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    int result;
+
+    if (gballoc_init() != 0)
+    {
+        (void)printf("Cannot initialize gballoc\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        size_t i;
+
+        (void)memset(chunk, 'x', sizeof(chunk));
+
+        result = 0;
+        for (i = 0; (result == 0) && (i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0])); i++)
+        {
+            if ((result = measure_exact(chunk_sizes[i])) == 0)
+            {
+                result = measure_buffer(chunk_sizes[i]);
+            }
+        }
+
+        gballoc_deinit();
+    }
+
+    return result;
+}
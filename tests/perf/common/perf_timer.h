@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef PERF_TIMER_H
+#define PERF_TIMER_H
+
+#ifdef __cplusplus
+#include <cstdint>
+extern "C" {
+#else
+#include <stdint.h>
+#endif
+
+/* tickcounter only has millisecond (or second) resolution, the perf tests need a finer monotonic clock */
+uint64_t perf_timer_get_ns(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PERF_TIMER_H */
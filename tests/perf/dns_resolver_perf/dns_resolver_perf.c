@@ -0,0 +1,310 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/dns_resolver.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "perf_timer.h"
+
+/* measures resolving the host name of a connection, first the lookup alone: getaddrinfo against a lookup of the resolver whose host name
+   is cached, then a reconnect storm: CONNECTION_COUNT connections to the same host name opened at once from one thread, with the socket IOs
+   calling getaddrinfo in socketio_open and with the resolver. The host name is localhost, which is resolved from the hosts file, so these
+   are the costs of the lookups themselves, a lookup that goes to a DNS server holds socketio_open for its round trips without the resolver. */
+
+#define HOSTNAME "localhost"
+#define LOOKUP_COUNT 10000
+#define CONNECTION_COUNT 200
+#define RUN_TIMEOUT_MS 10000
+
+typedef struct CONNECTION_TAG
+{
+    CONCRETE_IO_HANDLE socket_io;
+    IO_OPEN_RESULT open_result;
+    int is_open_completed;
+    int peer;
+} CONNECTION;
+
+static size_t io_error_count;
+
+static void on_io_open_complete(void* context, IO_OPEN_RESULT_DETAILED open_result)
+{
+    CONNECTION* connection = (CONNECTION*)context;
+    connection->open_result = open_result.result;
+    connection->is_open_completed = 1;
+}
+
+static void on_bytes_received(void* context, const unsigned char* buffer, size_t size)
+{
+    (void)context;
+    (void)buffer;
+    (void)size;
+}
+
+static void on_io_error(void* context)
+{
+    (void)context;
+    io_error_count++;
+}
+
+static int create_listen_socket(int* port)
+{
+    int result = socket(AF_INET, SOCK_STREAM, 0);
+    if (result != -1)
+    {
+        struct sockaddr_in address;
+        socklen_t address_length = sizeof(address);
+        (void)memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+
+        if ((bind(result, (struct sockaddr*)&address, sizeof(address)) != 0) ||
+            (listen(result, SOMAXCONN) != 0) ||
+            (getsockname(result, (struct sockaddr*)&address, &address_length) != 0) ||
+            (fcntl(result, F_SETFL, O_NONBLOCK) != 0))
+        {
+            (void)close(result);
+            result = -1;
+        }
+        else
+        {
+            *port = ntohs(address.sin_port);
+        }
+    }
+    return result;
+}
+
+static int measure_getaddrinfo(void)
+{
+    int result = 0;
+    struct addrinfo hints;
+    uint64_t start_ns;
+    size_t i;
+
+    (void)memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    start_ns = perf_timer_get_ns();
+    for (i = 0; i < LOOKUP_COUNT; i++)
+    {
+        struct addrinfo* addresses;
+        if (getaddrinfo(HOSTNAME, "443", &hints, &addresses) != 0)
+        {
+            (void)printf("getaddrinfo failed\r\n");
+            result = __LINE__;
+            break;
+        }
+        freeaddrinfo(addresses);
+    }
+
+    if (result == 0)
+    {
+        (void)printf("getaddrinfo          %8.0f ns/lookup\r\n", (double)(perf_timer_get_ns() - start_ns) / LOOKUP_COUNT);
+    }
+
+    return result;
+}
+
+static int measure_cached_lookup(void)
+{
+    int result = 0;
+    DNS_RESOLVER_LOOKUP_HANDLE lookup;
+    uint64_t start_ns;
+    size_t i;
+
+    /* the first lookup resolves the host name, the ones measured find it in the cache */
+    if ((lookup = dns_resolver_lookup(HOSTNAME)) == NULL)
+    {
+        (void)printf("dns_resolver_lookup failed\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        while (dns_resolver_get_result(lookup, NULL, NULL) == DNS_RESOLVER_PENDING)
+        {
+            ThreadAPI_Sleep(1);
+        }
+        dns_resolver_release(lookup);
+
+        start_ns = perf_timer_get_ns();
+        for (i = 0; i < LOOKUP_COUNT; i++)
+        {
+            const struct addrinfo* addresses;
+            if (((lookup = dns_resolver_lookup(HOSTNAME)) == NULL) ||
+                (dns_resolver_get_result(lookup, &addresses, NULL) != DNS_RESOLVER_OK))
+            {
+                (void)printf("cached lookup failed\r\n");
+                dns_resolver_release(lookup);
+                result = __LINE__;
+                break;
+            }
+            dns_resolver_release(lookup);
+        }
+
+        if (result == 0)
+        {
+            (void)printf("dns_resolver cached  %8.0f ns/lookup\r\n", (double)(perf_timer_get_ns() - start_ns) / LOOKUP_COUNT);
+        }
+    }
+
+    return result;
+}
+
+static size_t count_completed(const CONNECTION* connections)
+{
+    size_t result = 0;
+    size_t i;
+    for (i = 0; i < CONNECTION_COUNT; i++)
+    {
+        result += (size_t)connections[i].is_open_completed;
+    }
+    return result;
+}
+
+static int measure_reconnect_storm(CONNECTION* connections, int listen_socket, int port, const char* label)
+{
+    int result = 0;
+    SOCKETIO_CONFIG config;
+    uint64_t start_ns;
+    uint64_t opens_ns;
+    uint64_t deadline_ns;
+    size_t opened_count;
+    size_t accepted_count = 0;
+    size_t ok_count = 0;
+    size_t i;
+
+    config.hostname = HOSTNAME;
+    config.port = port;
+    config.accepted_socket = NULL;
+
+    start_ns = perf_timer_get_ns();
+    for (opened_count = 0; opened_count < CONNECTION_COUNT; opened_count++)
+    {
+        CONNECTION* connection = &connections[opened_count];
+        connection->is_open_completed = 0;
+        if ((connection->socket_io = socketio_create(&config)) == NULL)
+        {
+            (void)printf("socketio_create failed\r\n");
+            result = __LINE__;
+            break;
+        }
+        else if (socketio_open(connection->socket_io, on_io_open_complete, connection, on_bytes_received, connection, on_io_error, connection) != 0)
+        {
+            (void)printf("socketio_open failed\r\n");
+            socketio_destroy(connection->socket_io);
+            result = __LINE__;
+            break;
+        }
+    }
+    opens_ns = perf_timer_get_ns() - start_ns;
+
+    deadline_ns = start_ns + (uint64_t)RUN_TIMEOUT_MS * 1000000;
+    while ((result == 0) && (count_completed(connections) < CONNECTION_COUNT) && (perf_timer_get_ns() < deadline_ns))
+    {
+        int accepted;
+        while ((accepted_count < CONNECTION_COUNT) && ((accepted = accept(listen_socket, NULL, NULL)) != -1))
+        {
+            connections[accepted_count].peer = accepted;
+            accepted_count++;
+        }
+
+        for (i = 0; i < CONNECTION_COUNT; i++)
+        {
+            socketio_dowork(connections[i].socket_io);
+        }
+    }
+
+    if (result == 0)
+    {
+        for (i = 0; i < CONNECTION_COUNT; i++)
+        {
+            ok_count += (connections[i].is_open_completed && (connections[i].open_result == IO_OPEN_OK)) ? 1 : 0;
+        }
+
+        if (ok_count != CONNECTION_COUNT)
+        {
+            (void)printf("%lu of %d connections opened\r\n", (unsigned long)ok_count, CONNECTION_COUNT);
+            result = __LINE__;
+        }
+        else
+        {
+            (void)printf("%-12s %d socketio_opens in %8.1f us (%6.2f us/open), all open after %7.2f ms\r\n",
+                label, CONNECTION_COUNT, (double)opens_ns / 1000.0, (double)opens_ns / 1000.0 / CONNECTION_COUNT, (double)(perf_timer_get_ns() - start_ns) / 1000000.0);
+        }
+    }
+
+    for (i = 0; i < opened_count; i++)
+    {
+        (void)socketio_close(connections[i].socket_io, NULL, NULL);
+        socketio_destroy(connections[i].socket_io);
+    }
+    /* the accepted peers are only kept in the connections to be closed here, they are not matched with them */
+    for (i = 0; i < accepted_count; i++)
+    {
+        (void)close(connections[i].peer);
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    int result;
+    int port;
+    int listen_socket;
+    CONNECTION* connections;
+
+    if ((listen_socket = create_listen_socket(&port)) == -1)
+    {
+        (void)printf("Cannot create the listening socket\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        if ((connections = (CONNECTION*)malloc(sizeof(CONNECTION) * CONNECTION_COUNT)) == NULL)
+        {
+            (void)printf("Cannot allocate the connections\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            if (((result = measure_getaddrinfo()) == 0) &&
+                ((result = measure_reconnect_storm(connections, listen_socket, port, "getaddrinfo")) == 0))
+            {
+                if (dns_resolver_init() != 0)
+                {
+                    (void)printf("dns_resolver_init failed\r\n");
+                    result = __LINE__;
+                }
+                else
+                {
+                    /* the storm runs first, while the host name is not cached yet */
+                    if ((result = measure_reconnect_storm(connections, listen_socket, port, "dns_resolver")) == 0)
+                    {
+                        result = measure_cached_lookup();
+                    }
+                    dns_resolver_deinit();
+                }
+            }
+            (void)printf("errors: %lu\r\n", (unsigned long)io_error_count);
+
+            free(connections);
+        }
+
+        (void)close(listen_socket);
+    }
+
+    return result;
+}
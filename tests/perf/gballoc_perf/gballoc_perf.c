@@ -0,0 +1,196 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "perf_timer.h"
+
+/* measures the cost of gballoc_free/gballoc_malloc while a fixed number of allocations is alive.
+   The oldest block is always the one freed, which is the worst case for a tracker that walks its allocations. */
+
+#define OPERATION_COUNT 200000
+
+static const size_t live_counts[] = { 10, 100, 1000, 10000, 100000 };
+
+static int measure_free(size_t live_count)
+{
+    int result;
+    void** blocks = (void**)malloc(live_count * sizeof(void*));
+
+    if (blocks == NULL)
+    {
+        (void)printf("Cannot allocate the block array\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        size_t i;
+        size_t allocated;
+        uint64_t start_ns;
+        uint64_t end_ns;
+
+        result = 0;
+        for (allocated = 0; allocated < live_count; allocated++)
+        {
+            if ((blocks[allocated] = gballoc_malloc(16)) == NULL)
+            {
+                (void)printf("gballoc_malloc failed\r\n");
+                result = __LINE__;
+                break;
+            }
+        }
+
+        if (result == 0)
+        {
+            start_ns = perf_timer_get_ns();
+            for (i = 0; i < OPERATION_COUNT; i++)
+            {
+                size_t oldest = i % live_count;
+                gballoc_free(blocks[oldest]);
+                if ((blocks[oldest] = gballoc_malloc(16)) == NULL)
+                {
+                    (void)printf("gballoc_malloc failed\r\n");
+                    result = __LINE__;
+                    break;
+                }
+            }
+            end_ns = perf_timer_get_ns();
+
+            if (result == 0)
+            {
+                (void)printf("live allocations: %6lu, %d free+malloc: %8.1f ms, %8.1f ns/op, current memory used: %lu\r\n",
+                    (unsigned long)live_count, OPERATION_COUNT, (double)(end_ns - start_ns) / 1000000.0,
+                    (double)(end_ns - start_ns) / OPERATION_COUNT, (unsigned long)gballoc_getCurrentMemoryUsed());
+            }
+            else
+            {
+                blocks[i % live_count] = NULL;
+            }
+        }
+
+        for (i = 0; i < allocated; i++)
+        {
+            gballoc_free(blocks[i]);
+        }
+
+        free(blocks);
+    }
+
+    return result;
+}
+
+/* measures the aggregate malloc/free throughput when several threads allocate at the same time */
+
+#define THREAD_OPERATION_COUNT 200000
+#define THREAD_LIVE_COUNT 64
+#define MAX_THREAD_COUNT 16
+
+static const size_t thread_counts[] = { 1, 4, MAX_THREAD_COUNT };
+
+static int allocating_thread(void* arg)
+{
+    int result = 0;
+    void* blocks[THREAD_LIVE_COUNT] = { NULL };
+    size_t i;
+
+    (void)arg;
+
+    for (i = 0; i < THREAD_OPERATION_COUNT; i++)
+    {
+        size_t slot = i % THREAD_LIVE_COUNT;
+        gballoc_free(blocks[slot]);
+        if ((blocks[slot] = gballoc_malloc(16 + slot)) == NULL)
+        {
+            result = __LINE__;
+            break;
+        }
+    }
+
+    for (i = 0; i < THREAD_LIVE_COUNT; i++)
+    {
+        gballoc_free(blocks[i]);
+    }
+
+    return result;
+}
+
+static int measure_contention(size_t thread_count)
+{
+    int result = 0;
+    THREAD_HANDLE threads[MAX_THREAD_COUNT];
+    size_t started;
+    size_t i;
+    uint64_t start_ns;
+    uint64_t end_ns;
+
+    start_ns = perf_timer_get_ns();
+    for (started = 0; started < thread_count; started++)
+    {
+        if (ThreadAPI_Create(&threads[started], allocating_thread, NULL) != THREADAPI_OK)
+        {
+            (void)printf("Cannot create thread\r\n");
+            result = __LINE__;
+            break;
+        }
+    }
+
+    for (i = 0; i < started; i++)
+    {
+        int thread_result;
+        if ((ThreadAPI_Join(threads[i], &thread_result) != THREADAPI_OK) ||
+            (thread_result != 0))
+        {
+            (void)printf("Thread failed\r\n");
+            result = __LINE__;
+        }
+    }
+    end_ns = perf_timer_get_ns();
+
+    if (result == 0)
+    {
+        double total_ops = (double)thread_count * THREAD_OPERATION_COUNT;
+        (void)printf("threads: %2lu, %d free+malloc each: %8.1f ms, %8.2f Mops/s, current memory used: %lu\r\n",
+            (unsigned long)thread_count, THREAD_OPERATION_COUNT, (double)(end_ns - start_ns) / 1000000.0,
+            total_ops * 1000.0 / (double)(end_ns - start_ns), (unsigned long)gballoc_getCurrentMemoryUsed());
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    int result;
+
+    if (gballoc_init() != 0)
+    {
+        (void)printf("Cannot initialize gballoc\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        size_t i;
+
+        result = 0;
+        for (i = 0; i < sizeof(live_counts) / sizeof(live_counts[0]); i++)
+        {
+            if ((result = measure_free(live_counts[i])) != 0)
+            {
+                break;
+            }
+        }
+
+        for (i = 0; (result == 0) && (i < sizeof(thread_counts) / sizeof(thread_counts[0])); i++)
+        {
+            result = measure_contention(thread_counts[i]);
+        }
+
+        (void)printf("maximum memory used: %lu, allocation count: %lu\r\n",
+            (unsigned long)gballoc_getMaximumMemoryUsed(), (unsigned long)gballoc_getAllocationCount());
+
+        gballoc_deinit();
+    }
+
+    return result;
+}
@@ -0,0 +1,206 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/map.h"
+#include "perf_timer.h"
+
+/* measures building a set of request headers, looking up each of its headers and destroying it, with keys copied by the map
+   (Map_Create) and with keys acquired from the string intern table (Map_CreateWithInternedKeys, what HTTPHeaders and uws_client use).
+   LIVE_SET_COUNT header sets are kept alive meanwhile, the way concurrent requests keep theirs, and the memory they use is reported.
+   The lookups are made with copies of the names, and with interned keys also with the canonical copies of the names, the way a
+   header set is looked up with the keys of another one. */
+
+#define OPERATION_COUNT 200000
+#define LIVE_SET_COUNT 100
+
+static const char* header_names[] =
+{
+    "Host",
+    "User-Agent",
+    "Authorization",
+    "Content-Type",
+    "Content-Length",
+    "Accept",
+    "iothub-messageid",
+    "x-ms-client-request-id",
+    "Sec-WebSocket-Protocol",
+    "Sec-WebSocket-Version"
+};
+
+#define HEADER_COUNT (sizeof(header_names) / sizeof(header_names[0]))
+
+/* the names are looked up from copies, the way they arrive from callers */
+static char lookup_names[HEADER_COUNT][32];
+
+static void print_result(const char* operation, const char* mode, size_t operation_count, uint64_t elapsed_ns, size_t allocation_count)
+{
+    (void)printf("%-6s %-9s %7lu operations: %9.2f ms, %7.1f ns/operation, %5.2f allocations/operation\r\n",
+        operation, mode, (unsigned long)operation_count, (double)elapsed_ns / 1000000.0,
+        (double)elapsed_ns / (double)operation_count, (double)allocation_count / (double)operation_count);
+}
+
+static MAP_HANDLE build_header_set(int interned)
+{
+    MAP_HANDLE result = interned ? Map_CreateWithInternedKeys(NULL) : Map_Create(NULL);
+    if (result != NULL)
+    {
+        size_t i;
+        for (i = 0; i < HEADER_COUNT; i++)
+        {
+            if (Map_AddOrUpdate(result, header_names[i], "value") != MAP_OK)
+            {
+                Map_Destroy(result);
+                result = NULL;
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+static uint64_t lookup_header_set(MAP_HANDLE header_set, const char* const* names, size_t* total)
+{
+    uint64_t start_ns = perf_timer_get_ns();
+    size_t i;
+    for (i = 0; i < HEADER_COUNT; i++)
+    {
+        const char* value = Map_GetValueFromKey(header_set, names[i]);
+        if (value != NULL)
+        {
+            *total += (size_t)value[0];
+        }
+    }
+    /* a header that is not in the set */
+    if (Map_GetValueFromKey(header_set, "If-None-Match") != NULL)
+    {
+        *total += 1;
+    }
+    return perf_timer_get_ns() - start_ns;
+}
+
+static int measure(int interned, size_t* total)
+{
+    int result = 0;
+    const char* mode = interned ? "interned" : "copied";
+    const char* copied_names[HEADER_COUNT];
+    MAP_HANDLE live_sets[LIVE_SET_COUNT];
+    size_t memory_before = gballoc_getCurrentMemoryUsed();
+    size_t live_count;
+
+    for (live_count = 0; live_count < LIVE_SET_COUNT; live_count++)
+    {
+        if ((live_sets[live_count] = build_header_set(interned)) == NULL)
+        {
+            (void)printf("building a header set failed\r\n");
+            result = __LINE__;
+            break;
+        }
+    }
+
+    if (result == 0)
+    {
+        size_t live_bytes = gballoc_getCurrentMemoryUsed() - memory_before;
+        size_t round_count = OPERATION_COUNT / HEADER_COUNT;
+        size_t round;
+        uint64_t build_ns = 0;
+        uint64_t lookup_ns = 0;
+        uint64_t canonical_lookup_ns = 0;
+        size_t build_allocation_count = 0;
+        size_t lookup_allocation_count = 0;
+        const char* const* canonical_names;
+        const char* const* values;
+        size_t count;
+        size_t i;
+
+        for (i = 0; i < HEADER_COUNT; i++)
+        {
+            copied_names[i] = lookup_names[i];
+        }
+        /* the keys of a live set are in the order they were added */
+        (void)Map_GetInternals(live_sets[0], &canonical_names, &values, &count);
+
+        for (round = 0; round < round_count; round++)
+        {
+            uint64_t start_ns;
+            MAP_HANDLE header_set;
+
+            gballoc_resetMetrics();
+            start_ns = perf_timer_get_ns();
+            header_set = build_header_set(interned);
+            build_ns += perf_timer_get_ns() - start_ns;
+            build_allocation_count += gballoc_getAllocationCount();
+            if (header_set == NULL)
+            {
+                (void)printf("building a header set failed\r\n");
+                result = __LINE__;
+                break;
+            }
+            else
+            {
+                gballoc_resetMetrics();
+                lookup_ns += lookup_header_set(header_set, copied_names, total);
+                lookup_allocation_count += gballoc_getAllocationCount();
+                if (interned)
+                {
+                    canonical_lookup_ns += lookup_header_set(header_set, canonical_names, total);
+                }
+
+                Map_Destroy(header_set);
+            }
+        }
+
+        if (result == 0)
+        {
+            print_result("build", mode, round_count, build_ns, build_allocation_count);
+            print_result("lookup", mode, round_count * (HEADER_COUNT + 1), lookup_ns, lookup_allocation_count);
+            if (interned)
+            {
+                print_result("lookup", "canonical", round_count * (HEADER_COUNT + 1), canonical_lookup_ns, 0);
+            }
+            (void)printf("memory %-9s %lu live header sets: %lu bytes, %lu bytes/set\r\n",
+                mode, (unsigned long)LIVE_SET_COUNT, (unsigned long)live_bytes, (unsigned long)(live_bytes / LIVE_SET_COUNT));
+        }
+    }
+
+    while (live_count > 0)
+    {
+        live_count--;
+        Map_Destroy(live_sets[live_count]);
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    int result;
+
+    if (gballoc_init() != 0)
+    {
+        (void)printf("Cannot initialize gballoc\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        size_t total = 0;
+        size_t i;
+
+        for (i = 0; i < HEADER_COUNT; i++)
+        {
+            (void)sprintf(lookup_names[i], "%s", header_names[i]);
+        }
+
+        if ((result = measure(0, &total)) == 0)
+        {
+            result = measure(1, &total);
+        }
+        (void)printf("total: %lu\r\n", (unsigned long)total);
+
+        gballoc_deinit();
+    }
+
+    return result;
+}
@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/map.h"
+#include "perf_timer.h"
+
+/* measures building a map of a given number of keys with Map_Add, then looking up every key with Map_GetValueFromKey
+   as many times as the map was built, then cloning and destroying the map the way HTTPHeaders_Clone and ConstMap_Create do.
+   Small maps are rebuilt enough times that their timings are meaningful. */
+
+#define OPERATION_COUNT 1000000
+#define MAX_KEY_COUNT 10000
+
+static const size_t key_counts[] = { 10, 100, 10000 };
+
+static char keys[MAX_KEY_COUNT][32];
+
+static void print_result(const char* operation, size_t key_count, size_t operation_count, uint64_t elapsed_ns, size_t allocation_count)
+{
+    (void)printf("%-6s %5lu keys, %7lu operations: %9.2f ms, %8.1f ns/operation, %5.2f allocations/operation\r\n",
+        operation, (unsigned long)key_count, (unsigned long)operation_count, (double)elapsed_ns / 1000000.0,
+        (double)elapsed_ns / (double)operation_count, (double)allocation_count / (double)operation_count);
+}
+
+static int measure(size_t key_count)
+{
+    int result = 0;
+    /* building a large map with a linear scan is quadratic, so large maps do fewer rounds */
+    size_t round_count = (OPERATION_COUNT / key_count) / ((key_count > 1000) ? key_count / 100 : 1);
+    size_t lookup_round_count;
+    size_t clone_count = OPERATION_COUNT / key_count;
+    size_t round;
+    size_t found_count = 0;
+    uint64_t add_ns = 0;
+    uint64_t lookup_ns = 0;
+    uint64_t clone_ns = 0;
+    size_t add_allocation_count = 0;
+    size_t lookup_allocation_count = 0;
+    size_t clone_allocation_count = 0;
+
+    if (round_count == 0)
+    {
+        round_count = 1;
+    }
+    lookup_round_count = round_count;
+
+    for (round = 0; (result == 0) && (round < round_count); round++)
+    {
+        MAP_HANDLE map;
+        uint64_t start_ns;
+        size_t i;
+
+        gballoc_resetMetrics();
+        start_ns = perf_timer_get_ns();
+        if ((map = Map_Create(NULL)) == NULL)
+        {
+            (void)printf("Map_Create failed\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            for (i = 0; i < key_count; i++)
+            {
+                if (Map_Add(map, keys[i], "value") != MAP_OK)
+                {
+                    (void)printf("Map_Add failed\r\n");
+                    result = __LINE__;
+                    break;
+                }
+            }
+            add_ns += perf_timer_get_ns() - start_ns;
+            add_allocation_count += gballoc_getAllocationCount();
+
+            /* the lookups are measured on the map of the last round */
+            if ((result == 0) && (round == round_count - 1))
+            {
+                size_t lookup_round;
+
+                gballoc_resetMetrics();
+                start_ns = perf_timer_get_ns();
+                for (lookup_round = 0; lookup_round < lookup_round_count; lookup_round++)
+                {
+                    for (i = 0; i < key_count; i++)
+                    {
+                        if (Map_GetValueFromKey(map, keys[i]) != NULL)
+                        {
+                            found_count++;
+                        }
+                    }
+                }
+                lookup_ns = perf_timer_get_ns() - start_ns;
+                lookup_allocation_count = gballoc_getAllocationCount();
+
+                gballoc_resetMetrics();
+                start_ns = perf_timer_get_ns();
+                for (i = 0; i < clone_count; i++)
+                {
+                    MAP_HANDLE clone = Map_Clone(map);
+                    if (clone == NULL)
+                    {
+                        (void)printf("Map_Clone failed\r\n");
+                        result = __LINE__;
+                        break;
+                    }
+                    Map_Destroy(clone);
+                }
+                clone_ns = perf_timer_get_ns() - start_ns;
+                clone_allocation_count = gballoc_getAllocationCount();
+            }
+
+            Map_Destroy(map);
+        }
+    }
+
+    if (result == 0)
+    {
+        if (found_count != lookup_round_count * key_count)
+        {
+            (void)printf("Map_GetValueFromKey did not find all the keys\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            print_result("add", key_count, round_count * key_count, add_ns, add_allocation_count);
+            print_result("lookup", key_count, lookup_round_count * key_count, lookup_ns, lookup_allocation_count);
+            print_result("clone", key_count, clone_count, clone_ns, clone_allocation_count);
+        }
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    int result;
+
+    if (gballoc_init() != 0)
+    {
+        (void)printf("Cannot initialize gballoc\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        size_t i;
+
+        /* header-like keys that share a long prefix */
+        for (i = 0; i < MAX_KEY_COUNT; i++)
+        {
+            (void)sprintf(keys[i], "x-ms-header-%lu", (unsigned long)i);
+        }
+
+        result = 0;
+        for (i = 0; (result == 0) && (i < sizeof(key_counts) / sizeof(key_counts[0])); i++)
+        {
+            result = measure(key_counts[i]);
+        }
+
+        gballoc_deinit();
+    }
+
+    return result;
+}
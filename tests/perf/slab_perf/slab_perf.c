@@ -0,0 +1,233 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/slab.h"
+#include "perf_timer.h"
+
+/* measures the bookkeeping cost of a send the way socketio/wsio/uws_client do it: a pending record is allocated and
+   queued, and the oldest one is completed once the queue is at the given depth.
+   "heap" is the previous scheme: one malloc for the list node and one for the record.
+   "slab" is the current scheme: the list node and the record both come from a slab. */
+
+#define SEND_COUNT 1000000
+
+static const size_t queue_depths[] = { 1, 16, 256 };
+
+typedef struct PENDING_SEND_TAG
+{
+    void (*on_send_complete)(void* context, int result);
+    void* context;
+    void* owner;
+} PENDING_SEND;
+
+typedef struct HEAP_NODE_TAG
+{
+    void* item;
+    struct HEAP_NODE_TAG* next;
+} HEAP_NODE;
+
+static size_t completed_count;
+
+static void on_send_complete(void* context, int result)
+{
+    (void)context;
+    (void)result;
+    completed_count++;
+}
+
+static void print_result(const char* scheme, size_t queue_depth, uint64_t elapsed_ns, size_t allocation_count)
+{
+    (void)printf("%s queue depth: %4lu, %d sends: %8.1f ms, %8.2f M sends/s, %5.2f allocations/send\r\n",
+        scheme, (unsigned long)queue_depth, SEND_COUNT, (double)elapsed_ns / 1000000.0,
+        (double)SEND_COUNT * 1000.0 / (double)elapsed_ns, (double)allocation_count / SEND_COUNT);
+}
+
+static int measure_heap(size_t queue_depth)
+{
+    int result = 0;
+    HEAP_NODE* head = NULL;
+    HEAP_NODE* tail = NULL;
+    size_t pending = 0;
+    size_t i;
+    uint64_t start_ns;
+    uint64_t end_ns;
+
+    gballoc_resetMetrics();
+    completed_count = 0;
+
+    start_ns = perf_timer_get_ns();
+    for (i = 0; i < SEND_COUNT; i++)
+    {
+        HEAP_NODE* node = (HEAP_NODE*)gballoc_malloc(sizeof(HEAP_NODE));
+        PENDING_SEND* pending_send = (PENDING_SEND*)gballoc_malloc(sizeof(PENDING_SEND));
+        if ((node == NULL) || (pending_send == NULL))
+        {
+            (void)printf("gballoc_malloc failed\r\n");
+            gballoc_free(node);
+            gballoc_free(pending_send);
+            result = __LINE__;
+            break;
+        }
+
+        pending_send->on_send_complete = on_send_complete;
+        pending_send->context = NULL;
+        pending_send->owner = NULL;
+        node->item = pending_send;
+        node->next = NULL;
+        if (tail == NULL)
+        {
+            head = node;
+        }
+        else
+        {
+            tail->next = node;
+        }
+        tail = node;
+        pending++;
+
+        if (pending == queue_depth)
+        {
+            HEAP_NODE* oldest = head;
+            PENDING_SEND* completed = (PENDING_SEND*)oldest->item;
+
+            head = oldest->next;
+            if (head == NULL)
+            {
+                tail = NULL;
+            }
+            gballoc_free(oldest);
+            completed->on_send_complete(completed->context, 0);
+            gballoc_free(completed);
+            pending--;
+        }
+    }
+    end_ns = perf_timer_get_ns();
+
+    if (result == 0)
+    {
+        print_result("heap", queue_depth, end_ns - start_ns, gballoc_getAllocationCount());
+    }
+
+    while (head != NULL)
+    {
+        HEAP_NODE* next = head->next;
+        gballoc_free(head->item);
+        gballoc_free(head);
+        head = next;
+    }
+
+    return result;
+}
+
+static int measure_slab(size_t queue_depth)
+{
+    int result = 0;
+    SINGLYLINKEDLIST_HANDLE list;
+    SLAB_HANDLE slab;
+    uint64_t start_ns;
+    uint64_t end_ns;
+
+    gballoc_resetMetrics();
+    completed_count = 0;
+
+    /* the owner creates its list and slab once, their creation is part of the measured allocations */
+    start_ns = perf_timer_get_ns();
+    if ((list = singlylinkedlist_create()) == NULL)
+    {
+        (void)printf("singlylinkedlist_create failed\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        if ((slab = slab_create(sizeof(PENDING_SEND), 8)) == NULL)
+        {
+            (void)printf("slab_create failed\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            size_t pending = 0;
+            size_t i;
+
+            for (i = 0; i < SEND_COUNT; i++)
+            {
+                PENDING_SEND* pending_send = (PENDING_SEND*)slab_malloc(slab);
+                if (pending_send == NULL)
+                {
+                    (void)printf("slab_malloc failed\r\n");
+                    result = __LINE__;
+                    break;
+                }
+
+                pending_send->on_send_complete = on_send_complete;
+                pending_send->context = NULL;
+                pending_send->owner = NULL;
+                if (singlylinkedlist_add(list, pending_send) == NULL)
+                {
+                    (void)printf("singlylinkedlist_add failed\r\n");
+                    slab_free(slab, pending_send);
+                    result = __LINE__;
+                    break;
+                }
+                pending++;
+
+                if (pending == queue_depth)
+                {
+                    LIST_ITEM_HANDLE oldest = singlylinkedlist_get_head_item(list);
+                    PENDING_SEND* completed = (PENDING_SEND*)singlylinkedlist_item_get_value(oldest);
+                    void (*completed_callback)(void* context, int result) = completed->on_send_complete;
+                    void* completed_context = completed->context;
+
+                    (void)singlylinkedlist_remove(list, oldest);
+                    slab_free(slab, completed);
+                    completed_callback(completed_context, 0);
+                    pending--;
+                }
+            }
+
+            slab_destroy(slab);
+        }
+
+        singlylinkedlist_destroy(list);
+    }
+    end_ns = perf_timer_get_ns();
+
+    if (result == 0)
+    {
+        print_result("slab", queue_depth, end_ns - start_ns, gballoc_getAllocationCount());
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    int result;
+
+    if (gballoc_init() != 0)
+    {
+        (void)printf("Cannot initialize gballoc\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        size_t i;
+
+        result = 0;
+        for (i = 0; (result == 0) && (i < sizeof(queue_depths) / sizeof(queue_depths[0])); i++)
+        {
+            if ((result = measure_heap(queue_depths[i])) == 0)
+            {
+                result = measure_slab(queue_depths[i]);
+            }
+        }
+
+        gballoc_deinit();
+    }
+
+    return result;
+}
@@ -0,0 +1,318 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/socketio_event_loop.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+#include "perf_timer.h"
+
+/* measures opening connections from one thread while one of the endpoints does not answer.
+   The unresponsive endpoint is a listening socket whose backlog is full, the kernel drops the SYNs sent to it, so its connect neither
+   succeeds nor fails. It is opened first with a connect_timeout of STALLED_TIMEOUT_MS, then CONNECTION_COUNT connections are opened to
+   a listener that accepts them. socketio_open used to wait for the connect, up to 10 seconds, before returning: the thread was held by
+   the unresponsive endpoint before it could open any other connection. Now it returns right away and the connects are finished by
+   socketio_dowork or the event loop. */
+
+#define CONNECTION_COUNT 200
+#define STALLED_TIMEOUT_MS 1000
+#define BACKLOG_FILLER_COUNT 4
+#define RUN_TIMEOUT_MS 10000
+
+typedef struct CONNECTION_TAG
+{
+    CONCRETE_IO_HANDLE socket_io;
+    IO_OPEN_RESULT open_result;
+    uint64_t opened_ns;
+    int is_open_completed;
+    int peer;
+} CONNECTION;
+
+static uint64_t start_ns;
+static size_t io_error_count;
+
+static void on_io_open_complete(void* context, IO_OPEN_RESULT_DETAILED open_result)
+{
+    CONNECTION* connection = (CONNECTION*)context;
+    connection->open_result = open_result.result;
+    connection->opened_ns = perf_timer_get_ns() - start_ns;
+    connection->is_open_completed = 1;
+}
+
+static void on_bytes_received(void* context, const unsigned char* buffer, size_t size)
+{
+    (void)context;
+    (void)buffer;
+    (void)size;
+}
+
+static void on_io_error(void* context)
+{
+    (void)context;
+    io_error_count++;
+}
+
+static int create_listen_socket(int backlog, int* port)
+{
+    int result = socket(AF_INET, SOCK_STREAM, 0);
+    if (result != -1)
+    {
+        struct sockaddr_in address;
+        socklen_t address_length = sizeof(address);
+        (void)memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+
+        if ((bind(result, (struct sockaddr*)&address, sizeof(address)) != 0) ||
+            (listen(result, backlog) != 0) ||
+            (getsockname(result, (struct sockaddr*)&address, &address_length) != 0))
+        {
+            (void)close(result);
+            result = -1;
+        }
+        else
+        {
+            *port = ntohs(address.sin_port);
+        }
+    }
+    return result;
+}
+
+/* connects that are never accepted fill the backlog of the listening socket, the connects after them get no answer */
+static void fill_backlog(int* fillers, int port)
+{
+    size_t i;
+    struct sockaddr_in address;
+    (void)memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((uint16_t)port);
+
+    for (i = 0; i < BACKLOG_FILLER_COUNT; i++)
+    {
+        if ((fillers[i] = socket(AF_INET, SOCK_STREAM, 0)) != -1)
+        {
+            (void)fcntl(fillers[i], F_SETFL, O_NONBLOCK);
+            (void)connect(fillers[i], (struct sockaddr*)&address, sizeof(address));
+        }
+    }
+}
+
+static CONCRETE_IO_HANDLE open_connection(CONNECTION* connection, int port, SOCKETIO_EVENT_LOOP_HANDLE event_loop, unsigned int connect_timeout_ms)
+{
+    SOCKETIO_CONFIG config;
+    config.hostname = "127.0.0.1";
+    config.port = port;
+    config.accepted_socket = NULL;
+
+    connection->is_open_completed = 0;
+    if ((connection->socket_io = socketio_create(&config)) != NULL)
+    {
+        if (((event_loop != NULL) && (socketio_setoption(connection->socket_io, OPTION_EVENT_LOOP, event_loop) != 0)) ||
+            (socketio_setoption(connection->socket_io, OPTION_CONNECT_TIMEOUT, &connect_timeout_ms) != 0) ||
+            (socketio_open(connection->socket_io, on_io_open_complete, connection, on_bytes_received, connection, on_io_error, connection) != 0))
+        {
+            socketio_destroy(connection->socket_io);
+            connection->socket_io = NULL;
+        }
+    }
+    return connection->socket_io;
+}
+
+static size_t count_completed(const CONNECTION* connections, size_t count)
+{
+    size_t result = 0;
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        result += (size_t)connections[i].is_open_completed;
+    }
+    return result;
+}
+
+static int measure(CONNECTION* connections, int stalled_port, int listen_socket, int port, int use_event_loop)
+{
+    int result = 0;
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = NULL;
+
+    if (use_event_loop && ((event_loop = socketio_event_loop_create()) == NULL))
+    {
+        (void)printf("socketio_event_loop_create failed\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        /* connections[0] goes to the unresponsive endpoint */
+        CONNECTION* stalled = &connections[0];
+        uint64_t stalled_open_ns;
+        uint64_t opens_ns;
+        uint64_t deadline_ns;
+        size_t opened_count = 0;
+        size_t accepted_count = 0;
+        size_t i;
+
+        start_ns = perf_timer_get_ns();
+        if (open_connection(stalled, stalled_port, event_loop, STALLED_TIMEOUT_MS) == NULL)
+        {
+            (void)printf("opening the stalled connection failed\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            stalled_open_ns = perf_timer_get_ns() - start_ns;
+            for (opened_count = 1; opened_count <= CONNECTION_COUNT; opened_count++)
+            {
+                if (open_connection(&connections[opened_count], port, event_loop, STALLED_TIMEOUT_MS) == NULL)
+                {
+                    (void)printf("opening connection %lu failed\r\n", (unsigned long)opened_count);
+                    result = __LINE__;
+                    break;
+                }
+            }
+            opens_ns = perf_timer_get_ns() - start_ns;
+
+            deadline_ns = start_ns + (uint64_t)RUN_TIMEOUT_MS * 1000000;
+            while ((result == 0) && (count_completed(connections, CONNECTION_COUNT + 1) < CONNECTION_COUNT + 1) && (perf_timer_get_ns() < deadline_ns))
+            {
+                int accepted;
+                while ((accepted_count < CONNECTION_COUNT) && ((accepted = accept(listen_socket, NULL, NULL)) != -1))
+                {
+                    accepted_count++;
+                    connections[accepted_count].peer = accepted;
+                }
+
+                if (event_loop == NULL)
+                {
+                    for (i = 0; i <= CONNECTION_COUNT; i++)
+                    {
+                        socketio_dowork(connections[i].socket_io);
+                    }
+                }
+                else
+                {
+                    /* the stalled connect times out from the connect timer of its socket IO */
+                    (void)socketio_event_loop_run_once(event_loop, 10);
+                }
+            }
+
+            if (result == 0)
+            {
+                uint64_t last_open_ns = 0;
+                size_t ok_count = 0;
+                for (i = 1; i <= CONNECTION_COUNT; i++)
+                {
+                    if (connections[i].is_open_completed && (connections[i].open_result == IO_OPEN_OK))
+                    {
+                        ok_count++;
+                        if (connections[i].opened_ns > last_open_ns)
+                        {
+                            last_open_ns = connections[i].opened_ns;
+                        }
+                    }
+                }
+
+                if ((ok_count != CONNECTION_COUNT) || !stalled->is_open_completed || (stalled->open_result != IO_OPEN_ERROR))
+                {
+                    (void)printf("%lu of %d connections opened, stalled open %s\r\n", (unsigned long)ok_count, CONNECTION_COUNT,
+                        !stalled->is_open_completed ? "not completed" : (stalled->open_result == IO_OPEN_ERROR) ? "failed" : "did not fail");
+                    result = __LINE__;
+                }
+                else
+                {
+                    (void)printf("%-6s stalled socketio_open returned in %8.1f us, %d socketio_opens in %8.1f us, all open after %8.1f ms, stalled open failed after %7.1f ms\r\n",
+                        use_event_loop ? "loop" : "dowork", (double)stalled_open_ns / 1000.0, CONNECTION_COUNT, (double)(opens_ns - stalled_open_ns) / 1000.0,
+                        (double)last_open_ns / 1000000.0, (double)stalled->opened_ns / 1000000.0);
+                }
+            }
+
+            for (i = 0; i < opened_count; i++)
+            {
+                (void)socketio_close(connections[i].socket_io, NULL, NULL);
+                socketio_destroy(connections[i].socket_io);
+            }
+            /* the accepted peers are only kept in the connections to be closed here, they are not matched with them */
+            for (i = 1; i <= accepted_count; i++)
+            {
+                (void)close(connections[i].peer);
+            }
+        }
+
+        socketio_event_loop_destroy(event_loop);
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    int result = 0;
+    int stalled_port;
+    int stalled_listen_socket;
+    int port;
+    int listen_socket;
+    int fillers[BACKLOG_FILLER_COUNT];
+
+    if ((stalled_listen_socket = create_listen_socket(0, &stalled_port)) == -1)
+    {
+        (void)printf("Cannot create the unresponsive listening socket\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        fill_backlog(fillers, stalled_port);
+
+        if ((listen_socket = create_listen_socket(SOMAXCONN, &port)) == -1)
+        {
+            (void)printf("Cannot create the listening socket\r\n");
+            result = __LINE__;
+        }
+        else if (fcntl(listen_socket, F_SETFL, O_NONBLOCK) != 0)
+        {
+            (void)printf("Cannot make the listening socket non-blocking\r\n");
+            (void)close(listen_socket);
+            result = __LINE__;
+        }
+        else
+        {
+            CONNECTION* connections = (CONNECTION*)malloc(sizeof(CONNECTION) * (CONNECTION_COUNT + 1));
+            if (connections == NULL)
+            {
+                (void)printf("Cannot allocate the connections\r\n");
+                result = __LINE__;
+            }
+            else
+            {
+                if ((result = measure(connections, stalled_port, listen_socket, port, 0)) == 0)
+                {
+                    result = measure(connections, stalled_port, listen_socket, port, 1);
+                }
+                (void)printf("errors: %lu\r\n", (unsigned long)io_error_count);
+
+                free(connections);
+            }
+
+            (void)close(listen_socket);
+        }
+
+        {
+            size_t i;
+            for (i = 0; i < BACKLOG_FILLER_COUNT; i++)
+            {
+                (void)close(fillers[i]);
+            }
+        }
+        (void)close(stalled_listen_socket);
+    }
+
+    return result;
+}
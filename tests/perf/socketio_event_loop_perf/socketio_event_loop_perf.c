@@ -0,0 +1,387 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/socketio_event_loop.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+#include "perf_timer.h"
+
+/* measures driving many mostly idle loopback connections from one thread.
+   "dowork" is the previous scheme: every connection is polled by socketio_dowork, which calls recv on it, on every pass.
+   "loop" is the current scheme: the connections are registered with an event loop that sleeps until one of them is readable.
+   The idle CPU is measured over IDLE_DURATION_MS with no traffic, the wake-up latency is the time from a peer sending one byte
+   to the socket IO delivering it. The connections are capped by the open file limit, each one takes FILES_PER_CONNECTION descriptors. */
+
+#define IDLE_DURATION_MS 1000
+#define DOWORK_TICK_MS 10
+#define WAKEUP_COUNT 200
+#define WAKEUP_TIMEOUT_MS 1000
+#define RESERVED_FILE_COUNT 32
+#ifdef USE_IO_URING
+/* a socket IO on io_uring that is not given an event loop has a ring of its own */
+#define FILES_PER_CONNECTION 3
+#else
+#define FILES_PER_CONNECTION 2
+#endif
+
+static const size_t connection_counts[] = { 10, 1000, 10000 };
+
+typedef struct CONNECTION_TAG
+{
+    CONCRETE_IO_HANDLE socket_io;
+    int peer;
+} CONNECTION;
+
+static size_t opened_count;
+static size_t received_count;
+static uint64_t received_ns;
+static size_t io_error_count;
+
+static void on_io_open_complete(void* context, IO_OPEN_RESULT_DETAILED open_result)
+{
+    (void)context;
+    if (open_result.result == IO_OPEN_OK)
+    {
+        opened_count++;
+    }
+}
+
+static void on_bytes_received(void* context, const unsigned char* buffer, size_t size)
+{
+    (void)context;
+    (void)buffer;
+    received_ns = perf_timer_get_ns();
+    received_count += size;
+}
+
+static void on_io_error(void* context)
+{
+    (void)context;
+    io_error_count++;
+}
+
+static uint64_t get_cpu_ns(void)
+{
+    struct rusage usage;
+    (void)getrusage(RUSAGE_SELF, &usage);
+    return ((uint64_t)usage.ru_utime.tv_sec + (uint64_t)usage.ru_stime.tv_sec) * 1000000000 +
+        ((uint64_t)usage.ru_utime.tv_usec + (uint64_t)usage.ru_stime.tv_usec) * 1000;
+}
+
+static int create_listen_socket(int* port)
+{
+    int result = socket(AF_INET, SOCK_STREAM, 0);
+    if (result != -1)
+    {
+        struct sockaddr_in address;
+        socklen_t address_length = sizeof(address);
+        (void)memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+
+        if ((bind(result, (struct sockaddr*)&address, sizeof(address)) != 0) ||
+            (listen(result, SOMAXCONN) != 0) ||
+            (getsockname(result, (struct sockaddr*)&address, &address_length) != 0))
+        {
+            (void)close(result);
+            result = -1;
+        }
+        else
+        {
+            *port = ntohs(address.sin_port);
+        }
+    }
+    return result;
+}
+
+static void close_connections(CONNECTION* connections, size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        /* the peer closes first, so that the TIME_WAIT is on its side and the client ports can be reused by the next measurement */
+        (void)close(connections[i].peer);
+        (void)socketio_close(connections[i].socket_io, NULL, NULL);
+        socketio_destroy(connections[i].socket_io);
+    }
+}
+
+static size_t open_connections(CONNECTION* connections, size_t count, int listen_socket, int port, SOCKETIO_EVENT_LOOP_HANDLE event_loop)
+{
+    size_t result;
+    SOCKETIO_CONFIG config;
+    config.hostname = "127.0.0.1";
+    config.port = port;
+    config.accepted_socket = NULL;
+
+    for (result = 0; result < count; result++)
+    {
+        CONNECTION* connection = &connections[result];
+        if ((connection->socket_io = socketio_create(&config)) == NULL)
+        {
+            break;
+        }
+        else if ((event_loop != NULL) &&
+            (socketio_setoption(connection->socket_io, OPTION_EVENT_LOOP, event_loop) != 0))
+        {
+            socketio_destroy(connection->socket_io);
+            break;
+        }
+        else if (socketio_open(connection->socket_io, on_io_open_complete, connection, on_bytes_received, connection, on_io_error, connection) != 0)
+        {
+            socketio_destroy(connection->socket_io);
+            break;
+        }
+        else if ((connection->peer = accept(listen_socket, NULL, NULL)) == -1)
+        {
+            (void)socketio_close(connection->socket_io, NULL, NULL);
+            socketio_destroy(connection->socket_io);
+            break;
+        }
+    }
+
+    if (result < count)
+    {
+        close_connections(connections, result);
+    }
+
+    return result;
+}
+
+static void dowork_pass(CONNECTION* connections, size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        socketio_dowork(connections[i].socket_io);
+    }
+}
+
+/* the connects are finished by socketio_dowork or the event loop, they are not part of the idle measurement */
+static int wait_for_opens(CONNECTION* connections, size_t count, SOCKETIO_EVENT_LOOP_HANDLE event_loop)
+{
+    uint64_t deadline_ns = perf_timer_get_ns() + (uint64_t)WAKEUP_TIMEOUT_MS * 1000000;
+
+    while ((opened_count < count) && (perf_timer_get_ns() < deadline_ns))
+    {
+        if (event_loop == NULL)
+        {
+            dowork_pass(connections, count);
+        }
+        else
+        {
+            (void)socketio_event_loop_run_once(event_loop, WAKEUP_TIMEOUT_MS);
+        }
+    }
+
+    return (opened_count == count) ? 0 : __LINE__;
+}
+
+static void measure_idle(CONNECTION* connections, size_t count, SOCKETIO_EVENT_LOOP_HANDLE event_loop)
+{
+    uint64_t start_ns = perf_timer_get_ns();
+    uint64_t end_ns = start_ns + (uint64_t)IDLE_DURATION_MS * 1000000;
+    uint64_t start_cpu_ns = get_cpu_ns();
+    uint64_t cpu_ns;
+    uint64_t now_ns;
+    size_t pass_count = 0;
+
+    while ((now_ns = perf_timer_get_ns()) < end_ns)
+    {
+        if (event_loop == NULL)
+        {
+            dowork_pass(connections, count);
+        }
+        else
+        {
+            (void)socketio_event_loop_run_once(event_loop, (int)((end_ns - now_ns + 999999) / 1000000));
+        }
+        pass_count++;
+    }
+    cpu_ns = get_cpu_ns() - start_cpu_ns;
+
+    if (event_loop == NULL)
+    {
+        /* an application polling the connections every DOWORK_TICK_MS spends this share of a core only to find them idle */
+        double pass_ns = (double)cpu_ns / (double)pass_count;
+        (void)printf("dowork %5lu connections idle: %9.1f us CPU/pass, %6.2f %% CPU at one pass per %d ms\r\n",
+            (unsigned long)count, pass_ns / 1000.0, (pass_ns > DOWORK_TICK_MS * 1000000.0) ? 100.0 : pass_ns * 100.0 / (DOWORK_TICK_MS * 1000000.0), DOWORK_TICK_MS);
+    }
+    else
+    {
+        (void)printf("loop   %5lu connections idle: %9.1f us CPU in %d ms, %6.2f %% CPU, %lu wake-ups\r\n",
+            (unsigned long)count, (double)cpu_ns / 1000.0, IDLE_DURATION_MS, (double)cpu_ns * 100.0 / ((double)IDLE_DURATION_MS * 1000000.0), (unsigned long)pass_count);
+    }
+}
+
+static int measure_wakeup(CONNECTION* connections, size_t count, SOCKETIO_EVENT_LOOP_HANDLE event_loop)
+{
+    int result = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+    size_t i;
+
+    for (i = 0; i < WAKEUP_COUNT; i++)
+    {
+        /* a different connection every time, spread over the whole set */
+        CONNECTION* connection = &connections[(i * 7919) % count];
+        size_t expected_count = received_count + 1;
+        uint64_t sent_ns;
+        uint64_t deadline_ns;
+        uint64_t latency_ns;
+
+        sent_ns = perf_timer_get_ns();
+        if (send(connection->peer, "x", 1, 0) != 1)
+        {
+            (void)printf("sending from the peer failed\r\n");
+            result = __LINE__;
+            break;
+        }
+
+        deadline_ns = sent_ns + (uint64_t)WAKEUP_TIMEOUT_MS * 1000000;
+        while ((received_count < expected_count) && (perf_timer_get_ns() < deadline_ns))
+        {
+            if (event_loop == NULL)
+            {
+                dowork_pass(connections, count);
+            }
+            else
+            {
+                (void)socketio_event_loop_run_once(event_loop, WAKEUP_TIMEOUT_MS);
+            }
+        }
+
+        if (received_count < expected_count)
+        {
+            (void)printf("the byte sent was not received\r\n");
+            result = __LINE__;
+            break;
+        }
+
+        latency_ns = received_ns - sent_ns;
+        total_ns += latency_ns;
+        if (latency_ns > max_ns)
+        {
+            max_ns = latency_ns;
+        }
+    }
+
+    if (result == 0)
+    {
+        (void)printf("%-6s %5lu connections wake-up: %9.1f us average, %9.1f us max over %d wake-ups\r\n",
+            (event_loop == NULL) ? "dowork" : "loop", (unsigned long)count, (double)total_ns / WAKEUP_COUNT / 1000.0, (double)max_ns / 1000.0, WAKEUP_COUNT);
+    }
+
+    return result;
+}
+
+static int measure(CONNECTION* connections, size_t count, int listen_socket, int port, int use_event_loop)
+{
+    int result;
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = NULL;
+
+    if (use_event_loop && ((event_loop = socketio_event_loop_create()) == NULL))
+    {
+        (void)printf("socketio_event_loop_create failed\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        size_t created_count;
+
+        opened_count = 0;
+        created_count = open_connections(connections, count, listen_socket, port, event_loop);
+        if (created_count < count)
+        {
+            (void)printf("only %lu of %lu connections could be opened\r\n", (unsigned long)created_count, (unsigned long)count);
+            result = __LINE__;
+        }
+        else
+        {
+            if ((result = wait_for_opens(connections, count, event_loop)) != 0)
+            {
+                (void)printf("%lu of %lu opens completed\r\n", (unsigned long)opened_count, (unsigned long)count);
+            }
+            else
+            {
+                measure_idle(connections, count, event_loop);
+                result = measure_wakeup(connections, count, event_loop);
+            }
+            close_connections(connections, count);
+        }
+
+        socketio_event_loop_destroy(event_loop);
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    int result = 0;
+    int port;
+    int listen_socket;
+    struct rlimit file_limit;
+    size_t max_connection_count;
+    CONNECTION* connections;
+
+    /* every connection takes a descriptor on each side, and a ring with io_uring */
+    if (getrlimit(RLIMIT_NOFILE, &file_limit) == 0)
+    {
+        file_limit.rlim_cur = file_limit.rlim_max;
+        (void)setrlimit(RLIMIT_NOFILE, &file_limit);
+        (void)getrlimit(RLIMIT_NOFILE, &file_limit);
+    }
+    max_connection_count = (file_limit.rlim_cur > RESERVED_FILE_COUNT) ? (size_t)((file_limit.rlim_cur - RESERVED_FILE_COUNT) / FILES_PER_CONNECTION) : 0;
+
+    if ((listen_socket = create_listen_socket(&port)) == -1)
+    {
+        (void)printf("Cannot create the listening socket\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        if ((connections = (CONNECTION*)malloc(sizeof(CONNECTION) * connection_counts[sizeof(connection_counts) / sizeof(connection_counts[0]) - 1])) == NULL)
+        {
+            (void)printf("Cannot allocate the connections\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            size_t i;
+            for (i = 0; (result == 0) && (i < sizeof(connection_counts) / sizeof(connection_counts[0])); i++)
+            {
+                size_t count = connection_counts[i];
+                if (count > max_connection_count)
+                {
+                    (void)printf("%lu connections capped to %lu by the open file limit of %lu\r\n",
+                        (unsigned long)count, (unsigned long)max_connection_count, (unsigned long)file_limit.rlim_cur);
+                    count = max_connection_count;
+                }
+
+                if ((result = measure(connections, count, listen_socket, port, 0)) == 0)
+                {
+                    result = measure(connections, count, listen_socket, port, 1);
+                }
+            }
+            (void)printf("errors: %lu\r\n", (unsigned long)io_error_count);
+
+            free(connections);
+        }
+
+        (void)close(listen_socket);
+    }
+
+    return result;
+}
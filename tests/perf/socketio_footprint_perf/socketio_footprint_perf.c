@@ -0,0 +1,274 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <malloc.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/socketio_event_loop.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+#include "perf_timer.h"
+
+/* measures the heap taken by each of CONNECTION_COUNT open loopback connections that each received a heartbeat, the way idle device
+   connections spend most of their life.
+   Socket IOs polled with socketio_dowork have their receive buffer at the end of the instance. Socket IOs of an event loop share the
+   receive buffer of the loop, which is counted once, and are also given their own receive buffer with the receive_buffer_size option,
+   the size that large receives need, to compare. The heap is measured with mallinfo2, so it includes the allocator overhead. */
+
+#define CONNECTION_COUNT 1000
+#define HEARTBEAT_TIMEOUT_MS 5000
+
+typedef struct FOOTPRINT_SCENARIO_TAG
+{
+    const char* name;
+    int use_event_loop;
+    /* 0 leaves the option unset */
+    size_t receive_buffer_size;
+} FOOTPRINT_SCENARIO;
+
+static const FOOTPRINT_SCENARIO scenarios[] =
+{
+    { "dowork, 64 byte buffer in the instance", 0, 0 },
+    { "dowork, own 16 KB buffer", 0, 16384 },
+    { "loop, shared buffer of the loop", 1, 0 },
+    { "loop, own 16 KB buffer", 1, 16384 }
+};
+
+typedef struct CONNECTION_TAG
+{
+    CONCRETE_IO_HANDLE socket_io;
+    int peer;
+} CONNECTION;
+
+static size_t received_count;
+static size_t io_error_count;
+
+static void on_bytes_received(void* context, const unsigned char* buffer, size_t size)
+{
+    (void)context;
+    (void)buffer;
+    received_count += size;
+}
+
+static void on_io_error(void* context)
+{
+    (void)context;
+    io_error_count++;
+}
+
+static size_t get_heap_in_use(void)
+{
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks;
+}
+
+static int create_listen_socket(int* port)
+{
+    int result = socket(AF_INET, SOCK_STREAM, 0);
+    if (result != -1)
+    {
+        struct sockaddr_in address;
+        socklen_t address_length = sizeof(address);
+        (void)memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+
+        if ((bind(result, (struct sockaddr*)&address, sizeof(address)) != 0) ||
+            (listen(result, SOMAXCONN) != 0) ||
+            (getsockname(result, (struct sockaddr*)&address, &address_length) != 0))
+        {
+            (void)close(result);
+            result = -1;
+        }
+        else
+        {
+            *port = ntohs(address.sin_port);
+        }
+    }
+    return result;
+}
+
+static void close_connections(CONNECTION* connections, size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        /* the peer closes first, so that the TIME_WAIT is on its side and the client ports can be reused by the next measurement */
+        (void)close(connections[i].peer);
+        (void)socketio_close(connections[i].socket_io, NULL, NULL);
+        socketio_destroy(connections[i].socket_io);
+    }
+}
+
+static size_t open_connections(CONNECTION* connections, size_t count, int listen_socket, int port, SOCKETIO_EVENT_LOOP_HANDLE event_loop, size_t receive_buffer_size)
+{
+    size_t result;
+    SOCKETIO_CONFIG config;
+    config.hostname = "127.0.0.1";
+    config.port = port;
+    config.accepted_socket = NULL;
+
+    for (result = 0; result < count; result++)
+    {
+        CONNECTION* connection = &connections[result];
+        if ((connection->socket_io = socketio_create(&config)) == NULL)
+        {
+            break;
+        }
+        else if ((event_loop != NULL) &&
+            (socketio_setoption(connection->socket_io, OPTION_EVENT_LOOP, event_loop) != 0))
+        {
+            socketio_destroy(connection->socket_io);
+            break;
+        }
+        else if ((receive_buffer_size != 0) &&
+            (socketio_setoption(connection->socket_io, OPTION_RECEIVE_BUFFER_SIZE, &receive_buffer_size) != 0))
+        {
+            socketio_destroy(connection->socket_io);
+            break;
+        }
+        else if (socketio_open(connection->socket_io, NULL, NULL, on_bytes_received, connection, on_io_error, connection) != 0)
+        {
+            socketio_destroy(connection->socket_io);
+            break;
+        }
+        else if ((connection->peer = accept(listen_socket, NULL, NULL)) == -1)
+        {
+            (void)socketio_close(connection->socket_io, NULL, NULL);
+            socketio_destroy(connection->socket_io);
+            break;
+        }
+    }
+
+    if (result < count)
+    {
+        close_connections(connections, result);
+    }
+
+    return result;
+}
+
+/* every peer sends one byte, which every socket IO receives */
+static int receive_heartbeats(CONNECTION* connections, size_t count, SOCKETIO_EVENT_LOOP_HANDLE event_loop)
+{
+    int result = 0;
+    uint64_t deadline_ns;
+    size_t i;
+
+    received_count = 0;
+    for (i = 0; i < count; i++)
+    {
+        if (send(connections[i].peer, "h", 1, 0) != 1)
+        {
+            (void)printf("sending the heartbeat failed\r\n");
+            result = __LINE__;
+            break;
+        }
+    }
+
+    deadline_ns = perf_timer_get_ns() + (uint64_t)HEARTBEAT_TIMEOUT_MS * 1000000;
+    while ((result == 0) && (received_count < count) && (perf_timer_get_ns() < deadline_ns))
+    {
+        if (event_loop == NULL)
+        {
+            for (i = 0; i < count; i++)
+            {
+                socketio_dowork(connections[i].socket_io);
+            }
+        }
+        else
+        {
+            (void)socketio_event_loop_run_once(event_loop, HEARTBEAT_TIMEOUT_MS);
+        }
+    }
+
+    if ((result == 0) && (received_count != count))
+    {
+        (void)printf("%lu of %lu heartbeats received\r\n", (unsigned long)received_count, (unsigned long)count);
+        result = __LINE__;
+    }
+
+    return result;
+}
+
+static int measure(CONNECTION* connections, int listen_socket, int port, const FOOTPRINT_SCENARIO* scenario)
+{
+    int result;
+    size_t heap_before = get_heap_in_use();
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = NULL;
+
+    if (scenario->use_event_loop && ((event_loop = socketio_event_loop_create()) == NULL))
+    {
+        (void)printf("socketio_event_loop_create failed\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        size_t heap_with_loop = get_heap_in_use();
+        size_t opened_count = open_connections(connections, CONNECTION_COUNT, listen_socket, port, event_loop, scenario->receive_buffer_size);
+        if (opened_count < CONNECTION_COUNT)
+        {
+            (void)printf("only %lu of %d connections could be opened\r\n", (unsigned long)opened_count, CONNECTION_COUNT);
+            result = __LINE__;
+        }
+        else
+        {
+            if ((result = receive_heartbeats(connections, CONNECTION_COUNT, event_loop)) == 0)
+            {
+                size_t heap_with_connections = get_heap_in_use();
+                (void)printf("%-40s %d connections: %8.1f bytes/connection, %7lu bytes for the loop, %9lu bytes in all\r\n",
+                    scenario->name, CONNECTION_COUNT, (double)(heap_with_connections - heap_with_loop) / CONNECTION_COUNT,
+                    (unsigned long)(heap_with_loop - heap_before), (unsigned long)(heap_with_connections - heap_before));
+            }
+            close_connections(connections, CONNECTION_COUNT);
+        }
+
+        socketio_event_loop_destroy(event_loop);
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    int result = 0;
+    int port;
+    int listen_socket;
+
+    if ((listen_socket = create_listen_socket(&port)) == -1)
+    {
+        (void)printf("Cannot create the listening socket\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        CONNECTION* connections = (CONNECTION*)malloc(sizeof(CONNECTION) * CONNECTION_COUNT);
+        if (connections == NULL)
+        {
+            (void)printf("Cannot allocate the connections\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            size_t i;
+            for (i = 0; (result == 0) && (i < sizeof(scenarios) / sizeof(scenarios[0])); i++)
+            {
+                result = measure(connections, listen_socket, port, &scenarios[i]);
+            }
+            (void)printf("errors: %lu\r\n", (unsigned long)io_error_count);
+
+            free(connections);
+        }
+
+        (void)close(listen_socket);
+    }
+
+    return result;
+}
@@ -0,0 +1,381 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/socketio_event_loop.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+#include "perf_timer.h"
+
+/* measures the time from socketio_open to the open being indicated for a host name that resolves to ::1 then 127.0.0.1, with a listener
+   on each address and the same port. getaddrinfo is replaced by the one below, the hosts file does not have a dual stack name.
+   - both up: the IPv6 address is tried first and connects.
+   - IPv6 refused: nothing listens on ::1, the refused connect has the IPv4 address tried right away.
+   - IPv6 stalled: the backlog of the ::1 listener is full, the kernel drops the SYNs sent to it and its connect neither succeeds nor fails.
+     The IPv4 address is tried alongside it once the connection attempt delay elapsed. socketio_open used to connect to the first IPv4
+     address only, a host name whose first address did not answer failed the open after the connect timeout, 10 seconds by default.
+   - IPv6 stalled, loop: the same, with the socket IO on an event loop that is run without calling socketio_dowork, the delayed attempt is
+     started by the connect timer of the socket IO. */
+
+#define HOSTNAME "dualstack.test"
+#define OPEN_COUNT 200
+#define STALLED_OPEN_COUNT 10
+#define BACKLOG_FILLER_COUNT 4
+#define OPEN_TIMEOUT_MS 5000
+
+typedef struct CONNECTION_TAG
+{
+    IO_OPEN_RESULT open_result;
+    int is_open_completed;
+} CONNECTION;
+
+static size_t io_error_count;
+
+/* HOSTNAME resolves to ::1 then 127.0.0.1, any other host name does not resolve */
+int getaddrinfo(const char* node, const char* service, const struct addrinfo* hints, struct addrinfo** res)
+{
+    int result;
+    (void)hints;
+
+    if ((node == NULL) || (strcmp(node, HOSTNAME) != 0))
+    {
+        result = EAI_NONAME;
+    }
+    else
+    {
+        uint16_t port = htons((uint16_t)((service == NULL) ? 0 : atoi(service)));
+        struct addrinfo* ipv6 = (struct addrinfo*)calloc(1, sizeof(struct addrinfo) + sizeof(struct sockaddr_in6));
+        struct addrinfo* ipv4 = (struct addrinfo*)calloc(1, sizeof(struct addrinfo) + sizeof(struct sockaddr_in));
+
+        if ((ipv6 == NULL) || (ipv4 == NULL))
+        {
+            free(ipv6);
+            free(ipv4);
+            result = EAI_MEMORY;
+        }
+        else
+        {
+            struct sockaddr_in6* address6 = (struct sockaddr_in6*)(ipv6 + 1);
+            struct sockaddr_in* address4 = (struct sockaddr_in*)(ipv4 + 1);
+
+            address6->sin6_family = AF_INET6;
+            address6->sin6_addr = in6addr_loopback;
+            address6->sin6_port = port;
+            ipv6->ai_family = AF_INET6;
+            ipv6->ai_socktype = SOCK_STREAM;
+            ipv6->ai_addr = (struct sockaddr*)address6;
+            ipv6->ai_addrlen = sizeof(struct sockaddr_in6);
+            ipv6->ai_next = ipv4;
+
+            address4->sin_family = AF_INET;
+            address4->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address4->sin_port = port;
+            ipv4->ai_family = AF_INET;
+            ipv4->ai_socktype = SOCK_STREAM;
+            ipv4->ai_addr = (struct sockaddr*)address4;
+            ipv4->ai_addrlen = sizeof(struct sockaddr_in);
+
+            *res = ipv6;
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+void freeaddrinfo(struct addrinfo* res)
+{
+    while (res != NULL)
+    {
+        struct addrinfo* next = res->ai_next;
+        free(res);
+        res = next;
+    }
+}
+
+static void on_io_open_complete(void* context, IO_OPEN_RESULT_DETAILED open_result)
+{
+    CONNECTION* connection = (CONNECTION*)context;
+    connection->open_result = open_result.result;
+    connection->is_open_completed = 1;
+}
+
+static void on_bytes_received(void* context, const unsigned char* buffer, size_t size)
+{
+    (void)context;
+    (void)buffer;
+    (void)size;
+}
+
+static void on_io_error(void* context)
+{
+    (void)context;
+    io_error_count++;
+}
+
+static int create_listen_socket(int family, int port, int backlog)
+{
+    int result = socket(family, SOCK_STREAM, 0);
+    if (result != -1)
+    {
+        int one = 1;
+        int bind_result;
+
+        if (family == AF_INET6)
+        {
+            struct sockaddr_in6 address;
+            (void)memset(&address, 0, sizeof(address));
+            address.sin6_family = AF_INET6;
+            address.sin6_addr = in6addr_loopback;
+            address.sin6_port = htons((uint16_t)port);
+            /* the IPv4 listener has the same port */
+            bind_result = (setsockopt(result, IPPROTO_IPV6, IPV6_V6ONLY, &one, sizeof(one)) != 0) ? -1 : bind(result, (struct sockaddr*)&address, sizeof(address));
+        }
+        else
+        {
+            struct sockaddr_in address;
+            (void)memset(&address, 0, sizeof(address));
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons((uint16_t)port);
+            bind_result = bind(result, (struct sockaddr*)&address, sizeof(address));
+        }
+
+        if ((bind_result != 0) ||
+            (listen(result, backlog) != 0) ||
+            (fcntl(result, F_SETFL, O_NONBLOCK) != 0))
+        {
+            (void)close(result);
+            result = -1;
+        }
+    }
+    return result;
+}
+
+/* a port that is free on 127.0.0.1, the listeners bind it on both addresses */
+static int get_free_port(void)
+{
+    int result = -1;
+    int probe = socket(AF_INET, SOCK_STREAM, 0);
+    if (probe != -1)
+    {
+        struct sockaddr_in address;
+        socklen_t address_length = sizeof(address);
+        (void)memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        if ((bind(probe, (struct sockaddr*)&address, sizeof(address)) == 0) &&
+            (getsockname(probe, (struct sockaddr*)&address, &address_length) == 0))
+        {
+            result = ntohs(address.sin_port);
+        }
+        (void)close(probe);
+    }
+    return result;
+}
+
+/* fills the backlog of the ::1 listener, so that the next connects to it are not answered */
+static void fill_backlog(int port, int* fillers)
+{
+    size_t i;
+    struct sockaddr_in6 address;
+    (void)memset(&address, 0, sizeof(address));
+    address.sin6_family = AF_INET6;
+    address.sin6_addr = in6addr_loopback;
+    address.sin6_port = htons((uint16_t)port);
+
+    for (i = 0; i < BACKLOG_FILLER_COUNT; i++)
+    {
+        if ((fillers[i] = socket(AF_INET6, SOCK_STREAM, 0)) != -1)
+        {
+            (void)fcntl(fillers[i], F_SETFL, O_NONBLOCK);
+            (void)connect(fillers[i], (struct sockaddr*)&address, sizeof(address));
+        }
+    }
+}
+
+static void accept_all(int listen_socket)
+{
+    int accepted;
+    while ((listen_socket != -1) && ((accepted = accept(listen_socket, NULL, NULL)) != -1))
+    {
+        (void)close(accepted);
+    }
+}
+
+static int compare_u64(const void* left, const void* right)
+{
+    uint64_t left_value = *(const uint64_t*)left;
+    uint64_t right_value = *(const uint64_t*)right;
+    return (left_value < right_value) ? -1 : ((left_value > right_value) ? 1 : 0);
+}
+
+/* the opens are driven by socketio_dowork, or by the loop alone when event_loop is not NULL */
+static int measure_opens(const char* label, int port, size_t open_count, int ipv4_listener, int ipv6_listener, SOCKETIO_EVENT_LOOP_HANDLE event_loop)
+{
+    int result = 0;
+    uint64_t latencies_ns[OPEN_COUNT];
+    SOCKETIO_CONFIG config;
+    size_t i;
+
+    config.hostname = HOSTNAME;
+    config.port = port;
+    config.accepted_socket = NULL;
+
+    for (i = 0; (result == 0) && (i < open_count); i++)
+    {
+        CONNECTION connection;
+        CONCRETE_IO_HANDLE socket_io;
+        uint64_t start_ns;
+
+        connection.is_open_completed = 0;
+        if ((socket_io = socketio_create(&config)) == NULL)
+        {
+            (void)printf("socketio_create failed\r\n");
+            result = __LINE__;
+        }
+        else if ((event_loop != NULL) && (socketio_setoption(socket_io, OPTION_EVENT_LOOP, event_loop) != 0))
+        {
+            (void)printf("socketio_setoption failed\r\n");
+            result = __LINE__;
+            socketio_destroy(socket_io);
+        }
+        else
+        {
+            start_ns = perf_timer_get_ns();
+            if (socketio_open(socket_io, on_io_open_complete, &connection, on_bytes_received, &connection, on_io_error, &connection) != 0)
+            {
+                (void)printf("socketio_open failed\r\n");
+                result = __LINE__;
+            }
+            else
+            {
+                uint64_t deadline_ns = start_ns + (uint64_t)OPEN_TIMEOUT_MS * 1000000;
+                while (!connection.is_open_completed && (perf_timer_get_ns() < deadline_ns))
+                {
+                    if (event_loop == NULL)
+                    {
+                        socketio_dowork(socket_io);
+                    }
+                    else
+                    {
+                        (void)socketio_event_loop_run_once(event_loop, 100);
+                    }
+                }
+                latencies_ns[i] = perf_timer_get_ns() - start_ns;
+
+                if (!connection.is_open_completed || (connection.open_result != IO_OPEN_OK))
+                {
+                    (void)printf("%s: open %lu did not complete\r\n", label, (unsigned long)i);
+                    result = __LINE__;
+                }
+
+                (void)socketio_close(socket_io, NULL, NULL);
+            }
+            socketio_destroy(socket_io);
+        }
+
+        accept_all(ipv4_listener);
+        accept_all(ipv6_listener);
+    }
+
+    if (result == 0)
+    {
+        qsort(latencies_ns, open_count, sizeof(uint64_t), compare_u64);
+        (void)printf("%-18s %3lu opens: p50 %9.1f us, p99 %9.1f us\r\n", label, (unsigned long)open_count,
+            (double)latencies_ns[open_count / 2] / 1000.0, (double)latencies_ns[(open_count * 99) / 100] / 1000.0);
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    int result;
+    int port;
+    int ipv4_listener;
+    int ipv6_listener;
+
+    if ((port = get_free_port()) == -1)
+    {
+        (void)printf("Cannot find a free port\r\n");
+        result = __LINE__;
+    }
+    else if ((ipv4_listener = create_listen_socket(AF_INET, port, SOMAXCONN)) == -1)
+    {
+        (void)printf("Cannot create the IPv4 listening socket\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        if ((ipv6_listener = create_listen_socket(AF_INET6, port, SOMAXCONN)) == -1)
+        {
+            (void)printf("Cannot create the IPv6 listening socket\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            result = measure_opens("both up", port, OPEN_COUNT, ipv4_listener, ipv6_listener, NULL);
+            (void)close(ipv6_listener);
+        }
+
+        if ((result == 0) &&
+            ((result = measure_opens("IPv6 refused", port, OPEN_COUNT, ipv4_listener, -1, NULL)) == 0))
+        {
+            /* a backlog of 0 leaves one connection pending, the fillers are answered and the opens measured are not */
+            if ((ipv6_listener = create_listen_socket(AF_INET6, port, 0)) == -1)
+            {
+                (void)printf("Cannot create the stalled IPv6 listening socket\r\n");
+                result = __LINE__;
+            }
+            else
+            {
+                int fillers[BACKLOG_FILLER_COUNT];
+                size_t i;
+
+                fill_backlog(port, fillers);
+                result = measure_opens("IPv6 stalled", port, STALLED_OPEN_COUNT, ipv4_listener, -1, NULL);
+
+                if (result == 0)
+                {
+                    SOCKETIO_EVENT_LOOP_HANDLE event_loop = socketio_event_loop_create();
+                    if (event_loop == NULL)
+                    {
+                        (void)printf("socketio_event_loop_create failed\r\n");
+                        result = __LINE__;
+                    }
+                    else
+                    {
+                        result = measure_opens("IPv6 stalled, loop", port, STALLED_OPEN_COUNT, ipv4_listener, -1, event_loop);
+                        socketio_event_loop_destroy(event_loop);
+                    }
+                }
+
+                for (i = 0; i < BACKLOG_FILLER_COUNT; i++)
+                {
+                    if (fillers[i] != -1)
+                    {
+                        (void)close(fillers[i]);
+                    }
+                }
+                (void)close(ipv6_listener);
+            }
+        }
+        (void)printf("errors: %lu\r\n", (unsigned long)io_error_count);
+
+        (void)close(ipv4_listener);
+    }
+
+    return result;
+}
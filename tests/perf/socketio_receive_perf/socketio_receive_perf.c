@@ -0,0 +1,297 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/socketio_event_loop.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "perf_timer.h"
+
+/* measures downloading DOWNLOAD_SIZE bytes over a loopback connection, sent by a thread of the peer while an event loop runs the receive path
+   of the socket IO whenever the socket is readable, so that the CPU of the receiving thread is the one spent receiving,
+   with the receive buffer of the event loop shared by its socket IOs, which is the default, with a buffer of the socket IO set by the
+   receive_buffer_size option, RECEIVE_BYTES_VALUE being the size every socket IO had before, and with receive_batched, which reads what
+   the socket has into a buffer that grows and indicates it with one on_bytes_received.
+   The number of on_bytes_received per download, the throughput and the CPU of the receiving thread are reported. */
+
+#define DOWNLOAD_SIZE (1024 * 1024)
+#define DOWNLOAD_COUNT 20
+#define SEND_CHUNK_SIZE 65536
+#define DOWNLOAD_TIMEOUT_MS 30000
+
+typedef struct RECEIVE_SCENARIO_TAG
+{
+    const char* name;
+    /* 0 leaves the option unset */
+    size_t receive_buffer_size;
+    bool receive_batched;
+} RECEIVE_SCENARIO;
+
+/* the socket IO cannot go back to the buffer of the loop once it has its own, those scenarios come first */
+static const RECEIVE_SCENARIO scenarios[] =
+{
+    { "loop buffer (default)", 0, false },
+    { "batched in loop buffer", 0, true },
+    { "64 bytes", RECEIVE_BYTES_VALUE, false },
+    { "4 KB", 4096, false },
+    { "16 KB", 16384, false },
+    { "64 KB", 65536, false },
+    { "batched from 64 bytes", RECEIVE_BYTES_VALUE, true },
+    { "batched from 16 KB", 16384, true }
+};
+
+typedef struct PEER_TAG
+{
+    int socket;
+    const unsigned char* bytes;
+    size_t sent_size;
+} PEER;
+
+static size_t received_size;
+static size_t callback_count;
+static size_t io_error_count;
+
+static void on_bytes_received(void* context, const unsigned char* buffer, size_t size)
+{
+    (void)context;
+    (void)buffer;
+    received_size += size;
+    callback_count++;
+}
+
+static void on_io_error(void* context)
+{
+    (void)context;
+    io_error_count++;
+}
+
+static uint64_t get_thread_cpu_ns(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static int create_listen_socket(int* port)
+{
+    int result = socket(AF_INET, SOCK_STREAM, 0);
+    if (result != -1)
+    {
+        struct sockaddr_in address;
+        socklen_t address_length = sizeof(address);
+        (void)memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+
+        if ((bind(result, (struct sockaddr*)&address, sizeof(address)) != 0) ||
+            (listen(result, SOMAXCONN) != 0) ||
+            (getsockname(result, (struct sockaddr*)&address, &address_length) != 0))
+        {
+            (void)close(result);
+            result = -1;
+        }
+        else
+        {
+            *port = ntohs(address.sin_port);
+        }
+    }
+    return result;
+}
+
+static int peer_send(void* arg)
+{
+    PEER* peer = (PEER*)arg;
+
+    while (peer->sent_size < DOWNLOAD_SIZE)
+    {
+        size_t chunk_size = (DOWNLOAD_SIZE - peer->sent_size < SEND_CHUNK_SIZE) ? DOWNLOAD_SIZE - peer->sent_size : SEND_CHUNK_SIZE;
+        ssize_t sent = send(peer->socket, peer->bytes + peer->sent_size, chunk_size, 0);
+        if (sent <= 0)
+        {
+            break;
+        }
+        peer->sent_size += (size_t)sent;
+    }
+
+    return 0;
+}
+
+static int measure(CONCRETE_IO_HANDLE socket_io, SOCKETIO_EVENT_LOOP_HANDLE event_loop, int peer_socket, const unsigned char* bytes, const RECEIVE_SCENARIO* scenario)
+{
+    int result = 0;
+    uint64_t total_ns = 0;
+    uint64_t total_cpu_ns = 0;
+    size_t total_callback_count = 0;
+    size_t i;
+
+    if (((scenario->receive_buffer_size != 0) && (socketio_setoption(socket_io, OPTION_RECEIVE_BUFFER_SIZE, &scenario->receive_buffer_size) != 0)) ||
+        (socketio_setoption(socket_io, OPTION_RECEIVE_BATCHED, &scenario->receive_batched) != 0))
+    {
+        (void)printf("setting the receive options failed\r\n");
+        result = __LINE__;
+    }
+
+    for (i = 0; (result == 0) && (i < DOWNLOAD_COUNT); i++)
+    {
+        PEER peer;
+        THREAD_HANDLE peer_thread;
+
+        peer.socket = peer_socket;
+        peer.bytes = bytes;
+        peer.sent_size = 0;
+        received_size = 0;
+        callback_count = 0;
+
+        if (ThreadAPI_Create(&peer_thread, peer_send, &peer) != THREADAPI_OK)
+        {
+            (void)printf("Cannot create the peer thread\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            uint64_t start_ns = perf_timer_get_ns();
+            uint64_t deadline_ns = start_ns + (uint64_t)DOWNLOAD_TIMEOUT_MS * 1000000;
+            uint64_t start_cpu_ns = get_thread_cpu_ns();
+            int thread_result;
+
+            while ((received_size < DOWNLOAD_SIZE) && (io_error_count == 0) && (perf_timer_get_ns() < deadline_ns))
+            {
+                (void)socketio_event_loop_run_once(event_loop, DOWNLOAD_TIMEOUT_MS);
+            }
+
+            total_cpu_ns += get_thread_cpu_ns() - start_cpu_ns;
+            total_ns += perf_timer_get_ns() - start_ns;
+            total_callback_count += callback_count;
+            (void)ThreadAPI_Join(peer_thread, &thread_result);
+
+            if (received_size != DOWNLOAD_SIZE)
+            {
+                (void)printf("%lu of %lu bytes received\r\n", (unsigned long)received_size, (unsigned long)DOWNLOAD_SIZE);
+                result = __LINE__;
+            }
+        }
+    }
+
+    if (result == 0)
+    {
+        double megabytes = (double)DOWNLOAD_SIZE * DOWNLOAD_COUNT / (1024.0 * 1024.0);
+        (void)printf("%-22s %d x %d byte downloads: %8.1f callbacks/download, %7.1f bytes/callback, %8.1f MB/s, %7.1f us CPU/MB\r\n",
+            scenario->name, DOWNLOAD_COUNT, DOWNLOAD_SIZE, (double)total_callback_count / DOWNLOAD_COUNT,
+            (double)DOWNLOAD_SIZE * DOWNLOAD_COUNT / (double)total_callback_count,
+            megabytes * 1000000000.0 / (double)total_ns, (double)total_cpu_ns / 1000.0 / megabytes);
+    }
+
+    return result;
+}
+
+static int run_scenarios(SOCKETIO_EVENT_LOOP_HANDLE event_loop, int listen_socket, int port)
+{
+    int result = 0;
+    CONCRETE_IO_HANDLE socket_io;
+    SOCKETIO_CONFIG config;
+    config.hostname = "127.0.0.1";
+    config.port = port;
+    config.accepted_socket = NULL;
+
+    if ((socket_io = socketio_create(&config)) == NULL)
+    {
+        (void)printf("socketio_create failed\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        int peer_socket;
+
+        if (socketio_setoption(socket_io, OPTION_EVENT_LOOP, event_loop) != 0)
+        {
+            (void)printf("socketio_setoption failed\r\n");
+            result = __LINE__;
+        }
+        else if (socketio_open(socket_io, NULL, NULL, on_bytes_received, NULL, on_io_error, NULL) != 0)
+        {
+            (void)printf("socketio_open failed\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            if ((peer_socket = accept(listen_socket, NULL, NULL)) == -1)
+            {
+                (void)printf("accept failed\r\n");
+                result = __LINE__;
+            }
+            else
+            {
+                unsigned char* bytes = (unsigned char*)malloc(DOWNLOAD_SIZE);
+                if (bytes == NULL)
+                {
+                    (void)printf("Cannot allocate the download\r\n");
+                    result = __LINE__;
+                }
+                else
+                {
+                    size_t i;
+                    (void)memset(bytes, 'x', DOWNLOAD_SIZE);
+
+                    for (i = 0; (result == 0) && (i < sizeof(scenarios) / sizeof(scenarios[0])); i++)
+                    {
+                        result = measure(socket_io, event_loop, peer_socket, bytes, &scenarios[i]);
+                    }
+
+                    free(bytes);
+                }
+                (void)printf("errors: %lu\r\n", (unsigned long)io_error_count);
+
+                (void)close(peer_socket);
+            }
+
+            (void)socketio_close(socket_io, NULL, NULL);
+        }
+
+        socketio_destroy(socket_io);
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    int result;
+    int port;
+    int listen_socket;
+
+    if ((listen_socket = create_listen_socket(&port)) == -1)
+    {
+        (void)printf("Cannot create the listening socket\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        SOCKETIO_EVENT_LOOP_HANDLE event_loop = socketio_event_loop_create();
+        if (event_loop == NULL)
+        {
+            (void)printf("socketio_event_loop_create failed\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            result = run_scenarios(event_loop, listen_socket, port);
+            socketio_event_loop_destroy(event_loop);
+        }
+
+        (void)close(listen_socket);
+    }
+
+    return result;
+}
@@ -0,0 +1,392 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/constbuffer.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "perf_timer.h"
+
+/* measures sending messages over a loopback connection whose peer is slower than the sender, so that most of them wait in the
+   pending IO queue of the socket IO and are sent by socketio_dowork once the peer reads.
+   The messages are queued while the peer does not read, then a thread of the peer drains the connection while socketio_dowork
+   sends the queue, the time spent in the sends, the drain time and the CPU of the sending thread are reported.
+   "small copy" sends many small messages with socketio_send, SOCKETIO_MAX_IOVECS is the number of pending IOs gathered per sendmsg,
+   1 is the way the queue was sent before.
+   "large copy" and "large ref" upload 1 MB messages, with socketio_send which copies what it queues, and with socketio_send_constbuffer
+   which keeps a reference to the message instead. */
+
+#define ROUND_COUNT 5
+#define RECEIVE_BUFFER_SIZE 65536
+#define DRAIN_TIMEOUT_MS 30000
+#define OPEN_TIMEOUT_MS 5000
+
+#define STRINGIFY_VALUE(x) #x
+#define STRINGIFY(x) STRINGIFY_VALUE(x)
+#ifdef SOCKETIO_MAX_IOVECS
+#define IOVECS_LABEL "SOCKETIO_MAX_IOVECS=" STRINGIFY(SOCKETIO_MAX_IOVECS)
+#else
+#define IOVECS_LABEL "SOCKETIO_MAX_IOVECS default"
+#endif
+
+typedef struct SEND_SCENARIO_TAG
+{
+    const char* name;
+    size_t message_count;
+    size_t message_size;
+    int use_constbuffer;
+} SEND_SCENARIO;
+
+static const SEND_SCENARIO scenarios[] =
+{
+    { "small copy", 200000, 64, 0 },
+    { "large copy", 256, 1024 * 1024, 0 },
+    { "large ref", 256, 1024 * 1024, 1 }
+};
+
+typedef struct ROUND_RESULT_TAG
+{
+    uint64_t send_cpu_ns;
+    uint64_t drain_ns;
+    uint64_t drain_cpu_ns;
+    size_t queued_count;
+} ROUND_RESULT;
+
+typedef struct PEER_TAG
+{
+    int socket;
+    size_t expected_size;
+    size_t received_size;
+} PEER;
+
+static size_t completed_count;
+static size_t failed_count;
+static size_t out_of_order_count;
+static size_t io_error_count;
+
+static void on_send_complete(void* context, IO_SEND_RESULT send_result)
+{
+    /* the context is the index of the message, the completions have to come in the order of the sends */
+    if ((size_t)(uintptr_t)context != completed_count + failed_count)
+    {
+        out_of_order_count++;
+    }
+
+    if (send_result == IO_SEND_OK)
+    {
+        completed_count++;
+    }
+    else
+    {
+        failed_count++;
+    }
+}
+
+static void on_io_open_complete(void* context, IO_OPEN_RESULT_DETAILED open_result)
+{
+    *(IO_OPEN_RESULT*)context = open_result.result;
+}
+
+/* the connect is finished by socketio_dowork */
+static int wait_for_open(CONCRETE_IO_HANDLE socket_io, const IO_OPEN_RESULT* open_result)
+{
+    uint64_t deadline_ns = perf_timer_get_ns() + (uint64_t)OPEN_TIMEOUT_MS * 1000000;
+
+    while ((*open_result == IO_OPEN_CANCELLED) && (perf_timer_get_ns() < deadline_ns))
+    {
+        socketio_dowork(socket_io);
+    }
+
+    return (*open_result == IO_OPEN_OK) ? 0 : __LINE__;
+}
+
+static void on_bytes_received(void* context, const unsigned char* buffer, size_t size)
+{
+    (void)context;
+    (void)buffer;
+    (void)size;
+}
+
+static void on_io_error(void* context)
+{
+    (void)context;
+    io_error_count++;
+}
+
+static uint64_t get_thread_cpu_ns(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static int create_listen_socket(int* port)
+{
+    int result = socket(AF_INET, SOCK_STREAM, 0);
+    if (result != -1)
+    {
+        struct sockaddr_in address;
+        socklen_t address_length = sizeof(address);
+        (void)memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+
+        if ((bind(result, (struct sockaddr*)&address, sizeof(address)) != 0) ||
+            (listen(result, SOMAXCONN) != 0) ||
+            (getsockname(result, (struct sockaddr*)&address, &address_length) != 0))
+        {
+            (void)close(result);
+            result = -1;
+        }
+        else
+        {
+            *port = ntohs(address.sin_port);
+        }
+    }
+    return result;
+}
+
+static int peer_read(void* arg)
+{
+    PEER* peer = (PEER*)arg;
+    unsigned char buffer[RECEIVE_BUFFER_SIZE];
+
+    while (peer->received_size < peer->expected_size)
+    {
+        ssize_t received = recv(peer->socket, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+        {
+            break;
+        }
+        peer->received_size += (size_t)received;
+    }
+
+    return 0;
+}
+
+static void free_nothing(void* context)
+{
+    (void)context;
+}
+
+static int send_message(CONCRETE_IO_HANDLE socket_io, const unsigned char* message, size_t message_size, int use_constbuffer, size_t index)
+{
+    int result;
+
+    if (!use_constbuffer)
+    {
+        result = socketio_send(socket_io, message, message_size, on_send_complete, (void*)(uintptr_t)index);
+    }
+    else
+    {
+        /* the message is owned by the caller, the socket IO keeps a reference to the constbuffer instead of copying what it cannot send at once */
+        CONSTBUFFER_HANDLE constbuffer = CONSTBUFFER_CreateWithCustomFree(message, message_size, free_nothing, NULL);
+        if (constbuffer == NULL)
+        {
+            result = __LINE__;
+        }
+        else
+        {
+            result = socketio_send_constbuffer(socket_io, constbuffer, on_send_complete, (void*)(uintptr_t)index);
+            CONSTBUFFER_Destroy(constbuffer);
+        }
+    }
+
+    return result;
+}
+
+static int measure_round(CONCRETE_IO_HANDLE socket_io, int peer_socket, const SEND_SCENARIO* scenario, const unsigned char* message, ROUND_RESULT* round_result)
+{
+    int result = 0;
+    PEER peer;
+    THREAD_HANDLE peer_thread;
+    uint64_t start_cpu_ns;
+    size_t i;
+
+    completed_count = 0;
+    failed_count = 0;
+
+    /* the peer does not read yet: the socket buffers fill up and the rest of the messages are queued */
+    start_cpu_ns = get_thread_cpu_ns();
+    for (i = 0; i < scenario->message_count; i++)
+    {
+        if (send_message(socket_io, message, scenario->message_size, scenario->use_constbuffer, i) != 0)
+        {
+            (void)printf("sending a message failed\r\n");
+            result = __LINE__;
+            break;
+        }
+    }
+    round_result->send_cpu_ns = get_thread_cpu_ns() - start_cpu_ns;
+
+    if (result == 0)
+    {
+        round_result->queued_count = scenario->message_count - completed_count;
+
+        peer.socket = peer_socket;
+        peer.expected_size = scenario->message_count * scenario->message_size;
+        peer.received_size = 0;
+
+        if (ThreadAPI_Create(&peer_thread, peer_read, &peer) != THREADAPI_OK)
+        {
+            (void)printf("Cannot create the peer thread\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            uint64_t start_ns = perf_timer_get_ns();
+            uint64_t deadline_ns = start_ns + (uint64_t)DRAIN_TIMEOUT_MS * 1000000;
+            int thread_result;
+
+            start_cpu_ns = get_thread_cpu_ns();
+            while ((completed_count + failed_count < scenario->message_count) && (perf_timer_get_ns() < deadline_ns))
+            {
+                socketio_dowork(socket_io);
+            }
+
+            round_result->drain_cpu_ns = get_thread_cpu_ns() - start_cpu_ns;
+            (void)ThreadAPI_Join(peer_thread, &thread_result);
+            round_result->drain_ns = perf_timer_get_ns() - start_ns;
+
+            if ((completed_count != scenario->message_count) || (out_of_order_count != 0) || (peer.received_size != peer.expected_size))
+            {
+                (void)printf("%lu of %lu messages completed, %lu failed, %lu out of order, %lu of %lu bytes received\r\n",
+                    (unsigned long)completed_count, (unsigned long)scenario->message_count, (unsigned long)failed_count, (unsigned long)out_of_order_count,
+                    (unsigned long)peer.received_size, (unsigned long)peer.expected_size);
+                result = __LINE__;
+            }
+        }
+    }
+
+    return result;
+}
+
+static int measure(CONCRETE_IO_HANDLE socket_io, int peer_socket, const SEND_SCENARIO* scenario)
+{
+    int result = 0;
+    unsigned char* message = (unsigned char*)malloc(scenario->message_size);
+
+    if (message == NULL)
+    {
+        (void)printf("Cannot allocate the message\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        ROUND_RESULT total = { 0, 0, 0, 0 };
+        size_t round;
+
+        (void)memset(message, 'x', scenario->message_size);
+
+        for (round = 0; round < ROUND_COUNT; round++)
+        {
+            ROUND_RESULT round_result;
+            if ((result = measure_round(socket_io, peer_socket, scenario, message, &round_result)) != 0)
+            {
+                break;
+            }
+            total.send_cpu_ns += round_result.send_cpu_ns;
+            total.drain_ns += round_result.drain_ns;
+            total.drain_cpu_ns += round_result.drain_cpu_ns;
+            total.queued_count += round_result.queued_count;
+        }
+
+        if (result == 0)
+        {
+            size_t message_count = scenario->message_count * ROUND_COUNT;
+            double megabytes = (double)message_count * (double)scenario->message_size / (1024.0 * 1024.0);
+            (void)printf("%-12s %-28s %7lu x %7lu bytes, %7lu queued: %8.2f ms sending, %8.2f ms drain, %7.1f MB/s, %10.0f messages/s, %9.3f us CPU/message\r\n",
+                scenario->name, IOVECS_LABEL, (unsigned long)message_count, (unsigned long)scenario->message_size, (unsigned long)total.queued_count,
+                (double)total.send_cpu_ns / 1000000.0, (double)total.drain_ns / 1000000.0,
+                megabytes * 1000000000.0 / (double)(total.send_cpu_ns + total.drain_ns),
+                (double)message_count * 1000000000.0 / (double)total.drain_ns,
+                (double)(total.send_cpu_ns + total.drain_cpu_ns) / 1000.0 / (double)message_count);
+        }
+
+        free(message);
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    int result = 0;
+    int port;
+    int listen_socket;
+
+    if ((listen_socket = create_listen_socket(&port)) == -1)
+    {
+        (void)printf("Cannot create the listening socket\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        CONCRETE_IO_HANDLE socket_io;
+        SOCKETIO_CONFIG config;
+        config.hostname = "127.0.0.1";
+        config.port = port;
+        config.accepted_socket = NULL;
+
+        if ((socket_io = socketio_create(&config)) == NULL)
+        {
+            (void)printf("socketio_create failed\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            int peer_socket;
+            /* IO_OPEN_CANCELLED until the open completes */
+            IO_OPEN_RESULT open_result = IO_OPEN_CANCELLED;
+
+            if (socketio_open(socket_io, on_io_open_complete, &open_result, on_bytes_received, NULL, on_io_error, NULL) != 0)
+            {
+                (void)printf("socketio_open failed\r\n");
+                result = __LINE__;
+            }
+            else
+            {
+                if ((peer_socket = accept(listen_socket, NULL, NULL)) == -1)
+                {
+                    (void)printf("accept failed\r\n");
+                    result = __LINE__;
+                }
+                else if (wait_for_open(socket_io, &open_result) != 0)
+                {
+                    (void)printf("the open did not complete\r\n");
+                    (void)close(peer_socket);
+                    result = __LINE__;
+                }
+                else
+                {
+                    size_t i;
+                    for (i = 0; (result == 0) && (i < sizeof(scenarios) / sizeof(scenarios[0])); i++)
+                    {
+                        result = measure(socket_io, peer_socket, &scenarios[i]);
+                    }
+                    (void)printf("errors: %lu\r\n", (unsigned long)io_error_count);
+
+                    (void)close(peer_socket);
+                }
+
+                (void)socketio_close(socket_io, NULL, NULL);
+            }
+
+            socketio_destroy(socket_io);
+        }
+
+        (void)close(listen_socket);
+    }
+
+    return result;
+}
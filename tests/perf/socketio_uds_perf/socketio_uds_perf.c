@@ -0,0 +1,343 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "perf_timer.h"
+
+/* measures small request/response exchanges with a local server over loopback TCP and over a Unix domain socket, the unix_socket_path
+   option of the socket IO. A thread per listener answers every request, the bytes up to an empty line, with a 2 bytes response.
+   REQUEST_COUNT exchanges are made on one socket IO, sending the request and running socketio_dowork until the whole response came
+   back, which is the latency of the transport. tcp_nodelay is set so that the TCP numbers are not those of Nagle's algorithm, the socket
+   IO ignores it on a Unix domain socket. httpapi_compact is not measured: it sleeps 10 ms whenever the response is not there yet, its
+   exchanges would measure the sleep rather than the transport. The mean, median and 99th percentile of the exchanges are reported. */
+
+#define REQUEST_COUNT 20000
+#define RUN_TIMEOUT_MS 10000
+#define SERVER_BUFFER_SIZE 4096
+
+static const char request[] = "GET /perf HTTP/1.1\r\nHost: localhost\r\n\r\n";
+static const char response[] = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+
+typedef struct SERVER_TAG
+{
+    int listen_socket;
+    volatile int is_stopping;
+} SERVER;
+
+typedef struct CLIENT_TAG
+{
+    int is_open_completed;
+    IO_OPEN_RESULT open_result;
+    size_t received_size;
+    size_t io_error_count;
+} CLIENT;
+
+static void on_io_open_complete(void* context, IO_OPEN_RESULT_DETAILED open_result)
+{
+    CLIENT* client = (CLIENT*)context;
+    client->open_result = open_result.result;
+    client->is_open_completed = 1;
+}
+
+static void on_bytes_received(void* context, const unsigned char* buffer, size_t size)
+{
+    CLIENT* client = (CLIENT*)context;
+    (void)buffer;
+    client->received_size += size;
+}
+
+static void on_io_error(void* context)
+{
+    CLIENT* client = (CLIENT*)context;
+    client->io_error_count++;
+}
+
+/* answers the requests of one accepted connection until it is closed */
+static void serve_connection(int peer)
+{
+    static const char terminator[] = "\r\n\r\n";
+    char buffer[SERVER_BUFFER_SIZE];
+    size_t matched = 0;
+    ssize_t received;
+
+    while ((received = recv(peer, buffer, sizeof(buffer), 0)) > 0)
+    {
+        ssize_t i;
+        for (i = 0; i < received; i++)
+        {
+            matched = (buffer[i] == terminator[matched]) ? matched + 1 : ((buffer[i] == terminator[0]) ? 1 : 0);
+            if (matched == sizeof(terminator) - 1)
+            {
+                matched = 0;
+                if (send(peer, response, sizeof(response) - 1, MSG_NOSIGNAL) != (ssize_t)(sizeof(response) - 1))
+                {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+static int serve(void* context)
+{
+    SERVER* server = (SERVER*)context;
+    while (!server->is_stopping)
+    {
+        int peer = accept(server->listen_socket, NULL, NULL);
+        if (peer != -1)
+        {
+            serve_connection(peer);
+            (void)close(peer);
+        }
+    }
+    return 0;
+}
+
+static int create_tcp_listen_socket(int* port)
+{
+    int result = socket(AF_INET, SOCK_STREAM, 0);
+    if (result != -1)
+    {
+        struct sockaddr_in address;
+        socklen_t address_length = sizeof(address);
+        (void)memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+
+        if ((bind(result, (struct sockaddr*)&address, sizeof(address)) != 0) ||
+            (listen(result, SOMAXCONN) != 0) ||
+            (getsockname(result, (struct sockaddr*)&address, &address_length) != 0))
+        {
+            (void)close(result);
+            result = -1;
+        }
+        else
+        {
+            *port = ntohs(address.sin_port);
+        }
+    }
+    return result;
+}
+
+static int create_unix_listen_socket(const char* path)
+{
+    int result = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (result != -1)
+    {
+        struct sockaddr_un address;
+        (void)memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        (void)strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+        (void)unlink(path);
+
+        if ((bind(result, (struct sockaddr*)&address, sizeof(address)) != 0) ||
+            (listen(result, SOMAXCONN) != 0))
+        {
+            (void)close(result);
+            result = -1;
+        }
+    }
+    return result;
+}
+
+static int compare_ns(const void* left, const void* right)
+{
+    uint64_t left_ns = *(const uint64_t*)left;
+    uint64_t right_ns = *(const uint64_t*)right;
+    return (left_ns < right_ns) ? -1 : ((left_ns > right_ns) ? 1 : 0);
+}
+
+static void print_latencies(const char* transport, uint64_t* latencies_ns, size_t count)
+{
+    uint64_t total_ns = 0;
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        total_ns += latencies_ns[i];
+    }
+    qsort(latencies_ns, count, sizeof(uint64_t), compare_ns);
+
+    (void)printf("%-4s %6lu exchanges: mean %10.1f us, p50 %10.1f us, p99 %10.1f us\r\n", transport, (unsigned long)count,
+        (double)total_ns / (double)count / 1000.0, (double)latencies_ns[count / 2] / 1000.0, (double)latencies_ns[(count * 99) / 100] / 1000.0);
+}
+
+static int measure_socket_io(const char* transport, int port, const char* unix_socket_path, uint64_t* latencies_ns)
+{
+    int result = 0;
+    CLIENT client;
+    SOCKETIO_CONFIG config;
+    CONCRETE_IO_HANDLE socket_io;
+    int tcp_nodelay = 1;
+    config.hostname = "127.0.0.1";
+    config.port = port;
+    config.accepted_socket = NULL;
+    (void)memset(&client, 0, sizeof(client));
+
+    if ((socket_io = socketio_create(&config)) == NULL)
+    {
+        (void)printf("socketio_create failed\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        uint64_t deadline_ns = perf_timer_get_ns() + (uint64_t)RUN_TIMEOUT_MS * 1000000;
+
+        if (((unix_socket_path != NULL) && (socketio_setoption(socket_io, OPTION_UNIX_SOCKET_PATH, unix_socket_path) != 0)) ||
+            (socketio_open(socket_io, on_io_open_complete, &client, on_bytes_received, &client, on_io_error, &client) != 0))
+        {
+            (void)printf("socketio_open failed\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            while (!client.is_open_completed && (perf_timer_get_ns() < deadline_ns))
+            {
+                socketio_dowork(socket_io);
+            }
+
+            if (!client.is_open_completed || (client.open_result != IO_OPEN_OK))
+            {
+                (void)printf("the %s socket IO did not open\r\n", transport);
+                result = __LINE__;
+            }
+            else if (socketio_setoption(socket_io, "tcp_nodelay", &tcp_nodelay) != 0)
+            {
+                (void)printf("socketio_setoption failed\r\n");
+                result = __LINE__;
+            }
+            else
+            {
+                size_t i;
+                for (i = 0; (result == 0) && (i < REQUEST_COUNT); i++)
+                {
+                    size_t expected_size = (i + 1) * (sizeof(response) - 1);
+                    uint64_t start_ns = perf_timer_get_ns();
+
+                    if (socketio_send(socket_io, request, sizeof(request) - 1, NULL, NULL) != 0)
+                    {
+                        (void)printf("socketio_send failed\r\n");
+                        result = __LINE__;
+                    }
+                    else
+                    {
+                        while ((client.received_size < expected_size) && (client.io_error_count == 0) && (perf_timer_get_ns() < deadline_ns))
+                        {
+                            socketio_dowork(socket_io);
+                        }
+
+                        if (client.received_size < expected_size)
+                        {
+                            (void)printf("exchange %lu: no response\r\n", (unsigned long)i);
+                            result = __LINE__;
+                        }
+                        else
+                        {
+                            latencies_ns[i] = perf_timer_get_ns() - start_ns;
+                        }
+                    }
+                }
+
+                if (result == 0)
+                {
+                    print_latencies(transport, latencies_ns, REQUEST_COUNT);
+                }
+            }
+
+            (void)socketio_close(socket_io, NULL, NULL);
+        }
+
+        socketio_destroy(socket_io);
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    int result = 0;
+    SERVER tcp_server;
+    SERVER unix_server;
+    THREAD_HANDLE tcp_thread;
+    THREAD_HANDLE unix_thread;
+    char unix_socket_path[64];
+    int port;
+    int thread_result;
+    uint64_t* latencies_ns;
+
+    (void)snprintf(unix_socket_path, sizeof(unix_socket_path), "/tmp/socketio_uds_perf_%d.sock", (int)getpid());
+    tcp_server.is_stopping = 0;
+    unix_server.is_stopping = 0;
+
+    if ((latencies_ns = (uint64_t*)malloc(sizeof(uint64_t) * REQUEST_COUNT)) == NULL)
+    {
+        (void)printf("Cannot allocate the latencies\r\n");
+        result = __LINE__;
+    }
+    else if ((tcp_server.listen_socket = create_tcp_listen_socket(&port)) == -1)
+    {
+        (void)printf("Cannot create the TCP listening socket\r\n");
+        free(latencies_ns);
+        result = __LINE__;
+    }
+    else if ((unix_server.listen_socket = create_unix_listen_socket(unix_socket_path)) == -1)
+    {
+        (void)printf("Cannot create the Unix domain listening socket\r\n");
+        (void)close(tcp_server.listen_socket);
+        free(latencies_ns);
+        result = __LINE__;
+    }
+    else
+    {
+        if (ThreadAPI_Create(&tcp_thread, serve, &tcp_server) != THREADAPI_OK)
+        {
+            (void)printf("Cannot create the TCP server thread\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            if (ThreadAPI_Create(&unix_thread, serve, &unix_server) != THREADAPI_OK)
+            {
+                (void)printf("Cannot create the Unix domain server thread\r\n");
+                result = __LINE__;
+            }
+            else
+            {
+                (void)printf("%d socket IO exchanges of %d request bytes and %d response bytes\r\n",
+                    REQUEST_COUNT, (int)(sizeof(request) - 1), (int)(sizeof(response) - 1));
+                if ((result = measure_socket_io("tcp", port, NULL, latencies_ns)) == 0)
+                {
+                    result = measure_socket_io("uds", port, unix_socket_path, latencies_ns);
+                }
+
+                /* the server threads are blocked in accept, shutting the listening sockets down wakes them */
+                unix_server.is_stopping = 1;
+                (void)shutdown(unix_server.listen_socket, SHUT_RDWR);
+                (void)ThreadAPI_Join(unix_thread, &thread_result);
+            }
+
+            tcp_server.is_stopping = 1;
+            (void)shutdown(tcp_server.listen_socket, SHUT_RDWR);
+            (void)ThreadAPI_Join(tcp_thread, &thread_result);
+        }
+
+        (void)close(unix_server.listen_socket);
+        (void)unlink(unix_socket_path);
+        (void)close(tcp_server.listen_socket);
+        free(latencies_ns);
+    }
+
+    return result;
+}
@@ -0,0 +1,425 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/socketio_event_loop.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "perf_timer.h"
+
+/* measures the socket IO compiled in, socketio_uring_perf runs the io_uring one and socketio_uring_perf_berkeley the Berkeley sockets one.
+   CONNECTION_COUNT socket IOs of one event loop are connected to loopback peers that a thread echoes with epoll. Each round every socket IO
+   sends BURST_COUNT messages of MESSAGE_SIZE bytes and the loop runs until all of them came back, so that the thread of the loop does the
+   sends, the receives and the dispatch of the completions. The throughput of the messages, the CPU of the thread of the loop per message,
+   and the context switches of the process, from getrusage, are reported. */
+
+#define MESSAGE_SIZE 128
+#define BURST_COUNT 16
+#define ROUND_COUNT 20
+#define RUN_TIMEOUT_MS 30000
+#define ECHO_BUFFER_SIZE 65536
+/* descriptors kept for the process besides the connections */
+#define RESERVED_FILE_COUNT 64
+
+static const size_t connection_counts[] = { 100, 1000, 5000 };
+
+typedef struct CONNECTION_TAG
+{
+    CONCRETE_IO_HANDLE socket_io;
+    int is_open;
+    int peer;
+} CONNECTION;
+
+typedef struct ECHO_TAG
+{
+    int epoll_fd;
+    volatile int is_stopping;
+} ECHO;
+
+static size_t received_size;
+static size_t send_complete_count;
+static size_t open_count;
+static size_t io_error_count;
+
+static void on_io_open_complete(void* context, IO_OPEN_RESULT_DETAILED open_result)
+{
+    CONNECTION* connection = (CONNECTION*)context;
+    connection->is_open = (open_result.result == IO_OPEN_OK) ? 1 : 0;
+    open_count++;
+}
+
+static void on_bytes_received(void* context, const unsigned char* buffer, size_t size)
+{
+    (void)context;
+    (void)buffer;
+    received_size += size;
+}
+
+static void on_io_error(void* context)
+{
+    (void)context;
+    io_error_count++;
+}
+
+static void on_send_complete(void* context, IO_SEND_RESULT send_result)
+{
+    (void)context;
+    (void)send_result;
+    send_complete_count++;
+}
+
+static uint64_t get_thread_cpu_ns(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static long get_context_switch_count(void)
+{
+    struct rusage usage;
+    (void)getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+static int create_listen_socket(int* port)
+{
+    int result = socket(AF_INET, SOCK_STREAM, 0);
+    if (result != -1)
+    {
+        struct sockaddr_in address;
+        socklen_t address_length = sizeof(address);
+        (void)memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+
+        if ((bind(result, (struct sockaddr*)&address, sizeof(address)) != 0) ||
+            (listen(result, SOMAXCONN) != 0) ||
+            (getsockname(result, (struct sockaddr*)&address, &address_length) != 0) ||
+            (fcntl(result, F_SETFL, O_NONBLOCK) != 0))
+        {
+            (void)close(result);
+            result = -1;
+        }
+        else
+        {
+            *port = ntohs(address.sin_port);
+        }
+    }
+    return result;
+}
+
+/* writes back what each peer reads, the sends of a round fit in the socket buffers so the blocking sends do not wait for long */
+static int echo_peers(void* arg)
+{
+    ECHO* echo = (ECHO*)arg;
+    unsigned char* buffer = (unsigned char*)malloc(ECHO_BUFFER_SIZE);
+
+    while ((buffer != NULL) && !echo->is_stopping)
+    {
+        struct epoll_event events[64];
+        int event_count = epoll_wait(echo->epoll_fd, events, 64, 10);
+        int i;
+        for (i = 0; i < event_count; i++)
+        {
+            ssize_t received = recv(events[i].data.fd, buffer, ECHO_BUFFER_SIZE, MSG_DONTWAIT);
+            if (received > 0)
+            {
+                ssize_t sent_size = 0;
+                while (sent_size < received)
+                {
+                    ssize_t sent = send(events[i].data.fd, buffer + sent_size, (size_t)(received - sent_size), MSG_NOSIGNAL);
+                    if (sent <= 0)
+                    {
+                        break;
+                    }
+                    sent_size += sent;
+                }
+            }
+            else if (received == 0)
+            {
+                (void)epoll_ctl(echo->epoll_fd, EPOLL_CTL_DEL, events[i].data.fd, NULL);
+            }
+        }
+    }
+
+    free(buffer);
+    return 0;
+}
+
+static int open_connections(CONNECTION* connections, size_t count, SOCKETIO_EVENT_LOOP_HANDLE event_loop, int listen_socket, int port, int epoll_fd, size_t* opened_count)
+{
+    int result = 0;
+    SOCKETIO_CONFIG config;
+    uint64_t deadline_ns;
+    size_t accepted_count;
+
+    config.hostname = "127.0.0.1";
+    config.port = port;
+    config.accepted_socket = NULL;
+
+    open_count = 0;
+    for (*opened_count = 0; *opened_count < count; (*opened_count)++)
+    {
+        CONNECTION* connection = &connections[*opened_count];
+        connection->is_open = 0;
+        connection->peer = -1;
+        if ((connection->socket_io = socketio_create(&config)) == NULL)
+        {
+            (void)printf("socketio_create failed\r\n");
+            result = __LINE__;
+            break;
+        }
+        else if (socketio_setoption(connection->socket_io, OPTION_EVENT_LOOP, event_loop) != 0)
+        {
+            (void)printf("socketio_setoption failed\r\n");
+            socketio_destroy(connection->socket_io);
+            result = __LINE__;
+            break;
+        }
+        else if (socketio_open(connection->socket_io, on_io_open_complete, connection, on_bytes_received, connection, on_io_error, connection) != 0)
+        {
+            (void)printf("socketio_open failed\r\n");
+            socketio_destroy(connection->socket_io);
+            result = __LINE__;
+            break;
+        }
+    }
+
+    /* the peers are accepted while the opens complete, the listen backlog does not hold thousands of connections. They are not matched
+       with the connections, each one echoes its own socket */
+    accepted_count = 0;
+    deadline_ns = perf_timer_get_ns() + (uint64_t)RUN_TIMEOUT_MS * 1000000;
+    while ((result == 0) && ((open_count < count) || (accepted_count < count)) && (perf_timer_get_ns() < deadline_ns))
+    {
+        int accepted;
+        (void)socketio_event_loop_run_once(event_loop, 1);
+
+        while ((result == 0) && (accepted_count < count) && ((accepted = accept(listen_socket, NULL, NULL)) != -1))
+        {
+            struct epoll_event event;
+            connections[accepted_count].peer = accepted;
+            accepted_count++;
+            event.events = EPOLLIN;
+            event.data.fd = accepted;
+            if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, accepted, &event) != 0)
+            {
+                (void)printf("epoll_ctl failed\r\n");
+                result = __LINE__;
+            }
+        }
+    }
+
+    if ((result == 0) && ((open_count < count) || (accepted_count < count)))
+    {
+        (void)printf("%lu of %lu opens completed, %lu peers accepted\r\n", (unsigned long)open_count, (unsigned long)count, (unsigned long)accepted_count);
+        result = __LINE__;
+    }
+
+    return result;
+}
+
+static void close_connections(CONNECTION* connections, size_t count)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        (void)socketio_close(connections[i].socket_io, NULL, NULL);
+        socketio_destroy(connections[i].socket_io);
+    }
+    for (i = 0; i < count; i++)
+    {
+        if (connections[i].peer != -1)
+        {
+            (void)close(connections[i].peer);
+        }
+    }
+}
+
+static int measure_echo(CONNECTION* connections, size_t count, SOCKETIO_EVENT_LOOP_HANDLE event_loop)
+{
+    int result = 0;
+    unsigned char message[MESSAGE_SIZE];
+    size_t round_size = count * BURST_COUNT * MESSAGE_SIZE;
+    uint64_t deadline_ns;
+    uint64_t start_ns;
+    uint64_t start_cpu_ns;
+    long start_context_switch_count;
+    size_t round;
+
+    (void)memset(message, 'x', sizeof(message));
+    received_size = 0;
+    send_complete_count = 0;
+
+    start_ns = perf_timer_get_ns();
+    start_cpu_ns = get_thread_cpu_ns();
+    start_context_switch_count = get_context_switch_count();
+    deadline_ns = start_ns + (uint64_t)RUN_TIMEOUT_MS * 1000000;
+
+    for (round = 0; (result == 0) && (round < ROUND_COUNT); round++)
+    {
+        size_t i;
+        size_t j;
+        for (i = 0; (result == 0) && (i < count); i++)
+        {
+            for (j = 0; j < BURST_COUNT; j++)
+            {
+                if (socketio_send(connections[i].socket_io, message, sizeof(message), on_send_complete, NULL) != 0)
+                {
+                    (void)printf("socketio_send failed\r\n");
+                    result = __LINE__;
+                    break;
+                }
+            }
+        }
+
+        while ((result == 0) && ((received_size < round_size * (round + 1)) || (send_complete_count < count * BURST_COUNT * (round + 1))) &&
+            (io_error_count == 0) && (perf_timer_get_ns() < deadline_ns))
+        {
+            (void)socketio_event_loop_run_once(event_loop, 10);
+        }
+
+        if ((result == 0) && (received_size < round_size * (round + 1)))
+        {
+            (void)printf("round %lu: %lu of %lu bytes echoed\r\n", (unsigned long)round, (unsigned long)received_size, (unsigned long)(round_size * (round + 1)));
+            result = __LINE__;
+        }
+    }
+
+    if (result == 0)
+    {
+        double message_count = (double)count * BURST_COUNT * ROUND_COUNT;
+        uint64_t elapsed_ns = perf_timer_get_ns() - start_ns;
+        (void)printf("%5lu connections: %8.0f messages/s, %6.2f MB/s, %7.0f ns CPU/message, %8.3f context switches/message\r\n",
+            (unsigned long)count, message_count * 1000000000.0 / (double)elapsed_ns,
+            message_count * MESSAGE_SIZE * 1000.0 / 1024.0 / 1024.0 / ((double)elapsed_ns / 1000000.0),
+            (double)(get_thread_cpu_ns() - start_cpu_ns) / message_count,
+            (double)(get_context_switch_count() - start_context_switch_count) / message_count);
+    }
+
+    return result;
+}
+
+static int run_connection_count(CONNECTION* connections, size_t count, int listen_socket, int port)
+{
+    int result;
+    ECHO echo;
+    THREAD_HANDLE echo_thread;
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop;
+
+    if ((echo.epoll_fd = epoll_create1(0)) == -1)
+    {
+        (void)printf("epoll_create1 failed\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        echo.is_stopping = 0;
+        if ((event_loop = socketio_event_loop_create()) == NULL)
+        {
+            (void)printf("socketio_event_loop_create failed\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            if (ThreadAPI_Create(&echo_thread, echo_peers, &echo) != THREADAPI_OK)
+            {
+                (void)printf("Cannot create the echo thread\r\n");
+                result = __LINE__;
+            }
+            else
+            {
+                size_t opened_count;
+                int thread_result;
+
+                if ((result = open_connections(connections, count, event_loop, listen_socket, port, echo.epoll_fd, &opened_count)) == 0)
+                {
+                    result = measure_echo(connections, count, event_loop);
+                }
+
+                echo.is_stopping = 1;
+                (void)ThreadAPI_Join(echo_thread, &thread_result);
+                close_connections(connections, opened_count);
+            }
+
+            socketio_event_loop_destroy(event_loop);
+        }
+
+        (void)close(echo.epoll_fd);
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    int result = 0;
+    int port;
+    int listen_socket;
+    struct rlimit file_limit;
+    size_t max_connection_count;
+    CONNECTION* connections;
+
+    /* every connection takes a descriptor on each side */
+    if (getrlimit(RLIMIT_NOFILE, &file_limit) == 0)
+    {
+        file_limit.rlim_cur = file_limit.rlim_max;
+        (void)setrlimit(RLIMIT_NOFILE, &file_limit);
+        (void)getrlimit(RLIMIT_NOFILE, &file_limit);
+    }
+    max_connection_count = (file_limit.rlim_cur > RESERVED_FILE_COUNT) ? (size_t)((file_limit.rlim_cur - RESERVED_FILE_COUNT) / 2) : 0;
+
+    if ((listen_socket = create_listen_socket(&port)) == -1)
+    {
+        (void)printf("Cannot create the listening socket\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        if ((connections = (CONNECTION*)malloc(sizeof(CONNECTION) * connection_counts[sizeof(connection_counts) / sizeof(connection_counts[0]) - 1])) == NULL)
+        {
+            (void)printf("Cannot allocate the connections\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            size_t i;
+            (void)printf("%s socket IO, %d rounds of %d messages of %d bytes per connection\r\n",
+                SOCKETIO_PERF_ADAPTER_NAME, ROUND_COUNT, BURST_COUNT, MESSAGE_SIZE);
+
+            for (i = 0; (result == 0) && (i < sizeof(connection_counts) / sizeof(connection_counts[0])); i++)
+            {
+                size_t count = connection_counts[i];
+                if (count > max_connection_count)
+                {
+                    (void)printf("%lu connections capped to %lu by the open file limit of %lu\r\n",
+                        (unsigned long)count, (unsigned long)max_connection_count, (unsigned long)file_limit.rlim_cur);
+                    count = max_connection_count;
+                }
+                result = run_connection_count(connections, count, listen_socket, port);
+            }
+            (void)printf("errors: %lu\r\n", (unsigned long)io_error_count);
+
+            free(connections);
+        }
+
+        (void)close(listen_socket);
+    }
+
+    return result;
+}
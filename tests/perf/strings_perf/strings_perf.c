@@ -0,0 +1,210 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/strings.h"
+#include "perf_timer.h"
+
+/* measures the two most common ways STRING_HANDLEs are built in the SDK:
+   "sas" builds a SAS token the way construct_sas_token in sastoken.c does it,
+   "headers" builds "name: value" header lines the way the HTTP header code does it.
+   Only the API that predates STRING_reserve is used so that the numbers can be compared against older strings.c. */
+
+#define ITERATION_COUNT 200000
+
+static const char* scope = "myhub.azure-devices.net/devices/mydevice";
+static const char* expiry = "1500000000";
+static const char* keyname = "iothubowner";
+static const char* signature = "dGhpcyBpcyBub3QgYSByZWFsIHNpZ25hdHVyZQ%3d%3d";
+
+static const char* headers[][2] =
+{
+    { "Authorization", "SharedAccessSignature sr=myhub.azure-devices.net&sig=dGhpcyBpcyBub3QgYSByZWFsIHNpZ25hdHVyZQ%3d%3d&se=1500000000&skn=iothubowner" },
+    { "Content-Type", "application/json" },
+    { "Accept", "application/json" },
+    { "User-Agent", "iothubclient/1.1.0" },
+    { "Host", "myhub.azure-devices.net" },
+    { "If-Match", "\"AAAAAAAAAAE=\"" }
+};
+
+#define HEADER_COUNT (sizeof(headers) / sizeof(headers[0]))
+
+static size_t total_length;
+
+static void print_result(const char* workload, size_t operation_count, uint64_t elapsed_ns, size_t allocation_count)
+{
+    (void)printf("%-7s %7lu operations: %8.2f ms, %7.1f ns/operation, %5.2f allocations/operation\r\n",
+        workload, (unsigned long)operation_count, (double)elapsed_ns / 1000000.0,
+        (double)elapsed_ns / (double)operation_count, (double)allocation_count / (double)operation_count);
+}
+
+static int build_sas_token(void)
+{
+    int result;
+    STRING_HANDLE to_be_hashed;
+    STRING_HANDLE sas_token;
+    STRING_HANDLE url_encoded_signature;
+
+    if ((to_be_hashed = STRING_new()) == NULL)
+    {
+        result = __LINE__;
+    }
+    else
+    {
+        if ((sas_token = STRING_new()) == NULL)
+        {
+            result = __LINE__;
+        }
+        else
+        {
+            if ((STRING_concat(to_be_hashed, scope) != 0) ||
+                (STRING_concat(to_be_hashed, "\n") != 0) ||
+                (STRING_concat(to_be_hashed, expiry) != 0))
+            {
+                result = __LINE__;
+            }
+            else if ((url_encoded_signature = STRING_construct(signature)) == NULL)
+            {
+                result = __LINE__;
+            }
+            else
+            {
+                if ((STRING_copy(sas_token, "SharedAccessSignature sr=") != 0) ||
+                    (STRING_concat(sas_token, scope) != 0) ||
+                    (STRING_concat(sas_token, "&sig=") != 0) ||
+                    (STRING_concat_with_STRING(sas_token, url_encoded_signature) != 0) ||
+                    (STRING_concat(sas_token, "&se=") != 0) ||
+                    (STRING_concat(sas_token, expiry) != 0) ||
+                    (STRING_concat(sas_token, "&skn=") != 0) ||
+                    (STRING_concat(sas_token, keyname) != 0))
+                {
+                    result = __LINE__;
+                }
+                else
+                {
+                    total_length += STRING_length(sas_token) + STRING_length(to_be_hashed);
+                    result = 0;
+                }
+
+                STRING_delete(url_encoded_signature);
+            }
+
+            STRING_delete(sas_token);
+        }
+
+        STRING_delete(to_be_hashed);
+    }
+
+    return result;
+}
+
+static int build_header(const char* name, const char* value)
+{
+    int result;
+    STRING_HANDLE header;
+
+    if ((header = STRING_construct(name)) == NULL)
+    {
+        result = __LINE__;
+    }
+    else
+    {
+        if ((STRING_concat(header, ": ") != 0) ||
+            (STRING_concat(header, value) != 0))
+        {
+            result = __LINE__;
+        }
+        else
+        {
+            total_length += STRING_length(header);
+            result = 0;
+        }
+
+        STRING_delete(header);
+    }
+
+    return result;
+}
+
+static int measure_sas(void)
+{
+    int result = 0;
+    size_t i;
+    uint64_t start_ns;
+    uint64_t end_ns;
+
+    gballoc_resetMetrics();
+
+    start_ns = perf_timer_get_ns();
+    for (i = 0; (result == 0) && (i < ITERATION_COUNT); i++)
+    {
+        result = build_sas_token();
+    }
+    end_ns = perf_timer_get_ns();
+
+    if (result != 0)
+    {
+        (void)printf("building the SAS token failed\r\n");
+    }
+    else
+    {
+        print_result("sas", ITERATION_COUNT, end_ns - start_ns, gballoc_getAllocationCount());
+    }
+
+    return result;
+}
+
+static int measure_headers(void)
+{
+    int result = 0;
+    size_t i;
+    uint64_t start_ns;
+    uint64_t end_ns;
+
+    gballoc_resetMetrics();
+
+    start_ns = perf_timer_get_ns();
+    for (i = 0; (result == 0) && (i < ITERATION_COUNT * HEADER_COUNT); i++)
+    {
+        result = build_header(headers[i % HEADER_COUNT][0], headers[i % HEADER_COUNT][1]);
+    }
+    end_ns = perf_timer_get_ns();
+
+    if (result != 0)
+    {
+        (void)printf("building the header failed\r\n");
+    }
+    else
+    {
+        print_result("headers", ITERATION_COUNT * HEADER_COUNT, end_ns - start_ns, gballoc_getAllocationCount());
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    int result;
+
+    if (gballoc_init() != 0)
+    {
+        (void)printf("Cannot initialize gballoc\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        if ((result = measure_sas()) == 0)
+        {
+            result = measure_headers();
+        }
+
+        /* keeps the compiler from discarding the work */
+        (void)printf("total length: %lu\r\n", (unsigned long)total_length);
+
+        gballoc_deinit();
+    }
+
+    return result;
+}
@@ -43,6 +43,12 @@ void my_gballoc_free(void* ptr)
     free(ptr);
 }
 
+/* used by the slab hooks, which are defined after free is mapped to the gballoc_free mock */
+static void* real_malloc(size_t size)
+{
+    return malloc(size);
+}
+
 #include "umock_c.h"
 #include "umocktypes_bool.h"
 #include "azure_c_shared_utility/singlylinkedlist.h"
@@ -54,9 +60,58 @@ MOCK_FUNCTION_WITH_CODE(, bool, test_match_function, LIST_ITEM_HANDLE, list_item
 MOCK_FUNCTION_END(true);
 
 #include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/slab.h"
 
 #undef ENABLE_MOCKS
 
+#define TEST_SLAB_HANDLE ((SLAB_HANDLE)0x4243)
+
+/* the slab hooks keep track of the objects they hand out so that slab_destroy can release the ones still in use, like the real slab does */
+#define TEST_SLAB_MAX_OBJECTS 16
+#define TEST_SLAB_OBJECT_SIZE 64
+static void* test_slab_objects[TEST_SLAB_MAX_OBJECTS];
+
+static void* my_slab_malloc(SLAB_HANDLE slab)
+{
+    void* result = NULL;
+    size_t i;
+    (void)slab;
+    for (i = 0; i < TEST_SLAB_MAX_OBJECTS; i++)
+    {
+        if (test_slab_objects[i] == NULL)
+        {
+            result = real_malloc(TEST_SLAB_OBJECT_SIZE);
+            test_slab_objects[i] = result;
+            break;
+        }
+    }
+    return result;
+}
+
+static void my_slab_free(SLAB_HANDLE slab, void* ptr)
+{
+    size_t i;
+    (void)slab;
+    for (i = 0; i < TEST_SLAB_MAX_OBJECTS; i++)
+    {
+        if ((ptr != NULL) && (test_slab_objects[i] == ptr))
+        {
+            my_gballoc_free(ptr);
+            test_slab_objects[i] = NULL;
+            break;
+        }
+    }
+}
+
+static void my_slab_destroy(SLAB_HANDLE slab)
+{
+    size_t i;
+    for (i = 0; i < TEST_SLAB_MAX_OBJECTS; i++)
+    {
+        my_slab_free(slab, test_slab_objects[i]);
+    }
+}
+
 static TEST_MUTEX_HANDLE test_serialize_mutex;
 static TEST_MUTEX_HANDLE g_dllByDll;
 
@@ -88,9 +143,14 @@ TEST_SUITE_INITIALIZE(suite_init)
     ASSERT_ARE_EQUAL(int, 0, result);
 
     REGISTER_UMOCK_ALIAS_TYPE(LIST_ITEM_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(SLAB_HANDLE, void*);
 
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+    REGISTER_GLOBAL_MOCK_RETURN(slab_create, TEST_SLAB_HANDLE);
+    REGISTER_GLOBAL_MOCK_HOOK(slab_malloc, my_slab_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(slab_free, my_slab_free);
+    REGISTER_GLOBAL_MOCK_HOOK(slab_destroy, my_slab_destroy);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -119,6 +179,7 @@ TEST_FUNCTION_CLEANUP(method_cleanup)
 /* singlylinkedlist_create */
 
 /* Tests_SRS_LIST_01_001: [singlylinkedlist_create shall create a new list and return a non-NULL handle on success.] */
+/* Tests_SRS_LIST_03_001: [singlylinkedlist_create shall not create the slab for the list nodes, so that a list that never has an item added does not hold a slab.] */
 TEST_FUNCTION(when_underlying_calls_succeed_singlylinkedlist_create_succeeds)
 {
     // arrange
@@ -155,7 +216,29 @@ TEST_FUNCTION(when_underlying_malloc_fails_singlylinkedlist_create_fails)
 /* singlylinkedlist_destroy */
 
 /* Tests_SRS_LIST_01_003: [singlylinkedlist_destroy shall free all resources associated with the list identified by the handle argument.] */
+/* Tests_SRS_LIST_03_002: [If the slab for the list nodes was created, singlylinkedlist_destroy shall free all the nodes at once by calling slab_destroy.] */
 TEST_FUNCTION(singlylinkedlist_destroy_on_a_non_null_handle_frees_resources)
+{
+    // arrange
+    int x1 = 0x42;
+    int x2 = 0x43;
+    SINGLYLINKEDLIST_HANDLE handle = singlylinkedlist_create();
+    (void)singlylinkedlist_add(handle, &x1);
+    (void)singlylinkedlist_add(handle, &x2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(slab_destroy(TEST_SLAB_HANDLE));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    singlylinkedlist_destroy(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_LIST_03_002: [If the slab for the list nodes was created, singlylinkedlist_destroy shall free all the nodes at once by calling slab_destroy.] */
+TEST_FUNCTION(singlylinkedlist_destroy_on_a_list_that_never_had_items_frees_only_the_list)
 {
     // arrange
     SINGLYLINKEDLIST_HANDLE handle = singlylinkedlist_create();
@@ -219,6 +302,8 @@ TEST_FUNCTION(singlylinkedlist_add_with_NULL_item_fails)
 
 /* Tests_SRS_LIST_01_005: [singlylinkedlist_add shall add one item to the tail of the list and on success it shall return a handle to the added item.] */
 /* Tests_SRS_LIST_01_008: [singlylinkedlist_get_head_item shall return the head of the list.] */
+/* Tests_SRS_LIST_03_003: [singlylinkedlist_add shall allocate the new list node by calling slab_malloc.] */
+/* Tests_SRS_LIST_03_005: [If the slab for the list nodes was not created yet, singlylinkedlist_add shall create it by calling slab_create.] */
 TEST_FUNCTION(singlylinkedlist_add_adds_the_item_and_returns_a_non_NULL_handle)
 {
     // arrange
@@ -228,7 +313,8 @@ TEST_FUNCTION(singlylinkedlist_add_adds_the_item_and_returns_a_non_NULL_handle)
     LIST_ITEM_HANDLE head;
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(slab_malloc(TEST_SLAB_HANDLE));
 
     // act
     result = singlylinkedlist_add(list, &x);
@@ -259,7 +345,8 @@ TEST_FUNCTION(singlylinkedlist_add_when_an_item_is_in_the_singlylinkedlist_adds_
     (void)singlylinkedlist_add(list, &x1);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    /* the slab was created by the first add */
+    STRICT_EXPECTED_CALL(slab_malloc(TEST_SLAB_HANDLE));
 
     // act
     result = singlylinkedlist_add(list, &x2);
@@ -288,7 +375,8 @@ TEST_FUNCTION(when_the_underlying_malloc_fails_singlylinkedlist_add_fails)
     LIST_ITEM_HANDLE result;
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(slab_malloc(TEST_SLAB_HANDLE))
         .SetReturn((void*)NULL);
 
     // act
@@ -302,6 +390,30 @@ TEST_FUNCTION(when_the_underlying_malloc_fails_singlylinkedlist_add_fails)
     singlylinkedlist_destroy(list);
 }
 
+/* Tests_SRS_LIST_03_006: [If creating the slab fails, singlylinkedlist_add shall return NULL.] */
+TEST_FUNCTION(when_slab_create_fails_singlylinkedlist_add_fails)
+{
+    // arrange
+    SINGLYLINKEDLIST_HANDLE list = singlylinkedlist_create();
+    int x = 42;
+    LIST_ITEM_HANDLE result;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG))
+        .SetReturn((SLAB_HANDLE)NULL);
+
+    // act
+    result = singlylinkedlist_add(list, &x);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_IS_NULL(singlylinkedlist_get_head_item(list));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    singlylinkedlist_destroy(list);
+}
+
 /* singlylinkedlist_get_head_item */
 
 /* Tests_SRS_LIST_01_010: [If the list is empty, singlylinkedlist_get_head_item_shall_return NULL.] */
@@ -689,6 +801,7 @@ TEST_FUNCTION(singlylinkedlist_find_on_a_list_with_no_items_yields_NULL)
 /* singlylinkedlist_remove */
 
 /* Tests_SRS_LIST_01_023: [singlylinkedlist_remove shall remove a list item from the list and on success it shall return 0.] */
+/* Tests_SRS_LIST_03_004: [Removed nodes shall be returned to the slab by calling slab_free.] */
 TEST_FUNCTION(singlylinkedlist_remove_when_one_item_is_in_the_list_succeeds)
 {
     // arrange
@@ -700,7 +813,7 @@ TEST_FUNCTION(singlylinkedlist_remove_when_one_item_is_in_the_list_succeeds)
     item = singlylinkedlist_find(list, test_match_function, TEST_CONTEXT);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
 
     // act
     result = singlylinkedlist_remove(list, item);
@@ -785,7 +898,7 @@ TEST_FUNCTION(singlylinkedlist_remove_first_of_2_items_succeeds)
     LIST_ITEM_HANDLE item1 = singlylinkedlist_add(list, &x1);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
 
     // act
     result = singlylinkedlist_remove(list, item1);
@@ -811,7 +924,7 @@ TEST_FUNCTION(singlylinkedlist_remove_second_of_2_items_succeeds)
     item2 = singlylinkedlist_add(list, &x2);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
 
     // act
     result = singlylinkedlist_remove(list, item2);
@@ -1086,8 +1199,8 @@ TEST_FUNCTION(singlylinkedlist_remove_if_all_items_succeeds)
     (void)singlylinkedlist_add(list, &values[4]);
 
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(free(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
 
     // act
     result = singlylinkedlist_remove_if(list, removeif_condition_function, &profile);
@@ -1131,7 +1244,7 @@ TEST_FUNCTION(singlylinkedlist_remove_if_break_succeeds)
     (void)singlylinkedlist_add(list, &values[4]);
 
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
 
     // act
     result = singlylinkedlist_remove_if(list, removeif_condition_function, &profile);
@@ -1175,8 +1288,8 @@ TEST_FUNCTION(singlylinkedlist_remove_if_remove_and_break_succeeds)
     (void)singlylinkedlist_add(list, &values[4]);
 
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(free(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
 
     // act
     result = singlylinkedlist_remove_if(list, removeif_condition_function, &profile);
@@ -1215,7 +1328,7 @@ TEST_FUNCTION(singlylinkedlist_remove_if_removes_the_only_item_in_the_list)
     (void)singlylinkedlist_add(list, &values[0]);
 
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
 
     // act
     result = singlylinkedlist_remove_if(list, removeif_condition_function, &profile);
@@ -0,0 +1,539 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+void* my_gballoc_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void my_gballoc_free(void* ptr)
+{
+    free(ptr);
+}
+
+#include "umock_c.h"
+#include "azure_c_shared_utility/slab.h"
+
+#define ENABLE_MOCKS
+
+#include "azure_c_shared_utility/gballoc.h"
+
+#undef ENABLE_MOCKS
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+#define TEST_OBJECT_SIZE 24
+#define TEST_OBJECTS_PER_CHUNK 4
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(slab_unittests)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+/* slab_create */
+
+/* Tests_SRS_SLAB_03_003: [ slab_create shall allocate the slab and return a non-NULL handle, no chunk shall be allocated until the first slab_malloc. ]*/
+TEST_FUNCTION(slab_create_succeeds)
+{
+    // arrange
+    SLAB_HANDLE result;
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+    // act
+    result = slab_create(TEST_OBJECT_SIZE, TEST_OBJECTS_PER_CHUNK);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    slab_destroy(result);
+}
+
+/* Tests_SRS_SLAB_03_001: [ If object_size is 0, slab_create shall fail and return NULL. ]*/
+TEST_FUNCTION(slab_create_with_0_object_size_fails)
+{
+    // arrange
+    SLAB_HANDLE result;
+
+    // act
+    result = slab_create(0, TEST_OBJECTS_PER_CHUNK);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_SLAB_03_002: [ If objects_per_chunk is 0, slab_create shall use SLAB_DEFAULT_OBJECTS_PER_CHUNK. ]*/
+TEST_FUNCTION(slab_create_with_0_objects_per_chunk_uses_the_default)
+{
+    // arrange
+    size_t i;
+    SLAB_HANDLE slab = slab_create(TEST_OBJECT_SIZE, 0);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+    // act
+    for (i = 0; i < SLAB_DEFAULT_OBJECTS_PER_CHUNK; i++)
+    {
+        ASSERT_IS_NOT_NULL(slab_malloc(slab));
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    slab_destroy(slab);
+}
+
+/* Tests_SRS_SLAB_03_004: [ If any error occurs, slab_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_fails_slab_create_fails)
+{
+    // arrange
+    SLAB_HANDLE result;
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    // act
+    result = slab_create(TEST_OBJECT_SIZE, TEST_OBJECTS_PER_CHUNK);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_SLAB_03_004: [ If any error occurs, slab_create shall fail and return NULL. ]*/
+TEST_FUNCTION(slab_create_with_a_chunk_size_too_large_fails)
+{
+    // arrange
+    SLAB_HANDLE result;
+
+    // act
+    result = slab_create(TEST_OBJECT_SIZE, SIZE_MAX / 2);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* slab_destroy */
+
+/* Tests_SRS_SLAB_03_005: [ If slab is NULL, slab_destroy shall return. ]*/
+TEST_FUNCTION(slab_destroy_with_NULL_slab_returns)
+{
+    // arrange
+
+    // act
+    slab_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_SLAB_03_006: [ slab_destroy shall free all the chunks of the slab, whether their objects were freed or not, and the slab itself. ]*/
+TEST_FUNCTION(slab_destroy_frees_all_the_chunks)
+{
+    // arrange
+    size_t i;
+    void* first_object = NULL;
+    SLAB_HANDLE slab = slab_create(TEST_OBJECT_SIZE, TEST_OBJECTS_PER_CHUNK);
+    /* the first chunk has objects in use and one freed, the second has one object in use */
+    for (i = 0; i < TEST_OBJECTS_PER_CHUNK + 1; i++)
+    {
+        void* object = slab_malloc(slab);
+        if (i == 0)
+        {
+            first_object = object;
+        }
+    }
+    slab_free(slab, first_object);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(slab));
+
+    // act
+    slab_destroy(slab);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_SLAB_03_006: [ slab_destroy shall free all the chunks of the slab, whether their objects were freed or not, and the slab itself. ]*/
+TEST_FUNCTION(slab_destroy_frees_the_kept_empty_chunk)
+{
+    // arrange
+    SLAB_HANDLE slab = slab_create(TEST_OBJECT_SIZE, TEST_OBJECTS_PER_CHUNK);
+    slab_free(slab, slab_malloc(slab));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(slab));
+
+    // act
+    slab_destroy(slab);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* slab_malloc */
+
+/* Tests_SRS_SLAB_03_007: [ If slab is NULL, slab_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(slab_malloc_with_NULL_slab_fails)
+{
+    // arrange
+    void* result;
+
+    // act
+    result = slab_malloc(NULL);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_SLAB_03_009: [ Otherwise slab_malloc shall return the next never used object of that chunk, aligned for any type. ]*/
+/* Tests_SRS_SLAB_03_010: [ If all objects of the slab are in use, slab_malloc shall allocate a new chunk of objects_per_chunk objects. ]*/
+TEST_FUNCTION(slab_malloc_allocates_one_chunk_for_objects_per_chunk_objects)
+{
+    // arrange
+    size_t i;
+    unsigned char* objects[TEST_OBJECTS_PER_CHUNK];
+    SLAB_HANDLE slab = slab_create(TEST_OBJECT_SIZE, TEST_OBJECTS_PER_CHUNK);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+    // act
+    for (i = 0; i < TEST_OBJECTS_PER_CHUNK; i++)
+    {
+        objects[i] = (unsigned char*)slab_malloc(slab);
+    }
+
+    // assert
+    for (i = 0; i < TEST_OBJECTS_PER_CHUNK; i++)
+    {
+        ASSERT_IS_NOT_NULL(objects[i]);
+        ASSERT_ARE_EQUAL(size_t, 0, (size_t)((uintptr_t)objects[i] % sizeof(void*)));
+        (void)memset(objects[i], 0xAA, TEST_OBJECT_SIZE);
+        if (i > 0)
+        {
+            ASSERT_IS_TRUE(objects[i] >= objects[i - 1] + TEST_OBJECT_SIZE);
+        }
+    }
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    slab_destroy(slab);
+}
+
+/* Tests_SRS_SLAB_03_010: [ If all objects of the slab are in use, slab_malloc shall allocate a new chunk of objects_per_chunk objects. ]*/
+TEST_FUNCTION(when_the_chunk_is_full_slab_malloc_allocates_a_new_chunk)
+{
+    // arrange
+    size_t i;
+    void* result;
+    SLAB_HANDLE slab = slab_create(TEST_OBJECT_SIZE, TEST_OBJECTS_PER_CHUNK);
+    for (i = 0; i < TEST_OBJECTS_PER_CHUNK; i++)
+    {
+        (void)slab_malloc(slab);
+    }
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+    // act
+    result = slab_malloc(slab);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    slab_destroy(slab);
+}
+
+/* Tests_SRS_SLAB_03_008: [ slab_malloc shall return the most recently freed object of a chunk that has objects to hand out if there is one. ]*/
+TEST_FUNCTION(slab_malloc_reuses_the_most_recently_freed_object)
+{
+    // arrange
+    void* result;
+    SLAB_HANDLE slab = slab_create(TEST_OBJECT_SIZE, TEST_OBJECTS_PER_CHUNK);
+    void* object1 = slab_malloc(slab);
+    void* object2 = slab_malloc(slab);
+    slab_free(slab, object1);
+    slab_free(slab, object2);
+    umock_c_reset_all_calls();
+
+    // act
+    result = slab_malloc(slab);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, object2, result);
+    ASSERT_ARE_EQUAL(void_ptr, object1, slab_malloc(slab));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    slab_destroy(slab);
+}
+
+/* Tests_SRS_SLAB_03_008: [ slab_malloc shall return the most recently freed object of a chunk that has objects to hand out if there is one. ]*/
+TEST_FUNCTION(slab_malloc_reuses_a_freed_object_of_a_full_chunk_before_allocating_a_chunk)
+{
+    // arrange
+    size_t i;
+    void* objects[TEST_OBJECTS_PER_CHUNK];
+    void* result;
+    SLAB_HANDLE slab = slab_create(TEST_OBJECT_SIZE, TEST_OBJECTS_PER_CHUNK);
+    for (i = 0; i < TEST_OBJECTS_PER_CHUNK; i++)
+    {
+        objects[i] = slab_malloc(slab);
+    }
+    slab_free(slab, objects[1]);
+    umock_c_reset_all_calls();
+
+    // act
+    result = slab_malloc(slab);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, objects[1], result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    slab_destroy(slab);
+}
+
+/* Tests_SRS_SLAB_03_011: [ If allocating the chunk fails, slab_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(when_allocating_the_chunk_fails_slab_malloc_fails)
+{
+    // arrange
+    void* result;
+    SLAB_HANDLE slab = slab_create(TEST_OBJECT_SIZE, TEST_OBJECTS_PER_CHUNK);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+    // act
+    result = slab_malloc(slab);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    /* the failure is not sticky */
+    ASSERT_IS_NOT_NULL(slab_malloc(slab));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    slab_destroy(slab);
+}
+
+/* Tests_SRS_SLAB_03_009: [ Otherwise slab_malloc shall return the next never used object of that chunk, aligned for any type. ]*/
+TEST_FUNCTION(slab_malloc_with_an_object_smaller_than_a_pointer_succeeds)
+{
+    // arrange
+    unsigned char* object1;
+    unsigned char* object2;
+    SLAB_HANDLE slab = slab_create(1, TEST_OBJECTS_PER_CHUNK);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+    // act
+    object1 = (unsigned char*)slab_malloc(slab);
+    object2 = (unsigned char*)slab_malloc(slab);
+
+    // assert
+    ASSERT_IS_NOT_NULL(object1);
+    ASSERT_IS_NOT_NULL(object2);
+    ASSERT_IS_TRUE(object2 >= object1 + sizeof(void*));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    slab_destroy(slab);
+}
+
+/* slab_free */
+
+/* Tests_SRS_SLAB_03_012: [ If slab is NULL, slab_free shall return. ]*/
+TEST_FUNCTION(slab_free_with_NULL_slab_returns)
+{
+    // arrange
+    unsigned char object[TEST_OBJECT_SIZE];
+
+    // act
+    slab_free(NULL, object);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_SLAB_03_013: [ If ptr is NULL, slab_free shall return. ]*/
+TEST_FUNCTION(slab_free_with_NULL_ptr_returns)
+{
+    // arrange
+    SLAB_HANDLE slab = slab_create(TEST_OBJECT_SIZE, TEST_OBJECTS_PER_CHUNK);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+    // act
+    slab_free(slab, NULL);
+
+    // assert
+    /* the free list is still empty, so the next object comes from a new chunk */
+    ASSERT_IS_NOT_NULL(slab_malloc(slab));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    slab_destroy(slab);
+}
+
+/* Tests_SRS_SLAB_03_014: [ slab_free shall put the object on the free list of its chunk for reuse by slab_malloc. ]*/
+/* Tests_SRS_SLAB_03_015: [ When none of the objects of its chunk is in use anymore, slab_free shall keep the chunk if the slab has no other such chunk and free it otherwise. ]*/
+TEST_FUNCTION(slab_free_keeps_the_only_empty_chunk)
+{
+    // arrange
+    size_t i;
+    void* objects[TEST_OBJECTS_PER_CHUNK];
+    SLAB_HANDLE slab = slab_create(TEST_OBJECT_SIZE, TEST_OBJECTS_PER_CHUNK);
+    for (i = 0; i < TEST_OBJECTS_PER_CHUNK; i++)
+    {
+        objects[i] = slab_malloc(slab);
+    }
+    umock_c_reset_all_calls();
+
+    // act
+    for (i = 0; i < TEST_OBJECTS_PER_CHUNK; i++)
+    {
+        slab_free(slab, objects[i]);
+    }
+
+    // assert
+    /* all the objects are handed out again without a new chunk */
+    for (i = 0; i < TEST_OBJECTS_PER_CHUNK; i++)
+    {
+        ASSERT_IS_NOT_NULL(slab_malloc(slab));
+    }
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    slab_destroy(slab);
+}
+
+/* Tests_SRS_SLAB_03_015: [ When none of the objects of its chunk is in use anymore, slab_free shall keep the chunk if the slab has no other such chunk and free it otherwise. ]*/
+TEST_FUNCTION(slab_free_frees_a_second_empty_chunk)
+{
+    // arrange
+    size_t i;
+    void* objects[2 * TEST_OBJECTS_PER_CHUNK];
+    SLAB_HANDLE slab = slab_create(TEST_OBJECT_SIZE, TEST_OBJECTS_PER_CHUNK);
+    for (i = 0; i < 2 * TEST_OBJECTS_PER_CHUNK; i++)
+    {
+        objects[i] = slab_malloc(slab);
+    }
+    umock_c_reset_all_calls();
+
+    /* the first chunk emptied is kept, the second is freed */
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    for (i = 0; i < 2 * TEST_OBJECTS_PER_CHUNK; i++)
+    {
+        slab_free(slab, objects[i]);
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    slab_destroy(slab);
+}
+
+/* Tests_SRS_SLAB_03_015: [ When none of the objects of its chunk is in use anymore, slab_free shall keep the chunk if the slab has no other such chunk and free it otherwise. ]*/
+TEST_FUNCTION(slab_free_does_not_free_a_chunk_with_objects_in_use)
+{
+    // arrange
+    size_t i;
+    void* objects[2 * TEST_OBJECTS_PER_CHUNK];
+    SLAB_HANDLE slab = slab_create(TEST_OBJECT_SIZE, TEST_OBJECTS_PER_CHUNK);
+    for (i = 0; i < 2 * TEST_OBJECTS_PER_CHUNK; i++)
+    {
+        objects[i] = slab_malloc(slab);
+    }
+    umock_c_reset_all_calls();
+
+    // act
+    for (i = 1; i < 2 * TEST_OBJECTS_PER_CHUNK; i++)
+    {
+        slab_free(slab, objects[i]);
+    }
+
+    // assert
+    /* the first chunk still has objects[0] in use and the second is the kept empty chunk */
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    slab_free(slab, objects[0]);
+    slab_destroy(slab);
+}
+
+END_TEST_SUITE(slab_unittests)
@@ -0,0 +1,1668 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdbool.h>
+#endif
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <poll.h>
+
+#include "testrunnerswitcher.h"
+#include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/socketio_event_loop.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+#include "azure_c_shared_utility/constbuffer.h"
+#include "azure_c_shared_utility/threadapi.h"
+
+/* the socket IO runs on real sockets, it connects to a listening socket on the loopback and the tests play the peer with the accepted socket */
+#define TEST_HOSTNAME           "127.0.0.1"
+#define TEST_WAIT_MS            5000
+#define TEST_RECEIVE_SIZE       (64 * 1024)
+#define TEST_SEND_COUNT         100
+/* more than the socket and the peer buffer on the loopback, so that the socket takes only part of it */
+#define TEST_LARGE_SEND_SIZE    (16 * 1024 * 1024)
+/* SOCKETIO_MAX_IOVECS of socketio_berkeley.c is 64 */
+#define TEST_BUFFER_COUNT       200
+/* fits in the socket buffers on the loopback, so that the socket has all of it when the socket IO receives */
+#define TEST_BATCH_SIZE         (32 * 1024)
+#define TEST_CONNECT_TIMEOUT_MS 100
+/* what socketio_berkeley.c indicates when the connect timed out */
+#define TEST_CONNECT_TIMEOUT_ERROR_CODE 9999
+#define TEST_BACKLOG_FILLER_COUNT 4
+#define TEST_ABSTRACT_PATH      "@socketio_berkeley_loopback_ut"
+
+TEST_DEFINE_ENUM_TYPE(IO_OPEN_RESULT, IO_OPEN_RESULT_VALUES);
+TEST_DEFINE_ENUM_TYPE(IO_SEND_RESULT, IO_SEND_RESULT_VALUES);
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+typedef struct TEST_CONTEXT_TAG
+{
+    size_t open_complete_count;
+    IO_OPEN_RESULT open_result;
+    int open_code;
+    size_t error_count;
+    size_t close_complete_count;
+    size_t send_complete_count;
+    IO_SEND_RESULT send_result;
+    /* the index of each completed send, in the order of the completions */
+    size_t send_order[TEST_SEND_COUNT];
+    size_t received_size;
+    unsigned char received[TEST_RECEIVE_SIZE];
+    size_t receive_count;
+    size_t largest_receive_size;
+    const unsigned char* last_receive_buffer;
+} TEST_CONTEXT;
+
+typedef struct TEST_SEND_TAG
+{
+    TEST_CONTEXT* context;
+    size_t index;
+} TEST_SEND;
+
+static TEST_CONTEXT test_context;
+static int listen_socket;
+static int listen_port;
+static unsigned char large_bytes[TEST_LARGE_SEND_SIZE];
+static unsigned char large_received[TEST_LARGE_SEND_SIZE];
+
+static void on_io_open_complete(void* context, IO_OPEN_RESULT_DETAILED open_result)
+{
+    TEST_CONTEXT* test = (TEST_CONTEXT*)context;
+    test->open_complete_count++;
+    test->open_result = open_result.result;
+    test->open_code = open_result.code;
+}
+
+static void on_bytes_received(void* context, const unsigned char* buffer, size_t size)
+{
+    TEST_CONTEXT* test = (TEST_CONTEXT*)context;
+    size_t copied_size = (size < TEST_RECEIVE_SIZE - test->received_size) ? size : TEST_RECEIVE_SIZE - test->received_size;
+    (void)memcpy(test->received + test->received_size, buffer, copied_size);
+    test->received_size += copied_size;
+    test->receive_count++;
+    test->last_receive_buffer = buffer;
+    if (size > test->largest_receive_size)
+    {
+        test->largest_receive_size = size;
+    }
+}
+
+static void on_io_error(void* context)
+{
+    TEST_CONTEXT* test = (TEST_CONTEXT*)context;
+    test->error_count++;
+}
+
+static void on_io_close_complete(void* context)
+{
+    TEST_CONTEXT* test = (TEST_CONTEXT*)context;
+    test->close_complete_count++;
+}
+
+/* counts the releases of a constbuffer created with CONSTBUFFER_CreateWithCustomFree */
+static void on_constbuffer_free(void* context)
+{
+    size_t* free_count = (size_t*)context;
+    (*free_count)++;
+}
+
+static void on_send_complete(void* context, IO_SEND_RESULT send_result)
+{
+    TEST_SEND* send = (TEST_SEND*)context;
+    if (send->context->send_complete_count < TEST_SEND_COUNT)
+    {
+        send->context->send_order[send->context->send_complete_count] = send->index;
+    }
+    send->context->send_complete_count++;
+    send->context->send_result = send_result;
+}
+
+static int create_listen_socket_with_backlog(int backlog, int* port)
+{
+    int result = socket(AF_INET, SOCK_STREAM, 0);
+    if (result != -1)
+    {
+        struct sockaddr_in address;
+        socklen_t address_length = sizeof(address);
+        (void)memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+
+        if ((bind(result, (struct sockaddr*)&address, sizeof(address)) != 0) ||
+            (listen(result, backlog) != 0) ||
+            (getsockname(result, (struct sockaddr*)&address, &address_length) != 0))
+        {
+            (void)close(result);
+            result = -1;
+        }
+        else
+        {
+            *port = ntohs(address.sin_port);
+        }
+    }
+    return result;
+}
+
+static int create_listen_socket(int* port)
+{
+    return create_listen_socket_with_backlog(SOMAXCONN, port);
+}
+
+/* a listening Unix domain socket, path starting with '@' is in the abstract namespace */
+static int create_unix_listen_socket(const char* path)
+{
+    int result = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (result != -1)
+    {
+        struct sockaddr_un address;
+        socklen_t address_length = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + strlen(path) + 1);
+        (void)memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        (void)strcpy(address.sun_path, path);
+        if (path[0] == '@')
+        {
+            address.sun_path[0] = '\0';
+            address_length--;
+        }
+
+        if ((bind(result, (struct sockaddr*)&address, address_length) != 0) ||
+            (listen(result, SOMAXCONN) != 0))
+        {
+            (void)close(result);
+            result = -1;
+        }
+    }
+    return result;
+}
+
+/* a listening socket whose backlog is full, the kernel drops the SYNs sent to it so that a connect to it neither succeeds nor fails */
+static int create_stalled_listen_socket(int* fillers, int* port)
+{
+    int result = create_listen_socket_with_backlog(0, port);
+    if (result != -1)
+    {
+        size_t i;
+        struct sockaddr_in address;
+        (void)memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons((uint16_t)*port);
+
+        for (i = 0; i < TEST_BACKLOG_FILLER_COUNT; i++)
+        {
+            if ((fillers[i] = socket(AF_INET, SOCK_STREAM, 0)) != -1)
+            {
+                (void)fcntl(fillers[i], F_SETFL, O_NONBLOCK);
+                (void)connect(fillers[i], (struct sockaddr*)&address, sizeof(address));
+            }
+        }
+    }
+    return result;
+}
+
+static void close_stalled_listen_socket(int stalled_listen_socket, int* fillers)
+{
+    size_t i;
+    for (i = 0; i < TEST_BACKLOG_FILLER_COUNT; i++)
+    {
+        (void)close(fillers[i]);
+    }
+    (void)close(stalled_listen_socket);
+}
+
+/* closes the connections the listening socket has, a connect cancelled by the test may or may not have reached it */
+static void close_pending_peers(void)
+{
+    struct pollfd listen_poll;
+    listen_poll.fd = listen_socket;
+    listen_poll.events = POLLIN;
+    while (poll(&listen_poll, 1, 100) == 1)
+    {
+        (void)close(accept(listen_socket, NULL, NULL));
+    }
+}
+
+/* the socket of the socket IO is the one of the process whose local address is the remote address of peer */
+static int find_socket_of_peer(int peer)
+{
+    int result = -1;
+    struct sockaddr_in peer_address;
+    socklen_t peer_address_length = sizeof(peer_address);
+    if (getpeername(peer, (struct sockaddr*)&peer_address, &peer_address_length) == 0)
+    {
+        int fd;
+        for (fd = 0; (fd < 1024) && (result == -1); fd++)
+        {
+            struct sockaddr_in address;
+            socklen_t address_length = sizeof(address);
+            if ((fd != peer) &&
+                (getsockname(fd, (struct sockaddr*)&address, &address_length) == 0) &&
+                (address.sin_family == AF_INET) &&
+                (address.sin_port == peer_address.sin_port) &&
+                (address.sin_addr.s_addr == peer_address.sin_addr.s_addr))
+            {
+                result = fd;
+            }
+        }
+    }
+    return result;
+}
+
+static int get_socket_option(int socket, int level, int option_name)
+{
+    int result = -1;
+    socklen_t value_length = sizeof(result);
+    ASSERT_ARE_EQUAL(int, 0, getsockopt(socket, level, option_name, &result, &value_length));
+    return result;
+}
+
+/* runs the socket IO, or its event loop, until counter reaches expected */
+static void run_until(CONCRETE_IO_HANDLE socket_io, SOCKETIO_EVENT_LOOP_HANDLE event_loop, const size_t* counter, size_t expected)
+{
+    size_t waited_ms = 0;
+    while ((*counter < expected) && (waited_ms < TEST_WAIT_MS))
+    {
+        if (event_loop != NULL)
+        {
+            (void)socketio_event_loop_run_once(event_loop, 1);
+        }
+        else
+        {
+            socketio_dowork(socket_io);
+            ThreadAPI_Sleep(1);
+        }
+        waited_ms++;
+    }
+}
+
+static int accept_peer(void)
+{
+    int result = accept(listen_socket, NULL, NULL);
+    ASSERT_ARE_NOT_EQUAL(int, -1, result);
+    {
+        struct timeval timeout;
+        timeout.tv_sec = TEST_WAIT_MS / 1000;
+        timeout.tv_usec = 0;
+        (void)setsockopt(result, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+    return result;
+}
+
+/* reads size bytes from the peer, fewer if it times out */
+static size_t read_peer(int peer, unsigned char* buffer, size_t size)
+{
+    size_t result = 0;
+    while (result < size)
+    {
+        ssize_t received = recv(peer, buffer + result, size - result, 0);
+        if (received <= 0)
+        {
+            break;
+        }
+        result += (size_t)received;
+    }
+    return result;
+}
+
+/* reads size bytes from the peer while the socket IO, or its event loop, sends what it queued, fewer if it times out */
+static size_t read_peer_while_sending(CONCRETE_IO_HANDLE socket_io, SOCKETIO_EVENT_LOOP_HANDLE event_loop, int peer, unsigned char* buffer, size_t size)
+{
+    size_t result = 0;
+    size_t waited_ms = 0;
+    while ((result < size) && (waited_ms < TEST_WAIT_MS))
+    {
+        ssize_t received = recv(peer, buffer + result, size - result, MSG_DONTWAIT);
+        if (received > 0)
+        {
+            result += (size_t)received;
+        }
+        else if (event_loop != NULL)
+        {
+            (void)socketio_event_loop_run_once(event_loop, 1);
+            waited_ms++;
+        }
+        else
+        {
+            ThreadAPI_Sleep(1);
+            waited_ms++;
+        }
+
+        if (event_loop == NULL)
+        {
+            socketio_dowork(socket_io);
+        }
+    }
+    return result;
+}
+
+static CONCRETE_IO_HANDLE create_socket_io_to_port(SOCKETIO_EVENT_LOOP_HANDLE event_loop, int port)
+{
+    SOCKETIO_CONFIG config;
+    (void)memset(&config, 0, sizeof(config));
+    config.hostname = TEST_HOSTNAME;
+    config.port = port;
+    CONCRETE_IO_HANDLE result = socketio_create(&config);
+    ASSERT_IS_NOT_NULL(result);
+    if (event_loop != NULL)
+    {
+        ASSERT_ARE_EQUAL(int, 0, socketio_setoption(result, OPTION_EVENT_LOOP, event_loop));
+    }
+    return result;
+}
+
+static CONCRETE_IO_HANDLE create_socket_io(SOCKETIO_EVENT_LOOP_HANDLE event_loop)
+{
+    return create_socket_io_to_port(event_loop, listen_port);
+}
+
+/* opens a socket IO connected to the listening socket and returns the peer of the connection */
+static int open_socket_io(CONCRETE_IO_HANDLE socket_io, SOCKETIO_EVENT_LOOP_HANDLE event_loop, TEST_CONTEXT* context)
+{
+    ASSERT_ARE_EQUAL(int, 0, socketio_open(socket_io, on_io_open_complete, context, on_bytes_received, context, on_io_error, context));
+    run_until(socket_io, event_loop, &context->open_complete_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, context->open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_OK, context->open_result);
+    return accept_peer();
+}
+
+/* the peer sends size bytes of large_bytes */
+static void send_peer(int peer, size_t size)
+{
+    size_t sent_size = 0;
+    while (sent_size < size)
+    {
+        ssize_t sent = send(peer, large_bytes + sent_size, size - sent_size, 0);
+        ASSERT_IS_TRUE(sent > 0);
+        sent_size += (size_t)sent;
+    }
+}
+
+static void fill_large_bytes(void)
+{
+    size_t i;
+    for (i = 0; i < sizeof(large_bytes); i++)
+    {
+        large_bytes[i] = (unsigned char)(i * 7 + i / 251);
+    }
+}
+
+BEGIN_TEST_SUITE(socketio_berkeley_loopback_unittests)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    listen_socket = create_listen_socket(&listen_port);
+    ASSERT_ARE_NOT_EQUAL(int, -1, listen_socket);
+    fill_large_bytes();
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    (void)close(listen_socket);
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    (void)memset(&test_context, 0, sizeof(test_context));
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* socketio_create_with_arena */
+
+/* the instance and the host name come from the arena, which the socket IO does not free */
+TEST_FUNCTION(socketio_create_with_arena_allocates_the_socket_io_in_the_arena)
+{
+    // arrange
+    unsigned char received[3];
+    SOCKETIO_CONFIG config;
+    ARENA_HANDLE arena = arena_create(4096);
+    ASSERT_IS_NOT_NULL(arena);
+    (void)memset(&config, 0, sizeof(config));
+    config.hostname = TEST_HOSTNAME;
+    config.port = listen_port;
+
+    // act
+    CONCRETE_IO_HANDLE socket_io = socketio_create_with_arena(&config, arena);
+
+    // assert
+    ASSERT_IS_NOT_NULL(socket_io);
+    ASSERT_ARE_NOT_EQUAL(size_t, 0, arena_get_allocated_size(arena));
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    ASSERT_ARE_EQUAL(int, 0, socketio_send(socket_io, "abc", 3, NULL, NULL));
+    ASSERT_ARE_EQUAL(size_t, 3, read_peer(peer, received, 3));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(received, "abc", 3));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    arena_destroy(arena);
+    (void)close(peer);
+}
+
+/* socketio_sendv */
+
+TEST_FUNCTION(socketio_sendv_with_NULL_buffers_fails)
+{
+    // arrange
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    int result = socketio_sendv(socket_io, NULL, 1, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+TEST_FUNCTION(socketio_sendv_with_a_NULL_buffer_of_non_zero_size_fails)
+{
+    // arrange
+    CONSTBUFFER buffers[2] = { { (const unsigned char*)"abc", 3 }, { NULL, 1 } };
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    int result = socketio_sendv(socket_io, buffers, 2, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+TEST_FUNCTION(socketio_sendv_without_bytes_fails)
+{
+    // arrange
+    CONSTBUFFER buffers[2] = { { NULL, 0 }, { (const unsigned char*)"abc", 0 } };
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    int result = socketio_sendv(socket_io, buffers, 2, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+TEST_FUNCTION(socketio_sendv_when_not_open_fails)
+{
+    // arrange
+    CONSTBUFFER buffer = { (const unsigned char*)"abc", 3 };
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+
+    // act
+    int result = socketio_sendv(socket_io, &buffer, 1, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+}
+
+/* the buffers go out with one sendmsg, which the socket takes at once */
+TEST_FUNCTION(socketio_sendv_sends_the_buffers_in_order)
+{
+    // arrange
+    unsigned char received[9];
+    CONSTBUFFER buffers[3] = { { (const unsigned char*)"abc", 3 }, { NULL, 0 }, { (const unsigned char*)"defghi", 6 } };
+    TEST_SEND test_send = { &test_context, 0 };
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    int result = socketio_sendv(socket_io, buffers, 3, on_send_complete, &test_send);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.send_complete_count);
+    ASSERT_ARE_EQUAL(IO_SEND_RESULT, IO_SEND_OK, test_context.send_result);
+    ASSERT_ARE_EQUAL(size_t, 9, read_peer(peer, received, 9));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(received, "abcdefghi", 9));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* the buffers past the first SOCKETIO_MAX_IOVECS ones are queued and sent by socketio_dowork */
+TEST_FUNCTION(socketio_sendv_of_more_buffers_than_SOCKETIO_MAX_IOVECS_sends_them_all)
+{
+    // arrange
+    unsigned char bytes[TEST_BUFFER_COUNT];
+    unsigned char received[TEST_BUFFER_COUNT];
+    CONSTBUFFER buffers[TEST_BUFFER_COUNT];
+    TEST_SEND test_send = { &test_context, 0 };
+    size_t i;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    for (i = 0; i < TEST_BUFFER_COUNT; i++)
+    {
+        bytes[i] = (unsigned char)i;
+        buffers[i].buffer = &bytes[i];
+        buffers[i].size = 1;
+    }
+
+    // act
+    int result = socketio_sendv(socket_io, buffers, TEST_BUFFER_COUNT, on_send_complete, &test_send);
+    /* what was queued was copied */
+    (void)memset(bytes, 0xFF, sizeof(bytes));
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    run_until(socket_io, NULL, &test_context.send_complete_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.send_complete_count);
+    ASSERT_ARE_EQUAL(IO_SEND_RESULT, IO_SEND_OK, test_context.send_result);
+    ASSERT_ARE_EQUAL(size_t, TEST_BUFFER_COUNT, read_peer(peer, received, TEST_BUFFER_COUNT));
+    for (i = 0; i < TEST_BUFFER_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)i, (int)received[i]);
+    }
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* the socket takes part of the bytes, the rest is queued and completed once socketio_dowork sent it */
+TEST_FUNCTION(socketio_send_queues_what_the_socket_does_not_take)
+{
+    // arrange
+    TEST_SEND test_sends[2] = { { &test_context, 0 }, { &test_context, 1 } };
+    unsigned char received[4];
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    int result = socketio_send(socket_io, large_bytes, TEST_LARGE_SEND_SIZE, on_send_complete, &test_sends[0]);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.send_complete_count);
+    /* a send behind a queued one is queued whole */
+    ASSERT_ARE_EQUAL(int, 0, socketio_send(socket_io, "tail", 4, on_send_complete, &test_sends[1]));
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.send_complete_count);
+    ASSERT_ARE_EQUAL(size_t, TEST_LARGE_SEND_SIZE, read_peer_while_sending(socket_io, NULL, peer, large_received, TEST_LARGE_SEND_SIZE));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(large_received, large_bytes, TEST_LARGE_SEND_SIZE));
+    ASSERT_ARE_EQUAL(size_t, 4, read_peer_while_sending(socket_io, NULL, peer, received, 4));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(received, "tail", 4));
+    run_until(socket_io, NULL, &test_context.send_complete_count, 2);
+    ASSERT_ARE_EQUAL(size_t, 2, test_context.send_complete_count);
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.send_order[0]);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.send_order[1]);
+    ASSERT_ARE_EQUAL(IO_SEND_RESULT, IO_SEND_OK, test_context.send_result);
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.error_count);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* the pending sends are gathered SOCKETIO_MAX_IOVECS at a time and completed in order */
+TEST_FUNCTION(socketio_send_gathers_more_pending_sends_than_SOCKETIO_MAX_IOVECS)
+{
+    // arrange
+    static unsigned char bytes[TEST_SEND_COUNT][100];
+    static unsigned char received[sizeof(bytes)];
+    TEST_SEND test_sends[TEST_SEND_COUNT];
+    size_t i;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    ASSERT_ARE_EQUAL(int, 0, socketio_send(socket_io, large_bytes, TEST_LARGE_SEND_SIZE, NULL, NULL));
+
+    // act
+    for (i = 0; i < TEST_SEND_COUNT; i++)
+    {
+        (void)memset(bytes[i], (int)i, sizeof(bytes[i]));
+        test_sends[i].context = &test_context;
+        test_sends[i].index = i;
+        ASSERT_ARE_EQUAL(int, 0, socketio_send(socket_io, bytes[i], sizeof(bytes[i]), on_send_complete, &test_sends[i]));
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, TEST_LARGE_SEND_SIZE, read_peer_while_sending(socket_io, NULL, peer, large_received, TEST_LARGE_SEND_SIZE));
+    ASSERT_ARE_EQUAL(size_t, sizeof(received), read_peer_while_sending(socket_io, NULL, peer, received, sizeof(received)));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(received, bytes, sizeof(received)));
+    run_until(socket_io, NULL, &test_context.send_complete_count, TEST_SEND_COUNT);
+    ASSERT_ARE_EQUAL(size_t, TEST_SEND_COUNT, test_context.send_complete_count);
+    for (i = 0; i < TEST_SEND_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(size_t, i, test_context.send_order[i]);
+    }
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* the event loop watches the socket for writes while sends are pending and sends them when it is writable */
+TEST_FUNCTION(socketio_of_an_event_loop_sends_what_the_socket_does_not_take)
+{
+    // arrange
+    TEST_SEND test_send = { &test_context, 0 };
+    CONSTBUFFER buffers[2] = { { large_bytes, TEST_LARGE_SEND_SIZE / 2 }, { large_bytes + TEST_LARGE_SEND_SIZE / 2, TEST_LARGE_SEND_SIZE / 2 } };
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = socketio_event_loop_create();
+    CONCRETE_IO_HANDLE socket_io;
+    int peer;
+    ASSERT_IS_NOT_NULL(event_loop);
+    socket_io = create_socket_io(event_loop);
+    peer = open_socket_io(socket_io, event_loop, &test_context);
+
+    // act
+    int result = socketio_sendv(socket_io, buffers, 2, on_send_complete, &test_send);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.send_complete_count);
+    ASSERT_ARE_EQUAL(size_t, TEST_LARGE_SEND_SIZE, read_peer_while_sending(socket_io, event_loop, peer, large_received, TEST_LARGE_SEND_SIZE));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(large_received, large_bytes, TEST_LARGE_SEND_SIZE));
+    run_until(NULL, event_loop, &test_context.send_complete_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.send_complete_count);
+    ASSERT_ARE_EQUAL(IO_SEND_RESULT, IO_SEND_OK, test_context.send_result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    socketio_event_loop_destroy(event_loop);
+    (void)close(peer);
+}
+
+/* socketio_send_constbuffer */
+
+TEST_FUNCTION(socketio_send_constbuffer_with_NULL_constbuffer_fails)
+{
+    // arrange
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    int result = socketio_send_constbuffer(socket_io, NULL, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+TEST_FUNCTION(socketio_send_constbuffer_of_an_empty_constbuffer_fails)
+{
+    // arrange
+    CONSTBUFFER_HANDLE constbuffer = CONSTBUFFER_Create(NULL, 0);
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    ASSERT_IS_NOT_NULL(constbuffer);
+
+    // act
+    int result = socketio_send_constbuffer(socket_io, constbuffer, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    CONSTBUFFER_Destroy(constbuffer);
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* what the socket takes at once is not queued, the socket IO keeps no reference to the constbuffer */
+TEST_FUNCTION(socketio_send_constbuffer_sent_at_once_keeps_no_reference)
+{
+    // arrange
+    unsigned char received[6];
+    size_t free_count = 0;
+    TEST_SEND test_send = { &test_context, 0 };
+    CONSTBUFFER_HANDLE constbuffer = CONSTBUFFER_CreateWithCustomFree((const unsigned char*)"buffer", 6, on_constbuffer_free, &free_count);
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    ASSERT_IS_NOT_NULL(constbuffer);
+
+    // act
+    int result = socketio_send_constbuffer(socket_io, constbuffer, on_send_complete, &test_send);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.send_complete_count);
+    CONSTBUFFER_Destroy(constbuffer);
+    ASSERT_ARE_EQUAL(size_t, 1, free_count);
+    ASSERT_ARE_EQUAL(size_t, 6, read_peer(peer, received, 6));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(received, "buffer", 6));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* what the socket does not take is sent later from the constbuffer itself, which the socket IO releases once it is sent */
+TEST_FUNCTION(socketio_send_constbuffer_keeps_the_queued_constbuffer_until_it_is_sent)
+{
+    // arrange
+    size_t free_count = 0;
+    TEST_SEND test_send = { &test_context, 0 };
+    CONSTBUFFER_HANDLE constbuffer = CONSTBUFFER_CreateWithCustomFree(large_bytes, TEST_LARGE_SEND_SIZE, on_constbuffer_free, &free_count);
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    ASSERT_IS_NOT_NULL(constbuffer);
+
+    // act
+    int result = socketio_send_constbuffer(socket_io, constbuffer, on_send_complete, &test_send);
+    CONSTBUFFER_Destroy(constbuffer);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.send_complete_count);
+    ASSERT_ARE_EQUAL(size_t, 0, free_count);
+    /* the queued bytes were not copied, the change is sent */
+    large_bytes[TEST_LARGE_SEND_SIZE - 1] ^= 0xFF;
+    ASSERT_ARE_EQUAL(size_t, TEST_LARGE_SEND_SIZE, read_peer_while_sending(socket_io, NULL, peer, large_received, TEST_LARGE_SEND_SIZE));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(large_received, large_bytes, TEST_LARGE_SEND_SIZE));
+    run_until(socket_io, NULL, &test_context.send_complete_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.send_complete_count);
+    ASSERT_ARE_EQUAL(IO_SEND_RESULT, IO_SEND_OK, test_context.send_result);
+    ASSERT_ARE_EQUAL(size_t, 1, free_count);
+
+    // cleanup
+    large_bytes[TEST_LARGE_SEND_SIZE - 1] ^= 0xFF;
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+TEST_FUNCTION(socketio_destroy_releases_the_queued_constbuffer)
+{
+    // arrange
+    size_t free_count = 0;
+    CONSTBUFFER_HANDLE constbuffer = CONSTBUFFER_CreateWithCustomFree(large_bytes, TEST_LARGE_SEND_SIZE, on_constbuffer_free, &free_count);
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    ASSERT_IS_NOT_NULL(constbuffer);
+    ASSERT_ARE_EQUAL(int, 0, socketio_send_constbuffer(socket_io, constbuffer, NULL, NULL));
+    CONSTBUFFER_Destroy(constbuffer);
+    ASSERT_ARE_EQUAL(size_t, 0, free_count);
+
+    // act
+    socketio_destroy(socket_io);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, free_count);
+
+    // cleanup
+    (void)close(peer);
+}
+
+/* a constbuffer queued behind copied sends keeps its place */
+TEST_FUNCTION(socketio_send_constbuffer_behind_pending_sends_is_sent_in_order)
+{
+    // arrange
+    unsigned char received[10];
+    size_t free_count = 0;
+    TEST_SEND test_sends[3] = { { &test_context, 0 }, { &test_context, 1 }, { &test_context, 2 } };
+    CONSTBUFFER_HANDLE constbuffer = CONSTBUFFER_CreateWithCustomFree((const unsigned char*)"buffer", 6, on_constbuffer_free, &free_count);
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    ASSERT_IS_NOT_NULL(constbuffer);
+    ASSERT_ARE_EQUAL(int, 0, socketio_send(socket_io, large_bytes, TEST_LARGE_SEND_SIZE, on_send_complete, &test_sends[0]));
+
+    // act
+    int result = socketio_send_constbuffer(socket_io, constbuffer, on_send_complete, &test_sends[1]);
+    CONSTBUFFER_Destroy(constbuffer);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, socketio_send(socket_io, "tail", 4, on_send_complete, &test_sends[2]));
+    ASSERT_ARE_EQUAL(size_t, 0, free_count);
+    ASSERT_ARE_EQUAL(size_t, TEST_LARGE_SEND_SIZE, read_peer_while_sending(socket_io, NULL, peer, large_received, TEST_LARGE_SEND_SIZE));
+    ASSERT_ARE_EQUAL(size_t, 10, read_peer_while_sending(socket_io, NULL, peer, received, 10));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(received, "buffertail", 10));
+    run_until(socket_io, NULL, &test_context.send_complete_count, 3);
+    ASSERT_ARE_EQUAL(size_t, 3, test_context.send_complete_count);
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.send_order[0]);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.send_order[1]);
+    ASSERT_ARE_EQUAL(size_t, 2, test_context.send_order[2]);
+    ASSERT_ARE_EQUAL(size_t, 1, free_count);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* receive_buffer_size and receive_batched */
+
+TEST_FUNCTION(socketio_setoption_receive_buffer_size_of_0_fails)
+{
+    // arrange
+    size_t receive_size = 0;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+
+    // act
+    int result = socketio_setoption(socket_io, OPTION_RECEIVE_BUFFER_SIZE, &receive_size);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+}
+
+TEST_FUNCTION(socketio_receives_at_most_RECEIVE_BYTES_VALUE_bytes_at_a_time)
+{
+    // arrange
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    send_peer(peer, 1000);
+    run_until(socket_io, NULL, &test_context.received_size, 1000);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1000, test_context.received_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, large_bytes, 1000));
+    ASSERT_ARE_EQUAL(size_t, RECEIVE_BYTES_VALUE, test_context.largest_receive_size);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+TEST_FUNCTION(socketio_setoption_receive_buffer_size_smaller_than_RECEIVE_BYTES_VALUE_limits_each_receive)
+{
+    // arrange
+    size_t receive_size = 16;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    int result = socketio_setoption(socket_io, OPTION_RECEIVE_BUFFER_SIZE, &receive_size);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    send_peer(peer, 100);
+    run_until(socket_io, NULL, &test_context.received_size, 100);
+    ASSERT_ARE_EQUAL(size_t, 100, test_context.received_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, large_bytes, 100));
+    ASSERT_ARE_EQUAL(size_t, 16, test_context.largest_receive_size);
+    ASSERT_ARE_EQUAL(size_t, 7, test_context.receive_count);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+TEST_FUNCTION(socketio_setoption_receive_buffer_size_larger_than_RECEIVE_BYTES_VALUE_receives_more_at_a_time)
+{
+    // arrange
+    size_t receive_size = 4096;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    int result = socketio_setoption(socket_io, OPTION_RECEIVE_BUFFER_SIZE, &receive_size);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    send_peer(peer, 4000);
+    run_until(socket_io, NULL, &test_context.received_size, 4000);
+    ASSERT_ARE_EQUAL(size_t, 4000, test_context.received_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, large_bytes, 4000));
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.receive_count);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* the receive buffer grows until it holds what the socket has, which is indicated with one on_bytes_received */
+TEST_FUNCTION(socketio_setoption_receive_batched_indicates_what_the_socket_has_at_once)
+{
+    // arrange
+    bool receive_batched = true;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    int result = socketio_setoption(socket_io, OPTION_RECEIVE_BATCHED, &receive_batched);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    send_peer(peer, TEST_BATCH_SIZE);
+    run_until(socket_io, NULL, &test_context.received_size, TEST_BATCH_SIZE);
+    ASSERT_ARE_EQUAL(size_t, TEST_BATCH_SIZE, test_context.received_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, large_bytes, TEST_BATCH_SIZE));
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.receive_count);
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.error_count);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* the buffer keeps the size it grew to until the receives are unbatched again */
+TEST_FUNCTION(socketio_setoption_receive_batched_false_goes_back_to_the_receive_buffer_size)
+{
+    // arrange
+    bool receive_batched = true;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, OPTION_RECEIVE_BATCHED, &receive_batched));
+    send_peer(peer, TEST_BATCH_SIZE);
+    run_until(socket_io, NULL, &test_context.received_size, TEST_BATCH_SIZE);
+    ASSERT_ARE_EQUAL(size_t, TEST_BATCH_SIZE, test_context.largest_receive_size);
+    test_context.received_size = 0;
+    test_context.receive_count = 0;
+    test_context.largest_receive_size = 0;
+    receive_batched = false;
+
+    // act
+    int result = socketio_setoption(socket_io, OPTION_RECEIVE_BATCHED, &receive_batched);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    send_peer(peer, 1000);
+    run_until(socket_io, NULL, &test_context.received_size, 1000);
+    ASSERT_ARE_EQUAL(size_t, 1000, test_context.received_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, large_bytes, 1000));
+    ASSERT_ARE_EQUAL(size_t, RECEIVE_BYTES_VALUE, test_context.largest_receive_size);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* the bytes the peer sent before closing are indicated before the error */
+TEST_FUNCTION(socketio_setoption_receive_batched_indicates_the_bytes_before_the_peer_closed)
+{
+    // arrange
+    bool receive_batched = true;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, OPTION_RECEIVE_BATCHED, &receive_batched));
+
+    // act
+    send_peer(peer, 100);
+    (void)close(peer);
+    run_until(socket_io, NULL, &test_context.error_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.error_count);
+    ASSERT_ARE_EQUAL(size_t, 100, test_context.received_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, large_bytes, 100));
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.receive_count);
+
+    // cleanup
+    socketio_destroy(socket_io);
+}
+
+/* connecting */
+
+/* socketio_open starts the connect and returns, the open is indicated once socketio_dowork finds the socket writable */
+TEST_FUNCTION(socketio_open_returns_while_opening_and_dowork_completes_the_open)
+{
+    // arrange
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer;
+
+    // act
+    int result = socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.open_complete_count);
+    ASSERT_ARE_NOT_EQUAL(int, 0, socketio_send(socket_io, "a", 1, NULL, NULL));
+    run_until(socket_io, NULL, &test_context.open_complete_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_OK, test_context.open_result);
+    peer = accept_peer();
+    ASSERT_ARE_EQUAL(int, 0, socketio_send(socket_io, "a", 1, NULL, NULL));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* with an event loop the open is indicated when the loop reports the socket writable */
+TEST_FUNCTION(socketio_open_of_an_event_loop_is_completed_by_the_loop)
+{
+    // arrange
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = socketio_event_loop_create();
+    CONCRETE_IO_HANDLE socket_io;
+    int peer;
+    ASSERT_IS_NOT_NULL(event_loop);
+    socket_io = create_socket_io(event_loop);
+
+    // act
+    int result = socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.open_complete_count);
+    run_until(NULL, event_loop, &test_context.open_complete_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_OK, test_context.open_result);
+    peer = accept_peer();
+
+    // cleanup
+    socketio_destroy(socket_io);
+    socketio_event_loop_destroy(event_loop);
+    (void)close(peer);
+}
+
+/* the refusal comes either from connect or from the writable check */
+TEST_FUNCTION(socketio_open_to_a_closed_port_fails_with_the_connect_error)
+{
+    // arrange
+    int closed_port;
+    int closed_socket = create_listen_socket(&closed_port);
+    CONCRETE_IO_HANDLE socket_io;
+    ASSERT_ARE_NOT_EQUAL(int, -1, closed_socket);
+    (void)close(closed_socket);
+    socket_io = create_socket_io_to_port(NULL, closed_port);
+
+    // act
+    (void)socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context);
+    run_until(socket_io, NULL, &test_context.open_complete_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_ERROR, test_context.open_result);
+    ASSERT_ARE_EQUAL(int, ECONNREFUSED, test_context.open_code);
+
+    // cleanup
+    socketio_destroy(socket_io);
+}
+
+TEST_FUNCTION(socketio_open_of_a_stalled_connect_fails_with_CONNECT_TIMEOUT_ERROR_CODE)
+{
+    // arrange
+    int fillers[TEST_BACKLOG_FILLER_COUNT];
+    int stalled_port;
+    int stalled_listen_socket = create_stalled_listen_socket(fillers, &stalled_port);
+    unsigned int connect_timeout_ms = TEST_CONNECT_TIMEOUT_MS;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io_to_port(NULL, stalled_port);
+    ASSERT_ARE_NOT_EQUAL(int, -1, stalled_listen_socket);
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, OPTION_CONNECT_TIMEOUT, &connect_timeout_ms));
+
+    // act
+    int result = socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ThreadAPI_Sleep(TEST_CONNECT_TIMEOUT_MS / 2);
+    socketio_dowork(socket_io);
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.open_complete_count);
+    run_until(socket_io, NULL, &test_context.open_complete_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_ERROR, test_context.open_result);
+    ASSERT_ARE_EQUAL(int, TEST_CONNECT_TIMEOUT_ERROR_CODE, test_context.open_code);
+    /* the socket IO is closed again and can be opened */
+    ASSERT_ARE_EQUAL(int, 0, socketio_close(socket_io, on_io_close_complete, &test_context));
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    close_stalled_listen_socket(stalled_listen_socket, fillers);
+}
+
+/* the timer of the loop fires the timeout, socketio_dowork is never called */
+TEST_FUNCTION(socketio_open_of_an_event_loop_with_a_stalled_connect_times_out_from_the_loop)
+{
+    // arrange
+    int fillers[TEST_BACKLOG_FILLER_COUNT];
+    int stalled_port;
+    int stalled_listen_socket = create_stalled_listen_socket(fillers, &stalled_port);
+    unsigned int connect_timeout_ms = TEST_CONNECT_TIMEOUT_MS;
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = socketio_event_loop_create();
+    CONCRETE_IO_HANDLE socket_io;
+    ASSERT_ARE_NOT_EQUAL(int, -1, stalled_listen_socket);
+    ASSERT_IS_NOT_NULL(event_loop);
+    socket_io = create_socket_io_to_port(event_loop, stalled_port);
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, OPTION_CONNECT_TIMEOUT, &connect_timeout_ms));
+
+    // act
+    int result = socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    run_until(NULL, event_loop, &test_context.open_complete_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_ERROR, test_context.open_result);
+    ASSERT_ARE_EQUAL(int, TEST_CONNECT_TIMEOUT_ERROR_CODE, test_context.open_code);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    socketio_event_loop_destroy(event_loop);
+    close_stalled_listen_socket(stalled_listen_socket, fillers);
+}
+
+/* the option also applies to the connect in progress */
+TEST_FUNCTION(socketio_setoption_connect_timeout_while_opening_times_out_the_connect)
+{
+    // arrange
+    int fillers[TEST_BACKLOG_FILLER_COUNT];
+    int stalled_port;
+    int stalled_listen_socket = create_stalled_listen_socket(fillers, &stalled_port);
+    unsigned int connect_timeout_ms = TEST_CONNECT_TIMEOUT_MS;
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = socketio_event_loop_create();
+    CONCRETE_IO_HANDLE socket_io;
+    ASSERT_ARE_NOT_EQUAL(int, -1, stalled_listen_socket);
+    ASSERT_IS_NOT_NULL(event_loop);
+    socket_io = create_socket_io_to_port(event_loop, stalled_port);
+    ASSERT_ARE_EQUAL(int, 0, socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context));
+
+    // act
+    int result = socketio_setoption(socket_io, OPTION_CONNECT_TIMEOUT, &connect_timeout_ms);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    run_until(NULL, event_loop, &test_context.open_complete_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_ERROR, test_context.open_result);
+    ASSERT_ARE_EQUAL(int, TEST_CONNECT_TIMEOUT_ERROR_CODE, test_context.open_code);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    socketio_event_loop_destroy(event_loop);
+    close_stalled_listen_socket(stalled_listen_socket, fillers);
+}
+
+TEST_FUNCTION(socketio_close_while_opening_cancels_the_open)
+{
+    // arrange
+    int fillers[TEST_BACKLOG_FILLER_COUNT];
+    int stalled_port;
+    int stalled_listen_socket = create_stalled_listen_socket(fillers, &stalled_port);
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = socketio_event_loop_create();
+    CONCRETE_IO_HANDLE socket_io;
+    ASSERT_ARE_NOT_EQUAL(int, -1, stalled_listen_socket);
+    ASSERT_IS_NOT_NULL(event_loop);
+    socket_io = create_socket_io_to_port(event_loop, stalled_port);
+    ASSERT_ARE_EQUAL(int, 0, socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context));
+
+    // act
+    int result = socketio_close(socket_io, on_io_close_complete, &test_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.close_complete_count);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_CANCELLED, test_context.open_result);
+    /* nothing is left for the loop to indicate */
+    (void)socketio_event_loop_run_once(event_loop, 10);
+    socketio_dowork(socket_io);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    socketio_event_loop_destroy(event_loop);
+    close_stalled_listen_socket(stalled_listen_socket, fillers);
+}
+
+/* there is no socket while connecting, the TCP options are set on the socket of the connect attempt */
+TEST_FUNCTION(socketio_setoption_tcp_options_before_and_while_opening_are_set_on_the_socket)
+{
+    // arrange
+    int keepalive = 1;
+    int nodelay = 1;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer;
+    int socket_of_peer;
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, "tcp_keepalive", &keepalive));
+    ASSERT_ARE_EQUAL(int, 0, socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context));
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.open_complete_count);
+
+    // act
+    int result = socketio_setoption(socket_io, "tcp_nodelay", &nodelay);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    run_until(socket_io, NULL, &test_context.open_complete_count, 1);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_OK, test_context.open_result);
+    peer = accept_peer();
+    socket_of_peer = find_socket_of_peer(peer);
+    ASSERT_ARE_NOT_EQUAL(int, -1, socket_of_peer);
+    ASSERT_ARE_NOT_EQUAL(int, 0, get_socket_option(socket_of_peer, SOL_SOCKET, SO_KEEPALIVE));
+    ASSERT_ARE_NOT_EQUAL(int, 0, get_socket_option(socket_of_peer, IPPROTO_TCP, TCP_NODELAY));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* once open the options go to the socket at once */
+TEST_FUNCTION(socketio_setoption_tcp_nodelay_when_open_is_set_on_the_socket)
+{
+    // arrange
+    int nodelay = 1;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    int socket_of_peer = find_socket_of_peer(peer);
+    ASSERT_ARE_NOT_EQUAL(int, -1, socket_of_peer);
+    ASSERT_ARE_EQUAL(int, 0, get_socket_option(socket_of_peer, IPPROTO_TCP, TCP_NODELAY));
+
+    // act
+    int result = socketio_setoption(socket_io, "tcp_nodelay", &nodelay);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_NOT_EQUAL(int, 0, get_socket_option(socket_of_peer, IPPROTO_TCP, TCP_NODELAY));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* unix_socket_path */
+
+/* the host name is not resolved, the socket IO connects to the Unix domain socket and sends and receives over it */
+TEST_FUNCTION(socketio_open_with_unix_socket_path_connects_to_the_path)
+{
+    // arrange
+    char path[64] = "/tmp/socketio_berkeley_loopback_ut_XXXXXX";
+    unsigned char received[5];
+    TEST_SEND test_send = { &test_context, 0 };
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int unix_listen_socket;
+    int peer;
+    ASSERT_IS_NOT_NULL(mkdtemp(path));
+    (void)strcat(path, "/s");
+    unix_listen_socket = create_unix_listen_socket(path);
+    ASSERT_ARE_NOT_EQUAL(int, -1, unix_listen_socket);
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, OPTION_UNIX_SOCKET_PATH, path));
+
+    // act
+    ASSERT_ARE_EQUAL(int, 0, socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context));
+    run_until(socket_io, NULL, &test_context.open_complete_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_OK, test_context.open_result);
+    peer = accept(unix_listen_socket, NULL, NULL);
+    ASSERT_ARE_NOT_EQUAL(int, -1, peer);
+    ASSERT_ARE_EQUAL(int, 0, socketio_send(socket_io, "hello", 5, on_send_complete, &test_send));
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.send_complete_count);
+    ASSERT_ARE_EQUAL(size_t, 5, read_peer(peer, received, 5));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(received, "hello", 5));
+    ASSERT_ARE_EQUAL(int, 4, (int)send(peer, "ping", 4, 0));
+    run_until(socket_io, NULL, &test_context.received_size, 4);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, "ping", 4));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+    (void)close(unix_listen_socket);
+    (void)unlink(path);
+    path[strlen(path) - 2] = '\0';
+    (void)rmdir(path);
+}
+
+/* a path starting with '@' names a socket of the abstract namespace */
+TEST_FUNCTION(socketio_open_with_an_abstract_unix_socket_path_connects)
+{
+    // arrange
+    int unix_listen_socket = create_unix_listen_socket(TEST_ABSTRACT_PATH);
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer;
+    ASSERT_ARE_NOT_EQUAL(int, -1, unix_listen_socket);
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, OPTION_UNIX_SOCKET_PATH, TEST_ABSTRACT_PATH));
+
+    // act
+    ASSERT_ARE_EQUAL(int, 0, socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context));
+    run_until(socket_io, NULL, &test_context.open_complete_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_OK, test_context.open_result);
+    peer = accept(unix_listen_socket, NULL, NULL);
+    ASSERT_ARE_NOT_EQUAL(int, -1, peer);
+    ASSERT_ARE_EQUAL(int, 4, (int)send(peer, "ping", 4, 0));
+    run_until(socket_io, NULL, &test_context.received_size, 4);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, "ping", 4));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+    (void)close(unix_listen_socket);
+}
+
+TEST_FUNCTION(socketio_open_of_an_event_loop_with_an_abstract_unix_socket_path_connects)
+{
+    // arrange
+    int unix_listen_socket = create_unix_listen_socket(TEST_ABSTRACT_PATH);
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = socketio_event_loop_create();
+    CONCRETE_IO_HANDLE socket_io;
+    int peer;
+    ASSERT_ARE_NOT_EQUAL(int, -1, unix_listen_socket);
+    ASSERT_IS_NOT_NULL(event_loop);
+    socket_io = create_socket_io(event_loop);
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, OPTION_UNIX_SOCKET_PATH, TEST_ABSTRACT_PATH));
+
+    // act
+    ASSERT_ARE_EQUAL(int, 0, socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context));
+    run_until(NULL, event_loop, &test_context.open_complete_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_OK, test_context.open_result);
+    peer = accept(unix_listen_socket, NULL, NULL);
+    ASSERT_ARE_NOT_EQUAL(int, -1, peer);
+    ASSERT_ARE_EQUAL(int, 4, (int)send(peer, "ping", 4, 0));
+    run_until(NULL, event_loop, &test_context.received_size, 4);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, "ping", 4));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    socketio_event_loop_destroy(event_loop);
+    (void)close(peer);
+    (void)close(unix_listen_socket);
+}
+
+/* the connect to a local socket is refused at once */
+TEST_FUNCTION(socketio_open_with_a_unix_socket_path_nobody_listens_on_fails)
+{
+    // arrange
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, OPTION_UNIX_SOCKET_PATH, "/nonexistent/socketio_berkeley_loopback_ut"));
+
+    // act
+    int result = socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_ERROR, test_context.open_result);
+    ASSERT_ARE_EQUAL(int, ENOENT, test_context.open_code);
+
+    // cleanup
+    socketio_destroy(socket_io);
+}
+
+TEST_FUNCTION(socketio_open_with_a_unix_socket_path_longer_than_sun_path_fails)
+{
+    // arrange
+    char path[sizeof(((struct sockaddr_un*)NULL)->sun_path) + 2];
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    (void)memset(path, 'a', sizeof(path) - 1);
+    path[0] = '/';
+    path[sizeof(path) - 1] = '\0';
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, OPTION_UNIX_SOCKET_PATH, path));
+
+    // act
+    int result = socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_ERROR, test_context.open_result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+}
+
+/* an empty path goes back to connecting to the host name and port */
+TEST_FUNCTION(socketio_setoption_with_an_empty_unix_socket_path_connects_to_the_host)
+{
+    // arrange
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer;
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, OPTION_UNIX_SOCKET_PATH, "/nonexistent/socketio_berkeley_loopback_ut"));
+
+    // act
+    int result = socketio_setoption(socket_io, OPTION_UNIX_SOCKET_PATH, "");
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* the layers above set the TCP options without knowing the transport */
+TEST_FUNCTION(socketio_setoption_tcp_nodelay_with_a_unix_socket_path_succeeds)
+{
+    // arrange
+    int value = 1;
+    int unix_listen_socket = create_unix_listen_socket(TEST_ABSTRACT_PATH);
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer;
+    ASSERT_ARE_NOT_EQUAL(int, -1, unix_listen_socket);
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, OPTION_UNIX_SOCKET_PATH, TEST_ABSTRACT_PATH));
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, "tcp_keepalive", &value));
+    ASSERT_ARE_EQUAL(int, 0, socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context));
+    run_until(socket_io, NULL, &test_context.open_complete_count, 1);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_OK, test_context.open_result);
+    peer = accept(unix_listen_socket, NULL, NULL);
+    ASSERT_ARE_NOT_EQUAL(int, -1, peer);
+
+    // act
+    int result = socketio_setoption(socket_io, "tcp_nodelay", &value);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+    (void)close(unix_listen_socket);
+}
+
+/* event_loop */
+
+/* the loop runs the socket, socketio_dowork does not have to be called */
+TEST_FUNCTION(socketio_setoption_event_loop_while_open_fails)
+{
+    // arrange
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = socketio_event_loop_create();
+    ASSERT_IS_NOT_NULL(event_loop);
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    int result = socketio_setoption(socket_io, OPTION_EVENT_LOOP, event_loop);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    socketio_event_loop_destroy(event_loop);
+    (void)close(peer);
+}
+
+/* a closed socket IO can be given a loop, its next open runs on the loop */
+TEST_FUNCTION(socketio_setoption_event_loop_after_close_opens_on_the_loop)
+{
+    // arrange
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = socketio_event_loop_create();
+    ASSERT_IS_NOT_NULL(event_loop);
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    ASSERT_ARE_EQUAL(int, 0, socketio_close(socket_io, NULL, NULL));
+    (void)close(peer);
+    (void)memset(&test_context, 0, sizeof(test_context));
+
+    // act
+    int result = socketio_setoption(socket_io, OPTION_EVENT_LOOP, event_loop);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    peer = open_socket_io(socket_io, event_loop, &test_context);
+    send_peer(peer, 10);
+    run_until(NULL, event_loop, &test_context.received_size, 10);
+    ASSERT_ARE_EQUAL(size_t, 10, test_context.received_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, large_bytes, 10));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    socketio_event_loop_destroy(event_loop);
+    (void)close(peer);
+}
+
+/* the receive buffer of the event loop */
+
+/* the socket IOs of a loop have no receive buffer of their own, they receive in the one of the loop */
+TEST_FUNCTION(socketio_of_an_event_loop_receives_in_the_buffer_of_the_loop)
+{
+    // arrange
+    static TEST_CONTEXT other_context;
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = socketio_event_loop_create();
+    CONCRETE_IO_HANDLE socket_io;
+    CONCRETE_IO_HANDLE other_socket_io;
+    unsigned char* loop_buffer;
+    size_t loop_buffer_size = 0;
+    int peer;
+    int other_peer;
+    ASSERT_IS_NOT_NULL(event_loop);
+    (void)memset(&other_context, 0, sizeof(other_context));
+    loop_buffer = socketio_event_loop_get_receive_buffer(event_loop, &loop_buffer_size);
+    ASSERT_IS_NOT_NULL(loop_buffer);
+    socket_io = create_socket_io(event_loop);
+    other_socket_io = create_socket_io(event_loop);
+    peer = open_socket_io(socket_io, event_loop, &test_context);
+    other_peer = open_socket_io(other_socket_io, event_loop, &other_context);
+
+    // act
+    send_peer(peer, 1000);
+    send_peer(other_peer, 1000);
+    run_until(NULL, event_loop, &test_context.received_size, 1000);
+    run_until(NULL, event_loop, &other_context.received_size, 1000);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1000, test_context.received_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, large_bytes, 1000));
+    ASSERT_ARE_EQUAL(size_t, 1000, other_context.received_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(other_context.received, large_bytes, 1000));
+    ASSERT_IS_TRUE(test_context.last_receive_buffer == loop_buffer);
+    ASSERT_IS_TRUE(other_context.last_receive_buffer == loop_buffer);
+    /* the buffer of the loop is larger than RECEIVE_BYTES_VALUE, what the socket has is received at once */
+    ASSERT_IS_TRUE(loop_buffer_size >= 1000);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.receive_count);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    socketio_destroy(other_socket_io);
+    socketio_event_loop_destroy(event_loop);
+    (void)close(peer);
+    (void)close(other_peer);
+}
+
+/* a batched receive in the buffer of the loop does not grow it */
+TEST_FUNCTION(socketio_of_an_event_loop_with_receive_batched_receives_in_the_buffer_of_the_loop)
+{
+    // arrange
+    bool receive_batched = true;
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = socketio_event_loop_create();
+    CONCRETE_IO_HANDLE socket_io;
+    unsigned char* loop_buffer;
+    size_t loop_buffer_size = 0;
+    int peer;
+    ASSERT_IS_NOT_NULL(event_loop);
+    loop_buffer = socketio_event_loop_get_receive_buffer(event_loop, &loop_buffer_size);
+    socket_io = create_socket_io(event_loop);
+    peer = open_socket_io(socket_io, event_loop, &test_context);
+
+    // act
+    int result = socketio_setoption(socket_io, OPTION_RECEIVE_BATCHED, &receive_batched);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    send_peer(peer, TEST_BATCH_SIZE);
+    run_until(NULL, event_loop, &test_context.received_size, TEST_BATCH_SIZE);
+    ASSERT_ARE_EQUAL(size_t, TEST_BATCH_SIZE, test_context.received_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, large_bytes, TEST_BATCH_SIZE));
+    ASSERT_IS_TRUE(test_context.last_receive_buffer == loop_buffer);
+    ASSERT_IS_TRUE(test_context.largest_receive_size <= loop_buffer_size);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    socketio_event_loop_destroy(event_loop);
+    (void)close(peer);
+}
+
+/* the receive_buffer_size option gives the socket IO its own buffer, the other socket IOs of the loop keep receiving in the one of the loop */
+TEST_FUNCTION(socketio_setoption_receive_buffer_size_gives_a_socket_io_of_an_event_loop_its_own_buffer)
+{
+    // arrange
+    static TEST_CONTEXT other_context;
+    size_t receive_size = 16;
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = socketio_event_loop_create();
+    CONCRETE_IO_HANDLE socket_io;
+    CONCRETE_IO_HANDLE other_socket_io;
+    unsigned char* loop_buffer;
+    size_t loop_buffer_size = 0;
+    int peer;
+    int other_peer;
+    ASSERT_IS_NOT_NULL(event_loop);
+    (void)memset(&other_context, 0, sizeof(other_context));
+    loop_buffer = socketio_event_loop_get_receive_buffer(event_loop, &loop_buffer_size);
+    socket_io = create_socket_io(event_loop);
+    other_socket_io = create_socket_io(event_loop);
+    peer = open_socket_io(socket_io, event_loop, &test_context);
+    other_peer = open_socket_io(other_socket_io, event_loop, &other_context);
+
+    // act
+    int result = socketio_setoption(socket_io, OPTION_RECEIVE_BUFFER_SIZE, &receive_size);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    send_peer(peer, 100);
+    send_peer(other_peer, 100);
+    run_until(NULL, event_loop, &test_context.received_size, 100);
+    run_until(NULL, event_loop, &other_context.received_size, 100);
+    ASSERT_ARE_EQUAL(size_t, 100, test_context.received_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, large_bytes, 100));
+    ASSERT_IS_NOT_NULL(test_context.last_receive_buffer);
+    ASSERT_IS_TRUE(test_context.last_receive_buffer != loop_buffer);
+    ASSERT_ARE_EQUAL(size_t, 16, test_context.largest_receive_size);
+    ASSERT_ARE_EQUAL(size_t, 100, other_context.received_size);
+    ASSERT_IS_TRUE(other_context.last_receive_buffer == loop_buffer);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    socketio_destroy(other_socket_io);
+    socketio_event_loop_destroy(event_loop);
+    (void)close(peer);
+    (void)close(other_peer);
+}
+
+END_TEST_SUITE(socketio_berkeley_loopback_unittests)
@@ -14,6 +14,8 @@
 #include "azure_c_shared_utility/singlylinkedlist.h"
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/optionhandler.h"
+#include "azure_c_shared_utility/conststring.h"
+#include "azure_c_shared_utility/dns_resolver.h"
 
 #undef ENABLE_MOCKS
 
@@ -0,0 +1,1357 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include "testrunnerswitcher.h"
+#include "azure_c_shared_utility/socketio_event_loop.h"
+
+/* the event loop runs on a real epoll instance, the tests make the sockets ready by writing to and closing the other end of socket pairs */
+#define TEST_WAIT_MS            5000
+#define TEST_SHORT_WAIT_MS      20
+#define TEST_TIMER_DELAY_MS     50
+#define TEST_RECEIVE_BUFFER_SIZE (64 * 1024)
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+typedef struct TEST_REGISTRATION_TAG
+{
+    struct TEST_CONTEXT_TAG* context;
+    int sockets[2];
+    SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE registration;
+    size_t event_count;
+    unsigned int events;
+} TEST_REGISTRATION;
+
+typedef struct TEST_TIMER_TAG
+{
+    struct TEST_CONTEXT_TAG* context;
+    SOCKETIO_EVENT_LOOP_TIMER_HANDLE timer;
+    size_t call_count;
+    unsigned int restart_delay_ms;
+    bool restart_on_call;
+    bool destroy_on_call;
+} TEST_TIMER;
+
+typedef struct TEST_CONTEXT_TAG
+{
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop;
+    TEST_REGISTRATION registrations[2];
+    TEST_TIMER timers[2];
+    size_t call_count;
+    /* what the callback of the run does to both registrations or both timers */
+    bool unregister_all_on_event;
+    bool destroy_timers_on_event;
+    bool destroy_all_on_timer;
+    bool run_on_event;
+    int run_result;
+    size_t destroy_count;
+    void* destroyed_context;
+} TEST_CONTEXT;
+
+static TEST_CONTEXT test_context;
+static volatile sig_atomic_t signal_count;
+
+static uint64_t get_time_ms(void)
+{
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000) + ((uint64_t)now.tv_nsec / 1000000);
+}
+
+static void on_event(void* context, unsigned int events)
+{
+    TEST_REGISTRATION* test = (TEST_REGISTRATION*)context;
+    test->event_count++;
+    test->events = events;
+    test->context->call_count++;
+
+    if (test->context->unregister_all_on_event)
+    {
+        size_t i;
+        for (i = 0; i < 2; i++)
+        {
+            socketio_event_loop_unregister(test->context->registrations[i].registration);
+            test->context->registrations[i].registration = NULL;
+        }
+    }
+
+    if (test->context->destroy_timers_on_event)
+    {
+        size_t i;
+        for (i = 0; i < 2; i++)
+        {
+            socketio_event_loop_destroy_timer(test->context->timers[i].timer);
+            test->context->timers[i].timer = NULL;
+        }
+    }
+
+    if (test->context->run_on_event)
+    {
+        test->context->run_result = socketio_event_loop_run_once(test->context->event_loop, 0);
+    }
+}
+
+static void on_timer(void* context)
+{
+    TEST_TIMER* test = (TEST_TIMER*)context;
+    test->call_count++;
+    test->context->call_count++;
+
+    if (test->restart_on_call)
+    {
+        ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_start_timer(test->timer, test->restart_delay_ms));
+    }
+
+    if (test->destroy_on_call)
+    {
+        socketio_event_loop_destroy_timer(test->timer);
+        test->timer = NULL;
+    }
+
+    if (test->context->destroy_all_on_timer)
+    {
+        size_t i;
+        for (i = 0; i < 2; i++)
+        {
+            socketio_event_loop_destroy_timer(test->context->timers[i].timer);
+            test->context->timers[i].timer = NULL;
+        }
+    }
+}
+
+static void on_destroy(void* context)
+{
+    test_context.destroy_count++;
+    test_context.destroyed_context = context;
+}
+
+static void on_signal(int signal_number)
+{
+    (void)signal_number;
+    signal_count++;
+}
+
+/* a socket pair whose sockets[0] is registered, the tests make it readable by writing to sockets[1] */
+static void create_socket_pair(TEST_REGISTRATION* test)
+{
+    test->context = &test_context;
+    ASSERT_ARE_EQUAL(int, 0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, test->sockets));
+}
+
+static void register_socket_pair(TEST_REGISTRATION* test, unsigned int events)
+{
+    create_socket_pair(test);
+    test->registration = socketio_event_loop_register(test_context.event_loop, test->sockets[0], events, on_event, test);
+    ASSERT_IS_NOT_NULL(test->registration);
+}
+
+static void close_socket_pair(TEST_REGISTRATION* test)
+{
+    socketio_event_loop_unregister(test->registration);
+    test->registration = NULL;
+    if (test->sockets[0] != -1)
+    {
+        (void)close(test->sockets[0]);
+    }
+    if (test->sockets[1] != -1)
+    {
+        (void)close(test->sockets[1]);
+    }
+}
+
+static void create_test_timer(TEST_TIMER* test)
+{
+    test->context = &test_context;
+    test->timer = socketio_event_loop_create_timer(test_context.event_loop, on_timer, test);
+    ASSERT_IS_NOT_NULL(test->timer);
+}
+
+static void run_until(const size_t* counter, size_t expected)
+{
+    uint64_t start_ms = get_time_ms();
+    while ((*counter < expected) && (get_time_ms() - start_ms < TEST_WAIT_MS))
+    {
+        ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, TEST_SHORT_WAIT_MS));
+    }
+}
+
+/* the first descriptor from first_fd on that is an epoll instance, the tests have no other epoll instance than the ones of their loops */
+static int find_epoll_fd(int first_fd)
+{
+    int result = -1;
+    int fd;
+    for (fd = first_fd; (fd < 1024) && (result == -1); fd++)
+    {
+        char path[64];
+        char target[64];
+        ssize_t target_length;
+        (void)snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+        target_length = readlink(path, target, sizeof(target) - 1);
+        if (target_length > 0)
+        {
+            target[target_length] = '\0';
+            if (strcmp(target, "anon_inode:[eventpoll]") == 0)
+            {
+                result = fd;
+            }
+        }
+    }
+    return result;
+}
+
+BEGIN_TEST_SUITE(socketio_event_loop_unittests)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    (void)memset(&test_context, 0, sizeof(test_context));
+    test_context.event_loop = socketio_event_loop_create();
+    ASSERT_IS_NOT_NULL(test_context.event_loop);
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    socketio_event_loop_destroy(test_context.event_loop);
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* socketio_event_loop_create */
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_001: [ socketio_event_loop_create shall create an epoll instance and return a non-NULL handle. ]*/
+TEST_FUNCTION(socketio_event_loop_create_creates_an_epoll_instance)
+{
+    // arrange
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop;
+    int epoll_fd;
+    int other_epoll_fd;
+
+    // act
+    event_loop = socketio_event_loop_create();
+
+    // assert
+    ASSERT_IS_NOT_NULL(event_loop);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, (void*)test_context.event_loop, (void*)event_loop);
+    /* the loop of the test and this one */
+    epoll_fd = find_epoll_fd(0);
+    ASSERT_ARE_NOT_EQUAL(int, -1, epoll_fd);
+    other_epoll_fd = find_epoll_fd(epoll_fd + 1);
+    ASSERT_ARE_NOT_EQUAL(int, -1, other_epoll_fd);
+
+    // cleanup
+    socketio_event_loop_destroy(event_loop);
+}
+
+/* socketio_event_loop_destroy */
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_003: [ If event_loop is NULL, socketio_event_loop_destroy shall return. ]*/
+TEST_FUNCTION(socketio_event_loop_destroy_with_NULL_event_loop_returns)
+{
+    // arrange
+
+    // act
+    socketio_event_loop_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.destroy_count);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_004: [ socketio_event_loop_destroy shall close the epoll instance and free the event loop. ]*/
+TEST_FUNCTION(socketio_event_loop_destroy_closes_the_epoll_instance)
+{
+    // arrange
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop;
+    socketio_event_loop_destroy(test_context.event_loop);
+    test_context.event_loop = NULL;
+    event_loop = socketio_event_loop_create();
+    ASSERT_IS_NOT_NULL(event_loop);
+    ASSERT_ARE_NOT_EQUAL(int, -1, find_epoll_fd(0));
+
+    // act
+    socketio_event_loop_destroy(event_loop);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, -1, find_epoll_fd(0));
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_028: [ If a context was set, socketio_event_loop_destroy shall first call its on_destroy with it, while the registrations it made can still be removed. ]*/
+TEST_FUNCTION(socketio_event_loop_destroy_calls_on_destroy_with_the_context)
+{
+    // arrange
+    int context;
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_set_context(test_context.event_loop, &context, on_destroy));
+
+    // act
+    socketio_event_loop_destroy(test_context.event_loop);
+    test_context.event_loop = NULL;
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.destroy_count);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)&context, test_context.destroyed_context);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_028: [ If a context was set, socketio_event_loop_destroy shall first call its on_destroy with it, while the registrations it made can still be removed. ]*/
+TEST_FUNCTION(socketio_event_loop_destroy_with_a_context_without_on_destroy_succeeds)
+{
+    // arrange
+    int context;
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_set_context(test_context.event_loop, &context, NULL));
+
+    // act
+    socketio_event_loop_destroy(test_context.event_loop);
+    test_context.event_loop = NULL;
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.destroy_count);
+}
+
+/* socketio_event_loop_register */
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_005: [ If event_loop or on_event is NULL or socket is negative, socketio_event_loop_register shall fail and return NULL. ]*/
+TEST_FUNCTION(socketio_event_loop_register_with_NULL_event_loop_fails)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE registration;
+    create_socket_pair(test);
+
+    // act
+    registration = socketio_event_loop_register(NULL, test->sockets[0], SOCKETIO_EVENT_READABLE, on_event, test);
+
+    // assert
+    ASSERT_IS_NULL(registration);
+
+    // cleanup
+    close_socket_pair(test);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_005: [ If event_loop or on_event is NULL or socket is negative, socketio_event_loop_register shall fail and return NULL. ]*/
+TEST_FUNCTION(socketio_event_loop_register_with_NULL_on_event_fails)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE registration;
+    create_socket_pair(test);
+
+    // act
+    registration = socketio_event_loop_register(test_context.event_loop, test->sockets[0], SOCKETIO_EVENT_READABLE, NULL, test);
+
+    // assert
+    ASSERT_IS_NULL(registration);
+
+    // cleanup
+    close_socket_pair(test);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_005: [ If event_loop or on_event is NULL or socket is negative, socketio_event_loop_register shall fail and return NULL. ]*/
+TEST_FUNCTION(socketio_event_loop_register_with_a_negative_socket_fails)
+{
+    // arrange
+    SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE registration;
+
+    // act
+    registration = socketio_event_loop_register(test_context.event_loop, -1, SOCKETIO_EVENT_READABLE, on_event, &test_context.registrations[0]);
+
+    // assert
+    ASSERT_IS_NULL(registration);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_006: [ socketio_event_loop_register shall add socket to the epoll instance, watched for events, and return a registration through which on_event is called with on_event_context and the events the socket is ready for. ]*/
+TEST_FUNCTION(socketio_event_loop_register_calls_on_event_when_the_socket_is_readable)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    register_socket_pair(test, SOCKETIO_EVENT_READABLE);
+    ASSERT_ARE_EQUAL(int, 1, (int)write(test->sockets[1], "a", 1));
+
+    // act
+    run_until(&test->event_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test->event_count);
+    ASSERT_ARE_EQUAL(int, SOCKETIO_EVENT_READABLE, (int)test->events);
+
+    // cleanup
+    close_socket_pair(test);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_006: [ socketio_event_loop_register shall add socket to the epoll instance, watched for events, and return a registration through which on_event is called with on_event_context and the events the socket is ready for. ]*/
+TEST_FUNCTION(socketio_event_loop_register_for_reads_does_not_report_a_writable_socket)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    register_socket_pair(test, SOCKETIO_EVENT_READABLE);
+
+    // act
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, TEST_SHORT_WAIT_MS));
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, test->event_count);
+
+    // cleanup
+    close_socket_pair(test);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_006: [ socketio_event_loop_register shall add socket to the epoll instance, watched for events, and return a registration through which on_event is called with on_event_context and the events the socket is ready for. ]*/
+TEST_FUNCTION(socketio_event_loop_register_for_reads_and_writes_reports_both)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    register_socket_pair(test, SOCKETIO_EVENT_READABLE | SOCKETIO_EVENT_WRITABLE);
+    ASSERT_ARE_EQUAL(int, 1, (int)write(test->sockets[1], "a", 1));
+
+    // act
+    run_until(&test->event_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test->event_count);
+    ASSERT_ARE_EQUAL(int, SOCKETIO_EVENT_READABLE | SOCKETIO_EVENT_WRITABLE, (int)test->events);
+
+    // cleanup
+    close_socket_pair(test);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_007: [ If any error occurs, socketio_event_loop_register shall fail and return NULL. ]*/
+TEST_FUNCTION(socketio_event_loop_register_of_a_registered_socket_fails)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE registration;
+    register_socket_pair(test, SOCKETIO_EVENT_READABLE);
+
+    // act
+    registration = socketio_event_loop_register(test_context.event_loop, test->sockets[0], SOCKETIO_EVENT_WRITABLE, on_event, test);
+
+    // assert
+    ASSERT_IS_NULL(registration);
+
+    // cleanup
+    close_socket_pair(test);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_007: [ If any error occurs, socketio_event_loop_register shall fail and return NULL. ]*/
+TEST_FUNCTION(socketio_event_loop_register_of_a_closed_socket_fails)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    SOCKETIO_EVENT_LOOP_REGISTRATION_HANDLE registration;
+    create_socket_pair(test);
+    (void)close(test->sockets[0]);
+
+    // act
+    registration = socketio_event_loop_register(test_context.event_loop, test->sockets[0], SOCKETIO_EVENT_READABLE, on_event, test);
+
+    // assert
+    ASSERT_IS_NULL(registration);
+
+    // cleanup
+    test->sockets[0] = -1;
+    close_socket_pair(test);
+}
+
+/* socketio_event_loop_modify */
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_008: [ If registration is NULL, socketio_event_loop_modify shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(socketio_event_loop_modify_with_NULL_registration_fails)
+{
+    // arrange
+    int result;
+
+    // act
+    result = socketio_event_loop_modify(NULL, SOCKETIO_EVENT_READABLE);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_009: [ socketio_event_loop_modify shall change the events the socket of registration is watched for to events and return 0. ]*/
+TEST_FUNCTION(socketio_event_loop_modify_to_writes_reports_the_socket_writable)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    int result;
+    register_socket_pair(test, SOCKETIO_EVENT_READABLE);
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, 0));
+    ASSERT_ARE_EQUAL(size_t, 0, test->event_count);
+
+    // act
+    result = socketio_event_loop_modify(test->registration, SOCKETIO_EVENT_READABLE | SOCKETIO_EVENT_WRITABLE);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    run_until(&test->event_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test->event_count);
+    ASSERT_ARE_EQUAL(int, SOCKETIO_EVENT_WRITABLE, (int)test->events);
+
+    // cleanup
+    close_socket_pair(test);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_009: [ socketio_event_loop_modify shall change the events the socket of registration is watched for to events and return 0. ]*/
+TEST_FUNCTION(socketio_event_loop_modify_to_reads_stops_reporting_the_socket_writable)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    int result;
+    register_socket_pair(test, SOCKETIO_EVENT_READABLE | SOCKETIO_EVENT_WRITABLE);
+    run_until(&test->event_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test->event_count);
+
+    // act
+    result = socketio_event_loop_modify(test->registration, SOCKETIO_EVENT_READABLE);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, TEST_SHORT_WAIT_MS));
+    ASSERT_ARE_EQUAL(size_t, 1, test->event_count);
+
+    // cleanup
+    close_socket_pair(test);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_010: [ If any error occurs, socketio_event_loop_modify shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(socketio_event_loop_modify_of_a_closed_socket_fails)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    int result;
+    register_socket_pair(test, SOCKETIO_EVENT_READABLE);
+    /* closing the socket takes it out of the epoll instance */
+    (void)close(test->sockets[0]);
+    test->sockets[0] = -1;
+
+    // act
+    result = socketio_event_loop_modify(test->registration, SOCKETIO_EVENT_WRITABLE);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    close_socket_pair(test);
+}
+
+/* socketio_event_loop_unregister */
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_011: [ If registration is NULL, socketio_event_loop_unregister shall return. ]*/
+TEST_FUNCTION(socketio_event_loop_unregister_with_NULL_registration_returns)
+{
+    // arrange
+
+    // act
+    socketio_event_loop_unregister(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, 0));
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_012: [ socketio_event_loop_unregister shall remove the socket of registration from the epoll instance, it has to be called before the socket is closed. ]*/
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_014: [ Otherwise socketio_event_loop_unregister shall free registration. ]*/
+TEST_FUNCTION(socketio_event_loop_unregister_stops_the_events_of_the_socket)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    register_socket_pair(test, SOCKETIO_EVENT_READABLE);
+    ASSERT_ARE_EQUAL(int, 1, (int)write(test->sockets[1], "a", 1));
+
+    // act
+    socketio_event_loop_unregister(test->registration);
+    test->registration = NULL;
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, TEST_SHORT_WAIT_MS));
+    ASSERT_ARE_EQUAL(size_t, 0, test->event_count);
+
+    // cleanup
+    close_socket_pair(test);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_012: [ socketio_event_loop_unregister shall remove the socket of registration from the epoll instance, it has to be called before the socket is closed. ]*/
+TEST_FUNCTION(socketio_event_loop_unregister_allows_registering_the_socket_again)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    register_socket_pair(test, SOCKETIO_EVENT_READABLE);
+    ASSERT_ARE_EQUAL(int, 1, (int)write(test->sockets[1], "a", 1));
+
+    // act
+    socketio_event_loop_unregister(test->registration);
+    test->registration = socketio_event_loop_register(test_context.event_loop, test->sockets[0], SOCKETIO_EVENT_READABLE, on_event, test);
+
+    // assert
+    ASSERT_IS_NOT_NULL(test->registration);
+    run_until(&test->event_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test->event_count);
+
+    // cleanup
+    close_socket_pair(test);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_013: [ When called from a callback of the running loop, socketio_event_loop_unregister shall stop the callbacks of registration and free it when the run ends, since events for it may still be waiting to be dispatched. ]*/
+TEST_FUNCTION(socketio_event_loop_unregister_from_a_callback_stops_the_callbacks_of_the_run)
+{
+    // arrange
+    size_t i;
+    for (i = 0; i < 2; i++)
+    {
+        register_socket_pair(&test_context.registrations[i], SOCKETIO_EVENT_READABLE);
+        ASSERT_ARE_EQUAL(int, 1, (int)write(test_context.registrations[i].sockets[1], "a", 1));
+    }
+    /* both sockets are ready, the first callback of the run unregisters both */
+    test_context.unregister_all_on_event = true;
+
+    // act
+    run_until(&test_context.call_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.call_count);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.registrations[0].event_count + test_context.registrations[1].event_count);
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, TEST_SHORT_WAIT_MS));
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.call_count);
+
+    // cleanup
+    for (i = 0; i < 2; i++)
+    {
+        close_socket_pair(&test_context.registrations[i]);
+    }
+}
+
+/* socketio_event_loop_run_once */
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_015: [ If event_loop is NULL, socketio_event_loop_run_once shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(socketio_event_loop_run_once_with_NULL_event_loop_fails)
+{
+    // arrange
+    int result;
+
+    // act
+    result = socketio_event_loop_run_once(NULL, 0);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_016: [ If called from a callback of the loop, socketio_event_loop_run_once shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(socketio_event_loop_run_once_from_a_callback_fails)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    register_socket_pair(test, SOCKETIO_EVENT_WRITABLE);
+    test_context.run_on_event = true;
+
+    // act
+    run_until(&test->event_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test->event_count);
+    ASSERT_ARE_NOT_EQUAL(int, 0, test_context.run_result);
+
+    // cleanup
+    close_socket_pair(test);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_017: [ socketio_event_loop_run_once shall wait up to timeout_ms milliseconds, or indefinitely if timeout_ms is negative, until at least one registered socket is ready. ]*/
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_019: [ A wait interrupted by a signal, or that timed out, shall not be an error. ]*/
+TEST_FUNCTION(socketio_event_loop_run_once_without_ready_sockets_waits_for_the_timeout)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    uint64_t start_ms;
+    int result;
+    register_socket_pair(test, SOCKETIO_EVENT_READABLE);
+    start_ms = get_time_ms();
+
+    // act
+    result = socketio_event_loop_run_once(test_context.event_loop, TEST_TIMER_DELAY_MS);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_TRUE(get_time_ms() - start_ms + 1 >= TEST_TIMER_DELAY_MS);
+    ASSERT_ARE_EQUAL(size_t, 0, test->event_count);
+
+    // cleanup
+    close_socket_pair(test);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_017: [ socketio_event_loop_run_once shall wait up to timeout_ms milliseconds, or indefinitely if timeout_ms is negative, until at least one registered socket is ready. ]*/
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_018: [ socketio_event_loop_run_once shall call the on_event callback of each ready registration once with the events it is ready for, and return 0. ]*/
+TEST_FUNCTION(socketio_event_loop_run_once_with_a_negative_timeout_returns_once_a_socket_is_ready)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    int result;
+    register_socket_pair(test, SOCKETIO_EVENT_READABLE);
+    ASSERT_ARE_EQUAL(int, 1, (int)write(test->sockets[1], "a", 1));
+
+    // act
+    result = socketio_event_loop_run_once(test_context.event_loop, -1);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, test->event_count);
+
+    // cleanup
+    close_socket_pair(test);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_018: [ socketio_event_loop_run_once shall call the on_event callback of each ready registration once with the events it is ready for, and return 0. ]*/
+TEST_FUNCTION(socketio_event_loop_run_once_calls_each_ready_registration_once)
+{
+    // arrange
+    size_t i;
+    int result;
+    for (i = 0; i < 2; i++)
+    {
+        register_socket_pair(&test_context.registrations[i], SOCKETIO_EVENT_READABLE);
+        ASSERT_ARE_EQUAL(int, 1, (int)write(test_context.registrations[i].sockets[1], "a", 1));
+    }
+
+    // act
+    result = socketio_event_loop_run_once(test_context.event_loop, TEST_WAIT_MS);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.registrations[0].event_count);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.registrations[1].event_count);
+
+    // cleanup
+    for (i = 0; i < 2; i++)
+    {
+        close_socket_pair(&test_context.registrations[i]);
+    }
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_018: [ socketio_event_loop_run_once shall call the on_event callback of each ready registration once with the events it is ready for, and return 0. ]*/
+TEST_FUNCTION(socketio_event_loop_run_once_reports_an_error_when_the_peer_closed)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    register_socket_pair(test, SOCKETIO_EVENT_WRITABLE);
+    (void)close(test->sockets[1]);
+    test->sockets[1] = -1;
+
+    // act
+    run_until(&test->event_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test->event_count);
+    ASSERT_ARE_EQUAL(int, SOCKETIO_EVENT_ERROR, (int)(test->events & SOCKETIO_EVENT_ERROR));
+
+    // cleanup
+    close_socket_pair(test);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_018: [ socketio_event_loop_run_once shall call the on_event callback of each ready registration once with the events it is ready for, and return 0. ]*/
+TEST_FUNCTION(socketio_event_loop_run_once_reports_an_error_not_asked_for)
+{
+    // arrange
+    TEST_REGISTRATION* test = &test_context.registrations[0];
+    register_socket_pair(test, 0);
+    (void)close(test->sockets[1]);
+    test->sockets[1] = -1;
+
+    // act
+    run_until(&test->event_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test->event_count);
+    ASSERT_ARE_EQUAL(int, SOCKETIO_EVENT_ERROR, (int)test->events);
+
+    // cleanup
+    close_socket_pair(test);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_019: [ A wait interrupted by a signal, or that timed out, shall not be an error. ]*/
+TEST_FUNCTION(socketio_event_loop_run_once_interrupted_by_a_signal_succeeds)
+{
+    // arrange
+    struct sigaction action;
+    struct sigaction previous_action;
+    struct itimerval interval;
+    int result;
+    (void)memset(&action, 0, sizeof(action));
+    action.sa_handler = on_signal;
+    (void)sigemptyset(&action.sa_mask);
+    ASSERT_ARE_EQUAL(int, 0, sigaction(SIGALRM, &action, &previous_action));
+    (void)memset(&interval, 0, sizeof(interval));
+    interval.it_value.tv_usec = TEST_SHORT_WAIT_MS * 1000;
+    signal_count = 0;
+    ASSERT_ARE_EQUAL(int, 0, setitimer(ITIMER_REAL, &interval, NULL));
+
+    // act
+    result = socketio_event_loop_run_once(test_context.event_loop, TEST_WAIT_MS);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 1, (int)signal_count);
+
+    // cleanup
+    (void)sigaction(SIGALRM, &previous_action, NULL);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_020: [ If waiting fails, socketio_event_loop_run_once shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(socketio_event_loop_run_once_when_waiting_fails_fails)
+{
+    // arrange
+    int epoll_fd = find_epoll_fd(0);
+    int null_fd = open("/dev/null", O_RDONLY);
+    int result;
+    ASSERT_ARE_NOT_EQUAL(int, -1, epoll_fd);
+    ASSERT_ARE_NOT_EQUAL(int, -1, null_fd);
+    /* the descriptor of the loop is not an epoll instance anymore, the loop closes it when destroyed */
+    ASSERT_ARE_EQUAL(int, epoll_fd, dup2(null_fd, epoll_fd));
+    (void)close(null_fd);
+
+    // act
+    result = socketio_event_loop_run_once(test_context.event_loop, 0);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* socketio_event_loop_get_receive_buffer */
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_021: [ If event_loop or size is NULL, socketio_event_loop_get_receive_buffer shall fail and return NULL. ]*/
+TEST_FUNCTION(socketio_event_loop_get_receive_buffer_with_NULL_event_loop_fails)
+{
+    // arrange
+    size_t size = 0;
+    unsigned char* result;
+
+    // act
+    result = socketio_event_loop_get_receive_buffer(NULL, &size);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_021: [ If event_loop or size is NULL, socketio_event_loop_get_receive_buffer shall fail and return NULL. ]*/
+TEST_FUNCTION(socketio_event_loop_get_receive_buffer_with_NULL_size_fails)
+{
+    // arrange
+    unsigned char* result;
+
+    // act
+    result = socketio_event_loop_get_receive_buffer(test_context.event_loop, NULL);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_022: [ socketio_event_loop_get_receive_buffer shall return the receive buffer of the loop and set size to its size. ]*/
+TEST_FUNCTION(socketio_event_loop_get_receive_buffer_returns_the_buffer_of_the_loop)
+{
+    // arrange
+    size_t size = 0;
+    size_t other_size = 0;
+    unsigned char* result;
+
+    // act
+    result = socketio_event_loop_get_receive_buffer(test_context.event_loop, &size);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, TEST_RECEIVE_BUFFER_SIZE, size);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)result, (void*)socketio_event_loop_get_receive_buffer(test_context.event_loop, &other_size));
+    ASSERT_ARE_EQUAL(size_t, size, other_size);
+    /* the whole buffer is writable */
+    (void)memset(result, 0xA5, size);
+}
+
+/* socketio_event_loop_set_context */
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_023: [ If event_loop or context is NULL, socketio_event_loop_set_context shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(socketio_event_loop_set_context_with_NULL_event_loop_fails)
+{
+    // arrange
+    int context;
+    int result;
+
+    // act
+    result = socketio_event_loop_set_context(NULL, &context, on_destroy);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_023: [ If event_loop or context is NULL, socketio_event_loop_set_context shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(socketio_event_loop_set_context_with_NULL_context_fails)
+{
+    // arrange
+    int result;
+
+    // act
+    result = socketio_event_loop_set_context(test_context.event_loop, NULL, on_destroy);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(socketio_event_loop_get_context(test_context.event_loop));
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_024: [ If the loop already has a context, socketio_event_loop_set_context shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(socketio_event_loop_set_context_when_a_context_was_set_fails)
+{
+    // arrange
+    int context;
+    int other_context;
+    int result;
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_set_context(test_context.event_loop, &context, on_destroy));
+
+    // act
+    result = socketio_event_loop_set_context(test_context.event_loop, &other_context, on_destroy);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)&context, socketio_event_loop_get_context(test_context.event_loop));
+
+    // cleanup
+    socketio_event_loop_destroy(test_context.event_loop);
+    test_context.event_loop = NULL;
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.destroy_count);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)&context, test_context.destroyed_context);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_025: [ socketio_event_loop_set_context shall keep context and on_destroy in the loop and return 0. ]*/
+TEST_FUNCTION(socketio_event_loop_set_context_keeps_the_context)
+{
+    // arrange
+    int context;
+    int result;
+
+    // act
+    result = socketio_event_loop_set_context(test_context.event_loop, &context, on_destroy);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)&context, socketio_event_loop_get_context(test_context.event_loop));
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.destroy_count);
+}
+
+/* socketio_event_loop_get_context */
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_026: [ If event_loop is NULL, socketio_event_loop_get_context shall return NULL. ]*/
+TEST_FUNCTION(socketio_event_loop_get_context_with_NULL_event_loop_returns_NULL)
+{
+    // arrange
+    void* result;
+
+    // act
+    result = socketio_event_loop_get_context(NULL);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_027: [ socketio_event_loop_get_context shall return the context of the loop, or NULL if none was set. ]*/
+TEST_FUNCTION(socketio_event_loop_get_context_without_a_context_returns_NULL)
+{
+    // arrange
+    void* result;
+
+    // act
+    result = socketio_event_loop_get_context(test_context.event_loop);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+/* socketio_event_loop_create_timer */
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_029: [ If event_loop or on_timer is NULL, socketio_event_loop_create_timer shall fail and return NULL. ]*/
+TEST_FUNCTION(socketio_event_loop_create_timer_with_NULL_event_loop_fails)
+{
+    // arrange
+    SOCKETIO_EVENT_LOOP_TIMER_HANDLE result;
+
+    // act
+    result = socketio_event_loop_create_timer(NULL, on_timer, &test_context.timers[0]);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_029: [ If event_loop or on_timer is NULL, socketio_event_loop_create_timer shall fail and return NULL. ]*/
+TEST_FUNCTION(socketio_event_loop_create_timer_with_NULL_on_timer_fails)
+{
+    // arrange
+    SOCKETIO_EVENT_LOOP_TIMER_HANDLE result;
+
+    // act
+    result = socketio_event_loop_create_timer(test_context.event_loop, NULL, &test_context.timers[0]);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_030: [ socketio_event_loop_create_timer shall return a stopped timer through which on_timer is called with on_timer_context. ]*/
+TEST_FUNCTION(socketio_event_loop_create_timer_returns_a_stopped_timer)
+{
+    // arrange
+    TEST_TIMER* test = &test_context.timers[0];
+    uint64_t start_ms;
+
+    // act
+    create_test_timer(test);
+
+    // assert
+    start_ms = get_time_ms();
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, TEST_SHORT_WAIT_MS));
+    ASSERT_ARE_EQUAL(size_t, 0, test->call_count);
+    /* a stopped timer does not shorten the wait */
+    ASSERT_IS_TRUE(get_time_ms() - start_ms + 1 >= TEST_SHORT_WAIT_MS);
+
+    // cleanup
+    socketio_event_loop_destroy_timer(test->timer);
+}
+
+/* socketio_event_loop_destroy_timer */
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_032: [ If timer is NULL, socketio_event_loop_destroy_timer shall return. ]*/
+TEST_FUNCTION(socketio_event_loop_destroy_timer_with_NULL_timer_returns)
+{
+    // arrange
+
+    // act
+    socketio_event_loop_destroy_timer(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, 0));
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_033: [ Otherwise socketio_event_loop_destroy_timer shall stop timer and free it. ]*/
+TEST_FUNCTION(socketio_event_loop_destroy_timer_of_a_started_timer_stops_it)
+{
+    // arrange
+    TEST_TIMER* test = &test_context.timers[0];
+    create_test_timer(test);
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_start_timer(test->timer, 0));
+
+    // act
+    socketio_event_loop_destroy_timer(test->timer);
+    test->timer = NULL;
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, TEST_SHORT_WAIT_MS));
+    ASSERT_ARE_EQUAL(size_t, 0, test->call_count);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_034: [ When called from a callback of the running loop, socketio_event_loop_destroy_timer shall stop timer and free it when the run ends. ]*/
+TEST_FUNCTION(socketio_event_loop_destroy_timer_from_its_callback_succeeds)
+{
+    // arrange
+    TEST_TIMER* test = &test_context.timers[0];
+    create_test_timer(test);
+    test->destroy_on_call = true;
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_start_timer(test->timer, 0));
+
+    // act
+    run_until(&test->call_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test->call_count);
+    ASSERT_IS_NULL(test->timer);
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, 0));
+    ASSERT_ARE_EQUAL(size_t, 1, test->call_count);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_034: [ When called from a callback of the running loop, socketio_event_loop_destroy_timer shall stop timer and free it when the run ends. ]*/
+TEST_FUNCTION(socketio_event_loop_destroy_timer_from_a_callback_stops_the_other_due_timers)
+{
+    // arrange
+    size_t i;
+    for (i = 0; i < 2; i++)
+    {
+        create_test_timer(&test_context.timers[i]);
+        ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_start_timer(test_context.timers[i].timer, 0));
+    }
+    /* both timers are due, the first callback of the run destroys both */
+    test_context.destroy_all_on_timer = true;
+
+    // act
+    run_until(&test_context.call_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.call_count);
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, 0));
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.call_count);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_034: [ When called from a callback of the running loop, socketio_event_loop_destroy_timer shall stop timer and free it when the run ends. ]*/
+TEST_FUNCTION(socketio_event_loop_destroy_timer_from_an_event_callback_stops_a_due_timer)
+{
+    // arrange
+    TEST_REGISTRATION* registration = &test_context.registrations[0];
+    TEST_TIMER* test = &test_context.timers[0];
+    register_socket_pair(registration, SOCKETIO_EVENT_WRITABLE);
+    create_test_timer(test);
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_start_timer(test->timer, 0));
+    /* the socket is ready and the timer due in the same run, the event callback comes first and destroys the timer */
+    test_context.destroy_timers_on_event = true;
+
+    // act
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, TEST_WAIT_MS));
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, registration->event_count);
+    ASSERT_ARE_EQUAL(size_t, 0, test->call_count);
+    ASSERT_IS_NULL(test->timer);
+
+    // cleanup
+    close_socket_pair(registration);
+}
+
+/* socketio_event_loop_start_timer */
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_035: [ If timer is NULL, socketio_event_loop_start_timer shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(socketio_event_loop_start_timer_with_NULL_timer_fails)
+{
+    // arrange
+    int result;
+
+    // act
+    result = socketio_event_loop_start_timer(NULL, 0);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_036: [ socketio_event_loop_start_timer shall make timer due delay_ms milliseconds from now, in place of the time it was due if it was started, and return 0. ]*/
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_041: [ socketio_event_loop_run_once shall then stop the started timers that are due and call the on_timer callback of each once, a timer started again by a callback of the run is not called before the next run. ]*/
+TEST_FUNCTION(socketio_event_loop_start_timer_calls_on_timer_once_after_the_delay)
+{
+    // arrange
+    TEST_TIMER* test = &test_context.timers[0];
+    uint64_t start_ms;
+    int result;
+    create_test_timer(test);
+    start_ms = get_time_ms();
+
+    // act
+    result = socketio_event_loop_start_timer(test->timer, TEST_TIMER_DELAY_MS);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    run_until(&test->call_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test->call_count);
+    ASSERT_IS_TRUE(get_time_ms() - start_ms + 1 >= TEST_TIMER_DELAY_MS);
+    /* the timer is stopped once called */
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, TEST_TIMER_DELAY_MS));
+    ASSERT_ARE_EQUAL(size_t, 1, test->call_count);
+
+    // cleanup
+    socketio_event_loop_destroy_timer(test->timer);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_036: [ socketio_event_loop_start_timer shall make timer due delay_ms milliseconds from now, in place of the time it was due if it was started, and return 0. ]*/
+TEST_FUNCTION(socketio_event_loop_start_timer_of_a_started_timer_replaces_the_due_time)
+{
+    // arrange
+    TEST_TIMER* test = &test_context.timers[0];
+    int result;
+    create_test_timer(test);
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_start_timer(test->timer, 0));
+
+    // act
+    result = socketio_event_loop_start_timer(test->timer, TEST_WAIT_MS);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, TEST_SHORT_WAIT_MS));
+    ASSERT_ARE_EQUAL(size_t, 0, test->call_count);
+
+    // cleanup
+    socketio_event_loop_destroy_timer(test->timer);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_041: [ socketio_event_loop_run_once shall then stop the started timers that are due and call the on_timer callback of each once, a timer started again by a callback of the run is not called before the next run. ]*/
+TEST_FUNCTION(socketio_event_loop_start_timer_from_its_callback_calls_it_on_the_next_run)
+{
+    // arrange
+    TEST_TIMER* test = &test_context.timers[0];
+    create_test_timer(test);
+    test->restart_on_call = true;
+    test->restart_delay_ms = 0;
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_start_timer(test->timer, 0));
+    run_until(&test->call_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test->call_count);
+    test->restart_on_call = false;
+
+    // act
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, TEST_SHORT_WAIT_MS));
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 2, test->call_count);
+
+    // cleanup
+    socketio_event_loop_destroy_timer(test->timer);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_041: [ socketio_event_loop_run_once shall then stop the started timers that are due and call the on_timer callback of each once, a timer started again by a callback of the run is not called before the next run. ]*/
+TEST_FUNCTION(socketio_event_loop_run_once_calls_each_due_timer_once)
+{
+    // arrange
+    size_t i;
+    for (i = 0; i < 2; i++)
+    {
+        create_test_timer(&test_context.timers[i]);
+        ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_start_timer(test_context.timers[i].timer, 0));
+    }
+
+    // act
+    run_until(&test_context.call_count, 2);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.timers[0].call_count);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.timers[1].call_count);
+
+    // cleanup
+    for (i = 0; i < 2; i++)
+    {
+        socketio_event_loop_destroy_timer(test_context.timers[i].timer);
+    }
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_040: [ socketio_event_loop_run_once shall not wait past the time the earliest started timer is due. ]*/
+TEST_FUNCTION(socketio_event_loop_run_once_does_not_wait_past_the_earliest_timer)
+{
+    // arrange
+    size_t i;
+    uint64_t start_ms;
+    for (i = 0; i < 2; i++)
+    {
+        create_test_timer(&test_context.timers[i]);
+    }
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_start_timer(test_context.timers[0].timer, TEST_WAIT_MS));
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_start_timer(test_context.timers[1].timer, TEST_TIMER_DELAY_MS));
+    start_ms = get_time_ms();
+
+    // act
+    run_until(&test_context.timers[1].call_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.timers[1].call_count);
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.timers[0].call_count);
+    ASSERT_IS_TRUE(get_time_ms() - start_ms < TEST_WAIT_MS);
+
+    // cleanup
+    for (i = 0; i < 2; i++)
+    {
+        socketio_event_loop_destroy_timer(test_context.timers[i].timer);
+    }
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_040: [ socketio_event_loop_run_once shall not wait past the time the earliest started timer is due. ]*/
+TEST_FUNCTION(socketio_event_loop_run_once_with_a_negative_timeout_returns_when_a_timer_is_due)
+{
+    // arrange
+    TEST_TIMER* test = &test_context.timers[0];
+    uint64_t start_ms;
+    create_test_timer(test);
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_start_timer(test->timer, TEST_TIMER_DELAY_MS));
+    start_ms = get_time_ms();
+
+    // act
+    while ((test->call_count == 0) && (get_time_ms() - start_ms < TEST_WAIT_MS))
+    {
+        ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, -1));
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test->call_count);
+    ASSERT_IS_TRUE(get_time_ms() - start_ms < TEST_WAIT_MS);
+
+    // cleanup
+    socketio_event_loop_destroy_timer(test->timer);
+}
+
+/* socketio_event_loop_stop_timer */
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_038: [ If timer is NULL, socketio_event_loop_stop_timer shall return. ]*/
+TEST_FUNCTION(socketio_event_loop_stop_timer_with_NULL_timer_returns)
+{
+    // arrange
+
+    // act
+    socketio_event_loop_stop_timer(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, 0));
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_039: [ socketio_event_loop_stop_timer shall stop timer, its on_timer is not called until it is started again. ]*/
+TEST_FUNCTION(socketio_event_loop_stop_timer_stops_a_started_timer)
+{
+    // arrange
+    TEST_TIMER* test = &test_context.timers[0];
+    create_test_timer(test);
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_start_timer(test->timer, 0));
+
+    // act
+    socketio_event_loop_stop_timer(test->timer);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, TEST_SHORT_WAIT_MS));
+    ASSERT_ARE_EQUAL(size_t, 0, test->call_count);
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_start_timer(test->timer, 0));
+    run_until(&test->call_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test->call_count);
+
+    // cleanup
+    socketio_event_loop_destroy_timer(test->timer);
+}
+
+/* Tests_SRS_SOCKETIO_EVENT_LOOP_03_039: [ socketio_event_loop_stop_timer shall stop timer, its on_timer is not called until it is started again. ]*/
+TEST_FUNCTION(socketio_event_loop_stop_timer_of_a_stopped_timer_returns)
+{
+    // arrange
+    TEST_TIMER* test = &test_context.timers[0];
+    create_test_timer(test);
+
+    // act
+    socketio_event_loop_stop_timer(test->timer);
+    socketio_event_loop_stop_timer(test->timer);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, socketio_event_loop_run_once(test_context.event_loop, 0));
+    ASSERT_ARE_EQUAL(size_t, 0, test->call_count);
+
+    // cleanup
+    socketio_event_loop_destroy_timer(test->timer);
+}
+
+END_TEST_SUITE(socketio_event_loop_unittests)
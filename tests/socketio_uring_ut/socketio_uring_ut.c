@@ -0,0 +1,1193 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdbool.h>
+#endif
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <poll.h>
+
+#include "testrunnerswitcher.h"
+#include "azure_c_shared_utility/socketio.h"
+#include "azure_c_shared_utility/socketio_event_loop.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+#include "azure_c_shared_utility/constbuffer.h"
+#include "azure_c_shared_utility/threadapi.h"
+
+/* the socket IO runs on a real ring, it connects to a listening socket on the loopback and the tests play the peer with the accepted socket */
+#define TEST_HOSTNAME           "127.0.0.1"
+#define TEST_WAIT_MS            5000
+#define TEST_RECEIVE_SIZE       (64 * 1024)
+#define TEST_SEND_COUNT         100
+#define TEST_ABSTRACT_PATH      "@socketio_uring_ut"
+
+TEST_DEFINE_ENUM_TYPE(IO_OPEN_RESULT, IO_OPEN_RESULT_VALUES);
+TEST_DEFINE_ENUM_TYPE(IO_SEND_RESULT, IO_SEND_RESULT_VALUES);
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+typedef struct TEST_CONTEXT_TAG
+{
+    size_t open_complete_count;
+    IO_OPEN_RESULT open_result;
+    int open_code;
+    size_t error_count;
+    size_t close_complete_count;
+    size_t send_complete_count;
+    IO_SEND_RESULT send_result;
+    /* the index of each completed send, in the order of the completions */
+    size_t send_order[TEST_SEND_COUNT];
+    size_t received_size;
+    unsigned char received[TEST_RECEIVE_SIZE];
+    /* destroyed by the first on_bytes_received when not NULL */
+    CONCRETE_IO_HANDLE destroy_on_receive;
+} TEST_CONTEXT;
+
+typedef struct TEST_SEND_TAG
+{
+    TEST_CONTEXT* context;
+    size_t index;
+} TEST_SEND;
+
+static TEST_CONTEXT test_context;
+static int listen_socket;
+static int listen_port;
+
+static void on_io_open_complete(void* context, IO_OPEN_RESULT_DETAILED open_result)
+{
+    TEST_CONTEXT* test = (TEST_CONTEXT*)context;
+    test->open_complete_count++;
+    test->open_result = open_result.result;
+    test->open_code = open_result.code;
+}
+
+static void on_bytes_received(void* context, const unsigned char* buffer, size_t size)
+{
+    TEST_CONTEXT* test = (TEST_CONTEXT*)context;
+    size_t copied_size = (size < TEST_RECEIVE_SIZE - test->received_size) ? size : TEST_RECEIVE_SIZE - test->received_size;
+    (void)memcpy(test->received + test->received_size, buffer, copied_size);
+    test->received_size += copied_size;
+
+    if (test->destroy_on_receive != NULL)
+    {
+        socketio_destroy(test->destroy_on_receive);
+        test->destroy_on_receive = NULL;
+    }
+}
+
+static void on_io_error(void* context)
+{
+    TEST_CONTEXT* test = (TEST_CONTEXT*)context;
+    test->error_count++;
+}
+
+static void on_io_close_complete(void* context)
+{
+    TEST_CONTEXT* test = (TEST_CONTEXT*)context;
+    test->close_complete_count++;
+}
+
+static void on_send_complete(void* context, IO_SEND_RESULT send_result)
+{
+    TEST_SEND* send = (TEST_SEND*)context;
+    if (send->context->send_complete_count < TEST_SEND_COUNT)
+    {
+        send->context->send_order[send->context->send_complete_count] = send->index;
+    }
+    send->context->send_complete_count++;
+    send->context->send_result = send_result;
+}
+
+static int create_listen_socket(int* port)
+{
+    int result = socket(AF_INET, SOCK_STREAM, 0);
+    if (result != -1)
+    {
+        struct sockaddr_in address;
+        socklen_t address_length = sizeof(address);
+        (void)memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+
+        if ((bind(result, (struct sockaddr*)&address, sizeof(address)) != 0) ||
+            (listen(result, SOMAXCONN) != 0) ||
+            (getsockname(result, (struct sockaddr*)&address, &address_length) != 0))
+        {
+            (void)close(result);
+            result = -1;
+        }
+        else
+        {
+            *port = ntohs(address.sin_port);
+        }
+    }
+    return result;
+}
+
+/* a listening Unix domain socket, path starting with '@' is in the abstract namespace */
+static int create_unix_listen_socket(const char* path)
+{
+    int result = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (result != -1)
+    {
+        struct sockaddr_un address;
+        socklen_t address_length = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + strlen(path) + 1);
+        (void)memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        (void)strcpy(address.sun_path, path);
+        if (path[0] == '@')
+        {
+            address.sun_path[0] = '\0';
+            address_length--;
+        }
+
+        if ((bind(result, (struct sockaddr*)&address, address_length) != 0) ||
+            (listen(result, SOMAXCONN) != 0))
+        {
+            (void)close(result);
+            result = -1;
+        }
+    }
+    return result;
+}
+
+/* runs the socket IO, or its event loop, until counter reaches expected */
+static void run_until(CONCRETE_IO_HANDLE socket_io, SOCKETIO_EVENT_LOOP_HANDLE event_loop, const size_t* counter, size_t expected)
+{
+    size_t waited_ms = 0;
+    while ((*counter < expected) && (waited_ms < TEST_WAIT_MS))
+    {
+        if (event_loop != NULL)
+        {
+            (void)socketio_event_loop_run_once(event_loop, 1);
+        }
+        else
+        {
+            socketio_dowork(socket_io);
+            ThreadAPI_Sleep(1);
+        }
+        waited_ms++;
+    }
+}
+
+static int accept_peer(void)
+{
+    int result = accept(listen_socket, NULL, NULL);
+    ASSERT_ARE_NOT_EQUAL(int, -1, result);
+    {
+        struct timeval timeout;
+        timeout.tv_sec = TEST_WAIT_MS / 1000;
+        timeout.tv_usec = 0;
+        (void)setsockopt(result, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+    return result;
+}
+
+/* closes the connections the listening socket has, a connect cancelled by the test may or may not have reached it */
+static void close_pending_peers(void)
+{
+    struct pollfd listen_poll;
+    listen_poll.fd = listen_socket;
+    listen_poll.events = POLLIN;
+    while (poll(&listen_poll, 1, 100) == 1)
+    {
+        (void)close(accept(listen_socket, NULL, NULL));
+    }
+}
+
+/* reads size bytes from the peer, fewer if it times out */
+static size_t read_peer(int peer, unsigned char* buffer, size_t size)
+{
+    size_t result = 0;
+    while (result < size)
+    {
+        ssize_t received = recv(peer, buffer + result, size - result, 0);
+        if (received <= 0)
+        {
+            break;
+        }
+        result += (size_t)received;
+    }
+    return result;
+}
+
+static CONCRETE_IO_HANDLE create_socket_io(SOCKETIO_EVENT_LOOP_HANDLE event_loop)
+{
+    SOCKETIO_CONFIG config;
+    config.hostname = TEST_HOSTNAME;
+    config.port = listen_port;
+    config.accepted_socket = NULL;
+    CONCRETE_IO_HANDLE result = socketio_create(&config);
+    ASSERT_IS_NOT_NULL(result);
+    if (event_loop != NULL)
+    {
+        ASSERT_ARE_EQUAL(int, 0, socketio_setoption(result, OPTION_EVENT_LOOP, event_loop));
+    }
+    return result;
+}
+
+/* opens a socket IO connected to the listening socket and returns the peer of the connection */
+static int open_socket_io(CONCRETE_IO_HANDLE socket_io, SOCKETIO_EVENT_LOOP_HANDLE event_loop, TEST_CONTEXT* context)
+{
+    ASSERT_ARE_EQUAL(int, 0, socketio_open(socket_io, on_io_open_complete, context, on_bytes_received, context, on_io_error, context));
+    run_until(socket_io, event_loop, &context->open_complete_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, context->open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_OK, context->open_result);
+    return accept_peer();
+}
+
+BEGIN_TEST_SUITE(socketio_uring_unittests)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    listen_socket = create_listen_socket(&listen_port);
+    ASSERT_ARE_NOT_EQUAL(int, -1, listen_socket);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    (void)close(listen_socket);
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    (void)memset(&test_context, 0, sizeof(test_context));
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* socketio_get_interface_description */
+
+/* Tests_SRS_SOCKETIO_URING_03_031: [ socketio_get_interface_description shall return the IO_INTERFACE_DESCRIPTION of the socketio API, socketio_retrieveoptions, socketio_create, socketio_destroy, socketio_open, socketio_close, socketio_send, socketio_dowork, socketio_setoption, socketio_create_with_arena and socketio_sendv. ]*/
+TEST_FUNCTION(socketio_get_interface_description_returns_the_functions)
+{
+    // arrange
+
+    // act
+    const IO_INTERFACE_DESCRIPTION* result = socketio_get_interface_description();
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_IS_NOT_NULL(result->concrete_io_retrieveoptions);
+    ASSERT_IS_TRUE(result->concrete_io_create == socketio_create);
+    ASSERT_IS_TRUE(result->concrete_io_destroy == socketio_destroy);
+    ASSERT_IS_TRUE(result->concrete_io_open == socketio_open);
+    ASSERT_IS_TRUE(result->concrete_io_close == socketio_close);
+    ASSERT_IS_TRUE(result->concrete_io_send == socketio_send);
+    ASSERT_IS_TRUE(result->concrete_io_dowork == socketio_dowork);
+    ASSERT_IS_TRUE(result->concrete_io_setoption == socketio_setoption);
+    ASSERT_IS_TRUE(result->concrete_io_create_with_arena == socketio_create_with_arena);
+    ASSERT_IS_TRUE(result->concrete_io_sendv == socketio_sendv);
+}
+
+/* socketio_create */
+
+/* Tests_SRS_SOCKETIO_URING_03_001: [ If io_create_parameters is NULL, socketio_create shall fail and return NULL. ]*/
+TEST_FUNCTION(socketio_create_with_NULL_config_fails)
+{
+    // arrange
+
+    // act
+    CONCRETE_IO_HANDLE result = socketio_create(NULL);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_002: [ If the hostname of the SOCKETIO_CONFIG is NULL and it has no accepted_socket, socketio_create shall fail and return NULL. ]*/
+TEST_FUNCTION(socketio_create_without_hostname_and_socket_fails)
+{
+    // arrange
+    SOCKETIO_CONFIG config;
+    config.hostname = NULL;
+    config.port = listen_port;
+    config.accepted_socket = NULL;
+
+    // act
+    CONCRETE_IO_HANDLE result = socketio_create(&config);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_003: [ socketio_create shall allocate the socket IO on the heap and return it. The ring is not created until the socket IO is opened. ]*/
+TEST_FUNCTION(socketio_create_succeeds)
+{
+    // arrange
+
+    // act
+    CONCRETE_IO_HANDLE result = create_socket_io(NULL);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+
+    // cleanup
+    socketio_destroy(result);
+}
+
+/* socketio_create_with_arena */
+
+/* Tests_SRS_SOCKETIO_URING_03_037: [ socketio_create_with_arena shall allocate the socket IO and its host name in arena when arena is not NULL, on the heap otherwise, and return it. ]*/
+TEST_FUNCTION(socketio_create_with_arena_allocates_the_socket_io_in_the_arena)
+{
+    // arrange
+    SOCKETIO_CONFIG config;
+    ARENA_HANDLE arena = arena_create(4096);
+    ASSERT_IS_NOT_NULL(arena);
+    config.hostname = TEST_HOSTNAME;
+    config.port = listen_port;
+    config.accepted_socket = NULL;
+
+    // act
+    CONCRETE_IO_HANDLE result = socketio_create_with_arena(&config, arena);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_NOT_EQUAL(size_t, 0, arena_get_allocated_size(arena));
+
+    // cleanup
+    socketio_destroy(result);
+    arena_destroy(arena);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_037: [ socketio_create_with_arena shall allocate the socket IO and its host name in arena when arena is not NULL, on the heap otherwise, and return it. ]*/
+TEST_FUNCTION(socketio_create_with_arena_with_NULL_arena_succeeds)
+{
+    // arrange
+    SOCKETIO_CONFIG config;
+    config.hostname = TEST_HOSTNAME;
+    config.port = listen_port;
+    config.accepted_socket = NULL;
+
+    // act
+    CONCRETE_IO_HANDLE result = socketio_create_with_arena(&config, NULL);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+
+    // cleanup
+    socketio_destroy(result);
+}
+
+/* socketio_destroy */
+
+/* Tests_SRS_SOCKETIO_URING_03_004: [ If socket_io is NULL, socketio_destroy shall return. ]*/
+TEST_FUNCTION(socketio_destroy_with_NULL_returns)
+{
+    // arrange
+
+    // act
+    socketio_destroy(NULL);
+
+    // assert
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_005: [ socketio_destroy shall close the socket like socketio_close, without indicating the open, destroy the ring of the socket IO when it has its own, and free the socket IO. ]*/
+TEST_FUNCTION(socketio_destroy_closes_the_socket)
+{
+    // arrange
+    unsigned char byte;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    socketio_destroy(socket_io);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, read_peer(peer, &byte, 1));
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.error_count);
+
+    // cleanup
+    (void)close(peer);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_005: [ socketio_destroy shall close the socket like socketio_close, without indicating the open, destroy the ring of the socket IO when it has its own, and free the socket IO. ]*/
+TEST_FUNCTION(socketio_destroy_from_on_bytes_received_succeeds)
+{
+    // arrange
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    test_context.destroy_on_receive = socket_io;
+    ASSERT_ARE_EQUAL(int, 4, (int)send(peer, "ping", 4, 0));
+
+    // act
+    run_until(socket_io, NULL, &test_context.received_size, 1);
+
+    // assert
+    ASSERT_IS_NULL(test_context.destroy_on_receive);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, "ping", test_context.received_size));
+
+    // cleanup
+    (void)close(peer);
+}
+
+/* socketio_open */
+
+/* Tests_SRS_SOCKETIO_URING_03_006: [ If socket_io is NULL or the socket IO is not closed, socketio_open shall fail, call on_io_open_complete with IO_OPEN_ERROR and return a non-zero value. ]*/
+TEST_FUNCTION(socketio_open_with_NULL_socket_io_fails)
+{
+    // arrange
+
+    // act
+    int result = socketio_open(NULL, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_ERROR, test_context.open_result);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_006: [ If socket_io is NULL or the socket IO is not closed, socketio_open shall fail, call on_io_open_complete with IO_OPEN_ERROR and return a non-zero value. ]*/
+TEST_FUNCTION(socketio_open_when_open_fails)
+{
+    // arrange
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    int result = socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 2, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_ERROR, test_context.open_result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_007: [ The first socketio_open shall create the ring of a socket IO without an event loop. With an event loop it shall use the ring of the loop, which the first socket IO of the loop to open creates, registers with the loop and keeps in the loop with socketio_event_loop_set_context. ]*/
+/* Tests_SRS_SOCKETIO_URING_03_010: [ socketio_open shall submit a connect to the first address, linked to a timeout of what is left of the connect_timeout option, and return 0. The open is indicated when the connect completes. ]*/
+/* Tests_SRS_SOCKETIO_URING_03_011: [ When a connect succeeds, the socket IO shall start the multishot receive and call on_io_open_complete with IO_OPEN_OK. ]*/
+TEST_FUNCTION(socketio_open_connects_to_the_host)
+{
+    // arrange
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+
+    // act
+    int result = socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.open_complete_count);
+    run_until(socket_io, NULL, &test_context.open_complete_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_OK, test_context.open_result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    close_pending_peers();
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_012: [ When a connect fails, the next address shall be connected to. When none is left the socket IO shall go back to closed and call on_io_open_complete with IO_OPEN_ERROR and the error of the last connect, or CONNECT_TIMEOUT_ERROR_CODE (9999) if the connect timed out. ]*/
+TEST_FUNCTION(socketio_open_to_a_closed_port_fails)
+{
+    // arrange
+    int port;
+    int closed_socket = create_listen_socket(&port);
+    SOCKETIO_CONFIG config;
+    CONCRETE_IO_HANDLE socket_io;
+    ASSERT_ARE_NOT_EQUAL(int, -1, closed_socket);
+    (void)close(closed_socket);
+    config.hostname = TEST_HOSTNAME;
+    config.port = port;
+    config.accepted_socket = NULL;
+    socket_io = socketio_create(&config);
+
+    // act
+    ASSERT_ARE_EQUAL(int, 0, socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context));
+    run_until(socket_io, NULL, &test_context.open_complete_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_ERROR, test_context.open_result);
+    ASSERT_ARE_EQUAL(int, ECONNREFUSED, test_context.open_code);
+    /* the socket IO is closed and can be opened again */
+    ASSERT_ARE_EQUAL(int, 0, socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context));
+
+    // cleanup
+    socketio_destroy(socket_io);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_008: [ For an accepted socket, socketio_open shall start the multishot receive, call on_io_open_complete with IO_OPEN_OK and return 0. ]*/
+TEST_FUNCTION(socketio_open_an_accepted_socket_succeeds)
+{
+    // arrange
+    int peer = socket(AF_INET, SOCK_STREAM, 0);
+    int accepted;
+    struct sockaddr_in address;
+    SOCKETIO_CONFIG config;
+    CONCRETE_IO_HANDLE socket_io;
+    (void)memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((uint16_t)listen_port);
+    ASSERT_ARE_EQUAL(int, 0, connect(peer, (struct sockaddr*)&address, sizeof(address)));
+    accepted = accept_peer();
+    config.hostname = NULL;
+    config.port = 0;
+    config.accepted_socket = &accepted;
+    socket_io = socketio_create(&config);
+
+    // act
+    int result = socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_OK, test_context.open_result);
+    ASSERT_ARE_EQUAL(int, 4, (int)send(peer, "pong", 4, 0));
+    run_until(socket_io, NULL, &test_context.received_size, 4);
+    ASSERT_ARE_EQUAL(size_t, 4, test_context.received_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, "pong", 4));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* socketio_close */
+
+/* Tests_SRS_SOCKETIO_URING_03_014: [ If socket_io is NULL, socketio_close shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(socketio_close_with_NULL_socket_io_fails)
+{
+    // arrange
+
+    // act
+    int result = socketio_close(NULL, on_io_close_complete, &test_context);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_015: [ socketio_close shall cancel the operations of the socket in flight, close the socket, drop the pending sends without calling their callbacks, call on_io_close_complete and return 0. No callback of the socket IO is called for the operations that complete after. ]*/
+TEST_FUNCTION(socketio_close_closes_the_socket)
+{
+    // arrange
+    unsigned char byte;
+    TEST_SEND test_send = { &test_context, 0 };
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    ASSERT_ARE_EQUAL(int, 0, socketio_send(socket_io, "a", 1, on_send_complete, &test_send));
+
+    // act
+    int result = socketio_close(socket_io, on_io_close_complete, &test_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.close_complete_count);
+    (void)read_peer(peer, &byte, 1);
+    ASSERT_ARE_EQUAL(size_t, 0, read_peer(peer, &byte, 1));
+    socketio_dowork(socket_io);
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.send_complete_count);
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.error_count);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_016: [ If the socket IO is opening, socketio_close shall call on_io_open_complete with IO_OPEN_CANCELLED. ]*/
+TEST_FUNCTION(socketio_close_while_opening_cancels_the_open)
+{
+    // arrange
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    ASSERT_ARE_EQUAL(int, 0, socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context));
+
+    // act
+    int result = socketio_close(socket_io, on_io_close_complete, &test_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_CANCELLED, test_context.open_result);
+    socketio_dowork(socket_io);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    close_pending_peers();
+}
+
+/* socketio_send */
+
+/* Tests_SRS_SOCKETIO_URING_03_017: [ If socket_io is NULL, or there are no bytes to send, the send functions shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(socketio_send_with_NULL_socket_io_fails)
+{
+    // arrange
+
+    // act
+    int result = socketio_send(NULL, "a", 1, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_017: [ If socket_io is NULL, or there are no bytes to send, the send functions shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(socketio_sendv_without_bytes_fails)
+{
+    // arrange
+    CONSTBUFFER buffer = { NULL, 0 };
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+
+    // act
+    int result = socketio_sendv(socket_io, &buffer, 1, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_018: [ If the socket IO is not open, the send functions shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(socketio_send_when_not_open_fails)
+{
+    // arrange
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+
+    // act
+    int result = socketio_send(socket_io, "a", 1, NULL, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_019: [ The send functions shall queue a pending IO with a copy of the bytes, or a reference to constbuffer, submit a sendmsg of the pending IOs when none is in flight, and return 0. ]*/
+/* Tests_SRS_SOCKETIO_URING_03_020: [ When a sendmsg completes, the pending IOs it sent shall be completed in order with IO_SEND_OK, and the next sendmsg shall send what is left. ]*/
+TEST_FUNCTION(socketio_send_sends_the_bytes)
+{
+    // arrange
+    unsigned char received[5];
+    char bytes[] = "hello";
+    TEST_SEND test_send = { &test_context, 0 };
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    int result = socketio_send(socket_io, bytes, 5, on_send_complete, &test_send);
+    /* the bytes were copied */
+    bytes[0] = 'j';
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    run_until(socket_io, NULL, &test_context.send_complete_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.send_complete_count);
+    ASSERT_ARE_EQUAL(IO_SEND_RESULT, IO_SEND_OK, test_context.send_result);
+    ASSERT_ARE_EQUAL(size_t, 5, read_peer(peer, received, 5));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(received, "hello", 5));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_019: [ The send functions shall queue a pending IO with a copy of the bytes, or a reference to constbuffer, submit a sendmsg of the pending IOs when none is in flight, and return 0. ]*/
+TEST_FUNCTION(socketio_sendv_sends_the_buffers_in_order)
+{
+    // arrange
+    unsigned char received[9];
+    CONSTBUFFER buffers[3] = { { (const unsigned char*)"abc", 3 }, { NULL, 0 }, { (const unsigned char*)"defghi", 6 } };
+    TEST_SEND test_send = { &test_context, 0 };
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    int result = socketio_sendv(socket_io, buffers, 3, on_send_complete, &test_send);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    run_until(socket_io, NULL, &test_context.send_complete_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.send_complete_count);
+    ASSERT_ARE_EQUAL(size_t, 9, read_peer(peer, received, 9));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(received, "abcdefghi", 9));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_019: [ The send functions shall queue a pending IO with a copy of the bytes, or a reference to constbuffer, submit a sendmsg of the pending IOs when none is in flight, and return 0. ]*/
+TEST_FUNCTION(socketio_send_constbuffer_sends_the_content)
+{
+    // arrange
+    unsigned char received[6];
+    CONSTBUFFER_HANDLE constbuffer = CONSTBUFFER_Create((const unsigned char*)"buffer", 6);
+    TEST_SEND test_send = { &test_context, 0 };
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    ASSERT_IS_NOT_NULL(constbuffer);
+
+    // act
+    int result = socketio_send_constbuffer(socket_io, constbuffer, on_send_complete, &test_send);
+    CONSTBUFFER_Destroy(constbuffer);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    run_until(socket_io, NULL, &test_context.send_complete_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.send_complete_count);
+    ASSERT_ARE_EQUAL(size_t, 6, read_peer(peer, received, 6));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(received, "buffer", 6));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_020: [ When a sendmsg completes, the pending IOs it sent shall be completed in order with IO_SEND_OK, and the next sendmsg shall send what is left. ]*/
+TEST_FUNCTION(socketio_send_completes_the_sends_in_order)
+{
+    // arrange
+    static unsigned char bytes[TEST_SEND_COUNT][100];
+    static unsigned char received[sizeof(bytes)];
+    TEST_SEND test_sends[TEST_SEND_COUNT];
+    size_t i;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    for (i = 0; i < TEST_SEND_COUNT; i++)
+    {
+        (void)memset(bytes[i], (int)i, sizeof(bytes[i]));
+        test_sends[i].context = &test_context;
+        test_sends[i].index = i;
+        ASSERT_ARE_EQUAL(int, 0, socketio_send(socket_io, bytes[i], sizeof(bytes[i]), on_send_complete, &test_sends[i]));
+    }
+    run_until(socket_io, NULL, &test_context.send_complete_count, TEST_SEND_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, TEST_SEND_COUNT, test_context.send_complete_count);
+    for (i = 0; i < TEST_SEND_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(size_t, i, test_context.send_order[i]);
+    }
+    ASSERT_ARE_EQUAL(size_t, sizeof(received), read_peer(peer, received, sizeof(received)));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(received, bytes, sizeof(received)));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* receiving */
+
+/* Tests_SRS_SOCKETIO_URING_03_022: [ For each completion of the receive, the socket IO shall call on_bytes_received with the bytes in the receive buffer, and give the buffer back to the ring when it returns. ]*/
+TEST_FUNCTION(socketio_receives_the_bytes_of_the_peer)
+{
+    // arrange
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    ASSERT_ARE_EQUAL(int, 5, (int)send(peer, "hello", 5, 0));
+    run_until(socket_io, NULL, &test_context.received_size, 5);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 5, test_context.received_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, "hello", 5));
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.error_count);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_024: [ When the ring has no receive buffer left, the receive shall start again once the dispatch of the completions gave the buffers back. ]*/
+TEST_FUNCTION(socketio_receives_more_than_the_receive_buffers_hold)
+{
+    // arrange
+    static unsigned char bytes[TEST_RECEIVE_SIZE];
+    size_t i;
+    size_t sent_size = 0;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    for (i = 0; i < sizeof(bytes); i++)
+    {
+        bytes[i] = (unsigned char)(i * 7);
+    }
+
+    // act
+    while (sent_size < sizeof(bytes))
+    {
+        ssize_t sent = send(peer, bytes + sent_size, sizeof(bytes) - sent_size, MSG_DONTWAIT);
+        if (sent > 0)
+        {
+            sent_size += (size_t)sent;
+        }
+        socketio_dowork(socket_io);
+    }
+    run_until(socket_io, NULL, &test_context.received_size, sizeof(bytes));
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, sizeof(bytes), test_context.received_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, bytes, sizeof(bytes)));
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.error_count);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_023: [ When the peer closed the socket or the receive fails, the socket IO shall call on_io_error. ]*/
+TEST_FUNCTION(socketio_indicates_an_error_when_the_peer_closes)
+{
+    // arrange
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    (void)close(peer);
+    run_until(socket_io, NULL, &test_context.error_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.error_count);
+    ASSERT_ARE_NOT_EQUAL(int, 0, socketio_send(socket_io, "a", 1, NULL, NULL));
+
+    // cleanup
+    socketio_destroy(socket_io);
+}
+
+/* socketio_dowork */
+
+/* Tests_SRS_SOCKETIO_URING_03_025: [ If socket_io is NULL, socketio_dowork shall return. ]*/
+TEST_FUNCTION(socketio_dowork_with_NULL_socket_io_returns)
+{
+    // arrange
+
+    // act
+    socketio_dowork(NULL);
+
+    // assert
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_007: [ The first socketio_open shall create the ring of a socket IO without an event loop. With an event loop it shall use the ring of the loop, which the first socket IO of the loop to open creates, registers with the loop and keeps in the loop with socketio_event_loop_set_context. ]*/
+/* Tests_SRS_SOCKETIO_URING_03_026: [ While the host name is resolved socketio_dowork shall check the lookup, otherwise it shall dispatch the completions of the own ring of the socket IO. It does nothing for a socket IO of an event loop. ]*/
+TEST_FUNCTION(socketio_of_an_event_loop_share_the_ring_of_the_loop)
+{
+    // arrange
+    static TEST_CONTEXT other_context;
+    TEST_SEND test_send = { &other_context, 0 };
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = socketio_event_loop_create();
+    CONCRETE_IO_HANDLE socket_io;
+    CONCRETE_IO_HANDLE other_socket_io;
+    void* ring;
+    int peer;
+    int other_peer;
+    unsigned char received[5];
+    ASSERT_IS_NOT_NULL(event_loop);
+    (void)memset(&other_context, 0, sizeof(other_context));
+    socket_io = create_socket_io(event_loop);
+    other_socket_io = create_socket_io(event_loop);
+
+    // act
+    peer = open_socket_io(socket_io, event_loop, &test_context);
+    ring = socketio_event_loop_get_context(event_loop);
+    other_peer = open_socket_io(other_socket_io, event_loop, &other_context);
+
+    // assert
+    ASSERT_IS_NOT_NULL(ring);
+    ASSERT_IS_TRUE(ring == socketio_event_loop_get_context(event_loop));
+    ASSERT_ARE_EQUAL(int, 4, (int)send(peer, "ping", 4, 0));
+    socketio_dowork(socket_io);
+    ASSERT_ARE_EQUAL(size_t, 0, test_context.received_size);
+    run_until(NULL, event_loop, &test_context.received_size, 4);
+    ASSERT_ARE_EQUAL(size_t, 4, test_context.received_size);
+    ASSERT_ARE_EQUAL(int, 0, socketio_send(other_socket_io, "hello", 5, on_send_complete, &test_send));
+    run_until(NULL, event_loop, &other_context.send_complete_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 1, other_context.send_complete_count);
+    ASSERT_ARE_EQUAL(size_t, 5, read_peer(other_peer, received, 5));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(received, "hello", 5));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    socketio_destroy(other_socket_io);
+    socketio_event_loop_destroy(event_loop);
+    (void)close(peer);
+    (void)close(other_peer);
+}
+
+/* socketio_setoption */
+
+/* Tests_SRS_SOCKETIO_URING_03_027: [ If socket_io, optionName or value is NULL, socketio_setoption shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(socketio_setoption_with_NULL_option_name_fails)
+{
+    // arrange
+    int value = 1;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+
+    // act
+    int result = socketio_setoption(socket_io, NULL, &value);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_028: [ socketio_setoption shall set the tcp_keepalive, tcp_keepalive_time, tcp_keepalive_interval and tcp_nodelay options on the socket, and return the errno of setsockopt when it fails. ]*/
+TEST_FUNCTION(socketio_setoption_sets_tcp_nodelay_on_the_socket)
+{
+    // arrange
+    int value = 1;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // act
+    int result = socketio_setoption(socket_io, "tcp_nodelay", &value);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_029: [ socketio_setoption shall keep the connect_timeout option for the next connect and return 0. ]*/
+TEST_FUNCTION(socketio_setoption_keeps_the_connect_timeout)
+{
+    // arrange
+    unsigned int connect_timeout_ms = 1000;
+    int peer;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+
+    // act
+    int result = socketio_setoption(socket_io, OPTION_CONNECT_TIMEOUT, &connect_timeout_ms);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_030: [ socketio_setoption shall fail and return a non-zero value for the receive_buffer_size, receive_batched and net_interface_mac_address options and any unknown option. ]*/
+TEST_FUNCTION(socketio_setoption_receive_buffer_size_fails)
+{
+    // arrange
+    size_t receive_size = 1024;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+
+    // act
+    int result = socketio_setoption(socket_io, OPTION_RECEIVE_BUFFER_SIZE, &receive_size);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+}
+
+/* unix_socket_path */
+
+/* Tests_SRS_SOCKETIO_URING_03_032: [ When the unix_socket_path option is set, socketio_open shall submit a connect to that Unix domain socket, linked to the connect timeout, instead of resolving the host name, and return 0. ]*/
+/* Tests_SRS_SOCKETIO_URING_03_033: [ socketio_setoption shall keep the unix_socket_path option for the next socketio_open, an empty path clears it, and return 0. ]*/
+TEST_FUNCTION(socketio_open_with_unix_socket_path_connects_to_the_path)
+{
+    // arrange
+    char path[64] = "/tmp/socketio_uring_ut_XXXXXX";
+    unsigned char received[5];
+    TEST_SEND test_send = { &test_context, 0 };
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int unix_listen_socket;
+    int peer;
+    ASSERT_IS_NOT_NULL(mkdtemp(path));
+    (void)strcat(path, "/s");
+    unix_listen_socket = create_unix_listen_socket(path);
+    ASSERT_ARE_NOT_EQUAL(int, -1, unix_listen_socket);
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, OPTION_UNIX_SOCKET_PATH, path));
+
+    // act
+    ASSERT_ARE_EQUAL(int, 0, socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context));
+    run_until(socket_io, NULL, &test_context.open_complete_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_OK, test_context.open_result);
+    peer = accept(unix_listen_socket, NULL, NULL);
+    ASSERT_ARE_NOT_EQUAL(int, -1, peer);
+    ASSERT_ARE_EQUAL(int, 0, socketio_send(socket_io, "hello", 5, on_send_complete, &test_send));
+    run_until(socket_io, NULL, &test_context.send_complete_count, 1);
+    ASSERT_ARE_EQUAL(size_t, 5, read_peer(peer, received, 5));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(received, "hello", 5));
+    ASSERT_ARE_EQUAL(int, 4, (int)send(peer, "ping", 4, 0));
+    run_until(socket_io, NULL, &test_context.received_size, 4);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, "ping", 4));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+    (void)close(unix_listen_socket);
+    (void)unlink(path);
+    path[strlen(path) - 2] = '\0';
+    (void)rmdir(path);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_032: [ When the unix_socket_path option is set, socketio_open shall submit a connect to that Unix domain socket, linked to the connect timeout, instead of resolving the host name, and return 0. ]*/
+TEST_FUNCTION(socketio_open_with_an_abstract_unix_socket_path_connects)
+{
+    // arrange
+    int unix_listen_socket = create_unix_listen_socket(TEST_ABSTRACT_PATH);
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer;
+    ASSERT_ARE_NOT_EQUAL(int, -1, unix_listen_socket);
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, OPTION_UNIX_SOCKET_PATH, TEST_ABSTRACT_PATH));
+
+    // act
+    ASSERT_ARE_EQUAL(int, 0, socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context));
+    run_until(socket_io, NULL, &test_context.open_complete_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_OK, test_context.open_result);
+    peer = accept(unix_listen_socket, NULL, NULL);
+    ASSERT_ARE_NOT_EQUAL(int, -1, peer);
+    ASSERT_ARE_EQUAL(int, 4, (int)send(peer, "ping", 4, 0));
+    run_until(socket_io, NULL, &test_context.received_size, 4);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_context.received, "ping", 4));
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+    (void)close(unix_listen_socket);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_012: [ When a connect fails, the next address shall be connected to. When none is left the socket IO shall go back to closed and call on_io_open_complete with IO_OPEN_ERROR and the error of the last connect, or CONNECT_TIMEOUT_ERROR_CODE (9999) if the connect timed out. ]*/
+TEST_FUNCTION(socketio_open_with_a_unix_socket_path_nobody_listens_on_fails)
+{
+    // arrange
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, OPTION_UNIX_SOCKET_PATH, "/nonexistent/socketio_uring_ut"));
+
+    // act
+    ASSERT_ARE_EQUAL(int, 0, socketio_open(socket_io, on_io_open_complete, &test_context, on_bytes_received, &test_context, on_io_error, &test_context));
+    run_until(socket_io, NULL, &test_context.open_complete_count, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_context.open_complete_count);
+    ASSERT_ARE_EQUAL(IO_OPEN_RESULT, IO_OPEN_ERROR, test_context.open_result);
+    ASSERT_ARE_EQUAL(int, ENOENT, test_context.open_code);
+
+    // cleanup
+    socketio_destroy(socket_io);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_033: [ socketio_setoption shall keep the unix_socket_path option for the next socketio_open, an empty path clears it, and return 0. ]*/
+TEST_FUNCTION(socketio_setoption_with_an_empty_unix_socket_path_connects_to_the_host)
+{
+    // arrange
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer;
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, OPTION_UNIX_SOCKET_PATH, "/nonexistent/socketio_uring_ut"));
+
+    // act
+    int result = socketio_setoption(socket_io, OPTION_UNIX_SOCKET_PATH, "");
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    peer = open_socket_io(socket_io, NULL, &test_context);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    (void)close(peer);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_035: [ Before the first socketio_open, socketio_setoption shall keep the event_loop option, create a timer of the loop for a socket IO that has a host name, and return 0. ]*/
+TEST_FUNCTION(socketio_setoption_event_loop_before_the_first_open_succeeds)
+{
+    // arrange
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = socketio_event_loop_create();
+    ASSERT_IS_NOT_NULL(event_loop);
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+
+    // act
+    int result = socketio_setoption(socket_io, OPTION_EVENT_LOOP, event_loop);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    socketio_event_loop_destroy(event_loop);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_038: [ socketio_setoption shall fail and return a non-zero value for the event_loop option once the socket IO was opened, or when creating the timer fails. ]*/
+TEST_FUNCTION(socketio_setoption_event_loop_after_the_first_open_fails)
+{
+    // arrange
+    SOCKETIO_EVENT_LOOP_HANDLE event_loop = socketio_event_loop_create();
+    ASSERT_IS_NOT_NULL(event_loop);
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    int peer = open_socket_io(socket_io, NULL, &test_context);
+    ASSERT_ARE_EQUAL(int, 0, socketio_close(socket_io, NULL, NULL));
+
+    // act
+    int result = socketio_setoption(socket_io, OPTION_EVENT_LOOP, event_loop);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+    socketio_event_loop_destroy(event_loop);
+    (void)close(peer);
+}
+
+/* Tests_SRS_SOCKETIO_URING_03_034: [ While the unix_socket_path option is set, socketio_setoption shall ignore the tcp_keepalive, tcp_keepalive_time, tcp_keepalive_interval and tcp_nodelay options and return 0. ]*/
+TEST_FUNCTION(socketio_setoption_tcp_nodelay_with_a_unix_socket_path_succeeds)
+{
+    // arrange
+    int value = 1;
+    CONCRETE_IO_HANDLE socket_io = create_socket_io(NULL);
+    ASSERT_ARE_EQUAL(int, 0, socketio_setoption(socket_io, OPTION_UNIX_SOCKET_PATH, TEST_ABSTRACT_PATH));
+
+    // act
+    int result = socketio_setoption(socket_io, "tcp_nodelay", &value);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    socketio_destroy(socket_io);
+}
+
+END_TEST_SUITE(socketio_uring_unittests)
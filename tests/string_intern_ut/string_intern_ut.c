@@ -0,0 +1,428 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+static size_t currentmalloc_call = 0;
+static size_t whenShallmalloc_fail = 0;
+
+void* my_gballoc_malloc(size_t size)
+{
+    void* result;
+    currentmalloc_call++;
+    if (whenShallmalloc_fail > 0)
+    {
+        if (currentmalloc_call == whenShallmalloc_fail)
+        {
+            result = NULL;
+        }
+        else
+        {
+            result = malloc(size);
+        }
+    }
+    else
+    {
+        result = malloc(size);
+    }
+    return result;
+}
+
+void my_gballoc_free(void* ptr)
+{
+    free(ptr);
+}
+
+#define ENABLE_MOCKS
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/lock.h"
+
+static const LOCK_HANDLE TEST_LOCK_HANDLE = (LOCK_HANDLE)0x4244;
+
+/*the lock of the table lives as long as the process, this counts how many times it was created*/
+static size_t lock_init_call_count = 0;
+
+LOCK_HANDLE my_Lock_Init(void)
+{
+    lock_init_call_count++;
+    return TEST_LOCK_HANDLE;
+}
+
+#undef ENABLE_MOCKS
+
+#include "azure_c_shared_utility/string_intern.h"
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+static const char* TEST_HEADER_NAME = "Content-Type";
+static const char* TEST_OTHER_HEADER_NAME = "Authorization";
+
+IMPLEMENT_UMOCK_C_ENUM_TYPE(LOCK_RESULT, LOCK_RESULT_VALUES);
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(string_intern_unittests)
+
+    TEST_SUITE_INITIALIZE(suite_init)
+    {
+        int result;
+
+        TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+        g_testByTest = TEST_MUTEX_CREATE();
+        ASSERT_IS_NOT_NULL(g_testByTest);
+
+        umock_c_init(on_umock_c_error);
+
+        result = umocktypes_charptr_register_types();
+        ASSERT_ARE_EQUAL(int, 0, result);
+
+        REGISTER_UMOCK_ALIAS_TYPE(LOCK_HANDLE, void*);
+        REGISTER_TYPE(LOCK_RESULT, LOCK_RESULT);
+
+        REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+        REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+        REGISTER_GLOBAL_MOCK_HOOK(Lock_Init, my_Lock_Init);
+        REGISTER_GLOBAL_MOCK_RETURN(Lock, LOCK_OK);
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(Lock, LOCK_ERROR);
+        REGISTER_GLOBAL_MOCK_RETURN(Unlock, LOCK_OK);
+    }
+
+    TEST_SUITE_CLEANUP(suite_cleanup)
+    {
+        umock_c_deinit();
+
+        TEST_MUTEX_DESTROY(g_testByTest);
+        TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    }
+
+    TEST_FUNCTION_INITIALIZE(method_init)
+    {
+        if (TEST_MUTEX_ACQUIRE(g_testByTest))
+        {
+            ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+        }
+
+        /*makes sure the lock of the table exists, the table is empty after this*/
+        string_intern_release(string_intern_acquire(TEST_HEADER_NAME));
+
+        umock_c_reset_all_calls();
+
+        currentmalloc_call = 0;
+        whenShallmalloc_fail = 0;
+    }
+
+    TEST_FUNCTION_CLEANUP(method_cleanup)
+    {
+        TEST_MUTEX_RELEASE(g_testByTest);
+    }
+
+    /*Tests_SRS_STRING_INTERN_03_001: [ If value is NULL, string_intern_acquire shall fail and return NULL. ]*/
+    TEST_FUNCTION(string_intern_acquire_with_NULL_value_fails)
+    {
+        ///act
+        const char* result = string_intern_acquire(NULL);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_STRING_INTERN_03_002: [ The first call to string_intern_acquire shall create the lock of the table. ]*/
+    TEST_FUNCTION(string_intern_acquire_creates_the_lock_only_once)
+    {
+        ///arrange
+        const char* interned1;
+        const char* interned2;
+
+        ///act
+        interned1 = string_intern_acquire(TEST_HEADER_NAME);
+        interned2 = string_intern_acquire(TEST_OTHER_HEADER_NAME);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 1, lock_init_call_count);
+
+        ///cleanup
+        string_intern_release(interned1);
+        string_intern_release(interned2);
+    }
+
+    /*Tests_SRS_STRING_INTERN_03_004: [ Otherwise string_intern_acquire shall copy value in a new entry of the table having its reference count set to 1 and return the copy. ]*/
+    /*Tests_SRS_STRING_INTERN_03_012: [ string_intern_acquire, string_intern_find and string_intern_release shall hold the lock of the table while they access it. ]*/
+    TEST_FUNCTION(string_intern_acquire_copies_a_new_string)
+    {
+        ///arrange
+        const char* result;
+
+        STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*the buckets of the table*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*the entry and its characters*/
+        STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+        ///act
+        result = string_intern_acquire(TEST_HEADER_NAME);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_HEADER_NAME, result);
+        /*testing that it is a copy and not a pointer assignment*/
+        ASSERT_ARE_NOT_EQUAL(void_ptr, TEST_HEADER_NAME, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        string_intern_release(result);
+    }
+
+    /*Tests_SRS_STRING_INTERN_03_003: [ If value is already interned, string_intern_acquire shall increment the reference count of the canonical copy and return it. ]*/
+    TEST_FUNCTION(string_intern_acquire_of_an_interned_string_returns_the_canonical_copy)
+    {
+        ///arrange
+        char same_characters[32];
+        const char* interned = string_intern_acquire(TEST_HEADER_NAME);
+        const char* result;
+        (void)strcpy(same_characters, TEST_HEADER_NAME);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+        STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+        ///act
+        result = string_intern_acquire(same_characters);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, interned, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        string_intern_release(result);
+        string_intern_release(interned);
+    }
+
+    /*Tests_SRS_STRING_INTERN_03_005: [ If any error occurs, string_intern_acquire shall fail and return NULL. ]*/
+    TEST_FUNCTION(string_intern_acquire_fails_when_Lock_fails)
+    {
+        ///arrange
+        const char* result;
+
+        STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
+            .SetReturn(LOCK_ERROR);
+
+        ///act
+        result = string_intern_acquire(TEST_HEADER_NAME);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_STRING_INTERN_03_005: [ If any error occurs, string_intern_acquire shall fail and return NULL. ]*/
+    TEST_FUNCTION(string_intern_acquire_fails_when_allocating_the_buckets_fails)
+    {
+        ///arrange
+        const char* result;
+
+        whenShallmalloc_fail = 1;
+        STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*the buckets of the table*/
+        STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+        ///act
+        result = string_intern_acquire(TEST_HEADER_NAME);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_STRING_INTERN_03_005: [ If any error occurs, string_intern_acquire shall fail and return NULL. ]*/
+    TEST_FUNCTION(string_intern_acquire_fails_when_allocating_the_entry_fails)
+    {
+        ///arrange
+        const char* result;
+
+        whenShallmalloc_fail = 2;
+        STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*the buckets of the table*/
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*the entry and its characters*/
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*the table is empty again*/
+        STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+        ///act
+        result = string_intern_acquire(TEST_HEADER_NAME);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_STRING_INTERN_03_004: [ Otherwise string_intern_acquire shall copy value in a new entry of the table having its reference count set to 1 and return the copy. ]*/
+    TEST_FUNCTION(string_intern_acquire_of_many_strings_succeeds)
+    {
+        ///arrange
+        const char* interned[100];
+        size_t i;
+
+        ///act
+        for (i = 0; i < sizeof(interned) / sizeof(interned[0]); i++)
+        {
+            char value[32];
+            (void)sprintf(value, "x-ms-header-%lu", (unsigned long)i);
+            interned[i] = string_intern_acquire(value);
+            ASSERT_IS_NOT_NULL(interned[i]);
+        }
+
+        ///assert
+        for (i = 0; i < sizeof(interned) / sizeof(interned[0]); i++)
+        {
+            char value[32];
+            (void)sprintf(value, "x-ms-header-%lu", (unsigned long)i);
+            ASSERT_ARE_EQUAL(char_ptr, value, interned[i]);
+            ASSERT_ARE_EQUAL(void_ptr, interned[i], string_intern_find(value));
+        }
+
+        ///cleanup
+        for (i = 0; i < sizeof(interned) / sizeof(interned[0]); i++)
+        {
+            string_intern_release(interned[i]);
+        }
+    }
+
+    /*Tests_SRS_STRING_INTERN_03_006: [ If value is NULL, string_intern_find shall return NULL. ]*/
+    TEST_FUNCTION(string_intern_find_with_NULL_value_returns_NULL)
+    {
+        ///act
+        const char* result = string_intern_find(NULL);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_STRING_INTERN_03_007: [ If value is interned, string_intern_find shall return its canonical copy without changing its reference count. ]*/
+    TEST_FUNCTION(string_intern_find_of_an_interned_string_returns_the_canonical_copy)
+    {
+        ///arrange
+        const char* interned = string_intern_acquire(TEST_HEADER_NAME);
+        const char* result;
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+        STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+        ///act
+        result = string_intern_find(TEST_HEADER_NAME);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, interned, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        /*the only reference is the one of string_intern_acquire*/
+        umock_c_reset_all_calls();
+        STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*the entry*/
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*the buckets*/
+        STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+        string_intern_release(interned);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_STRING_INTERN_03_008: [ Otherwise string_intern_find shall return NULL. ]*/
+    TEST_FUNCTION(string_intern_find_of_a_string_that_is_not_interned_returns_NULL)
+    {
+        ///arrange
+        const char* interned = string_intern_acquire(TEST_HEADER_NAME);
+        const char* result;
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+        STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+        ///act
+        result = string_intern_find(TEST_OTHER_HEADER_NAME);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        string_intern_release(interned);
+    }
+
+    /*Tests_SRS_STRING_INTERN_03_009: [ If interned is NULL, string_intern_release shall return. ]*/
+    TEST_FUNCTION(string_intern_release_with_NULL_interned_returns)
+    {
+        ///act
+        string_intern_release(NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_STRING_INTERN_03_010: [ Otherwise string_intern_release shall decrement the reference count of interned. ]*/
+    TEST_FUNCTION(string_intern_release_keeps_a_string_that_is_still_referenced)
+    {
+        ///arrange
+        const char* interned1 = string_intern_acquire(TEST_HEADER_NAME);
+        const char* interned2 = string_intern_acquire(TEST_HEADER_NAME);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+        STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+        ///act
+        string_intern_release(interned1);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(void_ptr, interned2, string_intern_find(TEST_HEADER_NAME));
+
+        ///cleanup
+        string_intern_release(interned2);
+    }
+
+    /*Tests_SRS_STRING_INTERN_03_011: [ If the reference count reaches 0, string_intern_release shall remove interned from the table and free it, the table frees its buckets when its last entry is removed. ]*/
+    TEST_FUNCTION(string_intern_release_of_the_last_reference_removes_the_string)
+    {
+        ///arrange
+        const char* interned = string_intern_acquire(TEST_HEADER_NAME);
+        const char* other = string_intern_acquire(TEST_OTHER_HEADER_NAME);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*the entry, the table still has other*/
+        STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+        ///act
+        string_intern_release(interned);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_NULL(string_intern_find(TEST_HEADER_NAME));
+        ASSERT_ARE_EQUAL(void_ptr, other, string_intern_find(TEST_OTHER_HEADER_NAME));
+
+        ///cleanup
+        string_intern_release(other);
+    }
+
+END_TEST_SUITE(string_intern_unittests)
@@ -51,6 +51,13 @@ static const char* INIT_FORMAT_INTEGER_RESULT = "Initial_test_format_1234";
 static const char* EMPTY_STRING = "";
 static const char* MODIFIED_STRING_VALUE = "Initial*";
 static const char* MODIFIED_STRING_VALUE2 = "*nitial_";
+/* longer than the strings stored inline in the STRING structure */
+static const char LONG_STRING_VALUE[] = "SharedAccessSignature sr=myhub.azure-devices.net";
+static const char* SAS_TOKEN_VALUE = "SharedAccessSignature sr=myhub.azure-devices.net&sig=dGVzdHNpZ25hdHVyZQ%3d%3d&se=1500000000&skn=iothubowner";
+static const char* QUOTED_LONG_STRING_VALUE = "\"SharedAccessSignature sr=myhub.azure-devices.net\"";
+
+/* mirrors STRING_INLINE_SIZE in strings.c */
+#define TEST_STRING_INLINE_SIZE         40
 
 #define NUMBER_OF_CHAR_TOCOPY           8
 #define TEST_INTEGER_VALUE              1234
@@ -132,6 +139,7 @@ BEGIN_TEST_SUITE(strings_unittests)
 
     /* STRING_Tests BEGIN */
     /* Tests_SRS_STRING_07_001: [STRING_new shall allocate a new STRING_HANDLE pointing to an empty string.] */
+    /* Tests_SRS_STRING_03_001: [ A string of less than STRING_INLINE_SIZE characters shall be stored in the STRING structure, without allocating memory for its characters. ]*/
     TEST_FUNCTION(STRING_new_Succeed)
     {
         ///arrange
@@ -139,7 +147,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(1));
 
         ///act
         g_hString = STRING_new();
@@ -163,7 +170,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(1));
 
         umock_c_negative_tests_snapshot();
 
@@ -234,7 +240,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_STRING_VALUE) + 1));
 
         ///act
         g_hString = STRING_construct(TEST_STRING_VALUE);
@@ -259,7 +264,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_STRING_VALUE) + 1));
 
         umock_c_negative_tests_snapshot();
 
@@ -284,6 +288,65 @@ BEGIN_TEST_SUITE(strings_unittests)
         umock_c_negative_tests_deinit();
     }
 
+    /* Tests_SRS_STRING_07_003: [STRING_construct shall allocate a new string with the value of the specified const char*.] */
+    TEST_FUNCTION(STRING_construct_long_string_allocates_its_value)
+    {
+        ///arrange
+        STRING_HANDLE g_hString;
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(LONG_STRING_VALUE) + 1));
+
+        ///act
+        g_hString = STRING_construct(LONG_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, LONG_STRING_VALUE, STRING_c_str(g_hString));
+        ASSERT_ARE_EQUAL(size_t, strlen(LONG_STRING_VALUE), STRING_length(g_hString));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
+    /* Tests_SRS_STRING_07_032: [STRING_construct encounters any error it shall return a NULL value.] */
+    TEST_FUNCTION(STRING_construct_long_string_Fail)
+    {
+        //arrange
+        STRING_HANDLE str_handle;
+        size_t count;
+        size_t index;
+        int negativeTestsInitResult = umock_c_negative_tests_init();
+        ASSERT_ARE_EQUAL(int, 0, negativeTestsInitResult);
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(LONG_STRING_VALUE) + 1));
+
+        umock_c_negative_tests_snapshot();
+
+        //act
+        count = umock_c_negative_tests_call_count();
+        for (index = 0; index < count; index++)
+        {
+            char tmp_msg[64];
+
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(index);
+
+            str_handle = STRING_construct(LONG_STRING_VALUE);
+
+            sprintf(tmp_msg, "STRING_construct failure in test %zu/%zu", index+1, count);
+
+            //assert
+            ASSERT_IS_NULL_WITH_MSG(str_handle, tmp_msg);
+        }
+
+        //cleanup
+        umock_c_negative_tests_deinit();
+    }
+
     /* Tests_SRS_STRING_07_005: [If the supplied const char* is NULL STRING_construct shall return a NULL value.] */
     TEST_FUNCTION(STRING_construct_With_NULL_HANDLE_Fail)
     {
@@ -306,7 +369,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(2 + strlen(TEST_STRING_VALUE) + 1));
 
         ///act
         g_hString = STRING_new_quoted(TEST_STRING_VALUE);
@@ -355,7 +417,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         ///arrange
         STRING_HANDLE str_handle;
 
-        EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
         EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
 
         ///act
@@ -377,7 +438,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         ///arrange
         STRING_HANDLE str_handle;
 
-        EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
         EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
 
         ///act
@@ -402,7 +462,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         int negativeTestsInitResult = umock_c_negative_tests_init();
         ASSERT_ARE_EQUAL(int, 0, negativeTestsInitResult);
 
-        EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
         EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
 
         umock_c_negative_tests_snapshot();
@@ -428,7 +487,8 @@ BEGIN_TEST_SUITE(strings_unittests)
         umock_c_negative_tests_deinit();
     }
 
-    /* Tests_ */
+    /* Tests_SRS_STRING_07_012: [STRING_concat shall concatenate the given STRING_HANDLE and the const char* value and place the value in the handle.] */
+    /* Tests_SRS_STRING_03_003: [ If the capacity of the string is enough for the new value, no memory shall be allocated. ]*/
     TEST_FUNCTION(STRING_Concat_Succeed)
     {
         ///arrange
@@ -437,9 +497,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(INITIAL_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, strlen(INITIAL_STRING_VALUE) + strlen(TEST_STRING_VALUE) + 1))
-            .IgnoreArgument(1);
-
         ///act
         nResult = STRING_concat(g_hString, TEST_STRING_VALUE);
 
@@ -452,6 +509,103 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_delete(g_hString);
     }
 
+    /* Tests_SRS_STRING_03_002: [ If the capacity of the string is not enough for the new value, the capacity shall grow to the larger of the needed size and twice the capacity. ]*/
+    TEST_FUNCTION(STRING_Concat_past_the_inline_storage_allocates_twice_the_capacity)
+    {
+        ///arrange
+        int nResult;
+        STRING_HANDLE g_hString;
+        g_hString = STRING_construct(TEST_STRING_VALUE);
+        (void)STRING_concat(g_hString, TEST_STRING_VALUE);
+        (void)STRING_concat(g_hString, TEST_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(2 * TEST_STRING_INLINE_SIZE));
+
+        ///act
+        nResult = STRING_concat(g_hString, TEST_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, 4 * strlen(TEST_STRING_VALUE), STRING_length(g_hString));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
+    /* Tests_SRS_STRING_03_002: [ If the capacity of the string is not enough for the new value, the capacity shall grow to the larger of the needed size and twice the capacity. ]*/
+    TEST_FUNCTION(STRING_Concat_heap_string_reallocates_to_twice_the_capacity)
+    {
+        ///arrange
+        int nResult;
+        STRING_HANDLE g_hString;
+        g_hString = STRING_construct(LONG_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 * (strlen(LONG_STRING_VALUE) + 1)))
+            .IgnoreArgument(1);
+
+        ///act
+        nResult = STRING_concat(g_hString, INITIAL_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, strlen(LONG_STRING_VALUE) + strlen(INITIAL_STRING_VALUE), STRING_length(g_hString));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
+    /* Tests_SRS_STRING_03_002: [ If the capacity of the string is not enough for the new value, the capacity shall grow to the larger of the needed size and twice the capacity. ]*/
+    TEST_FUNCTION(STRING_Concat_longer_than_twice_the_capacity_allocates_the_needed_size)
+    {
+        ///arrange
+        int nResult;
+        STRING_HANDLE g_hString;
+        g_hString = STRING_new();
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(SAS_TOKEN_VALUE) + 1));
+
+        ///act
+        nResult = STRING_concat(g_hString, SAS_TOKEN_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(char_ptr, SAS_TOKEN_VALUE, STRING_c_str(g_hString));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
+    /* Tests_SRS_STRING_07_013: [STRING_concat shall return a nonzero number if an error is encountered.] */
+    TEST_FUNCTION(when_growing_fails_STRING_Concat_fails)
+    {
+        ///arrange
+        int nResult;
+        STRING_HANDLE g_hString;
+        g_hString = STRING_construct(LONG_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, IGNORED_NUM_ARG))
+            .IgnoreAllArguments()
+            .SetReturn(NULL);
+
+        ///act
+        nResult = STRING_concat(g_hString, INITIAL_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(char_ptr, LONG_STRING_VALUE, STRING_c_str(g_hString));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
     /* Tests_SRS_STRING_07_013: [STRING_concat shall return a nonzero number if the STRING_HANDLE and const char* is NULL.] */
     TEST_FUNCTION(STRING_Concat_HANDLE_NULL_Fail)
     {
@@ -516,10 +670,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_copy(g_hString, TEST_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, strlen(TEST_STRING_VALUE) + strlen(TEST_STRING_VALUE)+1))
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
-
         ///act
         STRING_concat(g_hString, TEST_STRING_VALUE);
 
@@ -540,9 +690,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_HANDLE hAppend = STRING_construct(TEST_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, strlen(INITIAL_STRING_VALUE) + strlen(TEST_STRING_VALUE) + 1))
-            .IgnoreArgument(1);
-
         ///act
         nResult = STRING_concat_with_STRING(g_hString, hAppend);
 
@@ -556,6 +703,32 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_delete(g_hString);
     }
 
+    /* Tests_SRS_STRING_07_034: [String_Concat_with_STRING shall concatenate a given STRING_HANDLE variable with a source STRING_HANDLE.] */
+    /* Tests_SRS_STRING_03_002: [ If the capacity of the string is not enough for the new value, the capacity shall grow to the larger of the needed size and twice the capacity. ]*/
+    TEST_FUNCTION(STRING_Concat_With_STRING_to_itself_SUCCEED)
+    {
+        ///arrange
+        int nResult;
+        STRING_HANDLE g_hString = STRING_construct(LONG_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 * (strlen(LONG_STRING_VALUE) + 1)))
+            .IgnoreArgument(1);
+
+        ///act
+        nResult = STRING_concat_with_STRING(g_hString, g_hString);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, 2 * strlen(LONG_STRING_VALUE), STRING_length(g_hString));
+        ASSERT_ARE_EQUAL(int, 0, strncmp(LONG_STRING_VALUE, STRING_c_str(g_hString), strlen(LONG_STRING_VALUE)));
+        ASSERT_ARE_EQUAL(char_ptr, LONG_STRING_VALUE, STRING_c_str(g_hString) + strlen(LONG_STRING_VALUE));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        // Clean up
+        STRING_delete(g_hString);
+    }
+
     /* Tests_SRS_STRING_07_035: [String_Concat_with_STRING shall return a nonzero number if an error is encountered.] */
     TEST_FUNCTION(STRING_Concat_With_STRING_HANDLE_NULL_Fail)
     {
@@ -617,9 +790,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(INITIAL_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, strlen(TEST_STRING_VALUE) + 1))
-            .IgnoreArgument(1);
-
         ///act
         nResult = STRING_copy(g_hString, TEST_STRING_VALUE);
 
@@ -660,9 +830,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_HANDLE g_hString;
         g_hString = STRING_construct(INITIAL_STRING_VALUE);
         umock_c_reset_all_calls();
-        
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, NUMBER_OF_CHAR_TOCOPY + 1))
-            .IgnoreArgument(1);
 
         ///act
         nResult = STRING_copy_n(g_hString, COMBINED_STRING_VALUE, NUMBER_OF_CHAR_TOCOPY);
@@ -718,9 +885,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(INITIAL_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1))
-            .IgnoreArgument(1);
-
         ///act
         nResult = STRING_copy_n(g_hString, COMBINED_STRING_VALUE, 0);
 
@@ -742,9 +906,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(TEST_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 + strlen(TEST_STRING_VALUE) + 1))
-            .IgnoreArgument(1);
-
         ///act
         nResult = STRING_quote(g_hString);
 
@@ -757,6 +918,32 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_delete(g_hString);
     }
 
+    /* Tests_SRS_STRING_03_002: [ If the capacity of the string is not enough for the new value, the capacity shall grow to the larger of the needed size and twice the capacity. ]*/
+    TEST_FUNCTION(STRING_quote_long_string_Succeed)
+    {
+        ///arrange
+        int nResult;
+        STRING_HANDLE g_hString;
+        g_hString = STRING_construct(LONG_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 * (strlen(LONG_STRING_VALUE) + 1)))
+            .IgnoreArgument(1);
+
+        ///act
+        nResult = STRING_quote(g_hString);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(char_ptr, QUOTED_LONG_STRING_VALUE, STRING_c_str(g_hString));
+        ASSERT_ARE_EQUAL(size_t, strlen(QUOTED_LONG_STRING_VALUE), STRING_length(g_hString));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
+    /* Tests_SRS_STRING_07_029: [STRING_quote shall return a nonzero value if any error is encountered.] */
     TEST_FUNCTION(STRING_quote_fail)
     {
         ///arrange
@@ -766,10 +953,10 @@ BEGIN_TEST_SUITE(strings_unittests)
         int negativeTestsInitResult = umock_c_negative_tests_init();
         ASSERT_ARE_EQUAL(int, 0, negativeTestsInitResult);
 
-        str_handle = STRING_construct(TEST_STRING_VALUE);
+        str_handle = STRING_construct(LONG_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 + strlen(TEST_STRING_VALUE) + 1))
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 * (strlen(LONG_STRING_VALUE) + 1)))
             .IgnoreArgument(1);
 
         umock_c_negative_tests_snapshot();
@@ -832,7 +1019,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen(TEST_STRING_VALUE) + 1));
 
         ///act
         g_hString = STRING_construct(TEST_STRING_VALUE);
@@ -855,9 +1041,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(TEST_STRING_VALUE);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1))
-            .IgnoreArgument(1);
-
         ///act
         nResult = STRING_empty(g_hString);
 
@@ -870,6 +1053,29 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_delete(g_hString);
     }
 
+    /* Tests_SRS_STRING_03_004: [ STRING_empty shall keep the capacity of the string for reuse. ]*/
+    TEST_FUNCTION(STRING_empty_keeps_the_capacity)
+    {
+        ///arrange
+        STRING_HANDLE g_hString;
+        int nResult;
+        g_hString = STRING_construct(LONG_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        ///act
+        nResult = STRING_empty(g_hString);
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        nResult = STRING_concat(g_hString, LONG_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(char_ptr, LONG_STRING_VALUE, STRING_c_str(g_hString));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
     /* Tests_SRS_STRING_07_023: [STRING_empty shall return a nonzero value if the STRING_HANDLE is NULL.] */
     TEST_FUNCTION(STRING_empty_NULL_HANDLE_Fail)
     {
@@ -903,6 +1109,24 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_new();
         umock_c_reset_all_calls();
 
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        STRING_delete(g_hString);
+        
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_STRING_07_010: [STRING_delete will free the memory allocated by the STRING_HANDLE.] */
+    TEST_FUNCTION(STRING_delete_long_string_Succeed)
+    {
+        ///arrange
+        STRING_HANDLE g_hString;
+        g_hString = STRING_construct(LONG_STRING_VALUE);
+        umock_c_reset_all_calls();
+
         STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
@@ -910,7 +1134,7 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         ///act
         STRING_delete(g_hString);
-        
+
         ///assert
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     }
@@ -969,7 +1193,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof("aa")));
 
         ///act
         result = STRING_clone(hSource);
@@ -1000,7 +1223,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof("aa")));
 
         umock_c_negative_tests_snapshot();
 
@@ -1061,8 +1283,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(3))
-            .IgnoreArgument(1);
 
         ///act
         result = STRING_construct_n("qq", 2);
@@ -1083,8 +1303,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_HANDLE result;
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(4))
-            .IgnoreArgument(1);
 
         ///act
         result = STRING_construct_n("12345", 3);
@@ -1108,8 +1326,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(3))
-            .IgnoreArgument(1);
 
         umock_c_negative_tests_snapshot();
 
@@ -1286,7 +1502,10 @@ BEGIN_TEST_SUITE(strings_unittests)
 
             STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
                 .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(gballoc_malloc(strlen(JSONtests[i].expectedJSON) + 1));
+            if (strlen(JSONtests[i].expectedJSON) + 1 > TEST_STRING_INLINE_SIZE)
+            {
+                STRICT_EXPECTED_CALL(gballoc_malloc(strlen(JSONtests[i].expectedJSON) + 1));
+            }
 
             ///act
             result = STRING_new_JSON(JSONtests[i].source);
@@ -1310,7 +1529,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         ASSERT_ARE_EQUAL(int, 0, negativeTestsInitResult);
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)).IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(gballoc_malloc(strlen("ab") + 2+1));
 
         umock_c_negative_tests_snapshot();
 
@@ -1374,8 +1592,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument_size();
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(1 + 1));
-
         ///act
         result = STRING_from_byte_array((const unsigned char*)"a", 1);
 
@@ -1396,8 +1612,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument_size();
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(1 + 0));
-
         ///act
         result = STRING_from_byte_array(NULL, 0);
 
@@ -1418,14 +1632,14 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument_size();
         
-        STRICT_EXPECTED_CALL(gballoc_malloc(1 + 1))
+        STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(LONG_STRING_VALUE)))
             .SetReturn(NULL);
 
         STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument_ptr();
 
         ///act
-        result = STRING_from_byte_array((const unsigned char*)"a", 1);
+        result = STRING_from_byte_array((const unsigned char*)LONG_STRING_VALUE, strlen(LONG_STRING_VALUE));
 
         ///assert
         ASSERT_IS_NULL(result);
@@ -1497,8 +1711,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         umock_c_reset_all_calls();
 
-        EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, IGNORED_NUM_ARG));
-
         ///act
         str_result = STRING_sprintf(str_handle, FORMAT_STRING, TEST_STRING_VALUE);
 
@@ -1543,7 +1755,7 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_HANDLE str_handle;
         ASSERT_ARE_EQUAL(int, 0, negativeTestsInitResult);
 
-        str_handle = STRING_construct(INITIAL_STRING_VALUE);
+        str_handle = STRING_construct(LONG_STRING_VALUE);
         ASSERT_IS_NOT_NULL(str_handle);
 
         umock_c_reset_all_calls();
@@ -1700,4 +1912,133 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_delete(str_handle);
     }
 
+    /* Tests_SRS_STRING_03_005: [ If handle is NULL, STRING_reserve shall fail and return a non-zero value. ]*/
+    TEST_FUNCTION(STRING_reserve_with_NULL_handle_fails)
+    {
+        //arrange
+        int str_result;
+
+        //act
+        str_result = STRING_reserve(NULL, 100);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_STRING_03_006: [ If the string can already hold capacity characters, STRING_reserve shall succeed without allocating memory. ]*/
+    TEST_FUNCTION(STRING_reserve_within_the_inline_storage_does_not_allocate)
+    {
+        //arrange
+        int str_result;
+        STRING_HANDLE str_handle = STRING_construct(INITIAL_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        //act
+        str_result = STRING_reserve(str_handle, TEST_STRING_INLINE_SIZE - 1);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(char_ptr, INITIAL_STRING_VALUE, STRING_c_str(str_handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        STRING_delete(str_handle);
+    }
+
+    /* Tests_SRS_STRING_03_007: [ Otherwise STRING_reserve shall reallocate the string to hold exactly capacity characters and the terminating '\0', keeping its value. ]*/
+    /* Tests_SRS_STRING_03_008: [ On success STRING_reserve shall return 0. ]*/
+    TEST_FUNCTION(STRING_reserve_moves_an_inline_string_to_the_heap)
+    {
+        //arrange
+        int str_result;
+        STRING_HANDLE str_handle = STRING_construct(INITIAL_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(100 + 1));
+
+        //act
+        str_result = STRING_reserve(str_handle, 100);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(char_ptr, INITIAL_STRING_VALUE, STRING_c_str(str_handle));
+        ASSERT_ARE_EQUAL(size_t, strlen(INITIAL_STRING_VALUE), STRING_length(str_handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        STRING_delete(str_handle);
+    }
+
+    /* Tests_SRS_STRING_03_007: [ Otherwise STRING_reserve shall reallocate the string to hold exactly capacity characters and the terminating '\0', keeping its value. ]*/
+    TEST_FUNCTION(STRING_reserve_reallocates_a_heap_string)
+    {
+        //arrange
+        int str_result;
+        STRING_HANDLE str_handle = STRING_construct(LONG_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 1000 + 1))
+            .IgnoreArgument(1);
+
+        //act
+        str_result = STRING_reserve(str_handle, 1000);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(char_ptr, LONG_STRING_VALUE, STRING_c_str(str_handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        STRING_delete(str_handle);
+    }
+
+    /* Tests_SRS_STRING_03_003: [ If the capacity of the string is enough for the new value, no memory shall be allocated. ]*/
+    TEST_FUNCTION(STRING_concat_after_STRING_reserve_does_not_allocate)
+    {
+        //arrange
+        int str_result;
+        STRING_HANDLE str_handle = STRING_new();
+        (void)STRING_reserve(str_handle, 3 * strlen(LONG_STRING_VALUE));
+        umock_c_reset_all_calls();
+
+        //act
+        str_result = STRING_concat(str_handle, LONG_STRING_VALUE);
+        ASSERT_ARE_EQUAL(int, 0, str_result);
+        str_result = STRING_concat(str_handle, LONG_STRING_VALUE);
+        ASSERT_ARE_EQUAL(int, 0, str_result);
+        str_result = STRING_concat(str_handle, LONG_STRING_VALUE);
+
+        //assert
+        ASSERT_ARE_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(size_t, 3 * strlen(LONG_STRING_VALUE), STRING_length(str_handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        STRING_delete(str_handle);
+    }
+
+    /* Tests_SRS_STRING_03_009: [ If any error occurs, STRING_reserve shall fail, leave the string unchanged and return a non-zero value. ]*/
+    TEST_FUNCTION(when_allocating_fails_STRING_reserve_fails)
+    {
+        //arrange
+        int str_result;
+        STRING_HANDLE str_handle = STRING_construct(INITIAL_STRING_VALUE);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_malloc(100 + 1))
+            .SetReturn(NULL);
+
+        //act
+        str_result = STRING_reserve(str_handle, 100);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, str_result);
+        ASSERT_ARE_EQUAL(char_ptr, INITIAL_STRING_VALUE, STRING_c_str(str_handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        STRING_delete(str_handle);
+    }
+
 END_TEST_SUITE(strings_unittests)
\ No newline at end of file
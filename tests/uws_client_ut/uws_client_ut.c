@@ -56,11 +56,13 @@ Tests_SRS_UWS_CLIENT_01_211: [ One implication of this is that in absence of ext
 #include "azure_c_shared_utility/shared_util_options.h"
 #include "azure_c_shared_utility/crt_abstractions.h"
 #include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/slab.h"
 #include "azure_c_shared_utility/tlsio.h"
 #include "azure_c_shared_utility/uws_frame_encoder.h"
 #include "azure_c_shared_utility/gb_rand.h"
 #include "azure_c_shared_utility/base64.h"
 #include "azure_c_shared_utility/map.h"
+#include "azure_c_shared_utility/arena.h"
 
 TEST_DEFINE_ENUM_TYPE(IO_OPEN_RESULT, IO_OPEN_RESULT_VALUES);
 IMPLEMENT_UMOCK_C_ENUM_TYPE(IO_OPEN_RESULT, IO_OPEN_RESULT_VALUES);
@@ -74,12 +76,14 @@ IMPLEMENT_UMOCK_C_ENUM_TYPE(WS_FRAME_TYPE, WS_FRAME_TYPE_VALUES);
 static const void** list_items = NULL;
 static size_t list_item_count = 0;
 static const SINGLYLINKEDLIST_HANDLE TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE = (SINGLYLINKEDLIST_HANDLE)0x4242;
+static const SLAB_HANDLE TEST_SLAB_HANDLE = (SLAB_HANDLE)0x4350;
 static const LIST_ITEM_HANDLE TEST_LIST_ITEM_HANDLE = (LIST_ITEM_HANDLE)0x4243;
 static const XIO_HANDLE TEST_IO_HANDLE = (XIO_HANDLE)0x4244;
 static const OPTIONHANDLER_HANDLE TEST_IO_OPTIONHANDLER_HANDLE = (OPTIONHANDLER_HANDLE)0x4446;
 static const OPTIONHANDLER_HANDLE TEST_OPTIONHANDLER_HANDLE = (OPTIONHANDLER_HANDLE)0x4447;
 static const STRING_HANDLE BASE64_ENCODED_STRING = (STRING_HANDLE)0x4447;
 static const MAP_HANDLE TEST_REQUEST_HEADERS_MAP = (MAP_HANDLE)0x4448;
+static const ARENA_HANDLE TEST_ARENA = (ARENA_HANDLE)0x4449;
 
 static size_t currentmalloc_call;
 static size_t whenShallmalloc_fail;
@@ -135,6 +139,19 @@ static void my_gballoc_free(void* ptr)
     free(ptr);
 }
 
+/* the slab is mocked, pending sends are plain heap allocations so that leaks still show */
+static void* my_slab_malloc(SLAB_HANDLE slab)
+{
+    (void)slab;
+    return malloc(64);
+}
+
+static void my_slab_free(SLAB_HANDLE slab, void* ptr)
+{
+    (void)slab;
+    free(ptr);
+}
+
 static int my_mallocAndStrcpy_s(char** destination, const char* source)
 {
     *destination = (char*)malloc(strlen(source) + 1);
@@ -142,6 +159,37 @@ static int my_mallocAndStrcpy_s(char** destination, const char* source)
     return 0;
 }
 
+/* the arena hooks hand out memory from a static buffer, nothing allocated from TEST_ARENA is ever freed */
+static unsigned char test_arena_memory[4096];
+static size_t test_arena_used;
+
+static void* my_arena_malloc(ARENA_HANDLE arena, size_t size)
+{
+    void* result;
+    size_t aligned_size = ((size + sizeof(void*) - 1) / sizeof(void*)) * sizeof(void*);
+    (void)arena;
+    if (aligned_size > sizeof(test_arena_memory) - test_arena_used)
+    {
+        result = NULL;
+    }
+    else
+    {
+        result = test_arena_memory + test_arena_used;
+        test_arena_used += aligned_size;
+    }
+    return result;
+}
+
+static char* my_arena_copy_string(ARENA_HANDLE arena, const char* source)
+{
+    char* result = (char*)my_arena_malloc(arena, strlen(source) + 1);
+    if (result != NULL)
+    {
+        (void)strcpy(result, source);
+    }
+    return result;
+}
+
 static LIST_ITEM_HANDLE add_to_list(const void* item)
 {
     const void** items = (const void**)realloc((void*)list_items, (list_item_count + 1) * sizeof(item));
@@ -469,10 +517,15 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_realloc, my_gballoc_realloc);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
     REGISTER_GLOBAL_MOCK_HOOK(mallocAndStrcpy_s, my_mallocAndStrcpy_s);
+    REGISTER_GLOBAL_MOCK_HOOK(arena_malloc, my_arena_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(arena_copy_string, my_arena_copy_string);
     REGISTER_GLOBAL_MOCK_HOOK(xio_open, my_xio_open);
     REGISTER_GLOBAL_MOCK_HOOK(xio_close, my_xio_close);
     REGISTER_GLOBAL_MOCK_HOOK(xio_send, my_xio_send);
     REGISTER_GLOBAL_MOCK_RETURN(singlylinkedlist_create, TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE);
+    REGISTER_GLOBAL_MOCK_RETURN(slab_create, TEST_SLAB_HANDLE);
+    REGISTER_GLOBAL_MOCK_HOOK(slab_malloc, my_slab_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(slab_free, my_slab_free);
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_remove, my_singlylinkedlist_remove);
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_get_head_item, my_singlylinkedlist_get_head_item);
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_add, my_singlylinkedlist_add);
@@ -482,6 +535,7 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GLOBAL_MOCK_RETURN(socketio_get_interface_description, TEST_SOCKET_IO_INTERFACE_DESCRIPTION);
     REGISTER_GLOBAL_MOCK_RETURN(platform_get_default_tlsio, TEST_TLS_IO_INTERFACE_DESCRIPTION);
     REGISTER_GLOBAL_MOCK_RETURN(xio_create, TEST_IO_HANDLE);
+    REGISTER_GLOBAL_MOCK_RETURN(xio_create_with_arena, TEST_IO_HANDLE);
     REGISTER_GLOBAL_MOCK_RETURN(xio_retrieveoptions, TEST_IO_OPTIONHANDLER_HANDLE);
     REGISTER_GLOBAL_MOCK_RETURN(utf8_checker_is_valid_utf8, true);
     REGISTER_GLOBAL_MOCK_RETURN(Base64_Encode_Bytes, BASE64_ENCODED_STRING);
@@ -495,8 +549,8 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GLOBAL_MOCK_HOOK(uws_frame_encoder_encode, my_uws_frame_encoder_encode);
     REGISTER_GLOBAL_MOCK_HOOK(Map_GetInternals, my_Map_GetInternals);
     REGISTER_GLOBAL_MOCK_RETURN(STRING_c_str, "test_str");
-    REGISTER_GLOBAL_MOCK_RETURN(Map_Create, TEST_REQUEST_HEADERS_MAP);
-    REGISTER_GLOBAL_MOCK_FAIL_RETURN(Map_Create, NULL);
+    REGISTER_GLOBAL_MOCK_RETURN(Map_CreateWithInternedKeys, TEST_REQUEST_HEADERS_MAP);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(Map_CreateWithInternedKeys, NULL);
     REGISTER_GLOBAL_MOCK_RETURN(Map_AddOrUpdate, MAP_OK);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(Map_AddOrUpdate, MAP_ERROR);
     REGISTER_GLOBAL_MOCK_RETURN(Map_GetInternals, MAP_OK);
@@ -512,9 +566,11 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     REGISTER_UMOCK_ALIAS_TYPE(SINGLYLINKEDLIST_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(LIST_ITEM_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(SLAB_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(LIST_MATCH_FUNCTION, void*);
     REGISTER_UMOCK_ALIAS_TYPE(UWS_CLIENT_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(XIO_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(ARENA_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_IO_OPEN_COMPLETE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_BYTES_RECEIVED, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_IO_ERROR, void*);
@@ -551,6 +607,7 @@ TEST_FUNCTION_INITIALIZE(method_init)
 
     currentmalloc_call = 0;
     whenShallmalloc_fail = 0;
+    test_arena_used = 0;
     currentrealloc_call = 0;
     whenShallrealloc_fail = 0;
     singlylinkedlist_remove_result = 0;
@@ -572,6 +629,7 @@ TEST_FUNCTION_CLEANUP(method_cleanup)
 
 /* Tests_SRS_UWS_CLIENT_01_001: [`uws_client_create` shall create an instance of uws and return a non-NULL handle to it.]*/
 /* Tests_SRS_UWS_CLIENT_01_017: [ `uws_client_create` shall create a pending send IO list that is to be used to queue send packets by calling `singlylinkedlist_create`. ]*/
+/* Tests_SRS_UWS_CLIENT_03_005: [ `uws_client_create` shall create a slab for the pending sends by calling `slab_create`. ]*/
 /* Tests_SRS_UWS_CLIENT_01_005: [ If `use_ssl` is false then `uws_client_create` shall obtain the interface used to create a socketio instance by calling `socketio_get_interface_description`. ]*/
 /* Tests_SRS_UWS_CLIENT_01_008: [ The obtained interface shall be used to create the IO used as underlying IO by the newly created uws instance. ]*/
 /* Tests_SRS_UWS_CLIENT_01_009: [ The underlying IO shall be created by calling `xio_create`. ]*/
@@ -599,8 +657,9 @@ TEST_FUNCTION(uws_client_create_with_valid_args_no_ssl_succeeds)
         .IgnoreArgument_destination();
     STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "111"))
         .IgnoreArgument_destination();
-    STRICT_EXPECTED_CALL(Map_Create(NULL));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
     STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(socketio_get_interface_description());
     STRICT_EXPECTED_CALL(xio_create(TEST_SOCKET_IO_INTERFACE_DESCRIPTION, &socketio_config))
         .IgnoreArgument_io_create_parameters();
@@ -661,8 +720,9 @@ TEST_FUNCTION(uws_client_create_with_valid_args_no_ssl_port_different_than_80_su
         .IgnoreArgument_destination();
     STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "333"))
         .IgnoreArgument_destination();
-    STRICT_EXPECTED_CALL(Map_Create(NULL));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
     STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(socketio_get_interface_description());
     STRICT_EXPECTED_CALL(xio_create(TEST_SOCKET_IO_INTERFACE_DESCRIPTION, &socketio_config))
         .IgnoreArgument_io_create_parameters();
@@ -697,8 +757,9 @@ TEST_FUNCTION(uws_client_create_with_NULL_protocols_succeeds)
         .IgnoreArgument_destination();
     STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "333"))
         .IgnoreArgument_destination();
-    STRICT_EXPECTED_CALL(Map_Create(NULL));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
     STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(socketio_get_interface_description());
     STRICT_EXPECTED_CALL(xio_create(TEST_SOCKET_IO_INTERFACE_DESCRIPTION, &socketio_config))
         .IgnoreArgument_io_create_parameters();
@@ -849,7 +910,7 @@ TEST_FUNCTION(when_creating_the_pending_sends_list_fails_then_uws_client_create_
         .IgnoreArgument_destination();
     STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "test_resource/1"))
         .IgnoreArgument_destination();
-    STRICT_EXPECTED_CALL(Map_Create(NULL));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
     STRICT_EXPECTED_CALL(singlylinkedlist_create())
         .SetReturn(NULL);
     EXPECTED_CALL(Map_Destroy(IGNORED_PTR_ARG));
@@ -865,6 +926,35 @@ TEST_FUNCTION(when_creating_the_pending_sends_list_fails_then_uws_client_create_
     ASSERT_IS_NULL(uws_client);
 }
 
+/* Tests_SRS_UWS_CLIENT_03_006: [ If `slab_create` fails then `uws_client_create` shall fail and return NULL. ]*/
+TEST_FUNCTION(when_creating_the_pending_sends_slab_fails_then_uws_client_create_fails)
+{
+    // arrange
+    UWS_CLIENT_HANDLE uws_client;
+
+    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "test_host"))
+        .IgnoreArgument_destination();
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "test_resource/1"))
+        .IgnoreArgument_destination();
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
+    STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
+    EXPECTED_CALL(Map_Destroy(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    uws_client = uws_client_create("test_host", 80, "test_resource/1", false, protocols, sizeof(protocols) / sizeof(protocols[0]));
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(uws_client);
+}
+
 /* Tests_SRS_UWS_CLIENT_01_007: [ If obtaining the underlying IO interface fails, then `uws_client_create` shall fail and return NULL. ]*/
 TEST_FUNCTION(when_getting_the_socket_interface_description_fails_then_uws_client_create_fails)
 {
@@ -881,11 +971,13 @@ TEST_FUNCTION(when_getting_the_socket_interface_description_fails_then_uws_clien
         .IgnoreArgument_destination();
     STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "test_resource/1"))
         .IgnoreArgument_destination();
-    STRICT_EXPECTED_CALL(Map_Create(NULL));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
     STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(socketio_get_interface_description())
         .SetReturn(NULL);
     STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
+    STRICT_EXPECTED_CALL(slab_destroy(TEST_SLAB_HANDLE));
     EXPECTED_CALL(Map_Destroy(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
@@ -915,13 +1007,15 @@ TEST_FUNCTION(when_creating_the_io_handle_fails_then_uws_client_create_fails)
         .IgnoreArgument_destination();
     STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "test_resource/1"))
         .IgnoreArgument_destination();
-    STRICT_EXPECTED_CALL(Map_Create(NULL));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
     STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(socketio_get_interface_description());
     STRICT_EXPECTED_CALL(xio_create(TEST_SOCKET_IO_INTERFACE_DESCRIPTION, &socketio_config))
         .IgnoreArgument_io_create_parameters()
         .SetReturn(NULL);
     STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
+    STRICT_EXPECTED_CALL(slab_destroy(TEST_SLAB_HANDLE));
     EXPECTED_CALL(Map_Destroy(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
@@ -951,8 +1045,9 @@ TEST_FUNCTION(when_allocating_memory_for_the_protocols_array_fails_then_uws_clie
         .IgnoreArgument_destination();
     STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "test_resource/1"))
         .IgnoreArgument_destination();
-    STRICT_EXPECTED_CALL(Map_Create(NULL));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
     STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(socketio_get_interface_description());
     STRICT_EXPECTED_CALL(xio_create(TEST_SOCKET_IO_INTERFACE_DESCRIPTION, &socketio_config))
         .IgnoreArgument_io_create_parameters();
@@ -960,6 +1055,7 @@ TEST_FUNCTION(when_allocating_memory_for_the_protocols_array_fails_then_uws_clie
         .SetReturn(NULL);
     STRICT_EXPECTED_CALL(xio_destroy(TEST_IO_HANDLE));
     STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
+    STRICT_EXPECTED_CALL(slab_destroy(TEST_SLAB_HANDLE));
     EXPECTED_CALL(Map_Destroy(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
@@ -989,8 +1085,9 @@ TEST_FUNCTION(when_allocating_memory_for_the_first_proitocol_name_fails_then_uws
         .IgnoreArgument_destination();
     STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "test_resource/1"))
         .IgnoreArgument_destination();
-    STRICT_EXPECTED_CALL(Map_Create(NULL));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
     STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(socketio_get_interface_description());
     STRICT_EXPECTED_CALL(xio_create(TEST_SOCKET_IO_INTERFACE_DESCRIPTION, &socketio_config))
         .IgnoreArgument_io_create_parameters();
@@ -1001,6 +1098,7 @@ TEST_FUNCTION(when_allocating_memory_for_the_first_proitocol_name_fails_then_uws
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(xio_destroy(TEST_IO_HANDLE));
     STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
+    STRICT_EXPECTED_CALL(slab_destroy(TEST_SLAB_HANDLE));
     EXPECTED_CALL(Map_Destroy(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
@@ -1031,8 +1129,9 @@ TEST_FUNCTION(when_allocating_memory_for_the_second_protocol_name_fails_then_uws
         .IgnoreArgument_destination();
     STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "test_resource/1"))
         .IgnoreArgument_destination();
-    STRICT_EXPECTED_CALL(Map_Create(NULL));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
     STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(socketio_get_interface_description());
     STRICT_EXPECTED_CALL(xio_create(TEST_SOCKET_IO_INTERFACE_DESCRIPTION, &socketio_config))
         .IgnoreArgument_io_create_parameters();
@@ -1046,6 +1145,7 @@ TEST_FUNCTION(when_allocating_memory_for_the_second_protocol_name_fails_then_uws
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(xio_destroy(TEST_IO_HANDLE));
     STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
+    STRICT_EXPECTED_CALL(slab_destroy(TEST_SLAB_HANDLE));
     EXPECTED_CALL(Map_Destroy(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
@@ -1086,8 +1186,9 @@ TEST_FUNCTION(uws_client_create_with_valid_args_ssl_succeeds)
         .IgnoreArgument_destination();
     STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "test_resource/23"))
         .IgnoreArgument_destination();
-    STRICT_EXPECTED_CALL(Map_Create(NULL));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
     STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(platform_get_default_tlsio());
     STRICT_EXPECTED_CALL(socketio_get_interface_description());
     STRICT_EXPECTED_CALL(xio_create(TEST_TLS_IO_INTERFACE_DESCRIPTION, &tlsio_config))
@@ -1132,8 +1233,9 @@ TEST_FUNCTION(uws_client_create_with_valid_args_ssl_port_different_than_443_succ
         .IgnoreArgument_destination();
     STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "test_resource/23"))
         .IgnoreArgument_destination();
-    STRICT_EXPECTED_CALL(Map_Create(NULL));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
     STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(platform_get_default_tlsio());
     STRICT_EXPECTED_CALL(socketio_get_interface_description());
     STRICT_EXPECTED_CALL(xio_create(TEST_TLS_IO_INTERFACE_DESCRIPTION, &tlsio_config))
@@ -1168,11 +1270,13 @@ TEST_FUNCTION(when_getting_the_tlsio_interface_fails_then_uws_client_create_fail
         .IgnoreArgument_destination();
     STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "test_resource/23"))
         .IgnoreArgument_destination();
-    STRICT_EXPECTED_CALL(Map_Create(NULL));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
     STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(platform_get_default_tlsio())
         .SetReturn(NULL);
     STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
+    STRICT_EXPECTED_CALL(slab_destroy(TEST_SLAB_HANDLE));
     EXPECTED_CALL(Map_Destroy(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
@@ -1194,6 +1298,7 @@ TEST_FUNCTION(when_getting_the_tlsio_interface_fails_then_uws_client_create_fail
 /* Tests_SRS_UWS_CLIENT_01_521: [ The underlying IO shall be created by calling `xio_create`, while passing as arguments the `io_interface` and `io_create_parameters` argument values. ]*/
 /* Tests_SRS_UWS_CLIENT_01_523: [ The argument `resource_name` shall be copied for later use. ]*/
 /* Tests_SRS_UWS_CLIENT_01_530: [ `uws_client_create_with_io` shall create a pending send IO list that is to be used to queue send packets by calling `singlylinkedlist_create`. ]*/
+/* Tests_SRS_UWS_CLIENT_03_007: [ `uws_client_create_with_io` shall create a slab for the pending sends by calling `slab_create`. ]*/
 /* Tests_SRS_UWS_CLIENT_01_527: [ The protocol information indicated by `protocols` and `protocol_count` shall be copied for later use (for constructing the upgrade request). ]*/
 TEST_FUNCTION(uws_client_create_with_io_valid_args_succeeds)
 {
@@ -1210,8 +1315,9 @@ TEST_FUNCTION(uws_client_create_with_io_valid_args_succeeds)
         .IgnoreArgument_destination();
     STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "111"))
         .IgnoreArgument_destination();
-    STRICT_EXPECTED_CALL(Map_Create(NULL));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
     STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(xio_create(TEST_SOCKET_IO_INTERFACE_DESCRIPTION, &socketio_config))
         .IgnoreArgument_io_create_parameters();
     EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
@@ -1229,6 +1335,114 @@ TEST_FUNCTION(uws_client_create_with_io_valid_args_succeeds)
     uws_client_destroy(uws_client);
 }
 
+/* Tests_SRS_UWS_CLIENT_03_001: [ `uws_client_create_with_arena` shall behave like `uws_client_create`. ]*/
+/* Tests_SRS_UWS_CLIENT_03_004: [ If `arena` is not NULL, `uws_client_create_with_arena` shall create the underlying IO by calling `xio_create_with_arena` with `arena` instead of `xio_create`. ]*/
+TEST_FUNCTION(uws_client_create_with_arena_allocates_from_the_arena)
+{
+    // arrange
+    UWS_CLIENT_HANDLE uws_client;
+
+    STRICT_EXPECTED_CALL(arena_malloc(TEST_ARENA, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(arena_copy_string(TEST_ARENA, "test_host"));
+    STRICT_EXPECTED_CALL(arena_copy_string(TEST_ARENA, "111"));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
+    STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(socketio_get_interface_description());
+    STRICT_EXPECTED_CALL(xio_create_with_arena(TEST_SOCKET_IO_INTERFACE_DESCRIPTION, IGNORED_PTR_ARG, TEST_ARENA));
+    STRICT_EXPECTED_CALL(arena_malloc(TEST_ARENA, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(arena_copy_string(TEST_ARENA, "test_protocol"));
+
+    // act
+    uws_client = uws_client_create_with_arena(TEST_ARENA, "test_host", 80, "111", false, protocols, sizeof(protocols) / sizeof(protocols[0]));
+
+    // assert
+    ASSERT_IS_NOT_NULL(uws_client);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    uws_client_destroy(uws_client);
+}
+
+/* Tests_SRS_UWS_CLIENT_03_004: [ If `arena` is not NULL, `uws_client_create_with_arena` shall create the underlying IO by calling `xio_create_with_arena` with `arena` instead of `xio_create`. ]*/
+TEST_FUNCTION(uws_client_create_with_arena_with_ssl_creates_the_tls_io_in_the_arena)
+{
+    // arrange
+    UWS_CLIENT_HANDLE uws_client;
+
+    STRICT_EXPECTED_CALL(arena_malloc(TEST_ARENA, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(arena_copy_string(TEST_ARENA, "test_host"));
+    STRICT_EXPECTED_CALL(arena_copy_string(TEST_ARENA, "111"));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
+    STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(platform_get_default_tlsio());
+    STRICT_EXPECTED_CALL(socketio_get_interface_description());
+    STRICT_EXPECTED_CALL(xio_create_with_arena(TEST_TLS_IO_INTERFACE_DESCRIPTION, IGNORED_PTR_ARG, TEST_ARENA));
+    STRICT_EXPECTED_CALL(arena_malloc(TEST_ARENA, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(arena_copy_string(TEST_ARENA, "test_protocol"));
+
+    // act
+    uws_client = uws_client_create_with_arena(TEST_ARENA, "test_host", 443, "111", true, protocols, sizeof(protocols) / sizeof(protocols[0]));
+
+    // assert
+    ASSERT_IS_NOT_NULL(uws_client);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    uws_client_destroy(uws_client);
+}
+
+/* Tests_SRS_UWS_CLIENT_03_001: [ `uws_client_create_with_arena` shall behave like `uws_client_create`. ]*/
+TEST_FUNCTION(when_arena_copy_string_fails_uws_client_create_with_arena_fails)
+{
+    // arrange
+    UWS_CLIENT_HANDLE uws_client;
+
+    STRICT_EXPECTED_CALL(arena_malloc(TEST_ARENA, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(arena_copy_string(TEST_ARENA, "test_host"))
+        .SetReturn(NULL);
+
+    // act
+    uws_client = uws_client_create_with_arena(TEST_ARENA, "test_host", 80, "111", false, protocols, sizeof(protocols) / sizeof(protocols[0]));
+
+    // assert
+    ASSERT_IS_NULL(uws_client);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_UWS_CLIENT_03_002: [ `uws_client_create_with_io_and_arena` shall behave like `uws_client_create_with_io`. ]*/
+TEST_FUNCTION(uws_client_create_with_io_and_arena_allocates_from_the_arena)
+{
+    // arrange
+    SOCKETIO_CONFIG socketio_config;
+    UWS_CLIENT_HANDLE uws_client;
+
+    socketio_config.accepted_socket = NULL;
+    socketio_config.hostname = "my_horrible_host";
+    socketio_config.port = 1122;
+
+    STRICT_EXPECTED_CALL(arena_malloc(TEST_ARENA, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(arena_copy_string(TEST_ARENA, "test_host"));
+    STRICT_EXPECTED_CALL(arena_copy_string(TEST_ARENA, "111"));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
+    STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(xio_create(TEST_SOCKET_IO_INTERFACE_DESCRIPTION, &socketio_config));
+    STRICT_EXPECTED_CALL(arena_malloc(TEST_ARENA, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(arena_copy_string(TEST_ARENA, "test_protocol"));
+
+    // act
+    uws_client = uws_client_create_with_io_and_arena(TEST_ARENA, TEST_SOCKET_IO_INTERFACE_DESCRIPTION, &socketio_config, "test_host", 80, "111", protocols, sizeof(protocols) / sizeof(protocols[0]));
+
+    // assert
+    ASSERT_IS_NOT_NULL(uws_client);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    uws_client_destroy(uws_client);
+}
+
 /* Tests_SRS_UWS_CLIENT_01_516: [ If any of the arguments `io_interface`, `hostname` and `resource_name` is NULL then `uws_client_create_with_io` shall return NULL. ]*/
 TEST_FUNCTION(uws_client_create_with_io_with_NULL_io_interface_description_fails)
 {
@@ -1291,6 +1505,7 @@ TEST_FUNCTION(uws_client_create_with_io_with_NULL_resource_name_fails)
 /* Tests_SRS_UWS_CLIENT_01_522: [ If `xio_create` fails, then `uws_client_create_with_io` shall fail and return NULL. ]*/
 /* Tests_SRS_UWS_CLIENT_01_529: [ If allocating memory for the copy of the `resource_name` argument fails, then `uws_client_create_with_io` shall return NULL. ]*/
 /* Tests_SRS_UWS_CLIENT_01_531: [ If `singlylinkedlist_create` fails then `uws_client_create_with_io` shall fail and return NULL. ]*/
+/* Tests_SRS_UWS_CLIENT_03_008: [ If `slab_create` fails then `uws_client_create_with_io` shall fail and return NULL. ]*/
 /* Tests_SRS_UWS_CLIENT_01_528: [ If allocating memory for the copied protocol information fails then `uws_client_create_with_io` shall fail and return NULL. ]*/
 TEST_FUNCTION(when_any_call_fails_uws_client_create_with_io_fails)
 {
@@ -1315,9 +1530,11 @@ TEST_FUNCTION(when_any_call_fails_uws_client_create_with_io_fails)
     STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "111"))
         .IgnoreArgument_destination()
         .SetFailReturn(1);
-    STRICT_EXPECTED_CALL(Map_Create(NULL));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
     STRICT_EXPECTED_CALL(singlylinkedlist_create())
         .SetFailReturn(NULL);
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG))
+        .SetFailReturn(NULL);
     STRICT_EXPECTED_CALL(xio_create(TEST_SOCKET_IO_INTERFACE_DESCRIPTION, &socketio_config))
         .IgnoreArgument_io_create_parameters()
         .SetFailReturn(NULL);
@@ -1365,8 +1582,9 @@ TEST_FUNCTION(uws_client_create_with_io_with_NULL_protocols_succeeds)
         .IgnoreArgument_destination();
     STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "111"))
         .IgnoreArgument_destination();
-    STRICT_EXPECTED_CALL(Map_Create(NULL));
+    STRICT_EXPECTED_CALL(Map_CreateWithInternedKeys(NULL));
     STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(xio_create(TEST_SOCKET_IO_INTERFACE_DESCRIPTION, &socketio_config))
         .IgnoreArgument_io_create_parameters();
 
@@ -1445,6 +1663,7 @@ TEST_FUNCTION(uws_client_create_with_io_with_a_NULL_protocol_name_for_second_pro
 /* Tests_SRS_UWS_CLIENT_01_019: [ `uws_client_destroy` shall free all resources associated with the uws instance. ]*/
 /* Tests_SRS_UWS_CLIENT_01_023: [ `uws_client_destroy` shall ensure the underlying IO created in `uws_client_open_async` is destroyed by calling `xio_destroy`. ]*/
 /* Tests_SRS_UWS_CLIENT_01_024: [ `uws_client_destroy` shall free the list used to track the pending sends by calling `singlylinkedlist_destroy`. ]*/
+/* Tests_SRS_UWS_CLIENT_03_009: [ `uws_client_destroy` shall destroy the pending send slab by calling `slab_destroy`. ]*/
 /* Tests_SRS_UWS_CLIENT_01_424: [ `uws_client_destroy` shall free the buffer allocated in `uws_client_create` by calling `BUFFER_delete`. ]*/
 /* Tests_SRS_UWS_CLIENT_01_437: [ `uws_client_destroy` shall free the protocols array allocated in `uws_client_create`. ]*/
 TEST_FUNCTION(uws_client_destroy_fress_the_resources)
@@ -1465,6 +1684,7 @@ TEST_FUNCTION(uws_client_destroy_fress_the_resources)
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(xio_destroy(TEST_IO_HANDLE));
     STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
+    STRICT_EXPECTED_CALL(slab_destroy(TEST_SLAB_HANDLE));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(Map_Destroy(IGNORED_PTR_ARG));
@@ -1477,6 +1697,29 @@ TEST_FUNCTION(uws_client_destroy_fress_the_resources)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+/* Tests_SRS_UWS_CLIENT_03_003: [ Memory obtained from the arena shall not be freed by `uws_client_destroy`. ]*/
+TEST_FUNCTION(uws_client_destroy_does_not_free_arena_memory)
+{
+    // arrange
+    UWS_CLIENT_HANDLE uws_client;
+
+    uws_client = uws_client_create_with_arena(TEST_ARENA, "test_host", 444, "aaa", true, protocols, sizeof(protocols) / sizeof(protocols[0]));
+    umock_c_reset_all_calls();
+
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(xio_destroy(TEST_IO_HANDLE));
+    STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
+    STRICT_EXPECTED_CALL(slab_destroy(TEST_SLAB_HANDLE));
+    EXPECTED_CALL(Map_Destroy(IGNORED_PTR_ARG));
+
+    // act
+    uws_client_destroy(uws_client);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 /* Tests_SRS_UWS_CLIENT_01_437: [ `uws_client_destroy` shall free the protocols array allocated in `uws_client_create`. ]*/
 TEST_FUNCTION(uws_client_destroy_with_2_protocols_fress_both_protocols)
 {
@@ -1498,6 +1741,7 @@ TEST_FUNCTION(uws_client_destroy_with_2_protocols_fress_both_protocols)
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(xio_destroy(TEST_IO_HANDLE));
     STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
+    STRICT_EXPECTED_CALL(slab_destroy(TEST_SLAB_HANDLE));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(Map_Destroy(IGNORED_PTR_ARG));
@@ -1527,6 +1771,7 @@ TEST_FUNCTION(uws_client_destroy_with_no_protocols_frees_all_other_resources)
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(xio_destroy(TEST_IO_HANDLE));
     STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
+    STRICT_EXPECTED_CALL(slab_destroy(TEST_SLAB_HANDLE));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(Map_Destroy(IGNORED_PTR_ARG));
@@ -1577,6 +1822,7 @@ TEST_FUNCTION(uws_client_destroy_also_performs_a_close)
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(xio_destroy(TEST_IO_HANDLE));
     STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
+    STRICT_EXPECTED_CALL(slab_destroy(TEST_SLAB_HANDLE));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(Map_Destroy(IGNORED_PTR_ARG));
@@ -2289,8 +2535,8 @@ TEST_FUNCTION(uws_client_close_async_with_1_pending_send_frames_indicates_the_fr
     EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG))
         .ValidateArgumentValue_item_handle(&list_item);
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_send_frame_complete((void*)0x4248, WS_SEND_FRAME_CANCELLED));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
 
     // act
@@ -2339,15 +2585,15 @@ TEST_FUNCTION(uws_client_close_async_with_2_pending_send_frames_indicates_the_fr
     EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG))
         .ValidateArgumentValue_item_handle(&list_item_1);
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_send_frame_complete((void*)0x4248, WS_SEND_FRAME_CANCELLED));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE))
         .CaptureReturn(&list_item_2);
     EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG))
         .ValidateArgumentValue_item_handle(&list_item_2);
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_send_frame_complete((void*)0x4249, WS_SEND_FRAME_CANCELLED));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
 
     // act
@@ -5694,7 +5940,7 @@ TEST_FUNCTION(uws_client_send_frame_async_succeeds)
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response));
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(slab_malloc(TEST_SLAB_HANDLE));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_BINARY_FRAME, test_payload, sizeof(test_payload), true, true, 0))
         .CaptureReturn(&buffer_handle);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG))
@@ -5744,7 +5990,7 @@ TEST_FUNCTION(uws_send_text_frame_succeeds)
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response));
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(slab_malloc(TEST_SLAB_HANDLE));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_TEXT_FRAME, test_payload, sizeof(test_payload), true, true, 0))
         .CaptureReturn(&buffer_handle);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG))
@@ -5774,6 +6020,7 @@ TEST_FUNCTION(uws_send_text_frame_succeeds)
 }
 
 /* Tests_SRS_UWS_CLIENT_01_047: [ If allocating memory for the newly queued item fails, `uws_client_send_frame_async` shall fail and return a non-zero value. ]*/
+/* Tests_SRS_UWS_CLIENT_03_011: [ The memory for the queued item shall be obtained from the pending send slab by calling `slab_malloc`. ]*/
 TEST_FUNCTION(when_allocating_memory_for_the_new_sent_item_fails_uws_client_send_frame_async_fails)
 {
     // arrange
@@ -5792,7 +6039,7 @@ TEST_FUNCTION(when_allocating_memory_for_the_new_sent_item_fails_uws_client_send
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response));
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+    STRICT_EXPECTED_CALL(slab_malloc(TEST_SLAB_HANDLE))
         .SetReturn(NULL);
 
     // act
@@ -5825,10 +6072,10 @@ TEST_FUNCTION(when_encoding_the_frame_fails_uws_client_send_frame_async_fails)
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response));
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(slab_malloc(TEST_SLAB_HANDLE));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_BINARY_FRAME, test_payload, sizeof(test_payload), true, true, 0))
         .SetReturn(NULL);
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
 
     // act
     result = uws_client_send_frame_async(uws_client, WS_FRAME_TYPE_BINARY, test_payload, sizeof(test_payload), true, test_on_ws_send_frame_complete, (void*)0x4248);
@@ -5868,7 +6115,7 @@ TEST_FUNCTION(when_xio_send_fails_uws_client_send_frame_async_fails)
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response));
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(slab_malloc(TEST_SLAB_HANDLE));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_BINARY_FRAME, test_payload, sizeof(test_payload), true, true, 0))
         .CaptureReturn(&buffer_handle);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG))
@@ -5889,7 +6136,7 @@ TEST_FUNCTION(when_xio_send_fails_uws_client_send_frame_async_fails)
         .SetReturn((LIST_ITEM_HANDLE)0x1234);
     STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG))
         .ValidateArgumentValue_item_handle(&new_item_handle);
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(BUFFER_delete(IGNORED_PTR_ARG))
         .ValidateArgumentValue_handle(&buffer_handle);
 
@@ -5930,7 +6177,7 @@ TEST_FUNCTION(when_xio_send_fails_uws_client_send_frame_async_fails_message_remo
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(slab_malloc(TEST_SLAB_HANDLE));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_BINARY_FRAME, test_payload, sizeof(test_payload), true, true, 0))
         .CaptureReturn(&buffer_handle);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG))
@@ -5955,8 +6202,8 @@ TEST_FUNCTION(when_xio_send_fails_uws_client_send_frame_async_fails_message_remo
     g_xio_send_result = 1;
     STRICT_EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_send_frame_complete(IGNORED_PTR_ARG, WS_SEND_FRAME_ERROR));
-    STRICT_EXPECTED_CALL(free(IGNORED_PTR_ARG));
 
     // act
     result = uws_client_send_frame_async(uws_client, WS_FRAME_TYPE_BINARY, test_payload, sizeof(test_payload), true, test_on_ws_send_frame_complete, (void*)0x4248);
@@ -5991,7 +6238,7 @@ TEST_FUNCTION(when_adding_the_item_to_the_list_fails_uws_client_send_frame_async
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response));
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(slab_malloc(TEST_SLAB_HANDLE));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_BINARY_FRAME, test_payload, sizeof(test_payload), true, true, 0))
         .CaptureReturn(&buffer_handle);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG))
@@ -6003,7 +6250,7 @@ TEST_FUNCTION(when_adding_the_item_to_the_list_fails_uws_client_send_frame_async
     STRICT_EXPECTED_CALL(singlylinkedlist_add(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG))
         .IgnoreArgument_item()
         .SetReturn(NULL);
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(BUFFER_delete(IGNORED_PTR_ARG))
         .ValidateArgumentValue_handle(&buffer_handle);
 
@@ -6039,7 +6286,7 @@ TEST_FUNCTION(uws_client_send_frame_async_with_NULL_complete_callback_succeeds)
     g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)test_upgrade_response, sizeof(test_upgrade_response));
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(slab_malloc(TEST_SLAB_HANDLE));
     STRICT_EXPECTED_CALL(uws_frame_encoder_encode(WS_BINARY_FRAME, test_payload, sizeof(test_payload), true, true, 0))
         .CaptureReturn(&buffer_handle);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG))
@@ -6073,6 +6320,7 @@ TEST_FUNCTION(uws_client_send_frame_async_with_NULL_complete_callback_succeeds)
 /* Tests_SRS_UWS_CLIENT_01_389: [ When `on_underlying_io_send_complete` is called with `IO_SEND_OK` as a result of sending a WebSocket frame to the underlying IO, the send shall be indicated to the uws user by calling `on_ws_send_frame_complete` with `WS_SEND_FRAME_OK`. ]*/
 /* Tests_SRS_UWS_CLIENT_01_432: [ The indicated sent frame shall be removed from the list by calling `singlylinkedlist_remove`. ]*/
 /* Tests_SRS_UWS_CLIENT_01_434: [ The memory associated with the sent frame shall be freed. ]*/
+/* Tests_SRS_UWS_CLIENT_03_010: [ The sent frame shall be returned to the pending send slab by calling `slab_free` before the `on_ws_send_frame_complete` callback is called, as the callback may destroy the uws instance. ]*/
 TEST_FUNCTION(on_underlying_io_send_complete_with_OK_indicates_the_frame_as_sent_OK)
 {
     // arrange
@@ -6094,8 +6342,8 @@ TEST_FUNCTION(on_underlying_io_send_complete_with_OK_indicates_the_frame_as_sent
     EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG))
         .IgnoreArgument_item_handle();
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_send_frame_complete((void*)0x4245, WS_SEND_FRAME_OK));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 
     // act
     g_on_io_send_complete(g_on_io_send_complete_context, IO_SEND_OK);
@@ -6164,8 +6412,8 @@ TEST_FUNCTION(on_underlying_io_send_complete_with_ERROR_indicates_the_frame_with
     EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG))
         .IgnoreArgument_item_handle();
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_send_frame_complete((void*)0x4245, WS_SEND_FRAME_ERROR));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 
     // act
     g_on_io_send_complete(g_on_io_send_complete_context, IO_SEND_ERROR);
@@ -6199,8 +6447,8 @@ TEST_FUNCTION(on_underlying_io_send_complete_with_CANCELLED_indicates_the_frame_
     EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG))
         .IgnoreArgument_item_handle();
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_send_frame_complete((void*)0x4245, WS_SEND_FRAME_CANCELLED));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 
     // act
     g_on_io_send_complete(g_on_io_send_complete_context, IO_SEND_CANCELLED);
@@ -6263,8 +6511,8 @@ TEST_FUNCTION(on_underlying_io_send_complete_with_an_unknown_result_indicates_an
     EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG))
         .IgnoreArgument_item_handle();
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_ws_send_frame_complete((void*)0x4245, WS_SEND_FRAME_ERROR));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 
     // act
     g_on_io_send_complete(g_on_io_send_complete_context, (IO_SEND_RESULT)0x42);
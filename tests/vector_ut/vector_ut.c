@@ -58,6 +58,14 @@ static bool VECTOR_UNITTEST_isEqual(const void* left_hand_side, const void* righ
     return (rhs->nValue1 == lhs->nValue1 && rhs->lValue2 == lhs->lValue2);
 }
 
+static int VECTOR_UNITTEST_compare(const void* element1, const void* element2)
+{
+    const VECTOR_UNITTEST* lhs = (const VECTOR_UNITTEST*)element1;
+    const VECTOR_UNITTEST* rhs = (const VECTOR_UNITTEST*)element2;
+
+    return (lhs->nValue1 < rhs->nValue1) ? -1 : ((lhs->nValue1 > rhs->nValue1) ? 1 : 0);
+}
+
 #define NUM_ITEM_PUSH_BACK      128
 
 static TEST_MUTEX_HANDLE g_dllByDll;
@@ -776,7 +784,8 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         VECTOR_destroy(handle);
     }
 
-    /* Tests_SRS_VECTOR_10_014: [VECTOR_erase shall remove the `numElements` starting at `elements` and reduce its internal storage.] */
+    /* Tests_SRS_VECTOR_10_014: [VECTOR_erase shall remove the `numElements` starting at `elements`.] */
+    /* Tests_SRS_VECTOR_03_003: [VECTOR_erase shall keep the capacity of the vector for reuse.] */
     TEST_FUNCTION(VECTOR_erase_succeeds_case_1)
     {
         ///arrange
@@ -789,8 +798,6 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         (void)VECTOR_push_back(handle, &sItem2, 1);
         pfindItem = (VECTOR_UNITTEST*)VECTOR_find_if(handle, VECTOR_UNITTEST_isEqual, &sItem1);
         umock_c_reset_all_calls();
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, sizeof(VECTOR_UNITTEST)))
-            .IgnoreArgument_ptr();
 
         ///act
         VECTOR_erase(handle, pfindItem, 1);
@@ -798,6 +805,7 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         ///assert
         num = VECTOR_size(handle);
         ASSERT_ARE_EQUAL(size_t, 1, num);
+        ASSERT_ARE_EQUAL(size_t, 2, VECTOR_capacity(handle));
         pfindItem = (VECTOR_UNITTEST*)VECTOR_find_if(handle, VECTOR_UNITTEST_isEqual, &sItem1);
         ASSERT_IS_NULL(pfindItem);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -806,7 +814,8 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         VECTOR_destroy(handle);
     }
 
-    /* Tests_SRS_VECTOR_10_014: [VECTOR_erase shall remove the `numElements` starting at `elements` and reduce its internal storage.] */
+    /* Tests_SRS_VECTOR_10_014: [VECTOR_erase shall remove the `numElements` starting at `elements`.] */
+    /* Tests_SRS_VECTOR_03_003: [VECTOR_erase shall keep the capacity of the vector for reuse.] */
     TEST_FUNCTION(VECTOR_erase_succeeds_case_2)
     {
         ///arrange
@@ -819,8 +828,6 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         (void)VECTOR_push_back(handle, &sItem2, 1);
         pfindItem = (VECTOR_UNITTEST*)VECTOR_find_if(handle, VECTOR_UNITTEST_isEqual, &sItem1);
         umock_c_reset_all_calls();
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument_ptr();
 
         ///act
         VECTOR_erase(handle, pfindItem, 2);
@@ -828,6 +835,7 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         ///assert
         num = VECTOR_size(handle);
         ASSERT_ARE_EQUAL(size_t, 0, num);
+        ASSERT_ARE_EQUAL(size_t, 2, VECTOR_capacity(handle));
         pfindItem = (VECTOR_UNITTEST*)VECTOR_find_if(handle, VECTOR_UNITTEST_isEqual, &sItem1);
         ASSERT_IS_NULL(pfindItem);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -836,7 +844,8 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         VECTOR_destroy(handle);
     }
 
-    /* Tests_SRS_VECTOR_10_014: [VECTOR_erase shall remove the `numElements` starting at `elements` and reduce its internal storage.] */
+    /* Tests_SRS_VECTOR_03_003: [VECTOR_erase shall keep the capacity of the vector for reuse.] */
+    /* Tests_SRS_VECTOR_03_002: [VECTOR_push_back shall not allocate memory if the capacity of the vector is enough for the new elements.] */
     TEST_FUNCTION(VECTOR_erase_succeeds_case_3)
     {
         ///arrange
@@ -849,13 +858,10 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         (void)VECTOR_push_back(handle, &sItem2, 1);
         pfindItem = (VECTOR_UNITTEST*)VECTOR_find_if(handle, VECTOR_UNITTEST_isEqual, &sItem1);
         umock_c_reset_all_calls();
-        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, IGNORED_NUM_ARG))
-            .IgnoreArgument_ptr()
-            .IgnoreArgument_size()
-            .SetReturn(NULL);
 
         ///act
-        VECTOR_erase(handle, pfindItem, 1);
+        VECTOR_erase(handle, pfindItem, 2);
+        (void)VECTOR_push_back(handle, &sItem2, 1);
 
         ///assert
         num = VECTOR_size(handle);
@@ -998,6 +1004,7 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         VECTOR_destroy(handle);
     }
 
+    /* Tests_SRS_VECTOR_03_001: [If the capacity of the vector is not enough for the new elements, VECTOR_push_back shall grow it to the larger of the needed number of elements and twice the capacity.] */
     TEST_FUNCTION(VECTOR_push_back_multiple_elements_succeeds)
     {
         ///arrange
@@ -1007,9 +1014,10 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         VECTOR_UNITTEST sItem1 = {1, 2};
         VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
         umock_c_reset_all_calls();
-        for (nIndex = 0; nIndex < NUM_ITEM_PUSH_BACK; nIndex++)
+        /* the capacity doubles, so only pushing the 1st, 2nd, 3rd, 5th, 9th... element reallocates */
+        for (nIndex = 1; nIndex <= NUM_ITEM_PUSH_BACK; nIndex *= 2)
         {
-            STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, (nIndex + 1) * sizeof(VECTOR_UNITTEST)))
+            STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, nIndex * sizeof(VECTOR_UNITTEST)))
                 .IgnoreArgument_ptr();
         }
 
@@ -1033,6 +1041,653 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         VECTOR_destroy(handle);
     }
 
+    /* Tests_SRS_VECTOR_03_001: [If the capacity of the vector is not enough for the new elements, VECTOR_push_back shall grow it to the larger of the needed number of elements and twice the capacity.] */
+    TEST_FUNCTION(VECTOR_push_back_more_than_twice_the_capacity_allocates_the_needed_elements)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST sItems[5] = { { 1, 2 }, { 3, 4 }, { 5, 6 }, { 7, 8 }, { 9, 10 } };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItems[0], 1);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 6 * sizeof(VECTOR_UNITTEST)))
+            .IgnoreArgument_ptr();
+
+        ///act
+        result = VECTOR_push_back(handle, sItems, 5);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 6, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(size_t, 6, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_10_012: [VECTOR_push_back shall fail and return non-zero if memory allocation fails.] */
+    TEST_FUNCTION(VECTOR_push_back_fails_if_growing_fails)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST sItem = { 1, 2 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(VECTOR_UNITTEST)))
+            .IgnoreArgument_ptr()
+            .SetReturn(NULL);
+
+        ///act
+        result = VECTOR_push_back(handle, &sItem, 1);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 1, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(size_t, 1, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_015: [VECTOR_capacity shall return 0 if the given handle is NULL.] */
+    TEST_FUNCTION(VECTOR_capacity_returns_0_if_handle_is_NULL)
+    {
+        ///arrange
+        size_t num;
+
+        ///act
+        num = VECTOR_capacity(NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 0, num);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_VECTOR_03_016: [VECTOR_capacity shall return the number of elements the vector can hold without allocating memory.] */
+    TEST_FUNCTION(VECTOR_capacity_succeeds)
+    {
+        ///arrange
+        size_t num;
+        VECTOR_UNITTEST sItem = { 1, 2 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+
+        ///act
+        num = VECTOR_capacity(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 4, num);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_004: [VECTOR_reserve shall fail and return non-zero if `handle` is NULL.] */
+    TEST_FUNCTION(VECTOR_reserve_fails_if_handle_is_NULL)
+    {
+        ///arrange
+        int result;
+
+        ///act
+        result = VECTOR_reserve(NULL, 10);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_VECTOR_03_006: [Otherwise VECTOR_reserve shall reallocate the storage to hold exactly `numElements` elements, keeping the elements of the vector.] */
+    /* Tests_SRS_VECTOR_03_008: [On success VECTOR_reserve shall return 0.] */
+    TEST_FUNCTION(VECTOR_reserve_succeeds)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST* pResult;
+        VECTOR_UNITTEST sItem = { 1, 2 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 10 * sizeof(VECTOR_UNITTEST)))
+            .IgnoreArgument_ptr();
+
+        ///act
+        result = VECTOR_reserve(handle, 10);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 1, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(size_t, 10, VECTOR_capacity(handle));
+        pResult = (VECTOR_UNITTEST*)VECTOR_front(handle);
+        ASSERT_ARE_EQUAL(int, sItem.nValue1, pResult->nValue1);
+        ASSERT_ARE_EQUAL(long, sItem.lValue2, pResult->lValue2);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_005: [If the capacity of the vector is at least `numElements`, VECTOR_reserve shall return 0 without allocating memory.] */
+    /* Tests_SRS_VECTOR_03_002: [VECTOR_push_back shall not allocate memory if the capacity of the vector is enough for the new elements.] */
+    TEST_FUNCTION(VECTOR_reserve_within_the_capacity_does_not_allocate)
+    {
+        ///arrange
+        int result;
+        size_t nIndex;
+        VECTOR_UNITTEST sItem = { 1, 2 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_reserve(handle, NUM_ITEM_PUSH_BACK);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = VECTOR_reserve(handle, NUM_ITEM_PUSH_BACK / 2);
+        for (nIndex = 0; nIndex < NUM_ITEM_PUSH_BACK; nIndex++)
+        {
+            (void)VECTOR_push_back(handle, &sItem, 1);
+        }
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, NUM_ITEM_PUSH_BACK, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(size_t, NUM_ITEM_PUSH_BACK, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_007: [If any error occurs, VECTOR_reserve shall fail, leave the vector unchanged and return non-zero.] */
+    TEST_FUNCTION(VECTOR_reserve_fails_if_realloc_fails)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST sItem = { 1, 2 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 10 * sizeof(VECTOR_UNITTEST)))
+            .IgnoreArgument_ptr()
+            .SetReturn(NULL);
+
+        ///act
+        result = VECTOR_reserve(handle, 10);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 1, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(size_t, 1, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_007: [If any error occurs, VECTOR_reserve shall fail, leave the vector unchanged and return non-zero.] */
+    TEST_FUNCTION(VECTOR_reserve_fails_if_the_size_overflows)
+    {
+        ///arrange
+        int result;
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        umock_c_reset_all_calls();
+
+        ///act
+        result = VECTOR_reserve(handle, ((size_t)-1 / sizeof(VECTOR_UNITTEST)) + 1);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 0, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_009: [VECTOR_shrink_to_fit shall fail and return non-zero if `handle` is NULL.] */
+    TEST_FUNCTION(VECTOR_shrink_to_fit_fails_if_handle_is_NULL)
+    {
+        ///arrange
+        int result;
+
+        ///act
+        result = VECTOR_shrink_to_fit(NULL);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_VECTOR_03_010: [If the vector has no unused capacity, VECTOR_shrink_to_fit shall return 0 without allocating memory.] */
+    TEST_FUNCTION(VECTOR_shrink_to_fit_without_unused_capacity_does_not_allocate)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST sItem = { 1, 2 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+
+        ///act
+        result = VECTOR_shrink_to_fit(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 2, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_012: [Otherwise VECTOR_shrink_to_fit shall reallocate the storage to hold exactly the elements of the vector.] */
+    /* Tests_SRS_VECTOR_03_014: [On success VECTOR_shrink_to_fit shall return 0.] */
+    TEST_FUNCTION(VECTOR_shrink_to_fit_succeeds)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST sItem = { 1, 2 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 3 * sizeof(VECTOR_UNITTEST)))
+            .IgnoreArgument_ptr();
+
+        ///act
+        result = VECTOR_shrink_to_fit(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 3, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(size_t, 3, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_011: [If the vector is empty, VECTOR_shrink_to_fit shall release its internal storage and return 0.] */
+    TEST_FUNCTION(VECTOR_shrink_to_fit_of_an_empty_vector_releases_the_storage)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST sItem = { 1, 2 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        VECTOR_erase(handle, VECTOR_front(handle), 1);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument_ptr();
+
+        ///act
+        result = VECTOR_shrink_to_fit(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 0, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_013: [If reallocating fails, VECTOR_shrink_to_fit shall fail, leave the vector unchanged and return non-zero.] */
+    TEST_FUNCTION(VECTOR_shrink_to_fit_fails_if_realloc_fails)
+    {
+        ///arrange
+        int result;
+        VECTOR_UNITTEST sItem = { 1, 2 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, 3 * sizeof(VECTOR_UNITTEST)))
+            .IgnoreArgument_ptr()
+            .SetReturn(NULL);
+
+        ///act
+        result = VECTOR_shrink_to_fit(handle);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 3, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(size_t, 4, VECTOR_capacity(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_017: [VECTOR_erase_unordered shall return if `handle` or `element` is NULL.] */
+    TEST_FUNCTION(VECTOR_erase_unordered_if_handle_is_NULL)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItem = { 1, 2 };
+
+        ///act
+        VECTOR_erase_unordered(NULL, &sItem);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_VECTOR_03_017: [VECTOR_erase_unordered shall return if `handle` or `element` is NULL.] */
+    TEST_FUNCTION(VECTOR_erase_unordered_if_element_is_NULL)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItem = { 1, 2 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+
+        ///act
+        VECTOR_erase_unordered(handle, NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 1, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_018: [VECTOR_erase_unordered shall return if `element` is out of bound.] */
+    TEST_FUNCTION(VECTOR_erase_unordered_element_out_of_bound)
+    {
+        ///arrange
+        VECTOR_UNITTEST* pfindItem;
+        VECTOR_UNITTEST sItem1 = { 1, 2 };
+        VECTOR_UNITTEST sItem2 = { 3, 4 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_reserve(handle, 4);
+        (void)VECTOR_push_back(handle, &sItem1, 1);
+        (void)VECTOR_push_back(handle, &sItem2, 1);
+        pfindItem = (VECTOR_UNITTEST*)VECTOR_back(handle);
+        pfindItem += 1;
+        umock_c_reset_all_calls();
+
+        ///act
+        VECTOR_erase_unordered(handle, pfindItem);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 2, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_019: [VECTOR_erase_unordered shall return if `element` is misaligned.] */
+    TEST_FUNCTION(VECTOR_erase_unordered_element_misaligned)
+    {
+        ///arrange
+        void* pfindItem;
+        VECTOR_UNITTEST sItem1 = { 1, 2 };
+        VECTOR_UNITTEST sItem2 = { 3, 4 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem1, 1);
+        (void)VECTOR_push_back(handle, &sItem2, 1);
+        pfindItem = (void*)(((unsigned char*)VECTOR_front(handle)) + 0x1);
+        umock_c_reset_all_calls();
+
+        ///act
+        VECTOR_erase_unordered(handle, pfindItem);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 2, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_020: [VECTOR_erase_unordered shall remove `element` by moving the last element of the vector in its place, keeping the capacity of the vector.] */
+    TEST_FUNCTION(VECTOR_erase_unordered_moves_the_last_element)
+    {
+        ///arrange
+        VECTOR_UNITTEST* pResult;
+        VECTOR_UNITTEST sItems[3] = { { 1, 2 }, { 3, 4 }, { 5, 6 } };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, sItems, 3);
+        umock_c_reset_all_calls();
+
+        ///act
+        VECTOR_erase_unordered(handle, VECTOR_front(handle));
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 2, VECTOR_size(handle));
+        ASSERT_ARE_EQUAL(size_t, 3, VECTOR_capacity(handle));
+        pResult = (VECTOR_UNITTEST*)VECTOR_element(handle, 0);
+        ASSERT_ARE_EQUAL(int, sItems[2].nValue1, pResult->nValue1);
+        pResult = (VECTOR_UNITTEST*)VECTOR_element(handle, 1);
+        ASSERT_ARE_EQUAL(int, sItems[1].nValue1, pResult->nValue1);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_020: [VECTOR_erase_unordered shall remove `element` by moving the last element of the vector in its place, keeping the capacity of the vector.] */
+    TEST_FUNCTION(VECTOR_erase_unordered_the_last_element)
+    {
+        ///arrange
+        VECTOR_UNITTEST* pResult;
+        VECTOR_UNITTEST sItems[2] = { { 1, 2 }, { 3, 4 } };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, sItems, 2);
+        umock_c_reset_all_calls();
+
+        ///act
+        VECTOR_erase_unordered(handle, VECTOR_back(handle));
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 1, VECTOR_size(handle));
+        pResult = (VECTOR_UNITTEST*)VECTOR_back(handle);
+        ASSERT_ARE_EQUAL(int, sItems[0].nValue1, pResult->nValue1);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_021: [VECTOR_sort shall return if `handle` or `compare` is NULL.] */
+    TEST_FUNCTION(VECTOR_sort_if_handle_is_NULL)
+    {
+        ///arrange
+
+        ///act
+        VECTOR_sort(NULL, VECTOR_UNITTEST_compare);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_VECTOR_03_021: [VECTOR_sort shall return if `handle` or `compare` is NULL.] */
+    TEST_FUNCTION(VECTOR_sort_if_compare_is_NULL)
+    {
+        ///arrange
+        VECTOR_UNITTEST* pResult;
+        VECTOR_UNITTEST sItems[2] = { { 3, 4 }, { 1, 2 } };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, sItems, 2);
+        umock_c_reset_all_calls();
+
+        ///act
+        VECTOR_sort(handle, NULL);
+
+        ///assert
+        pResult = (VECTOR_UNITTEST*)VECTOR_front(handle);
+        ASSERT_ARE_EQUAL(int, 3, pResult->nValue1);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_022: [VECTOR_sort shall sort the elements of the vector in ascending order according to `compare`.] */
+    TEST_FUNCTION(VECTOR_sort_succeeds)
+    {
+        ///arrange
+        size_t nIndex;
+        VECTOR_UNITTEST sItems[5] = { { 5, 0 }, { 1, 0 }, { 4, 0 }, { 2, 0 }, { 3, 0 } };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, sItems, 5);
+        umock_c_reset_all_calls();
+
+        ///act
+        VECTOR_sort(handle, VECTOR_UNITTEST_compare);
+
+        ///assert
+        for (nIndex = 0; nIndex < 5; nIndex++)
+        {
+            VECTOR_UNITTEST* pResult = (VECTOR_UNITTEST*)VECTOR_element(handle, nIndex);
+            ASSERT_ARE_EQUAL(int, (int)nIndex + 1, pResult->nValue1);
+        }
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_023: [VECTOR_lower_bound shall fail and return NULL if `handle`, `compare` or `value` is NULL.] */
+    TEST_FUNCTION(VECTOR_lower_bound_fails_if_handle_is_NULL)
+    {
+        ///arrange
+        void* pResult;
+        VECTOR_UNITTEST sItem = { 1, 2 };
+
+        ///act
+        pResult = VECTOR_lower_bound(NULL, VECTOR_UNITTEST_compare, &sItem);
+
+        ///assert
+        ASSERT_IS_NULL(pResult);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_VECTOR_03_023: [VECTOR_lower_bound shall fail and return NULL if `handle`, `compare` or `value` is NULL.] */
+    TEST_FUNCTION(VECTOR_lower_bound_fails_if_compare_is_NULL)
+    {
+        ///arrange
+        void* pResult;
+        VECTOR_UNITTEST sItem = { 1, 2 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+
+        ///act
+        pResult = VECTOR_lower_bound(handle, NULL, &sItem);
+
+        ///assert
+        ASSERT_IS_NULL(pResult);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_023: [VECTOR_lower_bound shall fail and return NULL if `handle`, `compare` or `value` is NULL.] */
+    TEST_FUNCTION(VECTOR_lower_bound_fails_if_value_is_NULL)
+    {
+        ///arrange
+        void* pResult;
+        VECTOR_UNITTEST sItem = { 1, 2 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, &sItem, 1);
+        umock_c_reset_all_calls();
+
+        ///act
+        pResult = VECTOR_lower_bound(handle, VECTOR_UNITTEST_compare, NULL);
+
+        ///assert
+        ASSERT_IS_NULL(pResult);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_024: [VECTOR_lower_bound shall return, with a binary search of the vector sorted by `compare`, the first element that does not compare less than `value`.] */
+    TEST_FUNCTION(VECTOR_lower_bound_returns_the_matching_element)
+    {
+        ///arrange
+        VECTOR_UNITTEST* pResult;
+        VECTOR_UNITTEST sItems[5] = { { 1, 0 }, { 3, 0 }, { 3, 1 }, { 5, 0 }, { 7, 0 } };
+        VECTOR_UNITTEST sValue = { 3, 0 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, sItems, 5);
+        umock_c_reset_all_calls();
+
+        ///act
+        pResult = (VECTOR_UNITTEST*)VECTOR_lower_bound(handle, VECTOR_UNITTEST_compare, &sValue);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, VECTOR_element(handle, 1), pResult);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_024: [VECTOR_lower_bound shall return, with a binary search of the vector sorted by `compare`, the first element that does not compare less than `value`.] */
+    TEST_FUNCTION(VECTOR_lower_bound_returns_the_next_greater_element)
+    {
+        ///arrange
+        VECTOR_UNITTEST* pResult;
+        VECTOR_UNITTEST sItems[5] = { { 1, 0 }, { 3, 0 }, { 3, 1 }, { 5, 0 }, { 7, 0 } };
+        VECTOR_UNITTEST sValue = { 4, 0 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, sItems, 5);
+        umock_c_reset_all_calls();
+
+        ///act
+        pResult = (VECTOR_UNITTEST*)VECTOR_lower_bound(handle, VECTOR_UNITTEST_compare, &sValue);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(pResult);
+        ASSERT_ARE_EQUAL(int, 5, pResult->nValue1);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
+    /* Tests_SRS_VECTOR_03_025: [VECTOR_lower_bound shall return NULL if all the elements compare less than `value`.] */
+    TEST_FUNCTION(VECTOR_lower_bound_returns_NULL_if_all_elements_are_less)
+    {
+        ///arrange
+        void* pResult;
+        VECTOR_UNITTEST sItems[3] = { { 1, 0 }, { 3, 0 }, { 5, 0 } };
+        VECTOR_UNITTEST sValue = { 6, 0 };
+        VECTOR_HANDLE handle = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        (void)VECTOR_push_back(handle, sItems, 3);
+        umock_c_reset_all_calls();
+
+        ///act
+        pResult = VECTOR_lower_bound(handle, VECTOR_UNITTEST_compare, &sValue);
+
+        ///assert
+        ASSERT_IS_NULL(pResult);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        VECTOR_destroy(handle);
+    }
+
     /* Vector_Tests END */
 
 END_TEST_SUITE(Vector_UnitTests)
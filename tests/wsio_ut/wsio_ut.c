@@ -21,6 +21,7 @@
 #include "azure_c_shared_utility/xio.h"
 #include "azure_c_shared_utility/crt_abstractions.h"
 #include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/slab.h"
 #include "azure_c_shared_utility/optionhandler.h"
 #include "azure_c_shared_utility/uws_client.h"
 
@@ -33,6 +34,8 @@ static const char* TEST_PROTOCOL = "test_proto";
 static const SINGLYLINKEDLIST_HANDLE TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE = (SINGLYLINKEDLIST_HANDLE)0x4242;
 static const LIST_ITEM_HANDLE TEST_LIST_ITEM_HANDLE = (LIST_ITEM_HANDLE)0x11;
 static const UWS_CLIENT_HANDLE TEST_UWS_HANDLE = (UWS_CLIENT_HANDLE)0x4243;
+static const SLAB_HANDLE TEST_SLAB_HANDLE = (SLAB_HANDLE)0x4244;
+static const ARENA_HANDLE TEST_ARENA = (ARENA_HANDLE)0x4250;
 static const XIO_HANDLE TEST_UNDERLYING_IO_HANDLE = (XIO_HANDLE)0x4244;
 static const OPTIONHANDLER_HANDLE TEST_OPTIONHANDLER_HANDLE = (OPTIONHANDLER_HANDLE)0x4246;
 static const OPTIONHANDLER_HANDLE TEST_UWS_CLIENT_OPTIONHANDLER_HANDLE = (OPTIONHANDLER_HANDLE)0x4247;
@@ -169,6 +172,19 @@ static OPTIONHANDLER_HANDLE my_OptionHandler_Create(pfCloneOption cloneOption, p
     return TEST_OPTIONHANDLER_HANDLE;
 }
 
+/* the slab is mocked, pending IO entries are plain heap allocations so that leaks still show */
+static void* my_slab_malloc(SLAB_HANDLE slab)
+{
+    (void)slab;
+    return my_gballoc_malloc(64);
+}
+
+static void my_slab_free(SLAB_HANDLE slab, void* ptr)
+{
+    (void)slab;
+    my_gballoc_free(ptr);
+}
+
 #include "azure_c_shared_utility/gballoc.h"
 
 #undef ENABLE_MOCKS
@@ -276,6 +292,9 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
     REGISTER_GLOBAL_MOCK_RETURN(singlylinkedlist_create, TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE);
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_remove, my_singlylinkedlist_remove);
+    REGISTER_GLOBAL_MOCK_RETURN(slab_create, TEST_SLAB_HANDLE);
+    REGISTER_GLOBAL_MOCK_HOOK(slab_malloc, my_slab_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(slab_free, my_slab_free);
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_get_head_item, my_singlylinkedlist_get_head_item);
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_add, my_singlylinkedlist_add);
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_item_get_value, my_singlylinkedlist_item_get_value);
@@ -289,6 +308,7 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GLOBAL_MOCK_RETURN(OptionHandler_AddOption, OPTIONHANDLER_OK);
     REGISTER_GLOBAL_MOCK_RETURN(OptionHandler_Clone, TEST_OPTIONHANDLER_HANDLE);
     REGISTER_GLOBAL_MOCK_RETURN(uws_client_create_with_io, TEST_UWS_HANDLE);
+    REGISTER_GLOBAL_MOCK_RETURN(uws_client_create_with_io_and_arena, TEST_UWS_HANDLE);
     REGISTER_GLOBAL_MOCK_RETURN(uws_client_retrieve_options, TEST_UWS_CLIENT_OPTIONHANDLER_HANDLE);
     
     REGISTER_TYPE(IO_OPEN_RESULT, IO_OPEN_RESULT);
@@ -297,8 +317,10 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     REGISTER_UMOCK_ALIAS_TYPE(SINGLYLINKEDLIST_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(LIST_ITEM_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(SLAB_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(XIO_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(UWS_CLIENT_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(ARENA_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_WS_OPEN_COMPLETE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_WS_FRAME_RECEIVED, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_WS_ERROR, void*);
@@ -351,6 +373,7 @@ TEST_FUNCTION_CLEANUP(method_cleanup)
 /* Tests_SRS_WSIO_01_128: [ - `resource_name` set to the `resource_name` field in the `io_create_parameters` passed to `wsio_create`. ]*/
 /* Tests_SRS_WSIO_01_129: [ - `protocols` shall be filled with only one structure, that shall have the `protocol` set to the value of the `protocol` field in the `io_create_parameters` passed to `wsio_create`. ]*/
 /* Tests_SRS_WSIO_01_076: [ `wsio_create` shall create a pending send IO list that is to be used to queue send packets by calling `singlylinkedlist_create`. ]*/
+/* Tests_SRS_WSIO_03_002: [ `wsio_create` shall create a slab for the pending send IO entries by calling `slab_create`. ]*/
 TEST_FUNCTION(wsio_create_for_secure_connection_with_valid_args_succeeds)
 {
     // arrange
@@ -359,6 +382,7 @@ TEST_FUNCTION(wsio_create_for_secure_connection_with_valid_args_succeeds)
     EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(uws_client_create_with_io(TEST_UNDERLYING_IO_INTERFACE, TEST_UNDERLYING_IO_PARAMETERS, TEST_HOST_ADDRESS, 443, TEST_RESOURCE_NAME, IGNORED_PTR_ARG, 1));
     STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
 
     // act
     wsio = wsio_get_interface_description()->concrete_io_create(&default_wsio_config);
@@ -371,6 +395,51 @@ TEST_FUNCTION(wsio_create_for_secure_connection_with_valid_args_succeeds)
     wsio_get_interface_description()->concrete_io_destroy(wsio);
 }
 
+/* Tests_SRS_WSIO_03_004: [ `wsio_create_with_arena` shall create the wsio instance like `wsio_create`. ]*/
+/* Tests_SRS_WSIO_03_001: [ If `arena` is not NULL, `wsio_create_with_arena` shall create the underlying uws instance by calling `uws_client_create_with_io_and_arena` with `arena` and the same arguments. ]*/
+TEST_FUNCTION(wsio_create_with_arena_creates_the_uws_instance_in_the_arena)
+{
+    // arrange
+    CONCRETE_IO_HANDLE wsio;
+
+    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(uws_client_create_with_io_and_arena(TEST_ARENA, TEST_UNDERLYING_IO_INTERFACE, TEST_UNDERLYING_IO_PARAMETERS, TEST_HOST_ADDRESS, 443, TEST_RESOURCE_NAME, IGNORED_PTR_ARG, 1));
+    STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
+
+    // act
+    wsio = wsio_get_interface_description()->concrete_io_create_with_arena(&default_wsio_config, TEST_ARENA);
+
+    // assert
+    ASSERT_IS_NOT_NULL(wsio);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    wsio_get_interface_description()->concrete_io_destroy(wsio);
+}
+
+/* Tests_SRS_WSIO_03_004: [ `wsio_create_with_arena` shall create the wsio instance like `wsio_create`. ]*/
+TEST_FUNCTION(wsio_create_with_arena_with_NULL_arena_creates_the_uws_instance_on_the_heap)
+{
+    // arrange
+    CONCRETE_IO_HANDLE wsio;
+
+    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(uws_client_create_with_io(TEST_UNDERLYING_IO_INTERFACE, TEST_UNDERLYING_IO_PARAMETERS, TEST_HOST_ADDRESS, 443, TEST_RESOURCE_NAME, IGNORED_PTR_ARG, 1));
+    STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
+
+    // act
+    wsio = wsio_get_interface_description()->concrete_io_create_with_arena(&default_wsio_config, NULL);
+
+    // assert
+    ASSERT_IS_NOT_NULL(wsio);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    wsio_get_interface_description()->concrete_io_destroy(wsio);
+}
+
 /* Tests_SRS_WSIO_01_065: [ If the argument `io_create_parameters` is NULL then `wsio_create` shall return NULL. ]*/
 TEST_FUNCTION(wsio_create_with_NULL_create_arguments_fails)
 {
@@ -528,6 +597,7 @@ TEST_FUNCTION(wsio_create_for_secure_connection_with_valid_args_succeeds_2)
     EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(uws_client_create_with_io(TEST_UNDERLYING_IO_INTERFACE, NULL, "another.com", 80, "haga", IGNORED_PTR_ARG, 1));
     STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
 
     // act
     wsio = wsio_get_interface_description()->concrete_io_create(&wsio_config);
@@ -540,11 +610,35 @@ TEST_FUNCTION(wsio_create_for_secure_connection_with_valid_args_succeeds_2)
     wsio_get_interface_description()->concrete_io_destroy(wsio);
 }
 
+/* Tests_SRS_WSIO_03_003: [ If `slab_create` fails then `wsio_create` shall fail and return NULL. ]*/
+TEST_FUNCTION(when_slab_create_fails_then_wsio_create_fails)
+{
+    // arrange
+    CONCRETE_IO_HANDLE wsio;
+
+    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(uws_client_create_with_io(TEST_UNDERLYING_IO_INTERFACE, TEST_UNDERLYING_IO_PARAMETERS, TEST_HOST_ADDRESS, 443, TEST_RESOURCE_NAME, IGNORED_PTR_ARG, 1));
+    STRICT_EXPECTED_CALL(singlylinkedlist_create());
+    STRICT_EXPECTED_CALL(slab_create(IGNORED_NUM_ARG, IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
+    STRICT_EXPECTED_CALL(uws_client_destroy(TEST_UWS_HANDLE));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    wsio = wsio_get_interface_description()->concrete_io_create(&default_wsio_config);
+
+    // assert
+    ASSERT_IS_NULL(wsio);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 /* wsio_destroy */
 
 /* Tests_SRS_WSIO_01_078: [ `wsio_destroy` shall free all resources associated with the wsio instance. ]*/
 /* Tests_SRS_WSIO_01_080: [ `wsio_destroy` shall destroy the uws instance created in `wsio_create` by calling `uws_client_destroy`. ]*/
 /* Tests_SRS_WSIO_01_081: [ `wsio_destroy` shall free the list used to track the pending send IOs by calling `singlylinkedlist_destroy`. ]*/
+/* Tests_SRS_WSIO_03_005: [ `wsio_destroy` shall destroy the pending IO slab by calling `slab_destroy`. ]*/
 TEST_FUNCTION(wsio_destroy_frees_all_resources)
 {
     // arrange
@@ -554,6 +648,7 @@ TEST_FUNCTION(wsio_destroy_frees_all_resources)
 
     STRICT_EXPECTED_CALL(uws_client_destroy(TEST_UWS_HANDLE));
     STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
+    STRICT_EXPECTED_CALL(slab_destroy(TEST_SLAB_HANDLE));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 
     // act
@@ -948,8 +1043,8 @@ TEST_FUNCTION(wsio_close_indicates_a_pending_send_as_CANCELLED)
     STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
     EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4343, IO_SEND_CANCELLED));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
 
     // act
@@ -982,13 +1077,13 @@ TEST_FUNCTION(wsio_close_indicates_2_pending_sends_as_CANCELLED)
     STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
     EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4343, IO_SEND_CANCELLED));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
     EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4343, IO_SEND_CANCELLED));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE));
 
     // act
@@ -1010,6 +1105,7 @@ TEST_FUNCTION(wsio_close_indicates_2_pending_sends_as_CANCELLED)
 /* Tests_SRS_WSIO_01_102: [ An entry shall be queued in the singly linked list by calling `singlylinkedlist_add`. ]*/
 /* Tests_SRS_WSIO_01_103: [ The entry shall contain the `on_send_complete` callback and its context. ]*/
 /* Tests_SRS_WSIO_01_096: [ The frame type used shall be `WS_FRAME_TYPE_BINARY`. ]*/
+/* Tests_SRS_WSIO_03_006: [ The memory for the pending IO data shall be obtained from the pending IO slab by calling `slab_malloc`. ]*/
 TEST_FUNCTION(wsio_send_with_1_byte_calls_uws_send_frame)
 {
     // arrange
@@ -1022,7 +1118,7 @@ TEST_FUNCTION(wsio_send_with_1_byte_calls_uws_send_frame)
     g_on_ws_open_complete(g_on_ws_open_complete_context, WS_OPEN_OK);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(slab_malloc(TEST_SLAB_HANDLE));
     STRICT_EXPECTED_CALL(singlylinkedlist_add(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(uws_client_send_frame_async(TEST_UWS_HANDLE, WS_FRAME_TYPE_BINARY, IGNORED_PTR_ARG, sizeof(test_buffer), true, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
         .ValidateArgumentBuffer(3, test_buffer, sizeof(test_buffer));
@@ -1185,7 +1281,7 @@ TEST_FUNCTION(when_allocating_memory_for_the_pending_send_fails_wsio_send_fails)
     g_on_ws_open_complete(g_on_ws_open_complete_context, WS_OPEN_OK);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+    STRICT_EXPECTED_CALL(slab_malloc(TEST_SLAB_HANDLE))
         .SetReturn(NULL);
 
     // act
@@ -1212,10 +1308,10 @@ TEST_FUNCTION(when_adding_the_pending_item_to_the_list_fails_wsio_send_fails)
     g_on_ws_open_complete(g_on_ws_open_complete_context, WS_OPEN_OK);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(slab_malloc(TEST_SLAB_HANDLE));
     STRICT_EXPECTED_CALL(singlylinkedlist_add(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG))
         .SetReturn(NULL);
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
 
     // act
     result = wsio_get_interface_description()->concrete_io_send(wsio, test_buffer, sizeof(test_buffer), test_on_send_complete, (void*)0x4343);
@@ -1241,7 +1337,7 @@ TEST_FUNCTION(wsio_send_with_NULL_send_complete_callback_succeeds)
     g_on_ws_open_complete(g_on_ws_open_complete_context, WS_OPEN_OK);
     umock_c_reset_all_calls();
 
-    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(slab_malloc(TEST_SLAB_HANDLE));
     STRICT_EXPECTED_CALL(singlylinkedlist_add(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(uws_client_send_frame_async(TEST_UWS_HANDLE, WS_FRAME_TYPE_BINARY, IGNORED_PTR_ARG, sizeof(test_buffer), true, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
         .ValidateArgumentBuffer(3, test_buffer, sizeof(test_buffer));
@@ -1804,6 +1900,7 @@ TEST_FUNCTION(when_on_underlying_ws_frame_received_is_called_with_positive_size_
 /* Tests_SRS_WSIO_01_143: [ When `on_underlying_ws_send_frame_complete` is called after sending a WebSocket frame, the pending IO shall be removed from the list. ]*/
 /* Tests_SRS_WSIO_01_145: [ Removing it from the list shall be done by calling `singlylinkedlist_remove`. ]*/
 /* Tests_SRS_WSIO_01_144: [ Also the pending IO data shall be freed. ]*/
+/* Tests_SRS_WSIO_03_004: [ The pending IO data shall be returned to the pending IO slab by calling `slab_free` before the `on_send_complete` callback is called, as the callback may destroy the wsio instance. ]*/
 /* Tests_SRS_WSIO_01_146: [ When `on_underlying_ws_send_frame_complete` is called with `WS_SEND_OK`, the callback `on_send_complete` shall be called with `IO_SEND_OK`. ]*/
 TEST_FUNCTION(wsio_send_with_1_byte_completed_indicates_the_completion_up)
 {
@@ -1819,8 +1916,8 @@ TEST_FUNCTION(wsio_send_with_1_byte_completed_indicates_the_completion_up)
 
     EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4343, IO_SEND_OK));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 
     // act
     g_on_ws_send_frame_complete(g_on_ws_send_frame_complete_context, WS_SEND_FRAME_OK);
@@ -1847,8 +1944,8 @@ TEST_FUNCTION(wsio_send_with_1_byte_completed_with_CANCELLED_indicates_the_compl
 
     EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4343, IO_SEND_CANCELLED));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 
     // act
     g_on_ws_send_frame_complete(g_on_ws_send_frame_complete_context, WS_SEND_FRAME_CANCELLED);
@@ -1875,8 +1972,8 @@ TEST_FUNCTION(wsio_send_with_1_byte_completed_with_ERROR_indicates_the_completio
 
     EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_SINGLYLINKEDSINGLYLINKEDLIST_HANDLE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(slab_free(TEST_SLAB_HANDLE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4343, IO_SEND_ERROR));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 
     // act
     g_on_ws_send_frame_complete(g_on_ws_send_frame_complete_context, WS_SEND_FRAME_ERROR);
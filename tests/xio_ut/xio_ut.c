@@ -41,6 +41,8 @@ static CONCRETE_IO_HANDLE TEST_CONCRETE_IO_HANDLE = (CONCRETE_IO_HANDLE)0x4242;
 #define ENABLE_MOCKS
 MOCK_FUNCTION_WITH_CODE(, CONCRETE_IO_HANDLE, test_xio_create, void*, xio_create_parameters)
 MOCK_FUNCTION_END(TEST_CONCRETE_IO_HANDLE)
+MOCK_FUNCTION_WITH_CODE(, CONCRETE_IO_HANDLE, test_xio_create_with_arena, void*, xio_create_parameters, ARENA_HANDLE, arena)
+MOCK_FUNCTION_END(TEST_CONCRETE_IO_HANDLE)
 MOCK_FUNCTION_WITH_CODE(, void, test_xio_destroy, CONCRETE_IO_HANDLE, handle)
 MOCK_FUNCTION_END()
 MOCK_FUNCTION_WITH_CODE(, int, test_xio_open, CONCRETE_IO_HANDLE, handle, ON_IO_OPEN_COMPLETE, on_io_open_complete, void*, on_io_open_complete_context, ON_BYTES_RECEIVED, on_bytes_received, void*, on_bytes_received_context, ON_IO_ERROR, on_io_error, void*, on_io_error_context)
@@ -49,6 +51,8 @@ MOCK_FUNCTION_WITH_CODE(, int, test_xio_close, CONCRETE_IO_HANDLE, handle, ON_IO
 MOCK_FUNCTION_END(0)
 MOCK_FUNCTION_WITH_CODE(, int, test_xio_send, CONCRETE_IO_HANDLE, handle, const void*, buffer, size_t, size, ON_SEND_COMPLETE, on_send_complete, void*, callback_context)
 MOCK_FUNCTION_END(0)
+MOCK_FUNCTION_WITH_CODE(, int, test_xio_sendv, CONCRETE_IO_HANDLE, handle, const CONSTBUFFER*, buffers, size_t, buffer_count, ON_SEND_COMPLETE, on_send_complete, void*, callback_context)
+MOCK_FUNCTION_END(0)
 MOCK_FUNCTION_WITH_CODE(, void, test_xio_dowork, CONCRETE_IO_HANDLE, handle)
 MOCK_FUNCTION_END()
 MOCK_FUNCTION_WITH_CODE(, int, test_xio_setoption, CONCRETE_IO_HANDLE, handle, const char*, optionName, const void*, value)
@@ -113,6 +117,35 @@ const IO_INTERFACE_DESCRIPTION test_io_description =
     test_xio_setoption
 };
 
+const IO_INTERFACE_DESCRIPTION test_io_description_with_sendv =
+{
+    test_xio_retrieveoptions,
+    test_xio_create,
+    test_xio_destroy,
+    test_xio_open,
+    test_xio_close,
+    test_xio_send,
+    test_xio_dowork,
+    test_xio_setoption,
+    NULL,
+    test_xio_sendv
+};
+
+const IO_INTERFACE_DESCRIPTION test_io_description_with_arena =
+{
+    test_xio_retrieveoptions,
+    test_xio_create,
+    test_xio_destroy,
+    test_xio_open,
+    test_xio_close,
+    test_xio_send,
+    test_xio_dowork,
+    test_xio_setoption,
+    test_xio_create_with_arena
+};
+
+#define TEST_ARENA ((ARENA_HANDLE)0x4244)
+
 static TEST_MUTEX_HANDLE g_testByTest;
 static TEST_MUTEX_HANDLE g_dllByDll;
 
@@ -168,12 +201,14 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     REGISTER_UMOCK_ALIAS_TYPE(CONCRETE_IO_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(XIO_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(ARENA_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(LOGGER_LOG, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_SEND_COMPLETE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_IO_CLOSE_COMPLETE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_IO_OPEN_COMPLETE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_BYTES_RECEIVED, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_IO_ERROR, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(const CONSTBUFFER*, void*);
 
     REGISTER_UMOCK_ALIAS_TYPE(pfCloneOption, void*);
     REGISTER_UMOCK_ALIAS_TYPE(pfDestroyOption, void*);
@@ -277,6 +312,97 @@ TEST_FUNCTION(when_concrete_xio_create_fails_then_xio_create_fails)
     ASSERT_IS_NULL(result);
 }
 
+/* xio_create_with_arena */
+
+/* Tests_SRS_XIO_03_038: [ xio_create_with_arena shall behave like xio_create. ]*/
+/* Tests_SRS_XIO_03_039: [ If arena is not NULL and the io_interface_description has a concrete_io_create_with_arena function, xio_create_with_arena shall call it passing the xio_create_parameters and arena arguments. ]*/
+TEST_FUNCTION(xio_create_with_arena_creates_the_concrete_io_in_the_arena)
+{
+    // arrange
+    XIO_HANDLE result;
+    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(test_xio_create_with_arena((void*)0x4243, TEST_ARENA));
+
+    // act
+    result = xio_create_with_arena(&test_io_description_with_arena, (void*)0x4243, TEST_ARENA);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    xio_destroy(result);
+}
+
+/* Tests_SRS_XIO_03_040: [ Otherwise xio_create_with_arena shall call concrete_io_create like xio_create, the IO is then allocated on the heap. ]*/
+TEST_FUNCTION(xio_create_with_arena_with_a_NULL_arena_calls_concrete_io_create)
+{
+    // arrange
+    XIO_HANDLE result;
+    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(test_xio_create((void*)0x4243));
+
+    // act
+    result = xio_create_with_arena(&test_io_description_with_arena, (void*)0x4243, NULL);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    xio_destroy(result);
+}
+
+/* Tests_SRS_XIO_03_040: [ Otherwise xio_create_with_arena shall call concrete_io_create like xio_create, the IO is then allocated on the heap. ]*/
+TEST_FUNCTION(xio_create_with_arena_for_a_concrete_io_without_arena_support_calls_concrete_io_create)
+{
+    // arrange
+    XIO_HANDLE result;
+    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(test_xio_create((void*)0x4243));
+
+    // act
+    result = xio_create_with_arena(&test_io_description, (void*)0x4243, TEST_ARENA);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    xio_destroy(result);
+}
+
+/* Tests_SRS_XIO_03_038: [ xio_create_with_arena shall behave like xio_create. ]*/
+TEST_FUNCTION(when_concrete_io_create_with_arena_fails_then_xio_create_with_arena_fails)
+{
+    // arrange
+    XIO_HANDLE result;
+    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(test_xio_create_with_arena(NULL, TEST_ARENA))
+        .SetReturn((CONCRETE_IO_HANDLE)NULL);
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    result = xio_create_with_arena(&test_io_description_with_arena, NULL, TEST_ARENA);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_XIO_03_038: [ xio_create_with_arena shall behave like xio_create. ]*/
+TEST_FUNCTION(when_io_interface_description_is_NULL_then_xio_create_with_arena_fails)
+{
+    // arrange
+
+    // act
+    XIO_HANDLE result = xio_create_with_arena(NULL, NULL, TEST_ARENA);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
 /* Tests_SRS_XIO_01_003: [If the argument io_interface_description is NULL, xio_create shall return NULL.] */
 TEST_FUNCTION(when_io_interface_description_is_NULL_then_xio_create_fails)
 {
@@ -777,6 +903,242 @@ TEST_FUNCTION(xio_send_with_non_NULL_buffer_and_zero_length_passes_the_args_down
     xio_destroy(handle);
 }
 
+/* xio_sendv */
+
+/* Tests_SRS_XIO_03_032: [ If xio or buffers is NULL or buffer_count is 0, xio_sendv shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(xio_sendv_with_NULL_handle_fails)
+{
+    // arrange
+    int result;
+    unsigned char send_data[] = { 0x42, 43 };
+    CONSTBUFFER buffers[1];
+    buffers[0].buffer = send_data;
+    buffers[0].size = sizeof(send_data);
+    umock_c_reset_all_calls();
+
+    // act
+    result = xio_sendv(NULL, buffers, 1, test_on_send_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_XIO_03_032: [ If xio or buffers is NULL or buffer_count is 0, xio_sendv shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(xio_sendv_with_NULL_buffers_fails)
+{
+    // arrange
+    int result;
+    XIO_HANDLE handle = xio_create(&test_io_description_with_sendv, NULL);
+    umock_c_reset_all_calls();
+
+    // act
+    result = xio_sendv(handle, NULL, 1, test_on_send_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    xio_destroy(handle);
+}
+
+/* Tests_SRS_XIO_03_032: [ If xio or buffers is NULL or buffer_count is 0, xio_sendv shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(xio_sendv_with_zero_buffer_count_fails)
+{
+    // arrange
+    int result;
+    unsigned char send_data[] = { 0x42, 43 };
+    CONSTBUFFER buffers[1];
+    XIO_HANDLE handle = xio_create(&test_io_description_with_sendv, NULL);
+    buffers[0].buffer = send_data;
+    buffers[0].size = sizeof(send_data);
+    umock_c_reset_all_calls();
+
+    // act
+    result = xio_sendv(handle, buffers, 0, test_on_send_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    xio_destroy(handle);
+}
+
+/* Tests_SRS_XIO_03_033: [ If the concrete IO implementation has a concrete_io_sendv function, xio_sendv shall call it passing down buffers, buffer_count, on_send_complete and callback_context. ]*/
+TEST_FUNCTION(xio_sendv_calls_the_underlying_concrete_io_sendv_and_succeeds)
+{
+    // arrange
+    int result;
+    unsigned char send_data_1[] = { 0x42, 43 };
+    unsigned char send_data_2[] = { 0x44 };
+    CONSTBUFFER buffers[2];
+    XIO_HANDLE handle = xio_create(&test_io_description_with_sendv, NULL);
+    buffers[0].buffer = send_data_1;
+    buffers[0].size = sizeof(send_data_1);
+    buffers[1].buffer = send_data_2;
+    buffers[1].size = sizeof(send_data_2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_xio_sendv(TEST_CONCRETE_IO_HANDLE, buffers, 2, test_on_send_complete, (void*)0x4242));
+
+    // act
+    result = xio_sendv(handle, buffers, 2, test_on_send_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    xio_destroy(handle);
+}
+
+/* Tests_SRS_XIO_03_037: [ If the underlying send fails, xio_sendv shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_the_concrete_io_sendv_fails_then_xio_sendv_fails)
+{
+    // arrange
+    int result;
+    unsigned char send_data[] = { 0x42, 43 };
+    CONSTBUFFER buffers[1];
+    XIO_HANDLE handle = xio_create(&test_io_description_with_sendv, NULL);
+    buffers[0].buffer = send_data;
+    buffers[0].size = sizeof(send_data);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_xio_sendv(TEST_CONCRETE_IO_HANDLE, buffers, 1, test_on_send_complete, (void*)0x4242))
+        .SetReturn(42);
+
+    // act
+    result = xio_sendv(handle, buffers, 1, test_on_send_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    xio_destroy(handle);
+}
+
+/* Tests_SRS_XIO_03_034: [ Otherwise, if buffer_count is 1, xio_sendv shall call concrete_io_send with the buffer, on_send_complete and callback_context. ]*/
+TEST_FUNCTION(xio_sendv_with_one_buffer_calls_the_underlying_concrete_io_send)
+{
+    // arrange
+    int result;
+    unsigned char send_data[] = { 0x42, 43 };
+    CONSTBUFFER buffers[1];
+    XIO_HANDLE handle = xio_create(&test_io_description, NULL);
+    buffers[0].buffer = send_data;
+    buffers[0].size = sizeof(send_data);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_xio_send(TEST_CONCRETE_IO_HANDLE, send_data, sizeof(send_data), test_on_send_complete, (void*)0x4242));
+
+    // act
+    result = xio_sendv(handle, buffers, 1, test_on_send_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    xio_destroy(handle);
+}
+
+/* Tests_SRS_XIO_03_035: [ Otherwise xio_sendv shall copy the buffers in order into one allocation, call concrete_io_send with it, on_send_complete and callback_context, and free it. ]*/
+TEST_FUNCTION(xio_sendv_with_several_buffers_gathers_them_and_calls_the_underlying_concrete_io_send)
+{
+    // arrange
+    int result;
+    unsigned char send_data_1[] = { 0x42, 43 };
+    unsigned char send_data_2[] = { 0x44 };
+    unsigned char expected_data[] = { 0x42, 43, 0x44 };
+    CONSTBUFFER buffers[3];
+    XIO_HANDLE handle = xio_create(&test_io_description, NULL);
+    buffers[0].buffer = send_data_1;
+    buffers[0].size = sizeof(send_data_1);
+    buffers[1].buffer = NULL;
+    buffers[1].size = 0;
+    buffers[2].buffer = send_data_2;
+    buffers[2].size = sizeof(send_data_2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(expected_data)));
+    STRICT_EXPECTED_CALL(test_xio_send(TEST_CONCRETE_IO_HANDLE, IGNORED_PTR_ARG, sizeof(expected_data), test_on_send_complete, (void*)0x4242))
+        .ValidateArgumentBuffer(2, expected_data, sizeof(expected_data));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    result = xio_sendv(handle, buffers, 3, test_on_send_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    xio_destroy(handle);
+}
+
+/* Tests_SRS_XIO_03_036: [ If any error occurs, xio_sendv shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_gathering_the_buffers_fails_then_xio_sendv_fails)
+{
+    // arrange
+    int result;
+    unsigned char send_data_1[] = { 0x42, 43 };
+    unsigned char send_data_2[] = { 0x44 };
+    CONSTBUFFER buffers[2];
+    XIO_HANDLE handle = xio_create(&test_io_description, NULL);
+    buffers[0].buffer = send_data_1;
+    buffers[0].size = sizeof(send_data_1);
+    buffers[1].buffer = send_data_2;
+    buffers[1].size = sizeof(send_data_2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(3))
+        .SetReturn(NULL);
+
+    // act
+    result = xio_sendv(handle, buffers, 2, test_on_send_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    xio_destroy(handle);
+}
+
+/* Tests_SRS_XIO_03_037: [ If the underlying send fails, xio_sendv shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_the_concrete_io_send_of_the_gathered_buffers_fails_then_xio_sendv_fails)
+{
+    // arrange
+    int result;
+    unsigned char send_data_1[] = { 0x42, 43 };
+    unsigned char send_data_2[] = { 0x44 };
+    CONSTBUFFER buffers[2];
+    XIO_HANDLE handle = xio_create(&test_io_description, NULL);
+    buffers[0].buffer = send_data_1;
+    buffers[0].size = sizeof(send_data_1);
+    buffers[1].buffer = send_data_2;
+    buffers[1].size = sizeof(send_data_2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(3));
+    STRICT_EXPECTED_CALL(test_xio_send(TEST_CONCRETE_IO_HANDLE, IGNORED_PTR_ARG, 3, test_on_send_complete, (void*)0x4242))
+        .SetReturn(42);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    result = xio_sendv(handle, buffers, 2, test_on_send_complete, (void*)0x4242);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    xio_destroy(handle);
+}
+
 /* xio_dowork */
 
 /* Tests_SRS_XIO_01_012: [xio_dowork shall call the concrete IO implementation specified in xio_create, by calling the concrete_xio_dowork function.] */
@@ -902,15 +1264,15 @@ TEST_FUNCTION(xio_setoption_fails_when_concrete_xio_setoption_fails)
 /*Tests_SRS_XIO_02_001: [ If argument xio is NULL then xio_retrieveoptions shall fail and return NULL. ]*/
 TEST_FUNCTION(xio_retrieveoptions_with_NULL_xio_fails)
 {
-    ///arrange
+    // arrange
 
-    ///act
+    // act
     OPTIONHANDLER_HANDLE h = xio_retrieveoptions(NULL);
 
-    ///assert
+    // assert
     ASSERT_IS_NULL(h);
 
-    ///cleanup
+    // cleanup
 }
 
 /*this function exists for the purpose of sharing code between happy and unhappy paths*/
@@ -933,21 +1295,21 @@ static void xio_retrieveoptions_inert_path(void)
 /*Tests_SRS_XIO_02_006: [ Otherwise, xio_retrieveoptions shall succeed and return a non-NULL handle. ]*/
 TEST_FUNCTION(xio_retrieveoptions_happypath)
 {
-    ///arrange
+    // arrange
 	OPTIONHANDLER_HANDLE h;
     XIO_HANDLE x = xio_create(&test_io_description, NULL);
     umock_c_reset_all_calls();
 
     xio_retrieveoptions_inert_path();
 
-    ///act
+    // act
     h = xio_retrieveoptions(x);
 
-    ///assert
+    // assert
     ASSERT_IS_NOT_NULL(h);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    ///cleanup
+    // cleanup
     OptionHandler_Destroy(h);
     xio_destroy(x);
 }
@@ -956,7 +1318,7 @@ TEST_FUNCTION(xio_retrieveoptions_happypath)
 
 TEST_FUNCTION(xio_retrieveoptions_unhappypaths)
 {
-    ///arrange
+    // arrange
 	XIO_HANDLE x;
 	size_t i;
     int negativeTestsInitResult = umock_c_negative_tests_init();
@@ -969,7 +1331,7 @@ TEST_FUNCTION(xio_retrieveoptions_unhappypaths)
 
     umock_c_negative_tests_snapshot();
 
-    ///act
+    // act
     for (i = 0; i < umock_c_negative_tests_call_count(); i++)
     {
         char temp_str[128];
@@ -988,7 +1350,7 @@ TEST_FUNCTION(xio_retrieveoptions_unhappypaths)
         ASSERT_IS_NULL_WITH_MSG(h, temp_str);
     }
 
-    ///cleanup
+    // cleanup
     xio_destroy(x);
     umock_c_negative_tests_deinit();
 }